@@ -0,0 +1,58 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "arena.h"
+#include <utility>
+
+namespace ATProto {
+
+static thread_local Arena::SharedPtr sArena;
+
+Arena::SharedPtr Arena::create(std::size_t initialSize)
+{
+    return std::make_shared<Arena>(initialSize);
+}
+
+Arena::Arena(std::size_t initialSize) :
+    mResource(initialSize, &mUpstream)
+{
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    ++mAllocationCount;
+    mBytesAllocated += bytes;
+    return mResource.allocate(bytes, alignment);
+}
+
+void* Arena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    ++mBlockCount;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void Arena::CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool Arena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+ArenaScope::ArenaScope(Arena::SharedPtr arena) :
+    mPrevious(std::exchange(sArena, std::move(arena)))
+{
+}
+
+ArenaScope::~ArenaScope()
+{
+    sArena = std::move(mPrevious);
+}
+
+const Arena::SharedPtr& ArenaScope::getArena()
+{
+    return sArena;
+}
+
+}
@@ -0,0 +1,108 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <memory>
+#include <memory_resource>
+
+namespace ATProto {
+
+// Memory arena for the object graph of a decoded reply.
+// Objects created with makeShared while an ArenaScope is active on the thread are
+// allocated from the arena of the scope instead of getting a heap allocation each.
+// The control block of every object holds a reference to its arena, such that the
+// arena lives till the last object allocated from it is released, e.g. a PostView
+// that is kept after its feed page is gone. Memory is only released when the
+// arena is destroyed.
+// Allocation is not thread safe. A scope must be used by a single thread.
+class Arena
+{
+public:
+    using SharedPtr = std::shared_ptr<Arena>;
+
+    static constexpr std::size_t DEFAULT_INITIAL_SIZE = 16 * 1024;
+
+    static SharedPtr create(std::size_t initialSize = DEFAULT_INITIAL_SIZE);
+
+    explicit Arena(std::size_t initialSize);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    // Allocations served by the arena.
+    int getAllocationCount() const { return mAllocationCount; }
+    std::size_t getBytesAllocated() const { return mBytesAllocated; }
+
+    // Heap allocations made by the arena for its buffers.
+    int getBlockCount() const { return mUpstream.mBlockCount; }
+
+private:
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        int mBlockCount = 0;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    CountingResource mUpstream;
+    std::pmr::monotonic_buffer_resource mResource;
+    int mAllocationCount = 0;
+    std::size_t mBytesAllocated = 0;
+};
+
+// Makes the arena the allocation arena of this thread for the lifetime of the scope.
+// A null arena makes a scope without arena, e.g. when arena decoding is disabled.
+// Scopes can be nested.
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena::SharedPtr arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    // Arena of the innermost scope on this thread, null if there is none.
+    static const Arena::SharedPtr& getArena();
+
+private:
+    Arena::SharedPtr mPrevious;
+};
+
+template<class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena::SharedPtr arena) : mArena(std::move(arena)) {}
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : mArena(other.getArena()) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) noexcept {} // released with the arena
+
+    const Arena::SharedPtr& getArena() const { return mArena; }
+
+    template<class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return mArena == other.getArena(); }
+
+private:
+    Arena::SharedPtr mArena;
+};
+
+// std::make_shared, or an allocation from the arena of the active scope.
+template<class T, class... Args>
+std::shared_ptr<T> makeShared(Args&&... args)
+{
+    if (const auto& arena = ArenaScope::getArena())
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+}
@@ -2,12 +2,15 @@
 // License: GPLv3
 #include "client.h"
 #include "at_uri.h"
+#include "jwt.h"
 #include "xjson.h"
 #include "lexicon/com_atproto_identity.h"
 #include "lexicon/lexicon.h"
+#include <QGuiApplication>
 #include <QTimer>
 #include <QUrl>
 #include <QUuid>
+#include <algorithm>
 
 namespace ATProto
 {
@@ -20,7 +23,6 @@ using namespace std::chrono_literals;
 static constexpr char const* ERROR_INVALID_JSON = "InvalidJson";
 static constexpr char const* ERROR_INVALID_SESSION = "InvalidSession";
 
-static constexpr auto AUTO_REFRESH_INTERVAL = 299s;
 
 static QString boolValue(bool value)
 {
@@ -70,9 +72,9 @@ static void addStringListParam(Xrpc::NetworkThread::Params& params, const QStrin
         params.append({name, str});
 }
 
-Client::SharedPtr Client::createPublicApiClient(QObject* parent)
+Client::SharedPtr Client::createPublicApiClient(QObject* parent, Xrpc::NetworkEngine::SharedPtr engine)
 {
-    auto xrpc = std::make_unique<Xrpc::Client>(PUBLIC_API_HOST);
+    auto xrpc = std::make_unique<Xrpc::Client>(PUBLIC_API_HOST, Xrpc::Client::DEFAULT_TIMEOUT_MS, QString{}, std::move(engine));
     auto client = std::make_shared<Client>(std::move(xrpc), parent);
     return client;
 }
@@ -82,9 +84,35 @@ Client::Client(std::unique_ptr<Xrpc::Client>&& xrpc, QObject* parent) :
     mXrpc(std::move(xrpc))
 {
     mAutoRefreshIntialDelayTimer.setSingleShot(true);
+    mAutoRefreshTimer.setSingleShot(true);
 
-    connect(&mAutoRefreshIntialDelayTimer, &QTimer::timeout, this, [this]{ mAutoRefreshTimer.start(AUTO_REFRESH_INTERVAL); });
+    connect(&mAutoRefreshIntialDelayTimer, &QTimer::timeout, this, [this]{ scheduleAutoRefresh(); });
     connect(&mAutoRefreshTimer, &QTimer::timeout, this, [this]{ autoRefreshSession(); });
+
+    if (qGuiApp)
+    {
+        connect(qGuiApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState state){
+            if (state == Qt::ApplicationActive && mAutoRefreshActive && !mAutoRefreshIntialDelayTimer.isActive())
+                scheduleAutoRefresh();
+        });
+    }
+
+    mXrpc->setTokenRefreshCb([this, presence=getPresence()](const Xrpc::Client::TokenRefreshDoneCb& doneCb){
+        if (!presence || !mSession)
+        {
+            doneCb({});
+            return;
+        }
+
+        refreshSession(
+            [this, presence, doneCb]{
+                doneCb(presence && mSession ? mSession->mAccessJwt : QString{});
+            },
+            [doneCb](const QString& error, const QString& msg){
+                qDebug() << "Token refresh failed:" << error << "-" << msg;
+                doneCb({});
+            });
+    });
 }
 
 void Client::setServiceAppView(const QString& service)
@@ -161,6 +189,15 @@ void Client::removeLabelerDid(const QString& did)
     setAcceptLabelersHeaderValue();
 }
 
+void Client::setSession(ComATProtoServer::Session::SharedPtr session)
+{
+    // Service auth tokens are issued for the account of the session.
+    if (!session || !mSession || session->mDid != mSession->mDid)
+        mServiceAuthCache.clear();
+
+    mSession = std::move(session);
+}
+
 void Client::updateSessionTokens(const QString& accessJwt, const QString& refreshJwt)
 {
     if (mSession)
@@ -238,6 +275,7 @@ void Client::createSessionContinue(const QString& user, const QString& pwd,
                                    const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     mSession = nullptr;
+    mServiceAuthCache.clear();
     QJsonObject root;
     root.insert("identifier", user);
     root.insert("password", pwd);
@@ -251,6 +289,7 @@ void Client::createSessionContinue(const QString& user, const QString& pwd,
 
             qDebug() << "Session created:" << session->mDid;
             mSession = std::move(session);
+            mServiceAuthCache.clear();
             mXrpc->setPDSFromSession(*mSession);
 
             if (successCb)
@@ -338,6 +377,7 @@ void Client::resumeSessionContinue(const ComATProtoServer::Session& session,
             {
                 qDebug() << "Session resumed";
                 mSession = std::make_shared<ComATProtoServer::Session>(session);
+                mServiceAuthCache.clear();
                 mSession->mHandle = resumed->mHandle;
                 mSession->mEmail = resumed->mEmail;
                 mSession->mEmailConfirmed = resumed->mEmailConfirmed;
@@ -473,6 +513,44 @@ void Client::resumeAndRefreshSessionContinue(bool retry, const ComATProtoServer:
 }
 
 void Client::refreshSession(const SuccessCb& successCb, const ErrorCb& errorCb)
+{
+    // A refresh invalidates the refresh token of a concurrent refresh.
+    const bool refreshing = !mRefreshSessionWaiters.empty();
+    mRefreshSessionWaiters.push_back({ successCb, errorCb });
+
+    if (refreshing)
+    {
+        qDebug() << "Join refresh in progress, waiters:" << mRefreshSessionWaiters.size();
+        return;
+    }
+
+    sendRefreshSession(
+        [this, presence=getPresence()]{
+            if (!presence)
+                return;
+
+            if (mAutoRefreshActive && !mAutoRefreshIntialDelayTimer.isActive())
+                scheduleAutoRefresh();
+
+            for (const auto& waiter : std::exchange(mRefreshSessionWaiters, {}))
+            {
+                if (waiter.mSuccessCb)
+                    waiter.mSuccessCb();
+            }
+        },
+        [this, presence=getPresence()](const QString& error, const QString& msg){
+            if (!presence)
+                return;
+
+            for (const auto& waiter : std::exchange(mRefreshSessionWaiters, {}))
+            {
+                if (waiter.mErrorCb)
+                    waiter.mErrorCb(error, msg);
+            }
+        });
+}
+
+void Client::sendRefreshSession(const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     if (mXrpc->isOAuthEnabled())
     {
@@ -530,9 +608,9 @@ void Client::refreshSessionOAuth(const SuccessCb& successCb, const ErrorCb& erro
         errorCb);
 }
 
-void Client::getAccountInviteCodes(const GetAccountInviteCodesSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getAccountInviteCodes(const GetAccountInviteCodesSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    mXrpc->get("com.atproto.server.getAccountInviteCodes", {}, {},
+    return mXrpc->get("com.atproto.server.getAccountInviteCodes", {}, {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -551,7 +629,7 @@ void Client::getAccountInviteCodes(const GetAccountInviteCodesSuccessCb& success
         authToken());
 }
 
-void Client::getServiceAuth(const QString& aud, const std::optional<QDateTime>& expiry, const std::optional<QString>& lexiconMethod,
+Xrpc::RequestHandle Client::getServiceAuth(const QString& aud, const std::optional<QDateTime>& expiry, const std::optional<QString>& lexiconMethod,
                     const GetServiceAuthSuccessCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Get serviceAuth:" << aud;
@@ -562,7 +640,7 @@ void Client::getServiceAuth(const QString& aud, const std::optional<QDateTime>&
 
     addOptionalStringParam(params, "lxm", lexiconMethod);
 
-    mXrpc->get("com.atproto.server.getServiceAuth", params, {},
+    return mXrpc->get("com.atproto.server.getServiceAuth", params, {},
         [successCb](ComATProtoServer::GetServiceAuthOutput::SharedPtr output){
             qDebug() << "getServiceAuth reply:" << output->mToken;
             if (successCb)
@@ -572,9 +650,47 @@ void Client::getServiceAuth(const QString& aud, const std::optional<QDateTime>&
         authToken());
 }
 
-void Client::requestEmailUpdate(const RequestEmailUpdateSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getServiceAuthToken(const QString& aud, const QString& lexiconMethod,
+                                                const GetServiceAuthTokenSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    mXrpc->post("com.atproto.server.requestEmailUpdate", {}, {},
+    const QString token = mServiceAuthCache.get(aud, lexiconMethod);
+
+    if (!token.isEmpty())
+    {
+        qDebug() << "Cached service auth:" << aud << lexiconMethod;
+
+        if (successCb)
+            successCb(token);
+
+        return {};
+    }
+
+    // The fetch is shared by all waiters, so it does not get cancelled by the handle
+    // of a single caller. Only the callbacks of a cancelled caller are dropped.
+    auto handle = Xrpc::RequestHandle::create();
+
+    if (!mServiceAuthCache.wait(aud, lexiconMethod, handle, successCb, errorCb))
+        return handle;
+
+    const QDateTime expiry = QDateTime::currentDateTimeUtc().addSecs(
+        std::chrono::seconds(ServiceAuthCache::TOKEN_LIFETIME).count());
+
+    getServiceAuth(aud, expiry, lexiconMethod,
+        [this, presence=getPresence(), aud, lexiconMethod, expiry](auto output){
+            if (presence)
+                mServiceAuthCache.fetched(aud, lexiconMethod, output->mToken, expiry);
+        },
+        [this, presence=getPresence(), aud, lexiconMethod](const QString& error, const QString& msg){
+            if (presence)
+                mServiceAuthCache.failed(aud, lexiconMethod, error, msg);
+        });
+
+    return handle;
+}
+
+Xrpc::RequestHandle Client::requestEmailUpdate(const RequestEmailUpdateSuccessCb& successCb, const ErrorCb& errorCb)
+{
+    return mXrpc->post("com.atproto.server.requestEmailUpdate", {}, {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -594,7 +710,7 @@ void Client::requestEmailUpdate(const RequestEmailUpdateSuccessCb& successCb, co
         authToken());
 }
 
-void Client::updateEmail(const QString& email, std::optional<bool> emailAuthFactor, const std::optional<QString>& token,
+Xrpc::RequestHandle Client::updateEmail(const QString& email, std::optional<bool> emailAuthFactor, const std::optional<QString>& token,
                  const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -602,7 +718,7 @@ void Client::updateEmail(const QString& email, std::optional<bool> emailAuthFact
     XJsonObject::insertOptionalJsonValue(json, "emailAuthFactor", emailAuthFactor);
     XJsonObject::insertOptionalJsonValue(json, "token", token);
 
-    mXrpc->post("com.atproto.server.updateEmail", QJsonDocument(json), {},
+    return mXrpc->post("com.atproto.server.updateEmail", QJsonDocument(json), {},
         [presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -616,12 +732,12 @@ void Client::updateEmail(const QString& email, std::optional<bool> emailAuthFact
         authToken());
 }
 
-void Client::requestPasswordReset(const QString& email, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::requestPasswordReset(const QString& email, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("email", email);
 
-    mXrpc->post("com.atproto.server.requestPasswordReset", QJsonDocument(json), {},
+    return mXrpc->post("com.atproto.server.requestPasswordReset", QJsonDocument(json), {},
         [presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -634,14 +750,14 @@ void Client::requestPasswordReset(const QString& email, const SuccessCb& success
         failure(errorCb));
 }
 
-void Client::resetPassword(const QString& password, const QString& token,
+Xrpc::RequestHandle Client::resetPassword(const QString& password, const QString& token,
                    const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("token", token);
     json.insert("password", password);
 
-    mXrpc->post("com.atproto.server.resetPassword", QJsonDocument(json), {},
+    return mXrpc->post("com.atproto.server.resetPassword", QJsonDocument(json), {},
         [presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -654,9 +770,9 @@ void Client::resetPassword(const QString& password, const QString& token,
         failure(errorCb));
 }
 
-void Client::requestEmailConfirmation(const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::requestEmailConfirmation(const SuccessCb& successCb, const ErrorCb& errorCb)
 {
-    mXrpc->post("com.atproto.server.requestEmailConfirmation", {}, {},
+    return mXrpc->post("com.atproto.server.requestEmailConfirmation", {}, {},
         [presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -670,14 +786,14 @@ void Client::requestEmailConfirmation(const SuccessCb& successCb, const ErrorCb&
         authToken());
 }
 
-void Client::confirmEmail(const QString& email, const QString& token,
+Xrpc::RequestHandle Client::confirmEmail(const QString& email, const QString& token,
                   const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("token", token);
     json.insert("email", email);
 
-    mXrpc->post("com.atproto.server.confirmEmail", QJsonDocument(json), {},
+    return mXrpc->post("com.atproto.server.confirmEmail", QJsonDocument(json), {},
         [presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -691,10 +807,10 @@ void Client::confirmEmail(const QString& email, const QString& token,
         authToken());
 }
 
-void Client::resolveHandle(const QString& handle,
+Xrpc::RequestHandle Client::resolveHandle(const QString& handle,
                    const ResolveHandleSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    mXrpc->get("com.atproto.identity.resolveHandle", {{"handle", handle}}, {},
+    return mXrpc->get("com.atproto.identity.resolveHandle", {{"handle", handle}}, {},
         [successCb](ComATProtoIdentity::ResolveHandleOutput::SharedPtr output){
             qDebug() << "resolveHandle:" << output->mDid;
 
@@ -705,13 +821,13 @@ void Client::resolveHandle(const QString& handle,
         authToken());
 }
 
-void Client::getProfile(const QString& user, const GetProfileSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getProfile(const QString& user, const GetProfileSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params httpHeaders;
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.actor.getProfile", {{"actor", user}}, httpHeaders,
+    return mXrpc->get("app.bsky.actor.getProfile", {{"actor", user}}, httpHeaders,
         [successCb](AppBskyActor::ProfileViewDetailed::SharedPtr profile){
             qDebug() << "getProfile:" << profile->mDid;
 
@@ -722,7 +838,7 @@ void Client::getProfile(const QString& user, const GetProfileSuccessCb& successC
         authToken());
 }
 
-void Client::getProfiles(const std::vector<QString>& users, const GetProfilesSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getProfiles(const std::vector<QString>& users, const GetProfilesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Q_ASSERT(users.size() > 0);
     Q_ASSERT(users.size() <= MAX_IDS_GET_PROFILES);
@@ -735,21 +851,21 @@ void Client::getProfiles(const std::vector<QString>& users, const GetProfilesSuc
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.actor.getProfiles", params, httpHeaders,
+    return mXrpc->get("app.bsky.actor.getProfiles", params, httpHeaders,
         [successCb](AppBskyActor::GetProfilesOutput::SharedPtr output){
             qDebug() << "getProfiles:" << output->mProfiles.size();
 
             if (successCb)
-                successCb(std::move(output->mProfiles));
+                successCb(output->mProfiles);
         },
         failure(errorCb),
         authToken());
 }
 
-void Client::getPreferences(const UserPrefsSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getPreferences(const UserPrefsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     // Do not proxy to AppView as preferences live on the PDS
-    mXrpc->get("app.bsky.actor.getPreferences", {}, {},
+    return mXrpc->get("app.bsky.actor.getPreferences", {}, {},
         [successCb](AppBskyActor::GetPreferencesOutput::SharedPtr prefs){
             qDebug() << "getPreferences ok";
 
@@ -760,16 +876,18 @@ void Client::getPreferences(const UserPrefsSuccessCb& successCb, const ErrorCb&
         authToken());
 }
 
-void Client::putPreferences(const UserPreferences& userPrefs,
+Xrpc::RequestHandle Client::putPreferences(const UserPreferences& userPrefs,
                             const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     AppBskyActor::GetPreferencesOutput prefs;
     prefs.mPreferences = userPrefs.toPreferenceList();
-    auto json = prefs.toJson();
-    qDebug() << "PREFS:" << json;
+    JsonWriter writer(PREFERENCES_SIZE_ESTIMATE);
+    prefs.writeJson(writer);
+    const QByteArray body = writer.take();
+    qDebug() << "PREFS:" << body;
 
     // Do not proxy to AppView as preferences live on the PDS
-    mXrpc->post("app.bsky.actor.putPreferences", QJsonDocument(json), {},
+    return mXrpc->post("app.bsky.actor.putPreferences", {}, body, "application/json", {},
         [successCb](const QJsonDocument& reply){
             qDebug() << "putPreferences:" << reply;
             if (successCb)
@@ -779,7 +897,7 @@ void Client::putPreferences(const UserPreferences& userPrefs,
         authToken());
 }
 
-void Client::searchActors(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::searchActors(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
                   const SearchActorsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"q", q}};
@@ -790,7 +908,7 @@ void Client::searchActors(const QString& q, std::optional<int> limit, const std:
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.actor.searchActors", params, httpHeaders,
+    return mXrpc->get("app.bsky.actor.searchActors", params, httpHeaders,
         [successCb](AppBskyActor::SearchActorsOutput::SharedPtr output){
             qDebug() << "searchActors:" << output->mCursor;
 
@@ -801,7 +919,7 @@ void Client::searchActors(const QString& q, std::optional<int> limit, const std:
         authToken());
 }
 
-void Client::searchActorsTypeahead(const QString& q, std::optional<int> limit,
+Xrpc::RequestHandle Client::searchActorsTypeahead(const QString& q, std::optional<int> limit,
                                    const SearchActorsTypeaheadSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"q", q}};
@@ -810,7 +928,7 @@ void Client::searchActorsTypeahead(const QString& q, std::optional<int> limit,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.actor.searchActorsTypeahead", params, httpHeaders,
+    return mXrpc->get("app.bsky.actor.searchActorsTypeahead", params, httpHeaders,
         [successCb](AppBskyActor::SearchActorsTypeaheadOutput::SharedPtr output){
             qDebug() << "searchActorsTypeahead:" << output->mActors.size();
 
@@ -821,7 +939,7 @@ void Client::searchActorsTypeahead(const QString& q, std::optional<int> limit,
         authToken());
 }
 
-void Client::getSuggestions(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getSuggestions(std::optional<int> limit, const std::optional<QString>& cursor,
                             const QStringList& acceptLanguages,
                             const GetSuggestionsSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -834,7 +952,7 @@ void Client::getSuggestions(std::optional<int> limit, const std::optional<QStrin
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.actor.getSuggestions", params, httpHeaders,
+    return mXrpc->get("app.bsky.actor.getSuggestions", params, httpHeaders,
         [successCb](AppBskyActor::GetSuggestionsOutput::SharedPtr output){
             qDebug() << "getSuggestions: ok";
             if (successCb)
@@ -844,7 +962,7 @@ void Client::getSuggestions(std::optional<int> limit, const std::optional<QStrin
         authToken());
 }
 
-void Client::createBookmark(QString uri, QString cid, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::createBookmark(QString uri, QString cid, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("uri", uri);
@@ -853,7 +971,7 @@ void Client::createBookmark(QString uri, QString cid, const SuccessCb& successCb
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.bookmark.createBookmark", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.bookmark.createBookmark", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Created bookmark reply:" << reply;
             if (successCb)
@@ -863,7 +981,7 @@ void Client::createBookmark(QString uri, QString cid, const SuccessCb& successCb
         authToken());
 }
 
-void Client::deleteBookmark(QString uri, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::deleteBookmark(QString uri, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("uri", uri);
@@ -871,7 +989,7 @@ void Client::deleteBookmark(QString uri, const SuccessCb& successCb, const Error
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.bookmark.deleteBookmark", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.bookmark.deleteBookmark", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Deleted bookmark reply:" << reply;
             if (successCb)
@@ -881,7 +999,7 @@ void Client::deleteBookmark(QString uri, const SuccessCb& successCb, const Error
         authToken());
 }
 
-void Client::getBookmarks(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getBookmarks(std::optional<int> limit, const std::optional<QString>& cursor,
                   const GetBookmarksSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -892,7 +1010,7 @@ void Client::getBookmarks(std::optional<int> limit, const std::optional<QString>
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.bookmark.getBookmarks", params, httpHeaders,
+    return mXrpc->get("app.bsky.bookmark.getBookmarks", params, httpHeaders,
         [successCb](AppBskyBookmark::GetBookmarksOutput::SharedPtr output){
             qDebug() << "getBookmarks, cursor:" << output->mCursor.value_or("");
             if (successCb)
@@ -902,7 +1020,7 @@ void Client::getBookmarks(std::optional<int> limit, const std::optional<QString>
         authToken());
 }
 
-void Client::getSuggestedFollows(const QString& user, const QStringList& acceptLanguages,
+Xrpc::RequestHandle Client::getSuggestedFollows(const QString& user, const QStringList& acceptLanguages,
                                  const GetSuggestedFollowsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"actor", user}};
@@ -912,7 +1030,7 @@ void Client::getSuggestedFollows(const QString& user, const QStringList& acceptL
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getSuggestedFollowsByActor", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getSuggestedFollowsByActor", params, httpHeaders,
         [successCb](AppBskyActor::GetSuggestedFollowsByActor::SharedPtr output){
             qDebug() << "getSuggestedFOllows:" << output->mSuggestions.size();
 
@@ -923,7 +1041,7 @@ void Client::getSuggestedFollows(const QString& user, const QStringList& acceptL
         authToken());
 }
 
-void Client::getServices(const std::vector<QString>& dids, bool detailed,
+Xrpc::RequestHandle Client::getServices(const std::vector<QString>& dids, bool detailed,
                          const GetServicesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"detailed", boolValue(detailed)}};
@@ -935,7 +1053,7 @@ void Client::getServices(const std::vector<QString>& dids, bool detailed,
     for (const auto& did : dids)
         params.append({"dids", did});
 
-    mXrpc->get("app.bsky.labeler.getServices", params, httpHeaders,
+    return mXrpc->get("app.bsky.labeler.getServices", params, httpHeaders,
         [successCb](AppBskyLabeler::GetServicesOutput::SharedPtr output){
             qDebug() << "getServices: success";
 
@@ -946,7 +1064,7 @@ void Client::getServices(const std::vector<QString>& dids, bool detailed,
         authToken());
 }
 
-void Client::getEmbedExternalView(const QString& url, const std::vector<QString> uris,
+Xrpc::RequestHandle Client::getEmbedExternalView(const QString& url, const std::vector<QString> uris,
                           const GetEmbedExternalViewCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"url", url}};
@@ -957,7 +1075,7 @@ void Client::getEmbedExternalView(const QString& url, const std::vector<QString>
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.embed.getEmbedExternalView", params, httpHeaders,
+    return mXrpc->get("app.bsky.embed.getEmbedExternalView", params, httpHeaders,
         [successCb](AppBskyEmbed::GetEmbedExternalViewOutput::SharedPtr output){
             qDebug() << "getEmbedExternalView: success";
 
@@ -968,7 +1086,7 @@ void Client::getEmbedExternalView(const QString& url, const std::vector<QString>
         authToken());
 }
 
-void Client::getAuthorFeed(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getAuthorFeed(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
                            const std::optional<QString> filter, std::optional<bool> includePins,
                            const GetAuthorFeedSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -982,7 +1100,7 @@ void Client::getAuthorFeed(const QString& user, std::optional<int> limit, const
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getAuthorFeed", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getAuthorFeed", params, httpHeaders,
         [successCb](AppBskyFeed::OutputFeed::SharedPtr feed){
             qDebug() << "getAuthorFeed: ok";
 
@@ -993,7 +1111,7 @@ void Client::getAuthorFeed(const QString& user, std::optional<int> limit, const
         authToken());
 }
 
-void Client::getActorLikes(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getActorLikes(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
                            const GetActorLikesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"actor", user}};
@@ -1004,7 +1122,7 @@ void Client::getActorLikes(const QString& user, std::optional<int> limit, const
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getActorLikes", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getActorLikes", params, httpHeaders,
         [successCb](AppBskyFeed::OutputFeed::SharedPtr feed){
             qDebug() << "getActorLikes: ok";
 
@@ -1015,7 +1133,7 @@ void Client::getActorLikes(const QString& user, std::optional<int> limit, const
         authToken());
 }
 
-void Client::getTimeline(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getTimeline(std::optional<int> limit, const std::optional<QString>& cursor,
                          const GetTimelineSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1026,7 +1144,7 @@ void Client::getTimeline(std::optional<int> limit, const std::optional<QString>&
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getTimeline", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getTimeline", params, httpHeaders,
         [successCb, errorCb](AppBskyFeed::OutputFeed::SharedPtr feed){
             qDebug() << "getTimeline succeeded";
 
@@ -1037,7 +1155,7 @@ void Client::getTimeline(std::optional<int> limit, const std::optional<QString>&
         authToken());
 }
 
-void Client::getFeed(const QString& feed, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getFeed(const QString& feed, std::optional<int> limit, const std::optional<QString>& cursor,
                      const QStringList& acceptLanguages,
                      const GetFeedSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1050,7 +1168,7 @@ void Client::getFeed(const QString& feed, std::optional<int> limit, const std::o
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getFeed", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getFeed", params, httpHeaders,
         [successCb](AppBskyFeed::OutputFeed::SharedPtr feed){
             qDebug() << "getFeed: ok";
 
@@ -1061,7 +1179,7 @@ void Client::getFeed(const QString& feed, std::optional<int> limit, const std::o
         authToken());
 }
 
-void Client::getListFeed(const QString& list, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getListFeed(const QString& list, std::optional<int> limit, const std::optional<QString>& cursor,
                          const QStringList& acceptLanguages,
                          const GetFeedSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1074,7 +1192,7 @@ void Client::getListFeed(const QString& list, std::optional<int> limit, const st
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getListFeed", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getListFeed", params, httpHeaders,
         [successCb](AppBskyFeed::OutputFeed::SharedPtr feed){
             qDebug() << "getListFeed: ok";
 
@@ -1085,7 +1203,7 @@ void Client::getListFeed(const QString& list, std::optional<int> limit, const st
         authToken());
 }
 
-void Client::getFeedGenerator(const QString& feed,
+Xrpc::RequestHandle Client::getFeedGenerator(const QString& feed,
                       const GetFeedGeneratorSuccessCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Get feed generator:" << feed;
@@ -1095,7 +1213,7 @@ void Client::getFeedGenerator(const QString& feed,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getFeedGenerator", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getFeedGenerator", params, httpHeaders,
         [successCb](AppBskyFeed::GetFeedGeneratorOutput::SharedPtr feed){
             qDebug() << "getFeedGenerator:" << feed->mView->mDisplayName;
 
@@ -1106,7 +1224,7 @@ void Client::getFeedGenerator(const QString& feed,
         authToken());
 }
 
-void Client::getFeedGenerators(const std::vector<QString>& feeds,
+Xrpc::RequestHandle Client::getFeedGenerators(const std::vector<QString>& feeds,
                        const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Get feed generators";
@@ -1122,7 +1240,7 @@ void Client::getFeedGenerators(const std::vector<QString>& feeds,
         params.append({"feeds", f});
     }
 
-    mXrpc->get("app.bsky.feed.getFeedGenerators", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getFeedGenerators", params, httpHeaders,
         [successCb](AppBskyFeed::GetFeedGeneratorsOutput::SharedPtr feed){
             qDebug() << "getFeedGenerators: ok";
 
@@ -1133,7 +1251,7 @@ void Client::getFeedGenerators(const std::vector<QString>& feeds,
         authToken());
 }
 
-void Client::getActorFeeds(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getActorFeeds(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
                            const GetActorFeedsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"actor", user}};
@@ -1144,7 +1262,7 @@ void Client::getActorFeeds(const QString& user, std::optional<int> limit, const
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getActorFeeds", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getActorFeeds", params, httpHeaders,
         [successCb](AppBskyFeed::GetActorFeedsOutput::SharedPtr output){
             qDebug() << "getActorFeeds: ok";
 
@@ -1155,7 +1273,7 @@ void Client::getActorFeeds(const QString& user, std::optional<int> limit, const
         authToken());
 }
 
-void Client::getPostThread(const QString& uri, std::optional<int> depth, std::optional<int> parentHeight,
+Xrpc::RequestHandle Client::getPostThread(const QString& uri, std::optional<int> depth, std::optional<int> parentHeight,
                            const GetPostThreadSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"uri", uri}};
@@ -1166,7 +1284,7 @@ void Client::getPostThread(const QString& uri, std::optional<int> depth, std::op
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getPostThread", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getPostThread", params, httpHeaders,
         [successCb](AppBskyFeed::PostThread::SharedPtr thread){
             qDebug() << "getPostThread OK";
 
@@ -1177,7 +1295,7 @@ void Client::getPostThread(const QString& uri, std::optional<int> depth, std::op
         authToken());
 }
 
-void Client::getPosts(const std::vector<QString>& uris,
+Xrpc::RequestHandle Client::getPosts(const std::vector<QString>& uris,
                       const GetPostsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Q_ASSERT(uris.size() > 0);
@@ -1191,18 +1309,18 @@ void Client::getPosts(const std::vector<QString>& uris,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getPosts", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getPosts", params, httpHeaders,
         [successCb](AppBskyFeed::GetPostsOutput::SharedPtr output){
             qDebug() << "getPosts:" << output->mPosts.size();
 
             if (successCb)
-                successCb(std::move(output->mPosts));
+                successCb(output->mPosts);
         },
         failure(errorCb),
         authToken());
 }
 
-void Client::getQuotes(const QString& uri, const std::optional<QString>& cid, std::optional<int> limit,
+Xrpc::RequestHandle Client::getQuotes(const QString& uri, const std::optional<QString>& cid, std::optional<int> limit,
                        const std::optional<QString>& cursor, const GetQuotesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"uri", uri}};
@@ -1214,7 +1332,7 @@ void Client::getQuotes(const QString& uri, const std::optional<QString>& cid, st
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getQuotes", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getQuotes", params, httpHeaders,
         [successCb](AppBskyFeed::GetQuotesOutput::SharedPtr output){
             qDebug() << "getQuotes: ok";
 
@@ -1225,7 +1343,7 @@ void Client::getQuotes(const QString& uri, const std::optional<QString>& cid, st
         authToken());
 }
 
-void Client::searchPosts(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::searchPosts(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
                          const std::optional<QString>& sort, const std::optional<QString>& author,
                          const std::optional<QString>& mentions, const std::optional<QDateTime>& since,
                          const std::optional<QDateTime>& until, const std::optional<QString>& lang,
@@ -1245,7 +1363,7 @@ void Client::searchPosts(const QString& q, std::optional<int> limit, const std::
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.searchPosts", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.searchPosts", params, httpHeaders,
         [successCb](AppBskyFeed::SearchPostsOutput::SharedPtr output){
             qDebug() << "searchPosts:" << output->mPosts.size();
 
@@ -1417,7 +1535,7 @@ const Xrpc::NetworkThread::Params& Client::SearchParams::getParams() const
     return mParams;
 }
 
-void Client::searchPostsV2(const QString& query, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::searchPostsV2(const QString& query, std::optional<int> limit, const std::optional<QString>& cursor,
                    const SearchParams& searchParams,
                    const SearchPostsV2SuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1430,7 +1548,7 @@ void Client::searchPostsV2(const QString& query, std::optional<int> limit, const
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.searchPostsV2", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.searchPostsV2", params, httpHeaders,
         [successCb](AppBskyFeed::SearchPostsV2Output::SharedPtr output){
             qDebug() << "searchPostsV2:" << output->mPosts.size();
 
@@ -1441,7 +1559,7 @@ void Client::searchPostsV2(const QString& query, std::optional<int> limit, const
         authToken());
 }
 
-void Client::getLikes(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getLikes(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
               const GetLikesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"uri", uri}};
@@ -1451,7 +1569,7 @@ void Client::getLikes(const QString& uri, std::optional<int> limit, const std::o
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getLikes", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getLikes", params, httpHeaders,
         [successCb](AppBskyFeed::GetLikesOutput::SharedPtr likes){
             qDebug() << "getLikes:" << likes->mLikes.size();
 
@@ -1462,7 +1580,7 @@ void Client::getLikes(const QString& uri, std::optional<int> limit, const std::o
         authToken());
 }
 
-void Client::getRepostedBy(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getRepostedBy(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
                    const GetRepostedBySuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"uri", uri}};
@@ -1473,7 +1591,7 @@ void Client::getRepostedBy(const QString& uri, std::optional<int> limit, const s
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getRepostedBy", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getRepostedBy", params, httpHeaders,
         [successCb](AppBskyFeed::GetRepostedByOutput::SharedPtr repostedBy){
             qDebug() << "getRepostedBy:" << repostedBy->mRepostedBy.size();
 
@@ -1484,7 +1602,7 @@ void Client::getRepostedBy(const QString& uri, std::optional<int> limit, const s
         authToken());
 }
 
-void Client::sendInteractions(const std::optional<QString>& feedUri, const AppBskyFeed::Interaction::List& interactions,
+Xrpc::RequestHandle Client::sendInteractions(const std::optional<QString>& feedUri, const AppBskyFeed::Interaction::List& interactions,
                               const QString& feedDid, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     const auto jsonArray = XJsonObject::toJsonArray<AppBskyFeed::Interaction>(interactions);
@@ -1496,7 +1614,7 @@ void Client::sendInteractions(const std::optional<QString>& feedUri, const AppBs
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, feedDid, SERVICE_KEY_BSKY_FEEDGEN);
 
-    mXrpc->post("app.bsky.feed.sendInteractions", json, httpHeaders,
+    return mXrpc->post("app.bsky.feed.sendInteractions", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "sendInteractions:" << reply;
             if (successCb)
@@ -1506,7 +1624,7 @@ void Client::sendInteractions(const std::optional<QString>& feedUri, const AppBs
         authToken());
 }
 
-void Client::getDrafts(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getDrafts(std::optional<int> limit, const std::optional<QString>& cursor,
                const GetDraftsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1516,7 +1634,7 @@ void Client::getDrafts(std::optional<int> limit, const std::optional<QString>& c
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.draft.getDrafts", params, httpHeaders,
+    return mXrpc->get("app.bsky.draft.getDrafts", params, httpHeaders,
         [successCb](AppBskyDraft::GetDraftsOutput::SharedPtr drafts){
             qDebug() << "getDrafts:" << drafts->mDrafts.size();
 
@@ -1527,7 +1645,7 @@ void Client::getDrafts(std::optional<int> limit, const std::optional<QString>& c
         authToken());
 }
 
-void Client::createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
+Xrpc::RequestHandle Client::createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
                  const CreateDraftSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -1536,7 +1654,7 @@ void Client::createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.draft.createDraft", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.draft.createDraft", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -1556,7 +1674,7 @@ void Client::createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
         authToken());
 }
 
-void Client::deleteDraft(const QString& id, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::deleteDraft(const QString& id, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
     json.insert("id", id);
@@ -1564,7 +1682,7 @@ void Client::deleteDraft(const QString& id, const SuccessCb& successCb, const Er
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.draft.deleteDraft", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.draft.deleteDraft", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Deleted draft reply:" << reply;
             if (successCb)
@@ -1574,7 +1692,7 @@ void Client::deleteDraft(const QString& id, const SuccessCb& successCb, const Er
         authToken());
 }
 
-void Client::updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
+Xrpc::RequestHandle Client::updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
                  const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -1583,7 +1701,7 @@ void Client::updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.draft.updateDraft", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.draft.updateDraft", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Updated draft reply:" << reply;
             if (successCb)
@@ -1593,7 +1711,7 @@ void Client::updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
         authToken());
 }
 
-void Client::getFollows(const QString& actor, std::optional<int> limit,
+Xrpc::RequestHandle Client::getFollows(const QString& actor, std::optional<int> limit,
                         const std::optional<QString>& cursor, const std::optional<QString>& sort,
                         const GetFollowsSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1606,7 +1724,7 @@ void Client::getFollows(const QString& actor, std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getFollows", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getFollows", params, httpHeaders,
         [successCb](AppBskyGraph::GetFollowsOutput::SharedPtr follows){
             qDebug() << "getFollows:" << follows->mFollows.size();
 
@@ -1617,7 +1735,7 @@ void Client::getFollows(const QString& actor, std::optional<int> limit,
         authToken());
 }
 
-void Client::getFollowers(const QString& actor, std::optional<int> limit,
+Xrpc::RequestHandle Client::getFollowers(const QString& actor, std::optional<int> limit,
                           const std::optional<QString>& cursor, const std::optional<QString>& sort,
                           const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1630,7 +1748,7 @@ void Client::getFollowers(const QString& actor, std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getFollowers", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getFollowers", params, httpHeaders,
         [successCb](AppBskyGraph::GetFollowersOutput::SharedPtr followers){
             qDebug() << "getFollowers:" << followers->mFollowers.size();
 
@@ -1641,7 +1759,7 @@ void Client::getFollowers(const QString& actor, std::optional<int> limit,
         authToken());
 }
 
-void Client::getKnownFollowers(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getKnownFollowers(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
                                const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"actor", actor}};
@@ -1652,7 +1770,7 @@ void Client::getKnownFollowers(const QString& actor, std::optional<int> limit, c
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getKnownFollowers", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getKnownFollowers", params, httpHeaders,
         [successCb](AppBskyGraph::GetFollowersOutput::SharedPtr followers){
             qDebug() << "getKnownFollowers:" << followers->mFollowers.size();
 
@@ -1663,7 +1781,7 @@ void Client::getKnownFollowers(const QString& actor, std::optional<int> limit, c
         authToken());
 }
 
-void Client::getBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
                        const GetBlocksSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1674,7 +1792,7 @@ void Client::getBlocks(std::optional<int> limit, const std::optional<QString>& c
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getBlocks", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getBlocks", params, httpHeaders,
         [successCb](AppBskyGraph::GetBlocksOutput::SharedPtr blocks){
             qDebug() << "getBlocks:" << blocks->mBlocks.size();
 
@@ -1685,7 +1803,7 @@ void Client::getBlocks(std::optional<int> limit, const std::optional<QString>& c
         authToken());
 }
 
-void Client::getMutes(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getMutes(std::optional<int> limit, const std::optional<QString>& cursor,
                       const GetMutesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1696,7 +1814,7 @@ void Client::getMutes(std::optional<int> limit, const std::optional<QString>& cu
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getMutes", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getMutes", params, httpHeaders,
         [successCb](AppBskyGraph::GetMutesOutput::SharedPtr mutes){
             qDebug() << "getMutes:" << mutes->mMutes.size();
 
@@ -1707,7 +1825,7 @@ void Client::getMutes(std::optional<int> limit, const std::optional<QString>& cu
         authToken());
 }
 
-void Client::muteActor(const QString& actor, std::optional<bool> onlyReposts, std::optional<bool> onlyQuotePosts, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::muteActor(const QString& actor, std::optional<bool> onlyReposts, std::optional<bool> onlyQuotePosts, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("actor", actor);
@@ -1723,7 +1841,7 @@ void Client::muteActor(const QString& actor, std::optional<bool> onlyReposts, st
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.muteActor", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.muteActor", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "muteActor:" << reply;
             if (successCb)
@@ -1733,7 +1851,7 @@ void Client::muteActor(const QString& actor, std::optional<bool> onlyReposts, st
         authToken());
 }
 
-void Client::unmuteActor(const QString& actor, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::unmuteActor(const QString& actor, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("actor", actor);
@@ -1742,7 +1860,7 @@ void Client::unmuteActor(const QString& actor, const SuccessCb& successCb, const
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.unmuteActor", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.unmuteActor", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "unmuteActor:" << reply;
             if (successCb)
@@ -1752,7 +1870,7 @@ void Client::unmuteActor(const QString& actor, const SuccessCb& successCb, const
         authToken());
 }
 
-void Client::muteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::muteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("root", root);
@@ -1761,7 +1879,7 @@ void Client::muteThread(const QString& root, const SuccessCb& successCb, const E
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.muteThread", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.muteThread", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "muteThread:" << reply;
             if (successCb)
@@ -1771,7 +1889,7 @@ void Client::muteThread(const QString& root, const SuccessCb& successCb, const E
         authToken());
 }
 
-void Client::unmuteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::unmuteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("root", root);
@@ -1780,7 +1898,7 @@ void Client::unmuteThread(const QString& root, const SuccessCb& successCb, const
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.unmuteThread", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.unmuteThread", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "unmuteThread:" << reply;
             if (successCb)
@@ -1790,7 +1908,7 @@ void Client::unmuteThread(const QString& root, const SuccessCb& successCb, const
         authToken());
 }
 
-void Client::getList(const QString& listUri, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getList(const QString& listUri, std::optional<int> limit, const std::optional<QString>& cursor,
                      const GetListSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"list", listUri}};
@@ -1801,7 +1919,7 @@ void Client::getList(const QString& listUri, std::optional<int> limit, const std
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getList", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getList", params, httpHeaders,
         [successCb](AppBskyGraph::GetListOutput::SharedPtr output){
             qDebug() << "getList:" << output->mList->mName;
 
@@ -1812,7 +1930,7 @@ void Client::getList(const QString& listUri, std::optional<int> limit, const std
         authToken());
 }
 
-void Client::getLists(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
+Xrpc::RequestHandle Client::getLists(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
                       std::optional<int> limit, const std::optional<QString>& cursor,
                       const GetListsSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1827,7 +1945,7 @@ void Client::getLists(const QString& actor, const std::vector<AppBskyGraph::List
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getLists", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getLists", params, httpHeaders,
         [successCb](AppBskyGraph::GetListsOutput::SharedPtr output){
             qDebug() << "getLists:" << output->mLists.size();
 
@@ -1838,7 +1956,7 @@ void Client::getLists(const QString& actor, const std::vector<AppBskyGraph::List
         authToken());
 }
 
-void Client::getListsWithMembership(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
+Xrpc::RequestHandle Client::getListsWithMembership(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
                             std::optional<int> limit, const std::optional<QString>& cursor,
                             const GetListsWithMembershipSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1853,7 +1971,7 @@ void Client::getListsWithMembership(const QString& actor, const std::vector<AppB
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getListsWithMembership", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getListsWithMembership", params, httpHeaders,
         [successCb](AppBskyGraph::GetListsWithMembershipOutput::SharedPtr output){
             qDebug() << "getListsWithMembership:" << output->mListsWithMembership.size();
 
@@ -1864,7 +1982,7 @@ void Client::getListsWithMembership(const QString& actor, const std::vector<AppB
         authToken());
 }
 
-void Client::getListBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getListBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
                            const GetListsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1875,7 +1993,7 @@ void Client::getListBlocks(std::optional<int> limit, const std::optional<QString
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getListBlocks", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getListBlocks", params, httpHeaders,
         [successCb](AppBskyGraph::GetListsOutput::SharedPtr output){
             qDebug() << "getListBlocks:" << output->mLists.size();
 
@@ -1886,7 +2004,7 @@ void Client::getListBlocks(std::optional<int> limit, const std::optional<QString
         authToken());
 }
 
-void Client::getListMutes(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getListMutes(std::optional<int> limit, const std::optional<QString>& cursor,
                           const GetListsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -1897,7 +2015,7 @@ void Client::getListMutes(std::optional<int> limit, const std::optional<QString>
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getListMutes", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getListMutes", params, httpHeaders,
         [successCb](AppBskyGraph::GetListsOutput::SharedPtr output){
             qDebug() << "getListMutes:" << output->mLists.size();
 
@@ -1908,7 +2026,7 @@ void Client::getListMutes(std::optional<int> limit, const std::optional<QString>
         authToken());
 }
 
-void Client::getActorStarterPacks(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getActorStarterPacks(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
                                   const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"actor", actor}};
@@ -1919,7 +2037,7 @@ void Client::getActorStarterPacks(const QString& actor, std::optional<int> limit
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getActorStarterPacks", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getActorStarterPacks", params, httpHeaders,
         [successCb](AppBskyGraph::GetStarterPacksOutput::SharedPtr output){
             qDebug() << "getActorStarterPacks:" << output->mStarterPacks.size();
 
@@ -1930,7 +2048,7 @@ void Client::getActorStarterPacks(const QString& actor, std::optional<int> limit
         authToken());
 }
 
-void Client::getStarterPacks(const std::vector<QString>& uris,
+Xrpc::RequestHandle Client::getStarterPacks(const std::vector<QString>& uris,
                              const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Q_ASSERT(uris.size() > 0);
@@ -1944,7 +2062,7 @@ void Client::getStarterPacks(const std::vector<QString>& uris,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getStarterPacks", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getStarterPacks", params, httpHeaders,
         [successCb](AppBskyGraph::GetStarterPacksOutput::SharedPtr output){
             qDebug() << "getStarterPacks:" << output->mStarterPacks.size();
 
@@ -1955,7 +2073,7 @@ void Client::getStarterPacks(const std::vector<QString>& uris,
         authToken());
 }
 
-void Client::getStarterpacksWithMembership(const QString& actor,
+Xrpc::RequestHandle Client::getStarterpacksWithMembership(const QString& actor,
                                    std::optional<int> limit, const std::optional<QString>& cursor,
                                    const GetStarterPacksWithMembershipSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -1967,7 +2085,7 @@ void Client::getStarterpacksWithMembership(const QString& actor,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getStarterpacksWithMembership", params, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getStarterpacksWithMembership", params, httpHeaders,
         [successCb](AppBskyGraph::GetStarterPacksWithMembershipOutput::SharedPtr output){
             qDebug() << "getStarterPacksWithMembership:" << output->mStarterPacksWithMembership.size();
 
@@ -1978,24 +2096,24 @@ void Client::getStarterpacksWithMembership(const QString& actor,
         authToken());
 }
 
-void Client::getStarterPack(const QString& starterPack, const GetStarterPackSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getStarterPack(const QString& starterPack, const GetStarterPackSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params httpHeaders;
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.graph.getStarterPack", {{"starterPack", starterPack}}, httpHeaders,
+    return mXrpc->get("app.bsky.graph.getStarterPack", {{"starterPack", starterPack}}, httpHeaders,
         [successCb](AppBskyGraph::GetStarterPackOutput::SharedPtr output){
             qDebug() << "getStarterPack:" << output->mStarterPack->mUri;
 
             if (successCb)
-                successCb(std::move(output->mStarterPack));
+                successCb(output->mStarterPack);
         },
         failure(errorCb),
         authToken());
 }
 
-void Client::muteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::muteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("list", listUri);
@@ -2004,7 +2122,7 @@ void Client::muteActorList(const QString& listUri, const SuccessCb& successCb, c
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.muteActorList", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.muteActorList", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "muteActorList:" << reply;
             if (successCb)
@@ -2014,7 +2132,7 @@ void Client::muteActorList(const QString& listUri, const SuccessCb& successCb, c
         authToken());
 }
 
-void Client::unmuteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::unmuteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject jsonObj;
     jsonObj.insert("list", listUri);
@@ -2023,7 +2141,7 @@ void Client::unmuteActorList(const QString& listUri, const SuccessCb& successCb,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.graph.unmuteActorList", json, httpHeaders,
+    return mXrpc->post("app.bsky.graph.unmuteActorList", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "unmuteActorList:" << reply;
             if (successCb)
@@ -2033,7 +2151,7 @@ void Client::unmuteActorList(const QString& listUri, const SuccessCb& successCb,
         authToken());
 }
 
-void Client::getUnreadNotificationCount(const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
+Xrpc::RequestHandle Client::getUnreadNotificationCount(const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
                                         const UnreadCountSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -2043,7 +2161,7 @@ void Client::getUnreadNotificationCount(const std::optional<QDateTime>& seenAt,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.notification.getUnreadCount", params, httpHeaders,
+    return mXrpc->get("app.bsky.notification.getUnreadCount", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2061,7 +2179,7 @@ void Client::getUnreadNotificationCount(const std::optional<QDateTime>& seenAt,
         authToken());
 }
 
-void Client::updateNotificationSeen(const QDateTime& dateTime,
+Xrpc::RequestHandle Client::updateNotificationSeen(const QDateTime& dateTime,
                                     const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonDocument json;
@@ -2072,7 +2190,7 @@ void Client::updateNotificationSeen(const QDateTime& dateTime,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.notification.updateSeen", json, httpHeaders,
+    return mXrpc->post("app.bsky.notification.updateSeen", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Updated notification seen:" << reply;
             if (successCb)
@@ -2082,7 +2200,7 @@ void Client::updateNotificationSeen(const QDateTime& dateTime,
         authToken());
 }
 
-void Client::listNotifications(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::listNotifications(std::optional<int> limit, const std::optional<QString>& cursor,
                                const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
                                const std::vector<AppBskyNotification::NotificationReason> reasons,
                                const NotificationsSuccessCb& successCb, const ErrorCb& errorCb,
@@ -2108,7 +2226,7 @@ void Client::listNotifications(std::optional<int> limit, const std::optional<QSt
 
     const auto now = QDateTime::currentDateTimeUtc();
 
-    mXrpc->get("app.bsky.notification.listNotifications", params, httpHeaders,
+    return mXrpc->get("app.bsky.notification.listNotifications", params, httpHeaders,
         [this, presence=getPresence(), now, successCb, updateSeen](AppBskyNotification::ListNotificationsOutput::SharedPtr output){
             if (!presence)
                 return;
@@ -2125,7 +2243,7 @@ void Client::listNotifications(std::optional<int> limit, const std::optional<QSt
         authToken());
 }
 
-void Client::putNotificationPreferences(bool priority,
+Xrpc::RequestHandle Client::putNotificationPreferences(bool priority,
                                         const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonDocument json;
@@ -2136,7 +2254,7 @@ void Client::putNotificationPreferences(bool priority,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.notification.putPreferences", json, httpHeaders,
+    return mXrpc->post("app.bsky.notification.putPreferences", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "Put notification preferences:" << reply;
             if (successCb)
@@ -2146,12 +2264,12 @@ void Client::putNotificationPreferences(bool priority,
         authToken());
 }
 
-void Client::getNotificationPreferences(const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getNotificationPreferences(const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.notification.getPreferences", {}, httpHeaders,
+    return mXrpc->get("app.bsky.notification.getPreferences", {}, httpHeaders,
         [successCb](AppBskyNotification::GetPreferencesOutput::SharedPtr output){
             qDebug() << "Get notification preferences:" << output->mPreferences->mJson;
             if (successCb)
@@ -2161,7 +2279,7 @@ void Client::getNotificationPreferences(const NotificationPreferencesSuccessCb&
         authToken());
 }
 
-void Client::putNotificationPreferencesV2(const AppBskyNotification::Preferences& prefs,
+Xrpc::RequestHandle Client::putNotificationPreferencesV2(const AppBskyNotification::Preferences& prefs,
                                   const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonDocument json;
@@ -2183,7 +2301,7 @@ void Client::putNotificationPreferencesV2(const AppBskyNotification::Preferences
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.notification.putPreferencesV2", json, httpHeaders,
+    return mXrpc->post("app.bsky.notification.putPreferencesV2", json, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2202,7 +2320,7 @@ void Client::putNotificationPreferencesV2(const AppBskyNotification::Preferences
         authToken());
 }
 
-void Client::listActivitySubscriptions(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::listActivitySubscriptions(std::optional<int> limit, const std::optional<QString>& cursor,
                                        const ListActivitySubscriptionsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -2213,7 +2331,7 @@ void Client::listActivitySubscriptions(std::optional<int> limit, const std::opti
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.notification.listActivitySubscriptions", params, httpHeaders,
+    return mXrpc->get("app.bsky.notification.listActivitySubscriptions", params, httpHeaders,
         [successCb](AppBskyNotification::ListActivitySubscriptionsOutput::SharedPtr output){
             qDebug() << "listActivitySubscriptions succeeded:" << output->mSubscriptions.size();
             if (successCb)
@@ -2223,7 +2341,7 @@ void Client::listActivitySubscriptions(std::optional<int> limit, const std::opti
         authToken());
 }
 
-void Client::putActivitySubscription(const QString& subject, const AppBskyNotification::ActivitySubscription& subscription,
+Xrpc::RequestHandle Client::putActivitySubscription(const QString& subject, const AppBskyNotification::ActivitySubscription& subscription,
                              const ActivitySubscriptionSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonDocument json;
@@ -2235,7 +2353,7 @@ void Client::putActivitySubscription(const QString& subject, const AppBskyNotifi
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.notification.putActivitySubscription", json, httpHeaders,
+    return mXrpc->post("app.bsky.notification.putActivitySubscription", json, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2254,7 +2372,7 @@ void Client::putActivitySubscription(const QString& subject, const AppBskyNotifi
         authToken());
 }
 
-void Client::registerPushNotifications(const QString& serviceDid, const QString& token,
+Xrpc::RequestHandle Client::registerPushNotifications(const QString& serviceDid, const QString& token,
                                const QString& platform, const QString& appId,
                                const SuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -2269,7 +2387,7 @@ void Client::registerPushNotifications(const QString& serviceDid, const QString&
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.notification.registerPush", json, httpHeaders,
+    return mXrpc->post("app.bsky.notification.registerPush", json, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() << "registerPush succeeded:" << reply;
             if (successCb)
@@ -2279,14 +2397,17 @@ void Client::registerPushNotifications(const QString& serviceDid, const QString&
         authToken());
 }
 
-void Client::getVideoJobStatus(const QString& jobId, const VideoJobStatusOutputCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getVideoJobStatus(const QString& jobId, const VideoJobStatusOutputCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"jobId", jobId}};
 
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.video.getJobStatus", params, httpHeaders,
+    // Job status is polled while the video gets processed.
+    const Xrpc::Client::PriorityScope priorityScope(*mXrpc, Xrpc::RequestPriority::BACKGROUND);
+
+    return mXrpc->get("app.bsky.video.getJobStatus", params, httpHeaders,
         [successCb](AppBskyVideo::JobStatusOutput::SharedPtr output){
             qDebug() << "Get video job status:" << output->mJobStatus->mRawState;
 
@@ -2297,24 +2418,28 @@ void Client::getVideoJobStatus(const QString& jobId, const VideoJobStatusOutputC
         authToken());
 }
 
-void Client::getVideoUploadLimits(const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getVideoUploadLimits(const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb)
 {
-    getServiceAuth(mServiceDidVideo, {}, "app.bsky.video.getUploadLimits",
-        [this, successCb, errorCb](auto output){
-            getVideoUploadLimits(output->mToken, successCb, errorCb);
+    auto handle = Xrpc::RequestHandle::create();
+
+    handle.chain(getServiceAuthToken(mServiceDidVideo, "app.bsky.video.getUploadLimits",
+        [this, handle, successCb, errorCb](const QString& token){
+            handle.chain(getVideoUploadLimits(token, successCb, errorCb));
         },
         [errorCb](const QString& error, const QString& msg){
             if (errorCb)
                 errorCb(error, msg);
-        });
+        }));
+
+    return handle;
 }
 
-void Client::getVideoUploadLimits(const QString& serviceAuthToken, const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getVideoUploadLimits(const QString& serviceAuthToken, const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.video.getUploadLimits", {}, httpHeaders,
+    return mXrpc->get("app.bsky.video.getUploadLimits", {}, httpHeaders,
         [successCb](AppBskyVideo::GetUploadLimitsOutput::SharedPtr output){
             qDebug() << "Get video upload limits:" << output->mCanUpload;
 
@@ -2326,30 +2451,32 @@ void Client::getVideoUploadLimits(const QString& serviceAuthToken, const GetVide
 }
 
 
-void Client::getServiceAuthForVideoUpload(const ErrorCb& errorCb, std::function<void(const QString& token)> uploadFunc)
+Xrpc::RequestHandle Client::getServiceAuthForVideoUpload(const ErrorCb& errorCb, std::function<Xrpc::RequestHandle(const QString& token)> uploadFunc)
 {
     QUrl url(mXrpc->getPDS());
     QString aud = "did:web:" + url.host();
-    QDateTime expiry = QDateTime::currentDateTimeUtc().addSecs(30 * 60);
+    auto handle = Xrpc::RequestHandle::create();
 
-    getServiceAuth(aud, expiry, "com.atproto.repo.uploadBlob",
-        [presence=getPresence(), errorCb, uploadFunc](auto output){
+    handle.chain(getServiceAuthToken(aud, "com.atproto.repo.uploadBlob",
+        [presence=getPresence(), handle, errorCb, uploadFunc](const QString& token){
             if (presence)
-                uploadFunc(output->mToken);
+                handle.chain(uploadFunc(token));
         },
-        errorCb);
+        errorCb));
+
+    return handle;
 }
 
-void Client::uploadVideo(QIODevice* blob, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::uploadVideo(QIODevice* blob, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb)
 {
     auto uploadFunc = [this, blob, successCb, errorCb](const QString& token){
-        uploadVideo(blob, token, successCb, errorCb);
+        return uploadVideo(blob, token, successCb, errorCb);
     };
 
-    getServiceAuthForVideoUpload(errorCb, uploadFunc);
+    return getServiceAuthForVideoUpload(errorCb, uploadFunc);
 }
 
-void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb)
 {
     const QString name = QUuid::createUuid().toString(QUuid::WithoutBraces);
     qDebug() << "Upload video:" << name << "size:" << blob->size();
@@ -2359,7 +2486,10 @@ void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.video.uploadVideo", params, blob, "video/mp4", httpHeaders,
+    // The job status request for an already uploaded video is part of this request.
+    auto handle = Xrpc::RequestHandle::create();
+
+    handle.chain(mXrpc->post("app.bsky.video.uploadVideo", params, blob, "video/mp4", httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2377,7 +2507,7 @@ void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const
                 invalidJsonError(e, errorCb);
             }
         },
-        [this, presence=getPresence(), successCb, errorCb](const QString& err, const QJsonDocument& reply){
+        [this, presence=getPresence(), handle, successCb, errorCb](const QString& err, const QJsonDocument& reply){
             if (!presence)
                 return;
 
@@ -2392,7 +2522,7 @@ void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const
                 {
                     qDebug() << "Video already exists:" << jobStatus->mJobId;
 
-                    getVideoJobStatus(jobStatus->mJobId,
+                    handle.chain(getVideoJobStatus(jobStatus->mJobId,
                         [successCb](const auto& jobStatusOutput){
                             if (successCb)
                                 successCb(jobStatusOutput->mJobStatus);
@@ -2401,7 +2531,7 @@ void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const
                             qWarning() << error << " - " << message;
                             if (errorCb)
                                 errorCb(error, message);
-                        });
+                        }));
                 }
                 else
                 {
@@ -2412,23 +2542,25 @@ void Client::uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const
                 requestFailed(err, reply, errorCb);
             }
         },
-        serviceAuthToken, true);
+        serviceAuthToken, true));
+
+    return handle;
 }
 
-void Client::videoStartUpload(int sizeInBytes, const QString& mimeType,
+Xrpc::RequestHandle Client::videoStartUpload(int sizeInBytes, const QString& mimeType,
                       const std::optional<QString>& name, std::optional<int> durationMs,
                       std::optional<int> width, std::optional<int> height,
                       const VideoStartUploadOputCb& successCb, const ErrorCb& errorCb)
 {
     auto uploadFunc = [this, sizeInBytes, mimeType, name, durationMs, width, height, successCb, errorCb]
         (const QString& token){
-            videoStartUpload(token, sizeInBytes, mimeType, name, durationMs, width, height, successCb, errorCb);
+            return videoStartUpload(token, sizeInBytes, mimeType, name, durationMs, width, height, successCb, errorCb);
         };
 
-    getServiceAuthForVideoUpload(errorCb, uploadFunc);
+    return getServiceAuthForVideoUpload(errorCb, uploadFunc);
 }
 
-void Client::videoStartUpload(const QString& serviceAuthToken,
+Xrpc::RequestHandle Client::videoStartUpload(const QString& serviceAuthToken,
                       int sizeInBytes, const QString& mimeType,
                       const std::optional<QString>& name, std::optional<int> durationMs,
                       std::optional<int> width, std::optional<int> height,
@@ -2445,7 +2577,7 @@ void Client::videoStartUpload(const QString& serviceAuthToken,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("app.bsky.video.startUpload", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.video.startUpload", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), serviceAuthToken, successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2465,7 +2597,7 @@ void Client::videoStartUpload(const QString& serviceAuthToken,
         serviceAuthToken, true);
 }
 
-void Client::videoUploadPart(QIODevice* blob,
+Xrpc::RequestHandle Client::videoUploadPart(QIODevice* blob,
                              const QString& serviceAuthToken, const QString& jobId, int partNumber,
                              const VideoUploadPartOutputCb& successCb, const ErrorCb& errorCb)
 {
@@ -2476,7 +2608,7 @@ void Client::videoUploadPart(QIODevice* blob,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.video.uploadPart", params, blob, "application/octet-stream", httpHeaders,
+    return mXrpc->post("app.bsky.video.uploadPart", params, blob, "application/octet-stream", httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2496,7 +2628,7 @@ void Client::videoUploadPart(QIODevice* blob,
         serviceAuthToken, true);
 }
 
-void Client::videoFinishUpload(const QString& serviceAuthToken, const QString& jobId,
+Xrpc::RequestHandle Client::videoFinishUpload(const QString& serviceAuthToken, const QString& jobId,
                                const VideoFinishUploadOutputCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Finish upload:" << jobId;
@@ -2506,7 +2638,7 @@ void Client::videoFinishUpload(const QString& serviceAuthToken, const QString& j
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.video.finishUpload", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.video.finishUpload", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2526,7 +2658,7 @@ void Client::videoFinishUpload(const QString& serviceAuthToken, const QString& j
         serviceAuthToken, true);
 }
 
-void Client::videoAbortUpload(const QString& serviceAuthToken, const QString& jobId,
+Xrpc::RequestHandle Client::videoAbortUpload(const QString& serviceAuthToken, const QString& jobId,
                                const VideoAbortUploadOutputCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Aboort upload:" << jobId;
@@ -2536,7 +2668,7 @@ void Client::videoAbortUpload(const QString& serviceAuthToken, const QString& jo
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->post("app.bsky.video.abortUpload", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("app.bsky.video.abortUpload", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2556,10 +2688,10 @@ void Client::videoAbortUpload(const QString& serviceAuthToken, const QString& jo
         serviceAuthToken, true);
 }
 
-void Client::uploadBlob(const QByteArray& blob, const QString& mimeType,
+Xrpc::RequestHandle Client::uploadBlob(const QByteArray& blob, const QString& mimeType,
                         const UploadBlobSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    mXrpc->post("com.atproto.repo.uploadBlob", {}, blob, mimeType, {},
+    return mXrpc->post("com.atproto.repo.uploadBlob", {}, blob, mimeType, {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){\
             if (!presence)
                 return;
@@ -2579,24 +2711,26 @@ void Client::uploadBlob(const QByteArray& blob, const QString& mimeType,
         authToken());
 }
 
-void Client::getBlob(const QString& did, const QString& cid,
+Xrpc::RequestHandle Client::getBlob(const QString& did, const QString& cid,
                      const GetBlobSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    auto continueFunc = [this, cid, successCb]
+    auto handle = Xrpc::RequestHandle::create();
+    auto continueFunc = [this, handle, cid, successCb]
         (const QString& did, const ErrorCb& errorCb, const QString& pds){
-            getBlobContinue(did, cid, successCb, errorCb, pds);
+            handle.chain(getBlobContinue(did, cid, successCb, errorCb, pds));
         };
 
     resolvePds(did, errorCb, continueFunc);
+    return handle;
 }
 
-void Client::getBlobContinue(const QString& did, const QString& cid,
+Xrpc::RequestHandle Client::getBlobContinue(const QString& did, const QString& cid,
                              const GetBlobSuccessCb& successCb, const ErrorCb& errorCb,
                              const QString& pds)
 {
     Xrpc::NetworkThread::Params params{{"did", did}, {"cid", cid}};
 
-    mXrpc->get("com.atproto.sync.getBlob", params, {},
+    return mXrpc->get("com.atproto.sync.getBlob", params, {},
         [successCb](const QByteArray& bytes, const QString& contentType){
             qDebug() <<"Got blob:" << bytes.size() << "bytes" << "content:" << contentType;
 
@@ -2608,19 +2742,68 @@ void Client::getBlobContinue(const QString& did, const QString& cid,
         pds);
 }
 
-void Client::getRecord(const QString& repo, const QString& collection,
+Xrpc::RequestHandle Client::getBlob(const QString& did, const QString& cid, QIODevice* device,
+                                    const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                    const ErrorCb& errorCb)
+{
+    return getBlobStream(did, cid, std::make_shared<Xrpc::StreamTarget>(device), successCb, progressCb, errorCb);
+}
+
+Xrpc::RequestHandle Client::getBlob(const QString& did, const QString& cid, const QString& filePath,
+                                    const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                    const ErrorCb& errorCb)
+{
+    return getBlobStream(did, cid, std::make_shared<Xrpc::StreamTarget>(filePath), successCb, progressCb, errorCb);
+}
+
+Xrpc::RequestHandle Client::getBlobStream(const QString& did, const QString& cid, const Xrpc::StreamTarget::SharedPtr& target,
+                                          const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                          const ErrorCb& errorCb)
+{
+    auto handle = Xrpc::RequestHandle::create();
+    auto continueFunc = [this, handle, cid, target, successCb, progressCb]
+        (const QString& did, const ErrorCb& errorCb, const QString& pds){
+            handle.chain(getBlobStreamContinue(did, cid, target, successCb, progressCb, errorCb, pds));
+        };
+
+    resolvePds(did, errorCb, continueFunc);
+    return handle;
+}
+
+Xrpc::RequestHandle Client::getBlobStreamContinue(const QString& did, const QString& cid, const Xrpc::StreamTarget::SharedPtr& target,
+                                                  const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                                  const ErrorCb& errorCb, const QString& pds)
+{
+    Xrpc::NetworkThread::Params params{{"did", did}, {"cid", cid}};
+
+    return mXrpc->getStream("com.atproto.sync.getBlob", params, target,
+        [successCb](qint64 size, const QString& contentType){
+            qDebug() << "Got blob:" << size << "bytes" << "content:" << contentType;
+
+            if (successCb)
+                successCb(size, contentType);
+        },
+        progressCb,
+        failureInvalidatePds(did, errorCb),
+        {},
+        pds);
+}
+
+Xrpc::RequestHandle Client::getRecord(const QString& repo, const QString& collection,
                        const QString& rkey, const std::optional<QString>& cid,
                        const GetRecordSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    auto continueFunc = [this, collection, rkey, cid, successCb]
+    auto handle = Xrpc::RequestHandle::create();
+    auto continueFunc = [this, handle, collection, rkey, cid, successCb]
         (const QString& repo, const ErrorCb& errorCb, const QString& pds){
-            getRecordContinue(repo, collection, rkey, cid, successCb, errorCb, pds);
+            handle.chain(getRecordContinue(repo, collection, rkey, cid, successCb, errorCb, pds));
         };
 
     resolvePds(repo, errorCb, continueFunc);
+    return handle;
 }
 
-void Client::getRecordContinue(const QString& repo, const QString& collection,
+Xrpc::RequestHandle Client::getRecordContinue(const QString& repo, const QString& collection,
                                const QString& rkey, const std::optional<QString>& cid,
                                const GetRecordSuccessCb& successCb, const ErrorCb& errorCb,
                                const QString& pds)
@@ -2628,7 +2811,7 @@ void Client::getRecordContinue(const QString& repo, const QString& collection,
     Xrpc::NetworkThread::Params params{{"repo", repo}, {"collection", collection}, {"rkey", rkey}};
     addOptionalStringParam(params, "cid", cid);
 
-    mXrpc->get("com.atproto.repo.getRecord", params, {},
+    return mXrpc->get("com.atproto.repo.getRecord", params, {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2649,20 +2832,22 @@ void Client::getRecordContinue(const QString& repo, const QString& collection,
         pds);
 }
 
-void Client::listRecords(const QString& repo, const QString& collection,
+Xrpc::RequestHandle Client::listRecords(const QString& repo, const QString& collection,
                          std::optional<int> limit, const std::optional<QString>& cursor,
                          const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     // listRecprds requests must be sent to the PDS that hosts the repo
-    auto continueFunc = [this, collection, limit, cursor, successCb]
+    auto handle = Xrpc::RequestHandle::create();
+    auto continueFunc = [this, handle, collection, limit, cursor, successCb]
         (const QString& repo, const ErrorCb& errorCb, const QString& pds){
-            listRecordsContinue(repo, collection, limit, cursor, successCb, errorCb, pds);
+            handle.chain(listRecordsContinue(repo, collection, limit, cursor, successCb, errorCb, pds));
         };
 
     resolvePds(repo, errorCb, continueFunc);
+    return handle;
 }
 
-void Client::listRecordsContinue(const QString& repo, const QString& collection,
+Xrpc::RequestHandle Client::listRecordsContinue(const QString& repo, const QString& collection,
                                  std::optional<int> limit, const std::optional<QString>& cursor,
                                  const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb,
                                  const QString& pds)
@@ -2671,7 +2856,7 @@ void Client::listRecordsContinue(const QString& repo, const QString& collection,
     addOptionalIntParam(params, "limit", limit, 1, 100);
     addOptionalStringParam(params, "cursor", cursor);
 
-    mXrpc->get("com.atproto.repo.listRecords", params, {},
+    return mXrpc->get("com.atproto.repo.listRecords", params, {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2692,24 +2877,27 @@ void Client::listRecordsContinue(const QString& repo, const QString& collection,
         pds);
 }
 
-void Client::createRecord(const QString& repo, const QString& collection, const QString& rkey,
-                          const QJsonObject& record, bool validate,
+Xrpc::RequestHandle Client::createRecord(const QString& repo, const QString& collection, const QString& rkey,
+                          const ComATProtoRepo::RecordValue& record, bool validate,
                           const CreateRecordSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    QJsonObject root;
-    root.insert("repo", repo);
-    root.insert("collection", collection);
-    root.insert("record", record);
-    root.insert("validate", validate);
+    JsonWriter writer(RECORD_SIZE_ESTIMATE);
+    writer.beginObject();
+    writer.key("repo").string(repo);
+    writer.key("collection").string(collection);
+    writer.key("record");
+    record.writeJson(writer);
+    writer.key("validate").boolean(validate);
 
     if (!rkey.isEmpty())
-        root.insert("rkey", rkey);
+        writer.key("rkey").string(rkey);
 
-    QJsonDocument json(root);
+    writer.endObject();
+    const QByteArray body = writer.take();
 
-    qDebug() << "Create record:" << json;
+    qDebug() << "Create record:" << body;
 
-    mXrpc->post("com.atproto.repo.createRecord", json, {},
+    return mXrpc->post("com.atproto.repo.createRecord", {}, body, "application/json", {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2729,22 +2917,24 @@ void Client::createRecord(const QString& repo, const QString& collection, const
         authToken());
 }
 
-void Client::putRecord(const QString& repo, const QString& collection, const QString& rkey,
-                       const QJsonObject& record, bool validate,
+Xrpc::RequestHandle Client::putRecord(const QString& repo, const QString& collection, const QString& rkey,
+                       const ComATProtoRepo::RecordValue& record, bool validate,
                        const PutRecordSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    QJsonObject root;
-    root.insert("repo", repo);
-    root.insert("collection", collection);
-    root.insert("record", record);
-    root.insert("rkey", rkey);
-    root.insert("validate", validate);
+    JsonWriter writer(RECORD_SIZE_ESTIMATE);
+    writer.beginObject();
+    writer.key("repo").string(repo);
+    writer.key("collection").string(collection);
+    writer.key("record");
+    record.writeJson(writer);
+    writer.key("rkey").string(rkey);
+    writer.key("validate").boolean(validate);
+    writer.endObject();
+    const QByteArray body = writer.take();
 
-    QJsonDocument json(root);
-
-    qDebug() << "Put record:" << json;
+    qDebug() << "Put record:" << body;
 
-    mXrpc->post("com.atproto.repo.putRecord", json, {},
+    return mXrpc->post("com.atproto.repo.putRecord", {}, body, "application/json", {},
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2764,7 +2954,7 @@ void Client::putRecord(const QString& repo, const QString& collection, const QSt
         authToken());
 }
 
-void Client::deleteRecord(const QString& repo, const QString& collection, const QString& rkey,
+Xrpc::RequestHandle Client::deleteRecord(const QString& repo, const QString& collection, const QString& rkey,
                           const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonDocument jsonDoc;
@@ -2776,7 +2966,7 @@ void Client::deleteRecord(const QString& repo, const QString& collection, const
 
     qDebug() << "Delete record:" << jsonDoc;
 
-    mXrpc->post("com.atproto.repo.deleteRecord", jsonDoc, {},
+    return mXrpc->post("com.atproto.repo.deleteRecord", jsonDoc, {},
         [successCb](const QJsonDocument& reply){
             qDebug() << "Deleted record:" << reply;
             if (successCb)
@@ -2786,28 +2976,29 @@ void Client::deleteRecord(const QString& repo, const QString& collection, const
         authToken());
 }
 
-void Client::applyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate,
-                         const SuccessCb& successCb, const ErrorCb& errorCb)
+QByteArray Client::writeApplyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate)
 {
-    QJsonObject json;
-    json.insert("repo", repo);
-    json.insert("validate", validate);
-    QJsonArray writesArray;
+    JsonWriter writer(APPLY_WRITE_SIZE_ESTIMATE * (qsizetype)writes.size());
+    writer.beginObject();
+    writer.key("repo").string(repo);
+    writer.key("validate").boolean(validate);
+    writer.key("writes").beginArray();
 
     for (const auto& write : writes)
-    {
-        QJsonObject writeJson;
-        std::visit([&writeJson](auto&& x){ writeJson = x->toJson(); }, write);
-        writesArray.push_back(writeJson);
-    }
+        std::visit([&writer](auto&& x){ x->writeJson(writer); }, write);
 
-    json.insert("writes", writesArray);
+    writer.endArray();
+    writer.endObject();
+    return writer.take();
+}
 
-    QJsonDocument jsonDoc;
-    jsonDoc.setObject(json);
-    qDebug() << "Apply writes:" << jsonDoc;
+Xrpc::RequestHandle Client::applyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate,
+                         const SuccessCb& successCb, const ErrorCb& errorCb)
+{
+    const QByteArray body = writeApplyWrites(repo, writes, validate);
+    qDebug() << "Apply writes:" << writes.size() << "bytes:" << body.size();
 
-    mXrpc->post("com.atproto.repo.applyWrites", jsonDoc, {},
+    return mXrpc->post("com.atproto.repo.applyWrites", {}, body, "application/json", {},
         [successCb](const QJsonDocument& reply){
             qDebug() << "Apply writes:" << reply;
             if (successCb)
@@ -2817,7 +3008,7 @@ void Client::applyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesL
         authToken());
 }
 
-void Client::reportAuthor(const QString& did, ComATProtoModeration::ReasonType reasonType,
+Xrpc::RequestHandle Client::reportAuthor(const QString& did, ComATProtoModeration::ReasonType reasonType,
                           const QString& reason, const std::optional<QString>& labelerDid,
                           const SuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -2843,7 +3034,7 @@ void Client::reportAuthor(const QString& did, ComATProtoModeration::ReasonType r
     qDebug() << "Report author:" << jsonDoc;
     qDebug() << "HTTP headers:" << httpHeaders;
 
-    mXrpc->post("com.atproto.moderation.createReport", jsonDoc, httpHeaders,
+    return mXrpc->post("com.atproto.moderation.createReport", jsonDoc, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() <<"Reported author:" << reply;
             if (successCb)
@@ -2853,7 +3044,7 @@ void Client::reportAuthor(const QString& did, ComATProtoModeration::ReasonType r
         authToken());
 }
 
-void Client::reportPostOrFeed(const QString& uri, const QString& cid,
+Xrpc::RequestHandle Client::reportPostOrFeed(const QString& uri, const QString& cid,
                               ComATProtoModeration::ReasonType reasonType,
                               const QString& reason, const std::optional<QString>& labelerDid,
                               const SuccessCb& successCb, const ErrorCb& errorCb)
@@ -2880,7 +3071,7 @@ void Client::reportPostOrFeed(const QString& uri, const QString& cid,
     qDebug() << "Report post or feed:" << jsonDoc;
     qDebug() << "HTTP headers:" << httpHeaders;
 
-    mXrpc->post("com.atproto.moderation.createReport", jsonDoc, httpHeaders,
+    return mXrpc->post("com.atproto.moderation.createReport", jsonDoc, httpHeaders,
         [successCb](const QJsonDocument& reply){
             qDebug() <<"Reported post or feed:" << reply;
             if (successCb)
@@ -2890,7 +3081,7 @@ void Client::reportPostOrFeed(const QString& uri, const QString& cid,
         authToken());
 }
 
-void Client::reportDirectMessage(const QString& did, const QString& convoId, const QString& messageId,
+Xrpc::RequestHandle Client::reportDirectMessage(const QString& did, const QString& convoId, const QString& messageId,
                                  ComATProtoModeration::ReasonType reasonType, const QString& reason,
                                  const SuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -2909,7 +3100,7 @@ void Client::reportDirectMessage(const QString& did, const QString& convoId, con
 
     qDebug() << "Report direct message:" << jsonDoc;
 
-    mXrpc->post("com.atproto.moderation.createReport", jsonDoc, {},
+    return mXrpc->post("com.atproto.moderation.createReport", jsonDoc, {},
         [successCb](const QJsonDocument& reply){
             qDebug() <<"Reported direct message:" << reply;
             if (successCb)
@@ -2919,7 +3110,7 @@ void Client::reportDirectMessage(const QString& did, const QString& convoId, con
         authToken());
 }
 
-void Client::getPopularFeedGenerators(const std::optional<QString>& q, std::optional<int> limit,
+Xrpc::RequestHandle Client::getPopularFeedGenerators(const std::optional<QString>& q, std::optional<int> limit,
                               const std::optional<QString>& cursor,
                               const GetPopularFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -2932,7 +3123,7 @@ void Client::getPopularFeedGenerators(const std::optional<QString>& q, std::opti
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.unspecced.getPopularFeedGenerators", params, httpHeaders,
+    return mXrpc->get("app.bsky.unspecced.getPopularFeedGenerators", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -2952,7 +3143,7 @@ void Client::getPopularFeedGenerators(const std::optional<QString>& q, std::opti
         authToken());
 }
 
-void Client::getSuggestedFeeds(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getSuggestedFeeds(std::optional<int> limit, const std::optional<QString>& cursor,
                        const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -2963,7 +3154,7 @@ void Client::getSuggestedFeeds(std::optional<int> limit, const std::optional<QSt
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.feed.getSuggestedFeeds", params, httpHeaders,
+    return mXrpc->get("app.bsky.feed.getSuggestedFeeds", params, httpHeaders,
         [successCb](AppBskyFeed::GetFeedGeneratorsOutput::SharedPtr feed){
             qDebug() << "getSuggestedFeeds: ok";
 
@@ -2974,7 +3165,7 @@ void Client::getSuggestedFeeds(std::optional<int> limit, const std::optional<QSt
         authToken());
 }
 
-void Client::getSuggestedStarterPacks(std::optional<int> limit,
+Xrpc::RequestHandle Client::getSuggestedStarterPacks(std::optional<int> limit,
                               const GetSuggestedStarterPacksCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -2984,7 +3175,7 @@ void Client::getSuggestedStarterPacks(std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.unspecced.getSuggestedStarterPacks", params, httpHeaders,
+    return mXrpc->get("app.bsky.unspecced.getSuggestedStarterPacks", params, httpHeaders,
         [successCb](AppBskyUnspecced::GetSuggestedStarterPacksOutput::SharedPtr output){
             qDebug() << "getSuggestedStarterPacks: ok";
 
@@ -2995,7 +3186,7 @@ void Client::getSuggestedStarterPacks(std::optional<int> limit,
         authToken());
 }
 
-void Client::getTrends(std::optional<int> limit, const GetTrendsSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getTrends(std::optional<int> limit, const GetTrendsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
     addOptionalIntParam(params, "limit", limit, 1, 25);
@@ -3004,7 +3195,7 @@ void Client::getTrends(std::optional<int> limit, const GetTrendsSuccessCb& succe
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceAppView);
 
-    mXrpc->get("app.bsky.unspecced.getTrends", params, httpHeaders,
+    return mXrpc->get("app.bsky.unspecced.getTrends", params, httpHeaders,
         [successCb, errorCb](AppBskyUnspecced::GetTrendsOutput::SharedPtr output){
             qDebug() << "getTrends:" << output->mTrends.size();
 
@@ -3015,7 +3206,7 @@ void Client::getTrends(std::optional<int> limit, const GetTrendsSuccessCb& succe
         authToken());
 }
 
-void Client::acceptConvo(const QString& convoId,
+Xrpc::RequestHandle Client::acceptConvo(const QString& convoId,
                          const AcceptConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3024,7 +3215,7 @@ void Client::acceptConvo(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.acceptConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.acceptConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3044,7 +3235,7 @@ void Client::acceptConvo(const QString& convoId,
         authToken());
 }
 
-void Client::deleteMessageForSelf(const QString& convoId, const QString& messageId,
+Xrpc::RequestHandle Client::deleteMessageForSelf(const QString& convoId, const QString& messageId,
                           const DeleteMessageSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3054,7 +3245,7 @@ void Client::deleteMessageForSelf(const QString& convoId, const QString& message
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.deleteMessageForSelf", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.deleteMessageForSelf", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3074,7 +3265,7 @@ void Client::deleteMessageForSelf(const QString& convoId, const QString& message
         authToken());
 }
 
-void Client::getConvo(const QString& convoId,
+Xrpc::RequestHandle Client::getConvo(const QString& convoId,
                       const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"convoId", convoId}};
@@ -3083,7 +3274,7 @@ void Client::getConvo(const QString& convoId,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getConvo", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getConvo", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3103,7 +3294,7 @@ void Client::getConvo(const QString& convoId,
         authToken());
 }
 
-void Client::getConvoForMembers(const std::vector<QString>& members,
+Xrpc::RequestHandle Client::getConvoForMembers(const std::vector<QString>& members,
                                 const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Q_ASSERT(members.size() > 0);
@@ -3117,7 +3308,7 @@ void Client::getConvoForMembers(const std::vector<QString>& members,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getConvoForMembers", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getConvoForMembers", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3137,7 +3328,7 @@ void Client::getConvoForMembers(const std::vector<QString>& members,
         authToken());
 }
 
-void Client::getConvoMembers(const QString& convoId, std::optional<int> limit,
+Xrpc::RequestHandle Client::getConvoMembers(const QString& convoId, std::optional<int> limit,
                      const std::optional<QString>& cursor,
                      const GetConvoMembersSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -3149,7 +3340,7 @@ void Client::getConvoMembers(const QString& convoId, std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getConvoMembers", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getConvoMembers", params, httpHeaders,
         [successCb](ChatBskyConvo::GetConvoMembersOutput::SharedPtr output){
             qDebug() << "Members:" << output->mMembers.size();
 
@@ -3160,7 +3351,7 @@ void Client::getConvoMembers(const QString& convoId, std::optional<int> limit,
         authToken());
 }
 
-void Client::getConvoAvailability(const std::vector<QString>& members,
+Xrpc::RequestHandle Client::getConvoAvailability(const std::vector<QString>& members,
                                   const ConvoAvailabilitySuccessCb& successCb, const ErrorCb& errorCb)
 {
     Q_ASSERT(members.size() > 0);
@@ -3174,7 +3365,7 @@ void Client::getConvoAvailability(const std::vector<QString>& members,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getConvoAvailability", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getConvoAvailability", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3194,7 +3385,7 @@ void Client::getConvoAvailability(const std::vector<QString>& members,
         authToken());
 }
 
-void Client::getConvoLog(const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::getConvoLog(const std::optional<QString>& cursor,
                          const ConvoLogSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -3203,7 +3394,7 @@ void Client::getConvoLog(const std::optional<QString>& cursor,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getLog", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getLog", params, httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3223,7 +3414,7 @@ void Client::getConvoLog(const std::optional<QString>& cursor,
         authToken());
 }
 
-void Client::getMessages(const QString& convoId, std::optional<int> limit,
+Xrpc::RequestHandle Client::getMessages(const QString& convoId, std::optional<int> limit,
                          const std::optional<QString>& cursor,
                          const GetMessagesSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -3234,7 +3425,7 @@ void Client::getMessages(const QString& convoId, std::optional<int> limit,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getMessages", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getMessages", params, httpHeaders,
         [successCb](ChatBskyConvo::GetMessagesOutput::SharedPtr output){
             qDebug() << "getMessages:" << output->mMessages.size();
 
@@ -3245,7 +3436,7 @@ void Client::getMessages(const QString& convoId, std::optional<int> limit,
         authToken());
 }
 
-void Client::getConvoUnreadCounts(bool includeGroupChats,
+Xrpc::RequestHandle Client::getConvoUnreadCounts(bool includeGroupChats,
                           const ConvoUnreadCountsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{"includeGroupChats", boolValue(includeGroupChats)}};
@@ -3253,7 +3444,7 @@ void Client::getConvoUnreadCounts(bool includeGroupChats,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.getUnreadCounts", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.getUnreadCounts", params, httpHeaders,
         [successCb](ChatBskyConvo::ConvoUnreadCountsOutput::SharedPtr output){
             qDebug() << "Convo unread:" << output->mUnreadAcceptedConvos << "request:" << output->mUnreadRequestConvos;
 
@@ -3264,7 +3455,7 @@ void Client::getConvoUnreadCounts(bool includeGroupChats,
         authToken());
 }
 
-void Client::leaveConvo(const QString& convoId,
+Xrpc::RequestHandle Client::leaveConvo(const QString& convoId,
                         const LeaveConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3273,7 +3464,7 @@ void Client::leaveConvo(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.leaveConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.leaveConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3293,7 +3484,7 @@ void Client::leaveConvo(const QString& convoId,
         authToken());
 }
 
-void Client::listConvos(std::optional<int> limit, bool onlyUnread,
+Xrpc::RequestHandle Client::listConvos(std::optional<int> limit, bool onlyUnread,
                         std::optional<ChatBskyConvo::ConvoStatus> status,
                         std::optional<ChatBskyConvo::ConvoKind> kind,
                         std::optional<ChatBskyConvo::ConvoLockStatus> lockStatus,
@@ -3320,7 +3511,7 @@ void Client::listConvos(std::optional<int> limit, bool onlyUnread,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.listConvos", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.listConvos", params, httpHeaders,
         [successCb](ChatBskyConvo::ConvoListOutput::SharedPtr output){
             qDebug() << "List convos: ok";
 
@@ -3331,7 +3522,7 @@ void Client::listConvos(std::optional<int> limit, bool onlyUnread,
         authToken());
 }
 
-void Client::listConvoRequests(std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::listConvoRequests(std::optional<int> limit, const std::optional<QString>& cursor,
                        const ConvoRequestListSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -3342,7 +3533,7 @@ void Client::listConvoRequests(std::optional<int> limit, const std::optional<QSt
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.convo.listConvoRequests", params, httpHeaders,
+    return mXrpc->get("chat.bsky.convo.listConvoRequests", params, httpHeaders,
         [successCb](ChatBskyConvo::ConvoRequestListOutput::SharedPtr output){
             qDebug() << "List convo requests:" << output->mRequests.size();
 
@@ -3353,7 +3544,7 @@ void Client::listConvoRequests(std::optional<int> limit, const std::optional<QSt
         authToken());
 }
 
-void Client::lockConvo(const QString& convoId,
+Xrpc::RequestHandle Client::lockConvo(const QString& convoId,
                        const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3363,7 +3554,7 @@ void Client::lockConvo(const QString& convoId,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.lockConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.lockConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3383,7 +3574,7 @@ void Client::lockConvo(const QString& convoId,
         authToken());
 }
 
-void Client::muteConvo(const QString& convoId,
+Xrpc::RequestHandle Client::muteConvo(const QString& convoId,
                        const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3393,7 +3584,7 @@ void Client::muteConvo(const QString& convoId,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.muteConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.muteConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3413,17 +3604,20 @@ void Client::muteConvo(const QString& convoId,
         authToken());
 }
 
-void Client::sendMessage(const QString& convoId, const ChatBskyConvo::MessageInput& message,
+Xrpc::RequestHandle Client::sendMessage(const QString& convoId, const ChatBskyConvo::MessageInput& message,
                          const MessageSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    QJsonObject json;
-    json.insert("convoId", convoId);
-    json.insert("message", message.toJson());
+    JsonWriter writer(RECORD_SIZE_ESTIMATE);
+    writer.beginObject();
+    writer.key("convoId").string(convoId);
+    writer.key("message");
+    message.writeJson(writer);
+    writer.endObject();
 
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.sendMessage", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.sendMessage", {}, writer.take(), "application/json", httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3443,7 +3637,7 @@ void Client::sendMessage(const QString& convoId, const ChatBskyConvo::MessageInp
         authToken());
 }
 
-void Client::unlockConvo(const QString& convoId,
+Xrpc::RequestHandle Client::unlockConvo(const QString& convoId,
                          const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3453,7 +3647,7 @@ void Client::unlockConvo(const QString& convoId,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.unlockConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.unlockConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3473,7 +3667,7 @@ void Client::unlockConvo(const QString& convoId,
         authToken());
 }
 
-void Client::unmuteConvo(const QString& convoId,
+Xrpc::RequestHandle Client::unmuteConvo(const QString& convoId,
                          const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3483,7 +3677,7 @@ void Client::unmuteConvo(const QString& convoId,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.unmuteConvo", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.unmuteConvo", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3503,7 +3697,7 @@ void Client::unmuteConvo(const QString& convoId,
         authToken());
 }
 
-void Client::updateRead(const QString& convoId, const std::optional<QString>& messageId,
+Xrpc::RequestHandle Client::updateRead(const QString& convoId, const std::optional<QString>& messageId,
                         const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3513,7 +3707,7 @@ void Client::updateRead(const QString& convoId, const std::optional<QString>& me
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.updateRead", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.updateRead", QJsonDocument(json), httpHeaders,
         [successCb](ChatBskyConvo::ConvoOutput::SharedPtr output){
             qDebug() << "Update read:" << output->mConvo->mId;
 
@@ -3524,7 +3718,7 @@ void Client::updateRead(const QString& convoId, const std::optional<QString>& me
         authToken());
 }
 
-void Client::updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
+Xrpc::RequestHandle Client::updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
                            const UpdateAllReadSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3535,7 +3729,7 @@ void Client::updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.updateAllRead", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.updateAllRead", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3555,7 +3749,7 @@ void Client::updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
         authToken());
 }
 
-void Client::addReaction(const QString& convoId, const QString& messageId, const QString& value,
+Xrpc::RequestHandle Client::addReaction(const QString& convoId, const QString& messageId, const QString& value,
                  const ReactionSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3566,7 +3760,7 @@ void Client::addReaction(const QString& convoId, const QString& messageId, const
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.addReaction", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.addReaction", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3586,7 +3780,7 @@ void Client::addReaction(const QString& convoId, const QString& messageId, const
         authToken());
 }
 
-void Client::removeReaction(const QString& convoId, const QString& messageId, const QString& value,
+Xrpc::RequestHandle Client::removeReaction(const QString& convoId, const QString& messageId, const QString& value,
                  const ReactionSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3597,7 +3791,7 @@ void Client::removeReaction(const QString& convoId, const QString& messageId, co
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.convo.removeReaction", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.convo.removeReaction", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3617,7 +3811,7 @@ void Client::removeReaction(const QString& convoId, const QString& messageId, co
         authToken());
 }
 
-void Client::addMembers(const QString& convoId, const std::vector<QString>& members,
+Xrpc::RequestHandle Client::addMembers(const QString& convoId, const std::vector<QString>& members,
                         const AddMembersSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3628,7 +3822,7 @@ void Client::addMembers(const QString& convoId, const std::vector<QString>& memb
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.addMembers", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.addMembers", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3648,7 +3842,7 @@ void Client::addMembers(const QString& convoId, const std::vector<QString>& memb
         authToken());
 }
 
-void Client::approveJoinRequest(const QString& convoId, const QString& member,
+Xrpc::RequestHandle Client::approveJoinRequest(const QString& convoId, const QString& member,
                         const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3659,7 +3853,7 @@ void Client::approveJoinRequest(const QString& convoId, const QString& member,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.approveJoinRequest", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.approveJoinRequest", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3679,7 +3873,7 @@ void Client::approveJoinRequest(const QString& convoId, const QString& member,
         authToken());
 }
 
-void Client::createGroup(const std::vector<QString>& members, const QString& name,
+Xrpc::RequestHandle Client::createGroup(const std::vector<QString>& members, const QString& name,
                          const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3690,7 +3884,7 @@ void Client::createGroup(const std::vector<QString>& members, const QString& nam
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.createGroup", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.createGroup", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3710,7 +3904,7 @@ void Client::createGroup(const std::vector<QString>& members, const QString& nam
         authToken());
 }
 
-void Client::createJoinLink(const QString& convoId, bool requireApproval, ChatBskyGroup::JoinRule joinRule,
+Xrpc::RequestHandle Client::createJoinLink(const QString& convoId, bool requireApproval, ChatBskyGroup::JoinRule joinRule,
                             const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3721,7 +3915,7 @@ void Client::createJoinLink(const QString& convoId, bool requireApproval, ChatBs
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.createJoinLink", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.createJoinLink", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3741,7 +3935,7 @@ void Client::createJoinLink(const QString& convoId, bool requireApproval, ChatBs
         authToken());
 }
 
-void Client::disableJoinLink(const QString& convoId,
+Xrpc::RequestHandle Client::disableJoinLink(const QString& convoId,
                              const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3750,7 +3944,7 @@ void Client::disableJoinLink(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.disableJoinLink", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.disableJoinLink", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3770,7 +3964,7 @@ void Client::disableJoinLink(const QString& convoId,
         authToken());
 }
 
-void Client::editGroup(const QString& convoId, const QString& name,
+Xrpc::RequestHandle Client::editGroup(const QString& convoId, const QString& name,
                        const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3781,7 +3975,7 @@ void Client::editGroup(const QString& convoId, const QString& name,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.editGroup", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.editGroup", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3801,7 +3995,7 @@ void Client::editGroup(const QString& convoId, const QString& name,
         authToken());
 }
 
-void Client::editJoinLink(const QString& convoId, std::optional<bool> requireApproval,
+Xrpc::RequestHandle Client::editJoinLink(const QString& convoId, std::optional<bool> requireApproval,
                           std::optional<ChatBskyGroup::JoinRule> joinRule,
                           const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -3817,7 +4011,7 @@ void Client::editJoinLink(const QString& convoId, std::optional<bool> requireApp
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.editJoinLink", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.editJoinLink", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3837,7 +4031,7 @@ void Client::editJoinLink(const QString& convoId, std::optional<bool> requireApp
         authToken());
 }
 
-void Client::enableJoinLink(const QString& convoId,
+Xrpc::RequestHandle Client::enableJoinLink(const QString& convoId,
                             const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3846,7 +4040,7 @@ void Client::enableJoinLink(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.enableJoinLink", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.enableJoinLink", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3866,7 +4060,7 @@ void Client::enableJoinLink(const QString& convoId,
         authToken());
 }
 
-void Client::getJoinLinkPreviews(const std::vector<QString>& codes,
+Xrpc::RequestHandle Client::getJoinLinkPreviews(const std::vector<QString>& codes,
                                  const JoinLinkPreviewsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params;
@@ -3878,7 +4072,7 @@ void Client::getJoinLinkPreviews(const std::vector<QString>& codes,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.group.getJoinLinkPreviews", params, httpHeaders,
+    return mXrpc->get("chat.bsky.group.getJoinLinkPreviews", params, httpHeaders,
         [successCb](ChatBskyGroup::JoinLinkPreviewsOutput::SharedPtr output){
             qDebug() << "Get join link previews:" << output->mJoinLinkPreviews.size();
 
@@ -3889,7 +4083,7 @@ void Client::getJoinLinkPreviews(const std::vector<QString>& codes,
         authToken());
 }
 
-void Client::listJoinRequests(const QString& convoId, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::listJoinRequests(const QString& convoId, std::optional<int> limit, const std::optional<QString>& cursor,
                               const JoinRequestsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{ "convoId", convoId }};
@@ -3900,7 +4094,7 @@ void Client::listJoinRequests(const QString& convoId, std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.group.listJoinRequests", params, httpHeaders,
+    return mXrpc->get("chat.bsky.group.listJoinRequests", params, httpHeaders,
         [successCb](ChatBskyGroup::JoinRequestsOutput::SharedPtr output){
             qDebug() << "List join requests:" << output->mRequests.size();
 
@@ -3911,7 +4105,7 @@ void Client::listJoinRequests(const QString& convoId, std::optional<int> limit,
         authToken());
 }
 
-void Client::listMutualGroups(const QString& subject, std::optional<int> limit, const std::optional<QString>& cursor,
+Xrpc::RequestHandle Client::listMutualGroups(const QString& subject, std::optional<int> limit, const std::optional<QString>& cursor,
                               const ConvoListSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params params{{ "subject", subject }};
@@ -3922,7 +4116,7 @@ void Client::listMutualGroups(const QString& subject, std::optional<int> limit,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.group.listMutualGroups", params, httpHeaders,
+    return mXrpc->get("chat.bsky.group.listMutualGroups", params, httpHeaders,
         [successCb](ChatBskyConvo::ConvoListOutput::SharedPtr output){
             qDebug() << "List mutual groups:" << output->mConvos.size();
 
@@ -3933,7 +4127,7 @@ void Client::listMutualGroups(const QString& subject, std::optional<int> limit,
         authToken());
 }
 
-void Client::rejectJoinRequest(const QString& convoId, const QString& member,
+Xrpc::RequestHandle Client::rejectJoinRequest(const QString& convoId, const QString& member,
                                const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3943,7 +4137,7 @@ void Client::rejectJoinRequest(const QString& convoId, const QString& member,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.rejectJoinRequest", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.rejectJoinRequest", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument&){
             qDebug() << "Rejected join request";
 
@@ -3954,7 +4148,7 @@ void Client::rejectJoinRequest(const QString& convoId, const QString& member,
         authToken());
 }
 
-void Client::removeMembers(const QString& convoId, const std::vector<QString>& members,
+Xrpc::RequestHandle Client::removeMembers(const QString& convoId, const std::vector<QString>& members,
                            const ConvoSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3965,7 +4159,7 @@ void Client::removeMembers(const QString& convoId, const std::vector<QString>& m
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.removeMembers", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.removeMembers", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -3985,7 +4179,7 @@ void Client::removeMembers(const QString& convoId, const std::vector<QString>& m
         authToken());
 }
 
-void Client::requestJoin(const QString& code,
+Xrpc::RequestHandle Client::requestJoin(const QString& code,
                          const RequestJoinSuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -3995,7 +4189,7 @@ void Client::requestJoin(const QString& code,
     addAcceptLabelersHeader(httpHeaders);
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.requestJoin", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.requestJoin", QJsonDocument(json), httpHeaders,
         [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply){
             if (!presence)
                 return;
@@ -4015,7 +4209,7 @@ void Client::requestJoin(const QString& code,
         authToken());
 }
 
-void Client::updateJoinRequestsRead(const QString& convoId,
+Xrpc::RequestHandle Client::updateJoinRequestsRead(const QString& convoId,
                                     const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -4024,7 +4218,7 @@ void Client::updateJoinRequestsRead(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.updateJoinRequestsRead", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.updateJoinRequestsRead", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument&){
             qDebug() << "Updated join requests read";
 
@@ -4035,7 +4229,7 @@ void Client::updateJoinRequestsRead(const QString& convoId,
         authToken());
 }
 
-void Client::withdrawJoinRequest(const QString& convoId,
+Xrpc::RequestHandle Client::withdrawJoinRequest(const QString& convoId,
                                  const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     QJsonObject json;
@@ -4044,7 +4238,7 @@ void Client::withdrawJoinRequest(const QString& convoId,
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.group.withdrawJoinRequest", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.group.withdrawJoinRequest", QJsonDocument(json), httpHeaders,
         [successCb](const QJsonDocument&){
             qDebug() << "Updated join requests read";
 
@@ -4055,12 +4249,12 @@ void Client::withdrawJoinRequest(const QString& convoId,
         authToken());
 }
 
-void Client::getChatNotificationPreferences(const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
+Xrpc::RequestHandle Client::getChatNotificationPreferences(const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->get("chat.bsky.notification.getPreferences", {}, httpHeaders,
+    return mXrpc->get("chat.bsky.notification.getPreferences", {}, httpHeaders,
         [successCb](ChatBskyNotification::GetPreferencesOutput::SharedPtr output){
             qDebug() << "getChatPreferences ok";
 
@@ -4071,7 +4265,7 @@ void Client::getChatNotificationPreferences(const ChatNotificationPreferencesSuc
         authToken());
 }
 
-void Client::putChatNotificationPreferences(const ChatBskyNotification::ChatPreference::SharedPtr& chat,
+Xrpc::RequestHandle Client::putChatNotificationPreferences(const ChatBskyNotification::ChatPreference::SharedPtr& chat,
                         const ChatBskyNotification::ChatPreference::SharedPtr& chatRequest,
                         const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb)
 {
@@ -4085,7 +4279,7 @@ void Client::putChatNotificationPreferences(const ChatBskyNotification::ChatPref
     Xrpc::NetworkThread::Params httpHeaders;
     addAtprotoProxyHeader(httpHeaders, mServiceChat);
 
-    mXrpc->post("chat.bsky.notification.putPreferences", QJsonDocument(json), httpHeaders,
+    return mXrpc->post("chat.bsky.notification.putPreferences", QJsonDocument(json), httpHeaders,
         [this, successCb, errorCb](const QJsonDocument& reply){
             qDebug() << "putPreferences ok";
 
@@ -4372,9 +4566,10 @@ void Client::startAutoRefresh(std::chrono::milliseconds initialDelay, const Auto
 
     mAutoRefreshDoneCb = doneCb;
     mAutoRefreshSessionExpiredCb = sessionExpiredCb;
+    mAutoRefreshActive = true;
 
     if (initialDelay == 0ms)
-        mAutoRefreshTimer.start(AUTO_REFRESH_INTERVAL);
+        scheduleAutoRefresh();
     else
         mAutoRefreshIntialDelayTimer.start(initialDelay);
 }
@@ -4386,10 +4581,50 @@ void Client::stopAutoRefresh()
     if (mSession)
         qDebug() << "Session:" << mSession->mHandle << "did:" << mSession->mDid;
 
+    mAutoRefreshActive = false;
     mAutoRefreshIntialDelayTimer.stop();
     mAutoRefreshTimer.stop();
 }
 
+void Client::setAutoRefreshMargin(std::chrono::seconds margin)
+{
+    qDebug() << "Auto refresh margin:" << margin.count() << "s";
+    mAutoRefreshMargin = margin;
+
+    if (mAutoRefreshActive && mAutoRefreshTimer.isActive())
+        scheduleAutoRefresh();
+}
+
+std::chrono::milliseconds Client::getAutoRefreshDelay() const
+{
+    const QDateTime expiry = mSession ? Jwt::getExpiry(mSession->mAccessJwt) : QDateTime{};
+
+    if (!expiry.isValid())
+        return AUTO_REFRESH_INTERVAL;
+
+    // Wall clock time, such that time spent in suspend is taken into account.
+    const std::chrono::milliseconds lifetime{QDateTime::currentDateTimeUtc().msecsTo(expiry)};
+
+    if (lifetime <= 0ms)
+        return 0ms;
+
+    // A token that lives shorter than the margin gets refreshed halfway.
+    const auto delay = lifetime > 2 * mAutoRefreshMargin ? lifetime - mAutoRefreshMargin : lifetime / 2;
+    return std::max<std::chrono::milliseconds>(delay, MIN_AUTO_REFRESH_DELAY);
+}
+
+std::chrono::milliseconds Client::getAutoRefreshRetryDelay(std::chrono::milliseconds refreshDelay)
+{
+    return std::clamp<std::chrono::milliseconds>(refreshDelay, MIN_AUTO_REFRESH_DELAY, AUTO_REFRESH_RETRY);
+}
+
+void Client::scheduleAutoRefresh()
+{
+    const auto delay = getAutoRefreshDelay();
+    qDebug() << "Schedule auto refresh:" << delay.count() << "ms";
+    mAutoRefreshTimer.start(delay);
+}
+
 void Client::autoRefreshSession(const std::function<void()>& cbDone)
 {
     Q_ASSERT(mSession);
@@ -4410,6 +4645,7 @@ void Client::autoRefreshSession(const std::function<void()>& cbDone)
     }
 
     qDebug() << "Auto refresh session:" << mSession->mHandle << "did:" << mSession->mDid;
+    const Xrpc::Client::PriorityScope priorityScope(*mXrpc, Xrpc::RequestPriority::BACKGROUND);
 
     refreshSession(
         [this, presence=getPresence(), cbDone]{
@@ -4444,7 +4680,10 @@ void Client::autoRefreshSession(const std::function<void()>& cbDone)
             }
             else
             {
-                qDebug() << "Refresh failed, wait for the next interval to refresh:" << mSession->mHandle << "did:" << mSession->mDid;
+                qDebug() << "Refresh failed, retry:" << mSession->mHandle << "did:" << mSession->mDid;
+
+                if (mAutoRefreshActive)
+                    mAutoRefreshTimer.start(getAutoRefreshRetryDelay(getAutoRefreshDelay()));
 
                 // There is nothing we can do now. Signal that we are done.
                 // Session will expire later if token is not valid anymore.
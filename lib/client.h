@@ -2,6 +2,7 @@
 // License: GPLv3
 #pragma once
 #include "presence.h"
+#include "service_auth_cache.h"
 #include "user_preferences.h"
 #include "xjson.h"
 #include "xrpc_client.h"
@@ -38,6 +39,8 @@ private:
     QString mMsg;
 };
 
+// Network functions return a handle to cancel the request. After cancellation
+// the callbacks of the request will not be called.
 class Client : public QObject, public Presence
 {
 public:
@@ -69,9 +72,12 @@ public:
     using GetStarterPacksWithMembershipSuccessCb = std::function<void(AppBskyGraph::GetStarterPacksWithMembershipOutput::SharedPtr)>;
     using GetAccountInviteCodesSuccessCb = std::function<void(ComATProtoServer::GetAccountInviteCodesOutput::SharedPtr)>;
     using GetServiceAuthSuccessCb = std::function<void(ComATProtoServer::GetServiceAuthOutput::SharedPtr)>;
+    using GetServiceAuthTokenSuccessCb = std::function<void(const QString& token)>;
     using RequestEmailUpdateSuccessCb = std::function<void(ComATProtoServer::RequestEmailUpdateOutput::SharedPtr)>;
     using UploadBlobSuccessCb = std::function<void(Blob::SharedPtr)>;
     using GetBlobSuccessCb = std::function<void(const QByteArray& bytes, const QString& contentType)>;
+    using GetBlobStreamSuccessCb = std::function<void(qint64 size, const QString& contentType)>;
+    using ProgressCb = Xrpc::StreamTarget::ProgressCb;
     using GetRecordSuccessCb = std::function<void(ComATProtoRepo::Record::SharedPtr)>;
     using ListRecordsSuccessCb = std::function<void(ComATProtoRepo::ListRecordsOutput::SharedPtr)>;
     using CreateRecordSuccessCb = std::function<void(ComATProtoRepo::StrongRef::SharedPtr)>;
@@ -154,13 +160,19 @@ public:
     static constexpr int MAX_TRENDS = 25;
     static constexpr int MAX_CONVO_MEMBERS = 10;
 
+    // The session gets refreshed this time before the access token expires.
+    static constexpr std::chrono::seconds DEFAULT_AUTO_REFRESH_MARGIN{120};
+    static constexpr std::chrono::seconds AUTO_REFRESH_INTERVAL{299}; // when the expiry of the token is unknown
+    static constexpr std::chrono::seconds AUTO_REFRESH_RETRY{30};
+    static constexpr std::chrono::seconds MIN_AUTO_REFRESH_DELAY{10};
+
     static constexpr const char* SERVICE_APP_VIEW = "";
     static constexpr const char* SERVICE_CHAT = "did:web:api.bsky.chat#bsky_chat";
     static constexpr const char* SERVICE_VIDEO_DID = "did:web:video.bsky.app";
     static constexpr const char* SERVICE_VIDEO_HOST = "https://video.bsky.app";
     static constexpr const char* PUBLIC_API_HOST = "https://public.api.bsky.app";
 
-    static SharedPtr createPublicApiClient(QObject* parent = nullptr);
+    static SharedPtr createPublicApiClient(QObject* parent = nullptr, Xrpc::NetworkEngine::SharedPtr engine = nullptr);
 
     explicit Client(Xrpc::Client::Ptr&& xrpc, QObject* parent = nullptr);
 
@@ -185,8 +197,8 @@ public:
     Xrpc::Client* getXrpcClient() const { return mXrpc.get(); }
     const QString& getPDS() const { return mXrpc->getPDS(); }
     const ComATProtoServer::Session* getSession() const { return mSession.get(); }
-    void setSession(ComATProtoServer::Session::SharedPtr session) { mSession = std::move(session); }
-    void clearSession() { mSession = nullptr; }
+    void setSession(ComATProtoServer::Session::SharedPtr session);
+    void clearSession() { mSession = nullptr; mServiceAuthCache.clear(); }
     void updateSessionTokens(const QString& accessJwt, const QString& refreshJwt);
     void updateSession2FA(bool enabled);
     void updateSessionEmailConfirmed(bool confirmed);
@@ -198,9 +210,18 @@ public:
     bool addLabelerDid(const QString& did);
     void removeLabelerDid(const QString& did);
 
+    // Auto refresh is scheduled by the expiry of the access token. The first refresh
+    // is scheduled after the initial delay. When the application becomes active, the
+    // refresh is rescheduled, as timers do not run during suspend.
     void startAutoRefresh(std::chrono::milliseconds initialDelay, const AutoRefreshDoneCb& doneCb, const AutoRefreshSessionExpiredCb& sessionExpiredCb);
     void stopAutoRefresh();
     void autoRefreshSession(const std::function<void()>& cbDone = {});
+    void setAutoRefreshMargin(std::chrono::seconds margin);
+    std::chrono::milliseconds getAutoRefreshDelay() const;
+
+    // Delay till a failed refresh is retried, given the delay till the refresh was
+    // due. The retry is not before the minimum delay, also when the token expired.
+    static std::chrono::milliseconds getAutoRefreshRetryDelay(std::chrono::milliseconds refreshDelay);
 
     // com.atproto.server
     /**
@@ -242,10 +263,12 @@ public:
      * @brief refreshSession (both passwd and oauth)
      * @param successCb
      * @param errorCb
+     *
+     * A refresh while a refresh is in progress joins the refresh in progress.
      */
     void refreshSession(const SuccessCb& successCb, const ErrorCb& errorCb);
 
-    void getAccountInviteCodes(const GetAccountInviteCodesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getAccountInviteCodes(const GetAccountInviteCodesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getServiceAuth
@@ -255,15 +278,21 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getServiceAuth(const QString& aud, const std::optional<QDateTime>& expiry, const std::optional<QString>& lexiconMethod,
-                        const GetServiceAuthSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getServiceAuth(const QString& aud, const std::optional<QDateTime>& expiry, const std::optional<QString>& lexiconMethod,
+                                       const GetServiceAuthSuccessCb& successCb, const ErrorCb& errorCb);
+
+    // Service auth token from the cache. A new token is fetched when the cached token is
+    // about to expire. Concurrent calls for the same audience and method share one fetch.
+    Xrpc::RequestHandle getServiceAuthToken(const QString& aud, const QString& lexiconMethod,
+                                            const GetServiceAuthTokenSuccessCb& successCb, const ErrorCb& errorCb);
+    const ServiceAuthCache& getServiceAuthCache() const { return mServiceAuthCache; }
 
     /**
      * @brief requestEmailUpdate Request a token in order to update email
      * @param successCb
      * @param errorCb
      */
-    void requestEmailUpdate(const RequestEmailUpdateSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle requestEmailUpdate(const RequestEmailUpdateSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief updateEmail
@@ -273,8 +302,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void updateEmail(const QString& email, std::optional<bool> emailAuthFactor, const std::optional<QString>& token,
-                     const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateEmail(const QString& email, std::optional<bool> emailAuthFactor, const std::optional<QString>& token,
+                                    const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief requestPasswordReset Initiate a user account password reset via email
@@ -282,7 +311,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void requestPasswordReset(const QString& email, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle requestPasswordReset(const QString& email, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief resetPassword
@@ -291,15 +320,15 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void resetPassword(const QString& password, const QString& token,
-                       const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle resetPassword(const QString& password, const QString& token,
+                                      const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief requestEmailConfirmation Request an email with a code to confirm ownership of email
      * @param successCb
      * @param errorCb
      */
-    void requestEmailConfirmation(const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle requestEmailConfirmation(const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief confirmEmail
@@ -308,8 +337,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void confirmEmail(const QString& email, const QString& token,
-                      const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle confirmEmail(const QString& email, const QString& token,
+                                     const SuccessCb& successCb, const ErrorCb& errorCb);
 
     // com.atproto.identity
     /**
@@ -320,8 +349,8 @@ public:
      *
      * Can be called on public API without auth
      */
-    void resolveHandle(const QString& handle,
-                       const ResolveHandleSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle resolveHandle(const QString& handle,
+                                      const ResolveHandleSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.actor
     /**
@@ -330,7 +359,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getProfile(const QString& user, const GetProfileSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getProfile(const QString& user, const GetProfileSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getProfiles
@@ -338,11 +367,11 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getProfiles(const std::vector<QString>& users, const GetProfilesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getProfiles(const std::vector<QString>& users, const GetProfilesSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void getPreferences(const UserPrefsSuccessCb& successCb, const ErrorCb& errorCb);
-    void putPreferences(const UserPreferences& userPrefs,
-                        const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getPreferences(const UserPrefsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putPreferences(const UserPreferences& userPrefs,
+                                       const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief searchActors
@@ -352,8 +381,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void searchActors(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
-                      const SearchActorsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle searchActors(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
+                                     const SearchActorsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief searchActorsTypeahead
@@ -364,8 +393,8 @@ public:
      *
      * Can be called on public API without auth
      */
-    void searchActorsTypeahead(const QString& q, std::optional<int> limit,
-                               const SearchActorsTypeaheadSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle searchActorsTypeahead(const QString& q, std::optional<int> limit,
+                                              const SearchActorsTypeaheadSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getSuggestions
@@ -375,9 +404,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getSuggestions(std::optional<int> limit, const std::optional<QString>& cursor,
-                        const QStringList& acceptLanguages,
-                        const GetSuggestionsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getSuggestions(std::optional<int> limit, const std::optional<QString>& cursor,
+                                       const QStringList& acceptLanguages,
+                                       const GetSuggestionsSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.bookmark
     /**
@@ -387,7 +416,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void createBookmark(QString uri, QString cid, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle createBookmark(QString uri, QString cid, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief deleteBookmark
@@ -395,7 +424,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void deleteBookmark(QString uri, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle deleteBookmark(QString uri, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getBookmarks
@@ -404,8 +433,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getBookmarks(std::optional<int> limit, const std::optional<QString>& cursor,
-                      const GetBookmarksSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getBookmarks(std::optional<int> limit, const std::optional<QString>& cursor,
+                                     const GetBookmarksSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.labeler
     /**
@@ -415,8 +444,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getServices(const std::vector<QString>& dids, bool detailed,
-                     const GetServicesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getServices(const std::vector<QString>& dids, bool detailed,
+                                    const GetServicesSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.embed
     /**
@@ -426,8 +455,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getEmbedExternalView(const QString& url, const std::vector<QString> uris,
-                              const GetEmbedExternalViewCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getEmbedExternalView(const QString& url, const std::vector<QString> uris,
+                                             const GetEmbedExternalViewCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.feed
     /**
@@ -440,9 +469,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getAuthorFeed(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
-                       const std::optional<QString> filter, std::optional<bool> includePins,
-                       const GetAuthorFeedSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getAuthorFeed(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const std::optional<QString> filter, std::optional<bool> includePins,
+                                      const GetAuthorFeedSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getActorLikes Get a list of posts liked by an actor.
@@ -452,8 +481,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getActorLikes(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
-                       const GetActorLikesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getActorLikes(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const GetActorLikesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getTimeline
@@ -462,8 +491,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getTimeline(std::optional<int> limit, const std::optional<QString>& cursor,
-                     const GetTimelineSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getTimeline(std::optional<int> limit, const std::optional<QString>& cursor,
+                                    const GetTimelineSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getFeed
@@ -474,9 +503,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getFeed(const QString& feed, std::optional<int> limit, const std::optional<QString>& cursor,
-                 const QStringList& acceptLanguages,
-                 const GetFeedSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getFeed(const QString& feed, std::optional<int> limit, const std::optional<QString>& cursor,
+                                const QStringList& acceptLanguages,
+                                const GetFeedSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getListFeed
@@ -487,9 +516,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getListFeed(const QString& list, std::optional<int> limit, const std::optional<QString>& cursor,
-                     const QStringList& acceptLanguages,
-                     const GetFeedSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getListFeed(const QString& list, std::optional<int> limit, const std::optional<QString>& cursor,
+                                    const QStringList& acceptLanguages,
+                                    const GetFeedSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getFeedGenerator
@@ -497,8 +526,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getFeedGenerator(const QString& feed,
-                          const GetFeedGeneratorSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getFeedGenerator(const QString& feed,
+                                         const GetFeedGeneratorSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getFeedGenerators
@@ -506,8 +535,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getFeedGenerators(const std::vector<QString>& feeds,
-                           const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getFeedGenerators(const std::vector<QString>& feeds,
+                                          const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getActorFeeds Get a list of feeds created by the actor.
@@ -517,8 +546,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getActorFeeds(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
-                       const GetActorFeedsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getActorFeeds(const QString& user, std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const GetActorFeedsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getPostThread
@@ -528,8 +557,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getPostThread(const QString& uri, std::optional<int> depth, std::optional<int> parentHeight,
-                       const GetPostThreadSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getPostThread(const QString& uri, std::optional<int> depth, std::optional<int> parentHeight,
+                                      const GetPostThreadSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getPosts
@@ -537,8 +566,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getPosts(const std::vector<QString>& uris,
-                  const GetPostsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getPosts(const std::vector<QString>& uris,
+                                 const GetPostsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getQuotes
@@ -549,8 +578,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getQuotes(const QString& uri, const std::optional<QString>& cid, std::optional<int> limit,
-                   const std::optional<QString>& cursor, const GetQuotesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getQuotes(const QString& uri, const std::optional<QString>& cid, std::optional<int> limit,
+                                  const std::optional<QString>& cursor, const GetQuotesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief searchPosts
@@ -567,11 +596,11 @@ public:
      * @param errorCb
      */
     // TODO: DEPRECATED
-    void searchPosts(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
-                     const std::optional<QString>& sort, const std::optional<QString>& author,
-                     const std::optional<QString>& mentions, const std::optional<QDateTime>& since,
-                     const std::optional<QDateTime>& until, const std::optional<QString>& lang,
-                     const SearchPostsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle searchPosts(const QString& q, std::optional<int> limit, const std::optional<QString>& cursor,
+                                    const std::optional<QString>& sort, const std::optional<QString>& author,
+                                    const std::optional<QString>& mentions, const std::optional<QDateTime>& since,
+                                    const std::optional<QDateTime>& until, const std::optional<QString>& lang,
+                                    const SearchPostsSuccessCb& successCb, const ErrorCb& errorCb);
 
     class SearchParams
     {
@@ -609,9 +638,9 @@ public:
         Xrpc::NetworkThread::Params mParams;
     };
 
-    void searchPostsV2(const QString& query, std::optional<int> limit, const std::optional<QString>& cursor,
-                       const SearchParams& searchParams,
-                       const SearchPostsV2SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle searchPostsV2(const QString& query, std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const SearchParams& searchParams,
+                                      const SearchPostsV2SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getLikes
@@ -621,8 +650,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getLikes(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
-                  const GetLikesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getLikes(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
+                                 const GetLikesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getRepostedBy
@@ -632,8 +661,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getRepostedBy(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
-                       const GetRepostedBySuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getRepostedBy(const QString& uri, std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const GetRepostedBySuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief sendInteractions
@@ -643,8 +672,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void sendInteractions(const std::optional<QString>& feedUri, const AppBskyFeed::Interaction::List& interactions,
-                          const QString& feedDid, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle sendInteractions(const std::optional<QString>& feedUri, const AppBskyFeed::Interaction::List& interactions,
+                                         const QString& feedDid, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getSuggestedFeeds
@@ -653,8 +682,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getSuggestedFeeds(std::optional<int> limit, const std::optional<QString>& cursor,
-                           const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getSuggestedFeeds(std::optional<int> limit, const std::optional<QString>& cursor,
+                                          const GetFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.draft
 
@@ -665,8 +694,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getDrafts(std::optional<int> limit, const std::optional<QString>& cursor,
-                   const GetDraftsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getDrafts(std::optional<int> limit, const std::optional<QString>& cursor,
+                                  const GetDraftsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief createDraft
@@ -674,8 +703,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
-                     const CreateDraftSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle createDraft(const AppBskyDraft::Draft::SharedPtr& draft,
+                                    const CreateDraftSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief deleteDraft
@@ -683,7 +712,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void deleteDraft(const QString& id, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle deleteDraft(const QString& id, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief updateDraft
@@ -691,8 +720,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
-                     const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateDraft(const AppBskyDraft::DraftWithId::SharedPtr& draft,
+                                    const SuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.graph
 
@@ -705,9 +734,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getFollows(const QString& actor, std::optional<int> limit,
-                    const std::optional<QString>& cursor, const std::optional<QString>& sort,
-                    const GetFollowsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getFollows(const QString& actor, std::optional<int> limit,
+                                   const std::optional<QString>& cursor, const std::optional<QString>& sort,
+                                   const GetFollowsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getFollowers
@@ -717,20 +746,20 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getFollowers(const QString& actor, std::optional<int> limit,
-                      const std::optional<QString>& cursor, const std::optional<QString>& sort,
-                      const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getFollowers(const QString& actor, std::optional<int> limit,
+                                     const std::optional<QString>& cursor, const std::optional<QString>& sort,
+                                     const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void getKnownFollowers(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
-                           const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getKnownFollowers(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
+                                          const GetFollowersSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void getBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
-                   const GetBlocksSuccessCb& successCb, const ErrorCb& errorCb);
-    void getMutes(std::optional<int> limit, const std::optional<QString>& cursor,
-                  const GetMutesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
+                                  const GetBlocksSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getMutes(std::optional<int> limit, const std::optional<QString>& cursor,
+                                 const GetMutesSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void muteActor(const QString& actor, std::optional<bool> onlyReposts, std::optional<bool> onlyQuotePosts, const SuccessCb& successCb, const ErrorCb& errorCb);
-    void unmuteActor(const QString& actor, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle muteActor(const QString& actor, std::optional<bool> onlyReposts, std::optional<bool> onlyQuotePosts, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle unmuteActor(const QString& actor, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief muteThread
@@ -738,8 +767,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void muteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb);
-    void unmuteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle muteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle unmuteThread(const QString& root, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getList
@@ -749,8 +778,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getList(const QString& listUri, std::optional<int> limit, const std::optional<QString>& cursor,
-                 const GetListSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getList(const QString& listUri, std::optional<int> limit, const std::optional<QString>& cursor,
+                                const GetListSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getLists Get a list of lists that belong to an actor.
@@ -761,9 +790,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getLists(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
-                  std::optional<int> limit, const std::optional<QString>& cursor,
-                  const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getLists(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
+                                 std::optional<int> limit, const std::optional<QString>& cursor,
+                                 const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getListsWithMembership Get lists of the current user
@@ -774,12 +803,12 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getListsWithMembership(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
-                                std::optional<int> limit, const std::optional<QString>& cursor,
-                                const GetListsWithMembershipSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getListsWithMembership(const QString& actor, const std::vector<AppBskyGraph::ListPurpose>& purposes,
+                                               std::optional<int> limit, const std::optional<QString>& cursor,
+                                               const GetListsWithMembershipSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void muteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb);
-    void unmuteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle muteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle unmuteActorList(const QString& listUri, const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getListBlocks Get lists that the actor is blocking.
@@ -788,10 +817,10 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getListBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
-                       const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
-    void getListMutes(std::optional<int> limit, const std::optional<QString>& cursor,
-                      const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getListBlocks(std::optional<int> limit, const std::optional<QString>& cursor,
+                                      const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getListMutes(std::optional<int> limit, const std::optional<QString>& cursor,
+                                     const GetListsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getActorStarterPacks
@@ -801,8 +830,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getActorStarterPacks(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
-                              const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getActorStarterPacks(const QString& actor, std::optional<int> limit, const std::optional<QString>& cursor,
+                                             const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getStarterPacks
@@ -810,8 +839,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getStarterPacks(const std::vector<QString>& uris,
-                         const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getStarterPacks(const std::vector<QString>& uris,
+                                        const GetStarterPacksSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getStarterPacksWithMembership Get starter packs of the current user
@@ -821,9 +850,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getStarterpacksWithMembership(const QString& actor,
-                                std::optional<int> limit, const std::optional<QString>& cursor,
-                                const GetStarterPacksWithMembershipSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getStarterpacksWithMembership(const QString& actor,
+                                               std::optional<int> limit, const std::optional<QString>& cursor,
+                                               const GetStarterPacksWithMembershipSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getStarterPack
@@ -831,7 +860,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getStarterPack(const QString& starterPack, const GetStarterPackSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getStarterPack(const QString& starterPack, const GetStarterPackSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getSuggestedFollows
@@ -839,8 +868,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getSuggestedFollows(const QString& user, const QStringList& acceptLanguages,
-                             const GetSuggestedFollowsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getSuggestedFollows(const QString& user, const QStringList& acceptLanguages,
+                                            const GetSuggestedFollowsSuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.notification
 
@@ -851,11 +880,11 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getUnreadNotificationCount(const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
-                                    const UnreadCountSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getUnreadNotificationCount(const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
+                                                   const UnreadCountSuccessCb& successCb, const ErrorCb& errorCb);
 
-    void updateNotificationSeen(const QDateTime& dateTime,
-                                const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateNotificationSeen(const QDateTime& dateTime,
+                                               const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listNotifications
@@ -867,21 +896,21 @@ public:
      * @param errorCb
      * @param updateSeen update the seen timestamp to the time of sending this request
      */
-    void listNotifications(std::optional<int> limit, const std::optional<QString>& cursor,
-                           const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
-                           const std::vector<AppBskyNotification::NotificationReason> reasons,
-                           const NotificationsSuccessCb& successCb, const ErrorCb& errorCb,
-                           bool updateSeen = false);
+    Xrpc::RequestHandle listNotifications(std::optional<int> limit, const std::optional<QString>& cursor,
+                                          const std::optional<QDateTime>& seenAt, std::optional<bool> priority,
+                                          const std::vector<AppBskyNotification::NotificationReason> reasons,
+                                          const NotificationsSuccessCb& successCb, const ErrorCb& errorCb,
+                                          bool updateSeen = false);
 
-    void putNotificationPreferences(bool priority,
-                                    const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putNotificationPreferences(bool priority,
+                                                   const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief app.bsky.notification.getPreferences
      * @param successCb
      * @param errorCb
      */
-    void getNotificationPreferences(const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getNotificationPreferences(const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief app.bsky.notification.putPreferencesV2
@@ -889,8 +918,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void putNotificationPreferencesV2(const AppBskyNotification::Preferences& prefs,
-                                      const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putNotificationPreferencesV2(const AppBskyNotification::Preferences& prefs,
+                                                     const NotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief app.bsky.notification.listActivitySubscriptions
@@ -899,8 +928,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listActivitySubscriptions(std::optional<int> limit, const std::optional<QString>& cursor,
-                                   const ListActivitySubscriptionsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listActivitySubscriptions(std::optional<int> limit, const std::optional<QString>& cursor,
+                                                  const ListActivitySubscriptionsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief app.bsky.notification.putActivitySubscription
@@ -909,8 +938,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void putActivitySubscription(const QString& subject, const AppBskyNotification::ActivitySubscription& subscription,
-                                 const ActivitySubscriptionSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putActivitySubscription(const QString& subject, const AppBskyNotification::ActivitySubscription& subscription,
+                                                const ActivitySubscriptionSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief registerPushNotifications
@@ -921,9 +950,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void registerPushNotifications(const QString& serviceDid, const QString& token,
-                                   const QString& platform, const QString& appId,
-                                   const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle registerPushNotifications(const QString& serviceDid, const QString& token,
+                                                  const QString& platform, const QString& appId,
+                                                  const SuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.video
 
@@ -933,15 +962,15 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getVideoJobStatus(const QString& jobId, const VideoJobStatusOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getVideoJobStatus(const QString& jobId, const VideoJobStatusOutputCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getVideoUploadLimits
      * @param successCb
      * @param errorCb
      */
-    void getVideoUploadLimits(const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb);
-    void getVideoUploadLimits(const QString& serviceAuthToken, const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getVideoUploadLimits(const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getVideoUploadLimits(const QString& serviceAuthToken, const GetVideoUploadLimitsCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief uploadVideo
@@ -949,8 +978,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void uploadVideo(QIODevice* blob, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb);
-    void uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle uploadVideo(QIODevice* blob, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle uploadVideo(QIODevice* blob, const QString& serviceAuthToken, const VideoUploadOutputCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief videoStartUpload
@@ -963,26 +992,26 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void videoStartUpload(int sizeInBytes, const QString& mimeType,
-                          const std::optional<QString>& name, std::optional<int> durationMs,
-                          std::optional<int> width, std::optional<int> height,
-                          const VideoStartUploadOputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle videoStartUpload(int sizeInBytes, const QString& mimeType,
+                                         const std::optional<QString>& name, std::optional<int> durationMs,
+                                         std::optional<int> width, std::optional<int> height,
+                                         const VideoStartUploadOputCb& successCb, const ErrorCb& errorCb);
 
-    void videoStartUpload(const QString& serviceAuthToken,
-                          int sizeInBytes, const QString& mimeType,
-                          const std::optional<QString>& name, std::optional<int> durationMs,
-                          std::optional<int> width, std::optional<int> height,
-                          const VideoStartUploadOputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle videoStartUpload(const QString& serviceAuthToken,
+                                         int sizeInBytes, const QString& mimeType,
+                                         const std::optional<QString>& name, std::optional<int> durationMs,
+                                         std::optional<int> width, std::optional<int> height,
+                                         const VideoStartUploadOputCb& successCb, const ErrorCb& errorCb);
 
-    void videoUploadPart(QIODevice* blob,
-                         const QString& serviceAuthToken, const QString& jobId, int partNumber,
-                         const VideoUploadPartOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle videoUploadPart(QIODevice* blob,
+                                        const QString& serviceAuthToken, const QString& jobId, int partNumber,
+                                        const VideoUploadPartOutputCb& successCb, const ErrorCb& errorCb);
 
-    void videoFinishUpload(const QString& serviceAuthToken, const QString& jobId,
-                           const VideoFinishUploadOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle videoFinishUpload(const QString& serviceAuthToken, const QString& jobId,
+                                          const VideoFinishUploadOutputCb& successCb, const ErrorCb& errorCb);
 
-    void videoAbortUpload(const QString& serviceAuthToken, const QString& jobId,
-                          const VideoAbortUploadOutputCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle videoAbortUpload(const QString& serviceAuthToken, const QString& jobId,
+                                         const VideoAbortUploadOutputCb& successCb, const ErrorCb& errorCb);
 
     // com.atproto.repo
 
@@ -993,8 +1022,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void uploadBlob(const QByteArray& blob, const QString& mimeType,
-                    const UploadBlobSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle uploadBlob(const QByteArray& blob, const QString& mimeType,
+                                   const UploadBlobSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getRecord
@@ -1005,9 +1034,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getRecord(const QString& repo, const QString& collection,
-                   const QString& rkey, const std::optional<QString>& cid,
-                   const GetRecordSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getRecord(const QString& repo, const QString& collection,
+                                  const QString& rkey, const std::optional<QString>& cid,
+                                  const GetRecordSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listRecords
@@ -1018,9 +1047,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listRecords(const QString& repo, const QString& collection,
-                     std::optional<int> limit, const std::optional<QString>& cursor,
-                     const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listRecords(const QString& repo, const QString& collection,
+                                    std::optional<int> limit, const std::optional<QString>& cursor,
+                                    const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief createRecord
@@ -1032,9 +1061,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void createRecord(const QString& repo, const QString& collection, const QString& rkey,
-                      const QJsonObject& record, bool validate,
-                      const CreateRecordSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle createRecord(const QString& repo, const QString& collection, const QString& rkey,
+                                     const ComATProtoRepo::RecordValue& record, bool validate,
+                                     const CreateRecordSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief putRecord create or update a record
@@ -1046,9 +1075,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void putRecord(const QString& repo, const QString& collection, const QString& rkey,
-                   const QJsonObject& record, bool validate,
-                   const PutRecordSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putRecord(const QString& repo, const QString& collection, const QString& rkey,
+                                  const ComATProtoRepo::RecordValue& record, bool validate,
+                                  const PutRecordSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief deleteRecord
@@ -1058,8 +1087,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void deleteRecord(const QString& repo, const QString& collection, const QString& rkey,
-                      const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle deleteRecord(const QString& repo, const QString& collection, const QString& rkey,
+                                     const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief applyWrites
@@ -1069,8 +1098,12 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void applyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate,
-                     const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle applyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate,
+                                    const SuccessCb& successCb, const ErrorCb& errorCb);
+
+    // Request body of applyWrites. The records are written without building a document
+    // for the batch.
+    static QByteArray writeApplyWrites(const QString& repo, const ComATProtoRepo::ApplyWritesList& writes, bool validate);
 
     // com.atproto.sync
 
@@ -1083,8 +1116,38 @@ public:
      *
      * PDS will be resolved from the did
      */
-    void getBlob(const QString& did, const QString& cid,
-                 const GetBlobSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getBlob(const QString& did, const QString& cid,
+                                const GetBlobSuccessCb& successCb, const ErrorCb& errorCb);
+
+    /**
+     * @brief getBlob streams the blob to a device as it arrives
+     * @param did
+     * @param cid
+     * @param device open for writing, must not be used till a callback is called
+     * @param successCb
+     * @param progressCb (optional)
+     * @param errorCb
+     *
+     * PDS will be resolved from the did
+     */
+    Xrpc::RequestHandle getBlob(const QString& did, const QString& cid, QIODevice* device,
+                                const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                const ErrorCb& errorCb);
+
+    /**
+     * @brief getBlob streams the blob to a file as it arrives
+     * @param did
+     * @param cid
+     * @param filePath the file is only created when the download is complete
+     * @param successCb
+     * @param progressCb (optional)
+     * @param errorCb
+     *
+     * PDS will be resolved from the did
+     */
+    Xrpc::RequestHandle getBlob(const QString& did, const QString& cid, const QString& filePath,
+                                const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                const ErrorCb& errorCb);
 
     // com.atproto.moderation
 
@@ -1097,9 +1160,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void reportAuthor(const QString& did, ComATProtoModeration::ReasonType reasonType,
-                      const QString& reason, const std::optional<QString>& labelerDid,
-                      const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle reportAuthor(const QString& did, ComATProtoModeration::ReasonType reasonType,
+                                     const QString& reason, const std::optional<QString>& labelerDid,
+                                     const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief reportPostOrFeed
@@ -1111,10 +1174,10 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void reportPostOrFeed(const QString& uri, const QString& cid,
-                          ComATProtoModeration::ReasonType reasonType,
-                          const QString& reason, const std::optional<QString>& labelerDid,
-                          const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle reportPostOrFeed(const QString& uri, const QString& cid,
+                                         ComATProtoModeration::ReasonType reasonType,
+                                         const QString& reason, const std::optional<QString>& labelerDid,
+                                         const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief reportDirectMessage
@@ -1126,9 +1189,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void reportDirectMessage(const QString& did, const QString& convoId, const QString& messageId,
-                             ComATProtoModeration::ReasonType reasonType, const QString& reason,
-                             const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle reportDirectMessage(const QString& did, const QString& convoId, const QString& messageId,
+                                            ComATProtoModeration::ReasonType reasonType, const QString& reason,
+                                            const SuccessCb& successCb, const ErrorCb& errorCb);
 
     // app.bsky.unspecced
 
@@ -1140,9 +1203,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getPopularFeedGenerators(const std::optional<QString>& q, std::optional<int> limit,
-                                  const std::optional<QString>& cursor,
-                                  const GetPopularFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getPopularFeedGenerators(const std::optional<QString>& q, std::optional<int> limit,
+                                                 const std::optional<QString>& cursor,
+                                                 const GetPopularFeedGeneratorsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getSuggestedStarterPacks
@@ -1150,8 +1213,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getSuggestedStarterPacks(std::optional<int> limit,
-                                  const GetSuggestedStarterPacksCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getSuggestedStarterPacks(std::optional<int> limit,
+                                                 const GetSuggestedStarterPacksCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getTrends
@@ -1159,7 +1222,7 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getTrends(std::optional<int> limit, const GetTrendsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getTrends(std::optional<int> limit, const GetTrendsSuccessCb& successCb, const ErrorCb& errorCb);
 
     // chat.bsky.convo
 
@@ -1169,8 +1232,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void acceptConvo(const QString& convoId,
-                     const AcceptConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle acceptConvo(const QString& convoId,
+                                    const AcceptConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief deleteMessageForSelf
@@ -1179,8 +1242,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void deleteMessageForSelf(const QString& convoId, const QString& messageId,
-                              const DeleteMessageSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle deleteMessageForSelf(const QString& convoId, const QString& messageId,
+                                             const DeleteMessageSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvo
@@ -1188,8 +1251,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvo(const QString& convoId,
-                  const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvo(const QString& convoId,
+                                 const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvoForMembers
@@ -1197,8 +1260,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvoForMembers(const std::vector<QString>& members,
-                            const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvoForMembers(const std::vector<QString>& members,
+                                           const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvoMembers
@@ -1208,9 +1271,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvoMembers(const QString& convoId, std::optional<int> limit,
-                         const std::optional<QString>& cursor,
-                         const GetConvoMembersSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvoMembers(const QString& convoId, std::optional<int> limit,
+                                        const std::optional<QString>& cursor,
+                                        const GetConvoMembersSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvoAvailability Get whether the requester and the other members can chat. If an existing convo is found for these members, it is returned.
@@ -1218,8 +1281,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvoAvailability(const std::vector<QString>& members,
-                              const ConvoAvailabilitySuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvoAvailability(const std::vector<QString>& members,
+                                             const ConvoAvailabilitySuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvoLog
@@ -1227,8 +1290,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvoLog(const std::optional<QString>& cursor,
-                     const ConvoLogSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvoLog(const std::optional<QString>& cursor,
+                                    const ConvoLogSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getMessages
@@ -1238,9 +1301,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getMessages(const QString& convoId, std::optional<int> limit,
-                     const std::optional<QString>& cursor,
-                     const GetMessagesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getMessages(const QString& convoId, std::optional<int> limit,
+                                    const std::optional<QString>& cursor,
+                                    const GetMessagesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief getConvoUnreadCounts
@@ -1248,8 +1311,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getConvoUnreadCounts(bool includeGroupChats,
-                              const ConvoUnreadCountsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getConvoUnreadCounts(bool includeGroupChats,
+                                             const ConvoUnreadCountsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief leaveConvo
@@ -1257,8 +1320,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void leaveConvo(const QString& convoId,
-                    const LeaveConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle leaveConvo(const QString& convoId,
+                                   const LeaveConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listConvos
@@ -1271,12 +1334,12 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listConvos(std::optional<int> limit, bool onlyUnread,
-                    std::optional<ChatBskyConvo::ConvoStatus> status,
-                    std::optional<ChatBskyConvo::ConvoKind> kind,
-                    std::optional<ChatBskyConvo::ConvoLockStatus> lockStatus,
-                    const std::optional<QString>& cursor,
-                    const ConvoListSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listConvos(std::optional<int> limit, bool onlyUnread,
+                                   std::optional<ChatBskyConvo::ConvoStatus> status,
+                                   std::optional<ChatBskyConvo::ConvoKind> kind,
+                                   std::optional<ChatBskyConvo::ConvoLockStatus> lockStatus,
+                                   const std::optional<QString>& cursor,
+                                   const ConvoListSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listConvoRequests
@@ -1285,8 +1348,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listConvoRequests(std::optional<int> limit, const std::optional<QString>& cursor,
-                           const ConvoRequestListSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listConvoRequests(std::optional<int> limit, const std::optional<QString>& cursor,
+                                          const ConvoRequestListSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief lockConvo
@@ -1294,8 +1357,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void lockConvo(const QString& convoId,
-                   const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle lockConvo(const QString& convoId,
+                                  const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief muteConvo
@@ -1303,8 +1366,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void muteConvo(const QString& convoId,
-                   const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle muteConvo(const QString& convoId,
+                                  const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief sendMessage
@@ -1313,8 +1376,8 @@ public:
      * @param successCb
      * @param errorCn
      */
-    void sendMessage(const QString& convoId, const ChatBskyConvo::MessageInput& message,
-                     const MessageSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle sendMessage(const QString& convoId, const ChatBskyConvo::MessageInput& message,
+                                    const MessageSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief unlockConvo
@@ -1322,8 +1385,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void unlockConvo(const QString& convoId,
-                     const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle unlockConvo(const QString& convoId,
+                                    const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief unmuteConvo
@@ -1331,8 +1394,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void unmuteConvo(const QString& convoId,
-                     const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle unmuteConvo(const QString& convoId,
+                                    const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief updateRead
@@ -1341,8 +1404,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void updateRead(const QString& convoId, const std::optional<QString>& messageId,
-                    const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateRead(const QString& convoId, const std::optional<QString>& messageId,
+                                   const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief updateAllRead
@@ -1350,8 +1413,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
-                       const UpdateAllReadSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateAllRead(std::optional<ChatBskyConvo::ConvoStatus> status,
+                                      const UpdateAllReadSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief addReaction
@@ -1361,10 +1424,10 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void addReaction(const QString& convoId, const QString& messageId, const QString& value,
-                     const ReactionSuccessCb& successCb, const ErrorCb& errorCb);
-    void removeReaction(const QString& convoId, const QString& messageId, const QString& value,
-                        const ReactionSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle addReaction(const QString& convoId, const QString& messageId, const QString& value,
+                                    const ReactionSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle removeReaction(const QString& convoId, const QString& messageId, const QString& value,
+                                       const ReactionSuccessCb& successCb, const ErrorCb& errorCb);
 
     // chat.bsky.group
 
@@ -1375,8 +1438,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void addMembers(const QString& convoId, const std::vector<QString>& members,
-                    const AddMembersSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle addMembers(const QString& convoId, const std::vector<QString>& members,
+                                   const AddMembersSuccessCb& successCb, const ErrorCb& errorCb);
 
 
     /**
@@ -1386,8 +1449,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void approveJoinRequest(const QString& convoId, const QString& member,
-                            const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle approveJoinRequest(const QString& convoId, const QString& member,
+                                           const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     static constexpr int MAX_GROUP_MEMBERS = 9999; // excluding the group creater
     static constexpr int MAX_GRAPHEMES_GROUP_NAME = 50;
@@ -1401,8 +1464,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void createGroup(const std::vector<QString>& members, const QString& name,
-                     const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle createGroup(const std::vector<QString>& members, const QString& name,
+                                    const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief createJoinLink
@@ -1412,8 +1475,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void createJoinLink(const QString& convoId, bool requireApproval, ChatBskyGroup::JoinRule joinRule,
-                        const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle createJoinLink(const QString& convoId, bool requireApproval, ChatBskyGroup::JoinRule joinRule,
+                                       const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief disableJoinLink
@@ -1421,8 +1484,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void disableJoinLink(const QString& convoId,
-                         const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle disableJoinLink(const QString& convoId,
+                                        const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief editGroup
@@ -1431,8 +1494,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void editGroup(const QString& convoId, const QString& name,
-                   const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle editGroup(const QString& convoId, const QString& name,
+                                  const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief editJoinLink
@@ -1442,9 +1505,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void editJoinLink(const QString& convoId, std::optional<bool> requireApproval,
-                      std::optional<ChatBskyGroup::JoinRule> joinRule,
-                      const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle editJoinLink(const QString& convoId, std::optional<bool> requireApproval,
+                                     std::optional<ChatBskyGroup::JoinRule> joinRule,
+                                     const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief enableJoinLink
@@ -1452,8 +1515,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void enableJoinLink(const QString& convoId,
-                        const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle enableJoinLink(const QString& convoId,
+                                       const JoinLinkSuccessCb& successCb, const ErrorCb& errorCb);
 
     static constexpr int MIN_JOIN_LINK_PREVIEWS_CODES = 1;
     static constexpr int MAX_JOIN_LINK_PREVIEWS_CODES = 50;
@@ -1464,8 +1527,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void getJoinLinkPreviews(const std::vector<QString>& codes,
-                             const JoinLinkPreviewsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getJoinLinkPreviews(const std::vector<QString>& codes,
+                                            const JoinLinkPreviewsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listJoinRequests
@@ -1475,8 +1538,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listJoinRequests(const QString& convoId, std::optional<int> limit, const std::optional<QString>& cursor,
-                          const JoinRequestsSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listJoinRequests(const QString& convoId, std::optional<int> limit, const std::optional<QString>& cursor,
+                                         const JoinRequestsSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief listMutualGroups
@@ -1486,8 +1549,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void listMutualGroups(const QString& subject, std::optional<int> limit, const std::optional<QString>& cursor,
-                          const ConvoListSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle listMutualGroups(const QString& subject, std::optional<int> limit, const std::optional<QString>& cursor,
+                                         const ConvoListSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief rejectJoinRequest
@@ -1495,8 +1558,8 @@ public:
      * @param member DID
      * @param successCb
      */
-    void rejectJoinRequest(const QString& convoId, const QString& member,
-                           const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle rejectJoinRequest(const QString& convoId, const QString& member,
+                                          const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief removeMembers
@@ -1505,8 +1568,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void removeMembers(const QString& convoId, const std::vector<QString>& members,
-                       const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle removeMembers(const QString& convoId, const std::vector<QString>& members,
+                                      const ConvoSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief requestJoin
@@ -1514,8 +1577,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void requestJoin(const QString& code,
-                     const RequestJoinSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle requestJoin(const QString& code,
+                                    const RequestJoinSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief updateJoinRequestsRead
@@ -1523,8 +1586,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void updateJoinRequestsRead(const QString& convoId,
-                                const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle updateJoinRequestsRead(const QString& convoId,
+                                               const SuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief withdrawJoinRequest
@@ -1532,8 +1595,8 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void withdrawJoinRequest(const QString& convoId,
-                             const SuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle withdrawJoinRequest(const QString& convoId,
+                                            const SuccessCb& successCb, const ErrorCb& errorCb);
 
     // chat.bsky.notification
 
@@ -1541,7 +1604,7 @@ public:
      * @brief getChatNotificationPreferences
      * @param successCb
      */
-    void getChatNotificationPreferences(const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle getChatNotificationPreferences(const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
 
     /**
      * @brief putChatNotificationPreferences only provides prefs will be updated
@@ -1550,9 +1613,9 @@ public:
      * @param successCb
      * @param errorCb
      */
-    void putChatNotificationPreferences(const ChatBskyNotification::ChatPreference::SharedPtr& chat,
-                            const ChatBskyNotification::ChatPreference::SharedPtr& chatRequest,
-                            const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
+    Xrpc::RequestHandle putChatNotificationPreferences(const ChatBskyNotification::ChatPreference::SharedPtr& chat,
+                                           const ChatBskyNotification::ChatPreference::SharedPtr& chatRequest,
+                                           const ChatNotificationPreferencesSuccessCb& successCb, const ErrorCb& errorCb);
 
     // oauth
 
@@ -1611,6 +1674,11 @@ public:
 #endif
 
 private:
+    // Initial sizes of JSON request bodies to avoid re-allocations while writing.
+    static constexpr qsizetype APPLY_WRITE_SIZE_ESTIMATE = 512; // per write
+    static constexpr qsizetype RECORD_SIZE_ESTIMATE = 1024;
+    static constexpr qsizetype PREFERENCES_SIZE_ESTIMATE = 4096;
+
     const QString& authToken() const;
     const QString& refreshToken() const;
 
@@ -1634,19 +1702,25 @@ private:
                                const SuccessCb& successCb, const ErrorCb& errorCb);
     void resumeAndRefreshSessionContinue(bool retry, const ComATProtoServer::Session& session,
                                const SuccessCb& successCb, const ResumeAndRefreshSessionErrorCb& errorCb);
-    void getRecordContinue(const QString& repo, const QString& collection,
-                           const QString& rkey, const std::optional<QString>& cid,
-                           const GetRecordSuccessCb& successCb, const ErrorCb& errorCb,
-                           const QString& pds = {});
-    void listRecordsContinue(const QString& repo, const QString& collection,
-                             std::optional<int> limit, const std::optional<QString>& cursor,
-                             const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb,
-                             const QString& pds = {});
-    void getBlobContinue(const QString& did, const QString& cid,
-                         const GetBlobSuccessCb& successCb, const ErrorCb& errorCb,
-                         const QString& pds = {});
-
-    void getServiceAuthForVideoUpload(const ErrorCb& errorCb, std::function<void(const QString& token)> uploadFunc);
+    Xrpc::RequestHandle getRecordContinue(const QString& repo, const QString& collection,
+                                          const QString& rkey, const std::optional<QString>& cid,
+                                          const GetRecordSuccessCb& successCb, const ErrorCb& errorCb,
+                                          const QString& pds = {});
+    Xrpc::RequestHandle listRecordsContinue(const QString& repo, const QString& collection,
+                                            std::optional<int> limit, const std::optional<QString>& cursor,
+                                            const ListRecordsSuccessCb& successCb, const ErrorCb& errorCb,
+                                            const QString& pds = {});
+    Xrpc::RequestHandle getBlobContinue(const QString& did, const QString& cid,
+                                        const GetBlobSuccessCb& successCb, const ErrorCb& errorCb,
+                                        const QString& pds = {});
+    Xrpc::RequestHandle getBlobStream(const QString& did, const QString& cid, const Xrpc::StreamTarget::SharedPtr& target,
+                                      const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                      const ErrorCb& errorCb);
+    Xrpc::RequestHandle getBlobStreamContinue(const QString& did, const QString& cid, const Xrpc::StreamTarget::SharedPtr& target,
+                                              const GetBlobStreamSuccessCb& successCb, const ProgressCb& progressCb,
+                                              const ErrorCb& errorCb, const QString& pds = {});
+
+    Xrpc::RequestHandle getServiceAuthForVideoUpload(const ErrorCb& errorCb, std::function<Xrpc::RequestHandle(const QString& token)> uploadFunc);
 
     void resolvePds(const QString& repo, const ErrorCb& errorCb, std::function<void(const QString& repo, const ErrorCb&, const QString& pds)> continueFunc);
     void setPdsFromUser(const QString& user, const SuccessCb& successCb, const ErrorCb& errorCb);
@@ -1661,6 +1735,14 @@ private:
         const QString& authDpopNonce);
     void deleteSessionOAuth(const SuccessCb& successCb);
     void refreshSessionOAuth(const SuccessCb& successCb, const ErrorCb& errorCb);
+    void sendRefreshSession(const SuccessCb& successCb, const ErrorCb& errorCb);
+    void scheduleAutoRefresh();
+
+    struct RefreshSessionWaiter
+    {
+        SuccessCb mSuccessCb;
+        ErrorCb mErrorCb;
+    };
 
     Xrpc::Client::Ptr mXrpc;
     ComATProtoServer::Session::SharedPtr mSession;
@@ -1670,6 +1752,10 @@ private:
     QTimer mAutoRefreshTimer;
     AutoRefreshDoneCb mAutoRefreshDoneCb;
     AutoRefreshSessionExpiredCb mAutoRefreshSessionExpiredCb;
+    bool mAutoRefreshActive = false;
+    std::chrono::seconds mAutoRefreshMargin = DEFAULT_AUTO_REFRESH_MARGIN;
+    std::vector<RefreshSessionWaiter> mRefreshSessionWaiters; // non-empty while refreshing
+    ServiceAuthCache mServiceAuthCache;
     QString mServiceAppView{SERVICE_APP_VIEW};
     QString mServiceChat{SERVICE_CHAT};
     QString mServiceDidVideo{SERVICE_VIDEO_DID};
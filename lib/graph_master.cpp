@@ -239,13 +239,13 @@ void GraphMaster::batchAddUsersToList(const QString& listUri, const QStringList&
 
     for (const auto& did : dids)
     {
-        AppBskyGraph::ListItem record;
-        record.mSubject = did;
-        record.mList = listUri;
-        record.mCreatedAt = QDateTime::currentDateTimeUtc();
+        auto record = std::make_shared<AppBskyGraph::ListItem>();
+        record->mSubject = did;
+        record->mList = listUri;
+        record->mCreatedAt = QDateTime::currentDateTimeUtc();
         auto create = std::make_shared<ATProto::ComATProtoRepo::ApplyWritesCreate>();
         create->mCollection = AppBskyGraph::ListItem::TYPE;
-        create->mValue = record.toJson();
+        create->mValue = std::move(record);
         writes.push_back(std::move(create));
     }
 
@@ -0,0 +1,103 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "host_health.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ATProto {
+
+HostHealth::HostHealth(std::chrono::milliseconds openDuration) :
+    mBaseOpenDuration(openDuration),
+    mOpenDuration(openDuration)
+{
+}
+
+bool HostHealth::allowRequest(const QDateTime& now)
+{
+    switch (mState)
+    {
+    case State::CLOSED:
+        return true;
+    case State::OPEN:
+        if (now < mOpenUntil)
+            return false;
+
+        qDebug() << "Circuit half open, probe";
+        mState = State::HALF_OPEN;
+        return true;
+    case State::HALF_OPEN:
+        return false;
+    }
+
+    Q_ASSERT(false);
+    return false;
+}
+
+void HostHealth::recordResponse(std::chrono::milliseconds latency)
+{
+    if (mState != State::CLOSED)
+        qDebug() << "Circuit closed";
+
+    mState = State::CLOSED;
+    mConsecutiveFailures = 0;
+    mOpenDuration = mBaseOpenDuration;
+
+    mLatencies.push_back(latency);
+
+    if ((int)mLatencies.size() > LATENCY_WINDOW)
+        mLatencies.pop_front();
+}
+
+void HostHealth::recordFailure(const QDateTime& now)
+{
+    ++mConsecutiveFailures;
+
+    if (mState == State::HALF_OPEN)
+    {
+        // The probe failed.
+        mOpenDuration = std::min(mOpenDuration * 2, std::chrono::milliseconds(MAX_OPEN_DURATION));
+        open(now);
+    }
+    else if (mState == State::CLOSED && mConsecutiveFailures >= FAILURE_THRESHOLD)
+    {
+        open(now);
+    }
+}
+
+void HostHealth::recordAbort()
+{
+    // The open time has passed already.
+    if (mState == State::HALF_OPEN)
+        mState = State::OPEN;
+}
+
+void HostHealth::open(const QDateTime& now)
+{
+    qDebug() << "Circuit open for:" << mOpenDuration.count() << "ms failures:" << mConsecutiveFailures;
+    mState = State::OPEN;
+    mOpenUntil = now.addMSecs(mOpenDuration.count());
+}
+
+std::chrono::milliseconds HostHealth::getLatencyPercentile(double p) const
+{
+    if (mLatencies.empty())
+        return std::chrono::milliseconds{0};
+
+    std::vector<std::chrono::milliseconds> sorted(mLatencies.begin(), mLatencies.end());
+    const int index = std::clamp((int)std::ceil(p * sorted.size()) - 1, 0, (int)sorted.size() - 1);
+    const auto nth = sorted.begin() + index;
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+
+std::chrono::milliseconds HostHealth::getHedgeDelay() const
+{
+    if ((int)mLatencies.size() < MIN_LATENCY_SAMPLES)
+        return DEFAULT_HEDGE_DELAY;
+
+    return std::clamp(getLatencyPercentile(0.95), MIN_HEDGE_DELAY, MAX_HEDGE_DELAY);
+}
+
+}
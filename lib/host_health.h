@@ -0,0 +1,71 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QDateTime>
+#include <chrono>
+#include <deque>
+
+namespace ATProto {
+
+// Latency and failure tracking for a host that can be replaced by another host,
+// e.g. a PLC directory mirror.
+//
+// The hedge delay is the learned p95 latency of the host. When a request has not
+// been answered within that time, the same request can be sent to another host.
+//
+// The circuit breaker opens after consecutive failures. While open, requests must
+// not be sent to the host. After the open duration one probe request is allowed.
+// If the probe succeeds the circuit closes, otherwise it opens again for a longer
+// duration.
+class HostHealth
+{
+public:
+    enum class State
+    {
+        CLOSED,
+        OPEN,
+        HALF_OPEN // probe in flight
+    };
+
+    static constexpr int FAILURE_THRESHOLD = 3;
+    static constexpr std::chrono::seconds DEFAULT_OPEN_DURATION{30};
+    static constexpr std::chrono::minutes MAX_OPEN_DURATION{5};
+    static constexpr int LATENCY_WINDOW = 50;
+    static constexpr int MIN_LATENCY_SAMPLES = 5;
+    static constexpr std::chrono::milliseconds DEFAULT_HEDGE_DELAY{1000}; // till enough samples
+    static constexpr std::chrono::milliseconds MIN_HEDGE_DELAY{100};
+    static constexpr std::chrono::milliseconds MAX_HEDGE_DELAY{5000};
+
+    explicit HostHealth(std::chrono::milliseconds openDuration = DEFAULT_OPEN_DURATION);
+
+    // Returns true if a request may be sent to the host. When the open duration
+    // has passed, this returns true once for the probe request.
+    bool allowRequest(const QDateTime& now = QDateTime::currentDateTimeUtc());
+
+    // The host answered. An error reply like 404 is an answer too.
+    void recordResponse(std::chrono::milliseconds latency);
+
+    // The host could not be reached, timed out or had a server error.
+    void recordFailure(const QDateTime& now = QDateTime::currentDateTimeUtc());
+
+    // The request got aborted before the host answered, e.g. a hedged request that
+    // lost. An aborted probe lets the next request probe.
+    void recordAbort();
+
+    std::chrono::milliseconds getHedgeDelay() const;
+    std::chrono::milliseconds getLatencyPercentile(double p) const;
+    State getState() const { return mState; }
+    int getConsecutiveFailures() const { return mConsecutiveFailures; }
+
+private:
+    void open(const QDateTime& now);
+
+    const std::chrono::milliseconds mBaseOpenDuration;
+    std::chrono::milliseconds mOpenDuration;
+    State mState = State::CLOSED;
+    int mConsecutiveFailures = 0;
+    QDateTime mOpenUntil;
+    std::deque<std::chrono::milliseconds> mLatencies; // most recent last
+};
+
+}
@@ -12,8 +12,9 @@ namespace ATProto {
 constexpr char const* DOH_PRIMARY = "https://dns.google/resolve";
 constexpr char const* DOH_SECONDARY = "https://cloudflare-dns.com/dns-query";
 
-IdentityResolver::IdentityResolver(QNetworkAccessManager* network) :
-    mNetwork(network)
+IdentityResolver::IdentityResolver(QNetworkAccessManager* network, std::shared_ptr<Xrpc::NetworkEngine> engine) :
+    mNetwork(network),
+    mEngine(engine)
 {
     Q_ASSERT(mNetwork);
     Q_ASSERT(mNetwork->autoDeleteReplies());
@@ -345,7 +346,7 @@ void IdentityResolver::handleHttpResponse(QNetworkReply* reply, const QString& h
 void IdentityResolver::resolveHandleBskyPublicApi(const QString& handle, const SuccessCb& successCb, const ErrorCb& errorCb)
 {
     qDebug() << "Resolve handle via bsky public API:" << handle;
-    Client::SharedPtr bsky = Client::createPublicApiClient(this);
+    Client::SharedPtr bsky = Client::createPublicApiClient(this, mEngine.lock());
 
     bsky->resolveHandle(handle,
         [handle, bsky, successCb](const QString& did){
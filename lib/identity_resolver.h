@@ -6,6 +6,10 @@
 #include <QNetworkReply>
 #include <QDnsLookup>
 
+namespace Xrpc {
+class NetworkEngine;
+}
+
 namespace ATProto {
 
 class IdentityResolver : public QObject, public Presence
@@ -15,7 +19,8 @@ public:
     using ErrorCb = std::function<void(const QString& error)>;
     using SuccessCb = std::function<void(const QString& did)>;
 
-    explicit IdentityResolver(QNetworkAccessManager* network);
+    // The engine is used for the clients to the bsky public API.
+    explicit IdentityResolver(QNetworkAccessManager* network, std::shared_ptr<Xrpc::NetworkEngine> engine = nullptr);
     void setUserAgent(const QString& userAgent) { mUserAgent = userAgent; }
     void resolveHandle(const QString& handle, const SuccessCb& successCb, const ErrorCb& errorCb);
 
@@ -40,6 +45,7 @@ private:
     std::unique_ptr<QDnsLookup> mDns;
 
     QNetworkAccessManager* mNetwork;
+    std::weak_ptr<Xrpc::NetworkEngine> mEngine;
     QString mUserAgent;
 };
 
@@ -73,9 +73,6 @@ QJsonObject JsonWebKey::extractPublicJwk() const
 {
     qDebug() << "Extract public key";
 
-    if (mPublicJwk)
-        return *mPublicJwk;
-
 #if defined(Q_OS_ANDROID) && defined(USE_ANDROID_KEYSTORE)
     qDebug() << "Alias:" << mAlias;
 
@@ -102,13 +99,12 @@ QJsonObject JsonWebKey::extractPublicJwk() const
         return {};
 
     // Reuse your existing function directly
-    const_cast<JsonWebKey*>(this)->mPublicJwk = extractPublicJwkSsl(pkey);
+    const QJsonObject jwk = extractPublicJwkSsl(pkey);
     EVP_PKEY_free(pkey);
+    return jwk;
 #else
-    const_cast<JsonWebKey*>(this)->mPublicJwk = extractPublicJwkSsl(mKey);
+    return extractPublicJwkSsl(mKey);
 #endif
-
-    return *mPublicJwk;
 }
 
 JsonWebKey JsonWebKey::generateDPoPKey(const QString& user)
@@ -141,6 +137,19 @@ JsonWebKey JsonWebKey::generateDPoPKey(const QString& user)
 #endif
 }
 
+// Called by the constructors only. The header is read without a lock by
+// concurrent proof builds.
+void JsonWebKey::initHeader()
+{
+    QJsonObject header;
+    header["typ"] = "dpop+jwt";
+    header["alg"] = "ES256";
+    header["jwk"] = extractPublicJwk(); // public key as JWK
+
+    const QByteArray json = QJsonDocument(header).toJson(QJsonDocument::Compact);
+    mHeaderB64 = json.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+}
+
 QByteArray JsonWebKey::sign(const QByteArray& data) const
 {
 #if defined(Q_OS_ANDROID) && defined(USE_ANDROID_KEYSTORE)
@@ -174,16 +183,51 @@ QByteArray JsonWebKey::sign(const QByteArray& data) const
     // This comes out as DER, still needs derToRawEcSignature()
     env->GetByteArrayRegion(jsig, 0, len, reinterpret_cast<jbyte*>(sig.data()));
 #else
+    if (!mSignCtx)
+    {
+        qWarning() << "No signing context";
+        return {};
+    }
+
+    // Copying the initialized context is cheaper than fetching the algorithms
+    // and setting up the key for every signature.
     EVP_MD_CTX* mdCtx = EVP_MD_CTX_new();
-    EVP_DigestSignInit(mdCtx, nullptr, EVP_sha256(), nullptr, mKey);
-    EVP_DigestSignUpdate(mdCtx, data.constData(), data.size());
+
+    if (!mdCtx)
+    {
+        qWarning() << "Failed to create signing context";
+        return {};
+    }
+
+    int copied;
+
+    {
+        QMutexLocker locker(mSignCtxMutex.get());
+        copied = EVP_MD_CTX_copy_ex(mdCtx, mSignCtx);
+    }
 
     size_t sigLen = 0;
-    EVP_DigestSignFinal(mdCtx, nullptr, &sigLen);
+
+    if (copied != 1 ||
+        EVP_DigestSignUpdate(mdCtx, data.constData(), data.size()) != 1 ||
+        EVP_DigestSignFinal(mdCtx, nullptr, &sigLen) != 1)
+    {
+        qWarning() << "Failed to sign data";
+        EVP_MD_CTX_free(mdCtx);
+        return {};
+    }
 
     QByteArray sig(sigLen, '\0');
-    EVP_DigestSignFinal(mdCtx, reinterpret_cast<unsigned char*>(sig.data()), &sigLen);
+    const int signedData = EVP_DigestSignFinal(mdCtx, reinterpret_cast<unsigned char*>(sig.data()), &sigLen);
     EVP_MD_CTX_free(mdCtx);
+
+    if (signedData != 1)
+    {
+        qWarning() << "Failed to sign data";
+        return {};
+    }
+
+    sig.resize(sigLen);
 #endif
 
     // Convert DER-encoded ECDSA sig to raw R||S for JWT
@@ -207,11 +251,6 @@ static QString createS256CodeChallend(const QString& token)
 
 QString JsonWebKey::buildDPoPProof(const QString& httpMethod, const QString& httpUri, const QString& accessToken, const QString& nonce) const
 {
-    QJsonObject header;
-    header["typ"] = "dpop+jwt";
-    header["alg"] = "ES256";
-    header["jwk"] = extractPublicJwk(); // public key as JWK
-
     QJsonObject payload;
     payload["jti"] = generateToken();
     payload["htm"] = httpMethod.toUpper();
@@ -231,13 +270,18 @@ QString JsonWebKey::buildDPoPProof(const QString& httpMethod, const QString& htt
         return data.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
     };
 
-    QByteArray headerB64  = b64url(QJsonDocument(header).toJson(QJsonDocument::Compact));
-    QByteArray payloadB64 = b64url(QJsonDocument(payload).toJson(QJsonDocument::Compact));
-    QByteArray signingInput = headerB64 + "." + payloadB64;
+    const QByteArray payloadB64 = b64url(QJsonDocument(payload).toJson(QJsonDocument::Compact));
+    const QByteArray signingInput = mHeaderB64 + "." + payloadB64;
 
     // Sign with private key
     QByteArray signature = sign(signingInput);
 
+    if (signature.isEmpty())
+    {
+        qWarning() << "Failed to build DPoP proof";
+        return {};
+    }
+
     const QString proof(signingInput + "." + b64url(signature));
     qDebug() << "End build DPoP proof";
     return proof;
@@ -274,12 +318,15 @@ QString JsonWebKey::generateToken(int length)
 JsonWebKey::JsonWebKey(const QString& alias) :
     mAlias(alias)
 {
+    initHeader();
 }
 
 JsonWebKey::JsonWebKey(JsonWebKey&& other) :
-    mAlias(other.mAlias)
+    mAlias(other.mAlias),
+    mHeaderB64(std::move(other.mHeaderB64))
 {
     other.mAlias.clear();
+    other.mHeaderB64.clear();
 }
 
 JsonWebKey::~JsonWebKey()
@@ -289,19 +336,57 @@ JsonWebKey::~JsonWebKey()
 JsonWebKey::JsonWebKey(EVP_PKEY* key) :
     mKey(key)
 {
+    initSigning();
 }
 
 JsonWebKey::JsonWebKey(JsonWebKey&& other) :
-    mKey(other.mKey)
+    mKey(other.mKey),
+    mSignCtx(other.mSignCtx),
+    mSignCtxMutex(std::move(other.mSignCtxMutex)),
+    mHeaderB64(std::move(other.mHeaderB64))
 {
     other.mKey = nullptr;
+    other.mSignCtx = nullptr;
+    other.mHeaderB64.clear();
 }
 
 JsonWebKey::~JsonWebKey()
 {
+    freeSigning();
+
     if (mKey)
         EVP_PKEY_free(mKey);
 }
+
+// The cached parts are built before the key gets used from multiple threads.
+void JsonWebKey::initSigning()
+{
+    if (!mKey)
+        return;
+
+    mSignCtx = EVP_MD_CTX_new();
+
+    if (EVP_DigestSignInit(mSignCtx, nullptr, EVP_sha256(), nullptr, mKey) != 1)
+    {
+        qWarning() << "Cannot initialize signing context";
+        freeSigning();
+        return;
+    }
+
+    mSignCtxMutex = std::make_unique<QMutex>();
+    initHeader();
+}
+
+void JsonWebKey::freeSigning()
+{
+    if (mSignCtx)
+    {
+        EVP_MD_CTX_free(mSignCtx);
+        mSignCtx = nullptr;
+    }
+
+    mSignCtxMutex = nullptr;
+}
 #endif
 
 JsonWebKey& JsonWebKey::operator=(JsonWebKey&& other)
@@ -310,13 +395,20 @@ JsonWebKey& JsonWebKey::operator=(JsonWebKey&& other)
     mAlias = other.mAlias;
     other.mAlias.clear();
 #else
+    freeSigning();
+
     if (mKey)
         EVP_PKEY_free(mKey);
 
     mKey = other.mKey;
+    mSignCtx = other.mSignCtx;
+    mSignCtxMutex = std::move(other.mSignCtxMutex);
     other.mKey = nullptr;
+    other.mSignCtx = nullptr;
 #endif
 
+    mHeaderB64 = std::move(other.mHeaderB64);
+    other.mHeaderB64.clear();
     return *this;
 }
 
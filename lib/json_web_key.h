@@ -3,11 +3,16 @@
 #pragma once
 #include <QByteArray>
 #include <QJsonObject>
+#include <QMutex>
 #include <QString>
 #include <openssl/ec.h>
+#include <memory>
 
 namespace ATProto {
 
+// The parts of a DPoP proof that only depend on the key are built once by the
+// constructor: the header with the public key and, on desktop, the signing context.
+// Proofs can be built concurrently from multiple threads.
 class JsonWebKey
 {
 public:
@@ -35,6 +40,7 @@ public:
 
     bool isNull() const;
 
+    // The proofs are empty when signing fails.
     QString buildAuthDPoPProof(const QString& httpMethod, const QString& httpUri, const QString& nonce) const;
     QString buildPdsDPoPProof(const QString& httpMethod, const QString& httpUri, const QString& accessToken, const QString& nonce) const;
 
@@ -57,13 +63,19 @@ private:
 
     QByteArray sign(const QByteArray& data) const;
     QJsonObject extractPublicJwk() const;
+    void initHeader();
 
 #if defined(Q_OS_ANDROID) && defined(USE_ANDROID_KEYSTORE)
     QString mAlias;
 #else
+    void initSigning();
+    void freeSigning();
+
     EVP_PKEY* mKey = nullptr;
+    EVP_MD_CTX* mSignCtx = nullptr; // initialized for mKey, copied for each signature
+    std::unique_ptr<QMutex> mSignCtxMutex;
 #endif
-    std::optional<QJsonObject> mPublicJwk;
+    QByteArray mHeaderB64; // read only after construction
 };
 
 }
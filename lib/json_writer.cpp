@@ -0,0 +1,345 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "json_writer.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocale>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ATProto {
+
+JsonWriter::JsonWriter(qsizetype reserveSize)
+{
+    if (reserveSize > 0)
+        mData.reserve(reserveSize);
+}
+
+QByteArray JsonWriter::take()
+{
+    Q_ASSERT(mFirst.empty());
+    mFirst.clear();
+    mAfterKey = false;
+    return std::exchange(mData, {});
+}
+
+void JsonWriter::beginValue()
+{
+    if (mAfterKey)
+    {
+        mAfterKey = false;
+        return;
+    }
+
+    if (mFirst.empty())
+        return;
+
+    if (mFirst.back())
+        mFirst.back() = false;
+    else
+        mData.append(',');
+}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    beginValue();
+    mData.append('{');
+    mFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    Q_ASSERT(!mFirst.empty());
+    mFirst.pop_back();
+    mData.append('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    beginValue();
+    mData.append('[');
+    mFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    Q_ASSERT(!mFirst.empty());
+    mFirst.pop_back();
+    mData.append(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(QAnyStringView key)
+{
+    Q_ASSERT(!mAfterKey);
+    beginValue();
+    writeString(key);
+    mData.append(':');
+    mAfterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::string(QAnyStringView value)
+{
+    beginValue();
+    writeString(value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::integer(qint64 value)
+{
+    beginValue();
+    mData.append(QByteArray::number(value));
+    return *this;
+}
+
+JsonWriter& JsonWriter::number(double value)
+{
+    beginValue();
+
+    // Like QJsonDocument, JSON has no infinity or NaN.
+    if (std::isfinite(value))
+        mData.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    else
+        mData.append("null");
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::boolean(bool value)
+{
+    beginValue();
+    mData.append(value ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::null()
+{
+    beginValue();
+    mData.append("null");
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const QJsonValue& value)
+{
+    writeValue(value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::dateTime(const QDateTime& value)
+{
+    return string(value.toUTC().toString(Qt::ISODateWithMs));
+}
+
+JsonWriter& JsonWriter::array(const std::vector<QString>& list)
+{
+    beginArray();
+
+    for (const auto& elem : list)
+        string(elem);
+
+    return endArray();
+}
+
+JsonWriter& JsonWriter::fields(const QJsonObject& json, std::initializer_list<QAnyStringView> except)
+{
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it)
+    {
+        const QString fieldKey = it.key();
+        const bool skip = std::any_of(except.begin(), except.end(),
+            [&fieldKey](QAnyStringView k){ return QAnyStringView::equal(fieldKey, k); });
+
+        if (!skip)
+        {
+            key(fieldKey);
+            writeValue(it.value());
+        }
+    }
+
+    return *this;
+}
+
+void JsonWriter::writeValue(const QJsonValue& value)
+{
+    switch (value.type())
+    {
+    case QJsonValue::Bool:
+        boolean(value.toBool());
+        break;
+    case QJsonValue::Double:
+    {
+        const double d = value.toDouble();
+        const qint64 i = value.toInteger();
+
+        if ((double)i == d)
+            integer(i);
+        else
+            number(d);
+
+        break;
+    }
+    case QJsonValue::String:
+        string(value.toString());
+        break;
+    case QJsonValue::Array:
+    {
+        beginArray();
+        const QJsonArray array = value.toArray();
+
+        for (const auto& elem : array)
+            writeValue(elem);
+
+        endArray();
+        break;
+    }
+    case QJsonValue::Object:
+    {
+        beginObject();
+        const QJsonObject object = value.toObject();
+
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+        {
+            key(it.key());
+            writeValue(it.value());
+        }
+
+        endObject();
+        break;
+    }
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        null();
+        break;
+    }
+}
+
+void JsonWriter::writeString(QAnyStringView s)
+{
+    mData.append('"');
+    s.visit([this](auto view){
+        if constexpr (std::is_same_v<decltype(view), QLatin1StringView>)
+            writeLatin1(view);
+        else if constexpr (std::is_same_v<decltype(view), QStringView>)
+            writeUtf16(view);
+        else
+            writeUtf8(view);
+    });
+    mData.append('"');
+}
+
+void JsonWriter::writeAscii(char c)
+{
+    switch (c)
+    {
+    case '"':
+        mData.append("\\\"");
+        break;
+    case '\\':
+        mData.append("\\\\");
+        break;
+    case '\b':
+        mData.append("\\b");
+        break;
+    case '\f':
+        mData.append("\\f");
+        break;
+    case '\n':
+        mData.append("\\n");
+        break;
+    case '\r':
+        mData.append("\\r");
+        break;
+    case '\t':
+        mData.append("\\t");
+        break;
+    default:
+        if ((uchar)c < 0x20)
+        {
+            static constexpr char HEX[] = "0123456789abcdef";
+            const char escape[] = { '\\', 'u', '0', '0', HEX[(uchar)c >> 4], HEX[c & 0xf] };
+            mData.append(escape, sizeof(escape));
+        }
+        else
+        {
+            mData.append(c);
+        }
+
+        break;
+    }
+}
+
+void JsonWriter::writeCodePoint(char32_t c)
+{
+    if (c < 0x80)
+    {
+        writeAscii((char)c);
+    }
+    else if (c < 0x800)
+    {
+        const char bytes[] = { char(0xc0 | (c >> 6)), char(0x80 | (c & 0x3f)) };
+        mData.append(bytes, sizeof(bytes));
+    }
+    else if (c < 0x10000)
+    {
+        const char bytes[] = { char(0xe0 | (c >> 12)), char(0x80 | ((c >> 6) & 0x3f)), char(0x80 | (c & 0x3f)) };
+        mData.append(bytes, sizeof(bytes));
+    }
+    else
+    {
+        const char bytes[] = { char(0xf0 | (c >> 18)), char(0x80 | ((c >> 12) & 0x3f)),
+                               char(0x80 | ((c >> 6) & 0x3f)), char(0x80 | (c & 0x3f)) };
+        mData.append(bytes, sizeof(bytes));
+    }
+}
+
+void JsonWriter::writeLatin1(QLatin1StringView s)
+{
+    for (const char c : s)
+        writeCodePoint((uchar)c);
+}
+
+void JsonWriter::writeUtf8(QUtf8StringView s)
+{
+    // Only ASCII needs escaping. Multi-byte sequences never contain ASCII bytes.
+    for (const auto c : s)
+    {
+        if ((uchar)c < 0x80)
+            writeAscii((char)c);
+        else
+            mData.append((char)c);
+    }
+}
+
+void JsonWriter::writeUtf16(QStringView s)
+{
+    const qsizetype size = s.size();
+
+    for (qsizetype i = 0; i < size; ++i)
+    {
+        const char16_t u = s[i].unicode();
+
+        if (u < 0x80)
+        {
+            writeAscii((char)u);
+        }
+        else if (QChar::isHighSurrogate(u) && i + 1 < size && QChar::isLowSurrogate(s[i + 1].unicode()))
+        {
+            writeCodePoint(QChar::surrogateToUcs4(u, s[i + 1].unicode()));
+            ++i;
+        }
+        else if (QChar::isSurrogate(u))
+        {
+            writeCodePoint(QChar::ReplacementCharacter);
+        }
+        else
+        {
+            writeCodePoint(u);
+        }
+    }
+}
+
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QAnyStringView>
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <initializer_list>
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace ATProto {
+
+// Writes compact UTF-8 JSON directly into a byte array, without building a
+// QJsonDocument first. Lexicon types write themselves with writeJson(), parts
+// that are only available as a JSON DOM can be written with value().
+// The caller is responsible for a well formed structure: key() inside objects,
+// matching begin and end calls.
+class JsonWriter
+{
+public:
+    explicit JsonWriter(qsizetype reserveSize = 0);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(QAnyStringView key);
+
+    JsonWriter& string(QAnyStringView value);
+    JsonWriter& integer(qint64 value);
+    JsonWriter& number(double value);
+    JsonWriter& boolean(bool value);
+    JsonWriter& null();
+    JsonWriter& value(const QJsonValue& value);
+    JsonWriter& dateTime(const QDateTime& value);
+    JsonWriter& array(const std::vector<QString>& list);
+
+    // Writes the fields of json, except the listed keys. Lexicon types keep the
+    // fields unknown to this library in a QJsonObject, the known fields are
+    // written from their members.
+    JsonWriter& fields(const QJsonObject& json, std::initializer_list<QAnyStringView> except);
+
+    // Writes a lexicon object with its writeJson(), or with its toJson() when it
+    // has none.
+    template<class ObjType>
+    JsonWriter& object(const ObjType& obj);
+
+    template<class ObjType>
+    JsonWriter& array(const std::vector<std::shared_ptr<ObjType>>& list);
+
+    // The variant must not be null.
+    template<class... Types>
+    JsonWriter& variant(const std::variant<Types...>& v);
+
+    const QByteArray& getData() const { return mData; }
+    QByteArray take();
+
+private:
+    void beginValue();
+    void writeString(QAnyStringView s);
+    void writeLatin1(QLatin1StringView s);
+    void writeUtf8(QUtf8StringView s);
+    void writeUtf16(QStringView s);
+    void writeAscii(char c);
+    void writeCodePoint(char32_t c);
+    void writeValue(const QJsonValue& value);
+
+    QByteArray mData;
+    std::vector<bool> mFirst; // per nesting level: no element written yet
+    bool mAfterKey = false;
+};
+
+template<class ObjType>
+JsonWriter& JsonWriter::object(const ObjType& obj)
+{
+    if constexpr (requires { obj.writeJson(*this); })
+        obj.writeJson(*this);
+    else
+        value(obj.toJson());
+
+    return *this;
+}
+
+template<class ObjType>
+JsonWriter& JsonWriter::array(const std::vector<std::shared_ptr<ObjType>>& list)
+{
+    beginArray();
+
+    for (const auto& elem : list)
+        object(*elem);
+
+    return endArray();
+}
+
+template<class... Types>
+JsonWriter& JsonWriter::variant(const std::variant<Types...>& v)
+{
+    std::visit([this](auto&& x){ Q_ASSERT(x); object(*x); }, v);
+    return *this;
+}
+
+}
@@ -0,0 +1,34 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "jwt.h"
+#include <QJsonDocument>
+
+namespace ATProto {
+
+QJsonObject Jwt::getPayload(const QString& token)
+{
+    const auto parts = QStringView(token).split('.');
+
+    if (parts.size() != 3)
+        return {};
+
+    const auto decoded = QByteArray::fromBase64Encoding(parts[1].toLatin1(),
+        QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals | QByteArray::AbortOnBase64DecodingErrors);
+
+    if (!decoded)
+        return {};
+
+    return QJsonDocument::fromJson(*decoded).object();
+}
+
+QDateTime Jwt::getExpiry(const QString& token)
+{
+    const auto exp = getPayload(token).value("exp");
+
+    if (!exp.isDouble())
+        return {};
+
+    return QDateTime::fromSecsSinceEpoch((qint64)exp.toDouble());
+}
+
+}
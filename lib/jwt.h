@@ -0,0 +1,22 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QDateTime>
+#include <QJsonObject>
+#include <QString>
+
+namespace ATProto {
+
+// Reads the claims of a JWT, e.g. an access token. The signature is not verified,
+// this is only meant for tokens issued to this client.
+class Jwt
+{
+public:
+    // Returns an empty object if the token is not a JWT.
+    static QJsonObject getPayload(const QString& token);
+
+    // Returns an invalid date time if the token is not a JWT or has no exp claim.
+    static QDateTime getExpiry(const QString& token);
+};
+
+}
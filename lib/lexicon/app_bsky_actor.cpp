@@ -95,7 +95,7 @@ QJsonObject ContentVisibilityDeclaration::toJson() const
 
 ContentVisibilityDeclaration::SharedPtr ContentVisibilityDeclaration::fromJson(const QJsonObject& json)
 {
-    auto declaration = std::make_shared<ContentVisibilityDeclaration>();
+    auto declaration = makeShared<ContentVisibilityDeclaration>();
     XJsonObject xjson(json);
     declaration->mHideFromAlgorithmicRecommendations = xjson.getRequiredBool("hideFromAlgorithmicRecommendations");
     return declaration;
@@ -115,8 +115,12 @@ QJsonObject VerificationView::toJson() const
 
 VerificationView::SharedPtr VerificationView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<VerificationView>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+VerificationView::SharedPtr VerificationView::fromJson(const XJsonObject& xjson)
+{
+    auto view = makeShared<VerificationView>();
     view->mIssuer = xjson.getRequiredString("issuer");
     view->mIssuerDisplayName = xjson.getOptionalString("issuerDisplayName");
     view->mIssuerHandle = xjson.getOptionalString("issuerHandle");
@@ -137,8 +141,12 @@ QJsonObject VerificationState::toJson() const
 
 VerificationState::SharedPtr VerificationState::fromJson(const QJsonObject& json)
 {
-    auto verificationState = std::make_shared<VerificationState>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+VerificationState::SharedPtr VerificationState::fromJson(const XJsonObject& xjson)
+{
+    auto verificationState = makeShared<VerificationState>();
     verificationState->mVerifications = xjson.getRequiredVector<VerificationView>("verifications");
     verificationState->mRawVerifiedStatus = xjson.getRequiredString("verifiedStatus");
     verificationState->mVerifiedStatus = stringToVerifiedStatus(verificationState->mRawVerifiedStatus);
@@ -158,7 +166,7 @@ QJsonObject KnownFollowers::toJson() const
 
 KnownFollowers::SharedPtr KnownFollowers::fromJson(const QJsonObject& json)
 {
-    auto knownFollowers = std::make_shared<KnownFollowers>();
+    auto knownFollowers = makeShared<KnownFollowers>();
     XJsonObject xjson(json);
     knownFollowers->mCount = xjson.getRequiredInt("count");
     knownFollowers->mFollowers = xjson.getRequiredVector<ProfileViewBasic>("followers");
@@ -185,8 +193,12 @@ QJsonObject ViewerState::toJson() const
 
 ViewerState::SharedPtr ViewerState::fromJson(const QJsonObject& json)
 {
-    auto viewerState = std::make_shared<ViewerState>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ViewerState::SharedPtr ViewerState::fromJson(const XJsonObject& xjson)
+{
+    auto viewerState = makeShared<ViewerState>();
     viewerState->mMuted = xjson.getOptionalBool("muted", false);
     viewerState->mMutedOnlyReposts = xjson.getOptionalBool("mutedOnlyReposts", false);
     viewerState->mMutedOnlyQuotePosts = xjson.getOptionalBool("mutedOnlyQuoteposts", false);
@@ -232,7 +244,7 @@ QJsonObject Status::toJson() const
 
 Status::SharedPtr Status::fromJson(const QJsonObject& json)
 {
-    auto status = std::make_shared<Status>();
+    auto status = makeShared<Status>();
     XJsonObject xjson(json);
     status->mRawStatus = xjson.getRequiredString("status");
     status->mStatus = stringToActorStatus(status->mRawStatus);
@@ -256,7 +268,7 @@ QJsonObject StatusView::toJson() const
 
 StatusView::SharedPtr StatusView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<StatusView>();
+    auto view = makeShared<StatusView>();
     XJsonObject xjson(json);
     view->mRawStatus = xjson.getRequiredString("status");
     view->mStatus = stringToActorStatus(view->mRawStatus);
@@ -280,8 +292,12 @@ QJsonObject ProfileAssociatedChat::toJson() const
 
 ProfileAssociatedChat::SharedPtr ProfileAssociatedChat::fromJson(const QJsonObject& json)
 {
-    auto associated = std::make_shared<ProfileAssociatedChat>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ProfileAssociatedChat::SharedPtr ProfileAssociatedChat::fromJson(const XJsonObject& xjson)
+{
+    auto associated = makeShared<ProfileAssociatedChat>();
     const auto allowIncoming = xjson.getRequiredString("allowIncoming");
     associated->mAllowIncoming = stringToAllowIncomingType(allowIncoming);
     const auto allowGroup = xjson.getOptionalString("allowGroupInvites");
@@ -302,8 +318,12 @@ QJsonObject ProfileAssociatedActivitySubscription::toJson() const
 
 ProfileAssociatedActivitySubscription::SharedPtr ProfileAssociatedActivitySubscription::fromJson(const QJsonObject& json)
 {
-    auto associated = std::make_shared<ProfileAssociatedActivitySubscription>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ProfileAssociatedActivitySubscription::SharedPtr ProfileAssociatedActivitySubscription::fromJson(const XJsonObject& xjson)
+{
+    auto associated = makeShared<ProfileAssociatedActivitySubscription>();
     const auto allowSubscriptions = xjson.getRequiredString("allowSubscriptions");
     associated->mAllowSubscriptions = stringToAllowSubscriptionsType(allowSubscriptions);
     return associated;
@@ -324,8 +344,12 @@ QJsonObject ProfileAssociated::toJson() const
 
 ProfileAssociated::SharedPtr ProfileAssociated::fromJson(const QJsonObject& json)
 {
-    auto associated = std::make_shared<ProfileAssociated>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ProfileAssociated::SharedPtr ProfileAssociated::fromJson(const XJsonObject& xjson)
+{
+    auto associated = makeShared<ProfileAssociated>();
     associated->mLists = xjson.getOptionalInt("lists", 0);
     associated->mFeeds = xjson.getOptionalInt("feedgens", 0);
     associated->mStarterPacks = xjson.getOptionalInt("starterPacks", 0);
@@ -355,8 +379,12 @@ QJsonObject ProfileViewBasic::toJson() const
 
 ProfileViewBasic::SharedPtr ProfileViewBasic::fromJson(const QJsonObject& json)
 {
-    XJsonObject root(json);
-    auto profileViewBasic = std::make_shared<ProfileViewBasic>();
+    return fromJson(XJsonObject(json));
+}
+
+ProfileViewBasic::SharedPtr ProfileViewBasic::fromJson(const XJsonObject& root)
+{
+    auto profileViewBasic = makeShared<ProfileViewBasic>();
     profileViewBasic->mDid = root.getRequiredString("did");
     profileViewBasic->mHandle = root.getRequiredString("handle");
     profileViewBasic->mDisplayName = root.getOptionalString("displayName");
@@ -364,7 +392,7 @@ ProfileViewBasic::SharedPtr ProfileViewBasic::fromJson(const QJsonObject& json)
     profileViewBasic->mAvatar = root.getOptionalString("avatar");
     profileViewBasic->mAssociated = root.getOptionalObject<ProfileAssociated>("associated");
     profileViewBasic->mViewer = root.getOptionalObject<ViewerState>("viewer");
-    ComATProtoLabel::getLabels(profileViewBasic->mLabels, json);
+    ComATProtoLabel::getLabels(profileViewBasic->mLabels, root);
     profileViewBasic->mCreatedAt = root.getOptionalDateTime("createdAt");
     profileViewBasic->mVerification = root.getOptionalObject<VerificationState>("verification");
     profileViewBasic->mStatus = root.getOptionalObject<StatusView>("status");
@@ -386,7 +414,7 @@ QJsonObject ProfileView::toJson() const
 ProfileView::SharedPtr ProfileView::fromJson(const QJsonObject& json)
 {
     XJsonObject root(json);
-    auto profile = std::make_shared<ProfileView>();
+    auto profile = makeShared<ProfileView>();
     profile->mDid = root.getRequiredString("did");
     profile->mHandle = root.getRequiredString("handle");
     profile->mDisplayName = root.getOptionalString("displayName");
@@ -406,7 +434,7 @@ ProfileView::SharedPtr ProfileView::fromJson(const QJsonObject& json)
 ProfileViewDetailed::SharedPtr ProfileViewDetailed::fromJson(const QJsonObject& json)
 {
     XJsonObject root(json);
-    auto profile = std::make_shared<ProfileViewDetailed>();
+    auto profile = makeShared<ProfileViewDetailed>();
     profile->mDid = root.getRequiredString("did");
     profile->mHandle = root.getRequiredString("handle");
     profile->mDisplayName = root.getOptionalString("displayName");
@@ -432,7 +460,7 @@ ProfileViewDetailed::SharedPtr ProfileViewDetailed::fromJson(const QJsonObject&
 GetProfilesOutput::SharedPtr GetProfilesOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<GetProfilesOutput>();
+    auto output = makeShared<GetProfilesOutput>();
     output->mProfiles = xjson.getRequiredVector<ProfileViewDetailed>("profiles");
     return output;
 }
@@ -453,7 +481,7 @@ QJsonObject Profile::toJson() const
 
 Profile::SharedPtr Profile::fromJson(const QJsonObject& json)
 {
-    auto profile = std::make_shared<Profile>();
+    auto profile = makeShared<Profile>();
     XJsonObject xjson(json);
     profile->mJson = json;
     profile->mDisplayName = xjson.getOptionalString("displayName");
@@ -475,9 +503,18 @@ QJsonObject AdultContentPref::toJson() const
     return json;
 }
 
+void AdultContentPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "enabled" });
+    writer.key("$type").string(TYPE);
+    writer.key("enabled").boolean(mEnabled);
+    writer.endObject();
+}
+
 AdultContentPref::SharedPtr AdultContentPref::fromJson(const QJsonObject& json)
 {
-    auto adultPref = std::make_shared<AdultContentPref>();
+    auto adultPref = makeShared<AdultContentPref>();
     XJsonObject xjson(json);
     adultPref->mEnabled = xjson.getRequiredBool("enabled");
     adultPref->mJson = json;
@@ -531,9 +568,23 @@ QJsonObject ContentLabelPref::toJson() const
     return json;
 }
 
+void ContentLabelPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "labelerDid", "label", "visibility" });
+    writer.key("$type").string(TYPE);
+
+    if (mLabelerDid)
+        writer.key("labelerDid").string(*mLabelerDid);
+
+    writer.key("label").string(mLabel);
+    writer.key("visibility").string(visibilityToString(mVisibility, mRawVisibility));
+    writer.endObject();
+}
+
 ContentLabelPref::SharedPtr ContentLabelPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<ContentLabelPref>();
+    auto pref = makeShared<ContentLabelPref>();
     XJsonObject xjson(json);
     pref->mLabelerDid = xjson.getOptionalString("labelerDid");
     pref->mLabel = xjson.getRequiredString("label");
@@ -552,9 +603,19 @@ QJsonObject SavedFeedsPref::toJson() const
     return json;
 }
 
+void SavedFeedsPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "pinned", "saved" });
+    writer.key("$type").string(TYPE);
+    writer.key("pinned").array(mPinned);
+    writer.key("saved").array(mSaved);
+    writer.endObject();
+}
+
 SavedFeedsPref::SharedPtr SavedFeedsPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<SavedFeedsPref>();
+    auto pref = makeShared<SavedFeedsPref>();
     XJsonObject xjson(json);
     pref->mPinned = xjson.getRequiredStringVector("pinned");
     pref->mSaved = xjson.getRequiredStringVector("saved");
@@ -594,9 +655,20 @@ QJsonObject SavedFeed::toJson() const
     return json;
 }
 
+void SavedFeed::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "id", "type", "value", "pinned" });
+    writer.key("id").string(mId);
+    writer.key("type").string(savedFeedTypeToString(mType, mRawType));
+    writer.key("value").string(mValue);
+    writer.key("pinned").boolean(mPinned);
+    writer.endObject();
+}
+
 SavedFeed::SharedPtr SavedFeed::fromJson(const QJsonObject& json)
 {
-    auto savedFeed = std::make_shared<SavedFeed>();
+    auto savedFeed = makeShared<SavedFeed>();
     const XJsonObject xjson(json);
     savedFeed->mId = xjson.getRequiredString("id");
     savedFeed->mRawType = xjson.getRequiredString("type");
@@ -615,9 +687,18 @@ QJsonObject SavedFeedsPrefV2::toJson() const
     return json;
 }
 
+void SavedFeedsPrefV2::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "items" });
+    writer.key("$type").string(TYPE);
+    writer.key("items").array<SavedFeed>(mItems);
+    writer.endObject();
+}
+
 SavedFeedsPrefV2::SharedPtr SavedFeedsPrefV2::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<SavedFeedsPrefV2>();
+    auto pref = makeShared<SavedFeedsPrefV2>();
     const XJsonObject xjson(json);
     pref->mItems = xjson.getRequiredVector<SavedFeed>("items");
     pref->mJson = json;
@@ -632,9 +713,21 @@ QJsonObject PersonalDetailsPref::toJson() const
     return json;
 }
 
+void PersonalDetailsPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "birthDate" });
+    writer.key("$type").string(TYPE);
+
+    if (mBirthDate)
+        writer.key("birthDate").dateTime(*mBirthDate);
+
+    writer.endObject();
+}
+
 PersonalDetailsPref::SharedPtr PersonalDetailsPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<PersonalDetailsPref>();
+    auto pref = makeShared<PersonalDetailsPref>();
     XJsonObject xjson(json);
     pref->mBirthDate = xjson.getOptionalDateTime("birthDate");
     pref->mJson = json;
@@ -654,9 +747,24 @@ QJsonObject FeedViewPref::toJson() const
     return json;
 }
 
+void FeedViewPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "feed", "hideReplies", "hideRepliesByUnfollowed", "hideRepliesByLikeCount",
+                           "hideReposts", "hideQuotePosts" });
+    writer.key("$type").string(TYPE);
+    writer.key("feed").string(mFeed);
+    writer.key("hideReplies").boolean(mHideReplies);
+    writer.key("hideRepliesByUnfollowed").boolean(mHideRepliesByUnfollowed);
+    writer.key("hideRepliesByLikeCount").integer(mHideRepliesByLikeCount);
+    writer.key("hideReposts").boolean(mHideReposts);
+    writer.key("hideQuotePosts").boolean(mHideQuotePosts);
+    writer.endObject();
+}
+
 FeedViewPref::SharedPtr FeedViewPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<FeedViewPref>();
+    auto pref = makeShared<FeedViewPref>();
     XJsonObject xjson(json);
     pref->mFeed = xjson.getRequiredString("feed");
     pref->mHideReplies = xjson.getOptionalBool("hideReplies", false);
@@ -677,9 +785,22 @@ QJsonObject ThreadViewPref::toJson() const
     return json;
 }
 
+void ThreadViewPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "sort", "prioritizeFollowedUsers" });
+    writer.key("$type").string(TYPE);
+
+    if (mSort)
+        writer.key("sort").string(*mSort);
+
+    writer.key("prioritizeFollowedUsers").boolean(mPrioritizeFollowedUsers);
+    writer.endObject();
+}
+
 ThreadViewPref::SharedPtr ThreadViewPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<ThreadViewPref>();
+    auto pref = makeShared<ThreadViewPref>();
     XJsonObject xjson(json);
     pref->mSort = xjson.getOptionalString("sort");
     pref->mPrioritizeFollowedUsers = xjson.getOptionalBool("prioritizeFollowedUsers", false);
@@ -775,9 +896,36 @@ QJsonObject MutedWord::toJson() const
     return json;
 }
 
+void MutedWord::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "value", "targets", "actorTarget", "expiresAt" });
+    writer.key("value").string(mValue);
+    writer.key("targets").beginArray();
+
+    for (const auto& target : mTargets)
+    {
+        const auto tgtString = mutedWordTargetToString(target.mTarget);
+        writer.string(!tgtString.isEmpty() ? tgtString : target.mRawTarget);
+    }
+
+    writer.endArray();
+
+    if (mActorTarget != ActorTarget::ALL)
+    {
+        const auto actorTgtString = actorTargetToString(mActorTarget);
+        writer.key("actorTarget").string(!actorTgtString.isEmpty() ? actorTgtString : mRawActorTarget);
+    }
+
+    if (mExpiresAt)
+        writer.key("expiresAt").dateTime(*mExpiresAt);
+
+    writer.endObject();
+}
+
 MutedWord::SharedPtr MutedWord::fromJson(const QJsonObject& json)
 {
-    auto mutedWord = std::make_shared<MutedWord>();
+    auto mutedWord = makeShared<MutedWord>();
     const XJsonObject xjson(json);
     mutedWord->mValue = xjson.getRequiredString("value");
     const auto targets = xjson.getRequiredStringVector("targets");
@@ -811,9 +959,23 @@ QJsonObject MutedWordsPref::toJson() const
     return json;
 }
 
+void MutedWordsPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "items" });
+    writer.key("$type").string(TYPE);
+    writer.key("items").beginArray();
+
+    for (const auto& item : mItems)
+        item.writeJson(writer);
+
+    writer.endArray();
+    writer.endObject();
+}
+
 MutedWordsPref::SharedPtr MutedWordsPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<MutedWordsPref>();
+    auto pref = makeShared<MutedWordsPref>();
     const XJsonObject xjson(json);
     auto items = xjson.getRequiredVector<MutedWord>("items");
     pref->mItems.reserve(items.size());
@@ -832,9 +994,17 @@ QJsonObject LabelerPrefItem::toJson() const
     return json;
 }
 
+void LabelerPrefItem::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "did" });
+    writer.key("did").string(mDid);
+    writer.endObject();
+}
+
 LabelerPrefItem::SharedPtr LabelerPrefItem::fromJson(const QJsonObject& json)
 {
-    auto item = std::make_shared<LabelerPrefItem>();
+    auto item = makeShared<LabelerPrefItem>();
     const XJsonObject xjson(json);
     item->mDid = xjson.getRequiredString("did");
     item->mJson = json;
@@ -855,9 +1025,23 @@ QJsonObject LabelersPref::toJson() const
     return json;
 }
 
+void LabelersPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "labelers" });
+    writer.key("$type").string(TYPE);
+    writer.key("labelers").beginArray();
+
+    for (const auto& labeler : mLabelers)
+        labeler.writeJson(writer);
+
+    writer.endArray();
+    writer.endObject();
+}
+
 LabelersPref::SharedPtr LabelersPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<LabelersPref>();
+    auto pref = makeShared<LabelersPref>();
     const XJsonObject xjson(json);
     auto labelers = xjson.getOptionalVector<LabelerPrefItem>("labelers");
 
@@ -882,9 +1066,19 @@ QJsonObject PostInteractionSettingsPref::toJson() const
     return json;
 }
 
+void PostInteractionSettingsPref::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "threadgateAllowRules", "postgateEmbeddingRules" });
+    writer.key("$type").string(TYPE);
+    mRules.writeRulesInto(writer, "threadgateAllowRules");
+    AppBskyFeed::PostgateEmbeddingRules::writeDisableEmbedding(writer, "postgateEmbeddingRules", mDisableEmbedding);
+    writer.endObject();
+}
+
 PostInteractionSettingsPref::SharedPtr PostInteractionSettingsPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<PostInteractionSettingsPref>();
+    auto pref = makeShared<PostInteractionSettingsPref>();
     const XJsonObject xjson(json);
     const auto allowArray = xjson.getOptionalArray("threadgateAllowRules");
 
@@ -908,9 +1102,18 @@ QJsonObject VerificationPrefs::toJson() const
     return json;
 }
 
+void VerificationPrefs::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "hideBadges" });
+    writer.key("$type").string(TYPE);
+    writer.key("hideBadges").boolean(mHideBadges);
+    writer.endObject();
+}
+
 VerificationPrefs::SharedPtr VerificationPrefs::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<VerificationPrefs>();
+    auto pref = makeShared<VerificationPrefs>();
     const XJsonObject xjson(json);
     pref->mHideBadges = xjson.getOptionalBool("hideBadges", false);
     return pref;
@@ -918,7 +1121,7 @@ VerificationPrefs::SharedPtr VerificationPrefs::fromJson(const QJsonObject& json
 
 UnknownPref::SharedPtr UnknownPref::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<UnknownPref>();
+    auto pref = makeShared<UnknownPref>();
     XJsonObject xjson(json);
     pref->mType = xjson.getRequiredString("$type");
     pref->mJson = json;
@@ -932,9 +1135,24 @@ QJsonObject GetPreferencesOutput::toJson() const
     return json;
 }
 
+void GetPreferencesOutput::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("preferences").beginArray();
+
+    for (const auto& pref : mPreferences)
+    {
+        if (!isNullVariant(pref))
+            writer.variant(pref);
+    }
+
+    writer.endArray();
+    writer.endObject();
+}
+
 GetPreferencesOutput::SharedPtr GetPreferencesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetPreferencesOutput>();
+    auto output = makeShared<GetPreferencesOutput>();
     const XJsonObject xjson(json);
     output->mPreferences =xjson.getRequiredVariantList<
         AdultContentPref,
@@ -955,7 +1173,7 @@ GetPreferencesOutput::SharedPtr GetPreferencesOutput::fromJson(const QJsonObject
 
 SearchActorsOutput::SharedPtr SearchActorsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<SearchActorsOutput>();
+    auto output = makeShared<SearchActorsOutput>();
     const XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mActors = xjson.getRequiredVector<ProfileView>("actors");
@@ -964,7 +1182,7 @@ SearchActorsOutput::SharedPtr SearchActorsOutput::fromJson(const QJsonObject& js
 
 SearchActorsTypeaheadOutput::SharedPtr SearchActorsTypeaheadOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<SearchActorsTypeaheadOutput>();
+    auto output = makeShared<SearchActorsTypeaheadOutput>();
     const XJsonObject xjson(json);
     output->mActors = xjson.getRequiredVector<ProfileViewBasic>("actors");
     return output;
@@ -972,7 +1190,7 @@ SearchActorsTypeaheadOutput::SharedPtr SearchActorsTypeaheadOutput::fromJson(con
 
 GetSuggestionsOutput::SharedPtr GetSuggestionsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetSuggestionsOutput>();
+    auto output = makeShared<GetSuggestionsOutput>();
     const XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mActors = xjson.getRequiredVector<ProfileView>("actors");
@@ -981,7 +1199,7 @@ GetSuggestionsOutput::SharedPtr GetSuggestionsOutput::fromJson(const QJsonObject
 
 GetSuggestedFollowsByActor::SharedPtr GetSuggestedFollowsByActor::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetSuggestedFollowsByActor>();
+    auto output = makeShared<GetSuggestedFollowsByActor>();
     const XJsonObject xjson(json);
     output->mSuggestions = xjson.getRequiredVector<ProfileView>("suggestions");
     return output;
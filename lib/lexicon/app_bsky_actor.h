@@ -49,6 +49,7 @@ struct VerificationView
     using SharedPtr = std::shared_ptr<VerificationView>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 enum class VerifiedStatus
@@ -75,6 +76,7 @@ struct VerificationState
 
     using SharedPtr = std::shared_ptr<VerificationState>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.actor.defs#knownFollowers
@@ -110,6 +112,7 @@ struct ViewerState
 
     using SharedPtr = std::shared_ptr<ViewerState>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 enum class ActorStatus
@@ -177,6 +180,7 @@ struct ProfileAssociatedChat
 
     using SharedPtr = std::shared_ptr<ProfileAssociatedChat>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.actor.defs#profileAssociatedActivitySubscription
@@ -198,6 +202,7 @@ struct ProfileAssociatedActivitySubscription
 
     using SharedPtr = std::shared_ptr<ProfileAssociatedActivitySubscription>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.actor.defs#profileAssociated
@@ -214,6 +219,7 @@ struct ProfileAssociated
 
     using SharedPtr = std::shared_ptr<ProfileAssociated>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.actor.defs#profileViewBasic
@@ -236,6 +242,7 @@ struct ProfileViewBasic
     using SharedPtr = std::shared_ptr<ProfileViewBasic>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.actor.defs#profileView
@@ -334,6 +341,7 @@ struct AdultContentPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<AdultContentPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -361,6 +369,7 @@ struct ContentLabelPref
 
     bool isGlobal() const { return !mLabelerDid; }
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ContentLabelPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -375,6 +384,7 @@ struct SavedFeedsPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<SavedFeedsPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -402,6 +412,7 @@ struct SavedFeed
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<SavedFeed>;
     using List = std::vector<SharedPtr>;
@@ -415,6 +426,7 @@ struct SavedFeedsPrefV2
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<SavedFeedsPrefV2>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -428,6 +440,7 @@ struct PersonalDetailsPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<PersonalDetailsPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -446,6 +459,7 @@ struct FeedViewPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<FeedViewPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -460,6 +474,7 @@ struct ThreadViewPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ThreadViewPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -502,6 +517,7 @@ struct MutedWord
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<MutedWord>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -515,6 +531,7 @@ struct MutedWordsPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<MutedWordsPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -528,6 +545,7 @@ struct LabelerPrefItem
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
     bool operator==(const LabelerPrefItem& other) const { return mDid == other.mDid; }
 
     using SharedPtr = std::shared_ptr<LabelerPrefItem>;
@@ -550,6 +568,7 @@ struct LabelersPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<LabelersPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -564,6 +583,7 @@ struct PostInteractionSettingsPref
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<PostInteractionSettingsPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -576,6 +596,7 @@ struct VerificationPrefs {
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<VerificationPrefs>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -590,6 +611,7 @@ struct UnknownPref
     QJsonObject mJson;
 
     QJsonObject toJson() const { return mJson; }
+    void writeJson(JsonWriter& writer) const { writer.value(mJson); }
 
     using SharedPtr = std::shared_ptr<UnknownPref>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -618,6 +640,7 @@ struct GetPreferencesOutput
     PreferenceList mPreferences;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<GetPreferencesOutput>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -7,7 +7,7 @@ namespace ATProto::AppBskyBookmark {
 
 BookmarkView::SharedPtr BookmarkView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<BookmarkView>();
+    auto view = makeShared<BookmarkView>();
     const XJsonObject xjson(json);
     view->mSubject = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("subject");
     view->mCreatedAt = xjson.getOptionalDateTime("createdAt");
@@ -17,7 +17,7 @@ BookmarkView::SharedPtr BookmarkView::fromJson(const QJsonObject& json)
 
 GetBookmarksOutput::SharedPtr GetBookmarksOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetBookmarksOutput>();
+    auto output = makeShared<GetBookmarksOutput>();
     const XJsonObject xjson(json);
     output->mBookmarks = xjson.getRequiredVector<BookmarkView>("bookmarks");
     output->mCursor = xjson.getOptionalString("cursor");
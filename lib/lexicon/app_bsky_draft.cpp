@@ -16,7 +16,7 @@ QJsonObject DraftEmbedLocalRef::toJson() const
 DraftEmbedLocalRef::SharedPtr DraftEmbedLocalRef::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto localRef = std::make_shared<DraftEmbedLocalRef>();
+    auto localRef = makeShared<DraftEmbedLocalRef>();
     localRef->mPath = xjson.getRequiredString("path");
     localRef->mJson = json;
     return localRef;
@@ -34,7 +34,7 @@ QJsonObject DraftEmbedCaption::toJson() const
 DraftEmbedCaption::SharedPtr DraftEmbedCaption::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto caption = std::make_shared<DraftEmbedCaption>();
+    auto caption = makeShared<DraftEmbedCaption>();
     caption->mLang = xjson.getRequiredString("lang");
     caption->mContent = xjson.getRequiredString("content");
     caption->mJson = json;
@@ -53,7 +53,7 @@ QJsonObject DraftEmbedImage::toJson() const
 DraftEmbedImage::SharedPtr DraftEmbedImage::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto image = std::make_shared<DraftEmbedImage>();
+    auto image = makeShared<DraftEmbedImage>();
     image->mLocalRef = xjson.getRequiredObject<DraftEmbedLocalRef>("localRef");
     image->mAlt = xjson.getOptionalString("alt");
     image->mJson = json;
@@ -73,7 +73,7 @@ QJsonObject DraftEmbedVideo::toJson() const
 DraftEmbedVideo::SharedPtr DraftEmbedVideo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto video = std::make_shared<DraftEmbedVideo>();
+    auto video = makeShared<DraftEmbedVideo>();
     video->mLocalRef = xjson.getRequiredObject<DraftEmbedLocalRef>("localRef");
     video->mAlt = xjson.getOptionalString("alt");
     video->mCaptions = xjson.getOptionalVector<DraftEmbedCaption>("captions");
@@ -92,7 +92,7 @@ QJsonObject DraftEmbedGallery::toJson() const
 DraftEmbedGallery::SharedPtr DraftEmbedGallery::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto gallery = std::make_shared<DraftEmbedGallery>();
+    auto gallery = makeShared<DraftEmbedGallery>();
     gallery->mItems = xjson.getRequiredVariantList<DraftEmbedImage>("items");
     gallery->mJson = json;
     return gallery;
@@ -109,7 +109,7 @@ QJsonObject DraftEmbedExternal::toJson() const
 DraftEmbedExternal::SharedPtr DraftEmbedExternal::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto external = std::make_shared<DraftEmbedExternal>();
+    auto external = makeShared<DraftEmbedExternal>();
     external->mUri = xjson.getRequiredString("uri");
     external->mJson = json;
     return external;
@@ -126,7 +126,7 @@ QJsonObject DraftEmbedRecord::toJson() const
 DraftEmbedRecord::SharedPtr DraftEmbedRecord::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto record = std::make_shared<DraftEmbedRecord>();
+    auto record = makeShared<DraftEmbedRecord>();
     record->mRecord = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("record");
     record->mJson = json;
     return record;
@@ -149,7 +149,7 @@ QJsonObject DraftPost::toJson() const
 DraftPost::SharedPtr DraftPost::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto post = std::make_shared<DraftPost>();
+    auto post = makeShared<DraftPost>();
     post->mText = xjson.getRequiredString("text");
     post->mLabels = xjson.getOptionalObject<ComATProtoLabel::SelfLabels>("labels");
     post->mEmbedImages = xjson.getOptionalVector<DraftEmbedImage>("embedImages");
@@ -178,7 +178,7 @@ QJsonObject Draft::toJson() const
 Draft::SharedPtr Draft::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto draft = std::make_shared<Draft>();
+    auto draft = makeShared<Draft>();
     draft->mDeviceId = xjson.getOptionalString("deviceId");
     draft->mDeviceName = xjson.getOptionalString("deviceName");
     draft->mPosts = xjson.getRequiredVector<DraftPost>("posts");
@@ -201,7 +201,7 @@ QJsonObject DraftWithId::toJson() const
 DraftWithId::SharedPtr DraftWithId::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto draft = std::make_shared<DraftWithId>();
+    auto draft = makeShared<DraftWithId>();
     draft->mId = xjson.getRequiredString("id");
     draft->mDraft = xjson.getRequiredObject<Draft>("draft");
     draft->mJson = json;
@@ -211,7 +211,7 @@ DraftWithId::SharedPtr DraftWithId::fromJson(const QJsonObject& json)
 DraftView::SharedPtr DraftView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<DraftView>();
+    auto view = makeShared<DraftView>();
     view->mId = xjson.getRequiredString("id");
     view->mDraft = xjson.getRequiredObject<Draft>("draft");
     view->mCreatedAt = xjson.getRequiredDateTime("createdAt");
@@ -222,7 +222,7 @@ DraftView::SharedPtr DraftView::fromJson(const QJsonObject& json)
 GetDraftsOutput::SharedPtr GetDraftsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<GetDraftsOutput>();
+    auto output = makeShared<GetDraftsOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mDrafts = xjson.getRequiredVector<DraftView>("drafts");
     return output;
@@ -231,7 +231,7 @@ GetDraftsOutput::SharedPtr GetDraftsOutput::fromJson(const QJsonObject& json)
 CreateDraftOutput::SharedPtr CreateDraftOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<CreateDraftOutput>();
+    auto output = makeShared<CreateDraftOutput>();
     output->mId = xjson.getRequiredString("id");
     return output;
 }
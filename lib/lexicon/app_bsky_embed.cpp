@@ -16,8 +16,12 @@ QJsonObject AspectRatio::toJson() const
 
 AspectRatio::SharedPtr AspectRatio::fromJson(const QJsonObject& json)
 {
-    auto aspectRatio = std::make_shared<AspectRatio>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+AspectRatio::SharedPtr AspectRatio::fromJson(const XJsonObject& xjson)
+{
+    auto aspectRatio = makeShared<AspectRatio>();
     aspectRatio->mWidth = xjson.getRequiredInt("width");
     aspectRatio->mHeight = xjson.getRequiredInt("height");
     return aspectRatio;
@@ -40,8 +44,12 @@ QJsonObject Image::toJson() const
 
 Image::SharedPtr Image::fromJson(const QJsonObject& json)
 {
-    auto image = std::make_shared<Image>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Image::SharedPtr Image::fromJson(const XJsonObject& xjson)
+{
+    auto image = makeShared<Image>();
     image->mImage = xjson.getRequiredObject<Blob>("image");
     image->mAlt = xjson.getRequiredString("alt");
     image->mAspectRatio = xjson.getOptionalObject<AspectRatio>("aspectRatio");
@@ -66,8 +74,12 @@ QJsonObject Images::toJson() const
 
 Images::SharedPtr Images::fromJson(const QJsonObject& json)
 {
-    auto images = std::make_shared<Images>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Images::SharedPtr Images::fromJson(const XJsonObject& xjson)
+{
+    auto images = makeShared<Images>();
     images->mImages = xjson.getRequiredVector<Image>("images");
     return images;
 }
@@ -84,13 +96,17 @@ QJsonObject ImagesViewImage::toJson() const
 
 ImagesViewImage::SharedPtr ImagesViewImage::fromJson(const QJsonObject& json)
 {
-    auto viewImage = std::make_shared<ImagesViewImage>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ImagesViewImage::SharedPtr ImagesViewImage::fromJson(const XJsonObject& xjson)
+{
+    auto viewImage = makeShared<ImagesViewImage>();
     viewImage->mThumb = xjson.getRequiredString("thumb");
     viewImage->mFullSize = xjson.getRequiredString("fullsize");
     viewImage->mAlt = xjson.getRequiredString("alt");
     viewImage->mAspectRatio = xjson.getOptionalObject<AspectRatio>("aspectRatio");
-    viewImage->mJson = json;
+    viewImage->mJson = xjson.getUnknownFields({ "thumb", "fullsize", "alt", "aspectRatio" });
     return viewImage;
 }
 
@@ -104,8 +120,12 @@ QJsonObject ImagesView::toJson() const
 
 ImagesView::SharedPtr ImagesView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<ImagesView>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ImagesView::SharedPtr ImagesView::fromJson(const XJsonObject& xjson)
+{
+    auto view = makeShared<ImagesView>();
     view->mImages = xjson.getRequiredVector<ImagesViewImage>("images");
     return view;
 }
@@ -122,8 +142,12 @@ QJsonObject GalleryImage::toJson() const
 
 GalleryImage::SharedPtr GalleryImage::fromJson(const QJsonObject& json)
 {
-    auto image = std::make_shared<GalleryImage>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+GalleryImage::SharedPtr GalleryImage::fromJson(const XJsonObject& xjson)
+{
+    auto image = makeShared<GalleryImage>();
     image->mImage = xjson.getRequiredObject<Blob>("image");
     image->mAlt = xjson.getRequiredString("alt");
     image->mAspectRatio = xjson.getRequiredObject<AspectRatio>("aspectRatio");
@@ -140,8 +164,12 @@ QJsonObject Gallery::toJson() const
 
 Gallery::SharedPtr Gallery::fromJson(const QJsonObject& json)
 {
-    auto gallery = std::make_shared<Gallery>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Gallery::SharedPtr Gallery::fromJson(const XJsonObject& xjson)
+{
+    auto gallery = makeShared<Gallery>();
     gallery->mItems = xjson.getRequiredVariantList<GalleryImage>("items");
     return gallery;
 }
@@ -159,13 +187,17 @@ QJsonObject GalleryViewImage::toJson() const
 
 GalleryViewImage::SharedPtr GalleryViewImage::fromJson(const QJsonObject& json)
 {
-    auto viewImage = std::make_shared<GalleryViewImage>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+GalleryViewImage::SharedPtr GalleryViewImage::fromJson(const XJsonObject& xjson)
+{
+    auto viewImage = makeShared<GalleryViewImage>();
     viewImage->mThumbnail = xjson.getRequiredString("thumbnail");
     viewImage->mFullSize = xjson.getRequiredString("fullsize");
     viewImage->mAlt = xjson.getRequiredString("alt");
     viewImage->mAspectRatio = xjson.getRequiredObject<AspectRatio>("aspectRatio");
-    viewImage->mJson = json;
+    viewImage->mJson = xjson.getUnknownFields({ "$type", "thumbnail", "fullsize", "alt", "aspectRatio" });
     return viewImage;
 }
 
@@ -179,8 +211,12 @@ QJsonObject GalleryView::toJson() const
 
 GalleryView::SharedPtr GalleryView::fromJson(const QJsonObject& json)
 {
-    auto galleryView = std::make_shared<GalleryView>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+GalleryView::SharedPtr GalleryView::fromJson(const XJsonObject& xjson)
+{
+    auto galleryView = makeShared<GalleryView>();
     galleryView->mItems = xjson.getRequiredVariantList<GalleryViewImage>("items");
     return galleryView;
 }
@@ -195,9 +231,13 @@ QJsonObject VideoCaption::toJson() const
 }
 
 VideoCaption::SharedPtr VideoCaption::fromJson(const QJsonObject& json)
+{
+    return fromJson(XJsonObject(json));
+}
+
+VideoCaption::SharedPtr VideoCaption::fromJson(const XJsonObject& xjson)
 {
     auto caption = std::make_unique<VideoCaption>();
-    const XJsonObject xjson(json);
     caption->mLang = xjson.getRequiredString("lang");
     caption->mFile = xjson.getRequiredObject<Blob>("file");
     return caption;
@@ -239,9 +279,13 @@ QJsonObject Video::toJson() const
 }
 
 Video::SharedPtr Video::fromJson(const QJsonObject& json)
+{
+    return fromJson(XJsonObject(json));
+}
+
+Video::SharedPtr Video::fromJson(const XJsonObject& xjson)
 {
     auto video = std::make_unique<Video>();
-    const XJsonObject xjson(json);
     video->mVideo = xjson.getRequiredObject<Blob>("video");
     video->mCaptions = xjson.getOptionalVector<VideoCaption>("captions");
     video->mAlt = xjson.getOptionalString("alt");
@@ -271,9 +315,13 @@ QJsonObject VideoView::toJson() const
 }
 
 VideoView::SharedPtr VideoView::fromJson(const QJsonObject& json)
+{
+    return fromJson(XJsonObject(json));
+}
+
+VideoView::SharedPtr VideoView::fromJson(const XJsonObject& xjson)
 {
     auto view = std::make_unique<VideoView>();
-    const XJsonObject xjson(json);
     view->mCid = xjson.getRequiredString("cid");
     view->mPlaylist = xjson.getRequiredString("playlist");
     view->mThumbnail = xjson.getOptionalString("thumbnail");
@@ -284,7 +332,7 @@ VideoView::SharedPtr VideoView::fromJson(const QJsonObject& json)
     if (view->mRawPresentation)
         view->mPresentation = stringToVideoPresentation(*view->mRawPresentation);
 
-    view->mJson = json;
+    view->mJson = xjson.getUnknownFields({ "$type", "cid", "playlist", "thumbnail", "alt", "aspectRatio", "presentation" });
     return view;
 }
 
@@ -304,8 +352,12 @@ QJsonObject ExternalExternal::toJson() const
 
 ExternalExternal::SharedPtr ExternalExternal::fromJson(const QJsonObject& json)
 {
-    auto external = std::make_shared<ExternalExternal>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ExternalExternal::SharedPtr ExternalExternal::fromJson(const XJsonObject& xjson)
+{
+    auto external = makeShared<ExternalExternal>();
     external->mUri = xjson.getRequiredString("uri");
     external->mTitle = xjson.getRequiredString("title");
     external->mDescription = xjson.getRequiredString("description");
@@ -324,8 +376,12 @@ QJsonObject External::toJson() const
 
 External::SharedPtr External::fromJson(const QJsonObject& json)
 {
-    auto external = std::make_shared<External>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+External::SharedPtr External::fromJson(const XJsonObject& xjson)
+{
+    auto external = makeShared<External>();
     external->mExternal = xjson.getRequiredObject<ExternalExternal>("external");
     return external;
 }
@@ -347,8 +403,12 @@ QJsonObject ColorRGB::toJson() const
 
 ColorRGB::SharedPtr ColorRGB::fromJson(const QJsonObject& json)
 {
-    auto rgb = std::make_shared<ColorRGB>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ColorRGB::SharedPtr ColorRGB::fromJson(const XJsonObject& xjson)
+{
+    auto rgb = makeShared<ColorRGB>();
     rgb->mR = xjson.getRequiredInt("r");
     rgb->mG = xjson.getRequiredInt("g");
     rgb->mB = xjson.getRequiredInt("b");
@@ -368,8 +428,12 @@ QJsonObject ViewExternalSourceTheme::toJson() const
 
 ViewExternalSourceTheme::SharedPtr ViewExternalSourceTheme::fromJson(const QJsonObject& json)
 {
-    auto theme = std::make_shared<ViewExternalSourceTheme>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ViewExternalSourceTheme::SharedPtr ViewExternalSourceTheme::fromJson(const XJsonObject& xjson)
+{
+    auto theme = makeShared<ViewExternalSourceTheme>();
     theme->mBackgroundRGB = xjson.getOptionalObject<ColorRGB>("backgroundRGB");
     theme->mForegroundRGB = xjson.getOptionalObject<ColorRGB>("foregroundRGB");
     theme->mAccentRGB = xjson.getOptionalObject<ColorRGB>("accentRGB");
@@ -391,8 +455,12 @@ QJsonObject ViewExternalSource::toJson() const
 
 ViewExternalSource::SharedPtr ViewExternalSource::fromJson(const QJsonObject& json)
 {
-    auto source = std::make_shared<ViewExternalSource>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ViewExternalSource::SharedPtr ViewExternalSource::fromJson(const XJsonObject& xjson)
+{
+    auto source = makeShared<ViewExternalSource>();
     source->mUri = xjson.getRequiredString("uri");
     source->mIcon = xjson.getOptionalString("icon");
     source->mTitle = xjson.getRequiredString("title");
@@ -420,8 +488,12 @@ QJsonObject ExternalViewExternal::toJson() const
 
 ExternalViewExternal::SharedPtr ExternalViewExternal::fromJson(const QJsonObject& json)
 {
-    auto viewExternal = std::make_shared<ExternalViewExternal>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ExternalViewExternal::SharedPtr ExternalViewExternal::fromJson(const XJsonObject& xjson)
+{
+    auto viewExternal = makeShared<ExternalViewExternal>();
     viewExternal->mUri = xjson.getRequiredString("uri");
     viewExternal->mTitle = xjson.getRequiredString("title");
     viewExternal->mDescription = xjson.getRequiredString("description");
@@ -446,8 +518,12 @@ QJsonObject ExternalView::toJson() const
 
 ExternalView::SharedPtr ExternalView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<ExternalView>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ExternalView::SharedPtr ExternalView::fromJson(const XJsonObject& xjson)
+{
+    auto view = makeShared<ExternalView>();
     view->mExternal = xjson.getRequiredObject<ExternalViewExternal>("external");
     return view;
 }
@@ -462,8 +538,12 @@ QJsonObject Record::toJson() const
 
 Record::SharedPtr Record::fromJson(const QJsonObject& json)
 {
-    auto record = std::make_shared<Record>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Record::SharedPtr Record::fromJson(const XJsonObject& xjson)
+{
+    auto record = makeShared<Record>();
     record->mRecord = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("record");
     return record;
 }
@@ -478,8 +558,12 @@ QJsonObject RecordViewNotFound::toJson() const
 
 RecordViewNotFound::SharedPtr RecordViewNotFound::fromJson(const QJsonObject& json)
 {
-    auto viewNotFound = std::make_shared<RecordViewNotFound>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordViewNotFound::SharedPtr RecordViewNotFound::fromJson(const XJsonObject& xjson)
+{
+    auto viewNotFound = makeShared<RecordViewNotFound>();
     viewNotFound->mUri = xjson.getRequiredString("uri");
     return viewNotFound;
 }
@@ -495,8 +579,12 @@ QJsonObject RecordViewBlocked::toJson() const
 
 RecordViewBlocked::SharedPtr RecordViewBlocked::fromJson(const QJsonObject& json)
 {
-    auto viewBlocked = std::make_shared<RecordViewBlocked>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordViewBlocked::SharedPtr RecordViewBlocked::fromJson(const XJsonObject& xjson)
+{
+    auto viewBlocked = makeShared<RecordViewBlocked>();
     viewBlocked->mUri = xjson.getRequiredString("uri");
     viewBlocked->mAuthor = xjson.getRequiredObject<AppBskyFeed::BlockedAuthor>("author");
     return viewBlocked;
@@ -512,8 +600,12 @@ QJsonObject RecordViewDetached::toJson() const
 
 RecordViewDetached::SharedPtr RecordViewDetached::fromJson(const QJsonObject& json)
 {
-    auto viewDetached = std::make_shared<RecordViewDetached>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordViewDetached::SharedPtr RecordViewDetached::fromJson(const XJsonObject& xjson)
+{
+    auto viewDetached = makeShared<RecordViewDetached>();
     viewDetached->mUri = xjson.getRequiredString("uri");
     return viewDetached;
 }
@@ -528,8 +620,12 @@ QJsonObject RecordView::toJson() const
 
 RecordView::SharedPtr RecordView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<RecordView>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordView::SharedPtr RecordView::fromJson(const XJsonObject& xjson)
+{
+    auto view = makeShared<RecordView>();
     view->mRecord = xjson.getRequiredVariant<
         RecordViewRecord,
         RecordViewNotFound,
@@ -555,8 +651,12 @@ QJsonObject RecordWithMedia::toJson() const
 
 RecordWithMedia::SharedPtr RecordWithMedia::fromJson(const QJsonObject& json)
 {
-    auto recordMedia = std::make_shared<RecordWithMedia>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordWithMedia::SharedPtr RecordWithMedia::fromJson(const XJsonObject& xjson)
+{
+    auto recordMedia = makeShared<RecordWithMedia>();
     recordMedia->mRecord = xjson.getRequiredObject<Record>("record");
     recordMedia->mMedia = xjson.getRequiredVariant<Images, Video, Gallery, External>("media");
     return recordMedia;
@@ -573,8 +673,12 @@ QJsonObject RecordWithMediaView::toJson() const
 
 RecordWithMediaView::SharedPtr RecordWithMediaView::fromJson(const QJsonObject& json)
 {
-    auto recordMediaView = std::make_shared<RecordWithMediaView>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordWithMediaView::SharedPtr RecordWithMediaView::fromJson(const XJsonObject& xjson)
+{
+    auto recordMediaView = makeShared<RecordWithMediaView>();
     recordMediaView->mRecord = xjson.getRequiredObject<RecordView>("record");
     recordMediaView->mMedia = xjson.getRequiredVariant<
         ImagesView,
@@ -601,8 +705,12 @@ QJsonObject RecordViewRecord::toJson() const
 
 RecordViewRecord::SharedPtr RecordViewRecord::fromJson(const QJsonObject& json)
 {
-    auto viewRecord = std::make_shared<RecordViewRecord>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+RecordViewRecord::SharedPtr RecordViewRecord::fromJson(const XJsonObject& xjson)
+{
+    auto viewRecord = makeShared<RecordViewRecord>();
     viewRecord->mUri = xjson.getRequiredString("uri");
     viewRecord->mCid = xjson.getRequiredString("cid");
     viewRecord->mAuthor = xjson.getRequiredObject<AppBskyActor::ProfileViewBasic>("author");
@@ -614,7 +722,7 @@ RecordViewRecord::SharedPtr RecordViewRecord::fromJson(const QJsonObject& json)
         AppBskyLabeler::LabelerView,
         ATProto::UnknownVariant>("value");
 
-    ComATProtoLabel::getLabels(viewRecord->mLabels, json);
+    ComATProtoLabel::getLabels(viewRecord->mLabels, xjson);
 
     viewRecord->mEmbeds = xjson.getOptionalVariantList<
         ImagesView,
@@ -631,7 +739,7 @@ RecordViewRecord::SharedPtr RecordViewRecord::fromJson(const QJsonObject& json)
 
 GetEmbedExternalViewOutput::SharedPtr GetEmbedExternalViewOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetEmbedExternalViewOutput>();
+    auto output = makeShared<GetEmbedExternalViewOutput>();
     const XJsonObject xjson(json);
     output->mView = xjson.getOptionalObject<ExternalView>("view");
     output->mAssociatedRefs = xjson.getOptionalVector<ComATProtoRepo::StrongRef>("associatedRefs");
@@ -74,6 +74,7 @@ struct BlockedAuthor
 
     using SharedPtr = std::shared_ptr<BlockedAuthor>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "";
 };
 
@@ -145,6 +146,7 @@ struct AspectRatio
 
     using SharedPtr = std::shared_ptr<AspectRatio>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.embed.images#image
@@ -159,6 +161,7 @@ struct Image
     using SharedPtr = std::shared_ptr<Image>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_BYTES = 2'000'000;
 };
 
@@ -171,6 +174,7 @@ struct Images
 
     using SharedPtr = std::shared_ptr<Images>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_IMAGES = 4;
     static constexpr char const* TYPE = "app.bsky.embed.images";
 };
@@ -189,6 +193,7 @@ struct ImagesViewImage
     using SharedPtr = std::shared_ptr<ImagesViewImage>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.embed.images#view
@@ -200,6 +205,7 @@ struct ImagesView
 
     using SharedPtr = std::shared_ptr<ImagesView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.images#view";
 };
 
@@ -214,6 +220,7 @@ struct GalleryImage
 
     using SharedPtr = std::shared_ptr<GalleryImage>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_BYTES = 2'000'000;
     static constexpr char const* TYPE = "app.bsky.embed.gallery#image";
 };
@@ -228,6 +235,7 @@ struct Gallery
 
     using SharedPtr = std::shared_ptr<Gallery>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_ITEMS = 20;
     static constexpr char const* TYPE = "app.bsky.embed.gallery";
 };
@@ -245,6 +253,7 @@ struct GalleryViewImage
 
     using SharedPtr = std::shared_ptr<GalleryViewImage>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.gallery#viewImage";
 };
 
@@ -258,6 +267,7 @@ struct GalleryView
 
     using SharedPtr = std::shared_ptr<GalleryView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.gallery#view";
 };
 
@@ -273,6 +283,7 @@ struct VideoCaption
     using SharedPtr = std::shared_ptr<VideoCaption>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_BYTES = 20'000;
     static constexpr char const* TYPE = "app.bsky.embed.video#caption";
 };
@@ -301,6 +312,7 @@ struct Video
 
     using SharedPtr = std::shared_ptr<Video>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_BYTES = 300'000'000;
     static constexpr char const* TYPE = "app.bsky.embed.video";
 };
@@ -321,6 +333,7 @@ struct VideoView
 
     using SharedPtr = std::shared_ptr<VideoView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.video#view";
 };
 
@@ -333,6 +346,7 @@ struct Record
 
     using SharedPtr = std::shared_ptr<Record>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record";
 };
 
@@ -347,6 +361,7 @@ struct RecordViewNotFound
 
     using SharedPtr = std::shared_ptr<RecordViewNotFound>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record#viewNotFound";
 };
 
@@ -360,6 +375,7 @@ struct RecordViewBlocked
 
     using SharedPtr = std::shared_ptr<RecordViewBlocked>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record#viewBlocked";
 };
 
@@ -372,6 +388,7 @@ struct RecordViewDetached
 
     using SharedPtr = std::shared_ptr<RecordViewDetached>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record#viewDetached";
 };
 
@@ -392,6 +409,7 @@ struct RecordView
 
     using SharedPtr = std::shared_ptr<RecordView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record#view";
 };
 
@@ -405,6 +423,7 @@ struct RecordWithMedia
 
     using SharedPtr = std::shared_ptr<RecordWithMedia>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.recordWithMedia";
 };
 
@@ -425,6 +444,7 @@ struct RecordWithMediaView
 
     using SharedPtr = std::shared_ptr<RecordWithMediaView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.recordWithMedia#view";
 };
 
@@ -450,6 +470,7 @@ struct PostReplyRef
 
     using SharedPtr = std::shared_ptr<PostReplyRef>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // Record types
@@ -480,9 +501,11 @@ struct Post
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<Post>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr int MAX_TEXT_GRAPHEMES = 300;
     static constexpr int MAX_TEXT_BYTES = 3000;
     static constexpr char const* TYPE = "app.bsky.feed.post";
@@ -511,6 +534,7 @@ struct RecordViewRecord
 
     using SharedPtr = std::shared_ptr<RecordViewRecord>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.record#viewRecord";
 };
 
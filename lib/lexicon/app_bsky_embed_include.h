@@ -27,6 +27,7 @@ struct ExternalExternal
 
     using SharedPtr = std::shared_ptr<ExternalExternal>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.embed.external
@@ -38,6 +39,7 @@ struct External
 
     using SharedPtr = std::shared_ptr<External>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.external";
 };
 
@@ -52,6 +54,7 @@ struct ColorRGB
 
     using SharedPtr = std::shared_ptr<ColorRGB>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.external#ColorRGB";
 };
 
@@ -66,6 +69,7 @@ struct ViewExternalSourceTheme
 
     using SharedPtr = std::shared_ptr<ViewExternalSourceTheme>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.external#viewExternalSourceTheme";
 };
 
@@ -81,6 +85,7 @@ struct ViewExternalSource
 
     using SharedPtr = std::shared_ptr<ViewExternalSource>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.external#viewExternalSource";
 };
 
@@ -103,6 +108,7 @@ struct ExternalViewExternal
 
     using SharedPtr = std::shared_ptr<ExternalViewExternal>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.embed.external#view
@@ -114,6 +120,7 @@ struct ExternalView
 
     using SharedPtr = std::shared_ptr<ExternalView>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.embed.external#view";
 };
 
@@ -4,6 +4,7 @@
 #include "app_bsky_actor.h"
 #include "../xjson.h"
 #include <QJsonArray>
+#include <mutex>
 #include <unordered_map>
 
 namespace ATProto::AppBskyFeed {
@@ -18,8 +19,12 @@ QJsonObject KnownLikers::toJson() const
 
 KnownLikers::SharedPtr KnownLikers::fromJson(const QJsonObject& json)
 {
-    auto likers = std::make_shared<KnownLikers>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+KnownLikers::SharedPtr KnownLikers::fromJson(const XJsonObject& xjson)
+{
+    auto likers = makeShared<KnownLikers>();
     likers->mCount = xjson.getRequiredInt("count");
     likers->mActors = xjson.getRequiredVector<AppBskyActor::ProfileViewBasic>("actors");
     return likers;
@@ -41,8 +46,12 @@ QJsonObject ViewerState::toJson() const
 
 ViewerState::SharedPtr ViewerState::fromJson(const QJsonObject& json)
 {
-    auto viewerState = std::make_shared<ViewerState>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ViewerState::SharedPtr ViewerState::fromJson(const XJsonObject& xjson)
+{
+    auto viewerState = makeShared<ViewerState>();
     viewerState->mRepost = xjson.getOptionalString("repost");
     viewerState->mLike = xjson.getOptionalString("like");
     viewerState->mBookmarked = xjson.getOptionalBool("bookmarked", false);
@@ -61,9 +70,16 @@ QJsonObject PostgateDisableRule::toJson() const
     return json;
 }
 
+void PostgateDisableRule::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string(TYPE);
+    writer.endObject();
+}
+
 PostgateDisableRule::SharedPtr PostgateDisableRule::fromJson(const QJsonObject&)
 {
-    auto rule = std::make_shared<PostgateDisableRule>();
+    auto rule = makeShared<PostgateDisableRule>();
     return rule;
 }
 
@@ -72,11 +88,21 @@ void PostgateEmbeddingRules::insertDisableEmbedding(QJsonObject& json, const QSt
     std::vector<RuleType> rules;
 
     if (disableEmbedding)
-        rules.push_back(std::make_shared<PostgateDisableRule>());
+        rules.push_back(makeShared<PostgateDisableRule>());
 
     XJsonObject::insertOptionalVariantArray(json, field, rules);
 }
 
+void PostgateEmbeddingRules::writeDisableEmbedding(JsonWriter& writer, QAnyStringView field, bool disableEmbedding)
+{
+    if (!disableEmbedding)
+        return;
+
+    writer.key(field).beginArray();
+    PostgateDisableRule{}.writeJson(writer);
+    writer.endArray();
+}
+
 bool PostgateEmbeddingRules::getDisableEmbedding(const QJsonObject& json, const QString& field)
 {
     XJsonObject xjson(json);
@@ -106,7 +132,7 @@ QJsonObject Postgate::toJson() const
 
 Postgate::SharedPtr Postgate::fromJson(const QJsonObject& json)
 {
-    auto postgate = std::make_shared<Postgate>();
+    auto postgate = makeShared<Postgate>();
     XJsonObject xjson(json);
     postgate->mCreatedAt = xjson.getRequiredDateTime("createdAt");
     postgate->mPost = xjson.getRequiredString("post");
@@ -123,9 +149,17 @@ QJsonObject ThreadgateListRule::toJson() const
     return json;
 }
 
+void ThreadgateListRule::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string(TYPE);
+    writer.key("list").string(mList);
+    writer.endObject();
+}
+
 ThreadgateListRule::SharedPtr ThreadgateListRule::fromJson(const QJsonObject& json)
 {
-    auto rule = std::make_shared<ThreadgateListRule>();
+    auto rule = makeShared<ThreadgateListRule>();
     XJsonObject xjson(json);
     rule->mList = xjson.getRequiredString("list");
     return rule;
@@ -170,6 +204,28 @@ void ThreadgateRules::insertRulesInto(QJsonObject& json, const QString& field) c
         json.insert(field, allowArray);
 }
 
+void ThreadgateRules::writeRulesInto(JsonWriter& writer, QAnyStringView field) const
+{
+    if (!mAllowMention && !mAllowFollower && !mAllowFollowing && mAllowList.empty() && !mAllowNobody)
+        return;
+
+    writer.key(field).beginArray();
+
+    if (mAllowMention)
+        writer.beginObject().key("$type").string("app.bsky.feed.threadgate#mentionRule").endObject();
+
+    if (mAllowFollower)
+        writer.beginObject().key("$type").string("app.bsky.feed.threadgate#followerRule").endObject();
+
+    if (mAllowFollowing)
+        writer.beginObject().key("$type").string("app.bsky.feed.threadgate#followingRule").endObject();
+
+    for (const auto& listRule : mAllowList)
+        listRule->writeJson(writer);
+
+    writer.endArray();
+}
+
 ThreadgateRules ThreadgateRules::getRules(const QJsonObject& json, const QString& field)
 {
     XJsonObject xjson(json);
@@ -183,7 +239,7 @@ ThreadgateRules ThreadgateRules::getRules(const QJsonObject& json, const QString
 
 ThreadgateRules::SharedPtr ThreadgateRules::fromJson(const QJsonArray& allowArray)
 {
-    auto threadgateRules = std::make_shared<ThreadgateRules>();
+    auto threadgateRules = makeShared<ThreadgateRules>();
 
     if (allowArray.empty())
         threadgateRules->mAllowNobody = true;
@@ -242,7 +298,7 @@ QJsonObject Threadgate::toJson() const
 
 Threadgate::SharedPtr Threadgate::fromJson(const QJsonObject& json)
 {
-    auto threadgate = std::make_shared<Threadgate>();
+    auto threadgate = makeShared<Threadgate>();
     XJsonObject xjson(json);
     threadgate->mPost = xjson.getRequiredString("post");
     const auto allowArray = xjson.getOptionalArray("allow");
@@ -274,7 +330,7 @@ QJsonObject ThreadgateView::toJson() const
 
 ThreadgateView::SharedPtr ThreadgateView::fromJson(const QJsonObject& json)
 {
-    auto threadgateView = std::make_shared<ThreadgateView>();
+    auto threadgateView = makeShared<ThreadgateView>();
     XJsonObject xjson(json);
     threadgateView->mUri = xjson.getOptionalString("uri");
     threadgateView->mCid = xjson.getOptionalString("cid");
@@ -305,8 +361,12 @@ QJsonObject PostReplyRef::toJson() const
 
 PostReplyRef::SharedPtr PostReplyRef::fromJson(const QJsonObject& json)
 {
-    auto replyRef = std::make_shared<PostReplyRef>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+PostReplyRef::SharedPtr PostReplyRef::fromJson(const XJsonObject& xjson)
+{
+    auto replyRef = makeShared<PostReplyRef>();
     replyRef->mRoot = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("root");
     replyRef->mParent = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("parent");
     return replyRef;
@@ -330,10 +390,47 @@ QJsonObject Record::Post::toJson() const
     return json;
 }
 
+void Record::Post::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "text", "facets", "reply", "embed", "labels", "langs", "createdAt", "bridgyOriginalText" });
+    writer.key("$type").string(TYPE);
+    writer.key("text").string(mText);
+
+    if (!mFacets.empty())
+        writer.key("facets").array<AppBskyRichtext::Facet>(mFacets);
+
+    if (mReply)
+        writer.key("reply").object(*mReply);
+
+    // An embed that was not decoded, e.g. of an unknown type, is kept from the JSON.
+    if (mEmbed && !isNullVariant(*mEmbed))
+        writer.key("embed").variant(*mEmbed);
+    else if (const QJsonValue embed = mJson.value("embed"); embed.isObject())
+        writer.key("embed").value(embed);
+
+    if (mLabels)
+        writer.key("labels").object(*mLabels);
+
+    if (!mLanguages.empty())
+        writer.key("langs").array(mLanguages);
+
+    writer.key("createdAt").dateTime(mCreatedAt);
+
+    if (mBridgyOriginalText)
+        writer.key("bridgyOriginalText").string(*mBridgyOriginalText);
+
+    writer.endObject();
+}
+
 Record::Post::SharedPtr Record::Post::fromJson(const QJsonObject& json)
 {
-    auto post = std::make_shared<Record::Post>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Record::Post::SharedPtr Record::Post::fromJson(const XJsonObject& xjson)
+{
+    auto post = makeShared<Record::Post>();
     post->mText = xjson.getRequiredString("text");
     post->mFacets = xjson.getOptionalVector<AppBskyRichtext::Facet>("facets");
     post->mReply = xjson.getOptionalObject<PostReplyRef>("reply");
@@ -349,7 +446,7 @@ Record::Post::SharedPtr Record::Post::fromJson(const QJsonObject& json)
     post->mLanguages = xjson.getOptionalStringVector("langs");
     post->mCreatedAt = xjson.getRequiredDateTime("createdAt");
     post->mBridgyOriginalText = xjson.getOptionalString("bridgyOriginalText");
-    post->mJson = json;
+    post->mJson = xjson.getUnknownFields({ "$type", "text", "facets", "reply", "embed", "labels", "langs", "createdAt", "bridgyOriginalText" });
     return post;
 }
 
@@ -360,8 +457,12 @@ QJsonObject PostView::toJson() const
     json.insert("uri", mUri);
     json.insert("cid", mCid);
     XJsonObject::insertOptionalJsonObject<AppBskyActor::ProfileViewBasic>(json, "author", mAuthor);
-    json.insert("record", XJsonObject::variantToJsonObject(mRecord));
-    XJsonObject::insertOptionalVariant(json, "embed", mEmbed);
+    const auto& record = getRecord();
+
+    if (!isNullVariant(record))
+        json.insert("record", XJsonObject::variantToJsonObject(record));
+
+    XJsonObject::insertOptionalVariant(json, "embed", getEmbed());
     XJsonObject::insertOptionalJsonValue(json, "bookmarkCount", mBookmarkCount, 0);
     XJsonObject::insertOptionalJsonValue(json, "replyCount", mReplyCount, 0);
     XJsonObject::insertOptionalJsonValue(json, "repostCount", mRepostCount, 0);
@@ -375,23 +476,96 @@ QJsonObject PostView::toJson() const
     return json;
 }
 
+class PostView::LazyContent
+{
+public:
+    explicit LazyContent(const XJsonObject& xjson) : mJson(xjson.retain()) {}
+
+    const RecordType& getRecord()
+    {
+        std::call_once(mRecordDecoded, [this]{
+            try {
+                mRecord = decodeRecord(mJson);
+            } catch (InvalidJsonException& e) {
+                qWarning() << "Invalid post record:" << e.msg();
+            }
+        });
+
+        return mRecord;
+    }
+
+    const std::optional<AppBskyEmbed::EmbedViewUnion>& getEmbed()
+    {
+        std::call_once(mEmbedDecoded, [this]{
+            try {
+                mEmbed = decodeEmbed(mJson);
+            } catch (InvalidJsonException& e) {
+                qWarning() << "Invalid post embed:" << e.msg();
+            }
+        });
+
+        return mEmbed;
+    }
+
+    static RecordType decodeRecord(const XJsonObject& xjson)
+    {
+        return xjson.getRequiredVariant<Record::Post, UnknownVariant>("record");
+    }
+
+    static std::optional<AppBskyEmbed::EmbedViewUnion> decodeEmbed(const XJsonObject& xjson)
+    {
+        return xjson.getOptionalVariant<
+            AppBskyEmbed::ImagesView,
+            AppBskyEmbed::VideoView,
+            AppBskyEmbed::GalleryView,
+            AppBskyEmbed::ExternalView,
+            AppBskyEmbed::RecordView,
+            AppBskyEmbed::RecordWithMediaView,
+            UnknownVariant>("embed");
+    }
+
+private:
+    const XJsonObject mJson; // shares the data of the reply
+    std::once_flag mRecordDecoded;
+    std::once_flag mEmbedDecoded;
+    RecordType mRecord;
+    std::optional<AppBskyEmbed::EmbedViewUnion> mEmbed;
+};
+
+const PostView::RecordType& PostView::getRecord() const
+{
+    return mLazy ? mLazy->getRecord() : mRecord;
+}
+
+const std::optional<AppBskyEmbed::EmbedViewUnion>& PostView::getEmbed() const
+{
+    return mLazy ? mLazy->getEmbed() : mEmbed;
+}
+
 PostView::SharedPtr PostView::fromJson(const QJsonObject& json)
 {
-    auto postView = std::make_shared<PostView>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+PostView::SharedPtr PostView::fromJson(const XJsonObject& xjson)
+{
+    auto postView = makeShared<PostView>();
     postView->mUri = xjson.getRequiredString("uri");
     postView->mCid = xjson.getRequiredString("cid");
-    postView->mAuthor = AppBskyActor::ProfileViewBasic::fromJson(json["author"].toObject());
-    postView->mRecord = xjson.getRequiredVariant<Record::Post, UnknownVariant>("record");
-    
-    postView->mEmbed = xjson.getOptionalVariant<
-        AppBskyEmbed::ImagesView,
-        AppBskyEmbed::VideoView,
-        AppBskyEmbed::GalleryView,
-        AppBskyEmbed::ExternalView,
-        AppBskyEmbed::RecordView,
-        AppBskyEmbed::RecordWithMediaView,
-        UnknownVariant>("embed");
+    postView->mAuthor = xjson.getRequiredObject<AppBskyActor::ProfileViewBasic>("author");
+
+    if (LazyDecodeScope::isActive())
+    {
+        // A reply without record is invalid, the content of the record is checked
+        // on access.
+        xjson.checkRequiredObject("record");
+        postView->mLazy = makeShared<LazyContent>(xjson);
+    }
+    else
+    {
+        postView->mRecord = LazyContent::decodeRecord(xjson);
+        postView->mEmbed = LazyContent::decodeEmbed(xjson);
+    }
 
     postView->mBookmarkCount = xjson.getOptionalInt("bookmarkCount", 0);
     postView->mReplyCount = xjson.getOptionalInt("replyCount", 0);
@@ -400,7 +574,7 @@ PostView::SharedPtr PostView::fromJson(const QJsonObject& json)
     postView->mQuoteCount = xjson.getOptionalInt("quoteCount", 0);
     postView->mIndexedAt = xjson.getRequiredDateTime("indexedAt");
     postView->mViewer = xjson.getOptionalObject<ViewerState>("viewer");
-    ComATProtoLabel::getLabels(postView->mLabels, json);
+    ComATProtoLabel::getLabels(postView->mLabels, xjson);
     postView->mThreadgate = xjson.getOptionalObject<ThreadgateView>("threadgate");
     return postView;
 }
@@ -408,7 +582,7 @@ PostView::SharedPtr PostView::fromJson(const QJsonObject& json)
 GetPostsOutput::SharedPtr GetPostsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<GetPostsOutput>();
+    auto output = makeShared<GetPostsOutput>();
     output->mPosts = xjson.getRequiredVector<PostView>("posts");
     return output;
 }
@@ -424,8 +598,12 @@ QJsonObject ReplyRef::toJson() const
 
 ReplyRef::SharedPtr ReplyRef::fromJson(const QJsonObject& json)
 {
-    auto replyRef = std::make_shared<ReplyRef>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ReplyRef::SharedPtr ReplyRef::fromJson(const XJsonObject& xjson)
+{
+    auto replyRef = makeShared<ReplyRef>();
     replyRef->mRoot = xjson.getRequiredVariant<
         PostView,
         NotFoundPost,
@@ -452,8 +630,12 @@ QJsonObject ReasonRepost::toJson() const
 
 ReasonRepost::SharedPtr ReasonRepost::fromJson(const QJsonObject& json)
 {
-    auto reason = std::make_shared<ReasonRepost>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ReasonRepost::SharedPtr ReasonRepost::fromJson(const XJsonObject& xjson)
+{
+    auto reason = makeShared<ReasonRepost>();
     reason->mBy = xjson.getRequiredObject<AppBskyActor::ProfileViewBasic>("by");
     reason->mUri = xjson.getOptionalString("uri");
     reason->mCid = xjson.getOptionalString("cid");
@@ -470,7 +652,13 @@ QJsonObject ReasonPin::toJson() const
 
 ReasonPin::SharedPtr ReasonPin::fromJson(const QJsonObject&)
 {
-    auto reason = std::make_shared<ReasonPin>();
+    auto reason = makeShared<ReasonPin>();
+    return reason;
+}
+
+ReasonPin::SharedPtr ReasonPin::fromJson(const XJsonObject&)
+{
+    auto reason = makeShared<ReasonPin>();
     return reason;
 }
 
@@ -486,8 +674,12 @@ QJsonObject FeedViewPost::toJson() const
 
 FeedViewPost::SharedPtr FeedViewPost::fromJson(const QJsonObject& json)
 {
-    auto feedViewPost = std::make_shared<FeedViewPost>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+FeedViewPost::SharedPtr FeedViewPost::fromJson(const XJsonObject& xjson)
+{
+    auto feedViewPost = makeShared<FeedViewPost>();
     feedViewPost->mPost = xjson.getRequiredObject<PostView>("post");
     feedViewPost->mReply = xjson.getOptionalObject<ReplyRef>("reply");
     feedViewPost->mReason = xjson.getOptionalVariant<ReasonRepost, ReasonPin>("reason");
@@ -497,8 +689,12 @@ FeedViewPost::SharedPtr FeedViewPost::fromJson(const QJsonObject& json)
 
 OutputFeed::SharedPtr OutputFeed::fromJson(const QJsonObject& json)
 {
-    auto outputFeed = std::make_shared<OutputFeed>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+OutputFeed::SharedPtr OutputFeed::fromJson(const XJsonObject& xjson)
+{
+    auto outputFeed = makeShared<OutputFeed>();
     outputFeed->mCursor = xjson.getOptionalString("cursor");
     outputFeed->mFeed = xjson.getRequiredVector<FeedViewPost>("feed");
     return outputFeed;
@@ -514,8 +710,12 @@ QJsonObject NotFoundPost::toJson() const
 
 NotFoundPost::SharedPtr NotFoundPost::fromJson(const QJsonObject& json)
 {
-    auto notFound = std::make_shared<NotFoundPost>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+NotFoundPost::SharedPtr NotFoundPost::fromJson(const XJsonObject& xjson)
+{
+    auto notFound = makeShared<NotFoundPost>();
     notFound->mUri = xjson.getRequiredString("uri");
     return notFound;
 }
@@ -530,8 +730,12 @@ QJsonObject BlockedAuthor::toJson() const
 
 BlockedAuthor::SharedPtr BlockedAuthor::fromJson(const QJsonObject& json)
 {
-    auto blockedAuthor = std::make_shared<BlockedAuthor>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+BlockedAuthor::SharedPtr BlockedAuthor::fromJson(const XJsonObject& xjson)
+{
+    auto blockedAuthor = makeShared<BlockedAuthor>();
     blockedAuthor->mDid = xjson.getRequiredString("did");
     blockedAuthor->mViewer = xjson.getOptionalObject<AppBskyActor::ViewerState>("viewer");
     return blockedAuthor;
@@ -548,8 +752,12 @@ QJsonObject BlockedPost::toJson() const
 
 BlockedPost::SharedPtr BlockedPost::fromJson(const QJsonObject& json)
 {
-    auto blockedPost = std::make_shared<BlockedPost>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+BlockedPost::SharedPtr BlockedPost::fromJson(const XJsonObject& xjson)
+{
+    auto blockedPost = makeShared<BlockedPost>();
     blockedPost->mUri = xjson.getRequiredString("uri");
     blockedPost->mAuthor = xjson.getRequiredObject<BlockedAuthor>("author");
     return blockedPost;
@@ -557,8 +765,12 @@ BlockedPost::SharedPtr BlockedPost::fromJson(const QJsonObject& json)
 
 ThreadViewPost::SharedPtr ThreadViewPost::fromJson(const QJsonObject& json)
 {
-    auto thread = std::make_shared<ThreadViewPost>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ThreadViewPost::SharedPtr ThreadViewPost::fromJson(const XJsonObject& xjson)
+{
+    auto thread = makeShared<ThreadViewPost>();
     thread->mPost = xjson.getRequiredObject<PostView>("post");
     thread->mParent = xjson.getOptionalVariant<
         ThreadViewPost,
@@ -590,8 +802,12 @@ ThreadViewPost::SharedPtr ThreadViewPost::fromJson(const QJsonObject& json)
 
 PostThread::SharedPtr PostThread::fromJson(const QJsonObject& json)
 {
-    auto postThread = std::make_shared<PostThread>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+PostThread::SharedPtr PostThread::fromJson(const XJsonObject& xjson)
+{
+    auto postThread = makeShared<PostThread>();
     postThread->mThread = xjson.getRequiredVariant<
         ThreadViewPost,
         NotFoundPost,
@@ -613,8 +829,12 @@ QJsonObject Like::toJson() const
 
 Like::SharedPtr Like::fromJson(const QJsonObject& json)
 {
-    auto like = std::make_shared<Like>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Like::SharedPtr Like::fromJson(const XJsonObject& xjson)
+{
+    auto like = makeShared<Like>();
     like->mSubject = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("subject");
     like->mCreatedAt = xjson.getRequiredDateTime("createdAt");
     like->mVia = xjson.getOptionalObject<ComATProtoRepo::StrongRef>("via");
@@ -633,8 +853,12 @@ QJsonObject Repost::toJson() const
 
 Repost::SharedPtr Repost::fromJson(const QJsonObject& json)
 {
-    auto repost = std::make_shared<Repost>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Repost::SharedPtr Repost::fromJson(const XJsonObject& xjson)
+{
+    auto repost = makeShared<Repost>();
     repost->mSubject = xjson.getRequiredObject<ComATProtoRepo::StrongRef>("subject");
     repost->mCreatedAt = xjson.getRequiredDateTime("createdAt");
     repost->mVia = xjson.getOptionalObject<ComATProtoRepo::StrongRef>("via");
@@ -643,7 +867,7 @@ Repost::SharedPtr Repost::fromJson(const QJsonObject& json)
 
 GetLikesLike::SharedPtr GetLikesLike::fromJson(const QJsonObject& json)
 {
-    auto like = std::make_shared<GetLikesLike>();
+    auto like = makeShared<GetLikesLike>();
     const XJsonObject xjson(json);
     like->mIndexedAt = xjson.getRequiredDateTime("indexedAt");
     like->mCreatedAt = xjson.getRequiredDateTime("createdAt");
@@ -653,7 +877,7 @@ GetLikesLike::SharedPtr GetLikesLike::fromJson(const QJsonObject& json)
 
 GetLikesOutput::SharedPtr GetLikesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetLikesOutput>();
+    auto output = makeShared<GetLikesOutput>();
     const XJsonObject xjson(json);
     output->mUri = xjson.getRequiredString("uri");
     output->mCid = xjson.getOptionalString("cid");
@@ -664,7 +888,7 @@ GetLikesOutput::SharedPtr GetLikesOutput::fromJson(const QJsonObject& json)
 
 GetRepostedByOutput::SharedPtr GetRepostedByOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetRepostedByOutput>();
+    auto output = makeShared<GetRepostedByOutput>();
     const XJsonObject xjson(json);
     output->mUri = xjson.getRequiredString("uri");
     output->mCid = xjson.getOptionalString("cid");
@@ -675,7 +899,7 @@ GetRepostedByOutput::SharedPtr GetRepostedByOutput::fromJson(const QJsonObject&
 
 SearchPostsOutput::SharedPtr SearchPostsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<SearchPostsOutput>();
+    auto output = makeShared<SearchPostsOutput>();
     const XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mHitsTotal = xjson.getOptionalInt("hitsTotal");
@@ -685,7 +909,7 @@ SearchPostsOutput::SharedPtr SearchPostsOutput::fromJson(const QJsonObject& json
 
 SearchPostsV2Output::SharedPtr SearchPostsV2Output::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<SearchPostsV2Output>();
+    auto output = makeShared<SearchPostsV2Output>();
     const XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mHitsTotal = xjson.getOptionalInt("hitsTotal");
@@ -703,7 +927,7 @@ QJsonObject GeneratorViewerState::toJson() const
 
 GeneratorViewerState::SharedPtr GeneratorViewerState::fromJson(const QJsonObject& json)
 {
-    auto viewerState = std::make_shared<GeneratorViewerState>();
+    auto viewerState = makeShared<GeneratorViewerState>();
     const XJsonObject xjson(json);
     viewerState->mLike = xjson.getOptionalString("like");
     return viewerState;
@@ -766,7 +990,7 @@ QJsonObject GeneratorView::toJson() const
 
 GeneratorView::SharedPtr GeneratorView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<GeneratorView>();
+    auto view = makeShared<GeneratorView>();
     const XJsonObject xjson(json);
     view->mUri = xjson.getRequiredString("uri");
     view->mCid = xjson.getRequiredString("cid");
@@ -791,7 +1015,7 @@ GeneratorView::SharedPtr GeneratorView::fromJson(const QJsonObject& json)
 
 GetFeedGeneratorOutput::SharedPtr GetFeedGeneratorOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetFeedGeneratorOutput>();
+    auto output = makeShared<GetFeedGeneratorOutput>();
     const XJsonObject xjson(json);
     output->mView = xjson.getRequiredObject<GeneratorView>("view");
     output->mIsOnline = xjson.getRequiredBool("isOnline");
@@ -801,7 +1025,7 @@ GetFeedGeneratorOutput::SharedPtr GetFeedGeneratorOutput::fromJson(const QJsonOb
 
 GetFeedGeneratorsOutput::SharedPtr GetFeedGeneratorsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetFeedGeneratorsOutput>();
+    auto output = makeShared<GetFeedGeneratorsOutput>();
     const XJsonObject xjson(json);
     output->mFeeds = xjson.getRequiredVector<GeneratorView>("feeds");
     output->mCursor = xjson.getOptionalString("cursor");
@@ -810,7 +1034,7 @@ GetFeedGeneratorsOutput::SharedPtr GetFeedGeneratorsOutput::fromJson(const QJson
 
 GetActorFeedsOutput::SharedPtr GetActorFeedsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetActorFeedsOutput>();
+    auto output = makeShared<GetActorFeedsOutput>();
     const XJsonObject xjson(json);
     output->mFeeds = xjson.getRequiredVector<GeneratorView>("feeds");
     output->mCursor = xjson.getOptionalString("cursor");
@@ -819,7 +1043,7 @@ GetActorFeedsOutput::SharedPtr GetActorFeedsOutput::fromJson(const QJsonObject&
 
 GetQuotesOutput::SharedPtr GetQuotesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetQuotesOutput>();
+    auto output = makeShared<GetQuotesOutput>();
     const XJsonObject xjson(json);
     output->mUri = xjson.getRequiredString("uri");
     output->mCid = xjson.getOptionalString("cid");
@@ -20,6 +20,7 @@ struct KnownLikers
 
     using SharedPtr = std::shared_ptr<KnownLikers>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.feed.defs#viewerState
@@ -38,6 +39,7 @@ struct ViewerState
 
     using SharedPtr = std::shared_ptr<ViewerState>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.feed.postgate
@@ -92,7 +94,10 @@ struct PostView
     QString mUri; // at-uri
     QString mCid;
     AppBskyActor::ProfileViewBasic::SharedPtr mAuthor; // required
-    std::variant<Record::Post::SharedPtr, UnknownVariant::SharedPtr> mRecord;
+    using RecordType = std::variant<Record::Post::SharedPtr, UnknownVariant::SharedPtr>;
+
+    // Not set when decoded lazily, use getRecord() and getEmbed() for access.
+    RecordType mRecord;
     std::optional<AppBskyEmbed::EmbedViewUnion> mEmbed;
     int mBookmarkCount = 0;
     int mReplyCount = 0;
@@ -104,11 +109,21 @@ struct PostView
     ComATProtoLabel::Label::List mLabels;
     ThreadgateView::SharedPtr mThreadgate; // optional
 
+    // Decoded from JSON on first access when the post view was decoded in a
+    // LazyDecodeScope. Thread safe. An invalid record or embed gives a null value.
+    const RecordType& getRecord() const;
+    const std::optional<AppBskyEmbed::EmbedViewUnion>& getEmbed() const;
+    bool isLazy() const { return mLazy != nullptr; }
+
+    class LazyContent;
+    std::shared_ptr<LazyContent> mLazy;
+
     QJsonObject toJson() const;
 
     using SharedPtr = std::shared_ptr<PostView>;
     using List = std::vector<PostView::SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#postView";
 };
 
@@ -129,6 +144,7 @@ struct NotFoundPost
 
     using SharedPtr = std::shared_ptr<NotFoundPost>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#notFoundPost";
 };
 
@@ -142,6 +158,7 @@ struct BlockedPost
 
     using SharedPtr = std::shared_ptr<BlockedPost>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#blockedPost";
 };
 
@@ -161,6 +178,7 @@ struct ReplyRef
 
     using SharedPtr = std::shared_ptr<ReplyRef>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.feed.defs#reasonRepost
@@ -175,6 +193,7 @@ struct ReasonRepost
 
     using SharedPtr = std::shared_ptr<ReasonRepost>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#reasonRepost";
 };
 
@@ -185,6 +204,7 @@ struct ReasonPin
 
     using SharedPtr = std::shared_ptr<ReasonPin>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#reasonPin";
 };
 
@@ -201,6 +221,7 @@ struct FeedViewPost
     using SharedPtr = std::shared_ptr<FeedViewPost>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 using PostFeed = FeedViewPost::List;
@@ -216,6 +237,7 @@ struct OutputFeed
     using SharedPtr = std::shared_ptr<OutputFeed>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 struct ThreadViewPost;
@@ -237,6 +259,7 @@ struct ThreadViewPost
 
     using SharedPtr = std::shared_ptr<ThreadViewPost>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.defs#threadViewPost";
 };
 
@@ -248,6 +271,7 @@ struct PostThread
 
     using SharedPtr = std::shared_ptr<PostThread>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.feed.like
@@ -261,6 +285,7 @@ struct Like
 
     using SharedPtr = std::shared_ptr<Like>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.like";
 };
 
@@ -275,6 +300,7 @@ struct Repost
 
     using SharedPtr = std::shared_ptr<Repost>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "app.bsky.feed.repost";
 };
 
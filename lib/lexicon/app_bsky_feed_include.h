@@ -1,17 +1,23 @@
 // Copyright (C) 2025 Michel de Boer
 // License: GPLv3
 #pragma once
+#include <QAnyStringView>
 #include <QJsonDocument>
 #include <QString>
 
 // Extra header to break cyclic dependencies
 
+namespace ATProto {
+class JsonWriter;
+}
+
 namespace ATProto::AppBskyFeed {
 
 // app.bsky.feed.postgate#disableRule
 struct PostgateDisableRule
 {
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<PostgateDisableRule>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -22,6 +28,7 @@ struct PostgateEmbeddingRules {
     using RuleType = std::variant<PostgateDisableRule::SharedPtr>;
 
     static void insertDisableEmbedding(QJsonObject& json, const QString& field, bool disableEmbedding);
+    static void writeDisableEmbedding(JsonWriter& writer, QAnyStringView field, bool disableEmbedding);
     static bool getDisableEmbedding(const QJsonObject& json, const QString& field);
 };
 
@@ -31,6 +38,7 @@ struct ThreadgateListRule
     QString mList; // at-uri
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ThreadgateListRule>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -48,6 +56,7 @@ struct ThreadgateRules
     QJsonArray toJson() const;
 
     void insertRulesInto(QJsonObject& json, const QString& field) const;
+    void writeRulesInto(JsonWriter& writer, QAnyStringView field) const;
     static ThreadgateRules getRules(const QJsonObject& json, const QString& field);
 
     using SharedPtr = std::shared_ptr<ThreadgateRules>;
@@ -10,7 +10,7 @@ namespace ATProto::AppBskyGraph {
 GetFollowsOutput::SharedPtr GetFollowsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto follows = std::make_shared<GetFollowsOutput>();
+    auto follows = makeShared<GetFollowsOutput>();
     follows->mSubject = xjson.getRequiredObject<AppBskyActor::ProfileView>("subject");
     follows->mFollows = xjson.getRequiredVector<AppBskyActor::ProfileView>("follows");
     follows->mCursor = xjson.getOptionalString("cursor");
@@ -20,7 +20,7 @@ GetFollowsOutput::SharedPtr GetFollowsOutput::fromJson(const QJsonObject& json)
 GetFollowersOutput::SharedPtr GetFollowersOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto followers = std::make_shared<GetFollowersOutput>();
+    auto followers = makeShared<GetFollowersOutput>();
     followers->mSubject = xjson.getRequiredObject<AppBskyActor::ProfileView>("subject");
     followers->mFollowers = xjson.getRequiredVector<AppBskyActor::ProfileView>("followers");
     followers->mCursor = xjson.getOptionalString("cursor");
@@ -30,7 +30,7 @@ GetFollowersOutput::SharedPtr GetFollowersOutput::fromJson(const QJsonObject& js
 GetBlocksOutput::SharedPtr GetBlocksOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto blocks = std::make_shared<GetBlocksOutput>();
+    auto blocks = makeShared<GetBlocksOutput>();
     blocks->mBlocks = xjson.getRequiredVector<AppBskyActor::ProfileView>("blocks");
     blocks->mCursor = xjson.getOptionalString("cursor");
     return blocks;
@@ -39,7 +39,7 @@ GetBlocksOutput::SharedPtr GetBlocksOutput::fromJson(const QJsonObject& json)
 GetMutesOutput::SharedPtr GetMutesOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto blocks = std::make_shared<GetMutesOutput>();
+    auto blocks = makeShared<GetMutesOutput>();
     blocks->mMutes = xjson.getRequiredVector<AppBskyActor::ProfileView>("mutes");
     blocks->mCursor = xjson.getOptionalString("cursor");
     return blocks;
@@ -57,7 +57,7 @@ QJsonObject Follow::toJson() const
 
 Follow::SharedPtr Follow::fromJson(const QJsonObject& json)
 {
-    auto follow = std::make_shared<Follow>();
+    auto follow = makeShared<Follow>();
     XJsonObject xjson(json);
     follow->mJson = json;
     follow->mSubject = xjson.getRequiredString("subject");
@@ -77,7 +77,7 @@ QJsonObject Block::toJson() const
 
 Block::SharedPtr Block::fromJson(const QJsonObject& json)
 {
-    auto block = std::make_shared<Block>();
+    auto block = makeShared<Block>();
     XJsonObject xjson(json);
     block->mJson = json;
     block->mSubject = xjson.getRequiredString("subject");
@@ -126,7 +126,7 @@ QJsonObject ListViewerState::toJson() const
 
 ListViewerState::SharedPtr ListViewerState::fromJson(const QJsonObject& json)
 {
-    auto viewerState = std::make_shared<ListViewerState>();
+    auto viewerState = makeShared<ListViewerState>();
     XJsonObject xjson(json);
     viewerState->mMuted = xjson.getOptionalBool("muted", false);
     viewerState->mBlocked = xjson.getOptionalString("blocked");
@@ -150,7 +150,7 @@ QJsonObject ListViewBasic::toJson() const
 
 ListViewBasic::SharedPtr ListViewBasic::fromJson(const QJsonObject& json)
 {
-    auto listView = std::make_shared<ListViewBasic>();
+    auto listView = makeShared<ListViewBasic>();
     XJsonObject xjson(json);
     listView->mUri = xjson.getRequiredString("uri");
     listView->mCid = xjson.getRequiredString("cid");
@@ -184,7 +184,7 @@ QJsonObject ListView::toJson() const
 
 ListView::SharedPtr ListView::fromJson(const QJsonObject& json)
 {
-    auto listView = std::make_shared<ListView>();
+    auto listView = makeShared<ListView>();
     XJsonObject xjson(json);
     listView->mUri = xjson.getRequiredString("uri");
     listView->mCid = xjson.getRequiredString("cid");
@@ -203,7 +203,7 @@ ListView::SharedPtr ListView::fromJson(const QJsonObject& json)
 
 ListItemView::SharedPtr ListItemView::fromJson(const QJsonObject& json)
 {
-    auto listItemView = std::make_shared<ListItemView>();
+    auto listItemView = makeShared<ListItemView>();
     XJsonObject xjson(json);
     listItemView->mUri = xjson.getRequiredString("uri");
     listItemView->mSubject = xjson.getRequiredObject<AppBskyActor::ProfileView>("subject");
@@ -231,7 +231,7 @@ QJsonObject List::toJson() const
 
 List::SharedPtr List::fromJson(const QJsonObject& json)
 {
-    auto list = std::make_shared<List>();
+    auto list = makeShared<List>();
     XJsonObject xjson(json);
     list->mJson = json;
     list->mRawPurpose = xjson.getRequiredString("purpose");
@@ -256,7 +256,7 @@ QJsonObject ListBlock::toJson() const
 
 ListBlock::SharedPtr ListBlock::fromJson(const QJsonObject& json)
 {
-    auto listBlock = std::make_shared<ListBlock>();
+    auto listBlock = makeShared<ListBlock>();
     XJsonObject xjson(json);
     listBlock->mJson = json;
     listBlock->mSubject = xjson.getRequiredString("subject");
@@ -274,9 +274,20 @@ QJsonObject ListItem::toJson() const
     return json;
 }
 
+void ListItem::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.fields(mJson, { "$type", "subject", "list", "createdAt" });
+    writer.key("$type").string(TYPE);
+    writer.key("subject").string(mSubject);
+    writer.key("list").string(mList);
+    writer.key("createdAt").dateTime(mCreatedAt);
+    writer.endObject();
+}
+
 ListItem::SharedPtr ListItem::fromJson(const QJsonObject& json)
 {
-    auto listItem = std::make_shared<ListItem>();
+    auto listItem = makeShared<ListItem>();
     XJsonObject xjson(json);
     listItem->mJson = json;
     listItem->mSubject = xjson.getRequiredString("subject");
@@ -287,7 +298,7 @@ ListItem::SharedPtr ListItem::fromJson(const QJsonObject& json)
 
 GetListOutput::SharedPtr GetListOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetListOutput>();
+    auto output = makeShared<GetListOutput>();
     XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mList = xjson.getRequiredObject<ListView>("list");
@@ -297,7 +308,7 @@ GetListOutput::SharedPtr GetListOutput::fromJson(const QJsonObject& json)
 
 GetListsOutput::SharedPtr GetListsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetListsOutput>();
+    auto output = makeShared<GetListsOutput>();
     XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mLists = xjson.getRequiredVector<ListView>("lists");
@@ -306,7 +317,7 @@ GetListsOutput::SharedPtr GetListsOutput::fromJson(const QJsonObject& json)
 
 ListWithMembership::SharedPtr ListWithMembership::fromJson(const QJsonObject& json)
 {
-    auto list = std::make_shared<ListWithMembership>();
+    auto list = makeShared<ListWithMembership>();
     XJsonObject xjson(json);
     list->mList = xjson.getRequiredObject<ListView>("list");
     list->mListItem = xjson.getOptionalObject<ListItemView>("listItem");
@@ -315,7 +326,7 @@ ListWithMembership::SharedPtr ListWithMembership::fromJson(const QJsonObject& js
 
 GetListsWithMembershipOutput::SharedPtr GetListsWithMembershipOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetListsWithMembershipOutput>();
+    auto output = makeShared<GetListsWithMembershipOutput>();
     XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mListsWithMembership = xjson.getRequiredVector<ListWithMembership>("listsWithMembership");
@@ -331,7 +342,7 @@ QJsonObject StarterPackFeedItem::toJson() const
 
 StarterPackFeedItem::SharedPtr StarterPackFeedItem::fromJson(const QJsonObject& json)
 {
-    auto feedItem = std::make_shared<StarterPackFeedItem>();
+    auto feedItem = makeShared<StarterPackFeedItem>();
     XJsonObject xjson(json);
     feedItem->mUri = xjson.getRequiredString("uri");
     return feedItem;
@@ -352,7 +363,7 @@ QJsonObject StarterPack::toJson() const
 
 StarterPack::SharedPtr StarterPack::fromJson(const QJsonObject& json)
 {
-    auto starterPack = std::make_shared<StarterPack>();
+    auto starterPack = makeShared<StarterPack>();
     XJsonObject xjson(json);
     starterPack->mName = xjson.getRequiredString("name");
     starterPack->mDescription = xjson.getOptionalString("description");
@@ -381,7 +392,7 @@ QJsonObject StarterPackViewBasic::toJson() const
 
 StarterPackViewBasic::SharedPtr StarterPackViewBasic::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<StarterPackViewBasic>();
+    auto view = makeShared<StarterPackViewBasic>();
     XJsonObject xjson(json);
     view->mUri = xjson.getRequiredString("uri");
     view->mCid = xjson.getRequiredString("cid");
@@ -397,7 +408,7 @@ StarterPackViewBasic::SharedPtr StarterPackViewBasic::fromJson(const QJsonObject
 
 StarterPackView::SharedPtr StarterPackView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<StarterPackView>();
+    auto view = makeShared<StarterPackView>();
     XJsonObject xjson(json);
     view->mUri = xjson.getRequiredString("uri");
     view->mCid = xjson.getRequiredString("cid");
@@ -415,7 +426,7 @@ StarterPackView::SharedPtr StarterPackView::fromJson(const QJsonObject& json)
 
 GetStarterPacksOutput::SharedPtr GetStarterPacksOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetStarterPacksOutput>();
+    auto output = makeShared<GetStarterPacksOutput>();
     XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mStarterPacks = xjson.getRequiredVector<StarterPackViewBasic>("starterPacks");
@@ -424,7 +435,7 @@ GetStarterPacksOutput::SharedPtr GetStarterPacksOutput::fromJson(const QJsonObje
 
 GetStarterPackOutput::SharedPtr GetStarterPackOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetStarterPackOutput>();
+    auto output = makeShared<GetStarterPackOutput>();
     XJsonObject xjson(json);
     output->mStarterPack = xjson.getRequiredObject<StarterPackView>("starterPack");
     return output;
@@ -432,7 +443,7 @@ GetStarterPackOutput::SharedPtr GetStarterPackOutput::fromJson(const QJsonObject
 
 StarterPackWithMembership::SharedPtr StarterPackWithMembership::fromJson(const QJsonObject& json)
 {
-    auto starterPack = std::make_shared<StarterPackWithMembership>();
+    auto starterPack = makeShared<StarterPackWithMembership>();
     XJsonObject xjson(json);
     starterPack->mStarterPack = xjson.getRequiredObject<StarterPackView>("starterPack");
     starterPack->mListItem = xjson.getOptionalObject<ListItemView>("listItem");
@@ -441,7 +452,7 @@ StarterPackWithMembership::SharedPtr StarterPackWithMembership::fromJson(const Q
 
 GetStarterPacksWithMembershipOutput::SharedPtr GetStarterPacksWithMembershipOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetStarterPacksWithMembershipOutput>();
+    auto output = makeShared<GetStarterPacksWithMembershipOutput>();
     XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mStarterPacksWithMembership = xjson.getRequiredVector<StarterPackWithMembership>("starterPacksWithMembership");
@@ -461,7 +472,7 @@ QJsonObject Verification::toJson() const
 
 Verification::SharedPtr Verification::fromJson(const QJsonObject& json)
 {
-    auto verification = std::make_shared<Verification>();
+    auto verification = makeShared<Verification>();
     XJsonObject xjson(json);
     verification->mJson = json;
     verification->mSubject = xjson.getRequiredString("subject");
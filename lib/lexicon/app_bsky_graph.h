@@ -171,6 +171,7 @@ struct ListItem
     QJsonObject mJson;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ListItem>;
     static SharedPtr fromJson(const QJsonObject& json);
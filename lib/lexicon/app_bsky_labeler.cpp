@@ -14,7 +14,7 @@ QJsonObject LabelerViewerState::toJson() const
 
 LabelerViewerState::SharedPtr LabelerViewerState::fromJson(const QJsonObject& json)
 {
-    auto state = std::make_shared<LabelerViewerState>();
+    auto state = makeShared<LabelerViewerState>();
     XJsonObject xjson(json);
     state->mLike = xjson.getOptionalString("like");
     return state;
@@ -22,7 +22,7 @@ LabelerViewerState::SharedPtr LabelerViewerState::fromJson(const QJsonObject& js
 
 LabelerPolicies::SharedPtr LabelerPolicies::fromJson(const QJsonObject& json)
 {
-    auto policies = std::make_shared<LabelerPolicies>();
+    auto policies = makeShared<LabelerPolicies>();
     XJsonObject xjson(json);
     policies->mLabelValues = xjson.getRequiredStringVector("labelValues");
     policies->mLabelValueDefinitions = xjson.getOptionalVector<ComATProtoLabel::LabelValueDefinition>("labelValueDefinitions");
@@ -45,7 +45,7 @@ QJsonObject LabelerView::toJson() const
 
 LabelerView::SharedPtr LabelerView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<LabelerView>();
+    auto view = makeShared<LabelerView>();
     XJsonObject xjson(json);
     view->mUri = xjson.getRequiredString("uri");
     view->mCid = xjson.getRequiredString("cid");
@@ -59,7 +59,7 @@ LabelerView::SharedPtr LabelerView::fromJson(const QJsonObject& json)
 
 LabelerViewDetailed::SharedPtr LabelerViewDetailed::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<LabelerViewDetailed>();
+    auto view = makeShared<LabelerViewDetailed>();
     XJsonObject xjson(json);
     view->mUri = xjson.getRequiredString("uri");
     view->mCid = xjson.getRequiredString("cid");
@@ -74,7 +74,7 @@ LabelerViewDetailed::SharedPtr LabelerViewDetailed::fromJson(const QJsonObject&
 
 GetServicesOutput::SharedPtr GetServicesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetServicesOutput>();
+    auto output = makeShared<GetServicesOutput>();
     XJsonObject xjson(json);
     output->mViews = xjson.getRequiredVariantList<
         LabelerView,
@@ -17,7 +17,7 @@ QJsonObject Declaration::toJson() const
 Declaration::SharedPtr Declaration::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto declaration = std::make_shared<Declaration>();
+    auto declaration = makeShared<Declaration>();
     declaration->mAllowSubscriptions = AppBskyActor::stringToAllowSubscriptionsType(xjson.getRequiredString("allowSubscriptions"));
     declaration->mJson = json;
     return declaration;
@@ -55,7 +55,7 @@ QJsonObject FilterablePreference::toJson() const
 
 FilterablePreference::SharedPtr FilterablePreference::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<FilterablePreference>();
+    auto pref = makeShared<FilterablePreference>();
     XJsonObject xjson(json);
     pref->mRawInclude = xjson.getRequiredString("include");
     pref->mInclude = stringToIncludeType(pref->mRawInclude);
@@ -76,7 +76,7 @@ QJsonObject Preference::toJson() const
 
 Preference::SharedPtr Preference::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<Preference>();
+    auto pref = makeShared<Preference>();
     XJsonObject xjson(json);
     pref->mList = xjson.getRequiredBool("list");
     pref->mPush = xjson.getRequiredBool("push");
@@ -105,7 +105,7 @@ QJsonObject Preferences::toJson() const
 
 Preferences::SharedPtr Preferences::fromJson(const QJsonObject& json)
 {
-    auto prefs = std::make_shared<Preferences>();
+    auto prefs = makeShared<Preferences>();
     XJsonObject xjson(json);
     prefs->mFollow = xjson.getRequiredObject<FilterablePreference>("follow");
     prefs->mLike = xjson.getRequiredObject<FilterablePreference>("like");
@@ -125,7 +125,7 @@ Preferences::SharedPtr Preferences::fromJson(const QJsonObject& json)
 
 GetPreferencesOutput::SharedPtr GetPreferencesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetPreferencesOutput>();
+    auto output = makeShared<GetPreferencesOutput>();
     XJsonObject xjson(json);
     output->mPreferences = xjson.getRequiredObject<Preferences>("preferences");
     return output;
@@ -142,7 +142,7 @@ QJsonObject ActivitySubscription::toJson() const
 
 ActivitySubscription::SharedPtr ActivitySubscription::fromJson(const QJsonObject& json)
 {
-    auto subscription = std::make_shared<ActivitySubscription>();
+    auto subscription = makeShared<ActivitySubscription>();
     XJsonObject xjson(json);
     subscription->mPost = xjson.getRequiredBool("post");
     subscription->mReply = xjson.getRequiredBool("reply");
@@ -161,7 +161,7 @@ QJsonObject SubjectActivitySubscription::toJson() const
 
 SubjectActivitySubscription::SharedPtr SubjectActivitySubscription::fromJson(const QJsonObject& json)
 {
-    auto subject = std::make_shared<SubjectActivitySubscription>();
+    auto subject = makeShared<SubjectActivitySubscription>();
     XJsonObject xjson(json);
     subject->mSubject = xjson.getRequiredString("subject");
     subject->mActivitySubscription = xjson.getOptionalObject<ActivitySubscription>("activitySubscription");
@@ -172,7 +172,7 @@ SubjectActivitySubscription::SharedPtr SubjectActivitySubscription::fromJson(con
 ListActivitySubscriptionsOutput::SharedPtr ListActivitySubscriptionsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ListActivitySubscriptionsOutput>();
+    auto output = makeShared<ListActivitySubscriptionsOutput>();
     output->mSubscriptions = xjson.getRequiredVector<AppBskyActor::ProfileView>("subscriptions");
     output->mCursor = xjson.getOptionalString("cursor");
     return output;
@@ -229,13 +229,17 @@ QString notificationReasonToString(NotificationReason reason)
 
 RecordDeleted::SharedPtr RecordDeleted::fromJson(const QJsonObject&)
 {
-    return std::make_shared<RecordDeleted>();
+    return makeShared<RecordDeleted>();
 }
 
 Notification::SharedPtr Notification::fromJson(const QJsonObject& json)
 {
-    auto notification = std::make_shared<Notification>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Notification::SharedPtr Notification::fromJson(const XJsonObject& xjson)
+{
+    auto notification = makeShared<Notification>();
     notification->mUri = xjson.getRequiredString("uri");
     notification->mCid = xjson.getRequiredString("cid");
     notification->mAuthor = xjson.getRequiredObject<AppBskyActor::ProfileView>("author");
@@ -256,14 +260,18 @@ Notification::SharedPtr Notification::fromJson(const QJsonObject& json)
     notification->mStarterPack = xjson.getOptionalObject<AppBskyGraph::StarterPackViewBasic>("starterPack");
     notification->mIsRead = xjson.getRequiredBool("isRead");
     notification->mIndexedAt = xjson.getRequiredDateTime("indexedAt");
-    ComATProtoLabel::getLabels(notification->mLabels, json);
+    ComATProtoLabel::getLabels(notification->mLabels, xjson);
     return notification;
 }
 
 ListNotificationsOutput::SharedPtr ListNotificationsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<ListNotificationsOutput>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+ListNotificationsOutput::SharedPtr ListNotificationsOutput::fromJson(const XJsonObject& xjson)
+{
+    auto output = makeShared<ListNotificationsOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mNotifications = xjson.getRequiredVector<Notification>("notifications");
     output->mPriority = xjson.getOptionalBool("priority", false);
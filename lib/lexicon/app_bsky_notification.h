@@ -176,6 +176,7 @@ struct Notification
     using SharedPtr = std::shared_ptr<Notification>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.notification.listNotifications#Output
@@ -188,6 +189,7 @@ struct ListNotificationsOutput
 
     using SharedPtr = std::shared_ptr<ListNotificationsOutput>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 }
@@ -15,11 +15,15 @@ QJsonObject FacetByteSlice::toJson() const
 }
 
 FacetByteSlice FacetByteSlice::fromJson(const QJsonObject& json)
+{
+    return fromJson(XJsonObject(json));
+}
+
+FacetByteSlice FacetByteSlice::fromJson(const XJsonObject& xjson)
 {
     FacetByteSlice byteSlice;
-    XJsonObject root(json);
-    byteSlice.mByteStart = root.getRequiredInt("byteStart");
-    byteSlice.mByteEnd = root.getRequiredInt("byteEnd");
+    byteSlice.mByteStart = xjson.getRequiredInt("byteStart");
+    byteSlice.mByteEnd = xjson.getRequiredInt("byteEnd");
     return byteSlice;
 }
 
@@ -33,9 +37,13 @@ QJsonObject FacetMention::toJson() const
 
 FacetMention::SharedPtr FacetMention::fromJson(const QJsonObject& json)
 {
-    auto mention = std::make_shared<FacetMention>();
-    const XJsonObject root(json);
-    mention->mDid = root.getRequiredString("did");
+    return fromJson(XJsonObject(json));
+}
+
+FacetMention::SharedPtr FacetMention::fromJson(const XJsonObject& xjson)
+{
+    auto mention = makeShared<FacetMention>();
+    mention->mDid = xjson.getRequiredString("did");
     return mention;
 }
 
@@ -49,9 +57,13 @@ QJsonObject FacetLink::toJson() const
 
 FacetLink::SharedPtr FacetLink::fromJson(const QJsonObject& json)
 {
-    auto link = std::make_shared<FacetLink>();
-    const XJsonObject root(json);
-    link->mUri = root.getRequiredString("uri");
+    return fromJson(XJsonObject(json));
+}
+
+FacetLink::SharedPtr FacetLink::fromJson(const XJsonObject& xjson)
+{
+    auto link = makeShared<FacetLink>();
+    link->mUri = xjson.getRequiredString("uri");
     return link;
 }
 
@@ -65,9 +77,13 @@ QJsonObject FacetTag::toJson() const
 
 FacetTag::SharedPtr FacetTag::fromJson(const QJsonObject& json)
 {
-    auto tag = std::make_shared<FacetTag>();
-    const XJsonObject root(json);
-    tag->mTag = root.getRequiredString("tag");
+    return fromJson(XJsonObject(json));
+}
+
+FacetTag::SharedPtr FacetTag::fromJson(const XJsonObject& xjson)
+{
+    auto tag = makeShared<FacetTag>();
+    tag->mTag = xjson.getRequiredString("tag");
     return tag;
 }
 
@@ -121,20 +137,22 @@ QJsonObject Facet::toJson() const
 
 Facet::SharedPtr Facet::fromJson(const QJsonObject& json)
 {
-    auto facet = std::make_shared<Facet>();
-    const XJsonObject root(json);
-    facet->mIndex = FacetByteSlice::fromJson(root.getRequiredJsonObject("index"));
-    const auto features = root.getRequiredArray("features");
+    return fromJson(XJsonObject(json));
+}
+
+Facet::SharedPtr Facet::fromJson(const XJsonObject& xjson)
+{
+    auto facet = makeShared<Facet>();
+    facet->mIndex = FacetByteSlice::fromJson(XJsonObject(xjson.getField("index", QJsonValue::Object)));
+    const XJsonValue features = xjson.getField("features", QJsonValue::Array);
 
-    for (const auto& f: features)
-    {
+    features.forEachElement([&facet](const XJsonValue& f){
         if (!f.isObject())
             throw InvalidJsonException("Invalid facet feature");
 
         Feature feature;
-        const QJsonObject featureJson = f.toObject();
-        const XJsonObject featureRoot(featureJson);
-        const QString type = featureRoot.getRequiredString("$type");
+        const XJsonObject featureJson(f);
+        const QString type = featureJson.getRequiredString("$type");
         feature.mType = Facet::Feature::stringToType(type);
 
         switch (feature.mType)
@@ -155,7 +173,7 @@ Facet::SharedPtr Facet::fromJson(const QJsonObject& json)
         }
 
         facet->mFeatures.push_back(std::move(feature));
-    }
+    });
 
     return facet;
 }
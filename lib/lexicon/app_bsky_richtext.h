@@ -5,6 +5,10 @@
 #include <QString>
 #include <set>
 
+namespace ATProto {
+class XJsonObject;
+}
+
 namespace ATProto::AppBskyRichtext {
 
 // app.bsky.richtext.facet#byteSlice
@@ -16,6 +20,7 @@ struct FacetByteSlice
     QJsonObject toJson() const;
 
     static FacetByteSlice fromJson(const QJsonObject& json);
+    static FacetByteSlice fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.richtext.facet#mention
@@ -27,6 +32,7 @@ struct FacetMention
 
     using SharedPtr = std::shared_ptr<FacetMention>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.richtext.facet#link
@@ -38,6 +44,7 @@ struct FacetLink
 
     using SharedPtr = std::shared_ptr<FacetLink>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.richtext.facet#tag
@@ -49,6 +56,7 @@ struct FacetTag
 
     using SharedPtr = std::shared_ptr<FacetTag>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // app.bsky.richtext.facet
@@ -79,6 +87,7 @@ struct Facet
     using SharedPtr = std::shared_ptr<Facet>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 /**
@@ -7,7 +7,7 @@ namespace ATProto::AppBskyUnspecced {
 
 GetPopularFeedGeneratorsOutput::SharedPtr GetPopularFeedGeneratorsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetPopularFeedGeneratorsOutput>();
+    auto output = makeShared<GetPopularFeedGeneratorsOutput>();
     const XJsonObject xjson(json);
     output->mFeeds = xjson.getRequiredVector<AppBskyFeed::GeneratorView>("feeds");
     output->mCursor = xjson.getOptionalString("cursor");
@@ -16,7 +16,7 @@ GetPopularFeedGeneratorsOutput::SharedPtr GetPopularFeedGeneratorsOutput::fromJs
 
 TrendingTopic::SharedPtr TrendingTopic::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<TrendingTopic>();
+    auto output = makeShared<TrendingTopic>();
     const XJsonObject xjson(json);
     output->mTopic = xjson.getRequiredString("topic");
     output->mDisplayName = xjson.getOptionalString("displayName");
@@ -36,7 +36,7 @@ TrendStatus stringToTrendStatus(const QString& str)
 
 TrendView::SharedPtr TrendView::fromJson(const QJsonObject& json)
 {
-    auto view = std::make_shared<TrendView>();
+    auto view = makeShared<TrendView>();
     const XJsonObject xjson(json);
     view->mTopic = xjson.getRequiredString("topic");
     view->mDisplayName = xjson.getRequiredString("displayName");
@@ -56,7 +56,7 @@ TrendView::SharedPtr TrendView::fromJson(const QJsonObject& json)
 
 GetTrendsOutput::SharedPtr GetTrendsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetTrendsOutput>();
+    auto output = makeShared<GetTrendsOutput>();
     const XJsonObject xjson(json);
     output->mTrends = xjson.getRequiredVector<TrendView>("trends");
     output->mRecIdStr = xjson.getOptionalString("recIdStr");
@@ -65,7 +65,7 @@ GetTrendsOutput::SharedPtr GetTrendsOutput::fromJson(const QJsonObject& json)
 
 GetSuggestedStarterPacksOutput::SharedPtr GetSuggestedStarterPacksOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetSuggestedStarterPacksOutput>();
+    auto output = makeShared<GetSuggestedStarterPacksOutput>();
     const XJsonObject xjson(json);
     output->mStarterPacks = xjson.getRequiredVector<AppBskyGraph::StarterPackView>("starterPacks");
     return output;
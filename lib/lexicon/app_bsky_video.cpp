@@ -42,7 +42,7 @@ JobStatusFailure stringToJobStatusFailure(const QString& str)
 
 JobStatus::SharedPtr JobStatus::fromJson(const QJsonObject& json)
 {
-    auto jobStatus = std::make_shared<JobStatus>();
+    auto jobStatus = makeShared<JobStatus>();
     const XJsonObject xjson(json);
     jobStatus->mJobId = xjson.getRequiredString("jobId");
     jobStatus->mDid = xjson.getRequiredString("did");
@@ -62,7 +62,7 @@ JobStatus::SharedPtr JobStatus::fromJson(const QJsonObject& json)
 
 JobStatusOutput::SharedPtr JobStatusOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<JobStatusOutput>();
+    auto output = makeShared<JobStatusOutput>();
     const XJsonObject xjson(json);
     output->mJobStatus = xjson.getRequiredObject<JobStatus>("jobStatus");
     return output;
@@ -70,7 +70,7 @@ JobStatusOutput::SharedPtr JobStatusOutput::fromJson(const QJsonObject& json)
 
 GetUploadLimitsOutput::SharedPtr GetUploadLimitsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetUploadLimitsOutput>();
+    auto output = makeShared<GetUploadLimitsOutput>();
     const XJsonObject xjson(json);
     output->mCanUpload = xjson.getRequiredBool("canUpload");
     output->mRemainingDailyVideos = xjson.getOptionalInt("remainingDailyVideos");
@@ -82,7 +82,7 @@ GetUploadLimitsOutput::SharedPtr GetUploadLimitsOutput::fromJson(const QJsonObje
 
 StartUploadOutput::SharedPtr StartUploadOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<StartUploadOutput>();
+    auto output = makeShared<StartUploadOutput>();
     const XJsonObject xjson(json);
     output->mJobId = xjson.getRequiredString("jobId");
     output->mPartSizeBytes = xjson.getRequiredInt("partSizeBytes");
@@ -93,7 +93,7 @@ StartUploadOutput::SharedPtr StartUploadOutput::fromJson(const QJsonObject& json
 
 UploadPartOutput::SharedPtr UploadPartOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<UploadPartOutput>();
+    auto output = makeShared<UploadPartOutput>();
     const XJsonObject xjson(json);
     output->mPartNumnber = xjson.getRequiredInt("partNumber");
     output->mSizeInBytes = xjson.getRequiredInt("sizeInBytes");
@@ -102,7 +102,7 @@ UploadPartOutput::SharedPtr UploadPartOutput::fromJson(const QJsonObject& json)
 
 FinishUploadOutput::SharedPtr FinishUploadOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<FinishUploadOutput>();
+    auto output = makeShared<FinishUploadOutput>();
     const XJsonObject xjson(json);
     output->mCompletedJobId = xjson.getRequiredString("completedJobId");
     output->mJobStatus = xjson.getRequiredObject<JobStatus>("jobStatus");
@@ -128,7 +128,7 @@ AbortState stringToAbortState(const QString& str)
 
 AbortUploadOutput::SharedPtr AbortUploadOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<AbortUploadOutput>();
+    auto output = makeShared<AbortUploadOutput>();
     const XJsonObject xjson(json);
     output->mRawState = xjson.getRequiredString("state");
     output->mState = stringToAbortState(output->mRawState);
@@ -20,7 +20,7 @@ QJsonObject Declaration::toJson() const
 Declaration::SharedPtr Declaration::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto declaration = std::make_shared<Declaration>();
+    auto declaration = makeShared<Declaration>();
     declaration->mAllowIncoming = AppBskyActor::stringToAllowIncomingType(xjson.getRequiredString("allowIncoming"));
     const auto allowGroup = xjson.getOptionalString("allowGroupInvites");
 
@@ -43,14 +43,14 @@ MemberRole stringToMemberRole(const QString& str)
 
 DirectConvoMember::SharedPtr DirectConvoMember::fromJson(const QJsonObject&)
 {
-    auto member = std::make_shared<DirectConvoMember>();
+    auto member = makeShared<DirectConvoMember>();
     return member;
 }
 
 GroupConvoMember::SharedPtr GroupConvoMember::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto member = std::make_shared<GroupConvoMember>();
+    auto member = makeShared<GroupConvoMember>();
     member->mAddedBy = xjson.getOptionalObject<ProfileViewBasic>("addedBy");
     member->mRawRole = xjson.getRequiredString("role");
     member->mRole = stringToMemberRole(member->mRawRole);
@@ -59,14 +59,14 @@ GroupConvoMember::SharedPtr GroupConvoMember::fromJson(const QJsonObject& json)
 
 PastGroupConvoMember::SharedPtr PastGroupConvoMember::fromJson(const QJsonObject&)
 {
-    auto member = std::make_shared<PastGroupConvoMember>();
+    auto member = makeShared<PastGroupConvoMember>();
     return member;
 }
 
 ProfileViewBasic::SharedPtr ProfileViewBasic::fromJson(const QJsonObject& json)
 {
     XJsonObject root(json);
-    auto profileViewBasic = std::make_shared<ProfileViewBasic>();
+    auto profileViewBasic = makeShared<ProfileViewBasic>();
     profileViewBasic->mDid = root.getRequiredString("did");
     profileViewBasic->mHandle = root.getRequiredString("handle");
     profileViewBasic->mDisplayName = root.getOptionalString("displayName");
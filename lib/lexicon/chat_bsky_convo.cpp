@@ -17,7 +17,7 @@ QJsonObject ConvoRef::toJson() const
 ConvoRef::SharedPtr ConvoRef::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto ref = std::make_shared<ConvoRef>();
+    auto ref = makeShared<ConvoRef>();
     ref->mDid = xjson.getRequiredString("did");
     ref->mConvoId = xjson.getRequiredString("convoId");
     return ref;
@@ -36,7 +36,7 @@ QJsonObject MessageRef::toJson() const
 MessageRef::SharedPtr MessageRef::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto ref = std::make_shared<MessageRef>();
+    auto ref = makeShared<MessageRef>();
     ref->mDid = xjson.getRequiredString("did");
     ref->mConvoId = xjson.getRequiredString("convoId");
     ref->mMessageId = xjson.getRequiredString("messageId");
@@ -54,7 +54,7 @@ QJsonObject ReplyRef::toJson() const
 ReplyRef::SharedPtr ReplyRef::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto ref = std::make_shared<ReplyRef>();
+    auto ref = makeShared<ReplyRef>();
     ref->mMessageId = xjson.getRequiredString("messageId");
     return ref;
 }
@@ -70,10 +70,26 @@ QJsonObject MessageInput::toJson() const
     return json;
 }
 
+void MessageInput::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string(MessageInput::TYPE);
+    writer.key("text").string(mText);
+    writer.key("facets").array<AppBskyRichtext::Facet>(mFacets);
+
+    if (mEmbed && !isNullVariant(*mEmbed))
+        writer.key("embed").variant(*mEmbed);
+
+    if (mReplyTo)
+        writer.key("replyTo").object(*mReplyTo);
+
+    writer.endObject();
+}
+
 MessageInput::SharedPtr MessageInput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto msg = std::make_shared<MessageInput>();
+    auto msg = makeShared<MessageInput>();
     msg->mText = xjson.getRequiredString("text");
     msg->mFacets = xjson.getOptionalVector<AppBskyRichtext::Facet>("facets");
     msg->mEmbed = xjson.getOptionalVariant<AppBskyEmbed::Record, ChatBskyEmbed::JoinLink>("embed");
@@ -84,7 +100,7 @@ MessageInput::SharedPtr MessageInput::fromJson(const QJsonObject& json)
 ReactionViewSender::SharedPtr ReactionViewSender::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto sender = std::make_shared<ReactionViewSender>();
+    auto sender = makeShared<ReactionViewSender>();
     sender->mDid = xjson.getRequiredString("did");
     return sender;
 }
@@ -102,7 +118,7 @@ ReactionView::SharedPtr ReactionView::fromJson(const QJsonObject& json)
 MessageViewSender::SharedPtr MessageViewSender::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto sender = std::make_shared<MessageViewSender>();
+    auto sender = makeShared<MessageViewSender>();
     sender->mDid = xjson.getRequiredString("did");
     return sender;
 }
@@ -110,7 +126,7 @@ MessageViewSender::SharedPtr MessageViewSender::fromJson(const QJsonObject& json
 MessageView::SharedPtr MessageView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<MessageView>();
+    auto view = makeShared<MessageView>();
     view->mId = xjson.getRequiredString("id");
     view->mRev = xjson.getRequiredString("rev");
     view->mText = xjson.getRequiredString("text");
@@ -130,7 +146,7 @@ MessageView::SharedPtr MessageView::fromJson(const QJsonObject& json)
 MessageAndReactionView::SharedPtr MessageAndReactionView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<MessageAndReactionView>();
+    auto view = makeShared<MessageAndReactionView>();
     view->mMessageView = xjson.getRequiredObject<MessageView>("message");
     view->mReactionView = xjson.getRequiredObject<ReactionView>("reaction");
     return view;
@@ -139,7 +155,7 @@ MessageAndReactionView::SharedPtr MessageAndReactionView::fromJson(const QJsonOb
 DeletedMessageView::SharedPtr DeletedMessageView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<DeletedMessageView>();
+    auto view = makeShared<DeletedMessageView>();
     view->mId = xjson.getRequiredString("id");
     view->mRev = xjson.getRequiredString("rev");
     view->mSender = xjson.getRequiredObject<MessageViewSender>("sender");
@@ -149,14 +165,14 @@ DeletedMessageView::SharedPtr DeletedMessageView::fromJson(const QJsonObject& js
 
 MessageBeforeUserJoinedGroupView::SharedPtr MessageBeforeUserJoinedGroupView::fromJson(const QJsonObject&)
 {
-    auto view = std::make_shared<MessageBeforeUserJoinedGroupView>();
+    auto view = makeShared<MessageBeforeUserJoinedGroupView>();
     return view;
 }
 
 SystemMessageReferredUser::SharedPtr SystemMessageReferredUser::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto user = std::make_shared<SystemMessageReferredUser>();
+    auto user = makeShared<SystemMessageReferredUser>();
     user->mDid = xjson.getRequiredString("did");
     return user;
 }
@@ -164,7 +180,7 @@ SystemMessageReferredUser::SharedPtr SystemMessageReferredUser::fromJson(const Q
 SystemMessageDataAddMember::SharedPtr SystemMessageDataAddMember::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataAddMember>();
+    auto data = makeShared<SystemMessageDataAddMember>();
     data->mMember = xjson.getRequiredObject<SystemMessageReferredUser>("member");
     data->mRawRole = xjson.getRequiredString("role");
     data->mRole = ChatBskyActor::stringToMemberRole(data->mRawRole);
@@ -175,7 +191,7 @@ SystemMessageDataAddMember::SharedPtr SystemMessageDataAddMember::fromJson(const
 SystemMessageDataRemoveMember::SharedPtr SystemMessageDataRemoveMember::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataRemoveMember>();
+    auto data = makeShared<SystemMessageDataRemoveMember>();
     data->mMember = xjson.getRequiredObject<SystemMessageReferredUser>("member");
     data->mRemovedBy = xjson.getRequiredObject<SystemMessageReferredUser>("removedBy");
     return data;
@@ -184,7 +200,7 @@ SystemMessageDataRemoveMember::SharedPtr SystemMessageDataRemoveMember::fromJson
 SystemMessageDataMemberJoin::SharedPtr SystemMessageDataMemberJoin::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataMemberJoin>();
+    auto data = makeShared<SystemMessageDataMemberJoin>();
     data->mMember = xjson.getRequiredObject<SystemMessageReferredUser>("member");
     data->mRawRole = xjson.getRequiredString("role");
     data->mRole = ChatBskyActor::stringToMemberRole(data->mRawRole);
@@ -195,7 +211,7 @@ SystemMessageDataMemberJoin::SharedPtr SystemMessageDataMemberJoin::fromJson(con
 SystemMessageDataMemberLeave::SharedPtr SystemMessageDataMemberLeave::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataMemberLeave>();
+    auto data = makeShared<SystemMessageDataMemberLeave>();
     data->mMember = xjson.getRequiredObject<SystemMessageReferredUser>("member");
     return data;
 }
@@ -203,7 +219,7 @@ SystemMessageDataMemberLeave::SharedPtr SystemMessageDataMemberLeave::fromJson(c
 SystemMessageDataLockConvo::SharedPtr SystemMessageDataLockConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataLockConvo>();
+    auto data = makeShared<SystemMessageDataLockConvo>();
     data->mLockedBy = xjson.getRequiredObject<SystemMessageReferredUser>("lockedBy");
     return data;
 }
@@ -211,7 +227,7 @@ SystemMessageDataLockConvo::SharedPtr SystemMessageDataLockConvo::fromJson(const
 SystemMessageDataUnlockConvo::SharedPtr SystemMessageDataUnlockConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataUnlockConvo>();
+    auto data = makeShared<SystemMessageDataUnlockConvo>();
     data->mUnlockedBy = xjson.getRequiredObject<SystemMessageReferredUser>("unlockedBy");
     return data;
 }
@@ -219,7 +235,7 @@ SystemMessageDataUnlockConvo::SharedPtr SystemMessageDataUnlockConvo::fromJson(c
 SystemMessageDataLockConvoPermanently::SharedPtr SystemMessageDataLockConvoPermanently::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataLockConvoPermanently>();
+    auto data = makeShared<SystemMessageDataLockConvoPermanently>();
     data->mLockedBy = xjson.getRequiredObject<SystemMessageReferredUser>("lockedBy");
     return data;
 }
@@ -227,7 +243,7 @@ SystemMessageDataLockConvoPermanently::SharedPtr SystemMessageDataLockConvoPerma
 SystemMessageDataEditGroup::SharedPtr SystemMessageDataEditGroup::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto data = std::make_shared<SystemMessageDataEditGroup>();
+    auto data = makeShared<SystemMessageDataEditGroup>();
     data->mOldName = xjson.getOptionalString("oldName");
     data->mNewName = xjson.getOptionalString("newName");
     return data;
@@ -235,32 +251,32 @@ SystemMessageDataEditGroup::SharedPtr SystemMessageDataEditGroup::fromJson(const
 
 SystemMessageDataCreateJoinLink::SharedPtr SystemMessageDataCreateJoinLink::fromJson(const QJsonObject&)
 {
-    auto data = std::make_shared<SystemMessageDataCreateJoinLink>();
+    auto data = makeShared<SystemMessageDataCreateJoinLink>();
     return data;
 }
 
 SystemMessageDataEditJoinLink::SharedPtr SystemMessageDataEditJoinLink::fromJson(const QJsonObject&)
 {
-    auto data = std::make_shared<SystemMessageDataEditJoinLink>();
+    auto data = makeShared<SystemMessageDataEditJoinLink>();
     return data;
 }
 
 SystemMessageDataEnableJoinLink::SharedPtr SystemMessageDataEnableJoinLink::fromJson(const QJsonObject&)
 {
-    auto data = std::make_shared<SystemMessageDataEnableJoinLink>();
+    auto data = makeShared<SystemMessageDataEnableJoinLink>();
     return data;
 }
 
 SystemMessageDataDisableJoinLink::SharedPtr SystemMessageDataDisableJoinLink::fromJson(const QJsonObject&)
 {
-    auto data = std::make_shared<SystemMessageDataDisableJoinLink>();
+    auto data = makeShared<SystemMessageDataDisableJoinLink>();
     return data;
 }
 
 SystemMessageView::SharedPtr SystemMessageView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<SystemMessageView>();
+    auto view = makeShared<SystemMessageView>();
     view->mId = xjson.getRequiredString("id");
     view->mRev = xjson.getRequiredString("rev");
     view->mSentAt = xjson.getRequiredDateTime("sentAt");
@@ -347,14 +363,14 @@ QString convoStatusToString(ConvoStatus status)
 
 DirectConvo::SharedPtr DirectConvo::fromJson(const QJsonObject&)
 {
-    auto convo = std::make_shared<DirectConvo>();
+    auto convo = makeShared<DirectConvo>();
     return convo;
 }
 
 GroupConvo::SharedPtr GroupConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto convo = std::make_shared<GroupConvo>();
+    auto convo = makeShared<GroupConvo>();
     convo->mName = xjson.getRequiredString("name");
     convo->mMemberCount = xjson.getRequiredInt("memberCount");
     convo->mCreatedAt = xjson.getRequiredDateTime("createdAt");
@@ -371,7 +387,7 @@ GroupConvo::SharedPtr GroupConvo::fromJson(const QJsonObject& json)
 ConvoView::SharedPtr ConvoView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<ConvoView>();
+    auto view = makeShared<ConvoView>();
     view->mId = xjson.getRequiredString("id");
     view->mRev = xjson.getRequiredString("rev");
     view->mMembers = xjson.getRequiredVector<ChatBskyActor::ProfileViewBasic>("members");
@@ -394,7 +410,7 @@ ConvoView::SharedPtr ConvoView::fromJson(const QJsonObject& json)
 LogBeginConvo::SharedPtr LogBeginConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logBeginConvo = std::make_shared<LogBeginConvo>();
+    auto logBeginConvo = makeShared<LogBeginConvo>();
     logBeginConvo->mConvoId = xjson.getRequiredString("convoId");
     logBeginConvo->mRev = xjson.getRequiredString("rev");
     return logBeginConvo;
@@ -403,7 +419,7 @@ LogBeginConvo::SharedPtr LogBeginConvo::fromJson(const QJsonObject& json)
 LogAcceptConvo::SharedPtr LogAcceptConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logAcceptConvo = std::make_shared<LogAcceptConvo>();
+    auto logAcceptConvo = makeShared<LogAcceptConvo>();
     logAcceptConvo->mConvoId = xjson.getRequiredString("convoId");
     logAcceptConvo->mRev = xjson.getRequiredString("rev");
     return logAcceptConvo;
@@ -412,7 +428,7 @@ LogAcceptConvo::SharedPtr LogAcceptConvo::fromJson(const QJsonObject& json)
 LogLeaveConvo::SharedPtr LogLeaveConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logLeaveConvo = std::make_shared<LogLeaveConvo>();
+    auto logLeaveConvo = makeShared<LogLeaveConvo>();
     logLeaveConvo->mConvoId = xjson.getRequiredString("convoId");
     logLeaveConvo->mRev = xjson.getRequiredString("rev");
     return logLeaveConvo;
@@ -421,7 +437,7 @@ LogLeaveConvo::SharedPtr LogLeaveConvo::fromJson(const QJsonObject& json)
 LogMuteConvo::SharedPtr LogMuteConvo::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logMuteConvo = std::make_shared<LogMuteConvo>();
+    auto logMuteConvo = makeShared<LogMuteConvo>();
     logMuteConvo->mConvoId = xjson.getRequiredString("convoId");
     logMuteConvo->mRev = xjson.getRequiredString("rev");
     return logMuteConvo;
@@ -429,8 +445,12 @@ LogMuteConvo::SharedPtr LogMuteConvo::fromJson(const QJsonObject& json)
 
 LogCreateMessage::SharedPtr LogCreateMessage::fromJson(const QJsonObject& json)
 {
-    XJsonObject xjson(json);
-    auto logCreateMessage = std::make_shared<LogCreateMessage>();
+    return fromJson(XJsonObject(json));
+}
+
+LogCreateMessage::SharedPtr LogCreateMessage::fromJson(const XJsonObject& xjson)
+{
+    auto logCreateMessage = makeShared<LogCreateMessage>();
     logCreateMessage->mConvoId = xjson.getRequiredString("convoId");
     logCreateMessage->mRev = xjson.getRequiredString("rev");
     logCreateMessage->mMessage = xjson.getRequiredVariant<MessageView, DeletedMessageView>("message");
@@ -440,7 +460,7 @@ LogCreateMessage::SharedPtr LogCreateMessage::fromJson(const QJsonObject& json)
 LogDeleteMessage::SharedPtr LogDeleteMessage::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logDeleteMessage = std::make_shared<LogDeleteMessage>();
+    auto logDeleteMessage = makeShared<LogDeleteMessage>();
     logDeleteMessage->mConvoId = xjson.getRequiredString("convoId");
     logDeleteMessage->mRev = xjson.getRequiredString("rev");
     logDeleteMessage->mMessage = xjson.getRequiredVariant<MessageView, DeletedMessageView>("message");
@@ -450,7 +470,7 @@ LogDeleteMessage::SharedPtr LogDeleteMessage::fromJson(const QJsonObject& json)
 LogReadMessage::SharedPtr LogReadMessage::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto logReadMessage = std::make_shared<LogReadMessage>();
+    auto logReadMessage = makeShared<LogReadMessage>();
     logReadMessage->mConvoId = xjson.getRequiredString("convoId");
     logReadMessage->mRev = xjson.getRequiredString("rev");
     logReadMessage->mMessage = xjson.getRequiredVariant<MessageView, DeletedMessageView>("message");
@@ -460,7 +480,7 @@ LogReadMessage::SharedPtr LogReadMessage::fromJson(const QJsonObject& json)
 AcceptConvoOutput::SharedPtr AcceptConvoOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<AcceptConvoOutput>();
+    auto output = makeShared<AcceptConvoOutput>();
     output->mRev = xjson.getOptionalString("rev");
     return output;
 }
@@ -468,7 +488,7 @@ AcceptConvoOutput::SharedPtr AcceptConvoOutput::fromJson(const QJsonObject& json
 ConvoOutput::SharedPtr ConvoOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ConvoOutput>();
+    auto output = makeShared<ConvoOutput>();
     output->mConvo = xjson.getRequiredObject<ConvoView>("convo");
     return output;
 }
@@ -476,7 +496,7 @@ ConvoOutput::SharedPtr ConvoOutput::fromJson(const QJsonObject& json)
 ConvoAvailabilityOuput::SharedPtr ConvoAvailabilityOuput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ConvoAvailabilityOuput>();
+    auto output = makeShared<ConvoAvailabilityOuput>();
     output->mCanChat = xjson.getRequiredBool("canChat");
     output->mConvo = xjson.getOptionalObject<ConvoView>("convo");
     return output;
@@ -485,7 +505,7 @@ ConvoAvailabilityOuput::SharedPtr ConvoAvailabilityOuput::fromJson(const QJsonOb
 ConvoUnreadCountsOutput::SharedPtr ConvoUnreadCountsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ConvoUnreadCountsOutput>();
+    auto output = makeShared<ConvoUnreadCountsOutput>();
     output->mUnreadAcceptedConvos = xjson.getRequiredInt("unreadAcceptedConvos");
     output->mUnreadRequestConvos = xjson.getRequiredInt("unreadRequestConvos");
     return output;
@@ -494,7 +514,7 @@ ConvoUnreadCountsOutput::SharedPtr ConvoUnreadCountsOutput::fromJson(const QJson
 ConvoListOutput::SharedPtr ConvoListOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ConvoListOutput>();
+    auto output = makeShared<ConvoListOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mConvos = xjson.getRequiredVector<ConvoView>("convos");
     return output;
@@ -503,7 +523,7 @@ ConvoListOutput::SharedPtr ConvoListOutput::fromJson(const QJsonObject& json)
 ConvoRequestListOutput::SharedPtr ConvoRequestListOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<ConvoRequestListOutput>();
+    auto output = makeShared<ConvoRequestListOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mRequests = xjson.getRequiredVariantList<ChatBskyConvo::ConvoView,
                                                      ChatBskyGroup::JoinRequestConvoView,
@@ -514,7 +534,7 @@ ConvoRequestListOutput::SharedPtr ConvoRequestListOutput::fromJson(const QJsonOb
 LogOutput::SharedPtr LogOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<LogOutput>();
+    auto output = makeShared<LogOutput>();
     output->mLogs = xjson.getRequiredVariantList<LogBeginConvo, LogLeaveConvo, LogCreateMessage, LogDeleteMessage>("logs");
     return output;
 }
@@ -522,7 +542,7 @@ LogOutput::SharedPtr LogOutput::fromJson(const QJsonObject& json)
 GetMessagesOutput::SharedPtr GetMessagesOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<GetMessagesOutput>();
+    auto output = makeShared<GetMessagesOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mMessages = xjson.getRequiredVariantList<MessageView,
                                                      DeletedMessageView,
@@ -534,7 +554,7 @@ GetMessagesOutput::SharedPtr GetMessagesOutput::fromJson(const QJsonObject& json
 LeaveConvoOutput::SharedPtr LeaveConvoOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<LeaveConvoOutput>();
+    auto output = makeShared<LeaveConvoOutput>();
     output->mConvoId = xjson.getRequiredString("convoId");
     output->mRev = xjson.getRequiredString("rev");
     return output;
@@ -543,7 +563,7 @@ LeaveConvoOutput::SharedPtr LeaveConvoOutput::fromJson(const QJsonObject& json)
 UpdateAllReadOutput::SharedPtr UpdateAllReadOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<UpdateAllReadOutput>();
+    auto output = makeShared<UpdateAllReadOutput>();
     output->mUpdatedCount = xjson.getRequiredInt("updatedCount");
     return output;
 }
@@ -551,7 +571,7 @@ UpdateAllReadOutput::SharedPtr UpdateAllReadOutput::fromJson(const QJsonObject&
 MessageOutput::SharedPtr MessageOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<MessageOutput>();
+    auto output = makeShared<MessageOutput>();
     output->mMessage = xjson.getRequiredObject<MessageView>("message");
     return output;
 }
@@ -559,7 +579,7 @@ MessageOutput::SharedPtr MessageOutput::fromJson(const QJsonObject& json)
 GetConvoMembersOutput::SharedPtr GetConvoMembersOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<GetConvoMembersOutput>();
+    auto output = makeShared<GetConvoMembersOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mMembers = xjson.getRequiredVector<ChatBskyActor::ProfileViewBasic>("members");
     return output;
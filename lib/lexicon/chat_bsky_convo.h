@@ -60,6 +60,7 @@ struct MessageInput
     ReplyRef::SharedPtr mReplyTo; // optional
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<MessageInput>;
     static SharedPtr fromJson(const QJsonObject& json);
@@ -439,6 +440,7 @@ struct LogCreateMessage
 
     using SharedPtr = std::shared_ptr<LogCreateMessage>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
     static constexpr char const* TYPE = "chat.bsky.convo.defs#logCreateMessage";
 };
 
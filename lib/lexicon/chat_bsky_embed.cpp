@@ -17,7 +17,7 @@ QJsonObject JoinLink::toJson() const
 JoinLink::SharedPtr JoinLink::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto joinLink = std::make_shared<JoinLink>();
+    auto joinLink = makeShared<JoinLink>();
     joinLink->mCode = xjson.getRequiredString("joinLink");
     joinLink->mJson = json;
     return joinLink;
@@ -26,7 +26,7 @@ JoinLink::SharedPtr JoinLink::fromJson(const QJsonObject& json)
 JoinLinkView::SharedPtr JoinLinkView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<JoinLinkView>();
+    auto view = makeShared<JoinLinkView>();
     view->mJoinLinkPreview = xjson.getRequiredVariant<
             ChatBskyGroup::JoinLinkPreviewView,
             ChatBskyGroup::DisabledJoinLinkPreviewView,
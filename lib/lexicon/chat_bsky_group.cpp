@@ -38,7 +38,7 @@ QString joinRuleToString(JoinRule rule)
 JoinLinkView::SharedPtr JoinLinkView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<JoinLinkView>();
+    auto view = makeShared<JoinLinkView>();
     view->mCode = xjson.getRequiredString("code");
     view->mRawEnabledStatus = xjson.getRequiredString("enabledStatus");
     view->mEnabledStatus = stringToLinkEnabledStatus(view->mRawEnabledStatus);
@@ -52,7 +52,7 @@ JoinLinkView::SharedPtr JoinLinkView::fromJson(const QJsonObject& json)
 JoinLinkViewerState::SharedPtr JoinLinkViewerState::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto state = std::make_shared<JoinLinkViewerState>();
+    auto state = makeShared<JoinLinkViewerState>();
     state->mRequestedAt = xjson.getOptionalDateTime("requestedAt");
     return state;
 }
@@ -60,7 +60,7 @@ JoinLinkViewerState::SharedPtr JoinLinkViewerState::fromJson(const QJsonObject&
 JoinLinkPreviewView::SharedPtr JoinLinkPreviewView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<JoinLinkPreviewView>();
+    auto view = makeShared<JoinLinkPreviewView>();
     view->mConvoId = xjson.getRequiredString("convoId");
     view->mCode = xjson.getRequiredString("code");
     view->mName = xjson.getRequiredString("name");
@@ -78,7 +78,7 @@ JoinLinkPreviewView::SharedPtr JoinLinkPreviewView::fromJson(const QJsonObject&
 DisabledJoinLinkPreviewView::SharedPtr DisabledJoinLinkPreviewView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<DisabledJoinLinkPreviewView>();
+    auto view = makeShared<DisabledJoinLinkPreviewView>();
     view->mCode = xjson.getRequiredString("code");
     return view;
 }
@@ -86,7 +86,7 @@ DisabledJoinLinkPreviewView::SharedPtr DisabledJoinLinkPreviewView::fromJson(con
 InvalidJoinLinkPreviewView::SharedPtr InvalidJoinLinkPreviewView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<InvalidJoinLinkPreviewView>();
+    auto view = makeShared<InvalidJoinLinkPreviewView>();
     view->mCode = xjson.getRequiredString("code");
     return view;
 }
@@ -94,7 +94,7 @@ InvalidJoinLinkPreviewView::SharedPtr InvalidJoinLinkPreviewView::fromJson(const
 JoinRequestView::SharedPtr JoinRequestView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<JoinRequestView>();
+    auto view = makeShared<JoinRequestView>();
     view->mConvoId = xjson.getRequiredString("convoId");
     view->mRequestedBy = xjson.getRequiredObject<ChatBskyActor::ProfileViewBasic>("requestedBy");
     view->mRequestedAt = xjson.getRequiredDateTime("requestedAt");
@@ -104,7 +104,7 @@ JoinRequestView::SharedPtr JoinRequestView::fromJson(const QJsonObject& json)
 JoinRequestConvoView::SharedPtr JoinRequestConvoView::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto view = std::make_shared<JoinRequestConvoView>();
+    auto view = makeShared<JoinRequestConvoView>();
     view->mConvoId = xjson.getRequiredString("convoId");
     view->mName = xjson.getRequiredString("name");
     view->mOwner = xjson.getRequiredObject<ChatBskyActor::ProfileViewBasic>("owner");
@@ -117,7 +117,7 @@ JoinRequestConvoView::SharedPtr JoinRequestConvoView::fromJson(const QJsonObject
 AddMembersOutput::SharedPtr AddMembersOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<AddMembersOutput>();
+    auto output = makeShared<AddMembersOutput>();
     output->mConvo = xjson.getRequiredObject<ChatBskyConvo::ConvoView>("convo");
     output->mAddedMebers = xjson.getOptionalVector<ChatBskyActor::ProfileViewBasic>("addedMembers");
     return output;
@@ -126,7 +126,7 @@ AddMembersOutput::SharedPtr AddMembersOutput::fromJson(const QJsonObject& json)
 JoinLinkOutput::SharedPtr JoinLinkOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<JoinLinkOutput>();
+    auto output = makeShared<JoinLinkOutput>();
     output->mJoinLink = xjson.getRequiredObject<JoinLinkView>("joinLink");
     return output;
 }
@@ -134,7 +134,7 @@ JoinLinkOutput::SharedPtr JoinLinkOutput::fromJson(const QJsonObject& json)
 JoinLinkPreviewsOutput::SharedPtr JoinLinkPreviewsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<JoinLinkPreviewsOutput>();
+    auto output = makeShared<JoinLinkPreviewsOutput>();
     output->mJoinLinkPreviews = xjson.getRequiredVariantList<
         ChatBskyGroup::JoinLinkPreviewView,
         ChatBskyGroup::DisabledJoinLinkPreviewView,
@@ -146,7 +146,7 @@ JoinLinkPreviewsOutput::SharedPtr JoinLinkPreviewsOutput::fromJson(const QJsonOb
 JoinRequestsOutput::SharedPtr JoinRequestsOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<JoinRequestsOutput>();
+    auto output = makeShared<JoinRequestsOutput>();
     output->mCursor = xjson.getOptionalString("cursor");
     output->mRequests = xjson.getRequiredVector<JoinRequestView>("requests");
     return output;
@@ -165,7 +165,7 @@ RequestJoinStatus stringToRequesJoinStatus(const QString& str)
 RequestJoinOutput::SharedPtr RequestJoinOutput::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto output = std::make_shared<RequestJoinOutput>();
+    auto output = makeShared<RequestJoinOutput>();
     output->mRawStatus = xjson.getRequiredString("status");
     output->mStatus = stringToRequesJoinStatus(output->mRawStatus);
     output->mConvo = xjson.getOptionalObject<ChatBskyConvo::ConvoView>("convo");
@@ -26,7 +26,7 @@ QJsonObject ChatPreference::toJson() const
 
 ChatPreference::SharedPtr ChatPreference::fromJson(const QJsonObject& json)
 {
-    auto pref = std::make_shared<ChatPreference>();
+    auto pref = makeShared<ChatPreference>();
     XJsonObject xjson(json);
     pref->mRawInclude = xjson.getRequiredString("include");
     pref->mInclude = stringToIncludeType(pref->mRawInclude);
@@ -46,7 +46,7 @@ QJsonObject Preferences::toJson() const
 
 Preferences::SharedPtr Preferences::fromJson(const QJsonObject& json)
 {
-    auto prefs = std::make_shared<Preferences>();
+    auto prefs = makeShared<Preferences>();
     XJsonObject xjson(json);
     prefs->mChat = xjson.getRequiredObject<ChatPreference>("chat");
     prefs->mChatRequest = xjson.getRequiredObject<ChatPreference>("chatRequest");
@@ -56,7 +56,7 @@ Preferences::SharedPtr Preferences::fromJson(const QJsonObject& json)
 
 GetPreferencesOutput::SharedPtr GetPreferencesOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<GetPreferencesOutput>();
+    auto output = makeShared<GetPreferencesOutput>();
     XJsonObject xjson(json);
     output->mPreferences = xjson.getRequiredObject<Preferences>("preferences");
     return output;
@@ -7,7 +7,7 @@ namespace ATProto::ComATProtoIdentity {
 
 ResolveHandleOutput::SharedPtr ResolveHandleOutput::fromJson(const QJsonObject& json)
 {
-    auto mention = std::make_shared<ResolveHandleOutput>();
+    auto mention = makeShared<ResolveHandleOutput>();
     const XJsonObject root(json);
     mention->mDid = root.getRequiredString("did");
     return mention;
@@ -22,8 +22,12 @@ QJsonObject Label::toJson() const
 
 Label::SharedPtr Label::fromJson(const QJsonObject& json)
 {
-    auto label = std::make_shared<Label>();
-    XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+Label::SharedPtr Label::fromJson(const XJsonObject& xjson)
+{
+    auto label = makeShared<Label>();
     label->mVersion = xjson.getOptionalInt("ver");
     label->mSrc = xjson.getRequiredString("src");
     label->mUri = xjson.getRequiredString("uri");
@@ -35,17 +39,20 @@ Label::SharedPtr Label::fromJson(const QJsonObject& json)
     return label;
 }
 
-void getLabels(Label::List& labels, const QJsonObject& json)
+void getLabels(Label::List& labels, const XJsonObject& xjson)
 {
-    XJsonObject xjson(json);
     labels = xjson.getOptionalVector<Label>("labels");
 }
 
 SelfLabel::SharedPtr SelfLabel::fromJson(const QJsonObject& json)
 {
-    auto label = std::make_shared<SelfLabel>();
-    XJsonObject xjson(json);
-    label->mJson = json;
+    return fromJson(XJsonObject(json));
+}
+
+SelfLabel::SharedPtr SelfLabel::fromJson(const XJsonObject& xjson)
+{
+    auto label = makeShared<SelfLabel>();
+    label->mJson = xjson.getUnknownFields({ "val" });
     label->mVal = xjson.getRequiredString("val");
     return label;
 }
@@ -59,9 +66,13 @@ QJsonObject SelfLabel::toJson() const
 
 SelfLabels::SharedPtr SelfLabels::fromJson(const QJsonObject& json)
 {
-    auto labels = std::make_shared<SelfLabels>();
-    XJsonObject xjson(json);
-    labels->mJson = json;
+    return fromJson(XJsonObject(json));
+}
+
+SelfLabels::SharedPtr SelfLabels::fromJson(const XJsonObject& xjson)
+{
+    auto labels = makeShared<SelfLabels>();
+    labels->mJson = xjson.getUnknownFields({ "$type", "values" });
     labels->mValues = xjson.getRequiredVector<SelfLabel>("values");
     return labels;
 }
@@ -76,7 +87,7 @@ QJsonObject SelfLabels::toJson() const
 
 LabelValueDefinitionStrings::SharedPtr LabelValueDefinitionStrings::fromJson(const QJsonObject& json)
 {
-    auto defStrings = std::make_shared<LabelValueDefinitionStrings>();
+    auto defStrings = makeShared<LabelValueDefinitionStrings>();
     XJsonObject xjson(json);
     defStrings->mLang = xjson.getRequiredString("lang");
     defStrings->mName = xjson.getRequiredString("name");
@@ -136,7 +147,7 @@ LabelValueDefinition::Setting LabelValueDefinition::stringToSetting(const QStrin
 
 LabelValueDefinition::SharedPtr LabelValueDefinition::fromJson(const QJsonObject& json)
 {
-    auto def = std::make_shared<LabelValueDefinition>();
+    auto def = makeShared<LabelValueDefinition>();
     XJsonObject xjson(json);
     def->mIdentifier = xjson.getRequiredString("identifier");
     def->mRawSeverity = xjson.getRequiredString("severity");
@@ -4,6 +4,10 @@
 #include <QJsonObject>
 #include <QtQmlIntegration>
 
+namespace ATProto {
+class XJsonObject;
+}
+
 namespace ATProto::ComATProtoLabel {
 
 // com.atproto.label.defs#label
@@ -23,9 +27,10 @@ struct Label
     using SharedPtr = std::shared_ptr<Label>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
-void getLabels(Label::List& labels, const QJsonObject& json);
+void getLabels(Label::List& labels, const XJsonObject& xjson);
 
 // com.atproto.label.defs#selfLabel
 struct SelfLabel
@@ -38,6 +43,7 @@ struct SelfLabel
     using SharedPtr = std::shared_ptr<SelfLabel>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // com.atproto.label.defs#selfLabels
@@ -50,6 +56,7 @@ struct SelfLabels
 
     using SharedPtr = std::shared_ptr<SelfLabels>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // com.atproto.label.defs#labelValueDefinitionStrings
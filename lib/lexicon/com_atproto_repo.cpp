@@ -16,8 +16,12 @@ QJsonObject StrongRef::toJson() const
 
 StrongRef::SharedPtr StrongRef::fromJson(const QJsonObject& json)
 {
-    auto strongRef = std::make_shared<StrongRef>();
-    const XJsonObject xjson(json);
+    return fromJson(XJsonObject(json));
+}
+
+StrongRef::SharedPtr StrongRef::fromJson(const XJsonObject& xjson)
+{
+    auto strongRef = makeShared<StrongRef>();
     strongRef->mUri = xjson.getRequiredString("uri");
     strongRef->mCid = xjson.getRequiredString("cid");
     return strongRef;
@@ -25,7 +29,7 @@ StrongRef::SharedPtr StrongRef::fromJson(const QJsonObject& json)
 
 UploadBlobOutput::SharedPtr UploadBlobOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<UploadBlobOutput>();
+    auto output = makeShared<UploadBlobOutput>();
     const XJsonObject xjson(json);
     output->mBlob = xjson.getRequiredObject<Blob>("blob");
     return output;
@@ -33,7 +37,7 @@ UploadBlobOutput::SharedPtr UploadBlobOutput::fromJson(const QJsonObject& json)
 
 Record::SharedPtr Record::fromJson(const QJsonObject& json)
 {
-    auto record = std::make_shared<Record>();
+    auto record = makeShared<Record>();
     const XJsonObject xjson(json);
     record->mUri = xjson.getRequiredString("uri");
     record->mCid = xjson.getOptionalString("cid");
@@ -43,20 +47,28 @@ Record::SharedPtr Record::fromJson(const QJsonObject& json)
 
 ListRecordsOutput::SharedPtr ListRecordsOutput::fromJson(const QJsonObject& json)
 {
-    auto output = std::make_shared<ListRecordsOutput>();
+    auto output = makeShared<ListRecordsOutput>();
     const XJsonObject xjson(json);
     output->mCursor = xjson.getOptionalString("cursor");
     output->mRecords = xjson.getRequiredVector<Record>("records");
     return output;
 }
 
+void RecordValue::writeJson(JsonWriter& writer) const
+{
+    if (mWriteJson)
+        mWriteJson(writer);
+    else
+        writer.value(mJson);
+}
+
 QJsonObject ApplyWritesCreate::toJson() const
 {
     QJsonObject json;
     json.insert("$type", "com.atproto.repo.applyWrites#create");
     json.insert("collection", mCollection);
     XJsonObject::insertOptionalJsonValue(json, "rkey", mRKey);
-    json.insert("value", mValue);
+    json.insert("value", mValue.toJson());
     return json;
 }
 
@@ -66,7 +78,7 @@ QJsonObject ApplyWritesUpdate::toJson() const
     json.insert("$type", "com.atproto.repo.applyWrites#update");
     json.insert("collection", mCollection);
     json.insert("rkey", mRKey);
-    json.insert("value", mValue);
+    json.insert("value", mValue.toJson());
     return json;
 }
 
@@ -79,4 +91,38 @@ QJsonObject ApplyWritesDelete::toJson() const
     return json;
 }
 
+void ApplyWritesCreate::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string("com.atproto.repo.applyWrites#create");
+    writer.key("collection").string(mCollection);
+
+    if (mRKey)
+        writer.key("rkey").string(*mRKey);
+
+    writer.key("value");
+    mValue.writeJson(writer);
+    writer.endObject();
+}
+
+void ApplyWritesUpdate::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string("com.atproto.repo.applyWrites#update");
+    writer.key("collection").string(mCollection);
+    writer.key("rkey").string(mRKey);
+    writer.key("value");
+    mValue.writeJson(writer);
+    writer.endObject();
+}
+
+void ApplyWritesDelete::writeJson(JsonWriter& writer) const
+{
+    writer.beginObject();
+    writer.key("$type").string("com.atproto.repo.applyWrites#delete");
+    writer.key("collection").string(mCollection);
+    writer.key("rkey").string(mRKey);
+    writer.endObject();
+}
+
 }
@@ -4,6 +4,7 @@
 #include "lexicon.h"
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <functional>
 
 namespace ATProto::ComATProtoRepo {
 
@@ -18,6 +19,7 @@ struct StrongRef
     using SharedPtr = std::shared_ptr<StrongRef>;
     using List = std::vector<SharedPtr>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 // com.atproto.repo.uploadBlob#output
@@ -51,14 +53,38 @@ struct ListRecordsOutput
     static SharedPtr fromJson(const QJsonObject& json);
 };
 
+// Record to write to a repo. A lexicon record is written into the request body
+// with its writeJson(), a JSON object is written as is.
+class RecordValue
+{
+public:
+    RecordValue() = default;
+    RecordValue(const QJsonObject& json) : mJson(json) {}
+
+    template<class RecordType>
+    RecordValue(std::shared_ptr<RecordType> record) :
+        mWriteJson([record](JsonWriter& writer){ writer.object(*record); }),
+        mToJson([record]{ return record->toJson(); })
+    {}
+
+    QJsonObject toJson() const { return mToJson ? mToJson() : mJson; }
+    void writeJson(JsonWriter& writer) const;
+
+private:
+    QJsonObject mJson;
+    std::function<void(JsonWriter&)> mWriteJson;
+    std::function<QJsonObject()> mToJson;
+};
+
 // com.atproto.repo.applyWrites#create
 struct ApplyWritesCreate
 {
     QString mCollection;
     std::optional<QString> mRKey;
-    QJsonObject mValue;
+    RecordValue mValue;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ApplyWritesCreate>;
 };
@@ -68,9 +94,10 @@ struct ApplyWritesUpdate
 {
     QString mCollection;
     QString mRKey;
-    QJsonObject mValue;
+    RecordValue mValue;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ApplyWritesUpdate>;
 };
@@ -82,6 +109,7 @@ struct ApplyWritesDelete
     QString mRKey;
 
     QJsonObject toJson() const;
+    void writeJson(JsonWriter& writer) const;
 
     using SharedPtr = std::shared_ptr<ApplyWritesDelete>;
 };
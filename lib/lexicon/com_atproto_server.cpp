@@ -8,7 +8,7 @@ namespace ATProto::ComATProtoServer {
 Session::SharedPtr Session::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto session = std::make_shared<Session>();
+    auto session = makeShared<Session>();
     session->mHandle = xjson.getRequiredString("handle");
     session->mDid = xjson.getRequiredString("did");
     session->mAccessJwt = xjson.getRequiredString("accessJwt");
@@ -29,7 +29,7 @@ std::optional<QString> Session::getPDS() const
 GetSessionOutput::SharedPtr GetSessionOutput::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto session = std::make_shared<GetSessionOutput>();
+    auto session = makeShared<GetSessionOutput>();
     session->mHandle = xjson.getRequiredString("handle");
     session->mDid = xjson.getRequiredString("did");
     session->mEmail = xjson.getOptionalString("email");
@@ -43,7 +43,7 @@ GetSessionOutput::SharedPtr GetSessionOutput::fromJson(const QJsonObject& json)
 InviteCodeUse::SharedPtr InviteCodeUse::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto inviteCodeUse = std::make_shared<InviteCodeUse>();
+    auto inviteCodeUse = makeShared<InviteCodeUse>();
     inviteCodeUse->mUsedBy = xjson.getRequiredString("usedBy");
     inviteCodeUse->mUsedAt = xjson.getRequiredDateTime("usedAt");
     return inviteCodeUse;
@@ -52,7 +52,7 @@ InviteCodeUse::SharedPtr InviteCodeUse::fromJson(const QJsonObject& json)
 InviteCode::SharedPtr InviteCode::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto inviteCode = std::make_shared<InviteCode>();
+    auto inviteCode = makeShared<InviteCode>();
     inviteCode->mCode = xjson.getRequiredString("code");
     inviteCode->mAvailable = xjson.getRequiredInt("available");
     inviteCode->mDisabled = xjson.getRequiredBool("disabled");
@@ -66,7 +66,7 @@ InviteCode::SharedPtr InviteCode::fromJson(const QJsonObject& json)
 GetAccountInviteCodesOutput::SharedPtr GetAccountInviteCodesOutput::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto output = std::make_shared<GetAccountInviteCodesOutput>();
+    auto output = makeShared<GetAccountInviteCodesOutput>();
     output->mCodes = xjson.getRequiredVector<InviteCode>("codes");
     return output;
 }
@@ -74,7 +74,7 @@ GetAccountInviteCodesOutput::SharedPtr GetAccountInviteCodesOutput::fromJson(con
 GetServiceAuthOutput::SharedPtr GetServiceAuthOutput::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto output = std::make_shared<GetServiceAuthOutput>();
+    auto output = makeShared<GetServiceAuthOutput>();
     output->mToken = xjson.getRequiredString("token");
     return output;
 }
@@ -82,7 +82,7 @@ GetServiceAuthOutput::SharedPtr GetServiceAuthOutput::fromJson(const QJsonObject
 RequestEmailUpdateOutput::SharedPtr RequestEmailUpdateOutput::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto output = std::make_shared<RequestEmailUpdateOutput>();
+    auto output = makeShared<RequestEmailUpdateOutput>();
     output->mTokenRequired = xjson.getRequiredBool("tokenRequired");
     return output;
 }
@@ -6,9 +6,27 @@
 #include "app_bsky_labeler.h"
 #include "../xjson.h"
 #include <unordered_map>
+#include <utility>
 
 namespace ATProto {
 
+static thread_local bool sLazyDecode = false;
+
+LazyDecodeScope::LazyDecodeScope(bool enable) :
+    mPrevious(std::exchange(sLazyDecode, enable))
+{
+}
+
+LazyDecodeScope::~LazyDecodeScope()
+{
+    sLazyDecode = mPrevious;
+}
+
+bool LazyDecodeScope::isActive()
+{
+    return sLazyDecode;
+}
+
 QJsonObject UnknownVariant::toJson() const
 {
     return mJson;
@@ -16,7 +34,7 @@ QJsonObject UnknownVariant::toJson() const
 
 UnknownVariant::SharedPtr UnknownVariant::fromJson(const QJsonObject& json)
 {
-    auto unknown = std::make_shared<UnknownVariant>();
+    auto unknown = makeShared<UnknownVariant>();
     XJsonObject xjson(json);
     unknown->mType = xjson.getRequiredString("$type");
     unknown->mJson = json;
@@ -25,7 +43,7 @@ UnknownVariant::SharedPtr UnknownVariant::fromJson(const QJsonObject& json)
 
 ATProtoError::SharedPtr ATProtoError::fromJson(const QJsonDocument& json)
 {
-    auto error = std::make_shared<ATProtoError>();
+    auto error = makeShared<ATProtoError>();
     const auto jsonObj = json.object();
     const XJsonObject xjson(jsonObj);
     error->mError = xjson.getRequiredString("error");
@@ -36,14 +54,17 @@ ATProtoError::SharedPtr ATProtoError::fromJson(const QJsonDocument& json)
 
 Blob::SharedPtr Blob::fromJson(const QJsonObject& json)
 {
-    auto blob = std::make_shared<Blob>();
-    const XJsonObject xjson(json);
-    blob->mJson = json;
-    
-    const auto refJson = xjson.getOptionalJsonObject("ref");
-    if (refJson)
+    return fromJson(XJsonObject(json));
+}
+
+Blob::SharedPtr Blob::fromJson(const XJsonObject& xjson)
+{
+    auto blob = makeShared<Blob>();
+    blob->mJson = xjson.getUnknownFields({ "$type", "ref", "mimeType", "size" });
+
+    if (xjson.has("ref"))
     {
-        const XJsonObject xRefJson(*refJson);
+        const XJsonObject xRefJson(xjson.getField("ref", QJsonValue::Object));
         blob->mRefLink = xRefJson.getRequiredString("$link");
         blob->mSize = xjson.getRequiredInt("size");
     }
@@ -72,7 +93,7 @@ QJsonObject Blob::toJson() const
 DidDocument::SharedPtr DidDocument::fromJson(const QJsonObject& json)
 {
     const XJsonObject xjson(json);
-    auto didDoc = std::make_shared<DidDocument>();
+    auto didDoc = makeShared<DidDocument>();
     const auto services = xjson.getOptionalArray("service");
 
     if (services)
@@ -1,6 +1,8 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #pragma once
+#include "arena.h"
+#include "json_writer.h"
 #include "qml_utils.h"
 #include <QException>
 #include <QJsonDocument>
@@ -9,6 +11,8 @@
 
 namespace ATProto {
 
+class XJsonObject;
+
 // Variant types in the lexicon are like this variant<T:Ptr, U:Ptr, ...>
 // The default constructor constructs a variant with the first alternative set
 // to its default value, i.e. nullptr
@@ -49,6 +53,23 @@ struct UnknownVariant
     static constexpr char const* TYPE = "";
 };
 
+// While a scope is active on the thread, lexicon types supporting lazy decoding
+// keep parts of their JSON undecoded till first access, e.g. PostView.
+// Scopes can be nested.
+class LazyDecodeScope
+{
+public:
+    explicit LazyDecodeScope(bool enable);
+    ~LazyDecodeScope();
+    LazyDecodeScope(const LazyDecodeScope&) = delete;
+    LazyDecodeScope& operator=(const LazyDecodeScope&) = delete;
+
+    static bool isActive();
+
+private:
+    bool mPrevious;
+};
+
 class InvalidContent : public QException
 {
 public:
@@ -83,6 +104,7 @@ public:
 
     // Internal stack errors
     SHARED_CONST(QString, DPOP_NONCE_MISSING, QStringLiteral("DpopNonceMissing"));
+    SHARED_CONST(QString, DPOP_PROOF_FAILED, QStringLiteral("DpopProofFailed"));
     SHARED_CONST(QString, PDS_NOT_FOUND, QStringLiteral("PdsNotFound"));
     SHARED_CONST(QString, XRPC_TIMEOUT, QStringLiteral("XrpcTimeout"));
 
@@ -153,6 +175,7 @@ struct Blob {
 
     using SharedPtr = std::shared_ptr<Blob>;
     static SharedPtr fromJson(const QJsonObject& json);
+    static SharedPtr fromJson(const XJsonObject& xjson);
 };
 
 struct DidDocument {
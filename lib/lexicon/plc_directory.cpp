@@ -8,7 +8,7 @@ namespace ATProto {
 PlcError::SharedPtr PlcError::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto error = std::make_shared<PlcError>();
+    auto error = makeShared<PlcError>();
     error->mMessage = xjson.getOptionalString("message");
     return error;
 }
@@ -16,7 +16,7 @@ PlcError::SharedPtr PlcError::fromJson(const QJsonObject& json)
 PlcAuditLogEntry::SharedPtr PlcAuditLogEntry::fromJson(const QJsonObject& json)
 {
     XJsonObject xjson(json);
-    auto entry = std::make_shared<PlcAuditLogEntry>();
+    auto entry = makeShared<PlcAuditLogEntry>();
     entry->mDid = xjson.getRequiredString("did");
     entry->mCreatedAt = xjson.getRequiredDateTime("createdAt");
     return entry;
@@ -28,7 +28,7 @@ PlcAuditLog::SharedPtr PlcAuditLog::fromJson(const QJsonDocument& json)
         throw InvalidJsonException("PLC Audit Log must be an array");
 
     const QJsonArray jsonArray = json.array();
-    auto log = std::make_shared<PlcAuditLog>();
+    auto log = makeShared<PlcAuditLog>();
 
     for (const auto& jsonElem : jsonArray)
     {
@@ -2,8 +2,10 @@
 // License: GPLv3
 #pragma once
 #include "presence.h"
+#include "rate_limiter.h"
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QTimer>
 
 namespace ATProto {
 
@@ -21,6 +23,9 @@ public:
 
     void setUserAgent(const QString& userAgent) { mUserAgent = userAgent; }
 
+    // Thread safe
+    QHash<QString, RateLimiter::BucketState> getRateLimitStates() const { return mRateLimiter.getStates(); }
+
 protected:
     static constexpr int MAX_RESEND = 2;
 
@@ -64,6 +69,20 @@ protected:
     }
 
     virtual void sendRequest(const RequestType& request, const RequestSuccessCb& successCb, const RequestErrorCb& errorCb)
+    {
+        const auto delay = mRateLimiter.acquire(request.mNetworkRequest.url());
+
+        if (delay.count() > 0)
+        {
+            qDebug() << "Rate limit, delay request:" << request.mNetworkRequest.url() << "delay:" << delay.count() << "ms";
+            QTimer::singleShot(delay, this, [this, request, successCb, errorCb]{ sendRequestNow(request, successCb, errorCb); });
+            return;
+        }
+
+        sendRequestNow(request, successCb, errorCb);
+    }
+
+    void sendRequestNow(const RequestType& request, const RequestSuccessCb& successCb, const RequestErrorCb& errorCb)
     {
         QNetworkReply* reply;
 
@@ -76,14 +95,22 @@ protected:
         // The latter call is not guaranteed however. We must only call errorCb once!
         auto errorHandled = std::make_shared<bool>(false);
 
+        // Connected first, such that the rate limits are updated before a resend.
+        connect(reply, &QNetworkReply::metaDataChanged, this,
+                [this, url=request.mNetworkRequest.url(), reply]{ mRateLimiter.update(url, RateLimitHeaders::fromReply(*reply)); });
         connect(reply, &QNetworkReply::finished, this,
                 [this, request, reply, successCb, errorCb, errorHandled]{ replyFinished(request, reply, successCb, errorCb, errorHandled); });
         connect(reply, &QNetworkReply::errorOccurred, this,
                 [this, request, reply, successCb, errorCb, errorHandled](auto errorCode){ this->networkError(request, reply, errorCode, successCb, errorCb, errorHandled); });
         connect(reply, &QNetworkReply::sslErrors, this,
                 [this, reply, errorCb, errorHandled](const QList<QSslError>& errors){ sslErrors(reply, errors, errorCb, errorHandled); });
+
+        requestSent(request, reply);
     }
 
+    // Called for each reply sent, including resends.
+    virtual void requestSent(const RequestType&, QNetworkReply*) {}
+
     bool mustResend(QNetworkReply::NetworkError error) const
     {
         switch (error)
@@ -103,6 +130,19 @@ protected:
         return false;
     }
 
+    bool mustResend(const QNetworkReply* reply, QNetworkReply::NetworkError error) const
+    {
+        return RateLimiter::isRateLimited(reply) || mustResend(error);
+    }
+
+    // Resend after a backoff delay
+    void sendRequestDelayed(int resendCount, const RequestType& request, const RequestSuccessCb& successCb, const RequestErrorCb& errorCb)
+    {
+        const auto delay = RateLimiter::backoffDelay(resendCount);
+        qDebug() << "Resend:" << request.mNetworkRequest.url() << "count:" << resendCount << "delay:" << delay.count() << "ms";
+        QTimer::singleShot(delay, this, [this, request, successCb, errorCb]{ sendRequest(request, successCb, errorCb); });
+    }
+
     virtual bool resendRequest(RequestType request, const RequestSuccessCb& successCb, const RequestErrorCb& errorCb)
     {
         if (request.mResendCount >= MAX_RESEND)
@@ -112,8 +152,7 @@ protected:
         }
 
         ++request.mResendCount;
-        qDebug() << "Resend:" << request.mNetworkRequest.url() << "count:" << request.mResendCount;
-        sendRequest(request, successCb, errorCb);
+        sendRequestDelayed(request.mResendCount, request, successCb, errorCb);
         return true;
     }
 
@@ -125,6 +164,7 @@ protected:
 
     QNetworkAccessManager* mNetwork;
     QString mUserAgent;
+    RateLimiter mRateLimiter;
 };
 
 }
@@ -159,7 +159,7 @@ void OAuth::handleProtectedResourceResponse(QNetworkReply* reply, const SuccessC
         const QString& error = reply->errorString();
         qWarning() << "Failed to get:" << reply->url() << "code:" <<  reply->error() << "error:" << error;
 
-        if (mustResend(reply->error()))
+        if (mustResend(reply, reply->error()))
         {
             if (resendCount >= MAX_RESEND)
             {
@@ -168,7 +168,8 @@ void OAuth::handleProtectedResourceResponse(QNetworkReply* reply, const SuccessC
                 return;
             }
 
-            getProtectedResourceRequest(successCb, errorCb, resendCount + 1);
+            QTimer::singleShot(RateLimiter::backoffDelay(resendCount + 1), this,
+                [this, successCb, errorCb, resendCount]{ getProtectedResourceRequest(successCb, errorCb, resendCount + 1); });
             return;
         }
 
@@ -252,7 +253,7 @@ void OAuth::handleAuthorizatonServerResponse(QNetworkReply* reply, const Success
         const QString& error = reply->errorString();
         qWarning() << "Failed to get:" << reply->url() << "code:" <<  reply->error() << "error:" << error;
 
-        if (mustResend(reply->error()))
+        if (mustResend(reply, reply->error()))
         {
             if (resendCount >= MAX_RESEND)
             {
@@ -261,7 +262,8 @@ void OAuth::handleAuthorizatonServerResponse(QNetworkReply* reply, const Success
                 return;
             }
 
-            getAuthorizationServerRequest(successCb, errorCb, resendCount + 1);
+            QTimer::singleShot(RateLimiter::backoffDelay(resendCount + 1), this,
+                [this, successCb, errorCb, resendCount]{ getAuthorizationServerRequest(successCb, errorCb, resendCount + 1); });
             return;
         }
 
@@ -464,7 +466,7 @@ void OAuth::replyFinished(const OAuthRequest& request, QNetworkReply* reply,
         *errorHandled = true;
         const auto data = reply->readAll();
 
-        if (mustResend(errorCode))
+        if (mustResend(reply, errorCode))
         {
             if (resendRequest(request, successCb, errorCb))
                 return;
@@ -508,7 +510,7 @@ void OAuth::networkError(const OAuthRequest& request, QNetworkReply* reply, QNet
         if (errorCode == QNetworkReply::OperationCanceledError)
             reply->disconnect();
 
-        if (mustResend(errorCode))
+        if (mustResend(reply, errorCode))
         {
             qDebug() << "Try resend on error:" << errorCode << errorMsg;
 
@@ -812,15 +814,15 @@ bool OAuth::resendRequest(OAuthRequest request, const AuthServerSuccessCb& succe
     }
 
     ++request.mResendCount;
-    qDebug() << "Resend:" << requestUrl << "count:" << request.mResendCount;
 
     if (request.mNetworkRequest.hasRawHeader("DPoP"))
     {
         // A new DPoP proof must be created, otherwise the resend will be seen as DPoP proof replay
         const QString dpopProof = mDpopPrivateJwk->buildAuthDPoPProof("POST", requestUrl, mDpopNonce);
+        request.mNetworkRequest.setRawHeader("DPoP", dpopProof.toUtf8());
     }
 
-    sendRequest(request, successCb, errorCb);
+    sendRequestDelayed(request.mResendCount, request, successCb, errorCb);
     return true;
 }
 
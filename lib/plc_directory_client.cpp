@@ -3,7 +3,10 @@
 #include "plc_directory_client.h"
 #include "at_regex.h"
 #include "lexicon.h"
+#include <QElapsedTimer>
 #include <QJsonObject>
+#include <QTimer>
+#include <algorithm>
 
 namespace ATProto {
 
@@ -20,6 +23,29 @@ static QString normalizeHost(const QString& host)
     return normalized;
 }
 
+static constexpr int HTTP_TOO_MANY_REQUESTS = 429;
+static constexpr int HTTP_INTERNAL_SERVER_ERROR = 500;
+
+// Network errors, server errors and rate limiting. An error reply like 404 is an
+// answer of the host.
+static bool isHostFailure(int errorCode, int httpStatus)
+{
+    if (httpStatus == HTTP_TOO_MANY_REQUESTS || httpStatus >= HTTP_INTERNAL_SERVER_ERROR)
+        return true;
+
+    return errorCode < QNetworkReply::ContentAccessDenied || errorCode >= QNetworkReply::InternalServerError;
+}
+
+// Returns true if the reply belongs to an aborted request.
+static bool trackReply(const PlcRequest& request, const QNetworkReply* reply)
+{
+    if (!request.mTracker)
+        return false;
+
+    request.mTracker->mHttpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    return request.mTracker->mAborted;
+}
+
 PlcDirectoryClient::PlcDirectoryClient(QNetworkAccessManager* network,
                                        const QString& primaryHost,
                                        const QString& secondaryHost,
@@ -32,10 +58,10 @@ PlcDirectoryClient::PlcDirectoryClient(QNetworkAccessManager* network,
     Q_ASSERT(mNetwork->autoDeleteReplies());
     Q_ASSERT(!primaryHost.isEmpty());
 
-    mHosts.push_back(primaryHost);
+    mHosts.push_back({ primaryHost, HostHealth{} });
 
     if (!secondaryHost.isEmpty())
-        mHosts.push_back(secondaryHost);
+        mHosts.push_back({ secondaryHost, HostHealth{} });
 }
 
 void PlcDirectoryClient::getPds(const QString& did, const PdsSuccessCb& successCb, const ErrorCb& errorCb)
@@ -51,28 +77,25 @@ void PlcDirectoryClient::getPds(const QString& did, const PdsSuccessCb& successC
         return;
     }
 
-    if (!getPdsContinue(did, successCb, errorCb))
+    if (ATRegex::isWebDid(did))
     {
-        if (errorCb)
-            errorCb(404, "Cannot resolve PDS");
+        if (!getPdsForWebDid(did, successCb, errorCb))
+        {
+            if (errorCb)
+                errorCb(404, "Cannot resolve PDS");
+        }
 
         return;
     }
-}
-
-bool PlcDirectoryClient::getPdsContinue(const QString& did, const PdsSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex)
-{
-    if (ATRegex::isWebDid(did))
-        return getPdsForWebDid(did, successCb, errorCb);
-
-    if (hostIndex < 0 || hostIndex >= (int)mHosts.size())
-        return false;
 
-    const QString& host = mHosts[hostIndex];
-    QUrl url(QString("https://%1/%2").arg(host, did));
-    getPdsRequest(did, url, successCb, errorCb, hostIndex);
+    hedgedGet(did,
+        [this, presence=getPresence(), did, successCb, errorCb](const QJsonDocument& reply) {
+            if (!presence)
+                return;
 
-    return true;
+            setPdsFromDidDocument(did, reply, successCb, errorCb);
+        },
+        errorCb);
 }
 
 bool PlcDirectoryClient::getPdsForWebDid(const QString& did, const PdsSuccessCb& successCb, const ErrorCb& errorCb)
@@ -92,7 +115,7 @@ bool PlcDirectoryClient::getPdsForWebDid(const QString& did, const PdsSuccessCb&
     return true;
 }
 
-void PlcDirectoryClient::getPdsRequest(const QString& did, const QUrl& url, const PdsSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex)
+void PlcDirectoryClient::getPdsRequest(const QString& did, const QUrl& url, const PdsSuccessCb& successCb, const ErrorCb& errorCb)
 {
     Request request;
     request.mNetworkRequest = QNetworkRequest(url);
@@ -105,99 +128,219 @@ void PlcDirectoryClient::getPdsRequest(const QString& did, const QUrl& url, cons
             if (!presence)
                 return;
 
-            qDebug() << "getPds:" << reply;
-            try {
-                auto didDoc = DidDocument::fromJson(reply.object());
+            setPdsFromDidDocument(did, reply, successCb, errorCb);
+        },
+        [errorCb](int errorCode, const QString& errorMsg) {
+            qWarning() << errorCode << "-" << errorMsg;
 
-                if (!didDoc->mATProtoPDS)
-                {
-                    qWarning() << "Cannot resolve PDS for:" << did;
+            if (errorCb)
+                errorCb(errorCode, errorMsg);
+        });
+}
 
-                    if (errorCb)
-                        errorCb(404, "Cannot resolve PDS");
+void PlcDirectoryClient::setPdsFromDidDocument(const QString& did, const QJsonDocument& reply, const PdsSuccessCb& successCb, const ErrorCb& errorCb)
+{
+    qDebug() << "getPds:" << reply;
 
-                    return;
-                }
+    try {
+        auto didDoc = DidDocument::fromJson(reply.object());
 
-                const QString pds = normalizeHost(*didDoc->mATProtoPDS);
-                qDebug() << "Resolved PDS for:" << did << *didDoc->mATProtoPDS << "normalized:" << pds;
-                mPdsCache.insert(did, new QString(pds));
+        if (!didDoc->mATProtoPDS)
+        {
+            qWarning() << "Cannot resolve PDS for:" << did;
 
-                if (successCb)
-                    successCb(pds);
-            } catch (InvalidJsonException& e) {
-                invalidJsonError(e, errorCb);
-            }
-        },
-        [this, presence=getPresence(), did, successCb, errorCb, hostIndex](int errorCode, const QString& errorMsg) {
+            if (errorCb)
+                errorCb(404, "Cannot resolve PDS");
+
+            return;
+        }
+
+        const QString pds = normalizeHost(*didDoc->mATProtoPDS);
+        qDebug() << "Resolved PDS for:" << did << *didDoc->mATProtoPDS << "normalized:" << pds;
+        mPdsCache.insert(did, new QString(pds));
+
+        if (successCb)
+            successCb(pds);
+    } catch (InvalidJsonException& e) {
+        invalidJsonError(e, errorCb);
+    }
+}
+
+void PlcDirectoryClient::getAuditLog(const QString& did, const AuditLogSuccessCb& successCb, const ErrorCb& errorCb)
+{
+    if (ATRegex::isWebDid(did))
+    {
+        qDebug() << "No audit log for web DID:" << did;
+
+        if (errorCb)
+            errorCb(-1, "No audit log available for web DID");
+
+        return;
+    }
+
+    hedgedGet(did + "/log/audit",
+        [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply) {
             if (!presence)
                 return;
 
-            qWarning() << errorCode << "-" << errorMsg;
+            qDebug() << "getAuditLog:" << reply;
 
-            if (hostIndex >= 0 && getPdsContinue(did, successCb, errorCb, hostIndex + 1))
-                return;
+            try {
+                auto auditLog = PlcAuditLog::fromJson(reply);
 
-            if (errorCb)
-                errorCb(errorCode, errorMsg);
-        });
+                if (successCb)
+                    successCb(std::move(auditLog));
+            } catch (InvalidJsonException& e) {
+                invalidJsonError(e, errorCb);
+            }
+        },
+        errorCb);
 }
 
-void PlcDirectoryClient::getAuditLog(const QString& did, const AuditLogSuccessCb& successCb, const ErrorCb& errorCb)
+void PlcDirectoryClient::hedgedGet(const QString& path, const SuccessJsonCb& successCb, const ErrorCb& errorCb)
 {
-    getAuditLogContinue(did, successCb, errorCb);
+    auto lookup = std::make_shared<HedgedLookup>();
+    lookup->mPath = path;
+    lookup->mSuccessCb = successCb;
+    lookup->mErrorCb = errorCb;
+    lookup->mStates.resize(mHosts.size(), LookupState::NOT_SENT);
+    lookup->mTrackers.resize(mHosts.size());
+
+    if (!sendToNextHost(lookup))
+    {
+        qWarning() << "All PLC directory hosts are failing:" << path;
+
+        if (errorCb)
+            errorCb(QNetworkReply::ServiceUnavailableError, "PLC directory unavailable");
+    }
 }
 
-bool PlcDirectoryClient::getAuditLogContinue(const QString& did, const AuditLogSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex)
+bool PlcDirectoryClient::sendToNextHost(const std::shared_ptr<HedgedLookup>& lookup)
 {
-    if (ATRegex::isWebDid(did))
+    for (int i = 0; i < (int)mHosts.size(); ++i)
     {
-        qDebug() << "No first appearance for web DID:" << did;
-        return false;
+        if (lookup->mStates[i] != LookupState::NOT_SENT)
+            continue;
+
+        if (!mHosts[i].mHealth.allowRequest())
+        {
+            qDebug() << "Circuit open, skip:" << mHosts[i].mName;
+            continue;
+        }
+
+        sendToHost(lookup, i);
+        return true;
     }
 
-    if (hostIndex < 0 || hostIndex >= (int)mHosts.size())
-        return false;
+    return false;
+}
 
-    const QString& host = mHosts[hostIndex];
+void PlcDirectoryClient::sendToHost(const std::shared_ptr<HedgedLookup>& lookup, int hostIndex)
+{
+    auto& host = mHosts[hostIndex];
+    lookup->mStates[hostIndex] = LookupState::IN_FLIGHT;
 
     Request request;
-    QUrl url(QString("https://%1/%2/log/audit").arg(host, did));
+    QUrl url(QString("https://%1/%2").arg(host.mName, lookup->mPath));
     request.mNetworkRequest = QNetworkRequest(url);
+    request.mTracker = std::make_shared<Request::Tracker>();
+    lookup->mTrackers[hostIndex] = request.mTracker;
     setUserAgentHeader(request.mNetworkRequest);
 
     qDebug() << "Send:" << url;
+    QElapsedTimer timer;
+    timer.start();
 
     sendRequest(request,
-        [this, presence=getPresence(), successCb, errorCb](const QJsonDocument& reply) {
+        [this, presence=getPresence(), lookup, hostIndex, timer](const QJsonDocument& reply) {
             if (!presence)
                 return;
 
-            qDebug() << "getAuditLog:" << reply;
-
-            try {
-                auto auditLog = PlcAuditLog::fromJson(reply);
+            lookup->mStates[hostIndex] = LookupState::FINISHED;
+            mHosts[hostIndex].mHealth.recordResponse(std::chrono::milliseconds(timer.elapsed()));
 
-                if (successCb)
-                    successCb(std::move(auditLog));
-            } catch (InvalidJsonException& e) {
-                invalidJsonError(e, errorCb);
+            if (lookup->mDone)
+            {
+                qDebug() << "Lost hedged lookup:" << mHosts[hostIndex].mName << lookup->mPath;
+                return;
             }
+
+            lookup->mDone = true;
+            abortLosers(lookup);
+
+            if (lookup->mSuccessCb)
+                lookup->mSuccessCb(reply);
         },
-        [this, presence=getPresence(), did, successCb, errorCb, hostIndex](int errorCode, const QString& errorMsg) {
+        [this, presence=getPresence(), lookup, hostIndex, timer](int errorCode, const QString& errorMsg) {
             if (!presence)
                 return;
 
-            qDebug() << errorCode << "-" << errorMsg;
+            qWarning() << mHosts[hostIndex].mName << errorCode << "-" << errorMsg;
+            lookup->mStates[hostIndex] = LookupState::FINISHED;
+            auto& health = mHosts[hostIndex].mHealth;
 
-            if (getAuditLogContinue(did, successCb, errorCb, hostIndex + 1))
+            if (isHostFailure(errorCode, lookup->mTrackers[hostIndex]->mHttpStatus))
+                health.recordFailure();
+            else
+                health.recordResponse(std::chrono::milliseconds(timer.elapsed()));
+
+            if (lookup->mDone)
                 return;
 
-            if (errorCb)
-                errorCb(errorCode, errorMsg);
+            // The next host may have the DID, e.g. when a mirror lags behind.
+            if (sendToNextHost(lookup))
+                return;
+
+            // Wait for the hedged request
+            if (std::ranges::find(lookup->mStates, LookupState::IN_FLIGHT) != lookup->mStates.end())
+                return;
+
+            lookup->mDone = true;
+
+            if (lookup->mErrorCb)
+                lookup->mErrorCb(errorCode, errorMsg);
         });
 
-    return true;
+    const auto hedgeDelay = host.mHealth.getHedgeDelay();
+
+    QTimer::singleShot(hedgeDelay, this, [this, lookup, hostIndex, hedgeDelay]{
+        if (lookup->mDone || lookup->mStates[hostIndex] != LookupState::IN_FLIGHT)
+            return;
+
+        if (sendToNextHost(lookup))
+            qDebug() << "Hedge lookup after:" << hedgeDelay.count() << "ms" << lookup->mPath;
+    });
+}
+
+void PlcDirectoryClient::abortLosers(const std::shared_ptr<HedgedLookup>& lookup)
+{
+    for (int i = 0; i < (int)mHosts.size(); ++i)
+    {
+        if (lookup->mStates[i] != LookupState::IN_FLIGHT)
+            continue;
+
+        qDebug() << "Abort hedged lookup:" << mHosts[i].mName << lookup->mPath;
+        lookup->mStates[i] = LookupState::FINISHED;
+        mHosts[i].mHealth.recordAbort();
+        auto& tracker = *lookup->mTrackers[i];
+        tracker.mAborted = true;
+
+        // A resend that is not sent yet gets aborted when it is sent.
+        if (tracker.mReply && !tracker.mReply->isFinished())
+            tracker.mReply->abort();
+    }
+}
+
+void PlcDirectoryClient::requestSent(const Request& request, QNetworkReply* reply)
+{
+    if (!request.mTracker)
+        return;
+
+    request.mTracker->mReply = reply;
+
+    // A resend after the lookup was answered by another host.
+    if (request.mTracker->mAborted)
+        reply->abort();
 }
 
 void PlcDirectoryClient::getFirstAppearance(const QString& did, const FirstAppearanceSuccessCb& successCb, const ErrorCb& errorCb)
@@ -261,6 +404,14 @@ void PlcDirectoryClient::replyFinished(const Request& request, QNetworkReply* re
                                        std::shared_ptr<bool> errorHandled)
 {
     Q_ASSERT(reply);
+
+    if (trackReply(request, reply))
+    {
+        qDebug() << "Aborted:" << reply->url();
+        *errorHandled = true;
+        return;
+    }
+
     const auto errorCode = reply->error();
     const QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString().trimmed();
     qDebug() << "Reply:" << errorCode << "content:" << contentType;
@@ -275,7 +426,7 @@ void PlcDirectoryClient::replyFinished(const Request& request, QNetworkReply* re
     {
         *errorHandled = true;
 
-        if (mustResend(errorCode))
+        if (mustResend(reply, errorCode))
         {
             if (resendRequest(request, successCb, errorCb))
                 return;
@@ -295,6 +446,14 @@ void PlcDirectoryClient::networkError(const Request& request, QNetworkReply* rep
                                       std::shared_ptr<bool> errorHandled)
 {
     Q_ASSERT(reply);
+
+    if (trackReply(request, reply))
+    {
+        qDebug() << "Aborted:" << reply->url();
+        *errorHandled = true;
+        return;
+    }
+
     const auto errorMsg = reply->errorString();
     qWarning() << "Network error:" << errorCode << errorMsg;
 
@@ -305,7 +464,7 @@ void PlcDirectoryClient::networkError(const Request& request, QNetworkReply* rep
         if (errorCode == QNetworkReply::OperationCanceledError)
             reply->disconnect();
 
-        if (mustResend(errorCode))
+        if (mustResend(reply, errorCode))
         {
             qDebug() << "Try resend on error:" << errorCode << errorMsg;
 
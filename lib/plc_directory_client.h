@@ -1,26 +1,41 @@
 // Copyright (C) 2024 Michel de Boer
 // License: GPLv3
 #pragma once
+#include "host_health.h"
 #include "lexicon/plc_directory.h"
 #include "network_client.h"
 #include "xjson.h"
 #include <QCache>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QPointer>
 
 namespace ATProto {
 
 struct PlcRequest
 {
+    // Shared by all sends of a request, including resends.
+    struct Tracker
+    {
+        QPointer<QNetworkReply> mReply; // last reply sent
+        int mHttpStatus = 0; // of the last reply
+        bool mAborted = false;
+    };
+
     QNetworkRequest mNetworkRequest;
     int mResendCount = 0;
     bool mIsPost = false;
     QByteArray mPostData;
+    std::shared_ptr<Tracker> mTracker;
 };
 
 using PlcErrorCb = std::function<void(int errorCode, const QString& errorMsg)>;
 using PlcSuccessJsonCb = std::function<void(const QJsonDocument& json)>;
 
+// Lookups go to the primary host first. If the primary has not answered within
+// its learned p95 latency, the lookup is hedged: the same request is sent to the
+// secondary host and the first answer is used, the other request gets aborted.
+// A host that keeps failing or rate limiting is skipped till a probe request succeeds.
 class PlcDirectoryClient : public NetworkClient<PlcRequest, PlcSuccessJsonCb, PlcErrorCb>
 {
 public:
@@ -44,13 +59,47 @@ public:
 
     void invalidatePdsCache(const QString& did);
 
+    // Host index 0 is the primary host.
+    int getHostCount() const { return (int)mHosts.size(); }
+    const HostHealth& getHostHealth(int hostIndex) const { return mHosts.at(hostIndex).mHealth; }
+
 private:
     using Request = PlcRequest;
 
-    bool getPdsContinue(const QString& did, const PdsSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex = 0);
+    struct Host
+    {
+        QString mName;
+        HostHealth mHealth;
+    };
+
+    enum class LookupState
+    {
+        NOT_SENT,
+        IN_FLIGHT,
+        FINISHED
+    };
+
+    // Lookup of a path on all PLC directory hosts.
+    struct HedgedLookup
+    {
+        QString mPath;
+        SuccessJsonCb mSuccessCb;
+        ErrorCb mErrorCb;
+        std::vector<LookupState> mStates; // per host
+        std::vector<std::shared_ptr<Request::Tracker>> mTrackers; // per host
+        bool mDone = false;
+    };
+
     bool getPdsForWebDid(const QString& did, const PdsSuccessCb& successCb, const ErrorCb& errorCb);
-    void getPdsRequest(const QString& did, const QUrl& url, const PdsSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex = -1);
-    bool getAuditLogContinue(const QString& did, const AuditLogSuccessCb& successCb, const ErrorCb& errorCb, int hostIndex = 0);
+    void getPdsRequest(const QString& did, const QUrl& url, const PdsSuccessCb& successCb, const ErrorCb& errorCb);
+    void setPdsFromDidDocument(const QString& did, const QJsonDocument& reply, const PdsSuccessCb& successCb, const ErrorCb& errorCb);
+
+    void hedgedGet(const QString& path, const SuccessJsonCb& successCb, const ErrorCb& errorCb);
+    bool sendToNextHost(const std::shared_ptr<HedgedLookup>& lookup);
+    void sendToHost(const std::shared_ptr<HedgedLookup>& lookup, int hostIndex);
+    void abortLosers(const std::shared_ptr<HedgedLookup>& lookup);
+
+    virtual void requestSent(const Request& request, QNetworkReply* reply) override;
 
     virtual void replyFinished(const Request& request, QNetworkReply* reply,
                        const SuccessJsonCb& successCb, const ErrorCb& errorCb,
@@ -64,7 +113,7 @@ private:
     void invalidJsonError(InvalidJsonException& e, const ErrorCb& cb);
     void invokeErrorCb(const QJsonDocument& jsonDoc, QNetworkReply* reply, QNetworkReply::NetworkError errorCode, const ErrorCb& errorCb);
 
-    std::vector<QString> mHosts;
+    std::vector<Host> mHosts;
     QCache<QString, QDateTime> mFirstAppearanceCache; // DID -> datetime
     QCache<QString, QString> mPdsCache; // DID -> PDS
 };
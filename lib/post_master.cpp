@@ -16,30 +16,25 @@ PostMaster::PostMaster(Client& client) :
 void PostMaster::post(const ATProto::AppBskyFeed::Record::Post& post,
                       const PostSuccessCb& successCb, const ErrorCb& errorCb)
 {
-    QJsonObject postJson;
+    qDebug() << "Posting:" << post.mText;
+    const QString& repo = mClient.getSessionDid();
+    auto record = std::make_shared<AppBskyFeed::Record::Post>(post);
 
+    // The post gets written to JSON by createRecord
     try {
-        postJson = post.toJson();
+        mClient.createRecord(repo, AppBskyFeed::Record::Post::TYPE, {}, std::move(record), true,
+            [successCb](auto strongRef){
+                if (successCb)
+                    successCb(strongRef->mUri, strongRef->mCid);
+            },
+            [errorCb](const QString& error, const QString& msg) {
+                if (errorCb)
+                    errorCb(error, msg);
+            });
     } catch (InvalidContent& e) {
         if (errorCb)
             QTimer::singleShot(0, &mPresence, [errorCb, e]{ errorCb("InvalidContent", "Invalid content: " + e.msg()); });
-
-        return;
     }
-
-    qDebug() << "Posting:" << postJson;
-    const QString& repo = mClient.getSessionDid();
-    const QString collection = postJson["$type"].toString();
-
-    mClient.createRecord(repo, collection, {}, postJson, true,
-        [successCb](auto strongRef){
-            if (successCb)
-                successCb(strongRef->mUri, strongRef->mCid);
-        },
-        [errorCb](const QString& error, const QString& msg) {
-            if (errorCb)
-                errorCb(error, msg);
-        });
 }
 
 void PostMaster::addThreadgate(const QString& uri, bool allowMention, bool allowFollower, bool allowFollowing, const QStringList& allowLists,
@@ -516,7 +511,7 @@ void PostMaster::continueGetFeed(const ATUri& atUri, const FeedCb& successCb)
         [successCb](auto output){
             try {
                 if (successCb)
-                    successCb(std::move(output->mView));
+                    successCb(output->mView);
             } catch (InvalidJsonException& e) {
                 qWarning() << e.msg();
             }
@@ -554,7 +549,7 @@ void PostMaster::continueGetList(const ATUri& atUri, const ListCb& successCb)
         [successCb](auto output){
             try {
                 if (successCb)
-                    successCb(std::move(output->mList));
+                    successCb(output->mList);
             } catch (InvalidJsonException& e) {
                 qWarning() << e.msg();
             }
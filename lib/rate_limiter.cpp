@@ -0,0 +1,251 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "rate_limiter.h"
+#include <QRandomGenerator>
+
+namespace ATProto {
+
+static constexpr int DEFAULT_WINDOW_SECS = 300;
+static constexpr int HTTP_TOO_MANY_REQUESTS = 429;
+static constexpr int HTTP_SERVICE_UNAVAILABLE = 503;
+
+static std::optional<int> toInt(const QByteArray& value)
+{
+    bool ok = false;
+    const int result = value.trimmed().toInt(&ok);
+
+    if (!ok)
+        return {};
+
+    return result;
+}
+
+RateLimitHeaders RateLimitHeaders::fromReply(const QNetworkReply& reply, const QDateTime& now)
+{
+    RateLimitHeaders headers;
+    headers.mHttpStatus = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (reply.hasRawHeader("ratelimit-limit"))
+        headers.mLimit = toInt(reply.rawHeader("ratelimit-limit"));
+
+    if (reply.hasRawHeader("ratelimit-remaining"))
+        headers.mRemaining = toInt(reply.rawHeader("ratelimit-remaining"));
+
+    if (reply.hasRawHeader("ratelimit-reset"))
+    {
+        const auto reset = reply.rawHeader("ratelimit-reset").trimmed().toLongLong();
+
+        // The PDS sends epoch seconds, the IETF draft has delta seconds.
+        if (reset > 1'000'000'000)
+            headers.mReset = QDateTime::fromSecsSinceEpoch(reset);
+        else if (reset > 0)
+            headers.mReset = now.addSecs(reset);
+    }
+
+    if (reply.hasRawHeader("ratelimit-policy"))
+    {
+        const auto parts = reply.rawHeader("ratelimit-policy").split(';');
+
+        for (const auto& part : parts)
+        {
+            const auto param = part.trimmed();
+
+            if (param.startsWith("w="))
+                headers.mWindowSecs = toInt(param.sliced(2));
+        }
+    }
+
+    if (reply.hasRawHeader("retry-after"))
+    {
+        const auto value = reply.rawHeader("retry-after").trimmed();
+
+        if (const auto secs = toInt(value); secs)
+        {
+            headers.mRetryAfter = now.addSecs(std::max(*secs, 0));
+        }
+        else
+        {
+            const auto date = QDateTime::fromString(QString::fromLatin1(value), Qt::RFC2822Date);
+
+            if (date.isValid())
+                headers.mRetryAfter = date;
+        }
+    }
+
+    return headers;
+}
+
+void RateLimiter::Bucket::refill(const QDateTime& now)
+{
+    if (mResetTime.isValid() && now >= mResetTime)
+    {
+        mTokens = std::max(mTokens + mLimit, 0.0);
+        mTokens = std::min(mTokens, (double)mLimit);
+        mResetTime = {};
+    }
+    else if (mUpdated.isValid())
+    {
+        const double elapsedSecs = mUpdated.msecsTo(now) / 1000.0;
+
+        if (elapsedSecs > 0)
+            mTokens = std::min(mTokens + elapsedSecs * mRefillPerSec, (double)mLimit);
+    }
+
+    mUpdated = now;
+}
+
+QString RateLimiter::bucketKey(const QUrl& url)
+{
+    return url.host() + url.path();
+}
+
+void RateLimiter::update(const QUrl& url, const RateLimitHeaders& headers, const QDateTime& now)
+{
+    QMutexLocker locker(&mMutex);
+
+    if (headers.mLimit && headers.mRemaining && *headers.mLimit > 0)
+    {
+        const QString key = bucketKey(url);
+        const bool known = mBuckets.contains(key);
+        auto& bucket = mBuckets[key];
+        const double remaining = std::clamp(*headers.mRemaining, 0, *headers.mLimit);
+
+        if (known)
+        {
+            // The remaining count does not include requests sent after this reply
+            // was produced, nor requests waiting for tokens. Keep the local count
+            // if it is lower, including any debt.
+            bucket.refill(now);
+            bucket.mTokens = std::min(bucket.mTokens, remaining);
+        }
+        else
+        {
+            bucket.mTokens = remaining;
+        }
+
+        bucket.mLimit = *headers.mLimit;
+        bucket.mResetTime = headers.mReset.value_or(QDateTime{});
+
+        int windowSecs = DEFAULT_WINDOW_SECS;
+
+        if (headers.mWindowSecs && *headers.mWindowSecs > 0)
+            windowSecs = *headers.mWindowSecs;
+        else if (bucket.mResetTime.isValid())
+            windowSecs = std::max((int)now.secsTo(bucket.mResetTime), 1);
+
+        bucket.mRefillPerSec = double(bucket.mLimit) / windowSecs;
+        bucket.mUpdated = now;
+    }
+
+    std::optional<QDateTime> blockedUntil = headers.mRetryAfter;
+
+    if (!blockedUntil && headers.mHttpStatus == HTTP_TOO_MANY_REQUESTS)
+    {
+        // Without Retry-After, wait till the reset, but not longer than the max delay.
+        const QDateTime maxTime = now.addMSecs(std::chrono::milliseconds(MAX_DELAY).count());
+        blockedUntil = headers.mReset ? std::min(*headers.mReset, maxTime) : now.addMSecs(BASE_BACKOFF.count());
+    }
+
+    if (blockedUntil)
+    {
+        const QString host = url.host();
+        auto& current = mBlockedUntil[host];
+
+        if (!current.isValid() || *blockedUntil > current)
+        {
+            current = *blockedUntil;
+            qWarning() << "Rate limited:" << host << "until:" << current;
+        }
+    }
+}
+
+std::chrono::milliseconds RateLimiter::acquire(const QUrl& url, const QDateTime& now)
+{
+    QMutexLocker locker(&mMutex);
+    qint64 waitMs = 0;
+
+    if (auto it = mBlockedUntil.find(url.host()); it != mBlockedUntil.end())
+    {
+        if (now < *it)
+            waitMs = now.msecsTo(*it);
+        else
+            mBlockedUntil.erase(it);
+    }
+
+    if (auto it = mBuckets.find(bucketKey(url)); it != mBuckets.end())
+    {
+        auto& bucket = *it;
+        bucket.refill(now);
+
+        if (bucket.mTokens < 1.0 && bucket.mRefillPerSec > 0.0)
+        {
+            qint64 bucketWaitMs = qint64((1.0 - bucket.mTokens) / bucket.mRefillPerSec * 1000.0);
+
+            if (bucket.mResetTime.isValid())
+                bucketWaitMs = std::min(bucketWaitMs, now.msecsTo(bucket.mResetTime));
+
+            waitMs = std::max(waitMs, bucketWaitMs);
+        }
+
+        bucket.mTokens -= 1.0;
+    }
+
+    waitMs = std::min(waitMs, (qint64)std::chrono::milliseconds(MAX_DELAY).count());
+    return std::chrono::milliseconds(std::max(waitMs, 0ll));
+}
+
+QHash<QString, RateLimiter::BucketState> RateLimiter::getStates() const
+{
+    QMutexLocker locker(&mMutex);
+    QHash<QString, BucketState> states;
+
+    for (auto it = mBuckets.begin(); it != mBuckets.end(); ++it)
+    {
+        const auto& bucket = it.value();
+        auto& state = states[it.key()];
+        state.mLimit = bucket.mLimit;
+        state.mTokens = bucket.mTokens;
+        state.mRefillPerSec = bucket.mRefillPerSec;
+        state.mResetTime = bucket.mResetTime;
+        state.mUpdated = bucket.mUpdated;
+    }
+
+    for (auto it = mBlockedUntil.begin(); it != mBlockedUntil.end(); ++it)
+    {
+        for (auto stateIt = states.begin(); stateIt != states.end(); ++stateIt)
+        {
+            if (stateIt.key().startsWith(it.key() + '/'))
+                stateIt->mBlockedUntil = it.value();
+        }
+
+        // A host can be blocked before any bucket is known.
+        if (!states.contains(it.key()))
+            states[it.key()].mBlockedUntil = it.value();
+    }
+
+    return states;
+}
+
+std::chrono::milliseconds RateLimiter::backoffDelay(int retry)
+{
+    const int exponent = std::clamp(retry - 1, 0, 16);
+    const qint64 capMs = std::min((qint64)BASE_BACKOFF.count() << exponent,
+                                  (qint64)std::chrono::milliseconds(MAX_BACKOFF).count());
+
+    // Equal jitter: half of the delay is fixed, the other half random.
+    const qint64 halfMs = capMs / 2;
+    return std::chrono::milliseconds(halfMs + QRandomGenerator::global()->bounded(halfMs + 1));
+}
+
+bool RateLimiter::isRateLimited(const QNetworkReply* reply)
+{
+    Q_ASSERT(reply);
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (status == HTTP_TOO_MANY_REQUESTS)
+        return true;
+
+    return status == HTTP_SERVICE_UNAVAILABLE && reply->hasRawHeader("retry-after");
+}
+
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QNetworkReply>
+#include <QUrl>
+#include <chrono>
+#include <optional>
+
+namespace ATProto {
+
+// Rate limit information from the ratelimit-* and Retry-After headers of a reply.
+struct RateLimitHeaders
+{
+    int mHttpStatus = 0;
+    std::optional<int> mLimit;
+    std::optional<int> mRemaining;
+    std::optional<QDateTime> mReset;
+    std::optional<int> mWindowSecs; // from ratelimit-policy, e.g. "3000;w=300"
+    std::optional<QDateTime> mRetryAfter;
+
+    static RateLimitHeaders fromReply(const QNetworkReply& reply, const QDateTime& now = QDateTime::currentDateTimeUtc());
+};
+
+// Token buckets fed by the rate limit headers of replies.
+// The PDS has different rate limits for different endpoints, e.g. createSession has
+// a much lower limit than other requests. Therefore there is a bucket per endpoint
+// (host + path). Retry-After and 429 replies block the whole host.
+// Requests exceeding the limit get delayed instead of being sent and rejected.
+// Thread safe.
+class RateLimiter
+{
+public:
+    struct BucketState
+    {
+        int mLimit = 0;
+        double mTokens = 0.0; // negative when requests are waiting for tokens
+        double mRefillPerSec = 0.0;
+        QDateTime mResetTime;
+        QDateTime mBlockedUntil;
+        QDateTime mUpdated;
+    };
+
+    static constexpr std::chrono::minutes MAX_DELAY{5};
+    static constexpr std::chrono::milliseconds BASE_BACKOFF{250};
+    static constexpr std::chrono::seconds MAX_BACKOFF{30};
+
+    void update(const QUrl& url, const RateLimitHeaders& headers, const QDateTime& now = QDateTime::currentDateTimeUtc());
+
+    // Takes a token for a request to the url. Returns the time to wait before the
+    // request can be sent.
+    std::chrono::milliseconds acquire(const QUrl& url, const QDateTime& now = QDateTime::currentDateTimeUtc());
+
+    // Bucket states by endpoint (host + path). For monitoring.
+    QHash<QString, BucketState> getStates() const;
+
+    // Exponential backoff with jitter for the n-th retry (starting at 1).
+    static std::chrono::milliseconds backoffDelay(int retry);
+
+    // Returns true if the reply asks to retry later (429, or 503 with Retry-After)
+    static bool isRateLimited(const QNetworkReply* reply);
+
+private:
+    struct Bucket
+    {
+        int mLimit = 0;
+        double mTokens = 0.0;
+        double mRefillPerSec = 0.0;
+        QDateTime mResetTime;
+        QDateTime mUpdated;
+
+        void refill(const QDateTime& now);
+    };
+
+    static QString bucketKey(const QUrl& url);
+
+    mutable QMutex mMutex;
+    QHash<QString, Bucket> mBuckets;
+    QHash<QString, QDateTime> mBlockedUntil; // per host
+};
+
+}
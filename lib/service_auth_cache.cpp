@@ -0,0 +1,87 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "service_auth_cache.h"
+#include "jwt.h"
+#include <QDebug>
+
+namespace ATProto {
+
+QString ServiceAuthCache::get(const QString& aud, const QString& lxm, const QDateTime& now) const
+{
+    const auto it = mTokens.find({aud, lxm});
+
+    if (it == mTokens.end())
+        return {};
+
+    if (now.secsTo(it->second.mExpiry) <= std::chrono::seconds(EXPIRY_MARGIN).count())
+        return {};
+
+    return it->second.mToken;
+}
+
+bool ServiceAuthCache::wait(const QString& aud, const QString& lxm, const Xrpc::RequestHandle& handle,
+                            const TokenCb& tokenCb, const ErrorCb& errorCb)
+{
+    auto [it, inserted] = mFetches.try_emplace({aud, lxm});
+    it->second.mWaiters.push_back({handle, tokenCb, errorCb});
+
+    if (!inserted)
+    {
+        qDebug() << "Wait for service auth fetch in flight:" << aud << lxm;
+        return false;
+    }
+
+    it->second.mGeneration = mGeneration;
+    ++mFetchCount;
+    return true;
+}
+
+void ServiceAuthCache::fetched(const QString& aud, const QString& lxm, const QString& token,
+                               const QDateTime& requestedExpiry)
+{
+    const Key key{aud, lxm};
+    auto node = mFetches.extract(key);
+
+    if (node.empty())
+    {
+        qWarning() << "No service auth fetch:" << aud << lxm;
+        return;
+    }
+
+    if (node.mapped().mGeneration == mGeneration)
+    {
+        const QDateTime expiry = Jwt::getExpiry(token);
+        mTokens[key] = Token{token, expiry.isValid() ? expiry : requestedExpiry};
+    }
+
+    for (const auto& waiter : node.mapped().mWaiters)
+    {
+        if (!waiter.mHandle.isCancelled() && waiter.mTokenCb)
+            waiter.mTokenCb(token);
+    }
+}
+
+void ServiceAuthCache::failed(const QString& aud, const QString& lxm, const QString& error, const QString& msg)
+{
+    auto node = mFetches.extract({aud, lxm});
+
+    if (node.empty())
+    {
+        qWarning() << "No service auth fetch:" << aud << lxm;
+        return;
+    }
+
+    for (const auto& waiter : node.mapped().mWaiters)
+    {
+        if (!waiter.mHandle.isCancelled() && waiter.mErrorCb)
+            waiter.mErrorCb(error, msg);
+    }
+}
+
+void ServiceAuthCache::clear()
+{
+    mTokens.clear();
+    ++mGeneration;
+}
+
+}
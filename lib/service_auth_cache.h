@@ -0,0 +1,82 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "xrpc_request_handle.h"
+#include <QDateTime>
+#include <QString>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ATProto {
+
+// Cache of service auth tokens (com.atproto.server.getServiceAuth) keyed by audience
+// and lexicon method. A token is handed out till shortly before it expires.
+// Requests for a token that is being fetched wait for that fetch instead of
+// fetching another token.
+class ServiceAuthCache
+{
+public:
+    using TokenCb = std::function<void(const QString& token)>;
+    using ErrorCb = std::function<void(const QString& error, const QString& msg)>;
+
+    // Lifetime to request for a new token.
+    static constexpr std::chrono::minutes TOKEN_LIFETIME{30};
+
+    // A token is not handed out anymore when it expires within this margin, such that
+    // a long running request, e.g. a video upload, can still use it.
+    static constexpr std::chrono::minutes EXPIRY_MARGIN{5};
+
+    // Returns the cached token, or an empty string if there is no valid token.
+    QString get(const QString& aud, const QString& lxm,
+                const QDateTime& now = QDateTime::currentDateTimeUtc()) const;
+
+    // Adds a waiter for a token. Returns true if the caller must fetch the token,
+    // i.e. no fetch for this key is in flight yet. The callbacks are not called
+    // when the handle gets cancelled.
+    bool wait(const QString& aud, const QString& lxm, const Xrpc::RequestHandle& handle,
+              const TokenCb& tokenCb, const ErrorCb& errorCb);
+
+    // The expiry is taken from the token. If the token has no exp claim, the
+    // requested expiry is used.
+    void fetched(const QString& aud, const QString& lxm, const QString& token,
+                 const QDateTime& requestedExpiry);
+    void failed(const QString& aud, const QString& lxm, const QString& error, const QString& msg);
+
+    // Drops all tokens, e.g. when the session changes. Tokens from fetches in
+    // flight are delivered to their waiters, but not cached.
+    void clear();
+
+    int size() const { return (int)mTokens.size(); }
+    int getFetchCount() const { return mFetchCount; }
+
+private:
+    using Key = std::pair<QString, QString>; // aud, lxm
+
+    struct Token
+    {
+        QString mToken;
+        QDateTime mExpiry;
+    };
+
+    struct Waiter
+    {
+        Xrpc::RequestHandle mHandle;
+        TokenCb mTokenCb;
+        ErrorCb mErrorCb;
+    };
+
+    struct Fetch
+    {
+        int mGeneration = 0;
+        std::vector<Waiter> mWaiters;
+    };
+
+    std::map<Key, Token> mTokens;
+    std::map<Key, Fetch> mFetches;
+    int mGeneration = 0;
+    int mFetchCount = 0;
+};
+
+}
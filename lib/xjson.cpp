@@ -1,23 +1,149 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #include "xjson.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#ifdef ATPROTO_SIMDJSON
+#include <simdjson.h>
+#endif
 
 namespace ATProto {
 
+static bool isBidiControlChar(QChar c)
+{
+    const char16_t u = c.unicode();
+    return u == 0x200E || u == 0x200F || // LRM, RLM
+           (u >= 0x202A && u <= 0x202E) || // LRE,RLE,PDF,LRO,RLO
+           (u >= 0x2066 && u <= 0x2069) || // LRI,RLI,FSI,PDI
+           u == 0x061C; // ALM
+}
+
 static QString& removeBidiControlChars(QString& s)
 {
-    static const std::unordered_set<QChar> bidiControls = {
-        QChar(0x200E), QChar(0x200F), // LRM, RLM
-        QChar(0x202A), QChar(0x202B), QChar(0x202C), QChar(0x202D), QChar(0x202E), // LRE,RLE,PDF,LRO,RLO
-        QChar(0x2066), QChar(0x2067), QChar(0x2068), QChar(0x2069), // LRI,RLI,FSI,PDI
-        QChar(0x061C) // ALM
-    };
+    // Almost no string has bidi controls. Scanning first avoids detaching the string.
+    if (std::none_of(s.cbegin(), s.cend(), isBidiControlChar))
+        return s;
+
+    return s.removeIf(isBidiControlChar);
+}
+
+static bool isAscii(QUtf8StringView s)
+{
+    return std::all_of(s.begin(), s.end(), [](char c){ return (uchar)c < 0x80; });
+}
+
+#ifdef ATPROTO_SIMDJSON
+namespace {
+
+using SimdElement = simdjson::dom::element;
+
+static_assert(sizeof(SimdElement) == sizeof(XJsonValue::SimdRef::mElement));
+static_assert(std::is_trivially_copyable_v<SimdElement>);
+
+// The parser owns the tape and strings of the parsed document.
+struct SimdDocument : public std::enable_shared_from_this<SimdDocument>
+{
+    simdjson::dom::parser mParser;
+    SimdElement mRoot;
+};
 
-    return s.removeIf([](QChar c){
-        return bidiControls.contains(c);
-    });
 }
 
+static constexpr bool SIMDJSON_AVAILABLE = true;
+
+static SimdElement toElement(const XJsonValue::SimdRef& ref)
+{
+    SimdElement element;
+    std::memcpy(&element, ref.mElement.data(), sizeof(element));
+    return element;
+}
+
+static XJsonValue::SimdRef toSimdRef(const void* document, const SimdElement& element)
+{
+    XJsonValue::SimdRef ref;
+    ref.mDocument = document;
+    std::memcpy(ref.mElement.data(), &element, sizeof(element));
+    return ref;
+}
+
+// Same conversion as QJsonValue: integral values in range, otherwise the default.
+template<typename Int>
+static Int toIntegral(const SimdElement& element, Int dflt)
+{
+    int64_t i;
+
+    if (element.get_int64().get(i) == simdjson::SUCCESS)
+        return std::in_range<Int>(i) ? (Int)i : dflt;
+
+    double d;
+
+    if (element.type() != simdjson::dom::element_type::DOUBLE || element.get_double().get(d) != simdjson::SUCCESS)
+        return dflt;
+
+    constexpr double MIN = (double)std::numeric_limits<Int>::min();
+
+    if (d >= MIN && d < -MIN && d == std::trunc(d))
+        return (Int)d;
+
+    return dflt;
+}
+
+static QString toString(std::string_view s)
+{
+    return QString::fromUtf8(s.data(), (qsizetype)s.size());
+}
+
+static QJsonValue toJsonValue(const SimdElement& element)
+{
+    switch (element.type())
+    {
+    case simdjson::dom::element_type::ARRAY:
+    {
+        const simdjson::dom::array elements = element.get_array().value_unsafe();
+        QJsonArray array;
+
+        for (const SimdElement elem : elements)
+            array.append(toJsonValue(elem));
+
+        return array;
+    }
+    case simdjson::dom::element_type::OBJECT:
+    {
+        const simdjson::dom::object fields = element.get_object().value_unsafe();
+        QJsonObject object;
+
+        for (const auto field : fields)
+            object.insert(toString(field.key), toJsonValue(field.value));
+
+        return object;
+    }
+    case simdjson::dom::element_type::INT64:
+        return (qint64)element.get_int64().value_unsafe();
+    case simdjson::dom::element_type::UINT64:
+        return (double)element.get_uint64().value_unsafe();
+    case simdjson::dom::element_type::DOUBLE:
+        return element.get_double().value_unsafe();
+    case simdjson::dom::element_type::STRING:
+        return toString(element.get_string().value_unsafe());
+    case simdjson::dom::element_type::BOOL:
+        return element.get_bool().value_unsafe();
+    case simdjson::dom::element_type::NULL_VALUE:
+        return QJsonValue(QJsonValue::Null);
+    }
+
+    return QJsonValue(QJsonValue::Undefined);
+}
+#else
+static constexpr bool SIMDJSON_AVAILABLE = false;
+#endif
+
+static std::atomic<XJsonBackend> sBackend = XJsonBackend::QJSON;
+
 InvalidJsonException::InvalidJsonException(const QString& msg) :
     mMsg(msg)
 {
@@ -64,52 +190,294 @@ void XJsonObject::insertOptionalDateTime(QJsonObject& json, const QString& key,
         json.insert(key, value->toUTC().toString(Qt::ISODateWithMs));
 }
 
+QJsonValue::Type XJsonValue::type() const
+{
+    if (!isSimd())
+        return mValue.type();
+
+#ifdef ATPROTO_SIMDJSON
+    switch (toElement(mSimd).type())
+    {
+    case simdjson::dom::element_type::ARRAY:
+        return QJsonValue::Array;
+    case simdjson::dom::element_type::OBJECT:
+        return QJsonValue::Object;
+    case simdjson::dom::element_type::INT64:
+    case simdjson::dom::element_type::UINT64:
+    case simdjson::dom::element_type::DOUBLE:
+        return QJsonValue::Double;
+    case simdjson::dom::element_type::STRING:
+        return QJsonValue::String;
+    case simdjson::dom::element_type::BOOL:
+        return QJsonValue::Bool;
+    case simdjson::dom::element_type::NULL_VALUE:
+        return QJsonValue::Null;
+    }
+#endif
+
+    return QJsonValue::Undefined;
+}
+
+QString XJsonValue::toString(const QString& dflt) const
+{
+    if (!isSimd())
+        return mValue.toString(dflt);
+
+#ifdef ATPROTO_SIMDJSON
+    std::string_view s;
+
+    if (toElement(mSimd).get_string().get(s) == simdjson::SUCCESS)
+        return ATProto::toString(s);
+#endif
+
+    return dflt;
+}
+
+int XJsonValue::toInt(int dflt) const
+{
+    if (!isSimd())
+        return mValue.toInt(dflt);
+
+#ifdef ATPROTO_SIMDJSON
+    return toIntegral<int>(toElement(mSimd), dflt);
+#else
+    return dflt;
+#endif
+}
+
+qint64 XJsonValue::toInteger(qint64 dflt) const
+{
+    if (!isSimd())
+        return mValue.toInteger(dflt);
+
+#ifdef ATPROTO_SIMDJSON
+    return toIntegral<qint64>(toElement(mSimd), dflt);
+#else
+    return dflt;
+#endif
+}
+
+double XJsonValue::toDouble(double dflt) const
+{
+    if (!isSimd())
+        return mValue.toDouble(dflt);
+
+#ifdef ATPROTO_SIMDJSON
+    double d;
+
+    if (toElement(mSimd).get_double().get(d) == simdjson::SUCCESS)
+        return d;
+#endif
+
+    return dflt;
+}
+
+bool XJsonValue::toBool(bool dflt) const
+{
+    if (!isSimd())
+        return mValue.toBool(dflt);
+
+#ifdef ATPROTO_SIMDJSON
+    bool b;
+
+    if (toElement(mSimd).get_bool().get(b) == simdjson::SUCCESS)
+        return b;
+#endif
+
+    return dflt;
+}
+
+qsizetype XJsonValue::size() const
+{
+    if (!isSimd())
+        return mValue.toArray().size();
+
+#ifdef ATPROTO_SIMDJSON
+    simdjson::dom::array array;
+
+    if (toElement(mSimd).get_array().get(array) == simdjson::SUCCESS)
+        return (qsizetype)array.size();
+#endif
+
+    return 0;
+}
+
+void XJsonValue::forEachElement(const std::function<void(const XJsonValue&)>& fn) const
+{
+    if (!isSimd())
+    {
+        const QJsonArray array = mValue.toArray();
+
+        for (const auto& elem : array)
+            fn(XJsonValue(QJsonValue(elem)));
+
+        return;
+    }
+
+#ifdef ATPROTO_SIMDJSON
+    simdjson::dom::array array;
+
+    if (toElement(mSimd).get_array().get(array) != simdjson::SUCCESS)
+        return;
+
+    for (const SimdElement elem : array)
+        fn(XJsonValue(toSimdRef(mSimd.mDocument, elem)));
+#endif
+}
+
+QJsonValue XJsonValue::toJsonValue() const
+{
+    if (!isSimd())
+        return mValue;
+
+#ifdef ATPROTO_SIMDJSON
+    return ATProto::toJsonValue(toElement(mSimd));
+#else
+    return QJsonValue(QJsonValue::Undefined);
+#endif
+}
+
+QJsonObject XJsonValue::toObject() const
+{
+    return isSimd() ? toJsonValue().toObject() : mValue.toObject();
+}
+
+QJsonArray XJsonValue::toArray() const
+{
+    return isSimd() ? toJsonValue().toArray() : mValue.toArray();
+}
+
 XJsonObject::XJsonObject(const QJsonObject& obj) :
     mObject(obj)
 {
 }
 
-QString XJsonObject::getRequiredString(const QString& key) const
+XJsonObject::XJsonObject(const XJsonValue& value)
 {
-    checkField(key, QJsonValue::String);
-    QString s = mObject[key].toString();
-    return removeBidiControlChars(s);
+    if (!value.isSimd())
+        mObject = value.mValue.toObject();
+    else if (value.isObject())
+        mSimd = value.mSimd;
+}
+
+QJsonObject XJsonObject::toJsonObject() const
+{
+    return isSimd() ? XJsonValue(mSimd).toObject() : mObject;
 }
 
-int XJsonObject::getRequiredInt(const QString& key) const
+QJsonObject XJsonObject::getUnknownFields(std::initializer_list<QAnyStringView> known) const
 {
-    checkField(key, QJsonValue::Double);
-    return mObject[key].toInt();
+    if (!isSimd())
+        return mObject;
+
+    QJsonObject unknown;
+
+#ifdef ATPROTO_SIMDJSON
+    const simdjson::dom::object fields = toElement(mSimd).get_object().value_unsafe();
+
+    for (const auto field : fields)
+    {
+        const QUtf8StringView key(field.key.data(), (qsizetype)field.key.size());
+        const bool isKnown = std::any_of(known.begin(), known.end(),
+            [key](QAnyStringView k){ return QAnyStringView::equal(k, key); });
+
+        if (!isKnown)
+            unknown.insert(toString(field.key), toJsonValue(field.value));
+    }
+#else
+    Q_UNUSED(known);
+#endif
+
+    return unknown;
 }
 
-int XJsonObject::getRequiredDouble(const QString& key) const
+XJsonObject XJsonObject::retain() const
 {
-    checkField(key, QJsonValue::Double);
-    return mObject[key].toDouble();
+    XJsonObject copy(*this);
+
+#ifdef ATPROTO_SIMDJSON
+    if (isSimd() && !copy.mDocument)
+        copy.mDocument = static_cast<const SimdDocument*>(mSimd.mDocument)->shared_from_this();
+#endif
+
+    return copy;
+}
+
+XJsonValue XJsonObject::getValue(QAnyStringView key) const
+{
+#ifdef ATPROTO_SIMDJSON
+    if (isSimd())
+    {
+        // simdjson compares keys as UTF-8. String literals need no conversion.
+        const auto lookup = [this](std::string_view k) -> XJsonValue {
+            SimdElement value;
+
+            if (toElement(mSimd).at_key(k).get(value) != simdjson::SUCCESS)
+                return {};
+
+            return XJsonValue(toSimdRef(mSimd.mDocument, value));
+        };
+
+        return key.visit([&lookup](auto k){
+            if constexpr (std::is_same_v<decltype(k), QUtf8StringView>)
+            {
+                return lookup(std::string_view(k.data(), k.size()));
+            }
+            else
+            {
+                const QByteArray utf8 = k.toString().toUtf8();
+                return lookup(std::string_view(utf8.constData(), utf8.size()));
+            }
+        });
+    }
+#endif
+
+    // Keys are mostly string literals. Looking them up as Latin-1 avoids a
+    // conversion to QString for each field.
+    return key.visit([this](auto k) -> XJsonValue {
+        if constexpr (std::is_same_v<decltype(k), QUtf8StringView>)
+        {
+            if (isAscii(k))
+                return mObject.value(QLatin1StringView(k.data(), k.size()));
+
+            return mObject.value(k.toString());
+        }
+        else
+        {
+            return mObject.value(k);
+        }
+    });
 }
 
-bool XJsonObject::getRequiredBool(const QString& key) const
+QString XJsonObject::getRequiredString(QAnyStringView key) const
 {
-    checkField(key, QJsonValue::Bool);
-    return mObject[key].toBool();
+    QString s = getField(key, QJsonValue::String).toString();
+    return removeBidiControlChars(s);
 }
 
-QDateTime XJsonObject::getRequiredDateTime(const QString& key) const
+int XJsonObject::getRequiredInt(QAnyStringView key) const
 {
-    checkField(key, QJsonValue::String);
-    const QString value = mObject[key].toString();
-    const QDateTime dateTime = QDateTime::fromString(value, Qt::ISODateWithMs);
+    return getField(key, QJsonValue::Double).toInt();
+}
 
-    if (!dateTime.isValid())
-        throw InvalidJsonException(QString("Invalid datetime: %1").arg(value));
+int XJsonObject::getRequiredDouble(QAnyStringView key) const
+{
+    return getField(key, QJsonValue::Double).toDouble();
+}
 
-    return dateTime;
+bool XJsonObject::getRequiredBool(QAnyStringView key) const
+{
+    return getField(key, QJsonValue::Bool).toBool();
 }
 
-QDate XJsonObject::getRequiredDate(const QString& key) const
+QDateTime XJsonObject::getRequiredDateTime(QAnyStringView key) const
 {
-    checkField(key, QJsonValue::String);
-    const QString value = mObject[key].toString();
+    return toDateTime(getField(key, QJsonValue::String));
+}
+
+QDate XJsonObject::getRequiredDate(QAnyStringView key) const
+{
+    const QString value = getField(key, QJsonValue::String).toString();
     const QDate date = QDate::fromString(value, Qt::ISODate);
 
     if (!date.isValid())
@@ -118,160 +486,166 @@ QDate XJsonObject::getRequiredDate(const QString& key) const
     return date;
 }
 
-QJsonObject XJsonObject::getRequiredJsonObject(const QString& key) const
+QJsonObject XJsonObject::getRequiredJsonObject(QAnyStringView key) const
+{
+    return getField(key, QJsonValue::Object).toObject();
+}
+
+QJsonArray XJsonObject::getRequiredArray(QAnyStringView key) const
 {
-    checkField(key, QJsonValue::Object);
-    return mObject[key].toObject();
+    return getField(key, QJsonValue::Array).toArray();
 }
 
-QJsonArray XJsonObject::getRequiredArray(const QString& key) const
+std::vector<QString> XJsonObject::getRequiredStringVector(QAnyStringView key) const
 {
-    checkField(key, QJsonValue::Array);
-    return mObject[key].toArray();
+    return toStringVector(key, getField(key, QJsonValue::Array));
 }
 
-std::vector<QString> XJsonObject::getRequiredStringVector(const QString& key) const
+std::vector<QString> XJsonObject::toStringVector(QAnyStringView key, const XJsonValue& jsonArray) const
 {
     std::vector<QString> result;
-    const auto jsonArray = getRequiredArray(key);
     result.reserve(jsonArray.size());
 
-    for (const auto& strJson : jsonArray)
-    {
+    jsonArray.forEachElement([this, key, &result](const XJsonValue& strJson){
         if (!strJson.isString())
         {
-            qWarning() << "Invalid string vector:" << key << "in json:" << mObject;
-            throw InvalidJsonException("Invalid string vector: " + key);
+            qWarning() << "Invalid string vector:" << key.toString() << "in json:" << toJsonObject();
+            throw InvalidJsonException("Invalid string vector: " + key.toString());
         }
 
         result.push_back(strJson.toString());
-    }
+    });
 
     return result;
 }
 
-std::vector<QString> XJsonObject::getOptionalStringVector(const QString& key) const
+std::vector<QString> XJsonObject::getOptionalStringVector(QAnyStringView key) const
 {
-    if (!mObject.contains(key))
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
         return {};
 
-    return getRequiredStringVector(key);
+    return toStringVector(key, checkType(key, value, QJsonValue::Array));
+}
+
+QStringList XJsonObject::getRequiredStringList(QAnyStringView key) const
+{
+    return toStringList(key, getField(key, QJsonValue::Array));
 }
 
-QStringList XJsonObject::getRequiredStringList(const QString& key) const
+QStringList XJsonObject::toStringList(QAnyStringView key, const XJsonValue& jsonArray) const
 {
     QStringList result;
-    const auto jsonArray = getRequiredArray(key);
     result.reserve(jsonArray.size());
 
-    for (const auto& strJson : jsonArray)
-    {
+    jsonArray.forEachElement([this, key, &result](const XJsonValue& strJson){
         if (!strJson.isString())
         {
-            qWarning() << "Invalid string list:" << key << "in json:" << mObject;
-            throw InvalidJsonException("Invalid string list: " + key);
+            qWarning() << "Invalid string list:" << key.toString() << "in json:" << toJsonObject();
+            throw InvalidJsonException("Invalid string list: " + key.toString());
         }
 
         result.push_back(strJson.toString());
-    }
+    });
 
     return result;
 }
 
-QStringList XJsonObject::getOptionalStringList(const QString& key) const
+QStringList XJsonObject::getOptionalStringList(QAnyStringView key) const
 {
-    if (!mObject.contains(key))
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
         return {};
 
-    return getRequiredStringList(key);
+    return toStringList(key, checkType(key, value, QJsonValue::Array));
 }
 
-std::optional<QString> XJsonObject::getOptionalString(const QString& key) const
+std::optional<QString> XJsonObject::getOptionalString(QAnyStringView key) const
 {
-    if (mObject.contains(key))
-    {
-        QString s = mObject[key].toString();
-        return removeBidiControlChars(s);
-    }
+    const XJsonValue value = getValue(key);
 
-    return {};
+    if (value.isUndefined())
+        return {};
+
+    QString s = value.toString();
+    return removeBidiControlChars(s);
 }
 
-QString XJsonObject::getOptionalString(const QString& key, const QString& dflt) const
+QString XJsonObject::getOptionalString(QAnyStringView key, const QString& dflt) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toString(dflt);
-
-    return dflt;
+    return getValue(key).toString(dflt);
 }
 
-std::optional<int> XJsonObject::getOptionalInt(const QString& key) const
+std::optional<int> XJsonObject::getOptionalInt(QAnyStringView key) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toInt();
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
 
-    return {};
+    return value.toInt();
 }
 
-int XJsonObject::getOptionalInt(const QString& key, int dflt) const
+int XJsonObject::getOptionalInt(QAnyStringView key, int dflt) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toInt(dflt);
-
-    return dflt;
+    return getValue(key).toInt(dflt);
 }
 
-std::optional<qint64> XJsonObject::getOptionalInt64(const QString& key) const
+std::optional<qint64> XJsonObject::getOptionalInt64(QAnyStringView key) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toInteger();
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
 
-    return {};
+    return value.toInteger();
 }
 
-qint64 XJsonObject::getOptionalInt64(const QString& key, qint64 dflt) const
+qint64 XJsonObject::getOptionalInt64(QAnyStringView key, qint64 dflt) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toInteger(dflt);
-
-    return dflt;
+    return getValue(key).toInteger(dflt);
 }
 
-std::optional<bool> XJsonObject::getOptionalBool(const QString& key) const
+std::optional<bool> XJsonObject::getOptionalBool(QAnyStringView key) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toBool();
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
 
-    return {};
+    return value.toBool();
 }
 
-bool XJsonObject::getOptionalBool(const QString& key, bool dflt) const
+bool XJsonObject::getOptionalBool(QAnyStringView key, bool dflt) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toBool(dflt);
-
-    return dflt;
+    return getValue(key).toBool(dflt);
 }
 
-std::optional<QDateTime> XJsonObject::getOptionalDateTime(const QString& key) const
+std::optional<QDateTime> XJsonObject::getOptionalDateTime(QAnyStringView key) const
 {
-    if (mObject.contains(key))
-        return getRequiredDateTime(key);
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
 
-    return {};
+    return toDateTime(checkType(key, value, QJsonValue::String));
 }
 
-QDateTime XJsonObject::getOptionalDateTime(const QString& key, QDateTime dflt) const
+QDateTime XJsonObject::getOptionalDateTime(QAnyStringView key, QDateTime dflt) const
 {
-    if (mObject.contains(key))
-        return getRequiredDateTime(key);
+    const XJsonValue value = getValue(key);
 
-    return dflt;
+    if (value.isUndefined())
+        return dflt;
+
+    return toDateTime(checkType(key, value, QJsonValue::String));
 }
 
-QUrl XJsonObject::getOptionalUrl(const QString& key) const
+QUrl XJsonObject::getOptionalUrl(QAnyStringView key) const
 {
-    const QString value = mObject[key].toString();
+    const QString value = getValue(key).toString();
     const QUrl url(value);
 
     if (!url.isValid())
@@ -280,35 +654,126 @@ QUrl XJsonObject::getOptionalUrl(const QString& key) const
     return url;
 }
 
-std::optional<QJsonObject> XJsonObject::getOptionalJsonObject(const QString& key) const
+std::optional<QJsonObject> XJsonObject::getOptionalJsonObject(QAnyStringView key) const
+{
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
+
+    return value.toObject();
+}
+
+std::optional<QJsonArray> XJsonObject::getOptionalArray(QAnyStringView key) const
+{
+    const XJsonValue value = getValue(key);
+
+    if (value.isUndefined())
+        return {};
+
+    return value.toArray();
+}
+
+QDateTime XJsonObject::toDateTime(const XJsonValue& value)
+{
+    const QString s = value.toString();
+    const QDateTime dateTime = QDateTime::fromString(s, Qt::ISODateWithMs);
+
+    if (!dateTime.isValid())
+        throw InvalidJsonException(QString("Invalid datetime: %1").arg(s));
+
+    return dateTime;
+}
+
+XJsonValue XJsonObject::getField(QAnyStringView key, QJsonValue::Type type) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toObject();
+    const XJsonValue value = getValue(key);
 
-    return {};
+    if (value.isUndefined())
+    {
+        qWarning() << "Field missing:" << key.toString() << toJsonObject();
+        throw InvalidJsonException(QString("JSON field missing: %1").arg(key.toString()));
+    }
+
+    return checkType(key, value, type);
 }
 
-std::optional<QJsonArray> XJsonObject::getOptionalArray(const QString& key) const
+const XJsonValue& XJsonObject::checkType(QAnyStringView key, const XJsonValue& value, QJsonValue::Type type) const
 {
-    if (mObject.contains(key))
-        return mObject[key].toArray();
+    if (value.type() != type)
+    {
+        qWarning() << "Field:" << key.toString() << "has wrong type:" << toJsonObject();
+        throw InvalidJsonException(QString("JSON field %1 does not have type: %2").arg(key.toString()).arg(type));
+    }
 
-    return {};
+    return value;
 }
 
-void XJsonObject::checkField(const QString& key, QJsonValue::Type type) const
+XJsonDocument::XJsonDocument(const QByteArray& json)
 {
-    if (!mObject.contains(key))
+#ifdef ATPROTO_SIMDJSON
+    if (sBackend == XJsonBackend::SIMDJSON)
     {
-        qWarning() << "Field missing:" << key << mObject;
-        throw InvalidJsonException(QString("JSON field missing: %1").arg(key));
+        auto document = std::make_shared<SimdDocument>();
+        const auto error = document->mParser.parse(json.constData(), json.size()).get(document->mRoot);
+
+        if (error != simdjson::SUCCESS)
+        {
+            qDebug() << "Invalid JSON:" << simdjson::error_message(error);
+            return;
+        }
+
+        mSimdDocument = std::move(document);
+        return;
     }
+#endif
+
+    mDocument = QJsonDocument::fromJson(json);
+}
+
+bool XJsonDocument::isObject() const
+{
+#ifdef ATPROTO_SIMDJSON
+    if (mSimdDocument)
+        return static_cast<const SimdDocument*>(mSimdDocument.get())->mRoot.is_object();
+#endif
+
+    return mDocument.isObject();
+}
 
-    if (mObject.value(key).type() != type)
+XJsonObject XJsonDocument::object() const
+{
+#ifdef ATPROTO_SIMDJSON
+    if (mSimdDocument)
+    {
+        const auto* document = static_cast<const SimdDocument*>(mSimdDocument.get());
+        return XJsonObject(XJsonValue(toSimdRef(document, document->mRoot)));
+    }
+#endif
+
+    return XJsonObject(mDocument.object());
+}
+
+bool XJsonDocument::setBackend(XJsonBackend backend)
+{
+    if (!isAvailable(backend))
     {
-        qWarning() << "Field:" << key << "has wrong type:" << mObject;
-        throw InvalidJsonException(QString("JSON field %1 does not have type: %2").arg(key).arg(type));
+        qWarning() << "JSON backend not available:" << (int)backend;
+        return false;
     }
+
+    sBackend = backend;
+    return true;
+}
+
+XJsonBackend XJsonDocument::getBackend()
+{
+    return sBackend;
+}
+
+bool XJsonDocument::isAvailable(XJsonBackend backend)
+{
+    return backend == XJsonBackend::QJSON || SIMDJSON_AVAILABLE;
 }
 
 }
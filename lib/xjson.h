@@ -2,11 +2,22 @@
 // License: GPLv3
 #pragma once
 #include "lexicon/lexicon.h"
+#include <QAnyStringView>
 #include <QDateTime>
 #include <QException>
+#include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QUrl>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <variant>
 
 namespace ATProto
 {
@@ -30,6 +41,81 @@ private:
     QString mMsg;
 };
 
+// FNV-1a hash of a $type. Types are ASCII, such that the hash of the UTF-16 code
+// units of a QString equals the hash of the literal.
+constexpr quint32 variantTypeHash(char const* type)
+{
+    quint32 hash = 2166136261u;
+
+    for (; *type; ++type)
+        hash = (hash ^ (uchar)*type) * 16777619u;
+
+    return hash;
+}
+
+inline quint32 variantTypeHash(QStringView type)
+{
+    quint32 hash = 2166136261u;
+
+    for (const QChar c : type)
+        hash = (hash ^ c.unicode()) * 16777619u;
+
+    return hash;
+}
+
+// Backend that parses JSON documents, see XJsonDocument.
+// SIMDJSON is available when the library is built with ENABLE_SIMDJSON. QJSON is
+// the default, SIMDJSON must be selected with XJsonDocument::setBackend().
+enum class XJsonBackend
+{
+    QJSON,
+    SIMDJSON
+};
+
+// JSON value of either backend, with the interface of QJsonValue.
+class XJsonValue
+{
+public:
+    // Element of a simdjson document. Opaque, such that simdjson.h stays out of
+    // this header.
+    struct SimdRef
+    {
+        const void* mDocument = nullptr;
+        alignas(8) std::array<std::byte, 16> mElement{};
+    };
+
+    XJsonValue() = default;
+    XJsonValue(const QJsonValue& value) : mValue(value) {}
+    explicit XJsonValue(const SimdRef& simd) : mSimd(simd) {}
+
+    bool isSimd() const { return mSimd.mDocument; }
+    QJsonValue::Type type() const;
+    bool isUndefined() const { return type() == QJsonValue::Undefined; }
+    bool isString() const { return type() == QJsonValue::String; }
+    bool isObject() const { return type() == QJsonValue::Object; }
+
+    QString toString(const QString& dflt = {}) const;
+    int toInt(int dflt = 0) const;
+    qint64 toInteger(qint64 dflt = 0) const;
+    double toDouble(double dflt = 0) const;
+    bool toBool(bool dflt = false) const;
+
+    // Array access
+    qsizetype size() const;
+    void forEachElement(const std::function<void(const XJsonValue&)>& fn) const;
+
+    // For the SIMDJSON backend these convert the value to Qt JSON.
+    QJsonValue toJsonValue() const;
+    QJsonObject toObject() const;
+    QJsonArray toArray() const;
+
+private:
+    friend class XJsonObject;
+
+    QJsonValue mValue{QJsonValue::Undefined};
+    SimdRef mSimd;
+};
+
 class XJsonObject
 {
 public:
@@ -68,66 +154,205 @@ public:
 
     XJsonObject(const QJsonObject& obj);
 
-    const QJsonObject& getObject() const { return mObject; }
-
-    QString getRequiredString(const QString& key) const;
-    int getRequiredInt(const QString& key) const;
-    int getRequiredDouble(const QString& key) const;
-    bool getRequiredBool(const QString& key) const;
-    QDateTime getRequiredDateTime(const QString& key) const;
-    QDate getRequiredDate(const QString& key) const;
-    QJsonObject getRequiredJsonObject(const QString& key) const;
-    QJsonArray getRequiredArray(const QString& key) const;
-    std::optional<QString> getOptionalString(const QString& key) const;
-    QString getOptionalString(const QString& key, const QString& dflt) const;
-    std::optional<int> getOptionalInt(const QString& key) const;
-    int getOptionalInt(const QString& key, int dflt) const;
-    std::optional<qint64> getOptionalInt64(const QString& key) const;
-    qint64 getOptionalInt64(const QString& key, qint64 dflt) const;
-    std::optional<bool> getOptionalBool(const QString& key) const;
-    bool getOptionalBool(const QString& key, bool dflt) const;
-    std::optional<QDateTime> getOptionalDateTime(const QString& key) const;
-    QDateTime getOptionalDateTime(const QString& key, QDateTime dflt) const;
-    QUrl getOptionalUrl(const QString& key) const;
-    std::optional<QJsonObject> getOptionalJsonObject(const QString& key) const;
-    std::optional<QJsonArray> getOptionalArray(const QString& key) const;
+    // A value that is not an object gives an empty object, like QJsonValue::toObject()
+    explicit XJsonObject(const XJsonValue& value);
+
+    // Decodes a lexicon type. Types with fromJson(const XJsonObject&) decode from
+    // either backend directly, other types from a QJsonObject.
+    template<class ObjType>
+    static typename ObjType::SharedPtr decode(const XJsonObject& xjson);
+
+    // For the SIMDJSON backend this converts the object to a QJsonObject.
+    QJsonObject toJsonObject() const;
+
+    // Returns the fields for a QJsonObject that keeps the fields unknown to a lexicon
+    // type. The QJSON backend returns the object as is, which costs nothing. The
+    // SIMDJSON backend converts only the fields not in known.
+    QJsonObject getUnknownFields(std::initializer_list<QAnyStringView> known) const;
+
+    // Returns a copy that keeps its document alive, such that it can be decoded
+    // after the document is gone, e.g. for lazy decoding.
+    XJsonObject retain() const;
+
+    QString getRequiredString(QAnyStringView key) const;
+    int getRequiredInt(QAnyStringView key) const;
+    int getRequiredDouble(QAnyStringView key) const;
+    bool getRequiredBool(QAnyStringView key) const;
+    QDateTime getRequiredDateTime(QAnyStringView key) const;
+    QDate getRequiredDate(QAnyStringView key) const;
+    QJsonObject getRequiredJsonObject(QAnyStringView key) const;
+    QJsonArray getRequiredArray(QAnyStringView key) const;
+
+    // Throws if the field is missing or not an object, without converting it.
+    void checkRequiredObject(QAnyStringView key) const { getField(key, QJsonValue::Object); }
+
+    // Returns an undefined value if the key is not present.
+    XJsonValue getValue(QAnyStringView key) const;
+    bool has(QAnyStringView key) const { return !getValue(key).isUndefined(); }
+
+    // Throws if the field is missing or of another type.
+    XJsonValue getField(QAnyStringView key, QJsonValue::Type type) const;
+
+    std::optional<QString> getOptionalString(QAnyStringView key) const;
+    QString getOptionalString(QAnyStringView key, const QString& dflt) const;
+    std::optional<int> getOptionalInt(QAnyStringView key) const;
+    int getOptionalInt(QAnyStringView key, int dflt) const;
+    std::optional<qint64> getOptionalInt64(QAnyStringView key) const;
+    qint64 getOptionalInt64(QAnyStringView key, qint64 dflt) const;
+    std::optional<bool> getOptionalBool(QAnyStringView key) const;
+    bool getOptionalBool(QAnyStringView key, bool dflt) const;
+    std::optional<QDateTime> getOptionalDateTime(QAnyStringView key) const;
+    QDateTime getOptionalDateTime(QAnyStringView key, QDateTime dflt) const;
+    QUrl getOptionalUrl(QAnyStringView key) const;
+    std::optional<QJsonObject> getOptionalJsonObject(QAnyStringView key) const;
+    std::optional<QJsonArray> getOptionalArray(QAnyStringView key) const;
 
     template<class ObjType>
-    typename ObjType::SharedPtr getRequiredObject(const QString& key) const;
+    typename ObjType::SharedPtr getRequiredObject(QAnyStringView key) const;
 
     template<class ObjType>
-    typename ObjType::SharedPtr getOptionalObject(const QString& key) const;
+    typename ObjType::SharedPtr getOptionalObject(QAnyStringView key) const;
 
     template<class ElemType>
-    std::vector<typename ElemType::SharedPtr> getRequiredVector(const QString& key) const;
+    std::vector<typename ElemType::SharedPtr> getRequiredVector(QAnyStringView key) const;
 
     template<class ElemType>
-    std::vector<typename ElemType::SharedPtr> getOptionalVector(const QString& key) const;
+    std::vector<typename ElemType::SharedPtr> getOptionalVector(QAnyStringView key) const;
 
-    std::vector<QString> getRequiredStringVector(const QString& key) const;
-    std::vector<QString> getOptionalStringVector(const QString& key) const;
-    QStringList getRequiredStringList(const QString& key) const;
-    QStringList getOptionalStringList(const QString& key) const;
+    std::vector<QString> getRequiredStringVector(QAnyStringView key) const;
+    std::vector<QString> getOptionalStringVector(QAnyStringView key) const;
+    QStringList getRequiredStringList(QAnyStringView key) const;
+    QStringList getOptionalStringList(QAnyStringView key) const;
 
     template<typename... Types>
-    static std::variant<typename Types::SharedPtr...> toVariant(const QJsonObject& json);
+    static std::variant<typename Types::SharedPtr...> toVariant(const XJsonObject& xjson);
 
     template<typename... Types>
-    std::variant<typename Types::SharedPtr...> getRequiredVariant(const QString& key) const;
+    std::variant<typename Types::SharedPtr...> getRequiredVariant(QAnyStringView key) const;
 
     template<typename... Types>
-    std::optional<std::variant<typename Types::SharedPtr...>> getOptionalVariant(const QString& key) const;
+    std::optional<std::variant<typename Types::SharedPtr...>> getOptionalVariant(QAnyStringView key) const;
 
     template<typename... Types>
-    std::vector<std::variant<typename Types::SharedPtr...>> getRequiredVariantList(const QString& key) const;
+    std::vector<std::variant<typename Types::SharedPtr...>> getRequiredVariantList(QAnyStringView key) const;
 
     template<typename... Types>
-    std::vector<std::variant<typename Types::SharedPtr...>> getOptionalVariantList(const QString& key) const;
+    std::vector<std::variant<typename Types::SharedPtr...>> getOptionalVariantList(QAnyStringView key) const;
 
 private:
-    void checkField(const QString& key, QJsonValue::Type type) const;
+    bool isSimd() const { return mSimd.mDocument; }
+
+    const XJsonValue& checkType(QAnyStringView key, const XJsonValue& value, QJsonValue::Type type) const;
+    std::vector<QString> toStringVector(QAnyStringView key, const XJsonValue& jsonArray) const;
+    QStringList toStringList(QAnyStringView key, const XJsonValue& jsonArray) const;
+    static QDateTime toDateTime(const XJsonValue& value);
+
+    template<class ElemType>
+    static std::vector<typename ElemType::SharedPtr> toVector(QAnyStringView key, const XJsonValue& jsonArray);
+
+    QJsonObject mObject; // QJSON backend
+    XJsonValue::SimdRef mSimd; // SIMDJSON backend
+    std::shared_ptr<const void> mDocument; // set by retain()
+};
+
+// Parsed JSON document. Values of the SIMDJSON backend refer to the document and
+// are valid as long as a copy of the document exists, or as an object retained
+// from it.
+class XJsonDocument
+{
+public:
+    // Parses with the selected backend. Like QJsonDocument, invalid JSON gives a
+    // document without object.
+    explicit XJsonDocument(const QByteArray& json);
+
+    bool isObject() const;
+
+    // Returns an empty object if the document has no object.
+    XJsonObject object() const;
+
+    // The backend for new documents. Returns false if the backend is not available.
+    static bool setBackend(XJsonBackend backend);
+    static XJsonBackend getBackend();
+    static bool isAvailable(XJsonBackend backend);
+
+private:
+    QJsonDocument mDocument; // QJSON backend
+    std::shared_ptr<const void> mSimdDocument; // SIMDJSON backend
+};
+
+// Open addressing hash table from $type to the index of the variant alternative,
+// built at compile time from the alternatives.
+// An alternative with an empty TYPE, i.e. UnknownVariant, catches all types that
+// do not match an alternative before it.
+template<typename... Types>
+struct VariantTypeTable
+{
+    using Variant = std::variant<typename Types::SharedPtr...>;
+    using DecodeFn = Variant(*)(const XJsonObject&);
+
+    static constexpr std::size_t SIZE = sizeof...(Types);
+    static constexpr std::array<char const*, SIZE> TYPES{ Types::TYPE... };
+    static constexpr std::array<quint32, SIZE> HASHES{ variantTypeHash(Types::TYPE)... };
+    static constexpr std::size_t SLOT_COUNT = std::bit_ceil(2 * SIZE);
+    static constexpr std::size_t SLOT_MASK = SLOT_COUNT - 1;
+
+    static constexpr std::size_t FALLBACK = []{
+        for (std::size_t i = 0; i < SIZE; ++i)
+        {
+            if (*TYPES[i] == '\0')
+                return i;
+        }
+
+        return SIZE;
+    }();
+
+    // Slot value is index + 1, 0 is an empty slot. With linear probing the first of
+    // duplicate types is found first.
+    static constexpr std::array<std::size_t, SLOT_COUNT> SLOTS = []{
+        std::array<std::size_t, SLOT_COUNT> slots{};
 
-    const QJsonObject& mObject;
+        for (std::size_t i = 0; i < SIZE; ++i)
+        {
+            if (*TYPES[i] == '\0')
+                continue;
+
+            std::size_t slot = HASHES[i] & SLOT_MASK;
+
+            while (slots[slot] != 0)
+                slot = (slot + 1) & SLOT_MASK;
+
+            slots[slot] = i + 1;
+        }
+
+        return slots;
+    }();
+
+    template<std::size_t I>
+    static Variant decode(const XJsonObject& xjson)
+    {
+        using T = std::tuple_element_t<I, std::tuple<Types...>>;
+        return Variant(std::in_place_index<I>, XJsonObject::decode<T>(xjson));
+    }
+
+    static constexpr std::array<DecodeFn, SIZE> DECODERS = []<std::size_t... I>(std::index_sequence<I...>){
+        return std::array<DecodeFn, SIZE>{ &decode<I>... };
+    }(std::index_sequence_for<Types...>{});
+
+    // Returns SIZE if there is no alternative for the type.
+    static std::size_t find(QStringView type)
+    {
+        const quint32 hash = variantTypeHash(type);
+
+        for (std::size_t slot = hash & SLOT_MASK; SLOTS[slot] != 0; slot = (slot + 1) & SLOT_MASK)
+        {
+            const std::size_t i = SLOTS[slot] - 1;
+
+            if (HASHES[i] == hash && type == QLatin1StringView(TYPES[i]))
+                return std::min(i, FALLBACK);
+        }
+
+        return FALLBACK;
+    }
 };
 
 template<class Type>
@@ -178,131 +403,98 @@ void XJsonObject::insertOptionalJsonObject(QJsonObject& json, const QString& key
 }
 
 template<class ObjType>
-typename ObjType::SharedPtr XJsonObject::getRequiredObject(const QString& key) const
+typename ObjType::SharedPtr XJsonObject::decode(const XJsonObject& xjson)
+{
+    if constexpr (requires { ObjType::fromJson(xjson); })
+        return ObjType::fromJson(xjson);
+    else
+        return ObjType::fromJson(xjson.toJsonObject());
+}
+
+template<class ObjType>
+typename ObjType::SharedPtr XJsonObject::getRequiredObject(QAnyStringView key) const
 {
-    const auto json = getRequiredJsonObject(key);
-    return ObjType::fromJson(json);
+    return decode<ObjType>(XJsonObject(getField(key, QJsonValue::Object)));
 }
 
 template<class ObjType>
-typename ObjType::SharedPtr XJsonObject::getOptionalObject(const QString& key) const
+typename ObjType::SharedPtr XJsonObject::getOptionalObject(QAnyStringView key) const
 {
-    const auto json = getOptionalJsonObject(key);
+    const XJsonValue value = getValue(key);
 
-    if (!json)
+    if (value.isUndefined())
         return nullptr;
 
-    return ObjType::fromJson(*json);
+    return decode<ObjType>(XJsonObject(value));
 }
 
 template<class ElemType>
-std::vector<typename ElemType::SharedPtr> XJsonObject::getRequiredVector(const QString& key) const
+std::vector<typename ElemType::SharedPtr> XJsonObject::toVector(QAnyStringView key, const XJsonValue& jsonArray)
 {
     std::vector<typename ElemType::SharedPtr> result;
-    const auto jsonArray = getRequiredArray(key);
     result.reserve(jsonArray.size());
 
-    for (const auto& json : jsonArray)
-    {
+    jsonArray.forEachElement([key, &result](const XJsonValue& json){
         if (!json.isObject())
         {
-            qWarning() << "PROTO ERROR invalid array element: not an object, key:" << key;
-            qInfo() << json;
-            throw InvalidJsonException("PROTO ERROR invalid element: " + key);
+            qWarning() << "PROTO ERROR invalid array element: not an object, key:" << key.toString();
+            qInfo() << json.toJsonValue();
+            throw InvalidJsonException("PROTO ERROR invalid element: " + key.toString());
         }
 
-        typename ElemType::SharedPtr elem = ElemType::fromJson(json.toObject());
+        typename ElemType::SharedPtr elem = decode<ElemType>(XJsonObject(json));
         result.push_back(std::move(elem));
-    }
+    });
 
     return result;
 }
 
 template<class ElemType>
-std::vector<typename ElemType::SharedPtr> XJsonObject::getOptionalVector(const QString& key) const
+std::vector<typename ElemType::SharedPtr> XJsonObject::getRequiredVector(QAnyStringView key) const
 {
-    std::vector<typename ElemType::SharedPtr> result;
-    const auto jsonArray = getOptionalArray(key);
-
-    if (!jsonArray)
-        return result;
-
-    result.reserve(jsonArray->size());
+    return toVector<ElemType>(key, getField(key, QJsonValue::Array));
+}
 
-    for (const auto& json : *jsonArray)
-    {
-        if (!json.isObject())
-        {
-            qWarning() << "PROTO ERROR invalid array element: not an object, key:" << key;
-            qInfo() << json;
-            throw InvalidJsonException("PROTO ERROR invalid element: " + key);
-        }
+template<class ElemType>
+std::vector<typename ElemType::SharedPtr> XJsonObject::getOptionalVector(QAnyStringView key) const
+{
+    const XJsonValue jsonArray = getValue(key);
 
-        typename ElemType::SharedPtr elem = ElemType::fromJson(json.toObject());
-        result.push_back(std::move(elem));
-    }
+    if (jsonArray.isUndefined())
+        return {};
 
-    return result;
+    return toVector<ElemType>(key, jsonArray);
 }
 
-#define VARIANT_CASE(i) \
-    case i: \
-    { \
-        using T = typename std::tuple_element<i < sizeof...(Types) ? i : 0, std::tuple<Types...>>::type; \
-        \
-        if (type == T::TYPE || UNKNOWN_VARIANT_TYPE == T::TYPE) \
-            return T::fromJson(objXJson.getObject()); \
-        \
-        break; \
-    }
-
 template<typename... Types>
-std::variant<typename Types::SharedPtr...> XJsonObject::toVariant(const QJsonObject& json)
+std::variant<typename Types::SharedPtr...> XJsonObject::toVariant(const XJsonObject& xjson)
 {
-    static_assert(sizeof...(Types) <= 13);
-    const QString UNKNOWN_VARIANT_TYPE = "";
-    const XJsonObject objXJson(json);
-    const QString type = objXJson.getRequiredString("$type");
+    using Table = VariantTypeTable<Types...>;
+    const QString type = xjson.getField("$type", QJsonValue::String).toString();
+    const std::size_t index = Table::find(type);
 
-    for (size_t i = 0; i < sizeof...(Types); ++i)
-    {
-        switch (i)
-        {
-            VARIANT_CASE(0)
-            VARIANT_CASE(1)
-            VARIANT_CASE(2)
-            VARIANT_CASE(3)
-            VARIANT_CASE(4)
-            VARIANT_CASE(5)
-            VARIANT_CASE(6)
-            VARIANT_CASE(7)
-            VARIANT_CASE(8)
-            VARIANT_CASE(9)
-            VARIANT_CASE(10)
-            VARIANT_CASE(11)
-            VARIANT_CASE(12)
-        };
-    }
+    if (index < Table::SIZE)
+        return Table::DECODERS[index](xjson);
 
     qWarning() << "Unknown type:" << type;
     return {};
 }
 
 template<typename... Types>
-std::variant<typename Types::SharedPtr...> XJsonObject::getRequiredVariant(const QString& key) const
+std::variant<typename Types::SharedPtr...> XJsonObject::getRequiredVariant(QAnyStringView key) const
 {
-    auto v = toVariant<Types...>(getRequiredJsonObject(key));
+    auto v = toVariant<Types...>(XJsonObject(getField(key, QJsonValue::Object)));
 
     if (isNullVariant(v))
-        qWarning() << "Unknown type for key:" << key;
+        qWarning() << "Unknown type for key:" << key.toString();
 
     return v;
 }
 
 template<typename... Types>
-std::optional<std::variant<typename Types::SharedPtr...>> XJsonObject::getOptionalVariant(const QString& key) const
+std::optional<std::variant<typename Types::SharedPtr...>> XJsonObject::getOptionalVariant(QAnyStringView key) const
 {
-    if (!mObject.contains(key))
+    if (!has(key))
         return {};
 
     auto v = getRequiredVariant<Types...>(key);
@@ -314,30 +506,28 @@ std::optional<std::variant<typename Types::SharedPtr...>> XJsonObject::getOption
 }
 
 template<typename... Types>
-std::vector<std::variant<typename Types::SharedPtr...>> XJsonObject::getRequiredVariantList(const QString& key) const
+std::vector<std::variant<typename Types::SharedPtr...>> XJsonObject::getRequiredVariantList(QAnyStringView key) const
 {
     std::vector<std::variant<typename Types::SharedPtr...>> variantList;
-    const auto& arrayJson = getRequiredArray(key);
+    const XJsonValue arrayJson = getField(key, QJsonValue::Array);
 
-    for (const auto& arrayElem : arrayJson)
-    {
+    arrayJson.forEachElement([key, &variantList](const XJsonValue& arrayElem){
         if (!arrayElem.isObject())
-            throw InvalidJsonException("Invalid array element: " + key);
+            throw InvalidJsonException("Invalid array element: " + key.toString());
 
-        const auto itemJson = arrayElem.toObject();
-        auto item = XJsonObject::toVariant<Types...>(itemJson);
+        auto item = toVariant<Types...>(XJsonObject(arrayElem));
 
         if (!isNullVariant(item))
             variantList.push_back(std::move(item));
-    }
+    });
 
     return variantList;
 }
 
 template<typename... Types>
-std::vector<std::variant<typename Types::SharedPtr...>> XJsonObject::getOptionalVariantList(const QString& key) const
+std::vector<std::variant<typename Types::SharedPtr...>> XJsonObject::getOptionalVariantList(QAnyStringView key) const
 {
-    if (mObject.contains(key))
+    if (has(key))
         return getRequiredVariantList<Types...>(key);
 
     return {};
@@ -6,19 +6,24 @@ namespace Xrpc {
 
 using namespace std::chrono_literals;
 
-static QNetworkAccessManager* makeNetwork(int networkTransferTimeoutMs, QObject* parent)
+static NetworkEngine::SharedPtr makeEngine(NetworkEngine::SharedPtr engine)
 {
-    auto* network = new QNetworkAccessManager(parent);
-    network->setAutoDeleteReplies(true);
-    network->setTransferTimeout(networkTransferTimeoutMs);
-    return network;
+    if (engine)
+        return engine;
+
+    return NetworkEngine::getDefault();
 }
 
-Client::Client(const QString& host, int networkTransferTimeoutMs, const QString& pdsDpopNonce) :
-    mNetwork(makeNetwork(networkTransferTimeoutMs, this)),
-    mPlcDirectoryClient(mNetwork.get()),
-    mIdentityResolver(mNetwork.get()),
-    mNetworkThread(new NetworkThread(networkTransferTimeoutMs, pdsDpopNonce))
+Client::Client(const QString& host, int networkTransferTimeoutMs, const QString& pdsDpopNonce,
+               NetworkEngine::SharedPtr engine) :
+    mEngine(makeEngine(std::move(engine))),
+    mPlcDirectoryClient(mEngine->getMainNetwork()),
+    mIdentityResolver(mEngine->getMainNetwork(), mEngine),
+    mShard(mEngine->selectShard(host)),
+    mNetworkThread(new NetworkThread(mEngine->getNetwork(mShard), mEngine->getDecodePool(), mEngine->getScheduler(mShard),
+                                     mEngine->getMetrics(), mEngine->getTlsSessionStore(),
+                                     mEngine->getConnectionWarmer(mShard), mEngine->getHttp2Watchdog(mShard),
+                                     networkTransferTimeoutMs, pdsDpopNonce))
 {
     qDebug() << "Host:" << host;
     qDebug() << "Network transfer timeout:" << networkTransferTimeoutMs;
@@ -27,181 +32,197 @@ Client::Client(const QString& host, int networkTransferTimeoutMs, const QString&
     qDebug() << "OpenSSL lib build:" << QSslSocket::sslLibraryBuildVersionString();
 
     if (!host.isEmpty())
-    {
         setPDS(host, "");
-        mNetworkThread->setPDS(mPDS);
-    }
 
-    if (mNetworkThread->moveToThread(mNetworkThread.get()))
-        qDebug() << "Moved network thread";
-    else
-        qWarning() << "Failed to move network thread";
+    mEngine->attach(mShard, mNetworkThread);
+    qDebug() << "Thread:" << QThread::currentThreadId() << "shard:" << mShard;
 
-    qDebug() << "Thread:" << QThread::currentThreadId();
+    // The connection warmer must only be used from the thread of the shard. The PDS
+    // gets set there before any request is handled.
+    if (!mPDS.isEmpty())
+    {
+        QMetaObject::invokeMethod(mNetworkThread,
+            [networkThread=mNetworkThread, pds=mPDS]{ networkThread->setPDS(pds); }, Qt::QueuedConnection);
+    }
 
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessJson, this, &Client::doCallback<NetworkThread::SuccessJsonCb, QJsonDocument>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessJson, this, &Client::doCallback<NetworkThread::SuccessJsonCb, QJsonDocument>);
 
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessBytes, this,
+    connect(mNetworkThread, &NetworkThread::requestSuccessBytes, this,
         [](QByteArray bytes, NetworkThread::SuccessBytesCb cb, QString contentType) {
             cb(std::move(bytes), std::move(contentType));
         });
 
+    connect(mNetworkThread, &NetworkThread::requestSuccessStream, this,
+        [](qint64 size, QString contentType, NetworkThread::SuccessStreamCb cb) {
+            cb(size, std::move(contentType));
+        });
+
+    connect(mNetworkThread, &NetworkThread::requestProgress, this,
+        [](qint64 bytesReceived, qint64 bytesTotal, StreamTarget::ProgressCb cb) {
+            cb(bytesReceived, bytesTotal);
+        });
+
     // com.atproto.server
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessSession, this, &Client::doCallback<NetworkThread::SuccessSessionCb, ATProto::ComATProtoServer::Session::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetSessionOutput, this, &Client::doCallback<NetworkThread::SuccessGetSessionOutputCb, ATProto::ComATProtoServer::GetSessionOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetServiceAuthOutput, this, &Client::doCallback<NetworkThread::SuccessGetServiceAuthOutputCb, ATProto::ComATProtoServer::GetServiceAuthOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessSession, this, &Client::doCallback<NetworkThread::SuccessSessionCb, ATProto::ComATProtoServer::Session::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetSessionOutput, this, &Client::doCallback<NetworkThread::SuccessGetSessionOutputCb, ATProto::ComATProtoServer::GetSessionOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetServiceAuthOutput, this, &Client::doCallback<NetworkThread::SuccessGetServiceAuthOutputCb, ATProto::ComATProtoServer::GetServiceAuthOutput::SharedPtr>);
 
     // com.atproto.identity
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessResolveHandleOutput, this, &Client::doCallback<NetworkThread::SuccessResolveHandleOutputCb, ATProto::ComATProtoIdentity::ResolveHandleOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessResolveHandleOutput, this, &Client::doCallback<NetworkThread::SuccessResolveHandleOutputCb, ATProto::ComATProtoIdentity::ResolveHandleOutput::SharedPtr>);
 
     // app.bsky.actor
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessProfileViewDetailed, this, &Client::doCallback<NetworkThread::SuccessProfileViewDetailedCb, ATProto::AppBskyActor::ProfileViewDetailed::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetProfilesOutput, this, &Client::doCallback<NetworkThread::SuccessGetProfilesOutputCb, ATProto::AppBskyActor::GetProfilesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessGetPreferencesOutputCb, ATProto::AppBskyActor::GetPreferencesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessSearchActorsOutput, this, &Client::doCallback<NetworkThread::SuccessSearchActorsOutputCb, ATProto::AppBskyActor::SearchActorsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessSearchActorsTypeaheadOutput, this, &Client::doCallback<NetworkThread::SuccessSearchActorsTypeaheadOutputCb, ATProto::AppBskyActor::SearchActorsTypeaheadOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetSuggestionsOutput, this, &Client::doCallback<NetworkThread::SuccessGetSuggestionsOutputCb, ATProto::AppBskyActor::GetSuggestionsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetSuggestedFollowsByActor, this, &Client::doCallback<NetworkThread::SuccessGetSuggestedFollowsByActorCb, ATProto::AppBskyActor::GetSuggestedFollowsByActor::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessProfileViewDetailed, this, &Client::doCallback<NetworkThread::SuccessProfileViewDetailedCb, ATProto::AppBskyActor::ProfileViewDetailed::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetProfilesOutput, this, &Client::doCallback<NetworkThread::SuccessGetProfilesOutputCb, ATProto::AppBskyActor::GetProfilesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessGetPreferencesOutputCb, ATProto::AppBskyActor::GetPreferencesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessSearchActorsOutput, this, &Client::doCallback<NetworkThread::SuccessSearchActorsOutputCb, ATProto::AppBskyActor::SearchActorsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessSearchActorsTypeaheadOutput, this, &Client::doCallback<NetworkThread::SuccessSearchActorsTypeaheadOutputCb, ATProto::AppBskyActor::SearchActorsTypeaheadOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetSuggestionsOutput, this, &Client::doCallback<NetworkThread::SuccessGetSuggestionsOutputCb, ATProto::AppBskyActor::GetSuggestionsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetSuggestedFollowsByActor, this, &Client::doCallback<NetworkThread::SuccessGetSuggestedFollowsByActorCb, ATProto::AppBskyActor::GetSuggestedFollowsByActor::SharedPtr>);
 
     // app.bsky.bookmark
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetBookmarksOutput, this, &Client::doCallback<NetworkThread::SuccessGetBookmarksOutputCb, ATProto::AppBskyBookmark::GetBookmarksOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetBookmarksOutput, this, &Client::doCallback<NetworkThread::SuccessGetBookmarksOutputCb, ATProto::AppBskyBookmark::GetBookmarksOutput::SharedPtr>);
 
     // app.bsky.labeler
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetServicesOutput, this, &Client::doCallback<NetworkThread::SuccessGetServicesOutputCb, ATProto::AppBskyLabeler::GetServicesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetServicesOutput, this, &Client::doCallback<NetworkThread::SuccessGetServicesOutputCb, ATProto::AppBskyLabeler::GetServicesOutput::SharedPtr>);
 
     // app.bsky.embed
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetEmbedExternalViewOutput, this, &Client::doCallback<NetworkThread::SuccessGetEmbedExternalViewOutputCb, ATProto::AppBskyEmbed::GetEmbedExternalViewOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetEmbedExternalViewOutput, this, &Client::doCallback<NetworkThread::SuccessGetEmbedExternalViewOutputCb, ATProto::AppBskyEmbed::GetEmbedExternalViewOutput::SharedPtr>);
 
     // app.bsky.feed
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessOutputFeed, this, &Client::doCallback<NetworkThread::SuccessOutputFeedCb, ATProto::AppBskyFeed::OutputFeed::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetFeedGeneratorOutput, this, &Client::doCallback<NetworkThread::SuccessGetFeedGeneratorOutputCb, ATProto::AppBskyFeed::GetFeedGeneratorOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetFeedGeneratorsOutput, this, &Client::doCallback<NetworkThread::SuccessGetFeedGeneratorsOutputCb, ATProto::AppBskyFeed::GetFeedGeneratorsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetActorFeedsOutput, this, &Client::doCallback<NetworkThread::SuccessGetActorFeedsOutputCb, ATProto::AppBskyFeed::GetActorFeedsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessPostThread, this, &Client::doCallback<NetworkThread::SuccessPostThreadCb, ATProto::AppBskyFeed::PostThread::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetPostsOutput, this, &Client::doCallback<NetworkThread::SuccessGetPostsOutputCb, ATProto::AppBskyFeed::GetPostsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetQuotesOutput, this, &Client::doCallback<NetworkThread::SuccessGetQuotesOutputCb, ATProto::AppBskyFeed::GetQuotesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessSearchPostsOutput, this, &Client::doCallback<NetworkThread::SuccessSearchPostsOutputCb, ATProto::AppBskyFeed::SearchPostsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessSearchPostsV2Output, this, &Client::doCallback<NetworkThread::SuccessSearchPostsV2OutputCb, ATProto::AppBskyFeed::SearchPostsV2Output::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetLikesOutput, this, &Client::doCallback<NetworkThread::SuccessGetLikesOutputCb, ATProto::AppBskyFeed::GetLikesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetRepostedByOutput, this, &Client::doCallback<NetworkThread::SuccessGetRepostedByOutputCb, ATProto::AppBskyFeed::GetRepostedByOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessOutputFeed, this, &Client::doCallback<NetworkThread::SuccessOutputFeedCb, ATProto::AppBskyFeed::OutputFeed::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetFeedGeneratorOutput, this, &Client::doCallback<NetworkThread::SuccessGetFeedGeneratorOutputCb, ATProto::AppBskyFeed::GetFeedGeneratorOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetFeedGeneratorsOutput, this, &Client::doCallback<NetworkThread::SuccessGetFeedGeneratorsOutputCb, ATProto::AppBskyFeed::GetFeedGeneratorsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetActorFeedsOutput, this, &Client::doCallback<NetworkThread::SuccessGetActorFeedsOutputCb, ATProto::AppBskyFeed::GetActorFeedsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessPostThread, this, &Client::doCallback<NetworkThread::SuccessPostThreadCb, ATProto::AppBskyFeed::PostThread::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetPostsOutput, this, &Client::doCallback<NetworkThread::SuccessGetPostsOutputCb, ATProto::AppBskyFeed::GetPostsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetQuotesOutput, this, &Client::doCallback<NetworkThread::SuccessGetQuotesOutputCb, ATProto::AppBskyFeed::GetQuotesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessSearchPostsOutput, this, &Client::doCallback<NetworkThread::SuccessSearchPostsOutputCb, ATProto::AppBskyFeed::SearchPostsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessSearchPostsV2Output, this, &Client::doCallback<NetworkThread::SuccessSearchPostsV2OutputCb, ATProto::AppBskyFeed::SearchPostsV2Output::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetLikesOutput, this, &Client::doCallback<NetworkThread::SuccessGetLikesOutputCb, ATProto::AppBskyFeed::GetLikesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetRepostedByOutput, this, &Client::doCallback<NetworkThread::SuccessGetRepostedByOutputCb, ATProto::AppBskyFeed::GetRepostedByOutput::SharedPtr>);
 
     // app.bsky.draft
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetDraftsOutput, this, &Client::doCallback<NetworkThread::SuccessGetDraftsOutputCb, ATProto::AppBskyDraft::GetDraftsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetDraftsOutput, this, &Client::doCallback<NetworkThread::SuccessGetDraftsOutputCb, ATProto::AppBskyDraft::GetDraftsOutput::SharedPtr>);
 
     // app.bsky.graph
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetFollowsOutput, this, &Client::doCallback<NetworkThread::SuccessGetFollowsOutputCb, ATProto::AppBskyGraph::GetFollowsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetFollowersOutput, this, &Client::doCallback<NetworkThread::SuccessGetFollowersOutputCb, ATProto::AppBskyGraph::GetFollowersOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetBlocksOutput, this, &Client::doCallback<NetworkThread::SuccessGetBlocksOutputCb, ATProto::AppBskyGraph::GetBlocksOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetMutesOutput, this, &Client::doCallback<NetworkThread::SuccessGetMutesOutputCb, ATProto::AppBskyGraph::GetMutesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetListOutput, this, &Client::doCallback<NetworkThread::SuccessGetListOutputCb, ATProto::AppBskyGraph::GetListOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetListsOutput, this, &Client::doCallback<NetworkThread::SuccessGetListsOutputCb, ATProto::AppBskyGraph::GetListsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetListsWithMembershipOutput, this, &Client::doCallback<NetworkThread::SuccessGetListsWithMembershipOutputCb, ATProto::AppBskyGraph::GetListsWithMembershipOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetStarterPackOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPackOutputCb, ATProto::AppBskyGraph::GetStarterPackOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetStarterPacksOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPacksOutputCb, ATProto::AppBskyGraph::GetStarterPacksOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetStarterPacksWithMembershipOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPacksWithMembershipOutputCb, ATProto::AppBskyGraph::GetStarterPacksWithMembershipOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetFollowsOutput, this, &Client::doCallback<NetworkThread::SuccessGetFollowsOutputCb, ATProto::AppBskyGraph::GetFollowsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetFollowersOutput, this, &Client::doCallback<NetworkThread::SuccessGetFollowersOutputCb, ATProto::AppBskyGraph::GetFollowersOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetBlocksOutput, this, &Client::doCallback<NetworkThread::SuccessGetBlocksOutputCb, ATProto::AppBskyGraph::GetBlocksOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetMutesOutput, this, &Client::doCallback<NetworkThread::SuccessGetMutesOutputCb, ATProto::AppBskyGraph::GetMutesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetListOutput, this, &Client::doCallback<NetworkThread::SuccessGetListOutputCb, ATProto::AppBskyGraph::GetListOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetListsOutput, this, &Client::doCallback<NetworkThread::SuccessGetListsOutputCb, ATProto::AppBskyGraph::GetListsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetListsWithMembershipOutput, this, &Client::doCallback<NetworkThread::SuccessGetListsWithMembershipOutputCb, ATProto::AppBskyGraph::GetListsWithMembershipOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetStarterPackOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPackOutputCb, ATProto::AppBskyGraph::GetStarterPackOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetStarterPacksOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPacksOutputCb, ATProto::AppBskyGraph::GetStarterPacksOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetStarterPacksWithMembershipOutput, this, &Client::doCallback<NetworkThread::SuccessGetStarterPacksWithMembershipOutputCb, ATProto::AppBskyGraph::GetStarterPacksWithMembershipOutput::SharedPtr>);
 
     // app.bsky.notification
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessListNotificationsOutput, this, &Client::doCallback<NetworkThread::SuccessListNotificationsOutputCb, ATProto::AppBskyNotification::ListNotificationsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetNotificationPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessGetNotificationPreferencesOutputCb, ATProto::AppBskyNotification::GetPreferencesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessListActivitySubscriptionsOutput, this, &Client::doCallback<NetworkThread::SuccessListActivitySubscriptionsOutputCb, ATProto::AppBskyNotification::ListActivitySubscriptionsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessListNotificationsOutput, this, &Client::doCallback<NetworkThread::SuccessListNotificationsOutputCb, ATProto::AppBskyNotification::ListNotificationsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetNotificationPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessGetNotificationPreferencesOutputCb, ATProto::AppBskyNotification::GetPreferencesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessListActivitySubscriptionsOutput, this, &Client::doCallback<NetworkThread::SuccessListActivitySubscriptionsOutputCb, ATProto::AppBskyNotification::ListActivitySubscriptionsOutput::SharedPtr>);
 
     // app.bsky.unspecced
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetSuggestedStarterPacks, this, &Client::doCallback<NetworkThread::SuccessGetSuggestedStarterPacksCb, ATProto::AppBskyUnspecced::GetSuggestedStarterPacksOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetTrends, this, &Client::doCallback<NetworkThread::SuccessGetTrendsCb, ATProto::AppBskyUnspecced::GetTrendsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetSuggestedStarterPacks, this, &Client::doCallback<NetworkThread::SuccessGetSuggestedStarterPacksCb, ATProto::AppBskyUnspecced::GetSuggestedStarterPacksOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetTrends, this, &Client::doCallback<NetworkThread::SuccessGetTrendsCb, ATProto::AppBskyUnspecced::GetTrendsOutput::SharedPtr>);
 
     // app.bsky.video
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessJobStatusOutput, this, &Client::doCallback<NetworkThread::SuccessJobStatusOutputCb, ATProto::AppBskyVideo::JobStatusOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetUploadLimitsOutput, this, &Client::doCallback<NetworkThread::SuccessGetUploadLimitsOutputCb, ATProto::AppBskyVideo::GetUploadLimitsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessJobStatusOutput, this, &Client::doCallback<NetworkThread::SuccessJobStatusOutputCb, ATProto::AppBskyVideo::JobStatusOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetUploadLimitsOutput, this, &Client::doCallback<NetworkThread::SuccessGetUploadLimitsOutputCb, ATProto::AppBskyVideo::GetUploadLimitsOutput::SharedPtr>);
 
     // chat.bsky.convo
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetConvoMembersOutput, this, &Client::doCallback<NetworkThread::SuccessGetConvoMembersOutputCb, ATProto::ChatBskyConvo::GetConvoMembersOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessGetMessagesOutput, this, &Client::doCallback<NetworkThread::SuccessGetMessagesOutputCb, ATProto::ChatBskyConvo::GetMessagesOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessConvoUnreadCountsOutput, this, &Client::doCallback<NetworkThread::SuccessConvoUnreadCountsOutputCb, ATProto::ChatBskyConvo::ConvoUnreadCountsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessConvoListOutput, this, &Client::doCallback<NetworkThread::SuccessConvoListOutputCb, ATProto::ChatBskyConvo::ConvoListOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessConvoRequestListOutput, this, &Client::doCallback<NetworkThread::SuccessConvoRequestListOutputCb, ATProto::ChatBskyConvo::ConvoRequestListOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessConvoOutput, this, &Client::doCallback<NetworkThread::SuccessConvoOutputCb, ATProto::ChatBskyConvo::ConvoOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetConvoMembersOutput, this, &Client::doCallback<NetworkThread::SuccessGetConvoMembersOutputCb, ATProto::ChatBskyConvo::GetConvoMembersOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessGetMessagesOutput, this, &Client::doCallback<NetworkThread::SuccessGetMessagesOutputCb, ATProto::ChatBskyConvo::GetMessagesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessConvoUnreadCountsOutput, this, &Client::doCallback<NetworkThread::SuccessConvoUnreadCountsOutputCb, ATProto::ChatBskyConvo::ConvoUnreadCountsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessConvoListOutput, this, &Client::doCallback<NetworkThread::SuccessConvoListOutputCb, ATProto::ChatBskyConvo::ConvoListOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessConvoRequestListOutput, this, &Client::doCallback<NetworkThread::SuccessConvoRequestListOutputCb, ATProto::ChatBskyConvo::ConvoRequestListOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessConvoOutput, this, &Client::doCallback<NetworkThread::SuccessConvoOutputCb, ATProto::ChatBskyConvo::ConvoOutput::SharedPtr>);
 
     // chat.bsky.group
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessJoinLinkPreviewsOutput, this, &Client::doCallback<NetworkThread::SuccessJoinLinkPreviewsOutputCb, ATProto::ChatBskyGroup::JoinLinkPreviewsOutput::SharedPtr>);
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessJoinRequestsOutput, this, &Client::doCallback<NetworkThread::SuccessJoinRequestsOutputCb, ATProto::ChatBskyGroup::JoinRequestsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessJoinLinkPreviewsOutput, this, &Client::doCallback<NetworkThread::SuccessJoinLinkPreviewsOutputCb, ATProto::ChatBskyGroup::JoinLinkPreviewsOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessJoinRequestsOutput, this, &Client::doCallback<NetworkThread::SuccessJoinRequestsOutputCb, ATProto::ChatBskyGroup::JoinRequestsOutput::SharedPtr>);
 
     // chat.bsky.notification
-    connect(mNetworkThread.get(), &NetworkThread::requestSuccessChatNotificationPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessChatNotificationPreferencesOutputCb, ATProto::ChatBskyNotification::GetPreferencesOutput::SharedPtr>);
+    connect(mNetworkThread, &NetworkThread::requestSuccessChatNotificationPreferencesOutput, this, &Client::doCallback<NetworkThread::SuccessChatNotificationPreferencesOutputCb, ATProto::ChatBskyNotification::GetPreferencesOutput::SharedPtr>);
 
     // oauth
-    connect(mNetworkThread.get(), &NetworkThread::oauthLoginRedirect, this,
+    connect(mNetworkThread, &NetworkThread::oauthLoginRedirect, this,
         [](QUrl url, QString alias, NetworkThread::OAuthLoginSuccessCb cb){ cb(std::move(url), std::move(alias)); });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthLoginFailed, this,
+    connect(mNetworkThread, &NetworkThread::oauthLoginFailed, this,
         [](QString error, QString msg, NetworkThread::OAuthErrorCb cb){ cb(std::move(error), std::move(msg)); });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthRequestInitialTokenSuccess, this,
+    connect(mNetworkThread, &NetworkThread::oauthRequestInitialTokenSuccess, this,
         [](QString did, QString scope, QString accessToken, QString refreshToken, NetworkThread::OAuthInitalTokenSuccessCb cb){
             cb(std::move(did), std::move(scope), std::move(accessToken), std::move(refreshToken));
         });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthRequestInitialTokenFailed, this,
+    connect(mNetworkThread, &NetworkThread::oauthRequestInitialTokenFailed, this,
         [](QString error, QString msg, NetworkThread::OAuthErrorCb cb){ cb(std::move(error), std::move(msg)); });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthRefreshTokenSucces, this,
+    connect(mNetworkThread, &NetworkThread::oauthRefreshTokenSucces, this,
         [](QString accessToken, QString refreshToken, NetworkThread::OAuthRefreshTokenSuccessCb cb){
             cb(std::move(accessToken), std::move(refreshToken));
         });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthRefreshTokenFailed, this,
+    connect(mNetworkThread, &NetworkThread::oauthRefreshTokenFailed, this,
         [](QString error, QString msg, NetworkThread::OAuthErrorCb cb){ cb(std::move(error), std::move(msg)); });
 
-    connect(mNetworkThread.get(), &NetworkThread::oauthLoggedOut, this,
+    connect(mNetworkThread, &NetworkThread::oauthLoggedOut, this,
         [](NetworkThread::OAuthLogoutSuccessCb cb){ cb(); });
 
-    connect(mNetworkThread.get(), &NetworkThread::pdsDpopNonceChanged, this, &Client::pdsDpopNonceChanged);
-    connect(mNetworkThread.get(), &NetworkThread::authDpopNonceChanged, this, &Client::authDpopNonceChanged);
+    connect(mNetworkThread, &NetworkThread::pdsDpopNonceChanged, this, &Client::pdsDpopNonceChanged);
+    connect(mNetworkThread, &NetworkThread::authDpopNonceChanged, this, &Client::authDpopNonceChanged);
+    connect(mNetworkThread, &NetworkThread::tokenRefreshNeeded, this, [this]{ refreshToken(); });
 
     // errors
-    connect(mNetworkThread.get(), &NetworkThread::requestError, this,
+    connect(mNetworkThread, &NetworkThread::requestError, this,
         [](QString error, QJsonDocument json, NetworkThread::ErrorCb cb) {
             cb(std::move(error), std::move(json));
         });
 
-    connect(mNetworkThread.get(), &NetworkThread::requestInvalidJsonError, this,
+    connect(mNetworkThread, &NetworkThread::requestInvalidJsonError, this,
         [](QString error, NetworkThread::ErrorCb cb) {
             auto json = QJsonDocument::fromJson("{}");
             cb(std::move(error), std::move(json));
         });
 
-    connect(this, &Client::postDataToNetwork, mNetworkThread.get(), &NetworkThread::postData, Qt::QueuedConnection);
-    connect(this, &Client::postJsonToNetwork, mNetworkThread.get(), &NetworkThread::postJson, Qt::QueuedConnection);
-    connect(this, &Client::getToNetwork, mNetworkThread.get(), &NetworkThread::get, Qt::QueuedConnection);
-    connect(this, &Client::pdsChanged, mNetworkThread.get(), &NetworkThread::setPDS, Qt::QueuedConnection);
-    connect(this, &Client::oauthDisabled, mNetworkThread.get(), &NetworkThread::disableOAuth, Qt::QueuedConnection);
-    connect(this, &Client::dpopNoncesChanged, mNetworkThread.get(), &NetworkThread::setDpopNonces, Qt::QueuedConnection);
-    connect(this, &Client::userAgentChanged, mNetworkThread.get(), &NetworkThread::setUserAgent, Qt::QueuedConnection);
-    connect(this, &Client::videoHostChanged, mNetworkThread.get(), &NetworkThread::setVideoHost, Qt::QueuedConnection);
-    connect(this, &Client::oauthNewTokensCbChanged, mNetworkThread.get(), &NetworkThread::setOAuthNewTokensCb, Qt::QueuedConnection);
-
-    connect(this, &Client::oauthLogin, mNetworkThread.get(), &NetworkThread::oauthLogin, Qt::QueuedConnection);
-    connect(this, &Client::oauthRequestInitialToken, mNetworkThread.get(), &NetworkThread::oauthRequestInitialToken, Qt::QueuedConnection);
-    connect(this, &Client::oauthRefreshToken, mNetworkThread.get(), &NetworkThread::oauthRefreshToken, Qt::QueuedConnection);
-    connect(this, &Client::oauthResumeSession, mNetworkThread.get(), &NetworkThread::oauthResumeSession, Qt::QueuedConnection);
-    connect(this, &Client::oauthLogout, mNetworkThread.get(), &NetworkThread::oauthLogout, Qt::QueuedConnection);
+    connect(this, &Client::postDataToNetwork, mNetworkThread, &NetworkThread::postData, Qt::QueuedConnection);
+    connect(this, &Client::postJsonToNetwork, mNetworkThread, &NetworkThread::postJson, Qt::QueuedConnection);
+    connect(this, &Client::getToNetwork, mNetworkThread, &NetworkThread::get, Qt::QueuedConnection);
+    connect(this, &Client::getStreamToNetwork, mNetworkThread, &NetworkThread::getStream, Qt::QueuedConnection);
+    connect(this, &Client::pdsChanged, mNetworkThread, &NetworkThread::setPDS, Qt::QueuedConnection);
+    connect(this, &Client::oauthDisabled, mNetworkThread, &NetworkThread::disableOAuth, Qt::QueuedConnection);
+    connect(this, &Client::dpopNoncesChanged, mNetworkThread, &NetworkThread::setDpopNonces, Qt::QueuedConnection);
+    connect(this, &Client::userAgentChanged, mNetworkThread, &NetworkThread::setUserAgent, Qt::QueuedConnection);
+    connect(this, &Client::videoHostChanged, mNetworkThread, &NetworkThread::setVideoHost, Qt::QueuedConnection);
+    connect(this, &Client::oauthNewTokensCbChanged, mNetworkThread, &NetworkThread::setOAuthNewTokensCb, Qt::QueuedConnection);
+    connect(this, &Client::tokenRefreshEnabled, mNetworkThread, &NetworkThread::enableTokenRefresh, Qt::QueuedConnection);
+    connect(this, &Client::tokenRefreshFinished, mNetworkThread, &NetworkThread::finishTokenRefresh, Qt::QueuedConnection);
+    connect(this, &Client::responseCacheEnabled, mNetworkThread, &NetworkThread::enableResponseCache, Qt::QueuedConnection);
+    connect(this, &Client::responseCachePolicyChanged, mNetworkThread, &NetworkThread::setResponseCachePolicy, Qt::QueuedConnection);
+    connect(this, &Client::responseCacheCleared, mNetworkThread, &NetworkThread::clearResponseCache, Qt::QueuedConnection);
+    connect(this, &Client::arenaDecodingEnabled, mNetworkThread, &NetworkThread::enableArenaDecoding, Qt::QueuedConnection);
+    connect(this, &Client::lazyPostDecodingEnabled, mNetworkThread, &NetworkThread::enableLazyPostDecoding, Qt::QueuedConnection);
+
+    connect(this, &Client::oauthLogin, mNetworkThread, &NetworkThread::oauthLogin, Qt::QueuedConnection);
+    connect(this, &Client::oauthRequestInitialToken, mNetworkThread, &NetworkThread::oauthRequestInitialToken, Qt::QueuedConnection);
+    connect(this, &Client::oauthRefreshToken, mNetworkThread, &NetworkThread::oauthRefreshToken, Qt::QueuedConnection);
+    connect(this, &Client::oauthResumeSession, mNetworkThread, &NetworkThread::oauthResumeSession, Qt::QueuedConnection);
+    connect(this, &Client::oauthLogout, mNetworkThread, &NetworkThread::oauthLogout, Qt::QueuedConnection);
 
 #if defined(Q_OS_ANDROID) && defined(USE_ANDROID_KEYSTORE)
-    connect(this, &Client::oauthSetDpopKeyAlias, mNetworkThread.get(), &NetworkThread::oauthSetDpopKeyAlias, Qt::QueuedConnection);
+    connect(this, &Client::oauthSetDpopKeyAlias, mNetworkThread, &NetworkThread::oauthSetDpopKeyAlias, Qt::QueuedConnection);
 #else
-    connect(this, &Client::oauthSaveDpopKey, mNetworkThread.get(), &NetworkThread::oauthSaveDpopKey, Qt::QueuedConnection);
-    connect(this, &Client::oauthLoadDpopKey, mNetworkThread.get(), &NetworkThread::oauthLoadDpopKey, Qt::QueuedConnection);
+    connect(this, &Client::oauthSaveDpopKey, mNetworkThread, &NetworkThread::oauthSaveDpopKey, Qt::QueuedConnection);
+    connect(this, &Client::oauthLoadDpopKey, mNetworkThread, &NetworkThread::oauthLoadDpopKey, Qt::QueuedConnection);
 #endif
-
-    qDebug() << "Start network thread";
-    mNetworkThread->start();
 }
 
 Client::~Client()
 {
     qDebug() << "Destroy client";
-    mNetworkThread->exit();
-    mNetworkThread->wait(1000);
-    qDebug() << "XRPC network thread stopped";
+    mEngine->detach(mShard, mNetworkThread);
+    qDebug() << "XRPC network client detached";
 }
 
 template<typename CallbackType, typename ArgType>
@@ -227,6 +248,52 @@ void Client::setOAuthNewTokensCb(const NetworkThread::NewTokensCb& cb)
     emit oauthNewTokensCbChanged(cb);
 }
 
+void Client::setTokenRefreshCb(const TokenRefreshCb& cb)
+{
+    mTokenRefreshCb = cb;
+    emit tokenRefreshEnabled(bool(cb));
+}
+
+void Client::refreshToken()
+{
+    if (!mTokenRefreshCb)
+    {
+        qWarning() << "No token refresh callback";
+        emit tokenRefreshFinished({});
+        return;
+    }
+
+    mTokenRefreshCb([this, presence=getPresence()](const QString& accessJwt){
+        if (presence)
+            emit tokenRefreshFinished(accessJwt);
+    });
+}
+
+void Client::enableResponseCache(bool enable)
+{
+    emit responseCacheEnabled(enable);
+}
+
+void Client::setResponseCachePolicy(const QString& nsid, const ResponseCache::Policy& policy)
+{
+    emit responseCachePolicyChanged(nsid, policy);
+}
+
+void Client::clearResponseCache()
+{
+    emit responseCacheCleared();
+}
+
+void Client::enableArenaDecoding(bool enable)
+{
+    emit arenaDecodingEnabled(enable);
+}
+
+void Client::enableLazyPostDecoding(bool enable)
+{
+    emit lazyPostDecodingEnabled(enable);
+}
+
 void Client::enableOAuth(bool enable)
 {
     mOAuthEnabled = enable;
@@ -247,9 +314,50 @@ void Client::setPDS(const QString& pds, const QString& did)
     else
         mPDS = "https://" + pds;
 
+    // Cached replies contain viewer state of the account.
+    if (!mDid.isEmpty() && did != mDid)
+        clearResponseCache();
+
     mDid = did;
     qDebug() << "PDS:" << mPDS << "DID:" << did;
     emit pdsChanged(mPDS);
+    moveToPdsShard();
+}
+
+void Client::moveToPdsShard(int attempt)
+{
+    const int shard = mEngine->selectShard(mPDS);
+
+    if (shard == mShard)
+        return;
+
+    auto* networkThread = mNetworkThread;
+    auto* engine = mEngine.get();
+
+    const bool moved = mEngine->reattach(mShard, shard, mNetworkThread,
+        [networkThread, engine, shard]{
+            if (!networkThread->canMoveShard())
+                return false;
+
+            networkThread->setShard(engine->getNetwork(shard), engine->getScheduler(shard),
+                                    engine->getConnectionWarmer(shard), engine->getHttp2Watchdog(shard));
+            return true;
+        });
+
+    if (moved)
+    {
+        qDebug() << "PDS:" << mPDS << "moved from shard:" << mShard << "to:" << shard;
+        mShard = shard;
+        return;
+    }
+
+    if (attempt >= MAX_MOVE_SHARD_ATTEMPTS)
+    {
+        qDebug() << "Requests in flight, PDS:" << mPDS << "stays on shard:" << mShard;
+        return;
+    }
+
+    QTimer::singleShot(MOVE_SHARD_RETRY, this, [this, attempt]{ moveToPdsShard(attempt + 1); });
 }
 
 void Client::setPDSFromSession(const ATProto::ComATProtoServer::Session& session)
@@ -340,33 +448,133 @@ void Client::setPDSFromHandle(const QString& handle, const SetPdsSuccessCb& succ
         });
 }
 
-void Client::post(const QString& service, const QJsonDocument& json, const NetworkThread::Params& rawHeaders,
-                  const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-                  const QString& accessJwt, bool isServiceAuthToken)
+Client::PriorityScope::PriorityScope(Client& client, RequestPriority priority) :
+    mClient(client),
+    mPreviousPriority(client.mPriority)
+{
+    mClient.mPriority = priority;
+}
+
+Client::PriorityScope::~PriorityScope()
+{
+    mClient.mPriority = mPreviousPriority;
+}
+
+Client::DeadlineScope::DeadlineScope(Client& client, std::chrono::milliseconds budget) :
+    mClient(client),
+    mPreviousBudget(client.mDeadlineBudget)
+{
+    mClient.mDeadlineBudget = budget;
+}
+
+Client::DeadlineScope::~DeadlineScope()
+{
+    mClient.mDeadlineBudget = mPreviousBudget;
+}
+
+QDeadlineTimer Client::makeDeadline() const
+{
+    if (!mDeadlineBudget)
+        return QDeadlineTimer::Forever;
+
+    return QDeadlineTimer(*mDeadlineBudget);
+}
+
+static NetworkThread::CallbackType guardCallback(const NetworkThread::CallbackType& successCb, const RequestHandle& handle)
+{
+    return std::visit(
+        [handle](const auto& cb) -> NetworkThread::CallbackType {
+            using T = std::decay_t<decltype(cb)>;
+
+            if (!cb)
+                return T{};
+
+            return T([handle, cb](auto&&... args){
+                if (!handle.isCancelled())
+                    cb(std::forward<decltype(args)>(args)...);
+            });
+        },
+        successCb
+    );
+}
+
+static NetworkThread::ErrorCb guardErrorCallback(const NetworkThread::ErrorCb& errorCb, const RequestHandle& handle)
+{
+    return [handle, errorCb](const QString& err, const QJsonDocument& json){
+        if (!handle.isCancelled())
+            errorCb(err, json);
+    };
+}
+
+RequestHandle Client::post(const QString& service, const QJsonDocument& json, const NetworkThread::Params& rawHeaders,
+                           const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
+                           const QString& accessJwt, bool isServiceAuthToken)
 {
     Q_ASSERT(!service.isEmpty());
     Q_ASSERT(errorCb);
-    emit postJsonToNetwork(service, json, rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken);
+    const auto handle = RequestHandle::create();
+    emit postJsonToNetwork(service, json, rawHeaders, guardCallback(successCb, handle),
+                           guardErrorCallback(errorCb, handle), accessJwt, isServiceAuthToken, handle, mPriority, makeDeadline());
+    return handle;
 }
 
-void Client::post(const QString& service, const NetworkThread::Params& params, const NetworkThread::DataType& data,
-                  const QString& mimeType, const NetworkThread::Params& rawHeaders,
-                  const NetworkThread::SuccessJsonCb& successCb, const NetworkThread::ErrorCb& errorCb,
-                  const QString& accessJwt, bool isServiceAuthToken)
+RequestHandle Client::post(const QString& service, const NetworkThread::Params& params, const NetworkThread::DataType& data,
+                           const QString& mimeType, const NetworkThread::Params& rawHeaders,
+                           const NetworkThread::SuccessJsonCb& successCb, const NetworkThread::ErrorCb& errorCb,
+                           const QString& accessJwt, bool isServiceAuthToken)
 {
     Q_ASSERT(!service.isEmpty());
     Q_ASSERT(successCb);
     Q_ASSERT(errorCb);
-    emit postDataToNetwork(service, params, data, mimeType, rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken);
+    const auto handle = RequestHandle::create();
+    const NetworkThread::SuccessJsonCb guardedCb = [handle, successCb](const QJsonDocument& json){
+        if (!handle.isCancelled())
+            successCb(json);
+    };
+
+    emit postDataToNetwork(service, params, data, mimeType, rawHeaders, guardedCb,
+                           guardErrorCallback(errorCb, handle), accessJwt, isServiceAuthToken, handle, mPriority, makeDeadline());
+    return handle;
 }
 
-void Client::get(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
-                 const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-                 const QString& accessJwt, bool isServiceAuthToken, const QString& pds)
+RequestHandle Client::get(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
+                          const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
+                          const QString& accessJwt, bool isServiceAuthToken, const QString& pds)
 {
     Q_ASSERT(!service.isEmpty());
     Q_ASSERT(errorCb);
-    emit getToNetwork(service, params, rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken, pds);
+    const auto handle = RequestHandle::create();
+    emit getToNetwork(service, params, rawHeaders, guardCallback(successCb, handle),
+                      guardErrorCallback(errorCb, handle), accessJwt, isServiceAuthToken, pds, handle, mPriority, makeDeadline());
+    return handle;
+}
+
+RequestHandle Client::getStream(const QString& service, const NetworkThread::Params& params,
+                                const StreamTarget::SharedPtr& target, const NetworkThread::SuccessStreamCb& successCb,
+                                const StreamTarget::ProgressCb& progressCb, const NetworkThread::ErrorCb& errorCb,
+                                const QString& accessJwt, const QString& pds)
+{
+    Q_ASSERT(!service.isEmpty());
+    Q_ASSERT(target);
+    Q_ASSERT(errorCb);
+    const auto handle = RequestHandle::create();
+
+    if (progressCb)
+    {
+        target->setProgressCb([handle, progressCb](qint64 bytesReceived, qint64 bytesTotal){
+            if (!handle.isCancelled())
+                progressCb(bytesReceived, bytesTotal);
+        });
+    }
+
+    const NetworkThread::SuccessStreamCb guardedCb = [handle, successCb](qint64 size, const QString& contentType){
+        if (!handle.isCancelled() && successCb)
+            successCb(size, contentType);
+    };
+
+    emit getStreamToNetwork(service, params, {}, target, guardedCb, guardErrorCallback(errorCb, handle),
+                            accessJwt, pds, handle, mPriority, makeDeadline());
+    return handle;
 }
 
 }
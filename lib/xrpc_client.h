@@ -5,6 +5,7 @@
 #include "oauth.h"
 #include "plc_directory_client.h"
 #include "presence.h"
+#include "xrpc_network_engine.h"
 #include "xrpc_network_thread.h"
 #include "lexicon/com_atproto_server.h"
 #include <QJsonDocument>
@@ -21,16 +22,60 @@ public:
     using Ptr = std::unique_ptr<Client>;
     using SetPdsSuccessCb = std::function<void()>;
     using SetPdsErrorCb = std::function<void(const QString& error)>;
-
-    static constexpr int DEFAULT_TIMEOUT_MS = 10000;
+    using TokenRefreshDoneCb = std::function<void(const QString& accessJwt)>; // empty on failure
+    using TokenRefreshCb = std::function<void(const TokenRefreshDoneCb& doneCb)>;
+
+    static constexpr int DEFAULT_TIMEOUT_MS = NetworkEngine::DEFAULT_TIMEOUT_MS;
+    static constexpr std::chrono::seconds MOVE_SHARD_RETRY{1};
+    static constexpr int MAX_MOVE_SHARD_ATTEMPTS = 10;
+
+    // Requests sent while the scope exists get the priority. Requests get normal
+    // priority by default.
+    class PriorityScope
+    {
+    public:
+        PriorityScope(Client& client, RequestPriority priority);
+        ~PriorityScope();
+
+        PriorityScope(const PriorityScope&) = delete;
+        PriorityScope& operator=(const PriorityScope&) = delete;
+
+    private:
+        Client& mClient;
+        RequestPriority mPreviousPriority;
+    };
+
+    // Each request sent while the scope exists must complete within the budget,
+    // including resends. Otherwise it fails with XRPC_TIMEOUT. Requests have no
+    // deadline by default.
+    class DeadlineScope
+    {
+    public:
+        DeadlineScope(Client& client, std::chrono::milliseconds budget);
+        ~DeadlineScope();
+
+        DeadlineScope(const DeadlineScope&) = delete;
+        DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    private:
+        Client& mClient;
+        std::optional<std::chrono::milliseconds> mPreviousBudget;
+    };
 
     // Host can be set as first point of contact for a new account.
     // If handle to DID resolution via DNS fails, then createSession will be sent to host.
     // pdsDpopNonce is the last received nonce from previous session (OPTIONAL)
-    explicit Client(const QString& host = {}, int networkTransferTimeoutMs = DEFAULT_TIMEOUT_MS, const QString& pdsDpopNonce = {});
+    // Clients for multiple accounts should share an engine. Without an engine the client
+    // uses NetworkEngine::getDefault(), which is shared by all clients created without one.
+    explicit Client(const QString& host = {}, int networkTransferTimeoutMs = DEFAULT_TIMEOUT_MS, const QString& pdsDpopNonce = {},
+                    NetworkEngine::SharedPtr engine = nullptr);
 
     ~Client();
 
+    const NetworkEngine::SharedPtr& getNetworkEngine() const { return mEngine; }
+    NetworkThread::CoalesceStats getCoalesceStats() const { return mNetworkThread->getCoalesceStats(); }
+    int getDpopNonceRotationCount() const { return mNetworkThread->getDpopNonceRotationCount(); }
+    QHash<QString, ATProto::RateLimiter::BucketState> getRateLimitStates() const { return mNetworkThread->getRateLimitStates(); }
     ATProto::PlcDirectoryClient& getPlcDirectoryClient() { return mPlcDirectoryClient; }
     void setUserAgent(const QString& userAgent);
     const QString& getPDS() const { return mPDS; }
@@ -40,40 +85,90 @@ public:
     bool isOAuthEnabled() const { return mOAuthEnabled; }
     void setDpopNonces(const QString& pdsDpopNonce, const QString& authDpopNonce);
     void setVideoHost(const QString& host);
+
+    // Open a connection to a host ahead of requests, e.g. the appview of a service.
+    // The PDS and video host are warmed automatically.
+    void prewarm(const QString& host) { mEngine->prewarm(mShard, host); }
+
     void setOAuthNewTokensCb(const NetworkThread::NewTokensCb& cb);
 
+    // The callback is called when a request fails on an expired access token. It must
+    // refresh the session and call doneCb with the new access token. Requests with the
+    // expired token are held until then, such that there is only a single refresh.
+    void setTokenRefreshCb(const TokenRefreshCb& cb);
+
+    // Cache replies of read-only requests. Disabled by default. When enabled, the
+    // default policies from ResponseCache::defaultPolicies() are used for NSIDs that
+    // have no policy set.
+    void enableResponseCache(bool enable);
+    void setResponseCachePolicy(const QString& nsid, const ResponseCache::Policy& policy);
+    void clearResponseCache();
+
+    // Decode the object graph of each reply into a single memory arena. Disabled by default.
+    // All objects of a reply keep the arena alive, so memory of a reply is only released
+    // when none of its objects is referenced anymore.
+    void enableArenaDecoding(bool enable);
+
+    // Decode the record and embed of post views on first access. Disabled by default.
+    // When enabled, PostView::getRecord() and PostView::getEmbed() must be used.
+    void enableLazyPostDecoding(bool enable);
+
+    RequestPriority getPriority() const { return mPriority; }
+    std::optional<std::chrono::milliseconds> getDeadlineBudget() const { return mDeadlineBudget; }
+
     void setPDSFromSession(const ATProto::ComATProtoServer::Session& session);
     void setPDSFromDid(const QString& did, const SetPdsSuccessCb& successCb, const SetPdsErrorCb& errorCb);
     void setPDSFromHandle(const QString& handle, const SetPdsSuccessCb& successCb, const SetPdsErrorCb& errorCb);
 
-    void post(const QString& service, const QJsonDocument& json, const NetworkThread::Params& rawHeaders,
-              const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-              const QString& accessJwt = {}, bool isServiceAuthToken = false);
-    void post(const QString& service, const NetworkThread::Params& params, const NetworkThread::DataType& data,
-              const QString& mimeType, const NetworkThread::Params& rawHeaders,
-              const NetworkThread::SuccessJsonCb& successCb, const NetworkThread::ErrorCb& errorCb,
-              const QString& accessJwt, bool isServiceAuthToken = false);
-    void get(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
-             const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-             const QString& accessJwt = {}, bool isServiceAuthToken = false, const QString& pds = {});
+    // The returned handle cancels the request. After cancellation no callbacks get called.
+    RequestHandle post(const QString& service, const QJsonDocument& json, const NetworkThread::Params& rawHeaders,
+                       const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
+                       const QString& accessJwt = {}, bool isServiceAuthToken = false);
+    RequestHandle post(const QString& service, const NetworkThread::Params& params, const NetworkThread::DataType& data,
+                       const QString& mimeType, const NetworkThread::Params& rawHeaders,
+                       const NetworkThread::SuccessJsonCb& successCb, const NetworkThread::ErrorCb& errorCb,
+                       const QString& accessJwt, bool isServiceAuthToken = false);
+    RequestHandle get(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
+                      const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
+                      const QString& accessJwt = {}, bool isServiceAuthToken = false, const QString& pds = {});
+
+    // Writes the reply to the target as it arrives instead of buffering it.
+    RequestHandle getStream(const QString& service, const NetworkThread::Params& params,
+                            const StreamTarget::SharedPtr& target, const NetworkThread::SuccessStreamCb& successCb,
+                            const StreamTarget::ProgressCb& progressCb, const NetworkThread::ErrorCb& errorCb,
+                            const QString& accessJwt = {}, const QString& pds = {});
 
 signals:
     // Internal use
     void postDataToNetwork(const QString& service, const NetworkThread::Params& params, const NetworkThread::DataType& data, const QString& mimeType, const NetworkThread::Params& rawHeaders,
                            const NetworkThread::SuccessJsonCb& successCb, const NetworkThread::ErrorCb& errorCb,
-                           const QString& accessJwt, bool isServiceAuthToken);
+                           const QString& accessJwt, bool isServiceAuthToken, const RequestHandle& handle,
+                           RequestPriority priority, const QDeadlineTimer& deadline);
     void postJsonToNetwork(const QString& service, const QJsonDocument& json, const NetworkThread::Params& rawHeaders,
                            const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-                           const QString& accessJwt, bool isServiceAuthToken);
+                           const QString& accessJwt, bool isServiceAuthToken, const RequestHandle& handle,
+                           RequestPriority priority, const QDeadlineTimer& deadline);
     void getToNetwork(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
                       const NetworkThread::CallbackType& successCb, const NetworkThread::ErrorCb& errorCb,
-                      const QString& accessJwt, bool isServiceAuthToken, const QString& pds);
+                      const QString& accessJwt, bool isServiceAuthToken, const QString& pds, const RequestHandle& handle,
+                      RequestPriority priority, const QDeadlineTimer& deadline);
+    void getStreamToNetwork(const QString& service, const NetworkThread::Params& params, const NetworkThread::Params& rawHeaders,
+                            const StreamTarget::SharedPtr& target, const NetworkThread::SuccessStreamCb& successCb,
+                            const NetworkThread::ErrorCb& errorCb, const QString& accessJwt, const QString& pds,
+                            const RequestHandle& handle, RequestPriority priority, const QDeadlineTimer& deadline);
     void pdsChanged(const QString& pds);
     void oauthDisabled();
     void dpopNoncesChanged(const QString& pdsDpopNonce, const QString& authDpopNonce);
     void userAgentChanged(const QString& userAgent);
     void videoHostChanged(const QString& host);
     void oauthNewTokensCbChanged(const NetworkThread::NewTokensCb& cb);
+    void tokenRefreshEnabled(bool enable);
+    void tokenRefreshFinished(const QString& accessJwt);
+    void responseCacheEnabled(bool enable);
+    void responseCachePolicyChanged(const QString& nsid, const ResponseCache::Policy& policy);
+    void responseCacheCleared();
+    void arenaDecodingEnabled(bool enable);
+    void lazyPostDecodingEnabled(bool enable);
 
     void oauthLogin(const QString& user, const QString& clientId, const QString& redirectUrl, const QStringList& scope,
                     const NetworkThread::OAuthLoginSuccessCb& successCb, const NetworkThread::OAuthErrorCb);
@@ -103,13 +198,24 @@ private:
     template<typename CallbackType, typename ArgType>
     void doCallback(ArgType arg, CallbackType cb);
 
+    QDeadlineTimer makeDeadline() const;
+    void refreshToken();
+
+    // Moves the network thread to the shard of the PDS host. While it has requests in
+    // flight it cannot be moved, then the move is retried a few times.
+    void moveToPdsShard(int attempt = 1);
+
     QString mPDS;
     QString mDid; // PDS is set for this DID
     bool mOAuthEnabled = false;
-    std::unique_ptr<QNetworkAccessManager> mNetwork;
+    RequestPriority mPriority = RequestPriority::NORMAL;
+    std::optional<std::chrono::milliseconds> mDeadlineBudget;
+    TokenRefreshCb mTokenRefreshCb;
+    NetworkEngine::SharedPtr mEngine;
     ATProto::PlcDirectoryClient mPlcDirectoryClient;
     ATProto::IdentityResolver mIdentityResolver;
-    std::unique_ptr<NetworkThread> mNetworkThread;
+    int mShard;
+    NetworkThread* mNetworkThread; // lives on the shard thread, deleted via the engine
 };
 
 }
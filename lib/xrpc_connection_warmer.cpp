@@ -0,0 +1,114 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_connection_warmer.h"
+#include <QSslConfiguration>
+
+namespace Xrpc {
+
+static bool elapsedAtLeast(const QElapsedTimer& timer, std::chrono::milliseconds duration)
+{
+    return timer.elapsed() >= duration.count();
+}
+
+ConnectionWarmer::ConnectionWarmer(QNetworkAccessManager* network, const TlsSessionStore* tlsSessionStore, QObject* parent) :
+    QObject(parent),
+    mNetwork(network),
+    mTlsSessionStore(tlsSessionStore),
+    mRewarmTimer(this) // child, such that it moves along to the network thread
+{
+    Q_ASSERT(mNetwork);
+    mRewarmTimer.setInterval(CHECK_INTERVAL);
+    connect(&mRewarmTimer, &QTimer::timeout, this, [this]{ rewarmIdle(); });
+}
+
+ConnectionWarmer::Host* ConnectionWarmer::getHost(const QUrl& url)
+{
+    if (url.host().isEmpty() || url.scheme() != "https")
+        return nullptr;
+
+    const quint16 port = (quint16)url.port(443);
+    const QString key = url.host() + ':' + QString::number(port);
+    auto it = mHosts.find(key);
+
+    if (it == mHosts.end())
+    {
+        it = mHosts.emplace(key, Host{}).first;
+        it->second.mName = url.host();
+        it->second.mPort = port;
+    }
+
+    return &it->second;
+}
+
+void ConnectionWarmer::warm(const QString& host)
+{
+    auto* h = getHost(host.contains("://") ? QUrl(host) : QUrl("https://" + host));
+
+    if (!h)
+    {
+        qDebug() << "Cannot warm:" << host;
+        return;
+    }
+
+    if (h->mLastActivity.isValid() && !elapsedAtLeast(h->mLastActivity, MIN_WARM_INTERVAL))
+        return;
+
+    connectToHost(*h);
+}
+
+void ConnectionWarmer::used(const QUrl& url)
+{
+    auto* h = getHost(url);
+
+    if (!h)
+        return;
+
+    h->mLastUsed.start();
+    h->mLastActivity.start();
+
+    if (!mRewarmTimer.isActive())
+        mRewarmTimer.start();
+}
+
+void ConnectionWarmer::connectToHost(Host& host)
+{
+    // The connection is reused by requests allowing HTTP/2 only if HTTP/2 is negotiated.
+    auto sslConfig = QSslConfiguration::defaultConfiguration();
+    sslConfig.setAllowedNextProtocols({ QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1 });
+
+    if (mTlsSessionStore)
+        mTlsSessionStore->apply(host.mName, host.mPort, sslConfig);
+
+    qDebug() << "Warm connection:" << host.mName << host.mPort;
+    mNetwork->connectToHostEncrypted(host.mName, host.mPort, sslConfig);
+    host.mLastActivity.start();
+    ++mWarmCount;
+}
+
+void ConnectionWarmer::rewarmIdle()
+{
+    bool keepWarm = false;
+
+    for (auto it = mHosts.begin(); it != mHosts.end(); )
+    {
+        auto& host = it->second;
+
+        if (!host.mLastUsed.isValid() || elapsedAtLeast(host.mLastUsed, KEEP_WARM))
+        {
+            it = mHosts.erase(it);
+            continue;
+        }
+
+        keepWarm = true;
+
+        if (elapsedAtLeast(host.mLastActivity, IDLE_REWARM))
+            connectToHost(host);
+
+        ++it;
+    }
+
+    if (!keepWarm)
+        mRewarmTimer.stop();
+}
+
+}
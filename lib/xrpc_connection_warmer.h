@@ -0,0 +1,60 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "xrpc_tls_session_store.h"
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QUrl>
+#include <chrono>
+#include <unordered_map>
+
+namespace Xrpc {
+
+// Opens encrypted connections to a host ahead of the first request, such that the
+// request does not pay for the DNS lookup, TCP and TLS handshakes.
+// Servers close idle connections. Connections to hosts that have been used recently
+// get re-warmed when they have been idle for too long.
+// Must be used on the thread of the network access manager.
+class ConnectionWarmer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::chrono::seconds MIN_WARM_INTERVAL{10};
+    static constexpr std::chrono::seconds IDLE_REWARM{60};
+    static constexpr std::chrono::minutes KEEP_WARM{10}; // after the last request
+    static constexpr std::chrono::seconds CHECK_INTERVAL{15};
+
+    explicit ConnectionWarmer(QNetworkAccessManager* network, const TlsSessionStore* tlsSessionStore = nullptr,
+                              QObject* parent = nullptr);
+
+    // The host can be a host name or URL, e.g. "https://bsky.social"
+    void warm(const QString& host);
+
+    // Records a request to the host of the URL, such that its connection will be kept warm.
+    void used(const QUrl& url);
+
+    int getWarmCount() const { return mWarmCount; }
+
+private:
+    struct Host
+    {
+        QString mName;
+        quint16 mPort = 443;
+        QElapsedTimer mLastUsed;
+        QElapsedTimer mLastActivity; // request or warm-up
+    };
+
+    Host* getHost(const QUrl& url);
+    void connectToHost(Host& host);
+    void rewarmIdle();
+
+    QNetworkAccessManager* mNetwork;
+    const TlsSessionStore* mTlsSessionStore;
+    std::unordered_map<QString, Host> mHosts;
+    QTimer mRewarmTimer;
+    int mWarmCount = 0;
+};
+
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_decode_pool.h"
+#include <QDebug>
+#include <QThread>
+
+namespace Xrpc {
+
+static constexpr int MAX_DECODE_THREADS = 4;
+static constexpr int DECODE_THREAD_EXPIRY_MS = 30'000;
+
+DecodePool::TaskGroup::TaskGroup(DecodePool& pool) :
+    mPool(pool)
+{
+}
+
+DecodePool::TaskGroup::~TaskGroup()
+{
+    waitForDone();
+}
+
+void DecodePool::TaskGroup::decode(Task task)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        ++mPending;
+    }
+
+    // The token is released when the task has run, or when the pool drops it
+    // without running it.
+    std::shared_ptr<void> token(nullptr, [this](void*){ taskReleased(); });
+    mPool.decode([task=std::move(task), token=std::move(token)]{ task(); });
+}
+
+void DecodePool::TaskGroup::waitForDone()
+{
+    QMutexLocker locker(&mMutex);
+
+    while (mPending > 0)
+        mDone.wait(&mMutex);
+}
+
+void DecodePool::TaskGroup::taskReleased()
+{
+    QMutexLocker locker(&mMutex);
+    Q_ASSERT(mPending > 0);
+
+    if (--mPending == 0)
+        mDone.wakeAll();
+}
+
+DecodePool::DecodePool(int maxThreads, const QString& name)
+{
+    mPool.setObjectName(name);
+    mPool.setMaxThreadCount(std::max(1, maxThreads));
+    mPool.setExpiryTimeout(DECODE_THREAD_EXPIRY_MS);
+    qDebug() << name << "threads:" << mPool.maxThreadCount();
+}
+
+DecodePool::~DecodePool()
+{
+    shutdown();
+}
+
+int DecodePool::defaultThreadCount()
+{
+    // Leave a core for the GUI and network thread.
+    return std::clamp(QThread::idealThreadCount() - 1, 1, MAX_DECODE_THREADS);
+}
+
+void DecodePool::decode(Task task)
+{
+    mPool.start(std::move(task));
+}
+
+void DecodePool::shutdown()
+{
+    mPool.clear();
+    mPool.waitForDone();
+}
+
+}
@@ -0,0 +1,57 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <functional>
+
+namespace Xrpc {
+
+// Decoding a large reply, e.g. a feed with 100 posts or a deep post thread, takes
+// tens of milliseconds on a phone. The decoding is done on this pool, such that
+// the network thread is free to handle I/O for other requests.
+class DecodePool
+{
+public:
+    using Task = std::function<void()>;
+
+    // Tracks the tasks of a single owner on a shared pool, such that the owner
+    // can wait for its own tasks before it gets destroyed.
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(DecodePool& pool);
+        ~TaskGroup();
+
+        void decode(Task task);
+        void waitForDone();
+
+    private:
+        void taskReleased();
+
+        DecodePool& mPool;
+        QMutex mMutex;
+        QWaitCondition mDone;
+        int mPending = 0;
+    };
+
+    explicit DecodePool(int maxThreads = defaultThreadCount(), const QString& name = "XrpcDecodePool");
+    ~DecodePool();
+
+    void decode(Task task);
+
+    // Cancels all tasks not started yet and waits for the running tasks to finish.
+    void shutdown();
+
+    int maxThreadCount() const { return mPool.maxThreadCount(); }
+    int activeThreadCount() const { return mPool.activeThreadCount(); }
+    bool waitForDone(int msecs = -1) { return mPool.waitForDone(msecs); }
+
+    static int defaultThreadCount();
+
+private:
+    QThreadPool mPool;
+};
+
+}
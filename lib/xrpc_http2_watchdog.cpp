@@ -0,0 +1,201 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_http2_watchdog.h"
+#include <algorithm>
+
+namespace Xrpc {
+
+Http2Watchdog::Http2Watchdog(QObject* parent) :
+    QObject(parent),
+    mCheckTimer(this) // child, such that it moves along to the network thread
+{
+    mCheckTimer.setInterval(CHECK_INTERVAL);
+    connect(&mCheckTimer, &QTimer::timeout, this, [this]{ checkStalls(); });
+}
+
+QString Http2Watchdog::makeKey(const QUrl& url)
+{
+    return url.host() + ':' + QString::number(url.port(443));
+}
+
+bool Http2Watchdog::isHttp2Allowed(const QUrl& url, Clock::time_point now) const
+{
+    const auto it = mHosts.find(makeKey(url));
+
+    if (it == mHosts.end() || !it->second.mFallbackStart)
+        return true;
+
+    return now - *it->second.mFallbackStart >= mHttp2RetryInterval;
+}
+
+void Http2Watchdog::prepare(QNetworkRequest& request, Clock::time_point now) const
+{
+    if (!isHttp2Allowed(request.url(), now))
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+}
+
+void Http2Watchdog::watch(QNetworkReply* reply, Clock::time_point now)
+{
+    Q_ASSERT(reply);
+    const QUrl url = reply->url();
+
+    if (url.scheme() != "https" || !reply->request().attribute(QNetworkRequest::Http2AllowedAttribute, true).toBool())
+        return;
+
+    const QString key = makeKey(url);
+    auto& host = mHosts[key];
+
+    if (host.mFallbackStart && isHttp2Allowed(url, now))
+    {
+        qDebug() << "Retry HTTP/2:" << key;
+        host.mFallbackStart.reset();
+    }
+
+    // A new request does not show progress on a connection that has requests in flight.
+    if (host.mReplies.isEmpty())
+        host.mLastProgress = now;
+
+    host.mReplies.insert(reply, {});
+
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, key, reply]{ metaDataChanged(key, reply); });
+    connect(reply, &QNetworkReply::downloadProgress, this,
+            [this, key, reply](qint64 bytesReceived, qint64 bytesTotal){ downloadProgress(key, reply, bytesReceived, bytesTotal); });
+    connect(reply, &QNetworkReply::uploadProgress, this,
+            [this, key, reply](qint64 bytesSent, qint64 bytesTotal){ uploadProgress(key, reply, bytesSent, bytesTotal); });
+    connect(reply, &QNetworkReply::finished, this, [this, key, reply]{ removeReply(key, reply); });
+    connect(reply, &QObject::destroyed, this, [this, key, reply]{ removeReply(key, reply); });
+
+    if (host.mUsesHttp2 && !mCheckTimer.isActive())
+        mCheckTimer.start();
+}
+
+bool Http2Watchdog::isStallAbort(const QNetworkReply* reply)
+{
+    return reply->property(STALL_ABORT_PROPERTY).toBool();
+}
+
+Http2Watchdog::Host* Http2Watchdog::getHost(const QString& key, QNetworkReply* reply)
+{
+    auto it = mHosts.find(key);
+
+    if (it == mHosts.end() || !it->second.mReplies.contains(reply))
+        return nullptr;
+
+    return &it->second;
+}
+
+void Http2Watchdog::progress(const QString& key, QNetworkReply* reply)
+{
+    auto* host = getHost(key, reply);
+
+    if (!host)
+        return;
+
+    host->mLastProgress = Clock::now();
+
+    if (!host->mUsesHttp2 && reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool())
+    {
+        qDebug() << "HTTP/2 used:" << key;
+        host->mUsesHttp2 = true;
+
+        if (!mCheckTimer.isActive())
+            mCheckTimer.start();
+    }
+}
+
+void Http2Watchdog::uploadProgress(const QString& key, QNetworkReply* reply, qint64 bytesSent, qint64 bytesTotal)
+{
+    progress(key, reply);
+
+    if (auto* host = getHost(key, reply))
+        host->mReplies[reply].mUploadOutstanding = bytesTotal < 0 || bytesSent < bytesTotal;
+}
+
+void Http2Watchdog::downloadProgress(const QString& key, QNetworkReply* reply, qint64 bytesReceived, qint64 bytesTotal)
+{
+    progress(key, reply);
+
+    // The total is unknown (-1) for a chunked reply.
+    if (auto* host = getHost(key, reply))
+        host->mReplies[reply].mDownloadOutstanding = bytesTotal < 0 || bytesReceived < bytesTotal;
+}
+
+void Http2Watchdog::metaDataChanged(const QString& key, QNetworkReply* reply)
+{
+    progress(key, reply);
+
+    // After the headers the body is expected, unless it is empty.
+    if (auto* host = getHost(key, reply))
+    {
+        const QVariant contentLength = reply->header(QNetworkRequest::ContentLengthHeader);
+        host->mReplies[reply].mDownloadOutstanding = !contentLength.isValid() || contentLength.toLongLong() > 0;
+    }
+}
+
+void Http2Watchdog::removeReply(const QString& key, QNetworkReply* reply)
+{
+    auto it = mHosts.find(key);
+
+    if (it != mHosts.end())
+        it->second.mReplies.remove(reply);
+}
+
+bool Http2Watchdog::Host::hasBytesOutstanding() const
+{
+    return std::any_of(mReplies.cbegin(), mReplies.cend(),
+        [](const ReplyState& state){ return state.mUploadOutstanding || state.mDownloadOutstanding; });
+}
+
+void Http2Watchdog::checkStalls(Clock::time_point now)
+{
+    bool watching = false;
+
+    for (auto& [key, host] : mHosts)
+    {
+        if (!host.mUsesHttp2 || host.mReplies.isEmpty())
+            continue;
+
+        const auto noProgress = now - host.mLastProgress;
+
+        if (noProgress >= mStallTimeout && host.hasBytesOutstanding())
+            handleStall(key, host, now, false);
+        else if (noProgress >= mWaitingStallTimeout && host.mReplies.size() >= MIN_STALLED_WAITING_REPLIES)
+            handleStall(key, host, now, true);
+        else
+            watching = true;
+    }
+
+    if (!watching)
+        mCheckTimer.stop();
+}
+
+void Http2Watchdog::handleStall(const QString& key, Host& host, Clock::time_point now, bool abortGetOnly)
+{
+    qWarning() << "HTTP/2 stalled:" << key << "requests:" << host.mReplies.size() << "waiting only:" << abortGetOnly
+               << "fall back to HTTP/1.1 for:" << mHttp2RetryInterval.count() << "ms";
+
+    ++mStallCount;
+    host.mFallbackStart = now;
+
+    // HTTP/2 must work again on this host before stalls are detected.
+    host.mUsesHttp2 = false;
+
+    // Aborted GET requests get resent by their client with HTTP/1.1. A POST that only
+    // waits may still get its reply, otherwise its transfer timeout ends it.
+    const auto replies = std::exchange(host.mReplies, {});
+
+    for (auto it = replies.cbegin(); it != replies.cend(); ++it)
+    {
+        auto* reply = it.key();
+
+        if (abortGetOnly && reply->operation() != QNetworkAccessManager::GetOperation)
+            continue;
+
+        reply->setProperty(STALL_ABORT_PROPERTY, true);
+        reply->abort();
+    }
+
+    emit stalled(key.section(':', 0, 0));
+}
+
+}
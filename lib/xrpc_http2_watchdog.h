@@ -0,0 +1,107 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QHash>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+
+namespace Xrpc {
+
+// Detects stalled HTTP/2 connections. All requests to a host are multiplexed on
+// a single HTTP/2 connection. When none of the requests to a host makes progress
+// for the stall timeout while a request has bytes outstanding, the connection is
+// considered stalled. The requests get aborted and requests to the host fall back
+// to HTTP/1.1 on new connections. HTTP/2 is tried again after the retry interval.
+//
+// Requests that only wait for their reply may just be slow on the server. Only when
+// multiple requests wait without progress for the much longer waiting stall timeout,
+// the connection is considered stalled. Then only the GET requests get aborted.
+//
+// Aborted GET requests are resent by their client. Aborted POST requests are not,
+// as the server may have processed them already (see isStallAbort).
+//
+// The stall timeout should be shorter than the transfer timeout of the requests.
+// When the waiting stall timeout is longer, waiting requests end on their transfer
+// timeout instead and HTTP/2 stays in use.
+// Must be used on the thread of the network access manager.
+class Http2Watchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_STALL_TIMEOUT{5000};
+    static constexpr std::chrono::milliseconds DEFAULT_WAITING_STALL_TIMEOUT{30000};
+    static constexpr std::chrono::minutes DEFAULT_HTTP2_RETRY_INTERVAL{60};
+    static constexpr std::chrono::milliseconds CHECK_INTERVAL{1000};
+    static constexpr int MIN_STALLED_WAITING_REPLIES = 2;
+
+    using Clock = std::chrono::steady_clock;
+
+    explicit Http2Watchdog(QObject* parent = nullptr);
+
+    void setStallTimeout(std::chrono::milliseconds timeout) { mStallTimeout = timeout; }
+    void setWaitingStallTimeout(std::chrono::milliseconds timeout) { mWaitingStallTimeout = timeout; }
+    void setHttp2RetryInterval(std::chrono::milliseconds interval) { mHttp2RetryInterval = interval; }
+
+    bool isHttp2Allowed(const QUrl& url, Clock::time_point now = Clock::now()) const;
+
+    // Disables HTTP/2 on the request if HTTP/2 stalled on its host.
+    void prepare(QNetworkRequest& request, Clock::time_point now = Clock::now()) const;
+
+    // Watches the progress of a reply. The reply gets aborted when the HTTP/2
+    // connection it uses stalls.
+    void watch(QNetworkReply* reply, Clock::time_point now = Clock::now());
+
+    // Aborts the replies on stalled connections. Called periodically while
+    // HTTP/2 replies are in flight.
+    void checkStalls(Clock::time_point now = Clock::now());
+
+    int getStallCount() const { return mStallCount; }
+
+    // Returns true if the reply got aborted because its connection stalled.
+    static bool isStallAbort(const QNetworkReply* reply);
+
+signals:
+    void stalled(const QString& host);
+
+private:
+    struct ReplyState
+    {
+        bool mUploadOutstanding = false;
+        bool mDownloadOutstanding = false;
+    };
+
+    struct Host
+    {
+        bool mUsesHttp2 = false; // known after the first reply
+        Clock::time_point mLastProgress;
+        std::optional<Clock::time_point> mFallbackStart; // set while falling back to HTTP/1.1
+        QHash<QNetworkReply*, ReplyState> mReplies;
+
+        bool hasBytesOutstanding() const;
+    };
+
+    static constexpr char const* STALL_ABORT_PROPERTY = "http2StallAbort";
+
+    static QString makeKey(const QUrl& url);
+    Host* getHost(const QString& key, QNetworkReply* reply);
+    void progress(const QString& key, QNetworkReply* reply);
+    void uploadProgress(const QString& key, QNetworkReply* reply, qint64 bytesSent, qint64 bytesTotal);
+    void downloadProgress(const QString& key, QNetworkReply* reply, qint64 bytesReceived, qint64 bytesTotal);
+    void metaDataChanged(const QString& key, QNetworkReply* reply);
+    void removeReply(const QString& key, QNetworkReply* reply);
+    void handleStall(const QString& key, Host& host, Clock::time_point now, bool abortGetOnly);
+
+    std::chrono::milliseconds mStallTimeout = DEFAULT_STALL_TIMEOUT;
+    std::chrono::milliseconds mWaitingStallTimeout = DEFAULT_WAITING_STALL_TIMEOUT;
+    std::chrono::milliseconds mHttp2RetryInterval = DEFAULT_HTTP2_RETRY_INTERVAL;
+    std::unordered_map<QString, Host> mHosts;
+    QTimer mCheckTimer;
+    int mStallCount = 0;
+};
+
+}
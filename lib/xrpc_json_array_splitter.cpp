@@ -0,0 +1,179 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_json_array_splitter.h"
+
+namespace Xrpc {
+
+// Depth inside the elements of the array: top level object = 1, array = 2
+static constexpr int ARRAY_DEPTH = 2;
+
+static bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+JsonArraySplitter::JsonArraySplitter(const QString& arrayKey) :
+    mArrayKey(arrayKey.toUtf8())
+{
+}
+
+void JsonArraySplitter::endElement(std::vector<QByteArray>& elements)
+{
+    elements.push_back(std::move(mElement));
+    mElement = {};
+    mInElement = false;
+    ++mElementCount;
+}
+
+void JsonArraySplitter::feed(const QByteArray& data, std::vector<QByteArray>& elements)
+{
+    const char* bytes = data.constData();
+    const qsizetype size = data.size();
+
+    // Start of the current element in data. Bytes of an element are copied in
+    // one go when the element ends or when the data ends.
+    qsizetype elementStart = mInElement ? 0 : -1;
+
+    auto finishElement = [&](qsizetype end){
+        mElement.append(bytes + elementStart, end - elementStart);
+        elementStart = -1;
+        endElement(elements);
+    };
+
+    for (qsizetype i = 0; i < size; ++i)
+    {
+        const char c = bytes[i];
+
+        if (mInString)
+        {
+            if (!mInElement)
+                mRemainder.append(c);
+
+            if (mEscape)
+            {
+                mEscape = false;
+            }
+            else if (c == '\\')
+            {
+                mEscape = true;
+                continue;
+            }
+            else if (c == '"')
+            {
+                mInString = false;
+                continue;
+            }
+
+            if (!mInElement && mDepth == 1)
+                mString.append(c);
+
+            continue;
+        }
+
+        if (mInElement)
+        {
+            switch (c)
+            {
+            case '"':
+                mInString = true;
+                break;
+            case '{':
+            case '[':
+                ++mDepth;
+                break;
+            case '}':
+            case ']':
+                if (mDepth == ARRAY_DEPTH)
+                {
+                    // The array closes after a scalar element.
+                    finishElement(i);
+                    break;
+                }
+
+                if (--mDepth == ARRAY_DEPTH)
+                    finishElement(i + 1);
+
+                continue;
+            case ',':
+                if (mDepth == ARRAY_DEPTH)
+                {
+                    finishElement(i);
+                    continue;
+                }
+
+                break;
+            default:
+                break;
+            }
+
+            if (mInElement)
+                continue;
+        }
+
+        if (mState == State::IN_ARRAY && mDepth == ARRAY_DEPTH)
+        {
+            if (c == ']')
+            {
+                mRemainder.append(c);
+                --mDepth;
+                mState = State::ARRAY_DONE;
+            }
+            else if (c != ',' && !isWhitespace(c))
+            {
+                mInElement = true;
+                elementStart = i;
+
+                if (c == '"')
+                    mInString = true;
+                else if (c == '{' || c == '[')
+                    ++mDepth;
+            }
+
+            continue;
+        }
+
+        mRemainder.append(c);
+
+        switch (c)
+        {
+        case '"':
+            mInString = true;
+
+            if (mDepth == 1)
+                mString.clear();
+
+            break;
+        case ':':
+            if (mDepth == 1)
+                mKeyMatched = (mString == mArrayKey);
+
+            break;
+        case ',':
+            if (mDepth == 1)
+                mKeyMatched = false;
+
+            break;
+        case '[':
+            ++mDepth;
+
+            if (mDepth == ARRAY_DEPTH && mKeyMatched && mState == State::BEFORE_ARRAY)
+                mState = State::IN_ARRAY;
+
+            break;
+        case '{':
+            ++mDepth;
+            break;
+        case '}':
+        case ']':
+            --mDepth;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (mInElement && elementStart >= 0)
+        mElement.append(bytes + elementStart, size - elementStart);
+}
+
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+namespace Xrpc {
+
+// Splits the elements of an array in a JSON object while the JSON is still arriving.
+// The array is the value of a key at the top level of the object, e.g. "feed" in
+// a getTimeline reply. Each element is returned as soon as it is complete, such that
+// it can be decoded while the rest is downloading.
+// The remainder is the object without the array elements, e.g. {"cursor":"x","feed":[]}
+//
+// The splitter only tracks the nesting of the JSON. The elements and the remainder
+// must be parsed to validate the JSON.
+class JsonArraySplitter
+{
+public:
+    explicit JsonArraySplitter(const QString& arrayKey);
+
+    // Appends the elements completed by the data to elements.
+    void feed(const QByteArray& data, std::vector<QByteArray>& elements);
+
+    const QByteArray& getRemainder() const { return mRemainder; }
+    QByteArray takeRemainder() { return std::move(mRemainder); }
+
+    // The number of elements returned so far.
+    int getElementCount() const { return mElementCount; }
+
+    // True when the array has been closed.
+    bool isArrayDone() const { return mState == State::ARRAY_DONE; }
+
+private:
+    enum class State
+    {
+        BEFORE_ARRAY,
+        IN_ARRAY,
+        ARRAY_DONE
+    };
+
+    void endElement(std::vector<QByteArray>& elements);
+
+    const QByteArray mArrayKey;
+    State mState = State::BEFORE_ARRAY;
+    int mDepth = 0;
+    bool mInString = false;
+    bool mEscape = false;
+
+    // Top level key tracking
+    QByteArray mString; // string being read at the top level
+    QByteArray mLastString;
+    bool mKeyMatched = false;
+
+    // Current array element
+    bool mInElement = false;
+    bool mScalarElement = false;
+    QByteArray mElement;
+    int mElementCount = 0;
+
+    QByteArray mRemainder;
+};
+
+}
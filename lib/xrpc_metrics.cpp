@@ -0,0 +1,240 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_metrics.h"
+#include <QTextStream>
+#include <algorithm>
+#include <tuple>
+
+namespace Xrpc {
+
+const std::vector<double> Metrics::LATENCY_BOUNDS_MS = {
+    5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000 };
+
+const std::vector<double> Metrics::DECODE_BOUNDS_MS = {
+    0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 1000 };
+
+const QString Metrics::Key::NON_XRPC_NSID = "non-xrpc";
+
+Metrics::Key Metrics::Key::fromUrl(const QUrl& url)
+{
+    static const QString XRPC_PATH = "/xrpc/";
+    const QString path = url.path();
+
+    if (!path.startsWith(XRPC_PATH))
+        return Key{ NON_XRPC_NSID, url.host() };
+
+    const QString nsid = path.sliced(XRPC_PATH.size());
+
+    if (nsid.isEmpty() || nsid.contains('/'))
+        return Key{ NON_XRPC_NSID, url.host() };
+
+    return Key{ nsid, url.host() };
+}
+
+Metrics::Histogram::Histogram(std::span<const double> bounds) :
+    mBounds(bounds),
+    mCounts(bounds.size() + 1, 0)
+{
+}
+
+void Metrics::Histogram::record(double value)
+{
+    const auto it = std::lower_bound(mBounds.begin(), mBounds.end(), value);
+    ++mCounts[it - mBounds.begin()];
+    ++mCount;
+    mSum += value;
+}
+
+double Metrics::Histogram::percentile(double p) const
+{
+    if (mCount == 0)
+        return 0.0;
+
+    const double target = std::clamp(p, 0.0, 1.0) * mCount;
+    qint64 cumulative = 0;
+
+    for (size_t i = 0; i < mCounts.size(); ++i)
+    {
+        const qint64 count = mCounts[i];
+
+        if (count == 0 || cumulative + count < target)
+        {
+            cumulative += count;
+            continue;
+        }
+
+        // Values in the overflow bucket are reported as the highest bound.
+        if (i == mBounds.size())
+            return mBounds.empty() ? 0.0 : mBounds.back();
+
+        const double lower = i > 0 ? mBounds[i - 1] : 0.0;
+        const double upper = mBounds[i];
+        return lower + (upper - lower) * (target - cumulative) / count;
+    }
+
+    return mBounds.empty() ? 0.0 : mBounds.back();
+}
+
+Metrics::Entry::Entry(const Key& key) :
+    mKey(key),
+    mLatencyMs(LATENCY_BOUNDS_MS),
+    mDecodeMs(DECODE_BOUNDS_MS)
+{
+}
+
+Metrics::Entry& Metrics::getEntry(const Key& key)
+{
+    const QString mapKey = key.mHost + '\n' + key.mNsid;
+    auto it = mEntries.find(mapKey);
+
+    if (it == mEntries.end())
+        it = mEntries.insert(mapKey, Entry(key));
+
+    return *it;
+}
+
+void Metrics::recordReply(const Key& key, std::chrono::milliseconds latency, qint64 requestBytes,
+                          qint64 responseBytes, bool error)
+{
+    QMutexLocker locker(&mMutex);
+    auto& entry = getEntry(key);
+    entry.mLatencyMs.record((double)latency.count());
+    ++entry.mRequests;
+    entry.mRequestBytes += requestBytes;
+    entry.mResponseBytes += responseBytes;
+
+    if (error)
+        ++entry.mErrors;
+}
+
+void Metrics::recordDecode(const Key& key, std::chrono::nanoseconds duration)
+{
+    QMutexLocker locker(&mMutex);
+    getEntry(key).mDecodeMs.record(duration.count() / 1e6);
+}
+
+void Metrics::recordRetry(const Key& key)
+{
+    QMutexLocker locker(&mMutex);
+    ++getEntry(key).mRetries;
+}
+
+void Metrics::recordDpopNonceResend(const Key& key)
+{
+    QMutexLocker locker(&mMutex);
+    ++getEntry(key).mDpopNonceResends;
+}
+
+void Metrics::recordTokenRefreshResend(const Key& key)
+{
+    QMutexLocker locker(&mMutex);
+    ++getEntry(key).mTokenRefreshResends;
+}
+
+Metrics::Snapshot Metrics::snapshot() const
+{
+    Snapshot result;
+
+    {
+        QMutexLocker locker(&mMutex);
+        result.reserve(mEntries.size());
+
+        for (const auto& entry : mEntries)
+            result.push_back(entry);
+    }
+
+    std::sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs){
+        return std::tie(lhs.mKey.mNsid, lhs.mKey.mHost) < std::tie(rhs.mKey.mNsid, rhs.mKey.mHost);
+    });
+
+    return result;
+}
+
+void Metrics::reset()
+{
+    QMutexLocker locker(&mMutex);
+    mEntries.clear();
+}
+
+static QString escapeLabel(QString value)
+{
+    value.replace('\\', "\\\\");
+    value.replace('"', "\\\"");
+    value.replace('\n', "\\n");
+    return value;
+}
+
+static QString labels(const Metrics::Key& key, const QString& extra = {})
+{
+    QString result = QString("nsid=\"%1\",host=\"%2\"").arg(escapeLabel(key.mNsid), escapeLabel(key.mHost));
+
+    if (!extra.isEmpty())
+        result += ',' + extra;
+
+    return '{' + result + '}';
+}
+
+// Prometheus convention is to use seconds as time unit.
+static void writeHistogram(QTextStream& out, const QString& name, const QString& help,
+                           const Metrics::Snapshot& entries, const Metrics::Histogram Metrics::Entry::*histogram)
+{
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << " histogram\n";
+
+    for (const auto& entry : entries)
+    {
+        const auto& hist = entry.*histogram;
+
+        if (hist.getCount() == 0)
+            continue;
+
+        const auto bounds = hist.getBounds();
+        const auto& counts = hist.getCounts();
+        qint64 cumulative = 0;
+
+        for (size_t i = 0; i < bounds.size(); ++i)
+        {
+            cumulative += counts[i];
+            const QString le = QString("le=\"%1\"").arg(bounds[i] / 1000.0);
+            out << name << "_bucket" << labels(entry.mKey, le) << ' ' << cumulative << '\n';
+        }
+
+        out << name << "_bucket" << labels(entry.mKey, "le=\"+Inf\"") << ' ' << hist.getCount() << '\n';
+        out << name << "_sum" << labels(entry.mKey) << ' ' << hist.getSum() / 1000.0 << '\n';
+        out << name << "_count" << labels(entry.mKey) << ' ' << hist.getCount() << '\n';
+    }
+}
+
+static void writeCounter(QTextStream& out, const QString& name, const QString& help,
+                         const Metrics::Snapshot& entries, qint64 Metrics::Entry::*counter)
+{
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << " counter\n";
+
+    for (const auto& entry : entries)
+        out << name << labels(entry.mKey) << ' ' << entry.*counter << '\n';
+}
+
+QString Metrics::toPrometheusText() const
+{
+    const auto entries = snapshot();
+    QString text;
+    QTextStream out(&text);
+
+    writeHistogram(out, "xrpc_request_duration_seconds", "Time from sending a request till its reply finished.",
+                   entries, &Entry::mLatencyMs);
+    writeHistogram(out, "xrpc_decode_duration_seconds", "Time to decode a reply.",
+                   entries, &Entry::mDecodeMs);
+    writeCounter(out, "xrpc_requests_total", "Finished requests.", entries, &Entry::mRequests);
+    writeCounter(out, "xrpc_errors_total", "Finished requests with an error.", entries, &Entry::mErrors);
+    writeCounter(out, "xrpc_request_bytes_total", "Bytes sent in request bodies.", entries, &Entry::mRequestBytes);
+    writeCounter(out, "xrpc_response_bytes_total", "Bytes received in reply bodies.", entries, &Entry::mResponseBytes);
+    writeCounter(out, "xrpc_retries_total", "Resends with backoff.", entries, &Entry::mRetries);
+    writeCounter(out, "xrpc_dpop_nonce_resends_total", "Resends with a new DPoP nonce.", entries, &Entry::mDpopNonceResends);
+    writeCounter(out, "xrpc_token_refresh_resends_total", "Resends with a refreshed access token.", entries, &Entry::mTokenRefreshResends);
+
+    out.flush();
+    return text;
+}
+
+}
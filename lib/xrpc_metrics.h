@@ -0,0 +1,101 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+#include <chrono>
+#include <span>
+#include <vector>
+
+namespace Xrpc {
+
+// Request metrics per NSID and host. Thread safe.
+// One registry is shared by all clients of a network engine.
+class Metrics
+{
+public:
+    struct Key
+    {
+        QString mNsid;
+        QString mHost;
+
+        // Label for all requests that are not XRPC calls. Using their paths would
+        // create a time series per path.
+        static const QString NON_XRPC_NSID;
+
+        // For XRPC URLs: https://host/xrpc/nsid
+        static Key fromUrl(const QUrl& url);
+    };
+
+    class Histogram
+    {
+    public:
+        explicit Histogram(std::span<const double> bounds);
+
+        void record(double value);
+
+        // Estimate of the p-th percentile (0.0 - 1.0) by linear interpolation
+        // within the bucket that holds the percentile.
+        double percentile(double p) const;
+
+        std::span<const double> getBounds() const { return mBounds; }
+        const std::vector<qint64>& getCounts() const { return mCounts; } // last count is the overflow bucket
+        qint64 getCount() const { return mCount; }
+        double getSum() const { return mSum; }
+
+    private:
+        std::span<const double> mBounds;
+        std::vector<qint64> mCounts;
+        qint64 mCount = 0;
+        double mSum = 0.0;
+    };
+
+    struct Entry
+    {
+        Key mKey;
+        Histogram mLatencyMs;
+        Histogram mDecodeMs;
+        qint64 mRequests = 0;
+        qint64 mErrors = 0;
+        qint64 mRequestBytes = 0;
+        qint64 mResponseBytes = 0;
+        qint64 mRetries = 0; // all resends
+        qint64 mDpopNonceResends = 0;
+        qint64 mTokenRefreshResends = 0;
+
+        explicit Entry(const Key& key);
+
+        double getLatencyP50() const { return mLatencyMs.percentile(0.50); }
+        double getLatencyP95() const { return mLatencyMs.percentile(0.95); }
+        double getLatencyP99() const { return mLatencyMs.percentile(0.99); }
+    };
+
+    using Snapshot = std::vector<Entry>;
+
+    static const std::vector<double> LATENCY_BOUNDS_MS;
+    static const std::vector<double> DECODE_BOUNDS_MS;
+
+    void recordReply(const Key& key, std::chrono::milliseconds latency, qint64 requestBytes,
+                     qint64 responseBytes, bool error);
+    void recordDecode(const Key& key, std::chrono::nanoseconds duration);
+    void recordRetry(const Key& key);
+    void recordDpopNonceResend(const Key& key);
+    void recordTokenRefreshResend(const Key& key);
+
+    // Copy of all entries sorted by NSID and host.
+    Snapshot snapshot() const;
+    void reset();
+
+    // Prometheus text exposition format
+    QString toPrometheusText() const;
+
+private:
+    Entry& getEntry(const Key& key);
+
+    mutable QMutex mMutex;
+    QHash<QString, Entry> mEntries;
+};
+
+}
@@ -0,0 +1,217 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_network_engine.h"
+#include <QDebug>
+#include <QUrl>
+
+namespace Xrpc {
+
+static constexpr int MAX_SHARDS = 4;
+
+static QNetworkAccessManager* makeNetwork(int networkTransferTimeoutMs)
+{
+    auto* network = new QNetworkAccessManager;
+    network->setAutoDeleteReplies(true);
+    network->setTransferTimeout(networkTransferTimeoutMs);
+    return network;
+}
+
+NetworkEngine::SharedPtr NetworkEngine::getDefault()
+{
+    static std::weak_ptr<NetworkEngine> sDefault;
+    auto engine = sDefault.lock();
+
+    if (!engine)
+    {
+        engine = std::make_shared<NetworkEngine>(defaultShardCount());
+        sDefault = engine;
+    }
+
+    return engine;
+}
+
+NetworkEngine::NetworkEngine(int shardCount, int networkTransferTimeoutMs) :
+    mMainNetwork(makeNetwork(networkTransferTimeoutMs))
+{
+    shardCount = std::clamp(shardCount, 1, MAX_SHARDS);
+    qDebug() << "Network engine shards:" << shardCount << "timeout:" << networkTransferTimeoutMs;
+    mShards.resize(shardCount);
+
+    for (int i = 0; i < shardCount; ++i)
+    {
+        auto& shard = mShards[i];
+        shard.mThread = std::make_unique<QThread>();
+        shard.mThread->setObjectName(QString("XrpcNetwork%1").arg(i));
+
+        shard.mNetwork = makeNetwork(networkTransferTimeoutMs);
+        shard.mNetwork->moveToThread(shard.mThread.get());
+        QObject::connect(shard.mThread.get(), &QThread::finished, shard.mNetwork, &QObject::deleteLater);
+        shard.mScheduler = std::make_unique<RequestScheduler>();
+
+        shard.mWarmer = new ConnectionWarmer(shard.mNetwork, &mTlsSessionStore);
+        shard.mWarmer->moveToThread(shard.mThread.get());
+        QObject::connect(shard.mThread.get(), &QThread::finished, shard.mWarmer, &QObject::deleteLater);
+
+        shard.mHttp2Watchdog = new Http2Watchdog;
+        shard.mHttp2Watchdog->moveToThread(shard.mThread.get());
+        QObject::connect(shard.mThread.get(), &QThread::finished, shard.mHttp2Watchdog, &QObject::deleteLater);
+
+        shard.mThread->start();
+    }
+}
+
+NetworkEngine::~NetworkEngine()
+{
+    qDebug() << "Destroy network engine";
+
+    for (auto& shard : mShards)
+    {
+        if (shard.mAttachedCount > 0)
+            qWarning() << "Objects still attached:" << shard.mThread->objectName() << shard.mAttachedCount;
+
+        shard.mThread->quit();
+        shard.mThread->wait();
+    }
+
+    mDecodePool.shutdown();
+    qDebug() << "Network engine stopped";
+}
+
+int NetworkEngine::defaultShardCount()
+{
+    return std::clamp(QThread::idealThreadCount() / 2, 1, MAX_SHARDS);
+}
+
+NetworkEngine::Shard& NetworkEngine::getShard(int shard)
+{
+    Q_ASSERT(shard >= 0 && shard < (int)mShards.size());
+    return mShards[shard];
+}
+
+const NetworkEngine::Shard& NetworkEngine::getShard(int shard) const
+{
+    Q_ASSERT(shard >= 0 && shard < (int)mShards.size());
+    return mShards[shard];
+}
+
+int NetworkEngine::getAttachedCount(int shard) const
+{
+    return getShard(shard).mAttachedCount;
+}
+
+QNetworkAccessManager* NetworkEngine::getNetwork(int shard) const
+{
+    return getShard(shard).mNetwork;
+}
+
+RequestScheduler& NetworkEngine::getScheduler(int shard)
+{
+    return *getShard(shard).mScheduler;
+}
+
+ConnectionWarmer* NetworkEngine::getConnectionWarmer(int shard) const
+{
+    return getShard(shard).mWarmer;
+}
+
+Http2Watchdog* NetworkEngine::getHttp2Watchdog(int shard) const
+{
+    return getShard(shard).mHttp2Watchdog;
+}
+
+void NetworkEngine::setHttp2StallTimeout(std::chrono::milliseconds timeout)
+{
+    for (auto& shard : mShards)
+    {
+        auto* watchdog = shard.mHttp2Watchdog;
+        QMetaObject::invokeMethod(watchdog, [watchdog, timeout]{ watchdog->setStallTimeout(timeout); }, Qt::QueuedConnection);
+    }
+}
+
+void NetworkEngine::prewarm(int shard, const QString& host)
+{
+    auto* warmer = getShard(shard).mWarmer;
+    QMetaObject::invokeMethod(warmer, [warmer, host]{ warmer->warm(host); }, Qt::QueuedConnection);
+}
+
+int NetworkEngine::selectShard(const QString& host) const
+{
+    if (!host.isEmpty())
+    {
+        // Fixed seed such that a host always maps to the same shard.
+        const QString hostName = QUrl::fromUserInput(host).host();
+        return (int)(qHash(hostName.isEmpty() ? host : hostName, 0) % mShards.size());
+    }
+
+    const auto it = std::min_element(mShards.begin(), mShards.end(),
+        [](const Shard& lhs, const Shard& rhs){ return lhs.mAttachedCount < rhs.mAttachedCount; });
+
+    return (int)(it - mShards.begin());
+}
+
+void NetworkEngine::attach(int shard, QObject* object)
+{
+    Q_ASSERT(object);
+    auto& s = getShard(shard);
+
+    if (!object->moveToThread(s.mThread.get()))
+    {
+        qWarning() << "Failed to attach to:" << s.mThread->objectName();
+        return;
+    }
+
+    ++s.mAttachedCount;
+    qDebug() << "Attached to:" << s.mThread->objectName() << "count:" << s.mAttachedCount;
+}
+
+void NetworkEngine::detach(int shard, QObject* object)
+{
+    Q_ASSERT(object);
+    auto& s = getShard(shard);
+    Q_ASSERT(s.mAttachedCount > 0);
+    --s.mAttachedCount;
+    qDebug() << "Detach from:" << s.mThread->objectName() << "count:" << s.mAttachedCount;
+
+    if (QThread::currentThread() == s.mThread.get() || !s.mThread->isRunning())
+    {
+        delete object;
+        return;
+    }
+
+    // The object may have replies in flight on the shard. Delete it on the shard
+    // to avoid racing with the reply handling.
+    QMetaObject::invokeMethod(s.mNetwork, [object]{ delete object; }, Qt::BlockingQueuedConnection);
+}
+
+bool NetworkEngine::reattach(int fromShard, int toShard, QObject* object, const std::function<bool()>& prepare)
+{
+    Q_ASSERT(object);
+
+    if (fromShard == toShard)
+        return false;
+
+    auto& from = getShard(fromShard);
+    auto& to = getShard(toShard);
+    bool moved = false;
+
+    // An object can only be moved to another thread from its own thread.
+    auto move = [object, &prepare, &moved, thread=to.mThread.get()]{
+        if (prepare())
+            moved = object->moveToThread(thread);
+    };
+
+    if (QThread::currentThread() == from.mThread.get())
+        move();
+    else
+        QMetaObject::invokeMethod(from.mNetwork, move, Qt::BlockingQueuedConnection);
+
+    if (!moved)
+        return false;
+
+    --from.mAttachedCount;
+    ++to.mAttachedCount;
+    qDebug() << "Moved from:" << from.mThread->objectName() << "to:" << to.mThread->objectName();
+    return true;
+}
+
+}
@@ -0,0 +1,108 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "xrpc_connection_warmer.h"
+#include "xrpc_decode_pool.h"
+#include "xrpc_http2_watchdog.h"
+#include "xrpc_metrics.h"
+#include "xrpc_request_scheduler.h"
+#include "xrpc_tls_session_store.h"
+#include <QNetworkAccessManager>
+#include <QThread>
+
+namespace Xrpc {
+
+// The network engine runs the I/O threads for XRPC clients. Clients for multiple
+// accounts can share an engine. Each I/O thread (shard) has its own network access
+// manager. A client is assigned to a shard by the host of its PDS, such that
+// connections to the same host are reused by all accounts on that host.
+class NetworkEngine
+{
+public:
+    using SharedPtr = std::shared_ptr<NetworkEngine>;
+
+    static constexpr int DEFAULT_TIMEOUT_MS = 10000;
+
+    // The engine shared by clients that are created without an engine. It gets created
+    // on first use and lives as long as a client uses it. Only to be used from the main thread.
+    static SharedPtr getDefault();
+
+    // Must be created on the main thread.
+    explicit NetworkEngine(int shardCount = 1, int networkTransferTimeoutMs = DEFAULT_TIMEOUT_MS);
+    ~NetworkEngine();
+
+    NetworkEngine(const NetworkEngine&) = delete;
+    NetworkEngine& operator=(const NetworkEngine&) = delete;
+
+    int getShardCount() const { return (int)mShards.size(); }
+    int getAttachedCount(int shard) const;
+
+    // Network access manager on the main thread, for PLC directory and identity resolution.
+    QNetworkAccessManager* getMainNetwork() const { return mMainNetwork.get(); }
+
+    // Only to be used from the thread of the shard.
+    QNetworkAccessManager* getNetwork(int shard) const;
+    RequestScheduler& getScheduler(int shard);
+    ConnectionWarmer* getConnectionWarmer(int shard) const;
+    Http2Watchdog* getHttp2Watchdog(int shard) const;
+
+    // Opens an encrypted connection to the host on the shard ahead of the first
+    // request. Can be called from any thread.
+    void prewarm(int shard, const QString& host);
+
+    // Time without progress on any request to a host after which its HTTP/2
+    // connection is considered stalled. Can be called from any thread.
+    void setHttp2StallTimeout(std::chrono::milliseconds timeout);
+
+    DecodePool& getDecodePool() { return mDecodePool; }
+
+    // Request metrics of all clients on this engine.
+    Metrics& getMetrics() { return mMetrics; }
+
+    // TLS session tickets of all clients on this engine. Disabled by default.
+    TlsSessionStore& getTlsSessionStore() { return mTlsSessionStore; }
+
+    // Resume TLS sessions with tickets stored in filePath, e.g. in the app data directory.
+    // Call before the first request to benefit from the stored tickets.
+    bool enableTlsSessionStore(const QString& filePath) { return mTlsSessionStore.open(filePath); }
+
+    // Returns the shard for a host. If the host is not known yet, the least
+    // loaded shard is returned.
+    int selectShard(const QString& host) const;
+
+    // Moves the object to the thread of the shard.
+    void attach(int shard, QObject* object);
+
+    // Deletes the object on the thread of the shard.
+    void detach(int shard, QObject* object);
+
+    // Moves the object from one shard to the other. The prepare function is called on
+    // the thread of the source shard. It must rebind the object to the resources of the
+    // target shard, or return false when the object cannot be moved, e.g. because it has
+    // requests in flight. Returns true if the object was moved.
+    bool reattach(int fromShard, int toShard, QObject* object, const std::function<bool()>& prepare);
+
+    static int defaultShardCount();
+
+private:
+    struct Shard
+    {
+        std::unique_ptr<QThread> mThread;
+        QNetworkAccessManager* mNetwork = nullptr; // lives in mThread
+        std::unique_ptr<RequestScheduler> mScheduler; // used from mThread
+        ConnectionWarmer* mWarmer = nullptr; // lives in mThread
+        Http2Watchdog* mHttp2Watchdog = nullptr; // lives in mThread
+        int mAttachedCount = 0;
+    };
+
+    Shard& getShard(int shard);
+    const Shard& getShard(int shard) const;
+
+    DecodePool mDecodePool;
+    Metrics mMetrics;
+    TlsSessionStore mTlsSessionStore;
+    std::unique_ptr<QNetworkAccessManager> mMainNetwork;
+    std::vector<Shard> mShards;
+};
+
+}
@@ -2,10 +2,13 @@
 // License: GPLv3
 #include "xrpc_network_thread.h"
 #include "client.h"
+#include "xrpc_json_array_splitter.h"
 #include "network_utils.h"
 #include "xjson.h"
 #include "lexicon/lexicon.h"
+#include <QElapsedTimer>
 #include <QSslSocket>
+#include <algorithm>
 
 namespace Xrpc {
 
@@ -14,6 +17,12 @@ using namespace std::chrono_literals;
 constexpr int MAX_RESEND = 3;
 static constexpr int MAX_DPOP_RESEND = 3;
 
+// Signing takes a few milliseconds, a request rarely waits for more than one proof.
+static constexpr int MAX_SIGN_THREADS = 2;
+
+// A resend is only started if this time remains till the deadline after the backoff.
+static constexpr std::chrono::milliseconds MIN_RESEND_BUDGET{1000};
+
 static bool isEmpty(const NetworkThread::DataType& data)
 {
     if (std::holds_alternative<QByteArray>(data))
@@ -28,13 +37,40 @@ static bool isEmpty(const NetworkThread::DataType& data)
     }
 }
 
+static bool isSuccessStatus(const QNetworkReply* reply)
+{
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    return httpStatus >= 200 && httpStatus < 300;
+}
+
+static qint64 dataSize(const NetworkThread::DataType& data)
+{
+    if (std::holds_alternative<QByteArray>(data))
+        return std::get<QByteArray>(data).size();
+
+    auto* ioDevice = std::get<QIODevice*>(data);
+    return ioDevice ? ioDevice->size() : 0;
+}
+
 
-NetworkThread::NetworkThread(int networkTransferTimeoutMs, const QString& pdsDpopNonce, QObject* parent) :
-    QThread(parent),
+NetworkThread::NetworkThread(QNetworkAccessManager* network, DecodePool& decodePool, RequestScheduler& scheduler,
+                             Metrics& metrics, TlsSessionStore& tlsSessionStore, ConnectionWarmer* warmer,
+                             Http2Watchdog* http2Watchdog, int networkTransferTimeoutMs, const QString& pdsDpopNonce, QObject* parent) :
+    QObject(parent),
+    mNetwork(network),
+    mScheduler(&scheduler),
+    mMetrics(metrics),
+    mTlsSessionStore(tlsSessionStore),
+    mWarmer(warmer),
+    mHttp2Watchdog(http2Watchdog),
     mNetworkTransferTimeoutMs(networkTransferTimeoutMs),
     mVideoHost(ATProto::Client::SERVICE_VIDEO_HOST),
-    mPdsDpopNonce(pdsDpopNonce)
+    mPdsDpopNonce(pdsDpopNonce),
+    mDecodeTasks(decodePool),
+    mSignPool(MAX_SIGN_THREADS, "XrpcSignPool")
 {
+    Q_ASSERT(mNetwork);
+    Q_ASSERT(mNetwork->autoDeleteReplies());
     qDebug() << "timeout:" << mNetworkTransferTimeoutMs << "video:" << mVideoHost << "pdsDpopNonce:" << mPdsDpopNonce;
 
     connect(this, &NetworkThread::requestSuccessSession, this,
@@ -43,9 +79,17 @@ NetworkThread::NetworkThread(int networkTransferTimeoutMs, const QString& pdsDpo
         });
 }
 
+NetworkThread::~NetworkThread()
+{
+    mScheduler->removeQueued(this);
+    mSignPool.shutdown();
+    mDecodeTasks.waitForDone();
+}
+
 void NetworkThread::setPDS(const QString& pds)
 {
     mPDS = pds;
+    prewarm(pds);
 
     if (mOAuth)
         mOAuth->setPds(pds);
@@ -63,21 +107,53 @@ void NetworkThread::setVideoHost(const QString& host)
 {
     qDebug() << "Video host:" << host;
     mVideoHost = host;
+    prewarm(host);
+}
+
+void NetworkThread::setShard(QNetworkAccessManager* network, RequestScheduler& scheduler,
+                             ConnectionWarmer* warmer, Http2Watchdog* http2Watchdog)
+{
+    Q_ASSERT(network);
+    Q_ASSERT(canMoveShard());
+    mNetwork = network;
+    mScheduler = &scheduler;
+    mWarmer = warmer;
+    mHttp2Watchdog = http2Watchdog;
 }
 
-void NetworkThread::run()
+bool NetworkThread::canMoveShard() const
 {
-    qDebug() << "XRPC network thread running:" << currentThreadId();
-    mNetwork = new QNetworkAccessManager(this);
-    mNetwork->setAutoDeleteReplies(true);
-    mNetwork->setTransferTimeout(mNetworkTransferTimeoutMs);
-    exec();
+    // Replies in flight are children of this object, but they must stay on the thread
+    // of their network access manager. Timers fire on the thread they were started on.
+    // The OAuth client keeps the network access manager it was created with.
+    return !mOAuth && mPendingTimers == 0 && mParkedRequests.empty() && mDpopResends.empty() &&
+           mInFlightGets.empty() && mRefreshingJwt.isEmpty() && !mScheduler->hasQueued(this) &&
+           findChildren<QNetworkReply*>(Qt::FindDirectChildrenOnly).isEmpty();
+}
+
+void NetworkThread::runLater(std::chrono::milliseconds delay, const std::function<void()>& fun)
+{
+    ++mPendingTimers;
+
+    QTimer::singleShot(delay, this, [this, fun]{
+        --mPendingTimers;
+        fun();
+    });
+}
+
+void NetworkThread::prewarm(const QString& host)
+{
+    Q_ASSERT(!mWarmer || mWarmer->thread() == QThread::currentThread());
+
+    if (mWarmer && !host.isEmpty())
+        mWarmer->warm(host);
 }
 
 void NetworkThread::postData(const QString& service, const NetworkThread::Params& params,
               const DataType& data, const QString& mimeType, const Params& rawHeaders,
               const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-              bool isServiceAuthToken)
+              bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+              const QDeadlineTimer& deadline)
 {
     Request request;
     request.mIsPost = true;
@@ -94,33 +170,401 @@ void NetworkThread::postData(const QString& service, const NetworkThread::Params
 
     setRawHeaders(request.mXrpcRequest, rawHeaders);
     request.mData = data;
+    request.mHandle = handle;
+    request.mPriority = priority;
+    request.mDeadline = deadline;
     sendRequest(request, successCb, errorCb);
 }
 
 void NetworkThread::postJson(const QString& service, const QJsonDocument& json, const Params& rawHeaders,
               const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-              bool isServiceAuthToken)
+              bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+              const QDeadlineTimer& deadline)
 {
     const QByteArray data(json.toJson(QJsonDocument::Compact));
-    postData(service, {}, data, "application/json", rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken);
+    postData(service, {}, data, "application/json", rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken, handle, priority, deadline);
 }
 
 void NetworkThread::get(const QString& service, const Params& params, const Params& rawHeaders,
          const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-         bool isServiceAuthToken, const QString& pds)
+         bool isServiceAuthToken, const QString& pds, const RequestHandle& handle, RequestPriority priority,
+         const QDeadlineTimer& deadline)
 {
+    if (handle.isCancelled())
+    {
+        qDebug() << "Request cancelled:" << service;
+        return;
+    }
+
+    const QUrl url = buildUrl(service, params, pds);
+    const QString requestKey = ResponseCache::makeKey(url, rawHeaders, accessJwt, isServiceAuthToken);
+
+    if (mResponseCache.hasPolicy(service))
+    {
+        const auto cached = mResponseCache.find(service, requestKey);
+
+        if (cached)
+        {
+            const bool stale = cached->mFreshness == ResponseCache::Freshness::STALE;
+            qDebug() << "Cache hit:" << url << "stale:" << stale;
+            invokeCallback(successCb, errorCb, cached->mData, cached->mContentType, handle, Metrics::Key::fromUrl(url));
+
+            if (stale)
+                refreshCacheEntry(service, url, requestKey, rawHeaders, successCb, accessJwt, isServiceAuthToken);
+
+            return;
+        }
+    }
+
+    sendGet(service, url, requestKey, rawHeaders, successCb, errorCb, accessJwt, isServiceAuthToken, handle, priority, deadline);
+}
+
+void NetworkThread::sendGet(const QString& service, const QUrl& url, const QString& requestKey, const Params& rawHeaders,
+                            const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
+                            bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+                            const QDeadlineTimer& deadline)
+{
+    const QString key = getInFlightKey(requestKey, successCb);
+    const InFlightWaiter waiter{ successCb, errorCb, handle, ++mWaiterSequence };
+    auto it = mInFlightGets.find(key);
+
+    // A cache refresh decodes its reply for each waiter, so any callback type can join.
+    if (it == mInFlightGets.end() || !it->second->isActive())
+        it = mInFlightGets.find(getCacheRefreshKey(requestKey));
+
+    if (it != mInFlightGets.end() && joinInFlightGet(it->second, waiter))
+    {
+        // The joined request may still be queued with a lower priority.
+        mScheduler->raisePriority(it->second->mHandle, priority);
+        watchWaiterDeadline(it->second, waiter.mId, deadline);
+        ++mCoalesceHits;
+        qDebug() << "Coalesced request:" << url << "hits:" << mCoalesceHits.load() << "misses:" << mCoalesceMisses.load();
+        return;
+    }
+
+    ++mCoalesceMisses;
+    auto inFlight = startInFlightGet(key);
+    joinInFlightGet(inFlight, waiter);
+    watchWaiterDeadline(inFlight, waiter.mId, deadline);
+
     Request request;
     request.mIsPost = false;
-    request.mXrpcRequest = QNetworkRequest(buildUrl(service, params, pds));
+    request.mXrpcRequest = QNetworkRequest(url);
+    setUserAgentHeader(request.mXrpcRequest);
+
+    if (!accessJwt.isNull())
+        setAuthorization(request, accessJwt, isServiceAuthToken);
+
+    setRawHeaders(request.mXrpcRequest, rawHeaders);
+
+    if (mResponseCache.hasPolicy(service))
+    {
+        request.mCacheNsid = service;
+        request.mCacheKey = requestKey;
+    }
+
+    // Each waiter has its own deadline. The request gets cancelled when all waiters
+    // passed their deadline.
+    request.mHandle = inFlight->mHandle;
+    request.mPriority = priority;
+    sendRequest(request, fanOutSuccess(inFlight, successCb), fanOutError(inFlight));
+}
+
+void NetworkThread::refreshCacheEntry(const QString& service, const QUrl& url, const QString& requestKey,
+                                      const Params& rawHeaders, const CallbackType& successCb,
+                                      const QString& accessJwt, bool isServiceAuthToken)
+{
+    // A request for the same URL in flight updates the cache when it finishes.
+    for (const auto& key : { getInFlightKey(requestKey, successCb), getCacheRefreshKey(requestKey) })
+    {
+        auto it = mInFlightGets.find(key);
+
+        if (it != mInFlightGets.end() && it->second->isActive())
+        {
+            qDebug() << "Cache refresh in flight:" << url;
+            return;
+        }
+    }
+
+    qDebug() << "Cache refresh:" << url;
+    auto inFlight = startInFlightGet(getCacheRefreshKey(requestKey));
+    inFlight->mCacheRefresh = true;
+
+    Request request;
+    request.mIsPost = false;
+    request.mXrpcRequest = QNetworkRequest(url);
     setUserAgentHeader(request.mXrpcRequest);
 
     if (!accessJwt.isNull())
         setAuthorization(request, accessJwt, isServiceAuthToken);
 
     setRawHeaders(request.mXrpcRequest, rawHeaders);
+    request.mCacheNsid = service;
+    request.mCacheKey = requestKey;
+    request.mCacheRefresh = true;
+    request.mHandle = inFlight->mHandle;
+    request.mPriority = RequestPriority::BACKGROUND;
+
+    // The reply is passed to the waiters that joined the refresh by finishCacheRefresh.
+    sendRequest(request, SuccessBytesCb{}, fanOutError(inFlight));
+}
+
+void NetworkThread::finishCacheRefresh(const Request& request, const QByteArray& data, const QString& contentType,
+                                       const Metrics::Key& metricsKey)
+{
+    mResponseCache.insert(request.mCacheNsid, request.mCacheKey, data, contentType);
+    auto it = mInFlightGets.find(getCacheRefreshKey(request.mCacheKey));
+
+    if (it == mInFlightGets.end() || it->second->mHandle != request.mHandle)
+        return;
+
+    const auto waiters = it->second->takeWaiters();
+
+    for (const auto& waiter : waiters)
+        invokeCallback(waiter.mSuccessCb, waiter.mErrorCb, data, contentType, waiter.mHandle, metricsKey);
+}
+
+void NetworkThread::getStream(const QString& service, const Params& params, const Params& rawHeaders,
+                              const StreamTarget::SharedPtr& target, const SuccessStreamCb& successCb, const ErrorCb& errorCb,
+                              const QString& accessJwt, const QString& pds, const RequestHandle& handle, RequestPriority priority,
+                              const QDeadlineTimer& deadline)
+{
+    Q_ASSERT(target);
+
+    if (handle.isCancelled())
+    {
+        qDebug() << "Request cancelled:" << service;
+        return;
+    }
+
+    // Streamed requests are not coalesced or cached, each has its own target.
+    Request request;
+    request.mIsPost = false;
+    request.mXrpcRequest = QNetworkRequest(buildUrl(service, params, pds));
+    setUserAgentHeader(request.mXrpcRequest);
+
+    if (!accessJwt.isNull())
+        setAuthorization(request, accessJwt, false);
+
+    setRawHeaders(request.mXrpcRequest, rawHeaders);
+    request.mHandle = handle;
+    request.mPriority = priority;
+    request.mDeadline = deadline;
+    request.mStream = target;
     sendRequest(request, successCb, errorCb);
 }
 
+void NetworkThread::enableResponseCache(bool enable)
+{
+    qDebug() << "Enable response cache:" << enable;
+
+    if (!enable)
+    {
+        mResponseCache = ResponseCache{};
+        return;
+    }
+
+    for (const auto& [nsid, policy] : ResponseCache::defaultPolicies())
+    {
+        if (!mResponseCache.hasPolicy(nsid))
+            mResponseCache.setPolicy(nsid, policy);
+    }
+}
+
+void NetworkThread::setResponseCachePolicy(const QString& nsid, const ResponseCache::Policy& policy)
+{
+    mResponseCache.setPolicy(nsid, policy);
+}
+
+void NetworkThread::clearResponseCache()
+{
+    qDebug() << "Clear response cache";
+    mResponseCache.clear();
+}
+
+void NetworkThread::enableArenaDecoding(bool enable)
+{
+    qDebug() << "Enable arena decoding:" << enable;
+    mArenaDecoding = enable;
+}
+
+void NetworkThread::enableLazyPostDecoding(bool enable)
+{
+    qDebug() << "Enable lazy post decoding:" << enable;
+    mLazyPostDecoding = enable;
+}
+
+NetworkThread::CoalesceStats NetworkThread::getCoalesceStats() const
+{
+    return { mCoalesceHits.load(), mCoalesceMisses.load() };
+}
+
+bool NetworkThread::InFlightGet::join(const InFlightWaiter& waiter)
+{
+    QMutexLocker locker(&mMutex);
+
+    // The callbacks are already being called, too late to join. A cancelled
+    // network request will not give any reply.
+    if (mDone || mHandle.isCancelled())
+        return false;
+
+    mWaiters.push_back(waiter);
+    return true;
+}
+
+std::vector<NetworkThread::InFlightWaiter> NetworkThread::InFlightGet::takeWaiters()
+{
+    QMutexLocker locker(&mMutex);
+    mDone = true;
+    return std::move(mWaiters);
+}
+
+std::optional<NetworkThread::InFlightWaiter> NetworkThread::InFlightGet::removeWaiter(quint64 id)
+{
+    QMutexLocker locker(&mMutex);
+
+    if (mDone)
+        return {};
+
+    auto it = std::find_if(mWaiters.begin(), mWaiters.end(), [id](const auto& waiter){ return waiter.mId == id; });
+
+    if (it == mWaiters.end())
+        return {};
+
+    InFlightWaiter waiter = std::move(*it);
+    mWaiters.erase(it);
+    return waiter;
+}
+
+bool NetworkThread::InFlightGet::allCancelled()
+{
+    QMutexLocker locker(&mMutex);
+
+    // A cache refresh is needed without waiters.
+    if (mCacheRefresh)
+        return false;
+
+    return !mDone && std::all_of(mWaiters.begin(), mWaiters.end(),
+                                 [](const auto& waiter){ return waiter.mHandle.isCancelled(); });
+}
+
+bool NetworkThread::InFlightGet::isActive()
+{
+    QMutexLocker locker(&mMutex);
+    return !mDone && !mHandle.isCancelled();
+}
+
+QString NetworkThread::getInFlightKey(const QString& requestKey, const CallbackType& successCb)
+{
+    // The callback type determines how the reply gets decoded.
+    return requestKey + '\n' + QString::number(successCb.index());
+}
+
+QString NetworkThread::getCacheRefreshKey(const QString& requestKey)
+{
+    return requestKey + "\nrefresh";
+}
+
+std::shared_ptr<NetworkThread::InFlightGet> NetworkThread::startInFlightGet(const QString& key)
+{
+    static constexpr size_t CLEANUP_THRESHOLD = 64;
+
+    // Finished requests are not removed from the map right away as they finish on
+    // the main thread.
+    if (mInFlightGets.size() >= CLEANUP_THRESHOLD)
+    {
+        std::erase_if(mInFlightGets, [](const auto& item){
+            QMutexLocker locker(&item.second->mMutex);
+            return item.second->mDone || item.second->mHandle.isCancelled();
+        });
+    }
+
+    auto inFlight = std::make_shared<InFlightGet>();
+    mInFlightGets[key] = inFlight;
+    return inFlight;
+}
+
+bool NetworkThread::joinInFlightGet(std::shared_ptr<InFlightGet> inFlight, const InFlightWaiter& waiter)
+{
+    if (!inFlight->join(waiter))
+        return false;
+
+    waiter.mHandle.onCancel([weakInFlight=std::weak_ptr<InFlightGet>(inFlight)]{
+        auto inFlight = weakInFlight.lock();
+
+        if (inFlight && inFlight->allCancelled())
+            inFlight->mHandle.cancel();
+    });
+
+    return true;
+}
+
+void NetworkThread::watchWaiterDeadline(std::shared_ptr<InFlightGet> inFlight, quint64 waiterId, const QDeadlineTimer& deadline)
+{
+    if (deadline.isForever())
+        return;
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline.remainingTimeAsDuration());
+    runLater(remaining, [this, weakInFlight=std::weak_ptr<InFlightGet>(inFlight), waiterId]{ expireWaiter(weakInFlight, waiterId); });
+}
+
+void NetworkThread::expireWaiter(std::weak_ptr<InFlightGet> weakInFlight, quint64 waiterId)
+{
+    auto inFlight = weakInFlight.lock();
+
+    if (!inFlight)
+        return;
+
+    // Not found when the reply got passed to the waiters already.
+    const auto waiter = inFlight->removeWaiter(waiterId);
+
+    if (!waiter)
+        return;
+
+    qDebug() << "Deadline passed for coalesced request, waiter:" << waiterId;
+
+    if (waiter->mErrorCb && !waiter->mHandle.isCancelled())
+        emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, waiter->mErrorCb);
+
+    if (inFlight->allCancelled())
+        inFlight->mHandle.cancel();
+}
+
+NetworkThread::CallbackType NetworkThread::fanOutSuccess(std::shared_ptr<InFlightGet> inFlight, const CallbackType& successCb)
+{
+    return std::visit(
+        [inFlight](const auto& cb) -> CallbackType {
+            using T = std::decay_t<decltype(cb)>;
+
+            return T([inFlight](auto&&... args){
+                const auto waiters = inFlight->takeWaiters();
+
+                for (const auto& waiter : waiters)
+                {
+                    const auto& typedCb = std::get<T>(waiter.mSuccessCb);
+
+                    if (typedCb && !waiter.mHandle.isCancelled())
+                        typedCb(args...);
+                }
+            });
+        },
+        successCb
+    );
+}
+
+NetworkThread::ErrorCb NetworkThread::fanOutError(std::shared_ptr<InFlightGet> inFlight)
+{
+    return [inFlight](const QString& err, const QJsonDocument& json){
+        const auto waiters = inFlight->takeWaiters();
+
+        for (const auto& waiter : waiters)
+        {
+            if (waiter.mErrorCb && !waiter.mHandle.isCancelled())
+                waiter.mErrorCb(err, json);
+        }
+    };
+}
+
 void NetworkThread::setAccessJwt(const QString &jwt)
 {
     qDebug() << "Access JWT:" << jwt;
@@ -133,22 +577,145 @@ void NetworkThread::updateSessionTokens(ATProto::ComATProtoServer::Session::Shar
     setAccessJwt(session->mAccessJwt);
 }
 
-void NetworkThread::sendRequest(Request& request, const CallbackType& successCb, const ErrorCb& errorCb)
+void NetworkThread::sendRequest(const Request& request, const CallbackType& successCb, const ErrorCb& errorCb)
+{
+    if (mustParkForTokenRefresh(request))
+    {
+        parkForTokenRefresh({ request, successCb, errorCb });
+        return;
+    }
+
+    const auto delay = mRateLimiter.acquire(request.mXrpcRequest.url());
+
+    if (delay > 0ms)
+    {
+        qDebug() << "Rate limit, delay request:" << request.mXrpcRequest.url() << "delay:" << delay.count() << "ms";
+
+        if (!request.mDeadline.isForever() && request.mDeadline.remainingTimeAsDuration() <= delay)
+        {
+            qDebug() << "Rate limit delay exceeds deadline:" << request.mXrpcRequest.url();
+            emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, errorCb);
+            return;
+        }
+
+        runLater(delay, [this, request, successCb, errorCb]{
+            signAndScheduleRequest(request, successCb, errorCb);
+        });
+
+        return;
+    }
+
+    signAndScheduleRequest(request, successCb, errorCb);
+}
+
+void NetworkThread::signAndScheduleRequest(Request request, const CallbackType& successCb, const ErrorCb& errorCb)
 {
-    qDebug() << "Request:" << request.mXrpcRequest.url()  << "Thread:" << currentThreadId();
+    if (!request.mDpop)
+    {
+        scheduleRequest(request, successCb, errorCb);
+        return;
+    }
+
+#if defined(Q_OS_ANDROID) && defined(USE_ANDROID_KEYSTORE)
+    // The Android Keystore is called via JNI from the network thread.
+    if (!buildDpopProof(request, request.mAccessJwt))
+    {
+        emit requestError(ATProto::ATProtoErrorMsg::DPOP_PROOF_FAILED, {}, errorCb);
+        return;
+    }
+
+    scheduleRequest(request, successCb, errorCb);
+#else
+    // The signature is created on the worker pool, such that the network thread
+    // does not block on ECDSA. Every send gets a new proof, otherwise a resend
+    // is seen as proof replay.
+    const QString nonce = mPdsDpopNonce;
+
+    mSignPool.decode([this, request, successCb, errorCb, nonce]{
+        const QString dpopProof = mDpopKey.buildPdsDPoPProof(
+            request.mIsPost ? "POST" : "GET", request.mXrpcRequest.url().toString(), request.mAccessJwt, nonce);
+
+        QMetaObject::invokeMethod(this,
+            [this, request, successCb, errorCb, dpopProof, nonce]() mutable {
+                if (dpopProof.isEmpty())
+                {
+                    emit requestError(ATProto::ATProtoErrorMsg::DPOP_PROOF_FAILED, {}, errorCb);
+                    return;
+                }
+
+                request.mXrpcRequest.setRawHeader("DPoP", dpopProof.toUtf8());
+                request.mDpopNonce = nonce;
+                scheduleRequest(request, successCb, errorCb);
+            },
+            Qt::QueuedConnection);
+    });
+#endif
+}
+
+void NetworkThread::scheduleRequest(const Request& request, const CallbackType& successCb, const ErrorCb& errorCb)
+{
+    const QString host = request.mXrpcRequest.url().host();
+
+    mScheduler->submit(this, host, request.mPriority, request.mHandle,
+        [this, request, successCb, errorCb](RequestPriority priority) mutable {
+            // The priority may have been raised while queued. The scheduler counts
+            // the request under the priority it is started with.
+            request.mPriority = priority;
+            return startRequest(request, successCb, errorCb);
+        });
+}
+
+bool NetworkThread::startRequest(Request& request, const CallbackType& successCb, const ErrorCb& errorCb)
+{
+    if (request.mHandle.isCancelled())
+    {
+        qDebug() << "Request cancelled:" << request.mXrpcRequest.url();
+        return false;
+    }
+
+    if (request.mDeadline.hasExpired())
+    {
+        qDebug() << "Deadline passed:" << request.mXrpcRequest.url();
+        emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, errorCb);
+        return false;
+    }
+
+    if (request.mSequence == 0)
+        request.mSequence = ++mStartSequence;
+
+    // The nonce may have rotated while the request was queued. The request gets
+    // scheduled again after the new proof is signed.
+    if (request.mDpop && request.mDpopNonce != mPdsDpopNonce)
+    {
+        qDebug() << "DPoP nonce rotated while queued:" << request.mXrpcRequest.url();
+        signAndScheduleRequest(request, successCb, errorCb);
+        return false;
+    }
+
+    if (request.mStream && !request.mStream->begin())
+    {
+        emit requestError(request.mStream->getError(), {}, errorCb);
+        return false;
+    }
+
+    // A resend starts with a fresh decoder.
+    request.mDecoder = makeIncrementalDecoder(request, successCb);
+
+    qDebug() << "Request:" << request.mXrpcRequest.url()  << "Thread:" << QThread::currentThreadId();
     QNetworkReply* reply;
     const QString host = request.mXrpcRequest.url().host();
 
-#if QT_VERSION < QT_VERSION_CHECK(6, 11, 1)
-    // HACK:
-    // HTTP/2 does not work between Qt6.10.2 and Eurosky. Connection goes
-    // stale after a while and then all requests time out for ~25s.
-    // With HTTP/1.1 all works fine.
-    // With Qt6.8.3 HTTP/2 worked fine too.
+    // HTTP/2 connections to some hosts go stale, e.g. between Qt6.10.2 and Eurosky.
+    // Then all requests time out. The watchdog falls back to HTTP/1.1 for such hosts.
+    if (mHttp2Watchdog)
+        mHttp2Watchdog->prepare(request.mXrpcRequest);
 
-    if (host.endsWith("eurosky.social"))
-        request.mXrpcRequest.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
-#endif
+    // The network access manager is shared with other clients on this shard.
+    request.mXrpcRequest.setTransferTimeout(mNetworkTransferTimeoutMs);
+    const bool storeTlsSession = mTlsSessionStore.isOpen();
+
+    if (storeTlsSession)
+        mTlsSessionStore.apply(request.mXrpcRequest);
 
     if (request.mIsPost)
     {
@@ -168,6 +735,55 @@ void NetworkThread::sendRequest(Request& request, const CallbackType& successCb,
         reply = mNetwork->get(request.mXrpcRequest);
     }
 
+    if (mWarmer)
+        mWarmer->used(request.mXrpcRequest.url());
+
+    if (mHttp2Watchdog)
+        mHttp2Watchdog->watch(reply);
+
+    // The abort is handled as a timeout.
+    if (!request.mDeadline.isForever())
+    {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(request.mDeadline.remainingTimeAsDuration());
+        QTimer::singleShot(remaining, reply, [reply]{ reply->abort(); });
+    }
+
+    // Replies in flight get aborted when this client is destroyed.
+    reply->setParent(this);
+    request.mHandle.setReply(reply);
+
+    // The reply gets deleted when it is finished, aborted or when this client is destroyed.
+    // The scheduler is owned by the network engine and outlives this client.
+    QObject::connect(reply, &QObject::destroyed,
+        [scheduler=mScheduler, host, priority=request.mPriority]{ scheduler->finished(host, priority); });
+
+    if (request.mStream)
+    {
+        // Limit buffering, data is written to the target as it arrives.
+        reply->setReadBufferSize(StreamTarget::READ_BUFFER_SIZE);
+        connect(reply, &QNetworkReply::readyRead, this,
+                [this, stream=request.mStream, reply]{ streamData(*stream, reply); });
+    }
+    else if (request.mDecoder)
+    {
+        connect(reply, &QNetworkReply::readyRead, this,
+            [decoder=request.mDecoder, reply]{
+                // The body of an error reply is handled when the reply is finished.
+                if (isSuccessStatus(reply))
+                    decoder->feed(reply->readAll());
+            });
+    }
+
+    if (storeTlsSession)
+    {
+        // A TLS 1.3 server sends its ticket after the handshake.
+        const QUrl url = request.mXrpcRequest.url();
+        connect(reply, &QNetworkReply::encrypted, this,
+                [this, reply, url]{ mTlsSessionStore.update(url, reply->sslConfiguration()); });
+        connect(reply, &QNetworkReply::finished, this,
+                [this, reply, url]{ mTlsSessionStore.update(url, reply->sslConfiguration()); });
+    }
+
     request.mSendTime = QDateTime::currentDateTime();
 
     // In case of an error multiple callbacks may fire. First errorOcccured() and then probably finished()
@@ -180,6 +796,8 @@ void NetworkThread::sendRequest(Request& request, const CallbackType& successCb,
             [this, request, reply, successCb, errorCb, errorHandled](auto errorCode){ this->networkError(request, reply, errorCode, successCb, errorCb, errorHandled); });
     connect(reply, &QNetworkReply::sslErrors, this,
             [this, reply, errorCb, errorHandled](const QList<QSslError>& errors){ sslErrors(reply, errors, errorCb, errorHandled); });
+
+    return true;
 }
 
 void NetworkThread::replyFinished(const Request& request, QNetworkReply* reply,
@@ -187,15 +805,35 @@ void NetworkThread::replyFinished(const Request& request, QNetworkReply* reply,
                    std::shared_ptr<bool> errorHandled)
 {
     Q_ASSERT(reply);
+
+    if (request.mHandle.isCancelled())
+    {
+        qDebug() << "Reply cancelled:" << request.mXrpcRequest.url();
+
+        // A partial download must not be saved.
+        if (request.mStream)
+            request.mStream->discard();
+
+        return;
+    }
+
+    mRateLimiter.update(request.mXrpcRequest.url(), ATProto::RateLimitHeaders::fromReply(*reply));
     const auto errorCode = reply->error();
     const QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString().trimmed();
     const auto respondeDt = QDateTime::currentDateTime() - request.mSendTime;
     qDebug() << "Reply:" << errorCode << "content:" << contentType << "errorHandled:" << *errorHandled << "responseMs:" << (respondeDt / 1ms) << request.mXrpcRequest.url();
     auto data = reply->readAll();
+    const auto metricsKey = Metrics::Key::fromUrl(request.mXrpcRequest.url());
+
+    // Bytes consumed while the reply was arriving
+    const qint64 consumedBytes = request.mStream ? request.mStream->getBytesWritten() :
+                                 request.mDecoder ? request.mDecoder->getBytesReceived() : 0;
+    mMetrics.recordReply(metricsKey, respondeDt, dataSize(request.mData), consumedBytes + data.size(),
+                         errorCode != QNetworkReply::NoError || *errorHandled);
     const bool hasDpopNonce = ATProto::NetworkUtils::hasDpopNonce(reply);
 
     if (hasDpopNonce)
-        setPdsDpopNonce(ATProto::NetworkUtils::getDpopNonce(reply));
+        updatePdsDpopNonce(ATProto::NetworkUtils::getDpopNonce(reply));
 
     // WORK AROUND:
     // Since Qt6.9.2 we sometimes get an Unknown error like this:
@@ -205,13 +843,37 @@ void NetworkThread::replyFinished(const Request& request, QNetworkReply* reply,
     // 09-01 19:24:47.662 10707 10792 W default : 19:24:47.663 warning unknown'0 Retry on unknown error
     if (errorCode == QNetworkReply::NoError && !*errorHandled)
     {
-        invokeCallback(std::move(successCb), errorCb, std::move(data), contentType);
+        if (request.mStream)
+        {
+            finishStream(*request.mStream, reply, data, contentType, successCb, errorCb);
+            return;
+        }
+
+        if (request.mDecoder)
+        {
+            request.mDecoder->finish(data, errorCb);
+            return;
+        }
+
+        if (request.mCacheRefresh)
+        {
+            finishCacheRefresh(request, data, contentType, metricsKey);
+            return;
+        }
+
+        if (!request.mCacheNsid.isEmpty())
+            mResponseCache.insert(request.mCacheNsid, request.mCacheKey, data, contentType);
+
+        invokeCallback(std::move(successCb), errorCb, std::move(data), contentType, request.mHandle, metricsKey);
     }
     else if (!*errorHandled)
     {
         *errorHandled = true;
 
-        if (mustResend(errorCode))
+        if (streamError(request, errorCb))
+            return;
+
+        if (mustResend(reply, errorCode))
         {
             if (resendRequest(request, successCb, errorCb))
                 return;
@@ -232,7 +894,7 @@ void NetworkThread::replyFinished(const Request& request, QNetworkReply* reply,
         }
         else if (ATProto::NetworkUtils::isInvalidTokenError(data))
         {
-            if (resendRequestWithNewToken(request, successCb, errorCb))
+            if (resendRequestWithNewToken(request, successCb, errorCb, reply->errorString(), QJsonDocument::fromJson(data)))
                 return;
         }
 
@@ -250,6 +912,19 @@ void NetworkThread::networkError(const Request& request, QNetworkReply* reply, Q
                   std::shared_ptr<bool> errorHandled)
 {
     Q_ASSERT(reply);
+
+    if (request.mHandle.isCancelled())
+    {
+        qDebug() << "Reply cancelled:" << request.mXrpcRequest.url();
+
+        // A partial download must not be saved.
+        if (request.mStream)
+            request.mStream->discard();
+
+        return;
+    }
+
+    mRateLimiter.update(request.mXrpcRequest.url(), ATProto::RateLimitHeaders::fromReply(*reply));
     auto errorMsg = reply->errorString();
     qInfo() << "Network error:" << errorCode << errorMsg;
 
@@ -261,7 +936,10 @@ void NetworkThread::networkError(const Request& request, QNetworkReply* reply, Q
         if (errorCode == QNetworkReply::OperationCanceledError)
             reply->disconnect();
 
-        if (mustResend(errorCode))
+        if (streamError(request, errorCb))
+            return;
+
+        if (mustResend(reply, errorCode))
         {
             qDebug() << "Try resend on error:" << errorCode << errorMsg;
 
@@ -272,7 +950,7 @@ void NetworkThread::networkError(const Request& request, QNetworkReply* reply, Q
         {
             if (ATProto::NetworkUtils::hasDpopNonce(reply))
             {
-                setPdsDpopNonce(ATProto::NetworkUtils::getDpopNonce(reply));
+                updatePdsDpopNonce(ATProto::NetworkUtils::getDpopNonce(reply));
 
                 if (resendWithNewDpopNonce(request, successCb, errorCb))
                     return;
@@ -286,7 +964,7 @@ void NetworkThread::networkError(const Request& request, QNetworkReply* reply, Q
         }
         else if (ATProto::NetworkUtils::isInvalidTokenError(data))
         {
-            if (resendRequestWithNewToken(request, successCb, errorCb))
+            if (resendRequestWithNewToken(request, successCb, errorCb, errorMsg, QJsonDocument::fromJson(data)))
                 return;
         }
 
@@ -734,15 +1412,301 @@ struct FromJson<T, typename std::enable_if_t<std::is_same_v<T, NetworkThread::Su
     static constexpr auto sEmitFun = &NetworkThread::requestSuccessChatNotificationPreferencesOutput;
 };
 
-void NetworkThread::invokeCallback(CallbackType successCb, const ErrorCb& errorCb, QByteArray data, const QString& contentType)
+// Replies having a large array of elements that get decoded while the reply arrives.
+template<typename T, typename Enable = void>
+struct IncrementalJson {};
+
+template<typename T>
+struct IncrementalJson<T, typename std::enable_if_t<std::is_same_v<T, NetworkThread::SuccessOutputFeedCb>>>
+{
+    using ElemType = ATProto::AppBskyFeed::FeedViewPost;
+    static constexpr char const* ARRAY_KEY = "feed";
+    static auto& elements(ATProto::AppBskyFeed::OutputFeed& reply) { return reply.mFeed; }
+};
+
+template<typename T>
+struct IncrementalJson<T, typename std::enable_if_t<std::is_same_v<T, NetworkThread::SuccessListNotificationsOutputCb>>>
+{
+    using ElemType = ATProto::AppBskyNotification::Notification;
+    static constexpr char const* ARRAY_KEY = "notifications";
+    static auto& elements(ATProto::AppBskyNotification::ListNotificationsOutput& reply) { return reply.mNotifications; }
+};
+
+template<typename T>
+struct IncrementalJson<T, typename std::enable_if_t<std::is_same_v<T, NetworkThread::SuccessGetFollowersOutputCb>>>
+{
+    using ElemType = ATProto::AppBskyActor::ProfileView;
+    static constexpr char const* ARRAY_KEY = "followers";
+    static auto& elements(ATProto::AppBskyGraph::GetFollowersOutput& reply) { return reply.mFollowers; }
+};
+
+template<typename T>
+struct IncrementalJson<T, typename std::enable_if_t<std::is_same_v<T, NetworkThread::SuccessGetFollowsOutputCb>>>
+{
+    using ElemType = ATProto::AppBskyActor::ProfileView;
+    static constexpr char const* ARRAY_KEY = "follows";
+    static auto& elements(ATProto::AppBskyGraph::GetFollowsOutput& reply) { return reply.mFollows; }
+};
+
+template<typename T>
+concept IncrementalReply = requires { IncrementalJson<T>::ARRAY_KEY; };
+
+// The network thread splits the array elements from the reply data as it arrives.
+// Batches of elements are decoded on the decode pool, in parallel with the download.
+// When the reply is finished, the rest of the reply is decoded and the reply is
+// assembled by the last decode task.
+template<typename T>
+class TypedIncrementalDecoder : public NetworkThread::IncrementalDecoder,
+                                public std::enable_shared_from_this<TypedIncrementalDecoder<T>>
+{
+public:
+    using Json = IncrementalJson<T>;
+    using ReplyType = typename FromJson<T>::ReplyType;
+    using ElemList = std::vector<typename Json::ElemType::SharedPtr>;
+
+    TypedIncrementalDecoder(NetworkThread& thread, DecodePool::TaskGroup& tasks, Metrics& metrics,
+                            const Metrics::Key& metricsKey, const T& cb, const RequestHandle& handle) :
+        mThread(thread),
+        mArenaDecoding(thread.isArenaDecodingEnabled()),
+        mLazyPostDecoding(thread.isLazyPostDecodingEnabled()),
+        mTasks(tasks),
+        mMetrics(metrics),
+        mMetricsKey(metricsKey),
+        mCb(cb),
+        mHandle(handle),
+        mSplitter(Json::ARRAY_KEY)
+    {}
+
+    void feed(const QByteArray& data) override
+    {
+        mBytesReceived += data.size();
+        std::vector<QByteArray> elements;
+        mSplitter.feed(data, elements);
+
+        if (elements.empty())
+            return;
+
+        const int first = mSplitter.getElementCount() - (int)elements.size();
+        addPending();
+        mTasks.decode([self=this->shared_from_this(), first, elements=std::move(elements)]{
+            self->decodeElements(first, elements);
+        });
+    }
+
+    void finish(const QByteArray& data, const NetworkThread::ErrorCb& errorCb) override
+    {
+        feed(data);
+        mErrorCb = errorCb;
+        addPending();
+        mTasks.decode([self=this->shared_from_this(), remainder=mSplitter.takeRemainder()]{
+            self->decodeRemainder(remainder);
+        });
+    }
+
+    qint64 getBytesReceived() const override { return mBytesReceived; }
+
+private:
+    void addPending()
+    {
+        QMutexLocker locker(&mMutex);
+        ++mPending;
+    }
+
+    void decodeElements(int first, const std::vector<QByteArray>& elements)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        ElemList decoded;
+        QString error;
+
+        if (!mHandle.isCancelled())
+        {
+            try {
+                // Each batch has its own arena, as batches are decoded in parallel.
+                const ATProto::ArenaScope arenaScope(mArenaDecoding ? ATProto::Arena::create() : nullptr);
+                const ATProto::LazyDecodeScope lazyScope(mLazyPostDecoding);
+                decoded.reserve(elements.size());
+
+                for (const auto& element : elements)
+                {
+                    const ATProto::XJsonDocument json(element);
+
+                    if (!json.isObject())
+                    {
+                        qWarning() << "PROTO ERROR invalid array element: not an object, key:" << Json::ARRAY_KEY;
+                        throw ATProto::InvalidJsonException(QString("PROTO ERROR invalid element: ") + Json::ARRAY_KEY);
+                    }
+
+                    decoded.push_back(ATProto::XJsonObject::decode<typename Json::ElemType>(json.object()));
+                }
+            } catch (ATProto::InvalidJsonException& e) {
+                qWarning() << e.msg();
+                error = e.msg();
+            }
+        }
+
+        bool last;
+
+        {
+            QMutexLocker locker(&mMutex);
+            mDecodeNs += timer.nsecsElapsed();
+
+            if (mError.isEmpty())
+                mError = error;
+
+            if (mElements.size() < first + decoded.size())
+                mElements.resize(first + decoded.size());
+
+            std::move(decoded.begin(), decoded.end(), mElements.begin() + first);
+            last = (--mPending == 0 && mFinished);
+        }
+
+        if (last)
+            complete();
+    }
+
+    void decodeRemainder(const QByteArray& remainder)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        typename ReplyType::SharedPtr reply;
+        QString error;
+
+        if (!mHandle.isCancelled())
+        {
+            try {
+                const ATProto::XJsonDocument json(remainder);
+                const ATProto::ArenaScope arenaScope(mArenaDecoding ? ATProto::Arena::create() : nullptr);
+                const ATProto::LazyDecodeScope lazyScope(mLazyPostDecoding);
+                reply = ATProto::XJsonObject::decode<ReplyType>(json.object());
+            } catch (ATProto::InvalidJsonException& e) {
+                qWarning() << e.msg();
+                error = e.msg();
+            }
+        }
+
+        bool last;
+
+        {
+            QMutexLocker locker(&mMutex);
+            mDecodeNs += timer.nsecsElapsed();
+            mReply = std::move(reply);
+
+            if (mError.isEmpty())
+                mError = error;
+
+            mFinished = true;
+            last = (--mPending == 0);
+        }
+
+        if (last)
+            complete();
+    }
+
+    // Called by the last decode task, no other tasks are running.
+    void complete()
+    {
+        if (mHandle.isCancelled())
+            return;
+
+        mMetrics.recordDecode(mMetricsKey, std::chrono::nanoseconds(mDecodeNs));
+
+        if (!mError.isEmpty())
+        {
+            emit mThread.requestInvalidJsonError(mError, mErrorCb);
+            return;
+        }
+
+        Json::elements(*mReply) = std::move(mElements);
+        qDebug() << "Incrementally decoded:" << mSplitter.getElementCount() << "elements, decode:" << mDecodeNs / 1000 << "us";
+        emit (mThread.*FromJson<T>::sEmitFun)(std::move(mReply), std::move(mCb));
+    }
+
+    NetworkThread& mThread;
+    const bool mArenaDecoding;
+    const bool mLazyPostDecoding;
+    DecodePool::TaskGroup& mTasks;
+    Metrics& mMetrics;
+    const Metrics::Key mMetricsKey;
+    T mCb;
+    NetworkThread::ErrorCb mErrorCb;
+    const RequestHandle mHandle;
+    JsonArraySplitter mSplitter; // used on the network thread only
+    qint64 mBytesReceived = 0; // used on the network thread only
+
+    QMutex mMutex;
+    int mPending = 0;
+    bool mFinished = false;
+    ElemList mElements;
+    typename ReplyType::SharedPtr mReply;
+    QString mError;
+    qint64 mDecodeNs = 0;
+};
+
+std::shared_ptr<NetworkThread::IncrementalDecoder> NetworkThread::makeIncrementalDecoder(
+    const Request& request, const CallbackType& successCb)
+{
+    // The response cache needs the complete reply data.
+    if (request.mIsPost || request.mStream || !request.mCacheNsid.isEmpty())
+        return nullptr;
+
+    return std::visit(
+        [this, &request](const auto& cb) -> std::shared_ptr<IncrementalDecoder> {
+            using T = std::decay_t<decltype(cb)>;
+
+            if constexpr (IncrementalReply<T>)
+            {
+                return std::make_shared<TypedIncrementalDecoder<T>>(
+                    *this, mDecodeTasks, mMetrics, Metrics::Key::fromUrl(request.mXrpcRequest.url()),
+                    cb, request.mHandle);
+            }
+            else
+            {
+                return nullptr;
+            }
+        },
+        successCb
+    );
+}
+
+void NetworkThread::invokeCallback(CallbackType successCb, const ErrorCb& errorCb, QByteArray data,
+                                   const QString& contentType, const RequestHandle& handle,
+                                   const Metrics::Key& metricsKey)
+{
+    if (handle.isCancelled())
+        return;
+
+    // Raw bytes need no decoding, all other replies are decoded on the decode pool
+    // to keep the network thread responsive.
+    if (auto* bytesCb = std::get_if<SuccessBytesCb>(&successCb))
+    {
+        emit requestSuccessBytes(std::move(data), std::move(*bytesCb), contentType);
+        return;
+    }
+
+    mDecodeTasks.decode(
+        [this, successCb=std::move(successCb), errorCb, data=std::move(data), handle, metricsKey]() mutable {
+            // The request may have been cancelled while this task was queued.
+            if (handle.isCancelled())
+                return;
+
+            QElapsedTimer timer;
+            timer.start();
+            decodeReply(std::move(successCb), errorCb, data);
+            mMetrics.recordDecode(metricsKey, std::chrono::nanoseconds(timer.nsecsElapsed()));
+        });
+}
+
+void NetworkThread::decodeReply(CallbackType successCb, const ErrorCb& errorCb, const QByteArray& data)
 {
     std::visit(
-        [this, errorCb, data, contentType](auto&& cb){
+        [this, errorCb, &data](auto&& cb){
             using T = std::decay_t<decltype(cb)>;
 
-            if constexpr (std::is_same_v<T, SuccessBytesCb>)
+            if constexpr (std::is_same_v<T, SuccessBytesCb> || std::is_same_v<T, SuccessStreamCb>)
             {
-                emit requestSuccessBytes(std::move(data), std::move(cb), contentType);
+                Q_ASSERT(false);
+                qWarning() << "Bytes callback cannot be decoded";
             }
             else if constexpr (std::is_same_v<T, SuccessJsonCb>)
             {
@@ -752,8 +1716,10 @@ void NetworkThread::invokeCallback(CallbackType successCb, const ErrorCb& errorC
             else
             {
                 try {
-                    QJsonDocument json(QJsonDocument::fromJson(data));
-                    auto reply = FromJson<T>::ReplyType::fromJson(json.object());
+                    const ATProto::XJsonDocument json(data);
+                    const ATProto::ArenaScope arenaScope(mArenaDecoding ? ATProto::Arena::create() : nullptr);
+                    const ATProto::LazyDecodeScope lazyScope(mLazyPostDecoding);
+                    auto reply = ATProto::XJsonObject::decode<typename FromJson<T>::ReplyType>(json.object());
                     emit (this->*FromJson<T>::sEmitFun)(std::move(reply), std::move(cb));
                 } catch (ATProto::InvalidJsonException& e) {
                     qWarning() << e.msg();
@@ -765,6 +1731,63 @@ void NetworkThread::invokeCallback(CallbackType successCb, const ErrorCb& errorC
     );
 }
 
+void NetworkThread::streamData(StreamTarget& stream, QNetworkReply* reply)
+{
+    // The body of an error reply is not written to the target. It is read when
+    // the reply is finished to determine how to handle the error.
+    if (!isSuccessStatus(reply) || stream.hasError())
+        return;
+
+    if (!stream.write(reply->readAll()))
+    {
+        // Triggers the error handling, which reports the stream error.
+        reply->abort();
+        return;
+    }
+
+    if (stream.getProgressCb() && stream.takeProgress())
+    {
+        const qint64 total = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+        emit requestProgress(stream.getBytesWritten(), total > 0 ? total : -1, stream.getProgressCb());
+    }
+}
+
+void NetworkThread::finishStream(StreamTarget& stream, QNetworkReply* reply, const QByteArray& data, const QString& contentType,
+                                 const CallbackType& successCb, const ErrorCb& errorCb)
+{
+    if (!stream.write(data) || !stream.commit())
+    {
+        stream.discard();
+        emit requestError(stream.getError(), {}, errorCb);
+        return;
+    }
+
+    qDebug() << "Streamed:" << stream.getBytesWritten() << "bytes" << reply->url();
+
+    if (stream.getProgressCb())
+        emit requestProgress(stream.getBytesWritten(), stream.getBytesWritten(), stream.getProgressCb());
+
+    const auto* streamCb = std::get_if<SuccessStreamCb>(&successCb);
+
+    if (streamCb && *streamCb)
+        emit requestSuccessStream(stream.getBytesWritten(), contentType, *streamCb);
+}
+
+bool NetworkThread::streamError(const Request& request, const ErrorCb& errorCb)
+{
+    if (!request.mStream)
+        return false;
+
+    // Partial data is dropped, a resend starts the download from the start.
+    request.mStream->discard();
+
+    if (!request.mStream->hasError())
+        return false;
+
+    emit requestError(request.mStream->getError(), {}, errorCb);
+    return true;
+}
+
 bool NetworkThread::resendRequest(Request request, const CallbackType& successCb, const ErrorCb& errorCb)
 {
     const QUrl requestUrl = request.mXrpcRequest.url();
@@ -775,37 +1798,170 @@ bool NetworkThread::resendRequest(Request request, const CallbackType& successCb
         return false;
     }
 
-    ++request.mResendCount;
-    qDebug() << "Resend:" << requestUrl << "count:" << request.mResendCount;
+    const auto delay = ATProto::RateLimiter::backoffDelay(request.mResendCount + 1);
 
-    if (request.mXrpcRequest.hasRawHeader("DPoP"))
+    if (!hasResendBudget(request, delay))
     {
-        // A new DPoP proof must be created, otherwise the resend will be seen as DPoP proof replay
-        const QString dpopProof = mDpopKey.buildPdsDPoPProof(
-            request.mIsPost ? "POST" : "GET", requestUrl.toString(), request.mAccessJwt, mPdsDpopNonce);
-        request.mXrpcRequest.setRawHeader("DPoP", dpopProof.toUtf8());
+        qWarning() << "No time left for resend:" << requestUrl;
+        emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, errorCb);
+        return true;
     }
 
-    sendRequest(request, successCb, errorCb);
+    ++request.mResendCount;
+    mMetrics.recordRetry(Metrics::Key::fromUrl(requestUrl));
+    qDebug() << "Resend:" << requestUrl << "count:" << request.mResendCount << "delay:" << delay.count() << "ms";
+
+    runLater(delay, [this, request, successCb, errorCb]{
+        sendRequest(request, successCb, errorCb);
+    });
+
+    return true;
+}
+
+bool NetworkThread::buildDpopProof(Request& request, const QString& accessJwt) const
+{
+    const QString dpopProof = mDpopKey.buildPdsDPoPProof(
+        request.mIsPost ? "POST" : "GET", request.mXrpcRequest.url().toString(), accessJwt, mPdsDpopNonce);
+
+    if (dpopProof.isEmpty())
+        return false;
+
+    request.mXrpcRequest.setRawHeader("DPoP", dpopProof.toUtf8());
+    request.mDpopNonce = mPdsDpopNonce;
     return true;
 }
 
-bool NetworkThread::resendRequestWithNewToken(Request request, const CallbackType& successCb, const ErrorCb& errorCb)
+bool NetworkThread::resendRequestWithNewToken(Request request, const CallbackType& successCb, const ErrorCb& errorCb,
+                                              const QString& error, const QJsonDocument& json)
 {
-    // TODO: this scenario may never happen.
-    // The case I saw was due to suspend/resume issues causing a background worker not
-    // to stop.
-    qDebug() << "New token resend:" << request.mXrpcRequest.url();
+    const QUrl requestUrl = request.mXrpcRequest.url();
+    qDebug() << "New token resend:" << requestUrl;
 
-    if (!mAccessJwt.isEmpty() && request.mAccessJwt == mAccessJwt)
+    if (!hasSessionToken(request) || request.mTokenRefreshed)
     {
-        qWarning() << "There is no new token:" << request.mXrpcRequest.url();
-        qDebug() << "Request:" << request.mXrpcRequest.url() << "token:" << request.mAccessJwt;
+        qWarning() << "Cannot get a new token:" << requestUrl;
         return false;
     }
 
-    request.mAccessJwt = mAccessJwt;
-    return resendRequest(request, successCb, errorCb);
+    if (mRefreshingJwt.isEmpty() && !mAccessJwt.isEmpty() && request.mAccessJwt != mAccessJwt)
+    {
+        // The token was refreshed while the request was in flight.
+        setAuthorization(request, mAccessJwt, false);
+        mMetrics.recordTokenRefreshResend(Metrics::Key::fromUrl(requestUrl));
+        return resendRequest(request, successCb, errorCb);
+    }
+
+    if (!mTokenRefreshEnabled)
+    {
+        qWarning() << "There is no new token:" << requestUrl;
+        qDebug() << "Request:" << requestUrl << "token:" << request.mAccessJwt;
+        return false;
+    }
+
+    parkForTokenRefresh({ std::move(request), successCb, errorCb, true, error, json });
+    return true;
+}
+
+bool NetworkThread::hasSessionToken(const Request& request)
+{
+    if (request.mAccessJwt.isEmpty() || request.mIsServiceAuthToken)
+        return false;
+
+    // These requests are authorized by the refresh token. Parking the refresh
+    // request itself would block the refresh forever.
+    const QString path = request.mXrpcRequest.url().path();
+    return !path.endsWith("/com.atproto.server.refreshSession") &&
+           !path.endsWith("/com.atproto.server.deleteSession");
+}
+
+bool NetworkThread::mustParkForTokenRefresh(const Request& request) const
+{
+    return !mRefreshingJwt.isEmpty() && request.mAccessJwt == mRefreshingJwt &&
+           !request.mTokenRefreshed && hasSessionToken(request);
+}
+
+void NetworkThread::parkForTokenRefresh(ParkedRequest parked)
+{
+    qDebug() << "Park request for token refresh:" << parked.mRequest.mXrpcRequest.url() << "failed:" << parked.mFailed;
+    const bool refreshing = !mRefreshingJwt.isEmpty();
+
+    if (!refreshing)
+        mRefreshingJwt = parked.mRequest.mAccessJwt;
+
+    parked.mParkId = ++mParkSequence;
+    const QDeadlineTimer& deadline = parked.mRequest.mDeadline;
+
+    if (!deadline.isForever())
+    {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline.remainingTimeAsDuration());
+        runLater(remaining, [this, parkId=parked.mParkId]{ expireParkedRequest(parkId); });
+    }
+
+    mParkedRequests.push_back(std::move(parked));
+
+    if (!refreshing)
+    {
+        qDebug() << "Token refresh needed";
+        emit tokenRefreshNeeded();
+    }
+}
+
+void NetworkThread::expireParkedRequest(quint64 parkId)
+{
+    auto it = std::find_if(mParkedRequests.begin(), mParkedRequests.end(),
+                           [parkId](const auto& parked){ return parked.mParkId == parkId; });
+
+    // Not found when the request got sent after the token refresh.
+    if (it == mParkedRequests.end())
+        return;
+
+    const ParkedRequest parked = std::move(*it);
+    mParkedRequests.erase(it);
+    qDebug() << "Deadline passed waiting for token refresh:" << parked.mRequest.mXrpcRequest.url();
+
+    if (!parked.mRequest.mHandle.isCancelled())
+        emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, parked.mErrorCb);
+}
+
+void NetworkThread::enableTokenRefresh(bool enable)
+{
+    qDebug() << "Enable token refresh:" << enable;
+    mTokenRefreshEnabled = enable;
+}
+
+void NetworkThread::finishTokenRefresh(const QString& accessJwt)
+{
+    qDebug() << "Token refresh finished:" << !accessJwt.isEmpty() << "parked:" << mParkedRequests.size();
+    mRefreshingJwt.clear();
+    auto parkedRequests = std::exchange(mParkedRequests, {});
+
+    if (!accessJwt.isEmpty())
+        setAccessJwt(accessJwt);
+
+    for (auto& parked : parkedRequests)
+    {
+        auto& request = parked.mRequest;
+
+        if (request.mHandle.isCancelled())
+            continue;
+
+        if (accessJwt.isEmpty())
+        {
+            if (parked.mFailed)
+                emit requestError(parked.mError, parked.mJson, parked.mErrorCb);
+            else
+                emit requestError(ATProto::ATProtoErrorMsg::EXPIRED_TOKEN, {}, parked.mErrorCb);
+
+            continue;
+        }
+
+        if (parked.mFailed)
+            mMetrics.recordTokenRefreshResend(Metrics::Key::fromUrl(request.mXrpcRequest.url()));
+
+        setAuthorization(request, accessJwt, false);
+        request.mTokenRefreshed = true;
+        sendRequest(request, parked.mSuccessCb, parked.mErrorCb);
+    }
 }
 
 bool NetworkThread::resendWithNewDpopNonce(Request request, const CallbackType& successCb, const ErrorCb& errorCb)
@@ -819,18 +1975,61 @@ bool NetworkThread::resendWithNewDpopNonce(Request request, const CallbackType&
         return false;
     }
 
+    if (!hasResendBudget(request, 0ms))
+    {
+        qWarning() << "No time left for DPoP resend:" << requestUrl;
+        emit requestError(ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, {}, errorCb);
+        return true;
+    }
+
     ++request.mDpopResendCount;
-    qDebug() << "DPoP resend:" << requestUrl << "count:" << request.mDpopResendCount;
-    const QString dpopProof = mDpopKey.buildPdsDPoPProof(
-        request.mIsPost ? "POST" : "GET", requestUrl.toString(), request.mAccessJwt, mPdsDpopNonce);
-    request.mXrpcRequest.setRawHeader("DPoP", dpopProof.toUtf8());
+    mMetrics.recordDpopNonceResend(Metrics::Key::fromUrl(requestUrl));
+    qDebug() << "DPoP resend:" << requestUrl << "count:" << request.mDpopResendCount << "seq:" << request.mSequence;
 
-    sendRequest(request, successCb, errorCb);
+    // After a nonce rotation all requests in flight fail. They are collected and
+    // rescheduled in their original order.
+    if (mDpopResends.empty())
+        QTimer::singleShot(0, this, [this]{ flushDpopResends(); });
+
+    mDpopResends.push_back({ std::move(request), successCb, errorCb });
     return true;
 }
 
-bool NetworkThread::mustResend(QNetworkReply::NetworkError error) const
+void NetworkThread::flushDpopResends()
+{
+    auto resends = std::exchange(mDpopResends, {});
+    qDebug() << "DPoP resends:" << resends.size() << "nonce:" << mPdsDpopNonce;
+
+    std::stable_sort(resends.begin(), resends.end(),
+        [](const ParkedRequest& lhs, const ParkedRequest& rhs){
+            return lhs.mRequest.mSequence < rhs.mRequest.mSequence;
+        });
+
+    for (const auto& resend : resends)
+        sendRequest(resend.mRequest, resend.mSuccessCb, resend.mErrorCb);
+}
+
+bool NetworkThread::hasResendBudget(const Request& request, std::chrono::milliseconds delay)
+{
+    if (request.mDeadline.isForever())
+        return true;
+
+    return request.mDeadline.remainingTimeAsDuration() >= delay + MIN_RESEND_BUDGET;
+}
+
+bool NetworkThread::mustResend(const QNetworkReply* reply, QNetworkReply::NetworkError error) const
 {
+    if (ATProto::RateLimiter::isRateLimited(reply))
+        return true;
+
+    // The server may have processed a POST before its connection stalled.
+    if (error == QNetworkReply::OperationCanceledError && reply->operation() == QNetworkAccessManager::PostOperation &&
+        Http2Watchdog::isStallAbort(reply))
+    {
+        qWarning() << "No resend of POST on stalled connection:" << reply->url();
+        return false;
+    }
+
     switch (error)
     {
     case QNetworkReply::NoError: // Unknown error seems to happen sometimes since Qt6.9.2
@@ -893,21 +2092,20 @@ void NetworkThread::setAuthorization(Request& request, const QString& accessJwt,
 {
     if (mOAuth && !isServiceAuthToken)
     {
-        const QUrl requestUrl = request.mXrpcRequest.url();
-        const QString dpopProof = mDpopKey.buildPdsDPoPProof(
-            request.mIsPost ? "POST" : "GET", requestUrl.toString(), accessJwt, mPdsDpopNonce);
-
+        // The DPoP proof is built when the request is sent.
         QString auth = QString("DPoP %1").arg(accessJwt);
         request.mXrpcRequest.setRawHeader("Authorization", auth.toUtf8());
-        request.mXrpcRequest.setRawHeader("DPoP", dpopProof.toUtf8());
+        request.mDpop = true;
     }
     else
     {
         QString auth = QString("Bearer %1").arg(accessJwt);
         request.mXrpcRequest.setRawHeader("Authorization", auth.toUtf8());
+        request.mDpop = false;
     }
 
     request.mAccessJwt = accessJwt;
+    request.mIsServiceAuthToken = isServiceAuthToken;
 }
 
 void NetworkThread::setRawHeaders(QNetworkRequest& request, const Params& params) const
@@ -953,7 +2151,7 @@ void NetworkThread::oauthLogin(const QString& user, const QString& clientId,
                                const OAuthLoginSuccessCb& successCb, const OAuthErrorCb& errorCb)
 {
     qDebug() << "Login:" << user << "clientId:" << clientId << "redirectUrl:" << redirectUrl << "scope:" << scope;
-    mDpopKey = ATProto::JsonWebKey::generateDPoPKey(user);
+    setDpopKey(ATProto::JsonWebKey::generateDPoPKey(user));
     enableOAuth(clientId);
 
     mOAuth->login(user, redirectUrl, scope,
@@ -1114,7 +2312,7 @@ void NetworkThread::oauthCleanup()
     if (ATProto::JsonWebKey::deleteKey(alias))
         qDebug() << "Deleted key:" << alias;
 #endif
-    mDpopKey = {};
+    setDpopKey({});
     mOAuthState.clear();
     mOAuthIssuer.clear();
     setPdsDpopNonce({});
@@ -1129,7 +2327,7 @@ const QString& NetworkThread::oauthDpopKeyGetAlias() const
 
 void NetworkThread::oauthSetDpopKeyAlias(const QString& alias)
 {
-    mDpopKey = ATProto::JsonWebKey(alias);
+    setDpopKey(ATProto::JsonWebKey(alias));
 }
 #else
 void NetworkThread::oauthSaveDpopKey(const QString& path, const QString& passPhrase)
@@ -1140,20 +2338,49 @@ void NetworkThread::oauthSaveDpopKey(const QString& path, const QString& passPhr
 
 void NetworkThread::oauthLoadDpopKey(const QString& path, const QString& passPhrase)
 {
-    mDpopKey = ATProto::JsonWebKey::load(path, passPhrase);
+    setDpopKey(ATProto::JsonWebKey::load(path, passPhrase));
 
     if (mDpopKey.isNull())
         qWarning() << "Could not load key";
 }
 #endif
 
+void NetworkThread::setDpopKey(ATProto::JsonWebKey key)
+{
+    // Running sign tasks use the current key.
+    mSignPool.waitForDone();
+    mDpopKey = std::move(key);
+}
+
 void NetworkThread::setPdsDpopNonce(const QString& nonce)
 {
     if (nonce == mPdsDpopNonce)
         return;
 
+    mPreviousPdsDpopNonce = mPdsDpopNonce;
     mPdsDpopNonce = nonce;
     emit pdsDpopNonceChanged(mPdsDpopNonce);
 }
 
+void NetworkThread::updatePdsDpopNonce(const QString& nonce)
+{
+    if (nonce == mPdsDpopNonce)
+        return;
+
+    // A reply sent before the rotation can arrive after a reply with the new nonce.
+    if (!mPreviousPdsDpopNonce.isEmpty() && nonce == mPreviousPdsDpopNonce)
+    {
+        qDebug() << "Ignore previous DPoP nonce:" << nonce;
+        return;
+    }
+
+    if (!mPdsDpopNonce.isEmpty())
+    {
+        ++mDpopNonceRotations;
+        qDebug() << "DPoP nonce rotated:" << mPdsDpopNonce << "->" << nonce << "rotations:" << mDpopNonceRotations.load();
+    }
+
+    setPdsDpopNonce(nonce);
+}
+
 }
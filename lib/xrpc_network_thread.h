@@ -2,6 +2,13 @@
 // License: GPLv3
 #pragma once
 #include "oauth.h"
+#include "rate_limiter.h"
+#include "xrpc_metrics.h"
+#include "xrpc_network_engine.h"
+#include "xrpc_request_handle.h"
+#include "xrpc_request_scheduler.h"
+#include "xrpc_response_cache.h"
+#include "xrpc_stream_target.h"
 #include "lexicon/app_bsky_actor.h"
 #include "lexicon/app_bsky_bookmark.h"
 #include "lexicon/app_bsky_draft.h"
@@ -16,15 +23,18 @@
 #include "lexicon/chat_bsky_notification.h"
 #include "lexicon/com_atproto_identity.h"
 #include "lexicon/com_atproto_server.h"
+#include <QDeadlineTimer>
 #include <QJsonDocument>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
-#include <QThread>
+#include <optional>
 
 namespace Xrpc {
 
-class NetworkThread : public QThread
+// Network state of a single XRPC client. The object lives on a shard thread of a
+// network engine. Multiple instances can live on the same shard.
+class NetworkThread : public QObject
 {
     Q_OBJECT
 public:
@@ -33,6 +43,7 @@ public:
     using ErrorCb = std::function<void(const QString& err, const QJsonDocument& json)>;
     using SuccessJsonCb = std::function<void(const QJsonDocument& json)>;
     using SuccessBytesCb = std::function<void(const QByteArray& bytes, const QString& contentType)>;
+    using SuccessStreamCb = std::function<void(qint64 size, const QString& contentType)>;
     using NewTokensCb = std::function<void(const QString& accessToken, const QString& refreshToken)>;
 
     // com.atproto.server
@@ -127,6 +138,7 @@ public:
     using CallbackType = std::variant<
         SuccessJsonCb,
         SuccessBytesCb,
+        SuccessStreamCb,
 
         // com.atproto.server
         SuccessSessionCb,
@@ -211,33 +223,106 @@ public:
         SuccessChatNotificationPreferencesOutputCb
     >;
 
+    // Decodes a reply while it is still arriving.
+    class IncrementalDecoder
+    {
+    public:
+        virtual ~IncrementalDecoder() = default;
+
+        // Called on the network thread for each chunk of the reply.
+        virtual void feed(const QByteArray& data) = 0;
+
+        // Called on the network thread with the last chunk of the reply.
+        virtual void finish(const QByteArray& data, const ErrorCb& errorCb) = 0;
+
+        // Bytes fed so far
+        virtual qint64 getBytesReceived() const = 0;
+    };
+
     struct Request
     {
         bool mIsPost = false;
         QNetworkRequest mXrpcRequest;
         DataType mData;
         QString mAccessJwt;
+        bool mIsServiceAuthToken = false;
+        bool mDpop = false; // a DPoP proof is built for each send
+        QString mDpopNonce; // nonce in the DPoP proof
+        quint64 mSequence = 0; // start order
+        bool mTokenRefreshed = false; // set when replayed after a token refresh
         int mResendCount = 0;
         int mDpopResendCount = 0;
         QDateTime mSendTime;
+        QString mCacheNsid; // set if the reply must be cached
+        QString mCacheKey;
+        bool mCacheRefresh = false; // set if the request refreshes a stale cache entry
+        RequestHandle mHandle;
+        RequestPriority mPriority = RequestPriority::NORMAL;
+        StreamTarget::SharedPtr mStream; // set if the reply must be streamed
+        std::shared_ptr<IncrementalDecoder> mDecoder; // set if the reply is decoded while it arrives
+        QDeadlineTimer mDeadline{QDeadlineTimer::Forever}; // for the call including resends
     };
 
-    NetworkThread(int networkTransferTimeoutMs, const QString& pdsDpopNonce = {}, QObject* parent = nullptr);
+    struct CoalesceStats
+    {
+        int mHits = 0; // requests that joined an identical request in flight
+        int mMisses = 0; // requests sent to the network
+    };
+
+    NetworkThread(QNetworkAccessManager* network, DecodePool& decodePool, RequestScheduler& scheduler,
+                  Metrics& metrics, TlsSessionStore& tlsSessionStore, ConnectionWarmer* warmer,
+                  Http2Watchdog* http2Watchdog, int networkTransferTimeoutMs, const QString& pdsDpopNonce = {}, QObject* parent = nullptr);
+    ~NetworkThread();
 
     void setPDS(const QString& pds);
     void setUserAgent(const QString& userAgent);
     void setVideoHost(const QString& host);
+    void prewarm(const QString& host);
+
+    // Rebinds this object to the resources of another shard before it gets moved to the
+    // thread of that shard. Only allowed when canMoveShard() is true.
+    void setShard(QNetworkAccessManager* network, RequestScheduler& scheduler,
+                  ConnectionWarmer* warmer, Http2Watchdog* http2Watchdog);
+
+    // True if no request is in flight, queued, parked or waiting for a resend, and
+    // there is no OAuth session.
+    bool canMoveShard() const;
+
+    // Thread safe
+    CoalesceStats getCoalesceStats() const;
+    int getDpopNonceRotationCount() const { return mDpopNonceRotations.load(); }
+    QHash<QString, ATProto::RateLimiter::BucketState> getRateLimitStates() const { return mRateLimiter.getStates(); }
+
+    // The response cache is disabled by default. Enabling sets the default
+    // policies for NSIDs that do not have a policy yet.
+    void enableResponseCache(bool enable);
+    void setResponseCachePolicy(const QString& nsid, const ResponseCache::Policy& policy);
+    void clearResponseCache();
+
+    void enableArenaDecoding(bool enable);
+    bool isArenaDecodingEnabled() const { return mArenaDecoding; }
+    void enableLazyPostDecoding(bool enable);
+    bool isLazyPostDecodingEnabled() const { return mLazyPostDecoding; }
 
     void postData(const QString& service, const NetworkThread::Params& params,
                   const DataType& data, const QString& mimeType, const Params& rawHeaders,
                   const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-                  bool isServiceAuthToken);
+                  bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+                  const QDeadlineTimer& deadline);
     void postJson(const QString& service, const QJsonDocument& json, const Params& rawHeaders,
                   const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-                  bool isServiceAuthToken);
+                  bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+                  const QDeadlineTimer& deadline);
     void get(const QString& service, const Params& params, const Params& rawHeaders,
              const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
-             bool isServiceAuthToken, const QString& pds);
+             bool isServiceAuthToken, const QString& pds, const RequestHandle& handle, RequestPriority priority,
+             const QDeadlineTimer& deadline);
+
+    // Writes the reply to the stream target as it arrives.
+    void getStream(const QString& service, const Params& params, const Params& rawHeaders,
+                   const StreamTarget::SharedPtr& target, const SuccessStreamCb& successCb, const ErrorCb& errorCb,
+                   const QString& accessJwt, const QString& pds, const RequestHandle& handle, RequestPriority priority,
+                   const QDeadlineTimer& deadline);
 
     // OAuth
     // OAuth is done from the network thread. Creating DPoP proofs is expensive (15ms on Android).
@@ -248,6 +333,13 @@ public:
     void setDpopNonces(const QString& pdsDpopNonce, const QString& authDpopNonce);
     void setOAuthNewTokensCb(const NewTokensCb& cb);
 
+    // When enabled, the first token failure triggers a single refresh of the access
+    // token via the tokenRefreshNeeded signal. Requests failing with the old token and
+    // new requests with the old token are parked until finishTokenRefresh is called.
+    // Then they are replayed with the new token. An empty token means the refresh failed.
+    void enableTokenRefresh(bool enable);
+    void finishTokenRefresh(const QString& accessJwt);
+
     void oauthLogin(const QString& user, const QString& clientId,
                     const QString& redirectUrl, const QStringList& scope,
                     const OAuthLoginSuccessCb& successCb, const OAuthErrorCb& errorCb);
@@ -278,6 +370,8 @@ signals:
     // clazy:excludeall=fully-qualified-moc-types
     void requestSuccessJson(QJsonDocument json, SuccessJsonCb cb);
     void requestSuccessBytes(QByteArray bytes, SuccessBytesCb cb, QString contentType);
+    void requestSuccessStream(qint64 size, QString contentType, SuccessStreamCb cb);
+    void requestProgress(qint64 bytesReceived, qint64 bytesTotal, StreamTarget::ProgressCb cb);
 
     // com.atproto.server
     void requestSuccessSession(ATProto::ComATProtoServer::Session::SharedPtr, SuccessSessionCb);
@@ -374,9 +468,7 @@ signals:
     void oauthLoggedOut(OAuthLogoutSuccessCb cb);
     void pdsDpopNonceChanged(QString nonce);
     void authDpopNonceChanged(QString nonce);
-
-protected:
-    virtual void run() override;
+    void tokenRefreshNeeded();
 
 private:
     QUrl buildUrl(const QString& service, const QString& pds = {}) const;
@@ -387,12 +479,29 @@ private:
 
     void setAccessJwt(const QString &jwt);
     void updateSessionTokens(ATProto::ComATProtoServer::Session::SharedPtr session);
-    void sendRequest(Request& request, const CallbackType& successCb, const ErrorCb& errorCb);
+    void sendRequest(const Request& request, const CallbackType& successCb, const ErrorCb& errorCb);
+    void signAndScheduleRequest(Request request, const CallbackType& successCb, const ErrorCb& errorCb);
+    void scheduleRequest(const Request& request, const CallbackType& successCb, const ErrorCb& errorCb);
+    bool startRequest(Request& request, const CallbackType& successCb, const ErrorCb& errorCb);
+    // The resend functions return false if the request must fail with the error
+    // of the reply. When the deadline of the request leaves no time for a resend,
+    // the request fails with a timeout.
     bool resendRequest(Request request, const CallbackType& successCb, const ErrorCb& errorCb);
-    bool resendRequestWithNewToken(Request request, const CallbackType& successCb, const ErrorCb& errorCb);
+    bool resendRequestWithNewToken(Request request, const CallbackType& successCb, const ErrorCb& errorCb,
+                                   const QString& error, const QJsonDocument& json);
     bool resendWithNewDpopNonce(Request request, const CallbackType& successCb, const ErrorCb& errorCb);
-    bool mustResend(QNetworkReply::NetworkError error) const;
-    void invokeCallback(CallbackType successCb, const ErrorCb& errorCb, QByteArray data, const QString& contentType);
+    static bool hasResendBudget(const Request& request, std::chrono::milliseconds delay);
+    bool buildDpopProof(Request& request, const QString& accessJwt) const;
+    void flushDpopResends();
+    bool mustResend(const QNetworkReply* reply, QNetworkReply::NetworkError error) const;
+    void invokeCallback(CallbackType successCb, const ErrorCb& errorCb, QByteArray data, const QString& contentType,
+                        const RequestHandle& handle, const Metrics::Key& metricsKey);
+    void decodeReply(CallbackType successCb, const ErrorCb& errorCb, const QByteArray& data);
+    std::shared_ptr<IncrementalDecoder> makeIncrementalDecoder(const Request& request, const CallbackType& successCb);
+    void streamData(StreamTarget& stream, QNetworkReply* reply);
+    void finishStream(StreamTarget& stream, QNetworkReply* reply, const QByteArray& data, const QString& contentType,
+                      const CallbackType& successCb, const ErrorCb& errorCb);
+    bool streamError(const Request& request, const ErrorCb& errorCb);
     void replyFinished(const Request& request, QNetworkReply* reply,
                        CallbackType successCb, const ErrorCb& errorCb,
                        std::shared_ptr<bool> errorHandled);
@@ -401,8 +510,74 @@ private:
                       std::shared_ptr<bool> errorHandled);
     void sslErrors(QNetworkReply* reply, const QList<QSslError>& errors, const ErrorCb& errorCb, std::shared_ptr<bool> errorHandled);
 
+    // Identical GET requests in flight are coalesced into a single network request.
+    // The reply is passed to the callbacks of all coalesced requests.
+    // The network request has its own handle. It gets cancelled when all
+    // coalesced requests are cancelled.
+    struct InFlightWaiter
+    {
+        CallbackType mSuccessCb;
+        ErrorCb mErrorCb;
+        RequestHandle mHandle;
+        quint64 mId = 0;
+    };
+
+    struct InFlightGet
+    {
+        QMutex mMutex;
+        bool mDone = false;
+        bool mCacheRefresh = false; // refreshes a stale cache entry, waiters are optional
+        std::vector<InFlightWaiter> mWaiters;
+        RequestHandle mHandle = RequestHandle::create();
+
+        bool join(const InFlightWaiter& waiter);
+        std::vector<InFlightWaiter> takeWaiters();
+        std::optional<InFlightWaiter> removeWaiter(quint64 id);
+        bool allCancelled();
+        bool isActive();
+    };
+
+    static QString getInFlightKey(const QString& requestKey, const CallbackType& successCb);
+    static QString getCacheRefreshKey(const QString& requestKey);
+    void sendGet(const QString& service, const QUrl& url, const QString& requestKey, const Params& rawHeaders,
+                 const CallbackType& successCb, const ErrorCb& errorCb, const QString& accessJwt,
+                 bool isServiceAuthToken, const RequestHandle& handle, RequestPriority priority,
+                 const QDeadlineTimer& deadline);
+    void refreshCacheEntry(const QString& service, const QUrl& url, const QString& requestKey,
+                           const Params& rawHeaders, const CallbackType& successCb,
+                           const QString& accessJwt, bool isServiceAuthToken);
+    void finishCacheRefresh(const Request& request, const QByteArray& data, const QString& contentType,
+                            const Metrics::Key& metricsKey);
+    std::shared_ptr<InFlightGet> startInFlightGet(const QString& key);
+    static bool joinInFlightGet(std::shared_ptr<InFlightGet> inFlight, const InFlightWaiter& waiter);
+    void watchWaiterDeadline(std::shared_ptr<InFlightGet> inFlight, quint64 waiterId, const QDeadlineTimer& deadline);
+    void expireWaiter(std::weak_ptr<InFlightGet> weakInFlight, quint64 waiterId);
+    static CallbackType fanOutSuccess(std::shared_ptr<InFlightGet> inFlight, const CallbackType& successCb);
+    static ErrorCb fanOutError(std::shared_ptr<InFlightGet> inFlight);
+
+    // Runs the function after the delay on the thread of this object.
+    void runLater(std::chrono::milliseconds delay, const std::function<void()>& fun);
+
     void oauthCleanup();
+    void setDpopKey(ATProto::JsonWebKey key);
     void setPdsDpopNonce(const QString& nonce);
+    void updatePdsDpopNonce(const QString& nonce);
+
+    struct ParkedRequest
+    {
+        Request mRequest;
+        CallbackType mSuccessCb;
+        ErrorCb mErrorCb;
+        bool mFailed = false; // the request failed with the old token
+        QString mError;
+        QJsonDocument mJson;
+        quint64 mParkId = 0;
+    };
+
+    static bool hasSessionToken(const Request& request);
+    bool mustParkForTokenRefresh(const Request& request) const;
+    void parkForTokenRefresh(ParkedRequest parked);
+    void expireParkedRequest(quint64 parkId);
 
     struct Task
     {
@@ -411,6 +586,11 @@ private:
     };
 
     QNetworkAccessManager* mNetwork;
+    RequestScheduler* mScheduler; // shared with the other clients on the shard
+    Metrics& mMetrics; // shared with the other clients on the engine
+    TlsSessionStore& mTlsSessionStore; // shared with the other clients on the engine
+    ConnectionWarmer* mWarmer; // shared with the other clients on the shard
+    Http2Watchdog* mHttp2Watchdog; // shared with the other clients on the shard
     int mNetworkTransferTimeoutMs;
     QString mPDS;
     QString mUserAgent;
@@ -421,8 +601,35 @@ private:
     QString mOAuthState;
     QString mOAuthIssuer;
     QString mPdsDpopNonce;
+    QString mPreviousPdsDpopNonce;
+    std::atomic_int mDpopNonceRotations = 0;
+    std::atomic_bool mArenaDecoding = false; // read by decode tasks
+    std::atomic_bool mLazyPostDecoding = false; // read by decode tasks
+    std::vector<ParkedRequest> mDpopResends; // rescheduled in start order
+    quint64 mStartSequence = 0;
     QString mAccessJwt;
     NewTokensCb mOAuthNewTokensCb;
+
+    bool mTokenRefreshEnabled = false;
+    QString mRefreshingJwt; // set while a token refresh is in progress
+    std::vector<ParkedRequest> mParkedRequests;
+    quint64 mParkSequence = 0;
+    int mPendingTimers = 0; // started by runLater()
+
+    std::unordered_map<QString, std::shared_ptr<InFlightGet>> mInFlightGets;
+    quint64 mWaiterSequence = 0;
+    std::atomic_int mCoalesceHits = 0;
+    std::atomic_int mCoalesceMisses = 0;
+    ResponseCache mResponseCache;
+    ATProto::RateLimiter mRateLimiter;
+
+    // Decode tasks emit signals from this object, so they must be finished
+    // before anything else gets destroyed.
+    DecodePool::TaskGroup mDecodeTasks;
+
+    // DPoP proofs are signed on their own pool, such that a request does not wait
+    // for the decoding of large replies before it can be sent.
+    DecodePool mSignPool;
 };
 
 }
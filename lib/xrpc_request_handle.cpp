@@ -0,0 +1,110 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_request_handle.h"
+#include <QDebug>
+#include <QMutex>
+
+namespace Xrpc {
+
+struct RequestHandle::State
+{
+    std::atomic_bool mCancelled = false;
+    QMutex mMutex;
+    QNetworkReply* mReply = nullptr;
+    std::vector<std::function<void()>> mCancelCbs;
+};
+
+RequestHandle RequestHandle::create()
+{
+    RequestHandle handle;
+    handle.mState = std::make_shared<State>();
+    return handle;
+}
+
+bool RequestHandle::isCancelled() const
+{
+    return mState && mState->mCancelled;
+}
+
+void RequestHandle::cancel() const
+{
+    if (!mState || mState->mCancelled.exchange(true))
+        return;
+
+    std::vector<std::function<void()>> cancelCbs;
+
+    {
+        QMutexLocker locker(&mState->mMutex);
+
+        // The reply lives on the network thread. It cannot be deleted while
+        // the mutex is locked. If it gets deleted before the abort is handled,
+        // then the posted abort gets discarded.
+        if (mState->mReply)
+        {
+            qDebug() << "Abort request:" << mState->mReply->url();
+            QMetaObject::invokeMethod(mState->mReply, &QNetworkReply::abort, Qt::QueuedConnection);
+        }
+
+        cancelCbs = std::move(mState->mCancelCbs);
+    }
+
+    for (const auto& cb : cancelCbs)
+        cb();
+}
+
+void RequestHandle::chain(const RequestHandle& child) const
+{
+    if (child.isNull() || child.mState == mState)
+        return;
+
+    onCancel([child]{ child.cancel(); });
+}
+
+void RequestHandle::onCancel(const std::function<void()>& cb) const
+{
+    if (!mState)
+        return;
+
+    {
+        QMutexLocker locker(&mState->mMutex);
+
+        if (!mState->mCancelled)
+        {
+            mState->mCancelCbs.push_back(cb);
+            return;
+        }
+    }
+
+    cb();
+}
+
+void RequestHandle::setReply(QNetworkReply* reply) const
+{
+    if (!mState)
+        return;
+
+    QMutexLocker locker(&mState->mMutex);
+    mState->mReply = reply;
+
+    if (!reply)
+        return;
+
+    // Cancelled before the reply was set.
+    if (mState->mCancelled)
+        QMetaObject::invokeMethod(reply, &QNetworkReply::abort, Qt::QueuedConnection);
+
+    QObject::connect(reply, &QObject::destroyed,
+        [weakState=std::weak_ptr<State>(mState), reply]{
+            auto state = weakState.lock();
+
+            if (!state)
+                return;
+
+            QMutexLocker locker(&state->mMutex);
+
+            if (state->mReply == reply)
+                state->mReply = nullptr;
+        });
+}
+
+}
@@ -0,0 +1,43 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QNetworkReply>
+#include <functional>
+#include <memory>
+
+namespace Xrpc {
+
+// Handle to cancel a request. After cancel() no callbacks of the request get
+// called. A reply in flight is aborted and a reply that is not decoded yet will
+// not be decoded.
+// A default constructed handle is a null handle that cannot be cancelled.
+// Copies of a handle share the same state. All functions are thread safe.
+class RequestHandle
+{
+public:
+    RequestHandle() = default;
+    static RequestHandle create();
+
+    bool isNull() const { return !mState; }
+    bool operator==(const RequestHandle& other) const { return mState == other.mState; }
+    bool isCancelled() const;
+    void cancel() const;
+
+    // The child gets cancelled when this handle gets cancelled. This is for requests
+    // that consist of multiple stages. If this handle is already cancelled, then
+    // the child is cancelled right away.
+    void chain(const RequestHandle& child) const;
+
+    // Called once when the handle gets cancelled. If the handle is already cancelled,
+    // then the callback is called right away.
+    void onCancel(const std::function<void()>& cb) const;
+
+    // For the network thread. The reply will be aborted on cancel.
+    void setReply(QNetworkReply* reply) const;
+
+private:
+    struct State;
+    std::shared_ptr<State> mState;
+};
+
+}
@@ -0,0 +1,276 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_request_scheduler.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+
+namespace Xrpc {
+
+bool RequestScheduler::Host::isIdle() const
+{
+    if (mInFlight > 0)
+        return false;
+
+    return std::all_of(mQueues.begin(), mQueues.end(), [](const Queue& queue){ return queue.empty(); });
+}
+
+RequestScheduler::RequestScheduler(int maxInFlight, int maxInFlightPerHost) :
+    mMaxInFlight(std::max(maxInFlight, 1)),
+    mMaxInFlightPerHost(std::clamp(maxInFlightPerHost, 1, mMaxInFlight)),
+    mMaxBackgroundInFlight(std::max(mMaxInFlight / 2, 1))
+{
+    qDebug() << "Max in flight:" << mMaxInFlight << "per host:" << mMaxInFlightPerHost << "background:" << mMaxBackgroundInFlight;
+}
+
+bool RequestScheduler::hasFreeSlot(const Host& host, RequestPriority priority) const
+{
+    if (mInFlight >= mMaxInFlight || host.mInFlight >= mMaxInFlightPerHost)
+        return false;
+
+    return priority != RequestPriority::BACKGROUND || mBackgroundInFlight < mMaxBackgroundInFlight;
+}
+
+void RequestScheduler::submit(const void* owner, const QString& host, RequestPriority priority,
+                              const RequestHandle& handle, const StartFun& startFun)
+{
+    Q_ASSERT(startFun);
+    auto& hostState = mHosts[host];
+    Entry entry{ owner, handle, startFun, {} };
+
+    // After each dispatch no queued request can be started. So if there is a free
+    // slot, then this request does not overtake any request that could use it.
+    if (hasFreeSlot(hostState, priority))
+    {
+        start(host, priority, entry);
+        return;
+    }
+
+    entry.mQueuedTimer.start();
+    enqueue(host, hostState, priority, std::move(entry));
+}
+
+void RequestScheduler::enqueue(const QString& hostName, Host& host, RequestPriority priority, Entry entry)
+{
+    auto& queue = host.mQueues[(int)priority];
+
+    if (queue.empty())
+        mHostRings[(int)priority].push_back(hostName);
+
+    queue.push_back(std::move(entry));
+}
+
+void RequestScheduler::start(const QString& hostName, RequestPriority priority, Entry& entry)
+{
+    const qint64 delayMs = entry.mQueuedTimer.isValid() ? entry.mQueuedTimer.elapsed() : 0;
+
+    ++mInFlight;
+    ++mHosts[hostName].mInFlight;
+
+    if (priority == RequestPriority::BACKGROUND)
+        ++mBackgroundInFlight;
+
+    if (!entry.mStart(priority))
+    {
+        finished(hostName, priority);
+        return;
+    }
+
+    auto& stats = mStats[(int)priority];
+    ++stats.mStarted;
+    stats.mTotalQueueDelayMs += delayMs;
+    stats.mMaxQueueDelayMs = std::max(stats.mMaxQueueDelayMs, delayMs);
+
+    if (delayMs > 0)
+        qDebug() << "Request queued:" << hostName << "priority:" << (int)priority << "delay:" << delayMs << "ms";
+}
+
+void RequestScheduler::finished(const QString& host, RequestPriority priority)
+{
+    auto it = mHosts.find(host);
+    Q_ASSERT(it != mHosts.end());
+
+    if (it == mHosts.end() || it->second.mInFlight <= 0 || mInFlight <= 0)
+    {
+        qWarning() << "Request not in flight:" << host;
+        return;
+    }
+
+    --mInFlight;
+    --it->second.mInFlight;
+
+    if (priority == RequestPriority::BACKGROUND)
+        --mBackgroundInFlight;
+
+    removeIdleHost(host);
+    dispatch();
+}
+
+bool RequestScheduler::startNext()
+{
+    for (int p = 0; p < PRIORITY_COUNT; ++p)
+    {
+        const auto priority = RequestPriority(p);
+
+        if (priority == RequestPriority::BACKGROUND && mBackgroundInFlight >= mMaxBackgroundInFlight)
+            continue;
+
+        auto& ring = mHostRings[p];
+
+        for (auto n = ring.size(); n > 0 && !ring.empty(); --n)
+        {
+            const QString hostName = ring.front();
+            ring.pop_front();
+            auto it = mHosts.find(hostName);
+
+            if (it == mHosts.end())
+                continue;
+
+            auto& queue = it->second.mQueues[p];
+
+            while (!queue.empty() && queue.front().mHandle.isCancelled())
+                queue.pop_front();
+
+            if (queue.empty())
+            {
+                removeIdleHost(hostName);
+                continue;
+            }
+
+            if (it->second.mInFlight >= mMaxInFlightPerHost)
+            {
+                ring.push_back(hostName);
+                continue;
+            }
+
+            Entry entry = std::move(queue.front());
+            queue.pop_front();
+
+            // Next turn for this host after the other hosts.
+            if (!queue.empty())
+                ring.push_back(hostName);
+
+            start(hostName, priority, entry);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RequestScheduler::dispatch()
+{
+    // A start function may finish a request right away.
+    if (mDispatching)
+        return;
+
+    mDispatching = true;
+
+    while (mInFlight < mMaxInFlight && startNext())
+        ;
+
+    mDispatching = false;
+}
+
+void RequestScheduler::raisePriority(const RequestHandle& handle, RequestPriority priority)
+{
+    if (handle.isNull())
+        return;
+
+    for (auto& [hostName, host] : mHosts)
+    {
+        for (int p = (int)priority + 1; p < PRIORITY_COUNT; ++p)
+        {
+            auto& queue = host.mQueues[p];
+            auto it = std::find_if(queue.begin(), queue.end(),
+                                   [&handle](const Entry& entry){ return entry.mHandle == handle; });
+
+            if (it == queue.end())
+                continue;
+
+            Entry entry = std::move(*it);
+            queue.erase(it);
+
+            if (queue.empty())
+                std::erase(mHostRings[p], hostName);
+
+            qDebug() << "Raise priority:" << hostName << p << "->" << (int)priority;
+            enqueue(hostName, host, priority, std::move(entry));
+            dispatch();
+            return;
+        }
+    }
+}
+
+void RequestScheduler::removeQueued(const void* owner)
+{
+    for (auto& [hostName, host] : mHosts)
+    {
+        for (int p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            auto& queue = host.mQueues[p];
+
+            if (std::erase_if(queue, [owner](const Entry& entry){ return entry.mOwner == owner; }) > 0 && queue.empty())
+                std::erase(mHostRings[p], hostName);
+        }
+    }
+
+    QStringList idleHosts;
+
+    for (const auto& [hostName, host] : mHosts)
+    {
+        if (host.isIdle())
+            idleHosts.push_back(hostName);
+    }
+
+    for (const auto& hostName : idleHosts)
+        removeIdleHost(hostName);
+}
+
+bool RequestScheduler::hasQueued(const void* owner) const
+{
+    for (const auto& item : mHosts)
+    {
+        for (const auto& queue : item.second.mQueues)
+        {
+            if (std::ranges::any_of(queue, [owner](const Entry& entry){ return entry.mOwner == owner; }))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void RequestScheduler::removeIdleHost(const QString& hostName)
+{
+    auto it = mHosts.find(hostName);
+
+    if (it == mHosts.end() || !it->second.isIdle())
+        return;
+
+    mHosts.erase(it);
+
+    for (auto& ring : mHostRings)
+        std::erase(ring, hostName);
+}
+
+int RequestScheduler::getInFlightCount(const QString& host) const
+{
+    auto it = mHosts.find(host);
+    return it != mHosts.end() ? it->second.mInFlight : 0;
+}
+
+int RequestScheduler::getQueuedCount() const
+{
+    int count = 0;
+
+    for (const auto& item : mHosts)
+    {
+        for (const auto& queue : item.second.mQueues)
+            count += (int)queue.size();
+    }
+
+    return count;
+}
+
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "xrpc_request_handle.h"
+#include <QElapsedTimer>
+#include <QString>
+#include <array>
+#include <deque>
+#include <unordered_map>
+
+namespace Xrpc {
+
+enum class RequestPriority
+{
+    INTERACTIVE = 0, // the user is waiting for the reply
+    NORMAL,
+    BACKGROUND // prefetching, polling, session refresh
+};
+
+// Schedules the requests of all clients on a network shard.
+// The number of requests in flight is capped in total and per host. A free slot
+// goes to the highest priority request. Hosts having queued requests of the same
+// priority take turns. Background requests can take at most half of the slots, such
+// that there is always room for other requests.
+// Not thread safe, it must only be used from the thread of the shard.
+class RequestScheduler
+{
+public:
+    // Starts the request with the priority it is counted under, which differs from
+    // the submitted priority when it got raised while queued. The same priority must
+    // be passed to finished(). Returns false if the request was not started, e.g.
+    // because it got cancelled while queued.
+    using StartFun = std::function<bool(RequestPriority priority)>;
+
+    static constexpr int DEFAULT_MAX_IN_FLIGHT = 24;
+    static constexpr int DEFAULT_MAX_IN_FLIGHT_PER_HOST = 8;
+    static constexpr int PRIORITY_COUNT = 3;
+
+    struct Stats
+    {
+        int mStarted = 0;
+        qint64 mTotalQueueDelayMs = 0;
+        qint64 mMaxQueueDelayMs = 0;
+
+        qint64 getMeanQueueDelayMs() const { return mStarted > 0 ? mTotalQueueDelayMs / mStarted : 0; }
+    };
+
+    explicit RequestScheduler(int maxInFlight = DEFAULT_MAX_IN_FLIGHT,
+                              int maxInFlightPerHost = DEFAULT_MAX_IN_FLIGHT_PER_HOST);
+
+    // Starts the request right away if there is a free slot, otherwise the request is
+    // queued. The owner identifies the queued requests for removal.
+    void submit(const void* owner, const QString& host, RequestPriority priority,
+                const RequestHandle& handle, const StartFun& startFun);
+
+    // Must be called once for every started request when it is done, with the
+    // priority passed to its start function.
+    void finished(const QString& host, RequestPriority priority);
+
+    // Raises the priority of a queued request, e.g. when an interactive request
+    // joins a background request.
+    void raisePriority(const RequestHandle& handle, RequestPriority priority);
+
+    // Removes all queued requests of the owner.
+    void removeQueued(const void* owner);
+
+    bool hasQueued(const void* owner) const;
+
+    int getInFlightCount() const { return mInFlight; }
+    int getInFlightCount(const QString& host) const;
+    int getQueuedCount() const;
+    const Stats& getStats(RequestPriority priority) const { return mStats[(int)priority]; }
+
+private:
+    struct Entry
+    {
+        const void* mOwner = nullptr;
+        RequestHandle mHandle;
+        StartFun mStart;
+        QElapsedTimer mQueuedTimer;
+    };
+
+    using Queue = std::deque<Entry>;
+
+    struct Host
+    {
+        int mInFlight = 0;
+        std::array<Queue, PRIORITY_COUNT> mQueues;
+
+        bool isIdle() const;
+    };
+
+    bool hasFreeSlot(const Host& host, RequestPriority priority) const;
+    void enqueue(const QString& hostName, Host& host, RequestPriority priority, Entry entry);
+    void start(const QString& hostName, RequestPriority priority, Entry& entry);
+    bool startNext();
+    void dispatch();
+    void removeIdleHost(const QString& hostName);
+
+    const int mMaxInFlight;
+    const int mMaxInFlightPerHost;
+    const int mMaxBackgroundInFlight;
+    int mInFlight = 0;
+    int mBackgroundInFlight = 0;
+    bool mDispatching = false;
+    std::unordered_map<QString, Host> mHosts;
+
+    // Per priority, the hosts having queued requests in round-robin order.
+    std::array<std::deque<QString>, PRIORITY_COUNT> mHostRings;
+
+    std::array<Stats, PRIORITY_COUNT> mStats;
+};
+
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_response_cache.h"
+#include <QDebug>
+#include <QStringList>
+
+namespace Xrpc {
+
+using namespace std::chrono_literals;
+
+void ResponseCache::setPolicy(const QString& nsid, const Policy& policy)
+{
+    Q_ASSERT(policy.mMaxEntries > 0);
+    Q_ASSERT(policy.mMaxBytes > 0);
+    qDebug() << "Cache policy:" << nsid << "ttl:" << policy.mTtl.count() << "maxStale:" << policy.mMaxStale.count()
+             << "maxEntries:" << policy.mMaxEntries << "maxBytes:" << policy.mMaxBytes;
+
+    auto cache = std::make_unique<NsidCache>();
+    cache->mPolicy = policy;
+    cache->mEntries.setMaxCost(policy.mMaxBytes);
+    mCaches[nsid] = std::move(cache);
+}
+
+void ResponseCache::removePolicy(const QString& nsid)
+{
+    mCaches.erase(nsid);
+}
+
+std::optional<ResponseCache::Lookup> ResponseCache::find(const QString& nsid, const QString& key, Clock::time_point now)
+{
+    auto it = mCaches.find(nsid);
+
+    if (it == mCaches.end())
+        return {};
+
+    auto& cache = *it->second;
+    const Entry* entry = cache.mEntries.object(key);
+
+    if (!entry)
+        return {};
+
+    const auto age = now - entry->mReceivedAt;
+
+    if (age < cache.mPolicy.mTtl)
+        return Lookup{ entry->mData, entry->mContentType, Freshness::FRESH };
+
+    if (age < cache.mPolicy.mTtl + cache.mPolicy.mMaxStale)
+        return Lookup{ entry->mData, entry->mContentType, Freshness::STALE };
+
+    qDebug() << "Expired:" << nsid << "age:" << age / 1s;
+    cache.mEntries.remove(key);
+    return {};
+}
+
+void ResponseCache::insert(const QString& nsid, const QString& key, const QByteArray& data, const QString& contentType,
+                           Clock::time_point now)
+{
+    auto it = mCaches.find(nsid);
+
+    if (it == mCaches.end())
+        return;
+
+    auto& cache = *it->second;
+
+    // The cost of an entry is at least the budget divided by the max entries.
+    // That way the cache holds at most mMaxEntries and at most mMaxBytes.
+    const qint64 minCost = cache.mPolicy.mMaxBytes / cache.mPolicy.mMaxEntries;
+    const qint64 cost = std::max((qint64)data.size(), minCost);
+
+    if (cost > cache.mPolicy.mMaxBytes)
+    {
+        qDebug() << "Reply too large to cache:" << nsid << data.size();
+        cache.mEntries.remove(key);
+        return;
+    }
+
+    auto* entry = new Entry{ data, contentType, now };
+    cache.mEntries.insert(key, entry, cost);
+}
+
+void ResponseCache::clear()
+{
+    for (auto& [_, cache] : mCaches)
+        cache->mEntries.clear();
+}
+
+QString ResponseCache::makeKey(const QUrl& url, const Params& rawHeaders, const QString& accessJwt, bool isServiceAuthToken)
+{
+    // All session tokens of a client identify the same account. A service auth
+    // token is scoped to a service and method, so the token itself identifies the auth.
+    QString auth;
+
+    if (!accessJwt.isNull())
+        auth = isServiceAuthToken ? accessJwt : QStringLiteral("session");
+
+    // The headers carry the proxy and labelers.
+    QStringList headers;
+
+    for (const auto& [name, value] : rawHeaders)
+        headers.push_back(name.toLower() + ':' + value);
+
+    headers.sort();
+
+    return QString("%1\n%2\n%3").arg(url.toString(QUrl::FullyEncoded), auth, headers.join('\n'));
+}
+
+const std::unordered_map<QString, ResponseCache::Policy>& ResponseCache::defaultPolicies()
+{
+    static const std::unordered_map<QString, Policy> POLICIES = {
+        { "app.bsky.actor.getProfiles", { 30s, 5min, 64, 2 * 1024 * 1024 } },
+        { "app.bsky.feed.getFeedGenerators", { 5min, 1h, 64, 1024 * 1024 } },
+        { "app.bsky.labeler.getServices", { 10min, 1h, 32, 512 * 1024 } },
+        { "app.bsky.unspecced.getSuggestedStarterPacks", { 10min, 1h, 8, 512 * 1024 } },
+        { "app.bsky.unspecced.getTrends", { 2min, 10min, 8, 256 * 1024 } }
+    };
+
+    return POLICIES;
+}
+
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QByteArray>
+#include <QCache>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QUrl>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace Xrpc {
+
+// Cache of raw replies for read-only XRPC requests with a per NSID policy.
+// A fresh entry is served without a network request. A stale entry is served
+// while the caller refreshes it in the background.
+// Not thread safe, must be used from the network thread.
+class ResponseCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Params = QList<QPair<QString, QString>>;
+
+    struct Policy
+    {
+        std::chrono::seconds mTtl{60}; // entry is fresh till this age
+        std::chrono::seconds mMaxStale{0}; // after the TTL a stale entry can be served for this time
+        int mMaxEntries = 32;
+        qint64 mMaxBytes = 256 * 1024;
+    };
+
+    enum class Freshness
+    {
+        FRESH,
+        STALE
+    };
+
+    struct Lookup
+    {
+        QByteArray mData;
+        QString mContentType;
+        Freshness mFreshness;
+    };
+
+    void setPolicy(const QString& nsid, const Policy& policy);
+    void removePolicy(const QString& nsid);
+    bool hasPolicy(const QString& nsid) const { return mCaches.contains(nsid); }
+
+    // Expired entries are removed and not returned.
+    std::optional<Lookup> find(const QString& nsid, const QString& key, Clock::time_point now = Clock::now());
+    void insert(const QString& nsid, const QString& key, const QByteArray& data, const QString& contentType,
+                Clock::time_point now = Clock::now());
+    void clear();
+
+    // Key of a request. Requests with different auth or headers are cached separately.
+    static QString makeKey(const QUrl& url, const Params& rawHeaders, const QString& accessJwt, bool isServiceAuthToken);
+
+    static const std::unordered_map<QString, Policy>& defaultPolicies();
+
+private:
+    struct Entry
+    {
+        QByteArray mData;
+        QString mContentType;
+        Clock::time_point mReceivedAt;
+    };
+
+    struct NsidCache
+    {
+        Policy mPolicy;
+        QCache<QString, Entry> mEntries;
+    };
+
+    std::unordered_map<QString, std::unique_ptr<NsidCache>> mCaches;
+};
+
+}
@@ -0,0 +1,134 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_stream_target.h"
+#include <QDebug>
+
+namespace Xrpc {
+
+StreamTarget::StreamTarget(QIODevice* device) :
+    mDevice(device)
+{
+    Q_ASSERT(mDevice);
+}
+
+StreamTarget::StreamTarget(const QString& filePath) :
+    mFilePath(filePath)
+{
+    Q_ASSERT(!mFilePath.isEmpty());
+}
+
+QIODevice* StreamTarget::getDevice() const
+{
+    return mDevice ? mDevice : mFile.get();
+}
+
+bool StreamTarget::begin()
+{
+    mError.clear();
+    mBytesReported = 0;
+
+    if (!mFilePath.isEmpty())
+    {
+        // A new save file drops the data from a previous attempt.
+        mFile = std::make_unique<QSaveFile>(mFilePath);
+        mBytesWritten = 0;
+
+        if (!mFile->open(QIODevice::WriteOnly))
+        {
+            mError = QString("Cannot open %1: %2").arg(mFilePath, mFile->errorString());
+            qWarning() << mError;
+            mFile = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    if (!mDevice || !mDevice->isWritable())
+    {
+        mError = "Stream device not writable";
+        qWarning() << mError;
+        return false;
+    }
+
+    if (mStartPos < 0)
+    {
+        mStartPos = mDevice->isSequential() ? 0 : mDevice->pos();
+    }
+    else if (mBytesWritten > 0)
+    {
+        if (mDevice->isSequential() || !mDevice->seek(mStartPos))
+        {
+            mError = "Cannot restart download on stream device";
+            qWarning() << mError;
+            return false;
+        }
+    }
+
+    mBytesWritten = 0;
+    return true;
+}
+
+bool StreamTarget::write(const QByteArray& data)
+{
+    if (data.isEmpty())
+        return true;
+
+    auto* device = getDevice();
+
+    if (!device)
+    {
+        mError = "Stream target not opened";
+        qWarning() << mError;
+        return false;
+    }
+
+    const qint64 written = device->write(data);
+
+    if (written != data.size())
+    {
+        mError = QString("Stream write failed: %1").arg(device->errorString());
+        qWarning() << mError;
+        return false;
+    }
+
+    mBytesWritten += written;
+    return true;
+}
+
+bool StreamTarget::commit()
+{
+    if (!mFile)
+        return true;
+
+    const bool saved = mFile->commit();
+
+    if (!saved)
+    {
+        mError = QString("Cannot save %1: %2").arg(mFilePath, mFile->errorString());
+        qWarning() << mError;
+    }
+
+    mFile = nullptr;
+    return saved;
+}
+
+void StreamTarget::discard()
+{
+    if (mFile)
+    {
+        mFile->cancelWriting();
+        mFile = nullptr;
+    }
+}
+
+bool StreamTarget::takeProgress()
+{
+    if (mBytesWritten - mBytesReported < PROGRESS_STEP)
+        return false;
+
+    mBytesReported = mBytesWritten;
+    return true;
+}
+
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QIODevice>
+#include <QSaveFile>
+#include <QString>
+#include <functional>
+#include <memory>
+
+namespace Xrpc {
+
+// Destination of a streamed download. Data is written in chunks as it arrives, such
+// that the download does not need to be buffered in memory.
+// The target is either a device supplied by the caller, or a file. A file is written
+// via QSaveFile, so it only appears when the download is complete.
+// The target is written on the network thread.
+class StreamTarget
+{
+public:
+    using SharedPtr = std::shared_ptr<StreamTarget>;
+
+    // bytesTotal is -1 if the size is unknown
+    using ProgressCb = std::function<void(qint64 bytesReceived, qint64 bytesTotal)>;
+
+    // Bytes buffered by the network reply. This bounds the memory used by a download.
+    static constexpr qint64 READ_BUFFER_SIZE = 256 * 1024;
+
+    // Minimum number of bytes between progress reports.
+    static constexpr qint64 PROGRESS_STEP = 256 * 1024;
+
+    // The device must be open for writing. The caller must not use the device
+    // till the request is finished.
+    explicit StreamTarget(QIODevice* device);
+    explicit StreamTarget(const QString& filePath);
+
+    void setProgressCb(const ProgressCb& progressCb) { mProgressCb = progressCb; }
+    const ProgressCb& getProgressCb() const { return mProgressCb; }
+
+    // Prepares for writing a download from the start. Returns false if the
+    // target cannot be (re)written, e.g. when retrying on a sequential device.
+    bool begin();
+
+    bool write(const QByteArray& data);
+
+    // Completes the download. For a file target, the file gets saved.
+    bool commit();
+
+    // Drops a partial download. For a file target, nothing gets saved.
+    void discard();
+
+    // Returns true if the progress must be reported, i.e. at least PROGRESS_STEP
+    // bytes were written since the last report.
+    bool takeProgress();
+
+    qint64 getBytesWritten() const { return mBytesWritten; }
+    const QString& getError() const { return mError; }
+    bool hasError() const { return !mError.isEmpty(); }
+
+private:
+    QIODevice* getDevice() const;
+
+    QIODevice* mDevice = nullptr; // owned by the caller
+    QString mFilePath;
+    std::unique_ptr<QSaveFile> mFile;
+    qint64 mStartPos = -1;
+    qint64 mBytesWritten = 0;
+    qint64 mBytesReported = 0;
+    ProgressCb mProgressCb;
+    QString mError;
+};
+
+}
@@ -0,0 +1,223 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "xrpc_tls_session_store.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+namespace Xrpc {
+
+TlsSessionStore::TlsSessionStore()
+{
+    mSavePool.setMaxThreadCount(1);
+}
+
+TlsSessionStore::~TlsSessionStore()
+{
+    mSavePool.waitForDone();
+}
+
+QString TlsSessionStore::makeKey(const QString& host, quint16 port)
+{
+    return host + ':' + QString::number(port);
+}
+
+bool TlsSessionStore::open(const QString& filePath)
+{
+    QMutexLocker locker(&mMutex);
+    mFilePath = filePath;
+    mTickets.clear();
+    return load();
+}
+
+bool TlsSessionStore::isOpen() const
+{
+    QMutexLocker locker(&mMutex);
+    return !mFilePath.isEmpty();
+}
+
+bool TlsSessionStore::load()
+{
+    QFile file(mFilePath);
+
+    if (!file.exists())
+        return true;
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot read TLS sessions:" << mFilePath << file.errorString();
+        return false;
+    }
+
+    const auto json = QJsonDocument::fromJson(file.readAll()).object();
+    const auto now = QDateTime::currentDateTimeUtc();
+
+    for (auto it = json.begin(); it != json.end(); ++it)
+    {
+        const auto ticketJson = it.value().toObject();
+        Ticket ticket{
+            QByteArray::fromBase64(ticketJson["ticket"].toString().toLatin1()),
+            QDateTime::fromString(ticketJson["expiry"].toString(), Qt::ISODate)
+        };
+
+        if (!ticket.mTicket.isEmpty() && ticket.mExpiry.isValid() && ticket.mExpiry > now)
+            mTickets.insert(it.key(), std::move(ticket));
+    }
+
+    qDebug() << "TLS sessions loaded:" << mTickets.size() << mFilePath;
+    return true;
+}
+
+QByteArray TlsSessionStore::toJson() const
+{
+    QJsonObject json;
+
+    for (auto it = mTickets.begin(); it != mTickets.end(); ++it)
+    {
+        QJsonObject ticketJson;
+        ticketJson.insert("ticket", QString::fromLatin1(it->mTicket.toBase64()));
+        ticketJson.insert("expiry", it->mExpiry.toString(Qt::ISODate));
+        json.insert(it.key(), ticketJson);
+    }
+
+    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+}
+
+void TlsSessionStore::scheduleSave()
+{
+    // Called with the mutex locked.
+    mSaveNeeded = true;
+
+    if (mSaving)
+        return;
+
+    mSaving = true;
+    mSavePool.start([this]{ saveTickets(); });
+}
+
+void TlsSessionStore::saveTickets()
+{
+    QMutexLocker locker(&mMutex);
+
+    // The file is written without holding the mutex, such that network threads
+    // are not blocked by the disk.
+    while (mSaveNeeded)
+    {
+        mSaveNeeded = false;
+        const QString filePath = mFilePath;
+        const QByteArray data = toJson();
+        locker.unlock();
+        writeFile(filePath, data);
+        locker.relock();
+    }
+
+    mSaving = false;
+}
+
+void TlsSessionStore::writeFile(const QString& filePath, const QByteArray& data)
+{
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Cannot save TLS sessions:" << filePath << file.errorString();
+        return;
+    }
+
+    // Restrict access before the tickets are written.
+    if (!file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner))
+    {
+        qWarning() << "Cannot restrict TLS sessions file:" << filePath << file.errorString();
+        file.cancelWriting();
+        return;
+    }
+
+    file.write(data);
+
+    if (!file.commit())
+        qWarning() << "Cannot save TLS sessions:" << filePath << file.errorString();
+}
+
+void TlsSessionStore::apply(QNetworkRequest& request) const
+{
+    const QUrl url = request.url();
+
+    if (url.scheme() != "https")
+        return;
+
+    auto sslConfig = request.sslConfiguration();
+    apply(url.host(), (quint16)url.port(443), sslConfig);
+    request.setSslConfiguration(sslConfig);
+}
+
+void TlsSessionStore::apply(const QString& host, quint16 port, QSslConfiguration& sslConfig) const
+{
+    QMutexLocker locker(&mMutex);
+
+    if (mFilePath.isEmpty())
+        return;
+
+    // Without persistence the ticket of a new session is not available.
+    sslConfig.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    const auto it = mTickets.find(makeKey(host, port));
+
+    if (it != mTickets.end() && it->mExpiry > QDateTime::currentDateTimeUtc())
+        sslConfig.setSessionTicket(it->mTicket);
+}
+
+void TlsSessionStore::update(const QUrl& url, const QSslConfiguration& sslConfig)
+{
+    const QByteArray ticket = sslConfig.sessionTicket();
+
+    if (ticket.isEmpty() || url.host().isEmpty())
+        return;
+
+    QMutexLocker locker(&mMutex);
+
+    if (mFilePath.isEmpty())
+        return;
+
+    const QString key = makeKey(url.host(), (quint16)url.port(443));
+    auto& stored = mTickets[key];
+
+    if (stored.mTicket == ticket)
+        return;
+
+    const int hint = sslConfig.sessionTicketLifeTimeHint();
+    const std::chrono::seconds lifetime = hint > 0 ?
+        std::min(std::chrono::seconds(hint), std::chrono::seconds(MAX_LIFETIME)) :
+        std::chrono::seconds(DEFAULT_LIFETIME);
+
+    stored.mTicket = ticket;
+    stored.mExpiry = QDateTime::currentDateTimeUtc().addSecs(lifetime.count());
+    qDebug() << "New TLS session:" << key << "lifetime:" << lifetime.count();
+
+    // Drop expired tickets of other hosts.
+    const auto now = QDateTime::currentDateTimeUtc();
+    for (auto it = mTickets.begin(); it != mTickets.end(); )
+        it = it->mExpiry <= now ? mTickets.erase(it) : std::next(it);
+
+    scheduleSave();
+}
+
+QByteArray TlsSessionStore::getTicket(const QString& host, quint16 port) const
+{
+    QMutexLocker locker(&mMutex);
+    const auto it = mTickets.find(makeKey(host, port));
+    return it != mTickets.end() ? it->mTicket : QByteArray{};
+}
+
+int TlsSessionStore::getTicketCount() const
+{
+    QMutexLocker locker(&mMutex);
+    return (int)mTickets.size();
+}
+
+void TlsSessionStore::waitForSaved()
+{
+    mSavePool.waitForDone();
+}
+
+}
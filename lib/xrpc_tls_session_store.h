@@ -0,0 +1,76 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QNetworkRequest>
+#include <QSslConfiguration>
+#include <QString>
+#include <QThreadPool>
+#include <QUrl>
+#include <chrono>
+
+namespace Xrpc {
+
+// Stores TLS session tickets per host on disk, such that the first connection
+// to a host after a restart resumes the session instead of doing a full handshake.
+// The store is disabled till it is opened. Thread safe.
+//
+// A session ticket holds the secrets of a session. The file is only readable by
+// the owner.
+//
+// The file is written on a background thread. Tickets received while a save is
+// in progress are saved together by the next save.
+class TlsSessionStore
+{
+public:
+    static constexpr std::chrono::hours DEFAULT_LIFETIME{1}; // when the server gives no hint
+    static constexpr std::chrono::days MAX_LIFETIME{7}; // RFC 8446
+
+    TlsSessionStore();
+
+    // Waits till the received tickets are saved.
+    ~TlsSessionStore();
+
+    // Loads the tickets from the file. Tickets received are saved to the file.
+    // Returns false if an existing file could not be read.
+    bool open(const QString& filePath);
+    bool isOpen() const;
+
+    // Sets the stored ticket for the host of the request on its SSL configuration.
+    void apply(QNetworkRequest& request) const;
+    void apply(const QString& host, quint16 port, QSslConfiguration& sslConfig) const;
+
+    // Stores the ticket from the SSL configuration of an encrypted connection to url.
+    void update(const QUrl& url, const QSslConfiguration& sslConfig);
+
+    QByteArray getTicket(const QString& host, quint16 port) const;
+    int getTicketCount() const;
+
+    // Waits till the tickets received so far are saved.
+    void waitForSaved();
+
+private:
+    struct Ticket
+    {
+        QByteArray mTicket;
+        QDateTime mExpiry;
+    };
+
+    static QString makeKey(const QString& host, quint16 port);
+    bool load();
+    void scheduleSave();
+    void saveTickets();
+    QByteArray toJson() const;
+    static void writeFile(const QString& filePath, const QByteArray& data);
+
+    mutable QMutex mMutex;
+    QString mFilePath;
+    QHash<QString, Ticket> mTickets;
+    bool mSaveNeeded = false;
+    bool mSaving = false;
+    QThreadPool mSavePool; // must be destroyed first, its task uses the members
+};
+
+}
@@ -52,6 +52,9 @@ void ATProtoTest::oauth(const QString user, QString host)
 
 void ATProtoTest::initHttpServer()
 {
+    if (mHttpServer)
+        return;
+
     mHttpServer = std::make_unique<QHttpServer>(this);
     mHttpServer->route("/oauth/callback", this,
         [this](const QHttpServerRequest& request, QHttpServerResponder& responder){
@@ -60,6 +63,19 @@ void ATProtoTest::initHttpServer()
             responder.write(QHttpServerResponder::StatusCode::NoContent);
         });
 
+    // Request metrics for scraping by Prometheus
+    mHttpServer->route("/metrics", this,
+        [this](const QHttpServerRequest&, QHttpServerResponder& responder){
+            if (!mBsky)
+            {
+                responder.write(QHttpServerResponder::StatusCode::ServiceUnavailable);
+                return;
+            }
+
+            const auto& engine = mBsky->getXrpcClient()->getNetworkEngine();
+            responder.write(engine->getMetrics().toPrometheusText().toUtf8(), "text/plain; version=0.0.4");
+        });
+
     auto tcpServer = new QTcpServer(this);
 
     if (!tcpServer->listen(QHostAddress::LocalHost, LISTEN_PORT) || !mHttpServer->bind(tcpServer))
@@ -24,6 +24,7 @@ public:
     {
         auto xrpc = std::make_unique<Xrpc::Client>(host);
         mBsky = std::make_unique<ATProto::Client>(std::move(xrpc));
+        initHttpServer();
         mBsky->createSession(user, password, {},
             [this, user]{
                 getProfile(user);
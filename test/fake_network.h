@@ -0,0 +1,106 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPointer>
+#include <vector>
+
+// Reply that only makes progress when the test says so.
+class FakeReply : public QNetworkReply
+{
+public:
+    FakeReply(const QNetworkRequest& request, QNetworkAccessManager::Operation operation, QObject* parent = nullptr) :
+        QNetworkReply(parent)
+    {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(operation);
+        open(QIODevice::ReadOnly);
+    }
+
+    void abort() override
+    {
+        if (isFinished())
+            return;
+
+        mAborted = true;
+        setError(OperationCanceledError, "Operation canceled");
+        setFinished(true);
+        emit errorOccurred(OperationCanceledError);
+        emit finished();
+    }
+
+    bool isAborted() const { return mAborted; }
+
+    void receiveHeaders(qint64 contentLength)
+    {
+        setAttribute(QNetworkRequest::Http2WasUsedAttribute, true);
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+        setHeader(QNetworkRequest::ContentLengthHeader, contentLength);
+        emit metaDataChanged();
+    }
+
+    void finish()
+    {
+        setFinished(true);
+        emit finished();
+    }
+
+    // Finishes with a JSON body. An HTTP error status makes the reply fail.
+    void respond(int httpStatus, const QByteArray& body)
+    {
+        if (isFinished())
+            return;
+
+        mBody = body;
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, httpStatus);
+        setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        setHeader(QNetworkRequest::ContentLengthHeader, body.size());
+        emit metaDataChanged();
+        emit readyRead();
+        setFinished(true);
+
+        if (httpStatus >= 400)
+        {
+            setError(ProtocolInvalidOperationError, "Error transferring");
+            emit errorOccurred(ProtocolInvalidOperationError);
+        }
+
+        emit finished();
+    }
+
+    qint64 bytesAvailable() const override { return mBody.size() - mReadPos + QNetworkReply::bytesAvailable(); }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        if (mReadPos >= mBody.size())
+            return isFinished() ? -1 : 0;
+
+        const qint64 size = std::min(maxSize, (qint64)mBody.size() - mReadPos);
+        memcpy(data, mBody.constData() + mReadPos, size);
+        mReadPos += size;
+        return size;
+    }
+
+private:
+    bool mAborted = false;
+    QByteArray mBody;
+    qint64 mReadPos = 0;
+};
+
+// Network access manager that creates fake replies.
+class FakeNetwork : public QNetworkAccessManager
+{
+public:
+    std::vector<QPointer<FakeReply>> mReplies;
+
+protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice*) override
+    {
+        auto* reply = new FakeReply(request, op, this);
+        mReplies.push_back(reply);
+        return reply;
+    }
+};
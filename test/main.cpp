@@ -1,7 +1,28 @@
 // Copyright (C) 2024 Michel de Boer
 // License: GPLv3
+#include "test_arena.h"
 #include "test_at_uri.h"
+#include "test_auto_refresh.h"
+#include "test_connection_warmer.h"
+#include "test_decode_pool.h"
+#include "test_dpop_nonce_rotation.h"
+#include "test_host_health.h"
+#include "test_http2_watchdog.h"
+#include "test_json_array_splitter.h"
+#include "test_json_web_key.h"
+#include "test_json_writer.h"
+#include "test_jwt.h"
+#include "test_lazy_post_view.h"
+#include "test_plc_directory_client.h"
+#include "test_rate_limiter.h"
+#include "test_request_deadline.h"
+#include "test_request_scheduler.h"
+#include "test_response_cache.h"
 #include "test_rich_text_master.h"
+#include "test_service_auth_cache.h"
+#include "test_stream_target.h"
+#include "test_tls_session_store.h"
+#include "test_xrpc_metrics.h"
 #include "test_xjson.h"
 #include <QTest>
 
@@ -16,5 +37,68 @@ int main(int argc, char *argv[])
     TestXJson testXJson;
     QTest::qExec(&testXJson, argc, argv);
 
+    TestDecodePool testDecodePool;
+    QTest::qExec(&testDecodePool, argc, argv);
+
+    TestRequestScheduler testRequestScheduler;
+    QTest::qExec(&testRequestScheduler, argc, argv);
+
+    TestJsonArraySplitter testJsonArraySplitter;
+    QTest::qExec(&testJsonArraySplitter, argc, argv);
+
+    TestConnectionWarmer testConnectionWarmer;
+    QTest::qExec(&testConnectionWarmer, argc, argv);
+
+    TestTlsSessionStore testTlsSessionStore;
+    QTest::qExec(&testTlsSessionStore, argc, argv);
+
+    TestHostHealth testHostHealth;
+    QTest::qExec(&testHostHealth, argc, argv);
+
+    TestDpopNonceRotation testDpopNonceRotation;
+    QTest::qExec(&testDpopNonceRotation, argc, argv);
+
+    TestJsonWebKey testJsonWebKey;
+    QTest::qExec(&testJsonWebKey, argc, argv);
+
+    TestJwt testJwt;
+    QTest::qExec(&testJwt, argc, argv);
+
+    TestServiceAuthCache testServiceAuthCache;
+    QTest::qExec(&testServiceAuthCache, argc, argv);
+
+    TestArena testArena;
+    QTest::qExec(&testArena, argc, argv);
+
+    TestLazyPostView testLazyPostView;
+    QTest::qExec(&testLazyPostView, argc, argv);
+
+    TestJsonWriter testJsonWriter;
+    QTest::qExec(&testJsonWriter, argc, argv);
+
+    TestResponseCache testResponseCache;
+    QTest::qExec(&testResponseCache, argc, argv);
+
+    TestRateLimiter testRateLimiter;
+    QTest::qExec(&testRateLimiter, argc, argv);
+
+    TestXrpcMetrics testXrpcMetrics;
+    QTest::qExec(&testXrpcMetrics, argc, argv);
+
+    TestStreamTarget testStreamTarget;
+    QTest::qExec(&testStreamTarget, argc, argv);
+
+    TestHttp2Watchdog testHttp2Watchdog;
+    QTest::qExec(&testHttp2Watchdog, argc, argv);
+
+    TestRequestDeadline testRequestDeadline;
+    QTest::qExec(&testRequestDeadline, argc, argv);
+
+    TestPlcDirectoryClient testPlcDirectoryClient;
+    QTest::qExec(&testPlcDirectoryClient, argc, argv);
+
+    TestAutoRefresh testAutoRefresh;
+    QTest::qExec(&testAutoRefresh, argc, argv);
+
     return 0;
 }
@@ -0,0 +1,201 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QString>
+
+// JSON of post views and the replies that hold them, for the decode tests.
+// The post view has facets, a record with media embed and labels, like posts on
+// a timeline.
+struct PostViewFixture
+{
+    // Post view of user i
+    static QByteArray makePost(int i)
+    {
+        return QString(POST_VIEW).arg(i).toUtf8();
+    }
+
+    // app.bsky.feed.getTimeline output
+    static QByteArray makeFeed(int size)
+    {
+        QByteArrayList posts;
+
+        for (int i = 0; i < size; ++i)
+            posts.push_back(R"({"post":)" + makePost(i) + '}');
+
+        return R"({"cursor":"cursor","feed":[)" + posts.join(',') + "]}";
+    }
+
+    // A root post with replies
+    static QByteArray makeThread(int size)
+    {
+        QByteArrayList replies;
+
+        for (int i = 1; i < size; ++i)
+            replies.push_back(R"({"$type":"app.bsky.feed.defs#threadViewPost","post":)" + makePost(i) + R"(,"replies":[]})");
+
+        return R"({"thread":{"$type":"app.bsky.feed.defs#threadViewPost","post":)" + makePost(0) +
+               R"(,"replies":[)" + replies.join(',') + "]}}";
+    }
+
+    // app.bsky.notification.listNotifications output with likes
+    static QByteArray makeNotifications(int size)
+    {
+        QByteArrayList notifications;
+
+        for (int i = 0; i < size; ++i)
+            notifications.push_back(QString(LIKE_NOTIFICATION).arg(i).toUtf8());
+
+        return R"({"cursor":"cursor","notifications":[)" + notifications.join(',') + "]}";
+    }
+
+    static constexpr char const* POST_VIEW = R"##({
+        "uri": "at://did:plc:user%1/app.bsky.feed.post/3kabc",
+        "cid": "bafyreib2rxk3rybk3aobmv5cjuql3bm2twh4jo5uxgf5lpqkqoe2jlqiqe",
+        "author": {
+            "did": "did:plc:user%1",
+            "handle": "user%1.bsky.social",
+            "displayName": "User %1",
+            "avatar": "https://cdn.bsky.app/img/avatar/plain/did:plc:user%1/bafkrei@jpeg",
+            "viewer": { "muted": false, "blockedBy": false },
+            "labels": [],
+            "createdAt": "2023-05-01T10:00:00.000Z"
+        },
+        "record": {
+            "$type": "app.bsky.feed.post",
+            "createdAt": "2024-04-14T20:48:40.913Z",
+            "langs": ["en"],
+            "text": "Post number %1 by @alice.bsky.social about https://example.com/article #atproto",
+            "facets": [
+                {
+                    "index": { "byteStart": 17, "byteEnd": 35 },
+                    "features": [{ "$type": "app.bsky.richtext.facet#mention", "did": "did:plc:alice" }]
+                },
+                {
+                    "index": { "byteStart": 42, "byteEnd": 69 },
+                    "features": [{ "$type": "app.bsky.richtext.facet#link", "uri": "https://example.com/article" }]
+                },
+                {
+                    "index": { "byteStart": 70, "byteEnd": 78 },
+                    "features": [{ "$type": "app.bsky.richtext.facet#tag", "tag": "atproto" }]
+                }
+            ],
+            "embed": {
+                "$type": "app.bsky.embed.recordWithMedia",
+                "record": {
+                    "$type": "app.bsky.embed.record",
+                    "record": {
+                        "uri": "at://did:plc:quoted/app.bsky.feed.post/3kquote",
+                        "cid": "bafyreiquotedcid"
+                    }
+                },
+                "media": {
+                    "$type": "app.bsky.embed.images",
+                    "images": [{
+                        "alt": "Picture %1",
+                        "aspectRatio": { "width": 1200, "height": 800 },
+                        "image": {
+                            "$type": "blob",
+                            "ref": { "$link": "bafkreiimage%1" },
+                            "mimeType": "image/jpeg",
+                            "size": 345678
+                        }
+                    }]
+                }
+            }
+        },
+        "embed": {
+            "$type": "app.bsky.embed.recordWithMedia#view",
+            "record": {
+                "$type": "app.bsky.embed.record#view",
+                "record": {
+                    "$type": "app.bsky.embed.record#viewRecord",
+                    "uri": "at://did:plc:quoted/app.bsky.feed.post/3kquote",
+                    "cid": "bafyreiquotedcid",
+                    "author": {
+                        "did": "did:plc:quoted",
+                        "handle": "quoted.bsky.social",
+                        "displayName": "Quoted",
+                        "avatar": "https://cdn.bsky.app/img/avatar/plain/did:plc:quoted/bafkrei@jpeg",
+                        "viewer": { "muted": false, "blockedBy": false },
+                        "labels": []
+                    },
+                    "value": {
+                        "$type": "app.bsky.feed.post",
+                        "createdAt": "2024-04-14T19:00:00.000Z",
+                        "langs": ["en"],
+                        "text": "The quoted post with a link card.",
+                        "embed": {
+                            "$type": "app.bsky.embed.external",
+                            "external": {
+                                "uri": "https://example.com/article",
+                                "title": "An article",
+                                "description": "The description of the article."
+                            }
+                        }
+                    },
+                    "labels": [],
+                    "embeds": [{
+                        "$type": "app.bsky.embed.external#view",
+                        "external": {
+                            "uri": "https://example.com/article",
+                            "title": "An article",
+                            "description": "The description of the article.",
+                            "thumb": "https://cdn.bsky.app/img/feed_thumbnail/plain/did:plc:quoted/bafkreithumb@jpeg"
+                        }
+                    }],
+                    "indexedAt": "2024-04-14T19:00:01.000Z"
+                }
+            },
+            "media": {
+                "$type": "app.bsky.embed.images#view",
+                "images": [{
+                    "thumb": "https://cdn.bsky.app/img/feed_thumbnail/plain/did:plc:user%1/bafkreiimage%1@jpeg",
+                    "fullsize": "https://cdn.bsky.app/img/feed_fullsize/plain/did:plc:user%1/bafkreiimage%1@jpeg",
+                    "alt": "Picture %1",
+                    "aspectRatio": { "width": 1200, "height": 800 }
+                }]
+            }
+        },
+        "bookmarkCount": 0,
+        "replyCount": 3,
+        "repostCount": 5,
+        "likeCount": 42,
+        "quoteCount": 1,
+        "indexedAt": "2024-04-14T20:48:41.123Z",
+        "viewer": { "threadMuted": false, "embeddingDisabled": false },
+        "labels": [{
+            "src": "did:plc:labeler",
+            "uri": "at://did:plc:user%1/app.bsky.feed.post/3kabc",
+            "val": "test",
+            "cts": "2024-04-14T20:48:41.123Z"
+        }]
+    })##";
+
+    static constexpr char const* LIKE_NOTIFICATION = R"##({
+        "uri": "at://did:plc:user%1/app.bsky.feed.like/3klike",
+        "cid": "bafyreib2rxk3rybk3aobmv5cjuql3bm2twh4jo5uxgf5lpqkqoe2jlqiqe",
+        "author": {
+            "did": "did:plc:user%1",
+            "handle": "user%1.bsky.social",
+            "displayName": "User %1",
+            "viewer": { "muted": false, "blockedBy": false },
+            "labels": [],
+            "indexedAt": "2024-04-14T20:48:41.123Z"
+        },
+        "reason": "like",
+        "reasonSubject": "at://did:plc:me/app.bsky.feed.post/3kabc",
+        "record": {
+            "$type": "app.bsky.feed.like",
+            "subject": {
+                "uri": "at://did:plc:me/app.bsky.feed.post/3kabc",
+                "cid": "bafyreib2rxk3rybk3aobmv5cjuql3bm2twh4jo5uxgf5lpqkqoe2jlqiqe"
+            },
+            "createdAt": "2024-04-14T20:48:40.913Z"
+        },
+        "isRead": false,
+        "indexedAt": "2024-04-14T20:48:41.123Z",
+        "labels": []
+    })##";
+};
@@ -0,0 +1,181 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "post_view_fixture.h"
+#include <arena.h>
+#include <lexicon/app_bsky_feed.h>
+#include <lexicon/app_bsky_notification.h>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QTest>
+
+using namespace ATProto;
+
+class TestArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void scope()
+    {
+        QVERIFY(!ArenaScope::getArena());
+        auto arena = Arena::create();
+
+        {
+            const ArenaScope scope(arena);
+            QCOMPARE(ArenaScope::getArena(), arena);
+            makeShared<ComATProtoRepo::StrongRef>();
+
+            {
+                const ArenaScope noArena(nullptr);
+                QVERIFY(!ArenaScope::getArena());
+                makeShared<ComATProtoRepo::StrongRef>();
+            }
+
+            QCOMPARE(ArenaScope::getArena(), arena);
+            makeShared<ComATProtoRepo::StrongRef>();
+        }
+
+        QVERIFY(!ArenaScope::getArena());
+        QCOMPARE(arena->getAllocationCount(), 2);
+    }
+
+    void objectKeepsArena()
+    {
+        std::weak_ptr<Arena> weakArena;
+        AppBskyFeed::PostView::SharedPtr post;
+
+        {
+            const auto json = QJsonDocument::fromJson(PostViewFixture::makeFeed(10));
+            auto arena = Arena::create();
+            weakArena = arena;
+            const ArenaScope scope(std::move(arena));
+            auto feed = AppBskyFeed::OutputFeed::fromJson(json.object());
+            post = feed->mFeed[5]->mPost;
+        }
+
+        // Only the post is left, the arena is still there.
+        QVERIFY(!weakArena.expired());
+        QCOMPARE(post->mAuthor->mHandle, "user5.bsky.social");
+        post = nullptr;
+        QVERIFY(weakArena.expired());
+    }
+
+    void allocationCount_data() { addReplyRows(); }
+
+    // The arena allocation count is the number of heap allocations for lexicon
+    // objects without arena. QString and QJsonObject data are not counted.
+    void allocationCount()
+    {
+        QFETCH(int, reply);
+        const auto json = QJsonDocument::fromJson(makeReply(reply));
+        auto arena = Arena::create();
+
+        {
+            const ArenaScope scope(arena);
+            QVERIFY(decode(reply, json.object()));
+        }
+
+        qInfo() << "Objects:" << arena->getAllocationCount() << "bytes:" << arena->getBytesAllocated()
+                << "arena blocks:" << arena->getBlockCount();
+        QVERIFY(arena->getAllocationCount() > REPLY_SIZE);
+        QVERIFY(arena->getBlockCount() < arena->getAllocationCount() / 10);
+    }
+
+    void decodeTime_data() { addReplyRows(); }
+
+    // Decode and release of a reply, as the app drops a page after it has been shown.
+    void decodeTime()
+    {
+        QFETCH(int, reply);
+        const auto json = QJsonDocument::fromJson(makeReply(reply));
+        const QJsonObject root = json.object();
+        const qint64 heapNs = timeDecodes(reply, root, false);
+        const qint64 arenaNs = timeDecodes(reply, root, true);
+        qInfo() << "Decode us heap:" << heapNs / DECODE_COUNT / 1000 << "arena:" << arenaNs / DECODE_COUNT / 1000;
+    }
+
+    void benchmarkDecode_data()
+    {
+        QTest::addColumn<int>("reply");
+        QTest::addColumn<bool>("useArena");
+
+        for (const auto& [name, reply] : REPLIES)
+        {
+            QTest::newRow(qPrintable(QString("%1 heap").arg(name))) << reply << false;
+            QTest::newRow(qPrintable(QString("%1 arena").arg(name))) << reply << true;
+        }
+    }
+
+    void benchmarkDecode()
+    {
+        QFETCH(int, reply);
+        QFETCH(bool, useArena);
+        const auto json = QJsonDocument::fromJson(makeReply(reply));
+        const QJsonObject root = json.object();
+
+        QBENCHMARK {
+            const ArenaScope scope(useArena ? Arena::create() : nullptr);
+            decode(reply, root);
+        }
+    }
+
+private:
+    enum Reply { FEED, THREAD, NOTIFICATIONS };
+    static constexpr std::pair<char const*, int> REPLIES[] = {
+        { "OutputFeed", FEED }, { "PostThread", THREAD }, { "ListNotificationsOutput", NOTIFICATIONS }
+    };
+    static constexpr int REPLY_SIZE = 100;
+    static constexpr int DECODE_COUNT = 50;
+
+    static void addReplyRows()
+    {
+        QTest::addColumn<int>("reply");
+
+        for (const auto& [name, reply] : REPLIES)
+            QTest::newRow(name) << reply;
+    }
+
+    static bool decode(int reply, const QJsonObject& json)
+    {
+        switch (reply)
+        {
+        case FEED:
+            return AppBskyFeed::OutputFeed::fromJson(json) != nullptr;
+        case THREAD:
+            return AppBskyFeed::PostThread::fromJson(json) != nullptr;
+        case NOTIFICATIONS:
+            return AppBskyNotification::ListNotificationsOutput::fromJson(json) != nullptr;
+        }
+
+        return false;
+    }
+
+    static qint64 timeDecodes(int reply, const QJsonObject& json, bool useArena)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < DECODE_COUNT; ++i)
+        {
+            const ArenaScope scope(useArena ? Arena::create() : nullptr);
+            decode(reply, json);
+        }
+
+        return timer.nsecsElapsed();
+    }
+
+    static QByteArray makeReply(int reply)
+    {
+        switch (reply)
+        {
+        case FEED:
+            return PostViewFixture::makeFeed(REPLY_SIZE);
+        case THREAD:
+            return PostViewFixture::makeThread(REPLY_SIZE);
+        case NOTIFICATIONS:
+            return PostViewFixture::makeNotifications(REPLY_SIZE);
+        }
+
+        return {};
+    }
+};
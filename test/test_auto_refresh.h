@@ -0,0 +1,36 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <client.h>
+#include <QTest>
+
+using namespace ATProto;
+using namespace std::chrono_literals;
+
+class TestAutoRefresh : public QObject
+{
+    Q_OBJECT
+private slots:
+    void retryDelay_data()
+    {
+        QTest::addColumn<qint64>("refreshDelayMs");
+        QTest::addColumn<qint64>("retryDelayMs");
+
+        // An expired token gives a refresh delay of 0, a retry must not loop.
+        QTest::newRow("expired") << 0LL << toMs(Client::MIN_AUTO_REFRESH_DELAY);
+        QTest::newRow("below minimum") << 5000LL << toMs(Client::MIN_AUTO_REFRESH_DELAY);
+        QTest::newRow("before retry") << 20000LL << 20000LL;
+        QTest::newRow("after retry") << 60000LL << toMs(Client::AUTO_REFRESH_RETRY);
+        QTest::newRow("unknown expiry") << toMs(Client::AUTO_REFRESH_INTERVAL) << toMs(Client::AUTO_REFRESH_RETRY);
+    }
+
+    void retryDelay()
+    {
+        QFETCH(qint64, refreshDelayMs);
+        QFETCH(qint64, retryDelayMs);
+        QCOMPARE((qint64)Client::getAutoRefreshRetryDelay(std::chrono::milliseconds(refreshDelayMs)).count(), retryDelayMs);
+    }
+
+private:
+    static qint64 toMs(std::chrono::milliseconds ms) { return ms.count(); }
+};
@@ -0,0 +1,103 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "tls_test_server.h"
+#include <xrpc_connection_warmer.h>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace Xrpc;
+
+// Compares first request latency with and without pre-warming against a local
+// TLS server. The handshake delay of the server stands in for network round trips.
+class TestConnectionWarmer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        mDefaultSslConfig = QSslConfiguration::defaultConfiguration();
+        QSslConfiguration::setDefaultConfiguration(TlsTestServer::clientConfiguration());
+        QVERIFY(mServer.start());
+    }
+
+    void cleanupTestCase()
+    {
+        QSslConfiguration::setDefaultConfiguration(mDefaultSslConfig);
+    }
+
+    void firstRequestLatency()
+    {
+        qint64 coldTotalMs = 0;
+        qint64 warmTotalMs = 0;
+
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            QNetworkAccessManager coldNetwork;
+            qint64 requestMs = 0;
+            timeRequest(coldNetwork, requestMs);
+
+            if (QTest::currentTestFailed())
+                return;
+
+            coldTotalMs += requestMs;
+
+            QNetworkAccessManager warmNetwork;
+            ConnectionWarmer warmer(&warmNetwork);
+            QSignalSpy encryptedSpy(&mServer, &TlsTestServer::encrypted);
+            warmer.warm(mServer.getHost());
+            QVERIFY(encryptedSpy.wait(5000));
+            QCOMPARE(warmer.getWarmCount(), 1);
+            timeRequest(warmNetwork, requestMs);
+
+            if (QTest::currentTestFailed())
+                return;
+
+            warmTotalMs += requestMs;
+        }
+
+        const qint64 coldMs = coldTotalMs / ROUNDS;
+        const qint64 warmMs = warmTotalMs / ROUNDS;
+        qInfo() << "First request latency, cold:" << coldMs << "ms warm:" << warmMs << "ms";
+
+        QVERIFY(coldMs >= HANDSHAKE_DELAY_MS);
+        QVERIFY(warmMs < coldMs / 2);
+    }
+
+    void minWarmInterval()
+    {
+        QNetworkAccessManager network;
+        ConnectionWarmer warmer(&network);
+        warmer.warm(mServer.getHost());
+        warmer.warm(mServer.getHost());
+        QCOMPARE(warmer.getWarmCount(), 1);
+
+        warmer.warm("http://localhost");
+        QCOMPARE(warmer.getWarmCount(), 1);
+    }
+
+private:
+    static constexpr int ROUNDS = 5;
+    static constexpr int HANDSHAKE_DELAY_MS = 50;
+
+    // Sets elapsedMs to the time till the reply finished.
+    void timeRequest(QNetworkAccessManager& network, qint64& elapsedMs)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        std::unique_ptr<QNetworkReply> reply(network.get(QNetworkRequest(mServer.getUrl())));
+        QSignalSpy finishedSpy(reply.get(), &QNetworkReply::finished);
+
+        if (!reply->isFinished())
+            finishedSpy.wait(5000);
+
+        elapsedMs = timer.elapsed();
+        QVERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+    }
+
+    TlsTestServer mServer{HANDSHAKE_DELAY_MS};
+    QSslConfiguration mDefaultSslConfig;
+};
@@ -0,0 +1,149 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <lexicon/app_bsky_feed.h>
+#include <xrpc_decode_pool.h>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+#include <QTimer>
+
+using namespace ATProto;
+
+class TestDecodePool : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        mFeedData = createFeed(100);
+    }
+
+    void decodeFeed()
+    {
+        Xrpc::DecodePool pool(2);
+        std::atomic_int postCount = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            pool.decode([this, &postCount]{
+                postCount += (int)decode(mFeedData)->mFeed.size();
+            });
+        }
+
+        QVERIFY(pool.waitForDone(10'000));
+        QCOMPARE(postCount.load(), 400);
+    }
+
+    void shutdownDropsPendingTasks()
+    {
+        Xrpc::DecodePool pool(1);
+        std::atomic_int done = 0;
+
+        for (int i = 0; i < 50; ++i)
+            pool.decode([this, &done]{ decode(mFeedData); ++done; });
+
+        pool.shutdown();
+        QVERIFY(done.load() < 50);
+        QCOMPARE(pool.activeThreadCount(), 0);
+    }
+
+    // The event loop stands in for the network thread. Its latency must stay flat
+    // while large decodes run on the pool. Decoding inline blocks it for the
+    // duration of a decode.
+    void eventLoopLatency()
+    {
+        constexpr int DECODE_COUNT = 20;
+
+        QElapsedTimer inlineTimer;
+        inlineTimer.start();
+
+        for (int i = 0; i < DECODE_COUNT; ++i)
+            decode(mFeedData);
+
+        const auto inlineMs = inlineTimer.elapsed();
+
+        Xrpc::DecodePool pool;
+        std::atomic_int done = 0;
+
+        for (int i = 0; i < DECODE_COUNT; ++i)
+            pool.decode([this, &done]{ decode(mFeedData); ++done; });
+
+        qint64 maxGapMs = 0;
+        QElapsedTimer gapTimer;
+        gapTimer.start();
+        QTimer tick;
+        tick.setInterval(1);
+        connect(&tick, &QTimer::timeout, this, [&maxGapMs, &gapTimer]{
+            maxGapMs = std::max(maxGapMs, gapTimer.restart());
+        });
+        tick.start();
+
+        QTRY_VERIFY_WITH_TIMEOUT(done.load() == DECODE_COUNT, 30'000);
+        tick.stop();
+
+        qDebug() << "Inline decode:" << inlineMs << "ms, max event loop gap with pool:" << maxGapMs << "ms";
+        QVERIFY(maxGapMs < std::max(inlineMs, (qint64)50));
+    }
+
+    void benchmarkFeedDecode()
+    {
+        QBENCHMARK {
+            decode(mFeedData);
+        }
+    }
+
+private:
+    static AppBskyFeed::OutputFeed::SharedPtr decode(const QByteArray& data)
+    {
+        const auto json = QJsonDocument::fromJson(data);
+        return AppBskyFeed::OutputFeed::fromJson(json.object());
+    }
+
+    static QByteArray createFeed(int postCount)
+    {
+        QJsonArray feed;
+
+        for (int i = 0; i < postCount; ++i)
+        {
+            const QString did = QString("did:plc:author%1").arg(i);
+            const QString uri = QString("at://%1/app.bsky.feed.post/post%2").arg(did).arg(i);
+
+            QJsonObject author;
+            author.insert("did", did);
+            author.insert("handle", QString("author%1.bsky.social").arg(i));
+            author.insert("displayName", QString("Author %1").arg(i));
+            author.insert("avatar", QString("https://cdn.bsky.app/img/avatar/plain/%1/avatar@jpeg").arg(did));
+
+            QJsonObject record;
+            record.insert("$type", "app.bsky.feed.post");
+            record.insert("text", QString("This is post number %1 with some text to make it a realistic size. ").arg(i).repeated(3));
+            record.insert("createdAt", "2026-01-01T12:00:00.000Z");
+            record.insert("langs", QJsonArray{"en"});
+
+            QJsonObject post;
+            post.insert("$type", "app.bsky.feed.defs#postView");
+            post.insert("uri", uri);
+            post.insert("cid", QString("bafyreicid%1").arg(i));
+            post.insert("author", author);
+            post.insert("record", record);
+            post.insert("replyCount", i);
+            post.insert("repostCount", i * 2);
+            post.insert("likeCount", i * 3);
+            post.insert("quoteCount", 1);
+            post.insert("indexedAt", "2026-01-01T12:00:01.000Z");
+
+            QJsonObject feedViewPost;
+            feedViewPost.insert("post", post);
+            feed.append(feedViewPost);
+        }
+
+        QJsonObject root;
+        root.insert("cursor", "next");
+        root.insert("feed", feed);
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray mFeedData;
+};
@@ -0,0 +1,163 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "tls_test_server.h"
+#include <json_web_key.h>
+#include <xrpc_network_thread.h>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QUrlQuery>
+#include <QTest>
+
+using namespace Xrpc;
+
+// Sends parallel OAuth requests to a local PDS that rotates its DPoP nonce while
+// requests are in flight.
+class TestDpopNonceRotation : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        mDefaultSslConfig = QSslConfiguration::defaultConfiguration();
+        QSslConfiguration::setDefaultConfiguration(TlsTestServer::clientConfiguration());
+        mServer.setHandler([this](const QByteArray& head){ return handleRequest(head); });
+        QVERIFY(mServer.start());
+
+        const auto key = ATProto::JsonWebKey::generateDPoPKey("test");
+        QVERIFY(!key.isNull());
+        QVERIFY(mKeyDir.isValid());
+        QVERIFY(key.save(getKeyPath(), KEY_PASS_PHRASE));
+    }
+
+    void cleanupTestCase()
+    {
+        QSslConfiguration::setDefaultConfiguration(mDefaultSslConfig);
+    }
+
+    void parallelRequestsAcrossRotation()
+    {
+        QNetworkAccessManager network;
+        network.setAutoDeleteReplies(true);
+        DecodePool decodePool(1);
+        RequestScheduler scheduler;
+        Metrics metrics;
+        TlsSessionStore tlsSessionStore;
+        NetworkThread thread(&network, decodePool, scheduler, metrics, tlsSessionStore,
+                             nullptr, nullptr, TIMEOUT_MS, NONCE_1);
+        thread.setPDS(mServer.getHost());
+        thread.oauthLoadDpopKey(getKeyPath(), KEY_PASS_PHRASE);
+        thread.enableOAuth("https://client.test/oauth-client-metadata.json");
+
+        connect(&thread, &NetworkThread::requestSuccessJson, this,
+                [](QJsonDocument json, NetworkThread::SuccessJsonCb cb){ cb(json); });
+        connect(&thread, &NetworkThread::requestError, this,
+                [](QString error, QJsonDocument json, NetworkThread::ErrorCb cb){ cb(error, json); });
+
+        int successCount = 0;
+        int errorCount = 0;
+
+        for (int i = 0; i < REQUEST_COUNT; ++i)
+        {
+            thread.get("test.ping", {{"i", QString::number(i)}}, {},
+                NetworkThread::SuccessJsonCb([&successCount](const QJsonDocument&){ ++successCount; }),
+                [&errorCount](const QString& error, const QJsonDocument&){
+                    qWarning() << "Request failed:" << error;
+                    ++errorCount;
+                },
+                "access-token", false, {}, RequestHandle::create(), RequestPriority::NORMAL,
+                QDeadlineTimer(QDeadlineTimer::Forever));
+        }
+
+        QTRY_COMPARE_WITH_TIMEOUT(successCount + errorCount, REQUEST_COUNT, TIMEOUT_MS);
+        QCOMPARE(errorCount, 0);
+        QCOMPARE(thread.getDpopNonceRotationCount(), 1);
+
+        // Only requests in flight during the rotation fail. Queued requests get a
+        // proof with the new nonce signed on the pool before they start.
+        int nonceErrorCount = 0;
+
+        for (const int count : std::as_const(mNonceErrors))
+        {
+            QCOMPARE(count, 1);
+            nonceErrorCount += count;
+        }
+
+        qInfo() << "Nonce errors:" << nonceErrorCount << "requests:" << mServer.getRequestCount();
+        QVERIFY(nonceErrorCount >= 1);
+        QVERIFY(nonceErrorCount <= RequestScheduler::DEFAULT_MAX_IN_FLIGHT_PER_HOST);
+        QCOMPARE(mServer.getRequestCount(), REQUEST_COUNT + nonceErrorCount);
+    }
+
+private:
+    static constexpr int REQUEST_COUNT = 40;
+    static constexpr int ROTATE_AT = 4;
+    static constexpr int TIMEOUT_MS = 10000;
+    static constexpr char const* NONCE_1 = "nonce-1";
+    static constexpr char const* NONCE_2 = "nonce-2";
+    static constexpr char const* KEY_PASS_PHRASE = "test";
+
+    QString getKeyPath() const { return mKeyDir.filePath("dpop.key"); }
+
+    static QByteArray getHeader(const QByteArray& head, const QByteArray& name)
+    {
+        for (const auto& line : head.split('\n'))
+        {
+            const qsizetype colon = line.indexOf(':');
+
+            if (colon > 0 && line.left(colon).trimmed().compare(name, Qt::CaseInsensitive) == 0)
+                return line.mid(colon + 1).trimmed();
+        }
+
+        return {};
+    }
+
+    static QString getProofNonce(const QByteArray& head)
+    {
+        const auto parts = getHeader(head, "DPoP").split('.');
+
+        if (parts.size() != 3)
+            return {};
+
+        const auto payload = QByteArray::fromBase64(parts[1],
+            QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+        return QJsonDocument::fromJson(payload).object().value("nonce").toString();
+    }
+
+    static int getIndex(const QByteArray& head)
+    {
+        // GET /xrpc/test.ping?i=<index> HTTP/1.1
+        const auto requestLine = head.left(head.indexOf('\r'));
+        const auto target = requestLine.split(' ').value(1);
+        return QUrlQuery(QUrl(QString::fromUtf8(target)).query()).queryItemValue("i").toInt();
+    }
+
+    QByteArray handleRequest(const QByteArray& head)
+    {
+        if (mServer.getRequestCount() == ROTATE_AT)
+            mServerNonce = NONCE_2;
+
+        QByteArray status = "200 OK";
+        QByteArray headers;
+        QByteArray body = "{}";
+
+        if (getProofNonce(head) != mServerNonce)
+        {
+            ++mNonceErrors[getIndex(head)];
+            status = "401 Unauthorized";
+            headers = "WWW-Authenticate: DPoP error=\"use_dpop_nonce\"\r\n";
+            body = R"({"error":"use_dpop_nonce","message":"Resource server requires nonce in DPoP proof"})";
+        }
+
+        return "HTTP/1.1 " + status + "\r\n" + headers +
+               "DPoP-Nonce: " + mServerNonce.toUtf8() + "\r\n"
+               "Content-Type: application/json\r\n"
+               "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+    }
+
+    TlsTestServer mServer;
+    QSslConfiguration mDefaultSslConfig;
+    QTemporaryDir mKeyDir;
+    QString mServerNonce = NONCE_1;
+    QHash<int, int> mNonceErrors; // request index -> nonce errors
+};
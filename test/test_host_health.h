@@ -0,0 +1,87 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <host_health.h>
+#include <QTest>
+
+using namespace ATProto;
+using namespace std::chrono_literals;
+
+class TestHostHealth : public QObject
+{
+    Q_OBJECT
+private slots:
+    void hedgeDelay()
+    {
+        HostHealth health;
+        QCOMPARE(health.getHedgeDelay(), HostHealth::DEFAULT_HEDGE_DELAY);
+
+        for (int i = 1; i <= 100; ++i)
+            health.recordResponse(std::chrono::milliseconds(i * 10));
+
+        // Only the last 50 samples count: 510..1000ms
+        QCOMPARE(health.getLatencyPercentile(0.0), 510ms);
+        QCOMPARE(health.getLatencyPercentile(0.5), 750ms);
+        QCOMPARE(health.getHedgeDelay(), 980ms);
+
+        for (int i = 0; i < HostHealth::LATENCY_WINDOW; ++i)
+            health.recordResponse(1ms);
+
+        QCOMPARE(health.getHedgeDelay(), HostHealth::MIN_HEDGE_DELAY);
+    }
+
+    void circuitBreaker()
+    {
+        HostHealth health(10s);
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+
+        for (int i = 0; i < HostHealth::FAILURE_THRESHOLD - 1; ++i)
+            health.recordFailure(now);
+
+        QCOMPARE(health.getState(), HostHealth::State::CLOSED);
+        QVERIFY(health.allowRequest(now));
+
+        health.recordFailure(now);
+        QCOMPARE(health.getState(), HostHealth::State::OPEN);
+        QVERIFY(!health.allowRequest(now.addSecs(9)));
+
+        // One probe after the open duration
+        QVERIFY(health.allowRequest(now.addSecs(10)));
+        QCOMPARE(health.getState(), HostHealth::State::HALF_OPEN);
+        QVERIFY(!health.allowRequest(now.addSecs(10)));
+
+        // A failed probe doubles the open duration
+        health.recordFailure(now.addSecs(10));
+        QCOMPARE(health.getState(), HostHealth::State::OPEN);
+        QVERIFY(!health.allowRequest(now.addSecs(29)));
+        QVERIFY(health.allowRequest(now.addSecs(30)));
+
+        health.recordResponse(100ms);
+        QCOMPARE(health.getState(), HostHealth::State::CLOSED);
+        QCOMPARE(health.getConsecutiveFailures(), 0);
+        QVERIFY(health.allowRequest(now.addSecs(30)));
+    }
+
+    void abortedProbe()
+    {
+        HostHealth health(10s);
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+
+        for (int i = 0; i < HostHealth::FAILURE_THRESHOLD; ++i)
+            health.recordFailure(now);
+
+        QVERIFY(health.allowRequest(now.addSecs(10)));
+        QCOMPARE(health.getState(), HostHealth::State::HALF_OPEN);
+
+        // The next request probes again.
+        health.recordAbort();
+        QCOMPARE(health.getState(), HostHealth::State::OPEN);
+        QVERIFY(health.allowRequest(now.addSecs(10)));
+        QCOMPARE(health.getState(), HostHealth::State::HALF_OPEN);
+
+        // An abort does not change a closed circuit.
+        health.recordResponse(100ms);
+        health.recordAbort();
+        QCOMPARE(health.getState(), HostHealth::State::CLOSED);
+    }
+};
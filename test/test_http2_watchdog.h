@@ -0,0 +1,221 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "fake_network.h"
+#include <xrpc_http2_watchdog.h>
+#include <xrpc_network_thread.h>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace Xrpc;
+using namespace std::chrono_literals;
+
+class TestHttp2Watchdog : public QObject
+{
+    Q_OBJECT
+private slots:
+    void singleWaitingReplyIsNoStall()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        // The server may take long to process a request.
+        FakeReply reply(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply, start);
+        watchdog.checkStalls(start + 10 * STALL_TIMEOUT);
+        QVERIFY(!reply.isAborted());
+        QCOMPARE(watchdog.getStallCount(), 0);
+    }
+
+    void multipleWaitingRepliesStall()
+    {
+        Http2Watchdog watchdog;
+        watchdog.setHttp2RetryInterval(RETRY_INTERVAL);
+        QSignalSpy stalledSpy(&watchdog, &Http2Watchdog::stalled);
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        FakeReply reply1(makeRequest(), QNetworkAccessManager::GetOperation);
+        FakeReply reply2(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply1, start);
+        watchdog.watch(&reply2, start);
+
+        // The server may be slow on both requests.
+        watchdog.checkStalls(start + STALL_TIMEOUT);
+        watchdog.checkStalls(start + WAITING_STALL_TIMEOUT - 1ms);
+        QVERIFY(!reply1.isAborted());
+        QVERIFY(!reply2.isAborted());
+
+        const auto stallTime = start + WAITING_STALL_TIMEOUT;
+        watchdog.checkStalls(stallTime);
+        QVERIFY(reply1.isAborted());
+        QVERIFY(reply2.isAborted());
+        QVERIFY(Http2Watchdog::isStallAbort(&reply1));
+        QVERIFY(Http2Watchdog::isStallAbort(&reply2));
+        QCOMPARE(watchdog.getStallCount(), 1);
+        QCOMPARE(stalledSpy.count(), 1);
+        QCOMPARE(stalledSpy.front().front().toString(), "pds.test");
+
+        // Fall back to HTTP/1.1 till the retry interval passed.
+        QNetworkRequest request = makeRequest();
+        watchdog.prepare(request, stallTime + RETRY_INTERVAL - 1ms);
+        QVERIFY(!request.attribute(QNetworkRequest::Http2AllowedAttribute, true).toBool());
+        QVERIFY(watchdog.isHttp2Allowed(QUrl("https://other.test/xrpc/test.ping"), stallTime));
+
+        request = makeRequest();
+        watchdog.prepare(request, stallTime + RETRY_INTERVAL);
+        QVERIFY(request.attribute(QNetworkRequest::Http2AllowedAttribute, true).toBool());
+    }
+
+    void waitingStallKeepsPost()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        FakeReply getReply(makeRequest(), QNetworkAccessManager::GetOperation);
+        FakeReply postReply(makeRequest(), QNetworkAccessManager::PostOperation);
+        watchdog.watch(&getReply, start);
+        watchdog.watch(&postReply, start);
+        emit postReply.uploadProgress(1000, 1000);
+
+        // The POST may have been processed, it is not resent after an abort.
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + WAITING_STALL_TIMEOUT);
+        QVERIFY(getReply.isAborted());
+        QVERIFY(!postReply.isAborted());
+        QCOMPARE(watchdog.getStallCount(), 1);
+        QVERIFY(!watchdog.isHttp2Allowed(makeRequest().url()));
+    }
+
+    void downloadOutstanding()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        FakeReply reply(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply, start);
+        const auto progressTime = Http2Watchdog::Clock::now();
+        reply.receiveHeaders(1000);
+        emit reply.downloadProgress(100, 1000);
+
+        watchdog.checkStalls(progressTime + STALL_TIMEOUT - 1ms);
+        QVERIFY(!reply.isAborted());
+
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + STALL_TIMEOUT);
+        QVERIFY(reply.isAborted());
+        QCOMPARE(watchdog.getStallCount(), 1);
+    }
+
+    void downloadComplete()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        // All bytes arrived, the reply only waits to be finished.
+        FakeReply reply(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply, start);
+        reply.receiveHeaders(1000);
+        emit reply.downloadProgress(1000, 1000);
+
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + 10 * STALL_TIMEOUT);
+        QVERIFY(!reply.isAborted());
+    }
+
+    void uploadOutstanding()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+        useHttp2(watchdog, start);
+
+        FakeReply reply(makeRequest(), QNetworkAccessManager::PostOperation);
+        watchdog.watch(&reply, start);
+        emit reply.uploadProgress(100, 1000);
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + STALL_TIMEOUT);
+        QVERIFY(reply.isAborted());
+
+        // After the upload completed, the reply waits for the server.
+        FakeReply reply2(makeRequest(), QNetworkAccessManager::PostOperation);
+        useHttp2(watchdog, start);
+        watchdog.watch(&reply2, start);
+        emit reply2.uploadProgress(1000, 1000);
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + 10 * STALL_TIMEOUT);
+        QVERIFY(!reply2.isAborted());
+    }
+
+    void http1NotWatched()
+    {
+        Http2Watchdog watchdog;
+        const auto start = Http2Watchdog::Clock::now();
+
+        // HTTP/2 use is not known yet.
+        FakeReply reply1(makeRequest(), QNetworkAccessManager::GetOperation);
+        FakeReply reply2(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply1, start);
+        watchdog.watch(&reply2, start);
+        watchdog.checkStalls(start + 10 * STALL_TIMEOUT);
+        QVERIFY(!reply1.isAborted());
+        QVERIFY(!reply2.isAborted());
+    }
+
+    void resendAfterStall()
+    {
+        FakeNetwork network;
+        DecodePool decodePool(1);
+        RequestScheduler scheduler;
+        Metrics metrics;
+        TlsSessionStore tlsSessionStore;
+        Http2Watchdog watchdog;
+        NetworkThread thread(&network, decodePool, scheduler, metrics, tlsSessionStore,
+                             nullptr, &watchdog, TIMEOUT_MS, {});
+        thread.setPDS("https://pds.test");
+        useHttp2(watchdog, Http2Watchdog::Clock::now());
+
+        connect(&thread, &NetworkThread::requestError, this,
+                [](QString error, QJsonDocument json, NetworkThread::ErrorCb cb){ cb(error, json); });
+
+        QStringList errors;
+        const auto errorCb = [&errors](const QString& error, const QJsonDocument&){ errors.push_back(error); };
+
+        thread.get("test.get", {}, {}, NetworkThread::SuccessJsonCb([](const QJsonDocument&){}), errorCb,
+                   {}, false, {}, RequestHandle::create(), RequestPriority::NORMAL, QDeadlineTimer(QDeadlineTimer::Forever));
+        thread.postJson("test.post", QJsonDocument(QJsonObject{}), {}, NetworkThread::SuccessJsonCb([](const QJsonDocument&){}),
+                        errorCb, {}, false, RequestHandle::create(), RequestPriority::NORMAL, QDeadlineTimer(QDeadlineTimer::Forever));
+
+        QTRY_COMPARE_WITH_TIMEOUT(network.mReplies.size(), (size_t)2, TIMEOUT_MS);
+        emit network.mReplies[1]->uploadProgress(10, 100);
+        watchdog.checkStalls(Http2Watchdog::Clock::now() + STALL_TIMEOUT);
+        QVERIFY(network.mReplies[0]->isAborted());
+        QVERIFY(network.mReplies[1]->isAborted());
+
+        // The GET gets resent, the POST fails.
+        QTRY_COMPARE_WITH_TIMEOUT(network.mReplies.size(), (size_t)3, TIMEOUT_MS);
+        QCOMPARE(network.mReplies[2]->url().path(), "/xrpc/test.get");
+        QCOMPARE(errors.size(), 1);
+        QCOMPARE(errors.front(), ATProto::ATProtoErrorMsg::XRPC_TIMEOUT);
+
+        // A resend of the POST would have been sent within the backoff of the first retry.
+        QTest::qWait(ATProto::RateLimiter::BASE_BACKOFF.count());
+        QCOMPARE(network.mReplies.size(), (size_t)3);
+    }
+
+private:
+    static constexpr std::chrono::milliseconds STALL_TIMEOUT = Http2Watchdog::DEFAULT_STALL_TIMEOUT;
+    static constexpr std::chrono::milliseconds WAITING_STALL_TIMEOUT = Http2Watchdog::DEFAULT_WAITING_STALL_TIMEOUT;
+    static constexpr std::chrono::minutes RETRY_INTERVAL{1};
+    static constexpr int TIMEOUT_MS = 5000;
+
+    static QNetworkRequest makeRequest() { return QNetworkRequest(QUrl("https://pds.test/xrpc/test.ping")); }
+
+    // A finished reply on HTTP/2 tells the watchdog that the host uses HTTP/2.
+    static void useHttp2(Http2Watchdog& watchdog, Http2Watchdog::Clock::time_point now)
+    {
+        FakeReply reply(makeRequest(), QNetworkAccessManager::GetOperation);
+        watchdog.watch(&reply, now);
+        reply.receiveHeaders(0);
+        reply.finish();
+    }
+};
@@ -0,0 +1,73 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <xrpc_json_array_splitter.h>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+using namespace Xrpc;
+
+class TestJsonArraySplitter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void split_data()
+    {
+        QTest::addColumn<int>("chunkSize");
+
+        for (int chunkSize : {1, 2, 3, 7, 64, 100000})
+            QTest::newRow(qPrintable(QString("chunk %1").arg(chunkSize))) << chunkSize;
+    }
+
+    void split()
+    {
+        QFETCH(int, chunkSize);
+        JsonArraySplitter splitter("feed");
+        std::vector<QByteArray> elements;
+
+        for (qsizetype i = 0; i < REPLY.size(); i += chunkSize)
+            splitter.feed(REPLY.mid(i, chunkSize), elements);
+
+        const auto expected = QJsonDocument::fromJson(REPLY).object();
+        const auto expectedFeed = expected["feed"].toArray();
+        QCOMPARE(elements.size(), (size_t)expectedFeed.size());
+        QCOMPARE(splitter.getElementCount(), expectedFeed.size());
+        QVERIFY(splitter.isArrayDone());
+
+        for (size_t i = 0; i < elements.size(); ++i)
+            QCOMPARE(QJsonDocument::fromJson(elements[i]).object(), expectedFeed[i].toObject());
+
+        auto expectedRemainder = expected;
+        expectedRemainder["feed"] = QJsonArray{};
+        QCOMPARE(QJsonDocument::fromJson(splitter.getRemainder()).object(), expectedRemainder);
+    }
+
+    void noArray()
+    {
+        JsonArraySplitter splitter("feed");
+        std::vector<QByteArray> elements;
+        const QByteArray reply = R"({"cursor":"c","other":[{"feed":[1]}]})";
+        splitter.feed(reply, elements);
+
+        QVERIFY(elements.empty());
+        QVERIFY(!splitter.isArrayDone());
+        QCOMPARE(splitter.getRemainder(), reply);
+    }
+
+private:
+    // Strings with JSON syntax and arrays with the same key at other levels must
+    // not confuse the splitter.
+    const QByteArray REPLY = R"({
+        "cursor": "a\"b],{",
+        "other": [1, {"feed": [2]}],
+        "feed": [
+            {"post": {"text": "he said \"}],\" ok", "x": [1, 2, {"y": "]"}]}},
+            {"a": 1},
+            {}
+        ],
+        "feed2": [{"z": 1}],
+        "tail": {"feed": [5]}
+    })";
+};
@@ -0,0 +1,305 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <json_web_key.h>
+#include <xrpc_decode_pool.h>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+
+using namespace ATProto;
+
+class TestJsonWebKey : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        mKey = JsonWebKey::generateDPoPKey("test");
+        QVERIFY(!mKey.isNull());
+    }
+
+    void pdsProof()
+    {
+        const auto proof = mKey.buildPdsDPoPProof("get", URL, "access-token", "nonce-1");
+        const auto parts = proof.toUtf8().split('.');
+        QCOMPARE(parts.size(), 3);
+
+        const auto header = decodeJson(parts[0]);
+        QCOMPARE(header["typ"].toString(), "dpop+jwt");
+        QCOMPARE(header["alg"].toString(), "ES256");
+        QCOMPARE(header["jwk"].toObject()["crv"].toString(), "P-256");
+
+        const auto payload = decodeJson(parts[1]);
+        QCOMPARE(payload["htm"].toString(), "GET");
+        QCOMPARE(payload["htu"].toString(), URL);
+        QCOMPARE(payload["nonce"].toString(), "nonce-1");
+        QVERIFY(payload.contains("ath"));
+
+        // P-256 signature R||S
+        QCOMPARE(QByteArray::fromBase64(parts[2], BASE64_URL).size(), 64);
+
+        // Each proof has a unique jti, the header is shared.
+        const auto other = mKey.buildPdsDPoPProof("GET", URL, "access-token", "nonce-1").toUtf8().split('.');
+        QCOMPARE(other[0], parts[0]);
+        QVERIFY(decodeJson(other[1]).value("jti") != payload.value("jti"));
+    }
+
+    void proofSignature()
+    {
+        const auto parts = mKey.buildPdsDPoPProof("GET", URL, "access-token", "nonce-1").toUtf8().split('.');
+        QCOMPARE(parts.size(), 3);
+        const auto jwk = decodeJson(parts[0])["jwk"].toObject();
+        const QByteArray signature = QByteArray::fromBase64(parts[2], BASE64_URL);
+        QVERIFY(verifySignature(jwk, parts[0] + '.' + parts[1], signature));
+
+        // The signature does not match other data, nor another key.
+        QVERIFY(!verifySignature(jwk, parts[0] + '.' + parts[1] + 'x', signature));
+        const auto otherKey = JsonWebKey::generateDPoPKey("test");
+        const auto otherParts = otherKey.buildPdsDPoPProof("GET", URL, {}, {}).toUtf8().split('.');
+        QVERIFY(!verifySignature(decodeJson(otherParts[0])["jwk"].toObject(), parts[0] + '.' + parts[1], signature));
+    }
+
+    void uncachedProofSignature()
+    {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        QVERIFY(key);
+        const auto parts = buildUncachedProof(key, "GET", URL, "access-token", "nonce-1").toUtf8().split('.');
+        EVP_PKEY_free(key);
+
+        QCOMPARE(parts.size(), 3);
+        const auto jwk = decodeJson(parts[0])["jwk"].toObject();
+        QVERIFY(verifySignature(jwk, parts[0] + '.' + parts[1], QByteArray::fromBase64(parts[2], BASE64_URL)));
+    }
+
+    void movedKeyKeepsProofs()
+    {
+        auto key = JsonWebKey::generateDPoPKey("test");
+        const auto header = key.buildPdsDPoPProof("GET", URL, {}, {}).toUtf8().split('.')[0];
+
+        JsonWebKey moved(std::move(key));
+        QVERIFY(key.isNull());
+        QCOMPARE(moved.buildPdsDPoPProof("GET", URL, {}, {}).toUtf8().split('.')[0], header);
+
+        // The header of the previous key must not stick.
+        moved = JsonWebKey::generateDPoPKey("test");
+        QVERIFY(moved.buildPdsDPoPProof("GET", URL, {}, {}).toUtf8().split('.')[0] != header);
+    }
+
+    // Proofs per second built inline on a single thread, like the network thread
+    // did for every request, against proofs built on the worker pool. The uncached
+    // baseline builds the header and signing context for every proof. The time the
+    // submitting thread is busy is what the network thread spends per request.
+    // Timings depend on the machine, so they are reported, not verified.
+    void proofsPerSecond()
+    {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        QVERIFY(key);
+        QElapsedTimer uncachedTimer;
+        uncachedTimer.start();
+
+        for (int i = 0; i < PROOF_COUNT; ++i)
+            buildUncachedProof(key, "GET", URL, "access-token", "nonce-1");
+
+        const qint64 uncachedNs = uncachedTimer.nsecsElapsed();
+        EVP_PKEY_free(key);
+
+        QElapsedTimer inlineTimer;
+        inlineTimer.start();
+
+        for (int i = 0; i < PROOF_COUNT; ++i)
+            mKey.buildPdsDPoPProof("GET", URL, "access-token", "nonce-1");
+
+        const qint64 inlineNs = inlineTimer.nsecsElapsed();
+
+        Xrpc::DecodePool pool;
+        std::atomic_int validCount = 0;
+        QElapsedTimer poolTimer;
+        poolTimer.start();
+
+        for (int i = 0; i < PROOF_COUNT; ++i)
+        {
+            pool.decode([this, &validCount]{
+                const auto proof = mKey.buildPdsDPoPProof("GET", URL, "access-token", "nonce-1");
+
+                if (proof.count('.') == 2)
+                    ++validCount;
+            });
+        }
+
+        const qint64 submitNs = poolTimer.nsecsElapsed();
+        QVERIFY(pool.waitForDone(30'000));
+        const qint64 poolNs = poolTimer.nsecsElapsed();
+        QCOMPARE(validCount.load(), PROOF_COUNT);
+
+        qInfo() << "DPoP proofs/s uncached:" << toProofsPerSecond(uncachedNs)
+                << "inline:" << toProofsPerSecond(inlineNs)
+                << "pool:" << toProofsPerSecond(poolNs) << "threads:" << pool.maxThreadCount();
+        qInfo() << "Calling thread per proof, uncached:" << uncachedNs / PROOF_COUNT
+                << "ns inline:" << inlineNs / PROOF_COUNT << "ns pool:" << submitNs / PROOF_COUNT << "ns";
+    }
+
+    void benchmarkProof()
+    {
+        QBENCHMARK {
+            mKey.buildPdsDPoPProof("GET", URL, "access-token", "nonce-1");
+        }
+    }
+
+    void benchmarkUncachedProof()
+    {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        QVERIFY(key);
+
+        QBENCHMARK {
+            buildUncachedProof(key, "GET", URL, "access-token", "nonce-1");
+        }
+
+        EVP_PKEY_free(key);
+    }
+
+private:
+    static constexpr int PROOF_COUNT = 2000;
+    static constexpr char const* URL = "https://pds.example/xrpc/app.bsky.feed.getTimeline";
+    static constexpr auto BASE64_URL = QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals;
+
+    static QJsonObject decodeJson(const QByteArray& base64)
+    {
+        return QJsonDocument::fromJson(QByteArray::fromBase64(base64, BASE64_URL)).object();
+    }
+
+    static qint64 toProofsPerSecond(qint64 ns)
+    {
+        return ns > 0 ? PROOF_COUNT * 1'000'000'000LL / ns : 0;
+    }
+
+    static QByteArray toBase64Url(const BIGNUM* bn)
+    {
+        QByteArray buf(32, '\0');
+        BN_bn2binpad(bn, reinterpret_cast<unsigned char*>(buf.data()), 32);
+        return buf.toBase64(BASE64_URL);
+    }
+
+    // Builds a proof the way JsonWebKey did before it cached the header and the
+    // signing context.
+    static QString buildUncachedProof(EVP_PKEY* key, const QString& httpMethod, const QString& httpUri,
+                                      const QString& accessToken, const QString& nonce)
+    {
+        BIGNUM* x = nullptr;
+        BIGNUM* y = nullptr;
+        EVP_PKEY_get_bn_param(key, OSSL_PKEY_PARAM_EC_PUB_X, &x);
+        EVP_PKEY_get_bn_param(key, OSSL_PKEY_PARAM_EC_PUB_Y, &y);
+
+        QJsonObject jwk;
+        jwk["kty"] = "EC";
+        jwk["crv"] = "P-256";
+        jwk["x"] = QString::fromLatin1(toBase64Url(x));
+        jwk["y"] = QString::fromLatin1(toBase64Url(y));
+        BN_free(x);
+        BN_free(y);
+
+        QJsonObject header;
+        header["typ"] = "dpop+jwt";
+        header["alg"] = "ES256";
+        header["jwk"] = jwk;
+
+        QJsonObject payload;
+        payload["jti"] = JsonWebKey::generateToken();
+        payload["htm"] = httpMethod.toUpper();
+        payload["htu"] = httpUri;
+        const auto now = QDateTime::currentSecsSinceEpoch();
+        payload["iat"] = now;
+        payload["exp"] = now + 30;
+        payload["ath"] = QString::fromLatin1(QCryptographicHash::hash(accessToken.toUtf8(), QCryptographicHash::Sha256).toBase64(BASE64_URL));
+        payload["nonce"] = nonce;
+
+        const QByteArray signingInput = QJsonDocument(header).toJson(QJsonDocument::Compact).toBase64(BASE64_URL) + '.' +
+                                        QJsonDocument(payload).toJson(QJsonDocument::Compact).toBase64(BASE64_URL);
+
+        EVP_MD_CTX* mdCtx = EVP_MD_CTX_new();
+        size_t sigLen = 0;
+        EVP_DigestSignInit(mdCtx, nullptr, EVP_sha256(), nullptr, key);
+        EVP_DigestSignUpdate(mdCtx, signingInput.constData(), signingInput.size());
+        EVP_DigestSignFinal(mdCtx, nullptr, &sigLen);
+        QByteArray der(sigLen, '\0');
+        EVP_DigestSignFinal(mdCtx, reinterpret_cast<unsigned char*>(der.data()), &sigLen);
+        EVP_MD_CTX_free(mdCtx);
+
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(der.constData());
+        ECDSA_SIG* sig = d2i_ECDSA_SIG(nullptr, &p, sigLen);
+
+        if (!sig)
+            return {};
+
+        QByteArray raw(64, '\0');
+        BN_bn2binpad(ECDSA_SIG_get0_r(sig), reinterpret_cast<unsigned char*>(raw.data()), 32);
+        BN_bn2binpad(ECDSA_SIG_get0_s(sig), reinterpret_cast<unsigned char*>(raw.data()) + 32, 32);
+        ECDSA_SIG_free(sig);
+
+        return QString::fromLatin1(signingInput + '.' + raw.toBase64(BASE64_URL));
+    }
+
+    static EVP_PKEY* publicKeyFromJwk(const QJsonObject& jwk)
+    {
+        const QByteArray x = QByteArray::fromBase64(jwk["x"].toString().toLatin1(), BASE64_URL);
+        const QByteArray y = QByteArray::fromBase64(jwk["y"].toString().toLatin1(), BASE64_URL);
+
+        if (jwk["kty"].toString() != "EC" || jwk["crv"].toString() != "P-256" || x.size() != 32 || y.size() != 32)
+            return nullptr;
+
+        // Uncompressed point
+        QByteArray point = QByteArray(1, '\x04') + x + y;
+        char groupName[] = "prime256v1";
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, groupName, 0),
+            OSSL_PARAM_construct_octet_string(OSSL_PKEY_PARAM_PUB_KEY, point.data(), point.size()),
+            OSSL_PARAM_construct_end()
+        };
+
+        EVP_PKEY* key = nullptr;
+        EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_name(nullptr, "EC", nullptr);
+
+        if (!ctx || EVP_PKEY_fromdata_init(ctx) != 1 || EVP_PKEY_fromdata(ctx, &key, EVP_PKEY_PUBLIC_KEY, params) != 1)
+            key = nullptr;
+
+        EVP_PKEY_CTX_free(ctx);
+        return key;
+    }
+
+    // Verifies a raw R||S signature with the public JWK.
+    static bool verifySignature(const QJsonObject& jwk, const QByteArray& data, const QByteArray& signature)
+    {
+        if (signature.size() != 64)
+            return false;
+
+        EVP_PKEY* key = publicKeyFromJwk(jwk);
+
+        if (!key)
+            return false;
+
+        const auto* raw = reinterpret_cast<const unsigned char*>(signature.constData());
+        ECDSA_SIG* sig = ECDSA_SIG_new();
+        ECDSA_SIG_set0(sig, BN_bin2bn(raw, 32, nullptr), BN_bin2bn(raw + 32, 32, nullptr));
+        QByteArray der(i2d_ECDSA_SIG(sig, nullptr), '\0');
+        auto* p = reinterpret_cast<unsigned char*>(der.data());
+        i2d_ECDSA_SIG(sig, &p);
+        ECDSA_SIG_free(sig);
+
+        EVP_MD_CTX* mdCtx = EVP_MD_CTX_new();
+        const bool valid = EVP_DigestVerifyInit(mdCtx, nullptr, EVP_sha256(), nullptr, key) == 1 &&
+            EVP_DigestVerify(mdCtx, reinterpret_cast<const unsigned char*>(der.constData()), der.size(),
+                             reinterpret_cast<const unsigned char*>(data.constData()), data.size()) == 1;
+        EVP_MD_CTX_free(mdCtx);
+        EVP_PKEY_free(key);
+        return valid;
+    }
+
+    JsonWebKey mKey;
+};
@@ -0,0 +1,453 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <client.h>
+#include <json_writer.h>
+#include <lexicon/app_bsky_actor.h>
+#include <lexicon/app_bsky_feed.h>
+#include <lexicon/app_bsky_graph.h>
+#include <lexicon/chat_bsky_convo.h>
+#include <lexicon/com_atproto_repo.h>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+#include <limits>
+
+using namespace ATProto;
+
+class TestJsonWriter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void structure()
+    {
+        JsonWriter writer;
+        writer.beginObject();
+        writer.key("a").integer(1);
+        writer.key("b").beginArray().boolean(true).null().number(1.5).beginObject().endObject().endArray();
+        writer.key("c").beginArray().endArray();
+        writer.key("d").string("x");
+        writer.endObject();
+        QCOMPARE(writer.take(), R"({"a":1,"b":[true,null,1.5,{}],"c":[],"d":"x"})");
+        QVERIFY(writer.getData().isEmpty());
+    }
+
+    void strings_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::newRow("empty") << QString();
+        QTest::newRow("ascii") << QString("hello world");
+        QTest::newRow("escapes") << QString("quote\" backslash\\ slash/ \b\f\n\r\t");
+        QTest::newRow("control") << QString(QChar(0x01)) + QChar(0x1f) + QChar(0x7f);
+        QTest::newRow("latin") << QString::fromUtf8("café");
+        QTest::newRow("cjk") << QString::fromUtf8("日本語");
+        QTest::newRow("emoji") << QString::fromUtf8("\U0001F600 \U0001F44D\U0001F3FD");
+    }
+
+    void strings()
+    {
+        QFETCH(QString, text);
+
+        JsonWriter writer;
+        writer.beginArray().string(text).endArray();
+        const QByteArray data = writer.take();
+
+        QJsonParseError error;
+        const auto doc = QJsonDocument::fromJson(data, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.array().at(0).toString(), text);
+        QCOMPARE(data, QJsonDocument(QJsonArray{text}).toJson(QJsonDocument::Compact));
+    }
+
+    void stringViews()
+    {
+        const QString text = QString::fromUtf8("café \"\U0001F600\"");
+
+        JsonWriter writer;
+        writer.beginArray();
+        writer.string(text);
+        writer.string(text.toUtf8());
+        writer.string(QLatin1StringView("caf\xe9 \"x\""));
+        writer.endArray();
+
+        const auto array = QJsonDocument::fromJson(writer.take()).array();
+        QCOMPARE(array.size(), 3);
+        QCOMPARE(array.at(0).toString(), text);
+        QCOMPARE(array.at(1).toString(), text);
+        QCOMPARE(array.at(2).toString(), QString::fromUtf8("café \"x\""));
+    }
+
+    void unpairedSurrogate()
+    {
+        JsonWriter writer;
+        writer.beginArray().string(QString(QChar(0xd83d)) + 'a').endArray();
+        QCOMPARE(QJsonDocument::fromJson(writer.take()).array().at(0).toString(),
+                 QString(QChar(QChar::ReplacementCharacter)) + 'a');
+    }
+
+    void numbers()
+    {
+        JsonWriter writer;
+        writer.beginArray();
+        writer.integer(0).integer(-42).integer(Q_INT64_C(9007199254740993));
+        writer.number(0.1).number(-2.5e-300).number(qInf()).number(qQNaN());
+        writer.value(QJsonValue(3.0)).value(QJsonValue(0.25));
+        writer.endArray();
+        QCOMPARE(writer.take(), "[0,-42,9007199254740993,0.1,-2.5e-300,null,null,3,0.25]");
+    }
+
+    void domValue()
+    {
+        const QJsonObject record = createRecord(7);
+
+        JsonWriter writer;
+        writer.value(record);
+        QCOMPARE(QJsonDocument::fromJson(writer.take()).object(), record);
+    }
+
+    void applyWrites()
+    {
+        const auto writes = createWrites(6);
+        const QByteArray data = Client::writeApplyWrites(REPO, writes, true);
+
+        QJsonParseError error;
+        const auto doc = QJsonDocument::fromJson(data, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.object(), toApplyWritesJson(writes));
+    }
+
+    void post()
+    {
+        const auto post = createPost(1);
+        QVERIFY(!post->mFacets.empty());
+        QVERIFY(post->mReply);
+        QVERIFY(post->mEmbed);
+        QVERIFY(post->mLabels);
+        QCOMPARE(writeObject(*post), post->toJson());
+        QCOMPARE(writeObject(*post).value("index").toInt(), 1);
+    }
+
+    // The embed of a post that was never decoded gets written from the JSON of the post.
+    void postUndecodedEmbed()
+    {
+        const QJsonObject record = createRecord(1);
+        const QJsonObject embed = record.value("embed").toObject();
+
+        const auto nullEmbedPost = createPost(1);
+        nullEmbedPost->mEmbed = AppBskyFeed::Record::Post::EmbedType{};
+        QVERIFY(isNullVariant(*nullEmbedPost->mEmbed));
+        QCOMPARE(writeObject(*nullEmbedPost).value("embed").toObject(), embed);
+        QTest::ignoreMessage(QtWarningMsg, "NULL variant: \"embed\"");
+        QCOMPARE(writeObject(*nullEmbedPost), nullEmbedPost->toJson());
+
+        const auto noEmbedPost = createPost(1);
+        noEmbedPost->mEmbed.reset();
+        QCOMPARE(writeObject(*noEmbedPost).value("embed").toObject(), embed);
+    }
+
+    void messageInput()
+    {
+        const QJsonObject json{
+            {"text", "Hello @alice.test"},
+            {"facets", QJsonArray{createFacet()}},
+            {"embed", QJsonObject{
+                {"$type", "app.bsky.embed.record"},
+                {"record", QJsonObject{{"uri", "at://did:plc:test/app.bsky.feed.post/quoted"}, {"cid", "bafyquoted"}}}
+            }},
+            {"replyTo", QJsonObject{{"messageId", "msg1"}}}
+        };
+        const auto message = ChatBskyConvo::MessageInput::fromJson(json);
+        QVERIFY(message->mEmbed);
+        QVERIFY(message->mReplyTo);
+        QCOMPARE(writeObject(*message), message->toJson());
+    }
+
+    void listItem()
+    {
+        const QJsonObject json{
+            {"$type", AppBskyGraph::ListItem::TYPE},
+            {"subject", "did:plc:subject"},
+            {"list", "at://did:plc:test/app.bsky.graph.list/list1"},
+            {"createdAt", CREATED_AT},
+            {"unknownField", "keep"}
+        };
+        const auto item = AppBskyGraph::ListItem::fromJson(json);
+        const ComATProtoRepo::RecordValue value(item);
+
+        JsonWriter writer;
+        value.writeJson(writer);
+        const auto written = QJsonDocument::fromJson(writer.take()).object();
+        QCOMPARE(written, item->toJson());
+        QCOMPARE(written, value.toJson());
+        QCOMPARE(written.value("unknownField").toString(), "keep");
+    }
+
+    void recordValueJson()
+    {
+        const QJsonObject record{{"$type", "app.bsky.feed.like"}, {"createdAt", CREATED_AT}};
+        const ComATProtoRepo::RecordValue value(record);
+
+        JsonWriter writer;
+        value.writeJson(writer);
+        QCOMPARE(QJsonDocument::fromJson(writer.take()).object(), record);
+        QCOMPARE(value.toJson(), record);
+    }
+
+    void preferences()
+    {
+        const auto prefs = AppBskyActor::GetPreferencesOutput::fromJson(createPreferencesJson());
+        QCOMPARE(prefs->mPreferences.size(), (size_t)13);
+
+        JsonWriter writer;
+        prefs->writeJson(writer);
+        const auto written = QJsonDocument::fromJson(writer.take()).object();
+        QCOMPARE(written, prefs->toJson());
+
+        // Unknown fields and preferences are kept.
+        const auto writtenPrefs = written.value("preferences").toArray();
+        QCOMPARE(writtenPrefs.size(), 13);
+        QCOMPARE(writtenPrefs.at(0).toObject().value("unknownField").toString(), "keep");
+        QCOMPARE(writtenPrefs.at(12).toObject().value("$type").toString(), "app.bsky.actor.defs#futurePref");
+    }
+
+    void postInteractionSettings_data()
+    {
+        QTest::addColumn<QJsonObject>("json");
+        const QString type = AppBskyActor::PostInteractionSettingsPref::TYPE;
+        QTest::newRow("no rules") << QJsonObject{{"$type", type}};
+        QTest::newRow("nobody") << QJsonObject{{"$type", type}, {"threadgateAllowRules", QJsonArray{}}};
+        QTest::newRow("all rules") << createPostInteractionSettingsJson();
+    }
+
+    void postInteractionSettings()
+    {
+        QFETCH(QJsonObject, json);
+        const auto pref = AppBskyActor::PostInteractionSettingsPref::fromJson(json);
+        QCOMPARE(writeObject(*pref), pref->toJson());
+    }
+
+    // Serialization of an applyWrites batch of posts through a DOM, as it was done,
+    // against the writer.
+    void applyWritesThroughput()
+    {
+        const auto writes = createWrites(BATCH_SIZE);
+        const auto writeDom = [&writes]{
+            return QJsonDocument(toApplyWritesJson(writes)).toJson(QJsonDocument::Compact);
+        };
+        const auto writeStream = [&writes]{ return Client::writeApplyWrites(REPO, writes, true); };
+
+        // Same content, only the order of the keys differs.
+        QCOMPARE(writeStream().size(), writeDom().size());
+
+        const qint64 domNs = measure(writeDom);
+        const qint64 writerNs = measure(writeStream);
+        qInfo() << "applyWrites" << BATCH_SIZE << "writes, DOM:" << domNs << "ns writer:" << writerNs
+                << "ns speedup:" << (double)domNs / writerNs;
+        QVERIFY(writerNs < domNs);
+    }
+
+    void preferencesThroughput()
+    {
+        const auto prefs = AppBskyActor::GetPreferencesOutput::fromJson(createPreferencesJson());
+        const auto writeDom = [&prefs]{ return QJsonDocument(prefs->toJson()).toJson(QJsonDocument::Compact); };
+        const auto writeStream = [&prefs]{
+            JsonWriter writer;
+            prefs->writeJson(writer);
+            return writer.take();
+        };
+
+        QCOMPARE(writeStream().size(), writeDom().size());
+
+        const qint64 domNs = measure(writeDom);
+        const qint64 writerNs = measure(writeStream);
+        qInfo() << "preferences, DOM:" << domNs << "ns writer:" << writerNs
+                << "ns speedup:" << (double)domNs / writerNs;
+        QVERIFY(writerNs < domNs);
+    }
+
+    void benchmarkApplyWrites()
+    {
+        const auto writes = createWrites(BATCH_SIZE);
+
+        QBENCHMARK {
+            Client::writeApplyWrites(REPO, writes, true);
+        }
+    }
+
+private:
+    static constexpr int BATCH_SIZE = 200;
+    static constexpr int ROUNDS = 50;
+    static constexpr int RUNS = 5;
+    static constexpr char const* REPO = "did:plc:test";
+    static constexpr char const* CREATED_AT = "2026-10-16T12:00:00.000Z";
+
+    // Best time of a number of runs in ns per round.
+    template<typename Fun>
+    static qint64 measure(const Fun& fun)
+    {
+        qint64 best = std::numeric_limits<qint64>::max();
+
+        for (int run = 0; run < RUNS; ++run)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            qsizetype size = 0;
+
+            for (int i = 0; i < ROUNDS; ++i)
+                size += fun().size();
+
+            best = std::min(best, timer.nsecsElapsed() / ROUNDS);
+            Q_ASSERT(size > 0);
+        }
+
+        return best;
+    }
+
+    template<typename ObjType>
+    static QJsonObject writeObject(const ObjType& obj)
+    {
+        JsonWriter writer;
+        obj.writeJson(writer);
+        return QJsonDocument::fromJson(writer.take()).object();
+    }
+
+    static QJsonObject createFacet()
+    {
+        return QJsonObject{
+            {"index", QJsonObject{{"byteStart", 6}, {"byteEnd", 17}}},
+            {"features", QJsonArray{QJsonObject{{"$type", "app.bsky.richtext.facet#mention"}, {"did", "did:plc:alice"}}}}
+        };
+    }
+
+    static QJsonObject createRecord(int i)
+    {
+        return QJsonObject{
+            {"$type", "app.bsky.feed.post"},
+            {"text", QString::fromUtf8("Post %1 with \"quotes\", a newline\nand é\U0001F600").arg(i)},
+            {"createdAt", CREATED_AT},
+            {"facets", QJsonArray{createFacet()}},
+            {"langs", QJsonArray{"en", "nl"}},
+            {"reply", QJsonObject{
+                {"root", QJsonObject{{"uri", "at://did:plc:test/app.bsky.feed.post/root"}, {"cid", "bafyroot"}}},
+                {"parent", QJsonObject{{"uri", "at://did:plc:test/app.bsky.feed.post/parent"}, {"cid", "bafyparent"}}}
+            }},
+            {"embed", QJsonObject{
+                {"$type", "app.bsky.embed.external"},
+                {"external", QJsonObject{{"uri", "https://example.test"}, {"title", "Title"}, {"description", "Description"}}}
+            }},
+            {"labels", QJsonObject{
+                {"$type", "com.atproto.label.defs#selfLabels"},
+                {"values", QJsonArray{QJsonObject{{"val", "nudity"}}}}
+            }},
+            {"index", i}
+        };
+    }
+
+    static AppBskyFeed::Record::Post::SharedPtr createPost(int i)
+    {
+        return AppBskyFeed::Record::Post::fromJson(createRecord(i));
+    }
+
+    // Typed posts get written by the writer, raw JSON records are copied.
+    static ComATProtoRepo::ApplyWritesList createWrites(int count)
+    {
+        ComATProtoRepo::ApplyWritesList writes;
+
+        for (int i = 0; i < count; ++i)
+        {
+            switch (i % 3)
+            {
+            case 0:
+            {
+                auto create = std::make_shared<ComATProtoRepo::ApplyWritesCreate>();
+                create->mCollection = AppBskyFeed::Record::Post::TYPE;
+                create->mRKey = QString("rkey%1").arg(i);
+                create->mValue = createPost(i);
+                writes.push_back(create);
+                break;
+            }
+            case 1:
+            {
+                auto update = std::make_shared<ComATProtoRepo::ApplyWritesUpdate>();
+                update->mCollection = AppBskyFeed::Record::Post::TYPE;
+                update->mRKey = QString("rkey%1").arg(i);
+                update->mValue = i % 2 ? ComATProtoRepo::RecordValue(createPost(i)) : createRecord(i);
+                writes.push_back(update);
+                break;
+            }
+            default:
+            {
+                auto del = std::make_shared<ComATProtoRepo::ApplyWritesDelete>();
+                del->mCollection = "app.bsky.feed.like";
+                del->mRKey = QString("rkey%1").arg(i);
+                writes.push_back(del);
+                break;
+            }
+            }
+        }
+
+        return writes;
+    }
+
+    static QJsonObject toApplyWritesJson(const ComATProtoRepo::ApplyWritesList& writes)
+    {
+        QJsonArray writesArray;
+
+        for (const auto& write : writes)
+            std::visit([&writesArray](auto&& x){ writesArray.push_back(x->toJson()); }, write);
+
+        return QJsonObject{{"repo", REPO}, {"validate", true}, {"writes", writesArray}};
+    }
+
+    static QJsonObject createPostInteractionSettingsJson()
+    {
+        return QJsonObject{
+            {"$type", AppBskyActor::PostInteractionSettingsPref::TYPE},
+            {"threadgateAllowRules", QJsonArray{
+                QJsonObject{{"$type", "app.bsky.feed.threadgate#mentionRule"}},
+                QJsonObject{{"$type", "app.bsky.feed.threadgate#followerRule"}},
+                QJsonObject{{"$type", "app.bsky.feed.threadgate#followingRule"}},
+                QJsonObject{{"$type", "app.bsky.feed.threadgate#listRule"}, {"list", "at://did:plc:test/app.bsky.graph.list/list1"}}
+            }},
+            {"postgateEmbeddingRules", QJsonArray{QJsonObject{{"$type", "app.bsky.feed.postgate#disableRule"}}}}
+        };
+    }
+
+    static QJsonObject createPreferencesJson()
+    {
+        return QJsonObject{
+            {"preferences", QJsonArray{
+                QJsonObject{{"$type", "app.bsky.actor.defs#adultContentPref"}, {"enabled", true}, {"unknownField", "keep"}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#contentLabelPref"}, {"labelerDid", "did:plc:labeler"},
+                            {"label", "nsfw"}, {"visibility", "warn"}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#savedFeedsPref"},
+                            {"pinned", QJsonArray{"at://did:plc:test/app.bsky.feed.generator/a"}},
+                            {"saved", QJsonArray{"at://did:plc:test/app.bsky.feed.generator/a",
+                                                 "at://did:plc:test/app.bsky.feed.generator/b"}}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#savedFeedsPrefV2"}, {"items", QJsonArray{
+                    QJsonObject{{"id", "1"}, {"type", "timeline"}, {"value", "following"}, {"pinned", true}},
+                    QJsonObject{{"id", "2"}, {"type", "feed"}, {"value", "at://did:plc:test/app.bsky.feed.generator/a"},
+                                {"pinned", false}, {"unknownField", 1}}
+                }}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#personalDetailsPref"}, {"birthDate", "2000-01-31T00:00:00.000Z"}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#feedViewPref"}, {"feed", "home"}, {"hideReplies", true},
+                            {"hideRepliesByLikeCount", 2}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#threadViewPref"}, {"sort", "oldest"},
+                            {"prioritizeFollowedUsers", true}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#mutedWordsPref"}, {"items", QJsonArray{
+                    QJsonObject{{"value", "spoiler"}, {"targets", QJsonArray{"content", "tag"}}},
+                    QJsonObject{{"id", "w2"}, {"value", "word"}, {"targets", QJsonArray{"content"}},
+                                {"actorTarget", "exclude-following"}, {"expiresAt", "2027-01-01T00:00:00.000Z"}}
+                }}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#labelersPref"}, {"labelers", QJsonArray{
+                    QJsonObject{{"did", "did:plc:labeler"}}
+                }}},
+                createPostInteractionSettingsJson(),
+                QJsonObject{{"$type", "app.bsky.actor.defs#verificationPrefs"}, {"hideBadges", true}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#threadViewPref"}},
+                QJsonObject{{"$type", "app.bsky.actor.defs#futurePref"}, {"setting", QJsonArray{1, "two"}}}
+            }}
+        };
+    }
+};
@@ -0,0 +1,36 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <jwt.h>
+#include <QJsonDocument>
+#include <QTest>
+
+using namespace ATProto;
+
+class TestJwt : public QObject
+{
+    Q_OBJECT
+private slots:
+    void expiry()
+    {
+        const auto token = makeToken(R"({"scope":"com.atproto.access","sub":"did:plc:test","iat":1700000000,"exp":1700007200})");
+        QCOMPARE(Jwt::getPayload(token)["sub"].toString(), "did:plc:test");
+        QCOMPARE(Jwt::getExpiry(token), QDateTime::fromSecsSinceEpoch(1700007200));
+    }
+
+    void noExpiry()
+    {
+        QVERIFY(!Jwt::getExpiry(makeToken(R"({"sub":"did:plc:test"})")).isValid());
+        QVERIFY(!Jwt::getExpiry("opaque-token").isValid());
+        QVERIFY(!Jwt::getExpiry("a.!!!.c").isValid());
+        QVERIFY(!Jwt::getExpiry({}).isValid());
+    }
+
+private:
+    static QString makeToken(const QByteArray& payload)
+    {
+        static constexpr auto BASE64_URL = QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals;
+        const QByteArray header = R"({"alg":"ES256K","typ":"at+jwt"})";
+        return QString::fromLatin1(header.toBase64(BASE64_URL) + '.' + payload.toBase64(BASE64_URL) + ".c2ln");
+    }
+};
@@ -0,0 +1,105 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "post_view_fixture.h"
+#include <lexicon/app_bsky_feed.h>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTest>
+#include <thread>
+
+using namespace ATProto;
+
+class TestLazyPostView : public QObject
+{
+    Q_OBJECT
+private slots:
+    void decodeOnAccess()
+    {
+        const auto json = QJsonDocument::fromJson(PostViewFixture::makePost(0)).object();
+        const auto eager = AppBskyFeed::PostView::fromJson(json);
+        QVERIFY(!eager->isLazy());
+
+        AppBskyFeed::PostView::SharedPtr lazy;
+
+        {
+            const LazyDecodeScope scope(true);
+            lazy = AppBskyFeed::PostView::fromJson(json);
+        }
+
+        QVERIFY(lazy->isLazy());
+        QVERIFY(isNullVariant(lazy->mRecord));
+        QVERIFY(!lazy->mEmbed);
+        QCOMPARE(lazy->mLikeCount, 42);
+
+        const auto* post = std::get_if<AppBskyFeed::Record::Post::SharedPtr>(&lazy->getRecord());
+        QVERIFY(post && *post);
+        QVERIFY((*post)->mText.startsWith("Post number 0 "));
+
+        QVERIFY(lazy->getEmbed());
+        QVERIFY(holdsNonNull<AppBskyEmbed::RecordWithMediaView::SharedPtr>(*lazy->getEmbed()));
+        QCOMPARE(lazy->toJson(), eager->toJson());
+    }
+
+    void concurrentAccess()
+    {
+        AppBskyFeed::PostView::SharedPtr lazy;
+
+        {
+            const LazyDecodeScope scope(true);
+            lazy = AppBskyFeed::PostView::fromJson(QJsonDocument::fromJson(PostViewFixture::makePost(0)).object());
+        }
+
+        std::vector<const AppBskyFeed::PostView::RecordType*> records(THREAD_COUNT);
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < THREAD_COUNT; ++i)
+            threads.emplace_back([&lazy, &records, i]{ records[i] = &lazy->getRecord(); });
+
+        for (auto& thread : threads)
+            thread.join();
+
+        const auto& post = std::get<AppBskyFeed::Record::Post::SharedPtr>(lazy->getRecord());
+
+        for (const auto* record : records)
+            QCOMPARE(std::get<AppBskyFeed::Record::Post::SharedPtr>(*record), post);
+    }
+
+    void invalidRecord()
+    {
+        auto json = QJsonDocument::fromJson(PostViewFixture::makePost(0)).object();
+        json["record"] = QJsonObject{{ "$type", "app.bsky.feed.post" }}; // no text, no createdAt
+
+        const LazyDecodeScope scope(true);
+        const auto lazy = AppBskyFeed::PostView::fromJson(json);
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Field missing: \"text\""));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Invalid post record:"));
+        QVERIFY(isNullVariant(lazy->getRecord()));
+
+        // Only the first access decodes
+        QVERIFY(isNullVariant(lazy->getRecord()));
+    }
+
+    void benchmarkDecodeFeed_data()
+    {
+        QTest::addColumn<bool>("lazy");
+        QTest::newRow("eager") << false;
+        QTest::newRow("lazy") << true;
+    }
+
+    void benchmarkDecodeFeed()
+    {
+        QFETCH(bool, lazy);
+        const auto json = QJsonDocument::fromJson(PostViewFixture::makeFeed(FEED_SIZE));
+        const QJsonObject root = json.object();
+
+        QBENCHMARK {
+            const LazyDecodeScope scope(lazy);
+            AppBskyFeed::OutputFeed::fromJson(root);
+        }
+    }
+
+private:
+    static constexpr int THREAD_COUNT = 8;
+    static constexpr int FEED_SIZE = 100;
+};
@@ -0,0 +1,124 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "fake_network.h"
+#include <plc_directory_client.h>
+#include <QTest>
+
+using namespace ATProto;
+
+class TestPlcDirectoryClient : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init()
+    {
+        mNetwork = std::make_unique<FakeNetwork>();
+        mNetwork->setAutoDeleteReplies(true);
+    }
+
+    void cleanup()
+    {
+        mNetwork = nullptr;
+    }
+
+    void abortLoser()
+    {
+        PlcDirectoryClient client(mNetwork.get(), "primary.test", "secondary.test");
+        Result result;
+        getPds(client, "did:plc:abc", result);
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+
+        // The primary does not answer within the hedge delay.
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)2, TIMEOUT_MS);
+        QCOMPARE(mNetwork->mReplies[1]->url().host(), "secondary.test");
+
+        // The answer of the secondary aborts the request to the primary.
+        mNetwork->mReplies[1]->respond(200, DID_DOC);
+        QVERIFY(mNetwork->mReplies[0]->isAborted());
+        QCOMPARE(result.mPds, "https://pds.test");
+        QCOMPARE(result.mCalls, 1);
+
+        // An aborted request is not a failure of the host.
+        QTest::qWait(RateLimiter::BASE_BACKOFF.count() * 2);
+        QCOMPARE(mNetwork->mReplies.size(), (size_t)2);
+        QCOMPARE(result.mCalls, 1);
+        QCOMPARE(client.getHostHealth(0).getConsecutiveFailures(), 0);
+        QCOMPARE(client.getHostHealth(1).getConsecutiveFailures(), 0);
+    }
+
+    void tooManyRequestsIsFailure()
+    {
+        PlcDirectoryClient client(mNetwork.get(), "primary.test", "");
+        Result result;
+        getPds(client, "did:plc:abc", result);
+
+        // The request gets resent till the maximum resends.
+        for (size_t i = 1; i <= 3; ++i)
+        {
+            QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), i, TIMEOUT_MS);
+            mNetwork->mReplies[i - 1]->respond(429, R"({"message":"Rate limit exceeded"})");
+        }
+
+        QTRY_COMPARE_WITH_TIMEOUT(result.mCalls, 1, TIMEOUT_MS);
+        QVERIFY(result.mPds.isNull());
+        QCOMPARE(client.getHostHealth(0).getConsecutiveFailures(), 1);
+    }
+
+    void serverErrorIsFailure()
+    {
+        PlcDirectoryClient client(mNetwork.get(), "primary.test", "");
+
+        for (int i = 1; i <= HostHealth::FAILURE_THRESHOLD; ++i)
+        {
+            Result result;
+            getPds(client, "did:plc:abc", result);
+            QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)i, TIMEOUT_MS);
+            mNetwork->mReplies.back()->respond(502, R"({"message":"Bad gateway"})");
+            QCOMPARE(result.mCalls, 1);
+            QCOMPARE(client.getHostHealth(0).getConsecutiveFailures(), i);
+        }
+
+        QCOMPARE(client.getHostHealth(0).getState(), HostHealth::State::OPEN);
+    }
+
+    void notFoundIsAnswer()
+    {
+        PlcDirectoryClient client(mNetwork.get(), "primary.test", "");
+        Result result;
+        getPds(client, "did:plc:abc", result);
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+        mNetwork->mReplies[0]->respond(404, R"({"message":"DID not registered"})");
+        QCOMPARE(result.mCalls, 1);
+        QCOMPARE(client.getHostHealth(0).getConsecutiveFailures(), 0);
+    }
+
+private:
+    static constexpr int TIMEOUT_MS = 5000;
+    static constexpr char const* DID_DOC = R"({
+        "id": "did:plc:abc",
+        "service": [{
+            "id": "#atproto_pds",
+            "type": "AtprotoPersonalDataServer",
+            "serviceEndpoint": "https://pds.test"
+        }]
+    })";
+
+    struct Result
+    {
+        int mCalls = 0;
+        QString mPds;
+    };
+
+    static void getPds(PlcDirectoryClient& client, const QString& did, Result& result)
+    {
+        client.getPds(did,
+            [&result](const QString& pds){
+                ++result.mCalls;
+                result.mPds = pds;
+            },
+            [&result](int, const QString&){ ++result.mCalls; });
+    }
+
+    std::unique_ptr<FakeNetwork> mNetwork;
+};
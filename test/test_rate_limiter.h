@@ -0,0 +1,185 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <rate_limiter.h>
+#include <QTest>
+
+using namespace ATProto;
+using namespace std::chrono_literals;
+
+class TestRateLimiter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void unknownEndpoint()
+    {
+        RateLimiter limiter;
+        QCOMPARE(limiter.acquire(URL), 0ms);
+        QVERIFY(limiter.getStates().isEmpty());
+    }
+
+    void refill()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        limiter.update(URL, makeHeaders(10, 0, 10), now); // 1 token per second
+
+        QCOMPARE(limiter.acquire(URL, now.addSecs(5)), 0ms);
+        QCOMPARE(getTokens(limiter), 4.0);
+
+        // Tokens never exceed the limit.
+        QCOMPARE(limiter.acquire(URL, now.addSecs(100)), 0ms);
+        QCOMPARE(getTokens(limiter), 9.0);
+    }
+
+    void refillAtReset()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        RateLimitHeaders headers;
+        headers.mLimit = 10;
+        headers.mRemaining = 0;
+        headers.mReset = now.addSecs(100);
+        limiter.update(URL, headers, now);
+
+        // Without a policy window the limit refills till the reset.
+        QCOMPARE(getState(limiter).mRefillPerSec, 0.1);
+
+        headers.mWindowSecs = 10000;
+        limiter.update(URL, headers, now);
+        QCOMPARE(getState(limiter).mRefillPerSec, 0.001);
+
+        // The reset bounds the wait.
+        QCOMPARE(limiter.acquire(URL, now.addSecs(90)), 10000ms);
+
+        // At the reset the full limit is added.
+        QCOMPARE(limiter.acquire(URL, now.addSecs(100)), 0ms);
+        QVERIFY(getTokens(limiter) > 8.0);
+    }
+
+    void debt()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        limiter.update(URL, makeHeaders(10, 1, 10), now);
+
+        QCOMPARE(limiter.acquire(URL, now), 0ms);
+        QCOMPARE(limiter.acquire(URL, now), 1000ms);
+        QCOMPARE(limiter.acquire(URL, now), 2000ms);
+        QCOMPARE(getTokens(limiter), -2.0);
+
+        // The debt gets paid off by the refill.
+        QCOMPARE(limiter.acquire(URL, now.addSecs(2)), 1000ms);
+        QCOMPARE(getTokens(limiter), -1.0);
+    }
+
+    void headerSyncKeepsDebt()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        limiter.update(URL, makeHeaders(10, 1, 10), now);
+
+        for (int i = 0; i < 3; ++i)
+            limiter.acquire(URL, now);
+
+        QCOMPARE(getTokens(limiter), -2.0);
+
+        // The server did not see the waiting requests yet.
+        limiter.update(URL, makeHeaders(10, 5, 10), now);
+        QCOMPARE(getTokens(limiter), -2.0);
+        QCOMPARE(limiter.acquire(URL, now), 3000ms);
+    }
+
+    void headerSyncLowersTokens()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        limiter.update(URL, makeHeaders(10, 10, 10), now);
+        QCOMPARE(getTokens(limiter), 10.0);
+
+        // Other clients of the same account use the same budget.
+        limiter.update(URL, makeHeaders(10, 2, 10), now.addSecs(1));
+        QCOMPARE(getTokens(limiter), 2.0);
+
+        // A remaining count above the limit gets clamped.
+        limiter.update(OTHER_URL, makeHeaders(10, 20, 10), now);
+        QCOMPARE(limiter.getStates()[bucketKey(OTHER_URL)].mTokens, 10.0);
+    }
+
+    void endpointBuckets()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        limiter.update(URL, makeHeaders(10, 0, 10), now);
+
+        QCOMPARE(limiter.acquire(URL, now), 1000ms);
+        QCOMPARE(limiter.acquire(OTHER_URL, now), 0ms);
+    }
+
+    void retryAfterBlocksHost()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        RateLimitHeaders headers;
+        headers.mHttpStatus = 429;
+        headers.mRetryAfter = now.addSecs(3);
+        limiter.update(URL, headers, now);
+
+        QCOMPARE(limiter.acquire(OTHER_URL, now), 3000ms);
+        QCOMPARE(limiter.acquire(URL, now.addSecs(1)), 2000ms);
+        QCOMPARE(limiter.acquire(URL, now.addSecs(3)), 0ms);
+        QCOMPARE(limiter.acquire(QUrl("https://other.host/xrpc/com.atproto.repo.createRecord"), now), 0ms);
+    }
+
+    void tooManyRequestsWithoutRetryAfter()
+    {
+        RateLimiter limiter;
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        RateLimitHeaders headers;
+        headers.mHttpStatus = 429;
+        limiter.update(URL, headers, now);
+        QCOMPARE(limiter.acquire(URL, now), RateLimiter::BASE_BACKOFF);
+
+        // Wait till the reset, capped by the max delay.
+        headers.mReset = now.addSecs(3600);
+        limiter.update(URL, headers, now);
+        QCOMPARE(limiter.acquire(URL, now), std::chrono::milliseconds(RateLimiter::MAX_DELAY));
+    }
+
+    void backoffDelay()
+    {
+        for (int retry = 1; retry < 20; ++retry)
+        {
+            const auto cap = std::min(RateLimiter::BASE_BACKOFF * (1 << std::min(retry - 1, 16)),
+                                      std::chrono::milliseconds(RateLimiter::MAX_BACKOFF));
+            const auto delay = RateLimiter::backoffDelay(retry);
+            QVERIFY(delay >= cap / 2);
+            QVERIFY(delay <= cap);
+        }
+    }
+
+private:
+    static RateLimitHeaders makeHeaders(int limit, int remaining, int windowSecs)
+    {
+        RateLimitHeaders headers;
+        headers.mHttpStatus = 200;
+        headers.mLimit = limit;
+        headers.mRemaining = remaining;
+        headers.mWindowSecs = windowSecs;
+        return headers;
+    }
+
+    static QString bucketKey(const QUrl& url) { return url.host() + url.path(); }
+
+    static RateLimiter::BucketState getState(const RateLimiter& limiter)
+    {
+        const auto states = limiter.getStates();
+        Q_ASSERT(states.contains(bucketKey(URL)));
+        return states[bucketKey(URL)];
+    }
+
+    static double getTokens(const RateLimiter& limiter) { return getState(limiter).mTokens; }
+
+    static inline const QUrl URL{"https://pds.test/xrpc/com.atproto.repo.createRecord"};
+    static inline const QUrl OTHER_URL{"https://pds.test/xrpc/com.atproto.server.createSession"};
+};
@@ -0,0 +1,180 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "fake_network.h"
+#include <xrpc_network_thread.h>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace Xrpc;
+
+// Deadlines of requests that wait on other requests: coalesced GETs and requests
+// parked for a token refresh.
+class TestRequestDeadline : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init()
+    {
+        mNetwork = std::make_unique<FakeNetwork>();
+        mDecodePool = std::make_unique<DecodePool>(1);
+        mScheduler = std::make_unique<RequestScheduler>();
+        mMetrics = std::make_unique<Metrics>();
+        mTlsSessionStore = std::make_unique<TlsSessionStore>();
+        mThread = std::make_unique<NetworkThread>(mNetwork.get(), *mDecodePool, *mScheduler, *mMetrics, *mTlsSessionStore,
+                                                  nullptr, nullptr, TIMEOUT_MS, {});
+        mThread->setPDS("https://pds.test");
+
+        connect(mThread.get(), &NetworkThread::requestSuccessJson, this,
+                [](QJsonDocument json, NetworkThread::SuccessJsonCb cb){ cb(json); });
+        connect(mThread.get(), &NetworkThread::requestError, this,
+                [](QString error, QJsonDocument json, NetworkThread::ErrorCb cb){ cb(error, json); });
+    }
+
+    void cleanup()
+    {
+        mThread = nullptr;
+        mTlsSessionStore = nullptr;
+        mMetrics = nullptr;
+        mScheduler = nullptr;
+        mDecodePool = nullptr;
+        mNetwork = nullptr;
+    }
+
+    void joinerDeadline()
+    {
+        Outcome first;
+        Outcome joiner;
+        get("test.get", first, QDeadlineTimer(QDeadlineTimer::Forever));
+        get("test.get", joiner, QDeadlineTimer(DEADLINE_MS));
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+
+        // Only the joiner fails, the shared request continues.
+        QTRY_COMPARE_WITH_TIMEOUT(joiner.mError, ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, TIMEOUT_MS);
+        QVERIFY(!first.mDone);
+        QVERIFY(!mNetwork->mReplies[0]->isAborted());
+
+        mNetwork->mReplies[0]->respond(200, R"({"ok":true})");
+        QTRY_VERIFY_WITH_TIMEOUT(first.mDone, TIMEOUT_MS);
+        QVERIFY(first.mError.isNull());
+        QCOMPARE(first.mJson.object().value("ok").toBool(), true);
+        QCOMPARE(joiner.mCalls, 1);
+        QCOMPARE(mNetwork->mReplies.size(), (size_t)1);
+    }
+
+    void firstDeadline()
+    {
+        Outcome first;
+        Outcome joiner;
+        get("test.get", first, QDeadlineTimer(DEADLINE_MS));
+        get("test.get", joiner, QDeadlineTimer(QDeadlineTimer::Forever));
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+
+        // The deadline of the first request does not end the request of the joiner.
+        QTRY_COMPARE_WITH_TIMEOUT(first.mError, ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, TIMEOUT_MS);
+        QVERIFY(!joiner.mDone);
+        QVERIFY(!mNetwork->mReplies[0]->isAborted());
+
+        mNetwork->mReplies[0]->respond(200, R"({"ok":true})");
+        QTRY_VERIFY_WITH_TIMEOUT(joiner.mDone, TIMEOUT_MS);
+        QVERIFY(joiner.mError.isNull());
+        QCOMPARE(first.mCalls, 1);
+    }
+
+    void allDeadlinesPassed()
+    {
+        Outcome first;
+        Outcome joiner;
+        get("test.get", first, QDeadlineTimer(DEADLINE_MS));
+        get("test.get", joiner, QDeadlineTimer(DEADLINE_MS * 2));
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+
+        QTRY_COMPARE_WITH_TIMEOUT(first.mError, ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, TIMEOUT_MS);
+        QVERIFY(!mNetwork->mReplies[0]->isAborted());
+
+        // Without waiters the request gets aborted.
+        QTRY_COMPARE_WITH_TIMEOUT(joiner.mError, ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, TIMEOUT_MS);
+        QTRY_VERIFY_WITH_TIMEOUT(mNetwork->mReplies[0]->isAborted(), TIMEOUT_MS);
+        QCOMPARE(first.mCalls, 1);
+        QCOMPARE(joiner.mCalls, 1);
+    }
+
+    void parkedDeadline()
+    {
+        mThread->enableTokenRefresh(true);
+        QSignalSpy refreshSpy(mThread.get(), &NetworkThread::tokenRefreshNeeded);
+
+        // The first request fails on an expired token, which starts a token refresh.
+        Outcome expired;
+        post("test.expired", expired, QDeadlineTimer(QDeadlineTimer::Forever));
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)1, TIMEOUT_MS);
+        mNetwork->mReplies[0]->respond(400, R"({"error":"ExpiredToken","message":"Token has expired"})");
+        QTRY_COMPARE_WITH_TIMEOUT(refreshSpy.count(), 1, TIMEOUT_MS);
+
+        // Requests with the old token wait for the refresh, but not beyond their deadline.
+        Outcome parked;
+        post("test.parked", parked, QDeadlineTimer(DEADLINE_MS));
+        QTRY_COMPARE_WITH_TIMEOUT(parked.mError, ATProto::ATProtoErrorMsg::XRPC_TIMEOUT, TIMEOUT_MS);
+        QVERIFY(!expired.mDone);
+
+        // The expired request is not sent after the refresh.
+        mThread->finishTokenRefresh("new-token");
+        QTRY_COMPARE_WITH_TIMEOUT(mNetwork->mReplies.size(), (size_t)2, TIMEOUT_MS);
+        QCOMPARE(mNetwork->mReplies[1]->url().path(), "/xrpc/test.expired");
+        QTest::qWait(DEADLINE_MS);
+        QCOMPARE(mNetwork->mReplies.size(), (size_t)2);
+        QCOMPARE(parked.mCalls, 1);
+    }
+
+private:
+    static constexpr int DEADLINE_MS = 100;
+    static constexpr int TIMEOUT_MS = 5000;
+    static constexpr char const* ACCESS_JWT = "access-token";
+
+    struct Outcome
+    {
+        bool mDone = false;
+        int mCalls = 0;
+        QJsonDocument mJson;
+        QString mError;
+    };
+
+    NetworkThread::SuccessJsonCb successCb(Outcome& outcome)
+    {
+        return [&outcome](const QJsonDocument& json){
+            outcome.mDone = true;
+            ++outcome.mCalls;
+            outcome.mJson = json;
+        };
+    }
+
+    NetworkThread::ErrorCb errorCb(Outcome& outcome)
+    {
+        return [&outcome](const QString& error, const QJsonDocument& json){
+            outcome.mDone = true;
+            ++outcome.mCalls;
+            outcome.mError = error;
+            outcome.mJson = json;
+        };
+    }
+
+    void get(const QString& service, Outcome& outcome, const QDeadlineTimer& deadline)
+    {
+        mThread->get(service, {}, {}, successCb(outcome), errorCb(outcome), ACCESS_JWT, false, {},
+                     RequestHandle::create(), RequestPriority::NORMAL, deadline);
+    }
+
+    void post(const QString& service, Outcome& outcome, const QDeadlineTimer& deadline)
+    {
+        mThread->postJson(service, QJsonDocument(QJsonObject{}), {}, successCb(outcome), errorCb(outcome), ACCESS_JWT, false,
+                          RequestHandle::create(), RequestPriority::NORMAL, deadline);
+    }
+
+    std::unique_ptr<FakeNetwork> mNetwork;
+    std::unique_ptr<DecodePool> mDecodePool;
+    std::unique_ptr<RequestScheduler> mScheduler;
+    std::unique_ptr<Metrics> mMetrics;
+    std::unique_ptr<TlsSessionStore> mTlsSessionStore;
+    std::unique_ptr<NetworkThread> mThread;
+};
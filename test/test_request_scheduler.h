@@ -0,0 +1,235 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <xrpc_request_scheduler.h>
+#include <QTest>
+#include <QTimer>
+#include <optional>
+#include <vector>
+
+using namespace Xrpc;
+
+class TestRequestScheduler : public QObject
+{
+    Q_OBJECT
+private slots:
+    void perHostCap()
+    {
+        RequestScheduler scheduler(10, 2);
+        int started = 0;
+
+        for (int i = 0; i < 5; ++i)
+            scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&started](RequestPriority){ ++started; return true; });
+
+        QCOMPARE(started, 2);
+        QCOMPARE(scheduler.getInFlightCount("a.test"), 2);
+        QCOMPARE(scheduler.getQueuedCount(), 3);
+
+        // Another host is not blocked by the cap of the first host.
+        scheduler.submit(this, "b.test", RequestPriority::NORMAL, {}, [&started](RequestPriority){ ++started; return true; });
+        QCOMPARE(started, 3);
+
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QCOMPARE(started, 4);
+        QCOMPARE(scheduler.getInFlightCount("a.test"), 2);
+        QCOMPARE(scheduler.getQueuedCount(), 2);
+    }
+
+    void priorityOrder()
+    {
+        RequestScheduler scheduler(1, 1);
+        QStringList order;
+        auto submit = [&](const QString& name, RequestPriority priority){
+            scheduler.submit(this, "a.test", priority, {}, [&order, name](RequestPriority){ order.push_back(name); return true; });
+        };
+
+        submit("first", RequestPriority::BACKGROUND);
+        submit("background", RequestPriority::BACKGROUND);
+        submit("normal", RequestPriority::NORMAL);
+        submit("interactive", RequestPriority::INTERACTIVE);
+
+        scheduler.finished("a.test", RequestPriority::BACKGROUND);
+        scheduler.finished("a.test", RequestPriority::INTERACTIVE);
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+
+        QCOMPARE(order, QStringList({"first", "interactive", "normal", "background"}));
+    }
+
+    void fairAcrossHosts()
+    {
+        RequestScheduler scheduler(1, 1);
+        QStringList order;
+
+        for (const QString host : {"a.test", "a.test", "a.test", "b.test", "b.test", "c.test"})
+            scheduler.submit(this, host, RequestPriority::NORMAL, {}, [&order, host](RequestPriority){ order.push_back(host); return true; });
+
+        while (order.size() < 6)
+            scheduler.finished(order.back(), RequestPriority::NORMAL);
+
+        QCOMPARE(order, QStringList({"a.test", "a.test", "b.test", "c.test", "a.test", "b.test"}));
+    }
+
+    void backgroundLeavesRoom()
+    {
+        RequestScheduler scheduler(4, 4);
+        int background = 0;
+        int normal = 0;
+
+        for (int i = 0; i < 4; ++i)
+            scheduler.submit(this, "a.test", RequestPriority::BACKGROUND, {}, [&background](RequestPriority){ ++background; return true; });
+
+        QCOMPARE(background, 2);
+
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&normal](RequestPriority){ ++normal; return true; });
+        QCOMPARE(normal, 1);
+    }
+
+    void cancelledRequestSkipped()
+    {
+        RequestScheduler scheduler(1, 1);
+        QStringList order;
+        auto handle = RequestHandle::create();
+
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&order](RequestPriority){ order.push_back("first"); return true; });
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, handle, [&order](RequestPriority){ order.push_back("cancelled"); return true; });
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&order](RequestPriority){ order.push_back("last"); return true; });
+
+        handle.cancel();
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QCOMPARE(order, QStringList({"first", "last"}));
+    }
+
+    void raisePriority()
+    {
+        RequestScheduler scheduler(1, 1);
+        QStringList order;
+        auto handle = RequestHandle::create();
+
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&order](RequestPriority){ order.push_back("first"); return true; });
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&order](RequestPriority){ order.push_back("normal"); return true; });
+        scheduler.submit(this, "a.test", RequestPriority::BACKGROUND, handle, [&order](RequestPriority){ order.push_back("raised"); return true; });
+
+        scheduler.raisePriority(handle, RequestPriority::INTERACTIVE);
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QCOMPARE(order, QStringList({"first", "raised"}));
+    }
+
+    void removeQueued()
+    {
+        RequestScheduler scheduler(1, 1);
+        int otherOwner = 0;
+        int started = 0;
+
+        scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [&started](RequestPriority){ ++started; return true; });
+        scheduler.submit(&otherOwner, "a.test", RequestPriority::NORMAL, {}, [&started](RequestPriority){ ++started; return true; });
+        QVERIFY(scheduler.hasQueued(&otherOwner));
+        QVERIFY(!scheduler.hasQueued(this)); // started right away
+        scheduler.removeQueued(&otherOwner);
+        QCOMPARE(scheduler.getQueuedCount(), 0);
+        QVERIFY(!scheduler.hasQueued(&otherOwner));
+
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QCOMPARE(started, 1);
+        QCOMPARE(scheduler.getInFlightCount(), 0);
+    }
+
+    // A BACKGROUND request raised while queued is counted as INTERACTIVE when it
+    // starts. Finishing it must not free a background slot it never took.
+    void raisedBackgroundKeepsBackgroundCap()
+    {
+        RequestScheduler scheduler(4, 4); // at most 2 background requests
+        auto handle = RequestHandle::create();
+        std::optional<RequestPriority> raisedPriority;
+        int background = 0;
+
+        scheduler.submit(this, "a.test", RequestPriority::BACKGROUND, {}, [&background](RequestPriority){ ++background; return true; });
+
+        for (int i = 0; i < 3; ++i)
+            scheduler.submit(this, "a.test", RequestPriority::NORMAL, {}, [](RequestPriority){ return true; });
+
+        scheduler.submit(this, "a.test", RequestPriority::BACKGROUND, handle,
+                         [&raisedPriority](RequestPriority priority){ raisedPriority = priority; return true; });
+        QCOMPARE(scheduler.getQueuedCount(), 1);
+
+        scheduler.raisePriority(handle, RequestPriority::INTERACTIVE);
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QVERIFY(raisedPriority);
+        QCOMPARE(*raisedPriority, RequestPriority::INTERACTIVE);
+
+        scheduler.finished("a.test", *raisedPriority);
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        scheduler.finished("a.test", RequestPriority::NORMAL);
+        QCOMPARE(scheduler.getInFlightCount(), 1);
+
+        // One background request is still in flight, so only one more may start.
+        for (int i = 0; i < 3; ++i)
+            scheduler.submit(this, "a.test", RequestPriority::BACKGROUND, {}, [&background](RequestPriority){ ++background; return true; });
+
+        QCOMPARE(background, 2);
+        QCOMPARE(scheduler.getInFlightCount(), 2);
+        QCOMPARE(scheduler.getQueuedCount(), 2);
+    }
+
+    // Simulated network: every request takes REQUEST_MS. A load of normal and background
+    // requests keeps all slots busy while interactive requests come in. An interactive
+    // request must be the next request to start after it is submitted, whereas in
+    // arrival order it would wait for the whole backlog.
+    void interactiveQueueDelayUnderLoad()
+    {
+        constexpr int REQUEST_MS = 10;
+        constexpr int LOAD_COUNT = 200;
+        constexpr int INTERACTIVE_COUNT = 10;
+        constexpr int MAX_IN_FLIGHT = 4;
+
+        RequestScheduler scheduler(MAX_IN_FLIGHT, MAX_IN_FLIGHT);
+        int done = 0;
+        int startCount = 0;
+        std::vector<std::pair<int, int>> interactiveStarts; // start count at submit, start index
+
+        auto submit = [&](const QString& host, RequestPriority priority){
+            const int submitCount = startCount;
+            scheduler.submit(this, host, priority, {},
+                [&scheduler, &done, &startCount, &interactiveStarts, host, submitCount](RequestPriority startPriority){
+                    if (startPriority == RequestPriority::INTERACTIVE)
+                        interactiveStarts.push_back({ submitCount, startCount });
+
+                    ++startCount;
+
+                    QTimer::singleShot(REQUEST_MS, Qt::PreciseTimer, [&scheduler, &done, host, startPriority]{
+                        ++done;
+                        scheduler.finished(host, startPriority);
+                    });
+                    return true;
+                });
+        };
+
+        for (int i = 0; i < LOAD_COUNT; ++i)
+        {
+            submit("pds.test", RequestPriority::NORMAL);
+            submit("video.test", RequestPriority::BACKGROUND);
+        }
+
+        for (int i = 0; i < INTERACTIVE_COUNT; ++i)
+        {
+            QTimer::singleShot(i * 5 * REQUEST_MS, Qt::PreciseTimer, this,
+                [&submit]{ submit("pds.test", RequestPriority::INTERACTIVE); });
+        }
+
+        constexpr int TOTAL = 2 * LOAD_COUNT + INTERACTIVE_COUNT;
+        QTRY_COMPARE_WITH_TIMEOUT(done, TOTAL, TOTAL * REQUEST_MS * 10);
+
+        const auto& interactive = scheduler.getStats(RequestPriority::INTERACTIVE);
+        const auto& normal = scheduler.getStats(RequestPriority::NORMAL);
+        const auto& background = scheduler.getStats(RequestPriority::BACKGROUND);
+        qInfo() << "Queue delay interactive mean:" << interactive.getMeanQueueDelayMs() << "ms max:" << interactive.mMaxQueueDelayMs << "ms";
+        qInfo() << "Queue delay normal mean:" << normal.getMeanQueueDelayMs() << "ms max:" << normal.mMaxQueueDelayMs << "ms";
+        qInfo() << "Queue delay background mean:" << background.getMeanQueueDelayMs() << "ms max:" << background.mMaxQueueDelayMs << "ms";
+
+        QCOMPARE(interactive.mStarted, INTERACTIVE_COUNT);
+        QCOMPARE((int)interactiveStarts.size(), INTERACTIVE_COUNT);
+
+        // No queued normal or background request started before an interactive one.
+        for (const auto& [submitCount, startIndex] : interactiveStarts)
+            QCOMPARE(startIndex, submitCount);
+    }
+};
@@ -0,0 +1,149 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <xrpc_response_cache.h>
+#include <QTest>
+
+using namespace Xrpc;
+using namespace std::chrono_literals;
+
+class TestResponseCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void freshStaleExpired()
+    {
+        ResponseCache cache;
+        cache.setPolicy(NSID, { 60s, 5min, 8, 1024 });
+        const auto t0 = ResponseCache::Clock::now();
+        cache.insert(NSID, "key", "data", "application/json", t0);
+
+        auto lookup = cache.find(NSID, "key", t0 + 59s);
+        QVERIFY(lookup);
+        QCOMPARE(lookup->mFreshness, ResponseCache::Freshness::FRESH);
+        QCOMPARE(lookup->mData, QByteArray("data"));
+        QCOMPARE(lookup->mContentType, QString("application/json"));
+
+        lookup = cache.find(NSID, "key", t0 + 60s);
+        QVERIFY(lookup);
+        QCOMPARE(lookup->mFreshness, ResponseCache::Freshness::STALE);
+
+        lookup = cache.find(NSID, "key", t0 + 6min - 1s);
+        QVERIFY(lookup);
+        QCOMPARE(lookup->mFreshness, ResponseCache::Freshness::STALE);
+
+        QVERIFY(!cache.find(NSID, "key", t0 + 6min));
+
+        // The expired entry got removed.
+        QVERIFY(!cache.find(NSID, "key", t0));
+    }
+
+    void noStale()
+    {
+        ResponseCache cache;
+        cache.setPolicy(NSID, { 60s, 0s, 8, 1024 });
+        const auto t0 = ResponseCache::Clock::now();
+        cache.insert(NSID, "key", "data", "application/json", t0);
+        QVERIFY(!cache.find(NSID, "key", t0 + 60s));
+    }
+
+    void refreshResetsAge()
+    {
+        ResponseCache cache;
+        cache.setPolicy(NSID, { 60s, 0s, 8, 1024 });
+        const auto t0 = ResponseCache::Clock::now();
+        cache.insert(NSID, "key", "old", "application/json", t0);
+        cache.insert(NSID, "key", "new", "application/json", t0 + 50s);
+
+        const auto lookup = cache.find(NSID, "key", t0 + 100s);
+        QVERIFY(lookup);
+        QCOMPARE(lookup->mData, QByteArray("new"));
+        QCOMPARE(lookup->mFreshness, ResponseCache::Freshness::FRESH);
+    }
+
+    void evictByEntries()
+    {
+        ResponseCache cache;
+        cache.setPolicy(NSID, { 60s, 0s, 2, 1024 });
+
+        for (const char* key : { "a", "b", "c" })
+            cache.insert(NSID, key, "x", "application/json");
+
+        int present = 0;
+
+        for (const char* key : { "a", "b", "c" })
+            present += cache.find(NSID, key) ? 1 : 0;
+
+        QCOMPARE(present, 2);
+        QVERIFY(cache.find(NSID, "c"));
+    }
+
+    void evictByBytes()
+    {
+        ResponseCache cache;
+        cache.setPolicy(NSID, { 60s, 0s, 100, 1000 });
+        cache.insert(NSID, "a", QByteArray(600, 'a'), "application/json");
+        cache.insert(NSID, "b", QByteArray(600, 'b'), "application/json");
+
+        QVERIFY(!cache.find(NSID, "a"));
+        QVERIFY(cache.find(NSID, "b"));
+
+        // A reply larger than the budget is not cached and drops the older entry for its key.
+        cache.insert(NSID, "b", QByteArray(1001, 'b'), "application/json");
+        QVERIFY(!cache.find(NSID, "b"));
+    }
+
+    void noPolicy()
+    {
+        ResponseCache cache;
+        cache.insert(NSID, "key", "data", "application/json");
+        QVERIFY(!cache.hasPolicy(NSID));
+        QVERIFY(!cache.find(NSID, "key"));
+
+        cache.setPolicy(NSID, {});
+        cache.insert(NSID, "key", "data", "application/json");
+        QVERIFY(!cache.find("other.nsid", "key"));
+
+        cache.clear();
+        QVERIFY(!cache.find(NSID, "key"));
+        QVERIFY(cache.hasPolicy(NSID));
+    }
+
+    void keyByAuth()
+    {
+        const QUrl url("https://pds.test/xrpc/app.bsky.actor.getProfiles?actors=did:plc:a");
+        const QString anonymous = ResponseCache::makeKey(url, {}, {}, false);
+        const QString session = ResponseCache::makeKey(url, {}, "jwt-1", false);
+        const QString serviceA = ResponseCache::makeKey(url, {}, "service-jwt-a", true);
+        const QString serviceB = ResponseCache::makeKey(url, {}, "service-jwt-b", true);
+
+        QVERIFY(anonymous != session);
+        QVERIFY(session != serviceA);
+        QVERIFY(serviceA != serviceB);
+
+        // All session tokens of a client belong to the same account.
+        QCOMPARE(ResponseCache::makeKey(url, {}, "jwt-2", false), session);
+
+        ResponseCache cache;
+        cache.setPolicy(NSID, {});
+        cache.insert(NSID, session, "session", "application/json");
+        QVERIFY(!cache.find(NSID, anonymous));
+        QVERIFY(!cache.find(NSID, serviceA));
+        QCOMPARE(cache.find(NSID, session)->mData, QByteArray("session"));
+    }
+
+    void keyByHeaders()
+    {
+        const QUrl url("https://pds.test/xrpc/app.bsky.actor.getProfiles");
+        const ResponseCache::Params labelers{{"atproto-accept-labelers", "did:plc:l1"}, {"atproto-proxy", "did:web:api.bsky.app#bsky_appview"}};
+        const ResponseCache::Params reversed{{"Atproto-Proxy", "did:web:api.bsky.app#bsky_appview"}, {"atproto-accept-labelers", "did:plc:l1"}};
+        const ResponseCache::Params other{{"atproto-accept-labelers", "did:plc:l2"}, {"atproto-proxy", "did:web:api.bsky.app#bsky_appview"}};
+
+        QCOMPARE(ResponseCache::makeKey(url, labelers, "jwt", false), ResponseCache::makeKey(url, reversed, "jwt", false));
+        QVERIFY(ResponseCache::makeKey(url, labelers, "jwt", false) != ResponseCache::makeKey(url, other, "jwt", false));
+        QVERIFY(ResponseCache::makeKey(url, labelers, "jwt", false) != ResponseCache::makeKey(url, {}, "jwt", false));
+    }
+
+private:
+    static constexpr char const* NSID = "app.bsky.actor.getProfiles";
+};
@@ -0,0 +1,95 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <service_auth_cache.h>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+using namespace ATProto;
+
+class TestServiceAuthCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void mergeFetches()
+    {
+        ServiceAuthCache cache;
+        QStringList tokens;
+        auto tokenCb = [&tokens](const QString& token){ tokens.push_back(token); };
+        auto cancelled = Xrpc::RequestHandle::create();
+        cancelled.cancel();
+
+        QVERIFY(cache.get(AUD, LXM).isEmpty());
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), tokenCb, {}));
+        QVERIFY(!cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), tokenCb, {}));
+        QVERIFY(!cache.wait(AUD, LXM, cancelled, tokenCb, {}));
+
+        // Another method is another token
+        QVERIFY(cache.wait(AUD, "app.bsky.video.getUploadLimits", Xrpc::RequestHandle::create(), tokenCb, {}));
+        QCOMPARE(cache.getFetchCount(), 2);
+
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        const QString token = makeToken(now.addSecs(30 * 60));
+        cache.fetched(AUD, LXM, token, now.addSecs(60));
+        QCOMPARE(tokens, QStringList({ token, token }));
+        QCOMPARE(cache.get(AUD, LXM, now), token);
+
+        // The margin is taken from the exp claim, not the requested expiry.
+        QCOMPARE(cache.get(AUD, LXM, now.addSecs(24 * 60)), token);
+        QVERIFY(cache.get(AUD, LXM, now.addSecs(25 * 60)).isEmpty());
+
+        // After the fetch a new wait fetches again.
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), tokenCb, {}));
+    }
+
+    void failure()
+    {
+        ServiceAuthCache cache;
+        int errorCount = 0;
+        auto errorCb = [&errorCount](const QString& error, const QString&){
+            QCOMPARE(error, "AuthRequired");
+            ++errorCount;
+        };
+
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), {}, errorCb));
+        QVERIFY(!cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), {}, errorCb));
+        cache.failed(AUD, LXM, "AuthRequired", "no session");
+        QCOMPARE(errorCount, 2);
+        QCOMPARE(cache.size(), 0);
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), {}, errorCb));
+    }
+
+    void clearDuringFetch()
+    {
+        ServiceAuthCache cache;
+        QString received;
+        const QDateTime expiry = QDateTime::currentDateTimeUtc().addSecs(30 * 60);
+
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(),
+                           [&received](const QString& token){ received = token; }, {}));
+        cache.clear();
+
+        // Token without an exp claim for the previous session.
+        cache.fetched(AUD, LXM, "opaque", expiry);
+        QCOMPARE(received, "opaque");
+        QCOMPARE(cache.size(), 0);
+
+        QVERIFY(cache.wait(AUD, LXM, Xrpc::RequestHandle::create(), {}, {}));
+        cache.fetched(AUD, LXM, "opaque", expiry);
+        QCOMPARE(cache.get(AUD, LXM), "opaque");
+    }
+
+private:
+    static constexpr char const* AUD = "did:web:pds.example";
+    static constexpr char const* LXM = "com.atproto.repo.uploadBlob";
+
+    static QString makeToken(const QDateTime& expiry)
+    {
+        static constexpr auto BASE64_URL = QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals;
+        const QByteArray header = R"({"alg":"ES256K","typ":"JWT"})";
+        const QJsonObject payload{{ "aud", AUD }, { "lxm", LXM }, { "exp", expiry.toSecsSinceEpoch() }};
+        const QByteArray json = QJsonDocument(payload).toJson(QJsonDocument::Compact);
+        return QString::fromLatin1(header.toBase64(BASE64_URL) + '.' + json.toBase64(BASE64_URL) + ".c2ln");
+    }
+};
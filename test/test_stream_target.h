@@ -0,0 +1,231 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "tls_test_server.h"
+#include <xrpc_network_thread.h>
+#include <QBuffer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Xrpc;
+
+// Streams downloads from a local server into stream targets.
+class TestStreamTarget : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        mDefaultSslConfig = QSslConfiguration::defaultConfiguration();
+        QSslConfiguration::setDefaultConfiguration(TlsTestServer::clientConfiguration());
+        mServer.setHandler([](const QByteArray& head){ return handleRequest(head); });
+        QVERIFY(mServer.start());
+        QVERIFY(mDir.isValid());
+    }
+
+    void cleanupTestCase()
+    {
+        QSslConfiguration::setDefaultConfiguration(mDefaultSslConfig);
+    }
+
+    void streamToDevice()
+    {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        auto target = std::make_shared<StreamTarget>(&buffer);
+        std::vector<std::pair<qint64, qint64>> progress;
+        target->setProgressCb([&progress](qint64 received, qint64 total){ progress.push_back({ received, total }); });
+
+        const auto result = download("test.chunked", target);
+        QVERIFY2(result.mError.isNull(), qPrintable(result.mError));
+        QCOMPARE(result.mSize, (qint64)CHUNKED_SIZE);
+        QCOMPARE(result.mContentType, "application/octet-stream");
+        QCOMPARE(buffer.data(), makeBody(CHUNKED_SIZE));
+
+        // The data is written in multiple chunks while it arrives.
+        QVERIFY(progress.size() > 2);
+
+        for (size_t i = 1; i < progress.size(); ++i)
+            QVERIFY(progress[i].first >= progress[i - 1].first);
+
+        // The size of a chunked reply is unknown till it is complete.
+        QCOMPARE(progress.front().second, (qint64)-1);
+        QCOMPARE(progress.back(), std::make_pair((qint64)CHUNKED_SIZE, (qint64)CHUNKED_SIZE));
+    }
+
+    void streamToFile()
+    {
+        const QString path = mDir.filePath("blob.bin");
+        auto target = std::make_shared<StreamTarget>(path);
+        qint64 total = 0;
+        target->setProgressCb([&total](qint64, qint64 bytesTotal){ total = bytesTotal; });
+
+        const auto result = download("test.large", target);
+        QVERIFY2(result.mError.isNull(), qPrintable(result.mError));
+        QCOMPARE(result.mSize, (qint64)LARGE_SIZE);
+        QCOMPARE(total, (qint64)LARGE_SIZE);
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), makeBody(LARGE_SIZE));
+    }
+
+    void cancel()
+    {
+        const QString path = mDir.filePath("cancelled.bin");
+        auto target = std::make_shared<StreamTarget>(path);
+        const auto handle = RequestHandle::create();
+        qint64 received = 0;
+
+        // Cancel after the first chunk got written.
+        target->setProgressCb([&received, handle](qint64 bytesReceived, qint64){
+            received = bytesReceived;
+            handle.cancel();
+        });
+
+        const auto result = download("test.large", target, handle, 1000);
+        QVERIFY(!result.mFinished);
+        QVERIFY(received > 0);
+        QVERIFY(received < LARGE_SIZE);
+        QVERIFY(target->getBytesWritten() < LARGE_SIZE);
+        QVERIFY(!QFile::exists(path));
+    }
+
+    void errorReply()
+    {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        auto target = std::make_shared<StreamTarget>(&buffer);
+
+        const auto result = download("test.error", target);
+        QVERIFY(result.mFinished);
+        QVERIFY(!result.mError.isNull());
+        QCOMPARE(result.mJson.object().value("error").toString(), "BlobNotFound");
+
+        // The body of an error reply is not written to the target.
+        QVERIFY(buffer.data().isEmpty());
+    }
+
+    void errorReplyToFile()
+    {
+        const QString path = mDir.filePath("error.bin");
+        auto target = std::make_shared<StreamTarget>(path);
+
+        const auto result = download("test.error", target);
+        QVERIFY(!result.mError.isNull());
+        QVERIFY(!QFile::exists(path));
+    }
+
+    void targetNotWritable()
+    {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        auto target = std::make_shared<StreamTarget>(&buffer);
+        const int requestCount = mServer.getRequestCount();
+
+        const auto result = download("test.large", target);
+        QCOMPARE(result.mError, "Stream device not writable");
+        QCOMPARE(mServer.getRequestCount(), requestCount);
+    }
+
+private:
+    static constexpr int CHUNK_SIZE = 300 * 1024;
+    static constexpr int CHUNK_COUNT = 4;
+    static constexpr int CHUNKED_SIZE = CHUNK_SIZE * CHUNK_COUNT;
+    static constexpr int LARGE_SIZE = 8 * 1024 * 1024;
+    static constexpr int TIMEOUT_MS = 10000;
+
+    struct Result
+    {
+        bool mFinished = false;
+        qint64 mSize = -1;
+        QString mContentType;
+        QString mError;
+        QJsonDocument mJson;
+    };
+
+    static QByteArray makeBody(int size)
+    {
+        QByteArray body(size, Qt::Uninitialized);
+
+        for (int i = 0; i < size; ++i)
+            body[i] = char(i % 251);
+
+        return body;
+    }
+
+    static QByteArray handleRequest(const QByteArray& head)
+    {
+        if (head.startsWith("GET /xrpc/test.chunked "))
+        {
+            const QByteArray body = makeBody(CHUNKED_SIZE);
+            QByteArray reply = "HTTP/1.1 200 OK\r\n"
+                               "Content-Type: application/octet-stream\r\n"
+                               "Transfer-Encoding: chunked\r\n\r\n";
+
+            for (int i = 0; i < CHUNK_COUNT; ++i)
+                reply += QByteArray::number(CHUNK_SIZE, 16) + "\r\n" + body.mid(i * CHUNK_SIZE, CHUNK_SIZE) + "\r\n";
+
+            return reply + "0\r\n\r\n";
+        }
+
+        if (head.startsWith("GET /xrpc/test.large "))
+        {
+            return "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: application/octet-stream\r\n"
+                   "Content-Length: " + QByteArray::number(LARGE_SIZE) + "\r\n\r\n" + makeBody(LARGE_SIZE);
+        }
+
+        const QByteArray body = R"({"error":"BlobNotFound","message":"Blob not found"})";
+        return "HTTP/1.1 400 Bad Request\r\n"
+               "Content-Type: application/json\r\n"
+               "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+    }
+
+    // Waits till the download finishes, or the wait time passes.
+    Result download(const QString& service, const StreamTarget::SharedPtr& target,
+                    const RequestHandle& handle = RequestHandle::create(), int waitMs = TIMEOUT_MS)
+    {
+        QNetworkAccessManager network;
+        network.setAutoDeleteReplies(true);
+        DecodePool decodePool(1);
+        RequestScheduler scheduler;
+        Metrics metrics;
+        TlsSessionStore tlsSessionStore;
+        NetworkThread thread(&network, decodePool, scheduler, metrics, tlsSessionStore,
+                             nullptr, nullptr, TIMEOUT_MS, {});
+        thread.setPDS(mServer.getHost());
+
+        connect(&thread, &NetworkThread::requestSuccessStream, this,
+                [](qint64 size, QString contentType, NetworkThread::SuccessStreamCb cb){ cb(size, contentType); });
+        connect(&thread, &NetworkThread::requestProgress, this,
+                [](qint64 bytesReceived, qint64 bytesTotal, StreamTarget::ProgressCb cb){ cb(bytesReceived, bytesTotal); });
+        connect(&thread, &NetworkThread::requestError, this,
+                [](QString error, QJsonDocument json, NetworkThread::ErrorCb cb){ cb(error, json); });
+
+        Result result;
+
+        thread.getStream(service, {}, {}, target,
+            [&result](qint64 size, const QString& contentType){
+                result.mFinished = true;
+                result.mSize = size;
+                result.mContentType = contentType;
+            },
+            [&result](const QString& error, const QJsonDocument& json){
+                result.mFinished = true;
+                result.mError = error;
+                result.mJson = json;
+            },
+            {}, {}, handle, RequestPriority::NORMAL, QDeadlineTimer(QDeadlineTimer::Forever));
+
+        if (!QTest::qWaitFor([&result]{ return result.mFinished; }, waitMs))
+            qDebug() << "Download not finished:" << service;
+
+        return result;
+    }
+
+    TlsTestServer mServer;
+    QSslConfiguration mDefaultSslConfig;
+    QTemporaryDir mDir;
+};
@@ -0,0 +1,193 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "tls_test_server.h"
+#include <xrpc_tls_session_store.h>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Xrpc;
+
+// Resumption needs a server that accepts tickets from other connections. The
+// QSslSocket server uses a new SSL context per connection and cannot resume
+// sessions. The OpenSSL test server can, and its status page shows whether a
+// session was resumed: "New, TLSv1.3, ..." or "Reused, TLSv1.3, ..."
+class TestTlsSessionStore : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(mDir.isValid());
+        writeFile("cert.pem", TlsTestServer::certificate().toPem());
+        writeFile("key.pem", TlsTestServer::privateKey().toPem());
+
+        mDefaultSslConfig = QSslConfiguration::defaultConfiguration();
+        QSslConfiguration::setDefaultConfiguration(TlsTestServer::clientConfiguration());
+
+        mPort = findFreePort();
+        mServer.start("openssl", { "s_server", "-accept", QString::number(mPort),
+                                   "-cert", mDir.filePath("cert.pem"), "-key", mDir.filePath("key.pem"),
+                                   "-www", "-quiet" });
+
+        // Without openssl only the tests without server run.
+        if (!mServer.waitForStarted(5000))
+            return;
+
+        QVERIFY(waitForServer());
+        mServerRunning = true;
+    }
+
+    void cleanupTestCase()
+    {
+        mServer.kill();
+        mServer.waitForFinished();
+        QSslConfiguration::setDefaultConfiguration(mDefaultSslConfig);
+    }
+
+    void resumeAfterRestart()
+    {
+        if (!mServerRunning)
+            QSKIP("openssl not available");
+
+        const QString storePath = mDir.filePath("tls_sessions.json");
+
+        {
+            TlsSessionStore store;
+            QVERIFY(store.open(storePath));
+            QCOMPARE(store.getTicketCount(), 0);
+
+            // Each network access manager has its own connections, like a new process.
+            QNetworkAccessManager network;
+            const QByteArray status = get(network, store);
+            QVERIFY2(status.contains("New,"), status.constData());
+            QVERIFY(!store.getTicket("localhost", mPort).isEmpty());
+        }
+
+        TlsSessionStore store;
+        QVERIFY(store.open(storePath));
+        QCOMPARE(store.getTicketCount(), 1);
+
+        QNetworkAccessManager network;
+        const QByteArray status = get(network, store);
+        QVERIFY2(status.contains("Reused,"), status.constData());
+    }
+
+    void disabled()
+    {
+        if (!mServerRunning)
+            QSKIP("openssl not available");
+
+        TlsSessionStore store;
+        QVERIFY(!store.isOpen());
+
+        QNetworkAccessManager network;
+        const QByteArray status = get(network, store);
+        QVERIFY2(status.contains("New,"), status.constData());
+        QCOMPARE(store.getTicketCount(), 0);
+    }
+
+    void fileOnlyReadableByOwner()
+    {
+        const QString storePath = mDir.filePath("tls_sessions_permissions.json");
+        TlsSessionStore store;
+        QVERIFY(store.open(storePath));
+        store.update(QUrl("https://pds.test"), makeConfig("ticket"));
+        store.waitForSaved();
+
+        QVERIFY(QFile::exists(storePath));
+        const auto permissions = QFile::permissions(storePath);
+        QVERIFY(permissions.testFlag(QFileDevice::ReadOwner));
+        QVERIFY(permissions.testFlag(QFileDevice::WriteOwner));
+        QVERIFY(!(permissions & (QFileDevice::ReadGroup | QFileDevice::WriteGroup | QFileDevice::ExeGroup |
+                                 QFileDevice::ReadOther | QFileDevice::WriteOther | QFileDevice::ExeOther)));
+    }
+
+    void burstOfTickets()
+    {
+        const QString storePath = mDir.filePath("tls_sessions_burst.json");
+
+        {
+            TlsSessionStore store;
+            QVERIFY(store.open(storePath));
+
+            for (int i = 0; i < HOST_COUNT; ++i)
+                store.update(QUrl(QString("https://pds%1.test").arg(i)), makeConfig(QByteArray::number(i)));
+
+            // The last tickets get saved before the store is destroyed.
+        }
+
+        TlsSessionStore store;
+        QVERIFY(store.open(storePath));
+        QCOMPARE(store.getTicketCount(), HOST_COUNT);
+
+        for (int i = 0; i < HOST_COUNT; ++i)
+            QCOMPARE(store.getTicket(QString("pds%1.test").arg(i), 443), QByteArray::number(i));
+    }
+
+private:
+    static constexpr int HOST_COUNT = 50;
+
+    static QSslConfiguration makeConfig(const QByteArray& ticket)
+    {
+        QSslConfiguration config;
+        config.setSessionTicket(ticket);
+        return config;
+    }
+
+    QByteArray get(QNetworkAccessManager& network, TlsSessionStore& store)
+    {
+        QNetworkRequest request(QUrl(QString("https://localhost:%1/").arg(mPort)));
+        store.apply(request);
+        std::unique_ptr<QNetworkReply> reply(network.get(request));
+        QSignalSpy finishedSpy(reply.get(), &QNetworkReply::finished);
+
+        if (!reply->isFinished() && !finishedSpy.wait(5000))
+            return "timeout";
+
+        store.update(request.url(), reply->sslConfiguration());
+        return reply->readAll();
+    }
+
+    void writeFile(const QString& name, const QByteArray& data)
+    {
+        QFile file(mDir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    static quint16 findFreePort()
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost, 0);
+        return server.serverPort();
+    }
+
+    bool waitForServer()
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            QTcpSocket socket;
+            socket.connectToHost(QHostAddress::LocalHost, mPort);
+
+            if (socket.waitForConnected(100))
+                return true;
+
+            QTest::qWait(100);
+        }
+
+        return false;
+    }
+
+    QTemporaryDir mDir;
+    QProcess mServer;
+    quint16 mPort = 0;
+    bool mServerRunning = false;
+    QSslConfiguration mDefaultSslConfig;
+};
@@ -1,22 +1,65 @@
 // Copyright (C) 2024 Michel de Boer
 // License: GPLv3
 #pragma once
+#include "post_view_fixture.h"
+#include <lexicon/app_bsky_feed.h>
 #include <lexicon/chat_bsky_convo.h>
 #include <xjson.h>
+#include <QElapsedTimer>
 #include <QJsonDocument>
+#include <QRegularExpression>
 #include <QTest>
 
 using namespace ATProto;
 
+static constexpr std::array<char const*, 16> TEST_VARIANT_TYPES{
+    "test.a", "test.b", "test.c", "test.d", "test.e", "test.f", "test.g", "test.h",
+    "test.i", "test.j", "test.k", "test.l", "test.m", "test.n", "test.o", "test.p"
+};
+
+template<int N>
+struct TestVariant
+{
+    using SharedPtr = std::shared_ptr<TestVariant>;
+    static constexpr char const* TYPE = TEST_VARIANT_TYPES[N];
+    static SharedPtr fromJson(const QJsonObject&) { return std::make_shared<TestVariant>(); }
+};
+
+// All tests run for each available backend.
 class TestXJson : public QObject
 {
     Q_OBJECT
 private slots:
+    void initTestCase_data()
+    {
+        QTest::addColumn<bool>("simdjson");
+        QTest::newRow("qjson") << false;
+
+        if (XJsonDocument::isAvailable(XJsonBackend::SIMDJSON))
+            QTest::newRow("simdjson") << true;
+    }
+
+    void initTestCase()
+    {
+        mDefaultBackend = XJsonDocument::getBackend();
+    }
+
+    void cleanupTestCase()
+    {
+        XJsonDocument::setBackend(mDefaultBackend);
+    }
+
+    void init()
+    {
+        QFETCH_GLOBAL(bool, simdjson);
+        QVERIFY(XJsonDocument::setBackend(simdjson ? XJsonBackend::SIMDJSON : XJsonBackend::QJSON));
+    }
+
     void requiredVariantMessageView()
     {
-        auto json = QJsonDocument::fromJson(LOG_CREATE_MESSAGE);
-        QVERIFY(!json.isEmpty());
-        auto lcm = ChatBskyConvo::LogCreateMessage::fromJson(json.object());
+        const XJsonDocument json(LOG_CREATE_MESSAGE);
+        QVERIFY(json.isObject());
+        auto lcm = XJsonObject::decode<ChatBskyConvo::LogCreateMessage>(json.object());
         QVERIFY(lcm);
         auto* messageView = std::get_if<ChatBskyConvo::MessageView::SharedPtr>(&lcm->mMessage);
         QVERIFY(messageView);
@@ -25,9 +68,9 @@ private slots:
 
     void requiredVariantDeletedMessageView()
     {
-        auto json = QJsonDocument::fromJson(LOG_CREATE_DELETED_MESSAGE);
-        QVERIFY(!json.isEmpty());
-        auto lcm = ChatBskyConvo::LogCreateMessage::fromJson(json.object());
+        const XJsonDocument json(LOG_CREATE_DELETED_MESSAGE);
+        QVERIFY(json.isObject());
+        auto lcm = XJsonObject::decode<ChatBskyConvo::LogCreateMessage>(json.object());
         QVERIFY(lcm);
         auto* messageView = std::get_if<ChatBskyConvo::DeletedMessageView::SharedPtr>(&lcm->mMessage);
         QVERIFY(messageView);
@@ -38,9 +81,9 @@ private slots:
     {
         QTest::ignoreMessage(QtWarningMsg, "Unknown type: \"chat.bsky.convo.defs#unknown\"");
         QTest::ignoreMessage(QtWarningMsg, "Unknown type for key: \"message\"");
-        auto json = QJsonDocument::fromJson(LOG_CREATE_UNKNOWN);
-        QVERIFY(!json.isEmpty());
-        auto lcm = ChatBskyConvo::LogCreateMessage::fromJson(json.object());
+        const XJsonDocument json(LOG_CREATE_UNKNOWN);
+        QVERIFY(json.isObject());
+        auto lcm = XJsonObject::decode<ChatBskyConvo::LogCreateMessage>(json.object());
         QVERIFY(lcm);
         auto* messageView = std::get_if<ChatBskyConvo::MessageView::SharedPtr>(&lcm->mMessage);
         QVERIFY(messageView);
@@ -48,7 +91,232 @@ private slots:
         QVERIFY(isNullVariant(lcm->mMessage));
     }
 
+    void variantDispatch()
+    {
+        using Variant = std::variant<
+            TestVariant<0>::SharedPtr, TestVariant<1>::SharedPtr, TestVariant<2>::SharedPtr, TestVariant<3>::SharedPtr,
+            TestVariant<4>::SharedPtr, TestVariant<5>::SharedPtr, TestVariant<6>::SharedPtr, TestVariant<7>::SharedPtr,
+            TestVariant<8>::SharedPtr, TestVariant<9>::SharedPtr, TestVariant<10>::SharedPtr, TestVariant<11>::SharedPtr,
+            TestVariant<12>::SharedPtr, TestVariant<13>::SharedPtr, TestVariant<14>::SharedPtr, TestVariant<15>::SharedPtr,
+            UnknownVariant::SharedPtr>;
+
+        auto toVariant = [](const QString& type) -> Variant {
+            return XJsonObject::toVariant<
+                TestVariant<0>, TestVariant<1>, TestVariant<2>, TestVariant<3>,
+                TestVariant<4>, TestVariant<5>, TestVariant<6>, TestVariant<7>,
+                TestVariant<8>, TestVariant<9>, TestVariant<10>, TestVariant<11>,
+                TestVariant<12>, TestVariant<13>, TestVariant<14>, TestVariant<15>,
+                UnknownVariant>(QJsonObject{{ "$type", type }});
+        };
+
+        for (int i = 0; i < (int)TEST_VARIANT_TYPES.size(); ++i)
+        {
+            const auto v = toVariant(TEST_VARIANT_TYPES[i]);
+            QCOMPARE((int)v.index(), i);
+            QVERIFY(!isNullVariant(v));
+        }
+
+        // Unknown types and prefixes of known types go to the catch all.
+        QCOMPARE((int)toVariant("test.q").index(), 16);
+        QCOMPARE((int)toVariant("test.").index(), 16);
+        QCOMPARE((int)toVariant("").index(), 16);
+
+        QTest::ignoreMessage(QtWarningMsg, "Unknown type: \"test.q\"");
+        const auto v = XJsonObject::toVariant<TestVariant<0>, TestVariant<1>>(QJsonObject{{ "$type", "test.q" }});
+        QVERIFY(isNullVariant(v));
+    }
+
+    void fieldLookup()
+    {
+        const QJsonObject json{
+            { "text", QString("a\u200Eb\u2067c") },
+            { "plain", "plain" },
+            { "count", 42 },
+            { QString::fromUtf8("caf\u00e9"), "latte" }
+        };
+        const XJsonDocument doc(toJson(json));
+        const XJsonObject xjson = doc.object();
+
+        QCOMPARE(xjson.getRequiredString("text"), "abc");
+        QCOMPARE(xjson.getRequiredString(QString("plain")), "plain");
+        QCOMPARE(xjson.getRequiredString(u"caf\u00e9"), "latte");
+        QCOMPARE(xjson.getRequiredString("caf\u00e9"), "latte"); // UTF-8, not ASCII
+        QCOMPARE(xjson.getOptionalInt("count", 0), 42);
+        QCOMPARE(xjson.getOptionalInt("missing", 7), 7);
+        QVERIFY(!xjson.getOptionalString("missing"));
+
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Field missing: \"missing\""));
+        QVERIFY_THROWS_EXCEPTION(InvalidJsonException, xjson.getRequiredString("missing"));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Field: \"count\" has wrong type"));
+        QVERIFY_THROWS_EXCEPTION(InvalidJsonException, xjson.getRequiredString("count"));
+    }
+
+    void numbers()
+    {
+        const XJsonDocument doc(R"({"int":42,"negative":-7,"big":4294967296,"integral":3.0,"fraction":1.5})");
+        const XJsonObject xjson = doc.object();
+
+        QCOMPARE(xjson.getOptionalInt("int", 0), 42);
+        QCOMPARE(xjson.getOptionalInt("negative", 0), -7);
+        QCOMPARE(xjson.getOptionalInt("big", 0), 0); // out of range
+        QCOMPARE(xjson.getOptionalInt64("big", 0), 4294967296LL);
+        QCOMPARE(xjson.getOptionalInt("integral", 0), 3);
+        QCOMPARE(xjson.getOptionalInt("fraction", 0), 0);
+        QCOMPARE(xjson.getOptionalInt64("fraction", 0), 0LL);
+    }
+
+    void invalidDocument()
+    {
+        const XJsonDocument doc("{\"feed\":");
+        QVERIFY(!doc.isObject());
+        QVERIFY(doc.object().toJsonObject().isEmpty());
+    }
+
+    void toJsonObject()
+    {
+        const QByteArray data = PostViewFixture::makeFeed(3);
+        const XJsonDocument doc(data);
+        QCOMPARE(doc.object().toJsonObject(), QJsonDocument::fromJson(data).object());
+    }
+
+    void decodeFeed()
+    {
+        const XJsonDocument json(PostViewFixture::makeFeed(FEED_SIZE));
+        const auto feed = XJsonObject::decode<AppBskyFeed::OutputFeed>(json.object());
+        QCOMPARE((int)feed->mFeed.size(), FEED_SIZE);
+        QCOMPARE(feed->mFeed.back()->mPost->mAuthor->mHandle, QString("user%1.bsky.social").arg(FEED_SIZE - 1));
+        QCOMPARE(feed->mFeed.back()->mPost->mLikeCount, 42);
+        QVERIFY(feed->mCursor);
+        QCOMPARE(*feed->mCursor, "cursor");
+
+        const auto* post = std::get_if<AppBskyFeed::Record::Post::SharedPtr>(&feed->mFeed.front()->mPost->getRecord());
+        QVERIFY(post);
+        QCOMPARE((*post)->mLanguages, std::vector<QString>{"en"});
+        QCOMPARE((*post)->toJson().value("text").toString(), (*post)->mText);
+        QCOMPARE((int)(*post)->mFacets.size(), 3);
+        QVERIFY((*post)->mEmbed);
+
+        const auto& embed = feed->mFeed.front()->mPost->getEmbed();
+        QVERIFY(embed);
+        QVERIFY(ATProto::holdsNonNull<AppBskyEmbed::RecordWithMediaView::SharedPtr>(*embed));
+    }
+
+    // Fields unknown to the library survive a decode and encode.
+    void postUnknownFields()
+    {
+        const XJsonDocument json(R"({"$type":"app.bsky.feed.post","text":"hi","createdAt":"2024-04-14T20:48:40.913Z","via":"client"})");
+        const auto post = XJsonObject::decode<AppBskyFeed::Record::Post>(json.object());
+        const QJsonObject postJson = post->toJson();
+        QCOMPARE(postJson.value("via").toString(), "client");
+        QCOMPARE(postJson.value("text").toString(), "hi");
+        QCOMPARE(postJson.value("$type").toString(), AppBskyFeed::Record::Post::TYPE);
+    }
+
+    // Lazy content gets decoded after the document is gone.
+    void lazyDecodeAfterDocument()
+    {
+        AppBskyFeed::OutputFeed::SharedPtr feed;
+
+        {
+            const LazyDecodeScope lazyScope(true);
+            const XJsonDocument json(PostViewFixture::makeFeed(2));
+            feed = XJsonObject::decode<AppBskyFeed::OutputFeed>(json.object());
+        }
+
+        const auto* post = std::get_if<AppBskyFeed::Record::Post::SharedPtr>(&feed->mFeed.back()->mPost->getRecord());
+        QVERIFY(post);
+        QVERIFY((*post)->mText.startsWith("Post number 1 "));
+    }
+
+    // A retained object can be decoded after the document is gone.
+    void retainAfterDocument()
+    {
+        std::optional<XJsonObject> root;
+
+        {
+            const XJsonDocument json(PostViewFixture::makeFeed(2));
+            root.emplace(json.object().retain());
+        }
+
+        const auto feed = XJsonObject::decode<AppBskyFeed::OutputFeed>(*root);
+        QCOMPARE((int)feed->mFeed.size(), 2);
+        const auto* post = std::get_if<AppBskyFeed::Record::Post::SharedPtr>(&feed->mFeed.back()->mPost->getRecord());
+        QVERIFY(post);
+        QVERIFY((*post)->mText.startsWith("Post number 1 "));
+    }
+
+    // Parse and decode of a timeline page
+    void benchmarkDecodeFeed()
+    {
+        const QByteArray data = PostViewFixture::makeFeed(FEED_SIZE);
+
+        QBENCHMARK {
+            const XJsonDocument json(data);
+            XJsonObject::decode<AppBskyFeed::OutputFeed>(json.object());
+        }
+    }
+
+    // Only the decode, the JSON document is already there.
+    void benchmarkDecodeFeedFromDocument()
+    {
+        const XJsonDocument json(PostViewFixture::makeFeed(FEED_SIZE));
+        const XJsonObject root = json.object();
+
+        QBENCHMARK {
+            XJsonObject::decode<AppBskyFeed::OutputFeed>(root);
+        }
+    }
+
+    // Parse and decode of a timeline page with embeds and facets must not be slower
+    // with SIMDJSON than with QJSON.
+    void decodeFeedSpeedup()
+    {
+        QFETCH_GLOBAL(bool, simdjson);
+
+        if (!simdjson)
+            QSKIP("Compared on the simdjson row");
+
+        const QByteArray data = PostViewFixture::makeFeed(FEED_SIZE);
+
+        // Warm up both backends before timing.
+        timeDecodeFeed(XJsonBackend::QJSON, data, 1);
+        timeDecodeFeed(XJsonBackend::SIMDJSON, data, 1);
+
+        const qint64 qjsonNs = timeDecodeFeed(XJsonBackend::QJSON, data, SPEEDUP_RUNS);
+        const qint64 simdjsonNs = timeDecodeFeed(XJsonBackend::SIMDJSON, data, SPEEDUP_RUNS);
+        QVERIFY(simdjsonNs > 0);
+        qInfo() << "Decode feed of" << FEED_SIZE << "posts, QJSON:" << qjsonNs / SPEEDUP_RUNS << "ns"
+                << "SIMDJSON:" << simdjsonNs / SPEEDUP_RUNS << "ns"
+                << "speedup:" << (double)qjsonNs / simdjsonNs;
+        QVERIFY2(simdjsonNs <= qjsonNs, "SIMDJSON decodes the feed slower than QJSON");
+    }
+
 private:
+    static constexpr int FEED_SIZE = 100;
+    static constexpr int SPEEDUP_RUNS = 200;
+
+    XJsonBackend mDefaultBackend = XJsonBackend::QJSON;
+
+    static QByteArray toJson(const QJsonObject& json)
+    {
+        return QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+
+    static qint64 timeDecodeFeed(XJsonBackend backend, const QByteArray& data, int runs)
+    {
+        XJsonDocument::setBackend(backend);
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < runs; ++i)
+        {
+            const XJsonDocument json(data);
+            XJsonObject::decode<AppBskyFeed::OutputFeed>(json.object());
+        }
+
+        return timer.nsecsElapsed();
+    }
+
     static constexpr char const* LOG_CREATE_MESSAGE = R"##({
         "rev": "c1",
         "convoId": "c42",
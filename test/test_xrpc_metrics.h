@@ -0,0 +1,142 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <xrpc_metrics.h>
+#include <QTest>
+
+using namespace Xrpc;
+using namespace std::chrono_literals;
+
+class TestXrpcMetrics : public QObject
+{
+    Q_OBJECT
+private slots:
+    void keyFromUrl()
+    {
+        auto key = Metrics::Key::fromUrl(QUrl("https://pds.test/xrpc/app.bsky.feed.getTimeline?limit=50"));
+        QCOMPARE(key.mNsid, "app.bsky.feed.getTimeline");
+        QCOMPARE(key.mHost, "pds.test");
+
+        key = Metrics::Key::fromUrl(QUrl("https://cdn.test/img/avatar/plain/did:plc:abc/bafkrei@jpeg"));
+        QCOMPARE(key.mNsid, Metrics::Key::NON_XRPC_NSID);
+        QCOMPARE(key.mHost, "cdn.test");
+
+        key = Metrics::Key::fromUrl(QUrl("https://plc.directory/did:plc:abc"));
+        QCOMPARE(key.mNsid, Metrics::Key::NON_XRPC_NSID);
+
+        key = Metrics::Key::fromUrl(QUrl("https://pds.test/xrpc/"));
+        QCOMPARE(key.mNsid, Metrics::Key::NON_XRPC_NSID);
+
+        key = Metrics::Key::fromUrl(QUrl("https://pds.test/xrpc/app.bsky.feed.getTimeline/extra"));
+        QCOMPARE(key.mNsid, Metrics::Key::NON_XRPC_NSID);
+    }
+
+    void nonXrpcUrlsShareEntry()
+    {
+        Metrics metrics;
+        metrics.recordReply(Metrics::Key::fromUrl(QUrl("https://cdn.test/a")), 1ms, 0, 10, false);
+        metrics.recordReply(Metrics::Key::fromUrl(QUrl("https://cdn.test/b")), 1ms, 0, 10, false);
+
+        const auto snapshot = metrics.snapshot();
+        QCOMPARE(snapshot.size(), (size_t)1);
+        QCOMPARE(snapshot[0].mRequests, (qint64)2);
+        QCOMPARE(snapshot[0].mResponseBytes, (qint64)20);
+    }
+
+    void percentileEmpty()
+    {
+        const Metrics::Histogram histogram(BOUNDS);
+        QCOMPARE(histogram.percentile(0.5), 0.0);
+    }
+
+    void percentile()
+    {
+        Metrics::Histogram histogram(BOUNDS);
+
+        for (double value : { 5.0, 15.0, 15.0, 25.0 })
+            histogram.record(value);
+
+        QCOMPARE(histogram.getCount(), (qint64)4);
+        QCOMPARE(histogram.getSum(), 60.0);
+        QCOMPARE(histogram.getCounts(), std::vector<qint64>({ 1, 2, 1, 0 }));
+
+        QCOMPARE(histogram.percentile(0.0), 0.0);
+        QCOMPARE(histogram.percentile(0.25), 10.0);
+        QCOMPARE(histogram.percentile(0.5), 15.0);
+        QCOMPARE(histogram.percentile(0.75), 20.0);
+        QCOMPARE(histogram.percentile(1.0), 30.0);
+
+        // Out of range percentiles get clamped.
+        QCOMPARE(histogram.percentile(2.0), 30.0);
+        QCOMPARE(histogram.percentile(-1.0), 0.0);
+    }
+
+    void percentileBucketBounds()
+    {
+        Metrics::Histogram histogram(BOUNDS);
+
+        // A value equal to a bound belongs to that bucket.
+        histogram.record(10.0);
+        histogram.record(20.0);
+        QCOMPARE(histogram.getCounts(), std::vector<qint64>({ 1, 1, 0, 0 }));
+        QCOMPARE(histogram.percentile(0.5), 10.0);
+        QCOMPARE(histogram.percentile(1.0), 20.0);
+    }
+
+    void percentileOverflow()
+    {
+        Metrics::Histogram histogram(BOUNDS);
+        histogram.record(5.0);
+        histogram.record(100.0);
+        QCOMPARE(histogram.getCounts(), std::vector<qint64>({ 1, 0, 0, 1 }));
+
+        // Values beyond the highest bound are reported as the highest bound.
+        QCOMPARE(histogram.percentile(0.5), 10.0);
+        QCOMPARE(histogram.percentile(0.99), 30.0);
+    }
+
+    void prometheusText()
+    {
+        Metrics metrics;
+        const Metrics::Key key{ "app.bsky.feed.getTimeline", "pds.test" };
+        metrics.recordReply(key, 7ms, 100, 2000, false);
+        metrics.recordReply(key, 300ms, 50, 0, true);
+        metrics.recordRetry(key);
+
+        const QStringList lines = metrics.toPrometheusText().split('\n');
+        const QString labels = R"(nsid="app.bsky.feed.getTimeline",host="pds.test")";
+
+        QVERIFY(lines.contains("# TYPE xrpc_request_duration_seconds histogram"));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"0.005\"} 0").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"0.01\"} 1").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"0.25\"} 1").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"0.5\"} 2").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"30\"} 2").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_bucket{%1,le=\"+Inf\"} 2").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_sum{%1} 0.307").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_duration_seconds_count{%1} 2").arg(labels)));
+
+        // Histograms without samples have no series.
+        QVERIFY(lines.contains("# TYPE xrpc_decode_duration_seconds histogram"));
+        QVERIFY(!metrics.toPrometheusText().contains("xrpc_decode_duration_seconds_bucket"));
+
+        QVERIFY(lines.contains("# TYPE xrpc_requests_total counter"));
+        QVERIFY(lines.contains(QString("xrpc_requests_total{%1} 2").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_errors_total{%1} 1").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_request_bytes_total{%1} 150").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_response_bytes_total{%1} 2000").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_retries_total{%1} 1").arg(labels)));
+        QVERIFY(lines.contains(QString("xrpc_dpop_nonce_resends_total{%1} 0").arg(labels)));
+    }
+
+    void prometheusEscaping()
+    {
+        Metrics metrics;
+        metrics.recordRetry({ "a\"b\\c\nd", "pds.test" });
+        const QString text = metrics.toPrometheusText();
+        QVERIFY(text.contains(R"(xrpc_retries_total{nsid="a\"b\\c\nd",host="pds.test"} 1)"));
+    }
+
+private:
+    static inline const std::vector<double> BOUNDS{ 10.0, 20.0, 30.0 };
+};